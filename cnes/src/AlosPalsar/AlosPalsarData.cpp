@@ -68,9 +68,7 @@ std::istream& operator>>(std::istream& is, AlosPalsarData& data)
   }
   else
   {
-    char* buff = new char[header.get_length()-12];
-    is.read(buff, header.get_length() - 12);
-    delete [] buff;
+    is.ignore(header.get_length() - 12);
   }
 
   std::streampos filePosition;
@@ -15,6 +15,10 @@
 namespace ossimplugins
 {
 
+   // Bytes of the record after its 12 byte header, read in place when the
+   // stream is a mapping.
+   static const std::size_t FacilityDataLength = 12276;
+
    AlosPalsarFacilityData::AlosPalsarFacilityData() : AlosPalsarRecord("facility_data_rec")
    {
    }
@@ -339,511 +343,334 @@ namespace ossimplugins
 
    std::istream& operator>>(std::istream& is, AlosPalsarFacilityData& data)
    {
-      char buf64[65];
-      buf64[64] = '\0';
-      char buf32[33];
-      buf32[32] = '\0';
-      char buf24[25];
-      buf24[24] = '\0';
-      char buf22[23];
-      buf22[22] = '\0';
-      char buf20[21];
-      buf20[20] = '\0';
-      char buf16[17];
-      buf16[16] = '\0';
-      char buf12[13];
-      buf12[12] = '\0';
-      char buf7[8];
-      buf7[7] = '\0';
-      char buf8[9];
-      buf8[8] = '\0';
-      char buf6[7];
-      buf6[6] = '\0';
-      char buf4[5];
-      buf4[4] = '\0';
-      char buf2[3];
-      buf2[2] = '\0';
-      char buf1[2];
-      buf1[1] = '\0';
+      ossimFixedWidthFieldReader fields(is, FacilityDataLength);
+      data.Read(fields);
+      return is;
+   }
 
-      is.read(buf64, 64);
-      data._name_of_facil_rec = buf64;
+   void AlosPalsarFacilityData::Read(ossimFixedWidthFieldReader& fields)
+   {
+      fields.readString(64, _name_of_facil_rec);
 
-      is.read(buf6, 6);
-      data._last_release_qc_date = buf6;
+      fields.readString(6, _last_release_qc_date);
 
-      is.read(buf2, 2);
+      fields.skip(2);
 
-      is.read(buf6, 6);
-      data._last_release_cal_date = buf6;
+      fields.readString(6, _last_release_cal_date);
 
-      is.read(buf4, 4);
-      data._qa_summary_flag = atoi(buf4);
+      _qa_summary_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._prf_code_change_flag = atoi(buf4);
+      _prf_code_change_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._sampling_win_change_flag = atoi(buf4);
+      _sampling_win_change_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._cal_gain_change_flag = atoi(buf4);
+      _cal_gain_change_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._quirp_qu_flag = atoi(buf4);
+      _quirp_qu_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._inp_data_stat_flag = atoi(buf4);
+      _inp_data_stat_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._dopp_cent_conf_meas_flag = atoi(buf4);
+      _dopp_cent_conf_meas_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._dopp_cent_val_flag = atoi(buf4);
+      _dopp_cent_val_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._dopp_ambig_conf_meas_flag = atoi(buf4);
+      _dopp_ambig_conf_meas_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._outp_data_mean_flag = atoi(buf4);
+      _outp_data_mean_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._OGOB_flag = atoi(buf4);
+      _OGOB_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._PRF_changes = atoi(buf4);
+      _PRF_changes = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._sampling_win_changes = atoi(buf4);
+      _sampling_win_changes = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._cal_gain_changes = atoi(buf4);
+      _cal_gain_changes = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._missing_lines = atoi(buf4);
+      _missing_lines = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._rec_gain_changes = atoi(buf4);
+      _rec_gain_changes = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._pulse_width_of_ACF_3db = atof(buf16);
+      _pulse_width_of_ACF_3db = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._first_side_lobe_lev_of_ACF = atof(buf16);
+      _first_side_lobe_lev_of_ACF = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._ISLR_of_ACF = atof(buf16);
+      _ISLR_of_ACF = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._dopp_cent_conf_meas = atof(buf16);
+      _dopp_cent_conf_meas = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._dopp_ambig_conf_meas = atof(buf16);
+      _dopp_ambig_conf_meas = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._inp_data_I_mean = atof(buf16);
+      _inp_data_I_mean = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._inp_data_Q_mean = atof(buf16);
+      _inp_data_Q_mean = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._inp_data_I_stddev = atof(buf16);
+      _inp_data_I_stddev = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._inp_data_Q_stddev = atof(buf16);
+      _inp_data_Q_stddev = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._cal_sys_gain = atof(buf16);
+      _cal_sys_gain = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._first_rec_gain_read = atof(buf16);
+      _first_rec_gain_read = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._dopp_ambig_num = atof(buf16);
+      _dopp_ambig_num = fields.readDouble(16);
 
-      is.read(buf16, 16);
+      fields.skip(16);
 
-      is.read(buf16, 16);
-      data._I_channel_bias_correction = atof(buf16);
+      _I_channel_bias_correction = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._Q_channel_bias_correction = atof(buf16);
+      _Q_channel_bias_correction = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._I_channel_gain_correction = atof(buf16);
+      _I_channel_gain_correction = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._Q_channel_gain_correction = atof(buf16);
+      _Q_channel_gain_correction = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._Q_channel_I_Q_correction = atof(buf16);
+      _Q_channel_I_Q_correction = fields.readDouble(16);
 
-      is.read(buf16, 16);
+      fields.skip(16);
 
-      is.read(buf16, 16);
-      data._noise_power = atof(buf16);
+      _noise_power = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._int_cal_utc = atoi(buf16);
+      _int_cal_utc = fields.readInt(16);
 
-      is.read(buf4, 4);
-      data._num_valid_cal_pulses = atoi(buf4);
+      _num_valid_cal_pulses = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._num_valid_noise_pulses = atoi(buf4);
+      _num_valid_noise_pulses = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._num_valid_replicas = atoi(buf4);
+      _num_valid_replicas = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._first_replica_sample = atof(buf16);
+      _first_replica_sample = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._mean_cal_pulse_power = atof(buf16);
+      _mean_cal_pulse_power = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._mean_noise_power = atof(buf16);
+      _mean_noise_power = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._range_comp_norm_fact = atof(buf16);
+      _range_comp_norm_fact = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._replica_power = atof(buf16);
+      _replica_power = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._first_range_pixel_mid_az_inc = atof(buf16);
+      _first_range_pixel_mid_az_inc = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._center_range_pix_mid_az_inc = atof(buf16);
+      _center_range_pix_mid_az_inc = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._last_range_pix_mid_az_inc = atof(buf16);
+      _last_range_pix_mid_az_inc = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._norm_ref_range_ro = atof(buf16);
+      _norm_ref_range_ro = fields.readDouble(16);
 
-      is.read(buf12, 12);
+      fields.skip(12);
 
-      is.read(buf4, 4);
-      data._antenna_elev_flag = atoi(buf4);
+      _antenna_elev_flag = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._abs_cal_const_K = atof(buf16);
+      _abs_cal_const_K = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._upp_bound_K = atof(buf16);
+      _upp_bound_K = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._low_bound_K = atof(buf16);
+      _low_bound_K = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._proc_noise_scale_fact = atof(buf16);
+      _proc_noise_scale_fact = fields.readDouble(16);
 
-      is.read(buf6, 6);
-      data._K_gen_date = buf6;
+      fields.readString(6, _K_gen_date);
 
-      is.read(buf4, 4);
-      data._K_vers_num = buf4;
+      fields.readString(4, _K_vers_num);
 
-      is.read(buf4, 4);
-      data._num_duplic_input_lines = atoi(buf4);
+      _num_duplic_input_lines = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._estim_bit_error_rate = atof(buf16);
+      _estim_bit_error_rate = fields.readDouble(16);
 
-      is.read(buf12, 12);
+      fields.skip(12);
 
-      is.read(buf16, 16);
-      data._out_image_mean = atof(buf16);
+      _out_image_mean = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._out_image_std_dev = atof(buf16);
+      _out_image_std_dev = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._out_image_max_value = atof(buf16);
+      _out_image_max_value = fields.readDouble(16);
 
-      is.read(buf24, 24);
-      data._time_raw_data_first_input = buf24;
+      fields.readString(24, _time_raw_data_first_input);
 
-      is.read(buf24, 24);
-      data._time_asc_node_state_vectors = buf24;
+      fields.readString(24, _time_asc_node_state_vectors);
 
-      is.read(buf22, 22);
-      data._asc_node_pos_X_comp = buf22;
+      fields.readString(22, _asc_node_pos_X_comp);
 
-      is.read(buf22, 22);
-      data._asc_node_pos_Y_comp = buf22;
+      fields.readString(22, _asc_node_pos_Y_comp);
 
-      is.read(buf22, 22);
-      data._asc_node_pos_Z_comp = buf22;
+      fields.readString(22, _asc_node_pos_Z_comp);
 
-      is.read(buf22, 22);
-      data._asc_node_vel_X_comp = buf22;
+      fields.readString(22, _asc_node_vel_X_comp);
 
-      is.read(buf22, 22);
-      data._asc_node_vel_Y_comp = buf22;
+      fields.readString(22, _asc_node_vel_Y_comp);
 
-      is.read(buf22, 22);
-      data._asc_node_vel_Z_comp = buf22;
+      fields.readString(22, _asc_node_vel_Z_comp);
 
-      is.read(buf4, 4);
-      data._out_pixel_bit_length = atoi(buf4);
+      _out_pixel_bit_length = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._proc_gain_param_1 = atof(buf16);
+      _proc_gain_param_1 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._proc_gain_param_2 = atof(buf16);
+      _proc_gain_param_2 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._proc_gain_param_3 = atof(buf16);
+      _proc_gain_param_3 = fields.readDouble(16);
 
-      is.read(buf4, 4);
-      data._peak_loc_cross_correl_fun = atoi(buf4);
+      _peak_loc_cross_correl_fun = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._3_dB_width_CCF = atof(buf16);
+      _3_dB_width_CCF = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._first_side_lobe_level = atof(buf16);
+      _first_side_lobe_level = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._ISLR_CCF_between_last = atof(buf16);
+      _ISLR_CCF_between_last = fields.readDouble(16);
 
-      is.read(buf4, 4);
-      data._peak_loc_CCF_betw_last = atoi(buf4);
+      _peak_loc_CCF_betw_last = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._Roll_Tilt_Mode_flag = atoi(buf4);
+      _Roll_Tilt_Mode_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._raw_data_correction_flag = atoi(buf4);
+      _raw_data_correction_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._look_detecion_flag = atoi(buf4);
+      _look_detecion_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._doppler_ambiguity_estimat_flag = atoi(buf4);
+      _doppler_ambiguity_estimat_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._azimuth_baseband_convers_flag = atoi(buf4);
+      _azimuth_baseband_convers_flag = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._samples_per_line_used = atoi(buf4);
+      _samples_per_line_used = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._range_lines_skip_factor = atoi(buf4);
+      _range_lines_skip_factor = fields.readInt(4);
 
-      is.read(buf24, 24);
-      data._time_of_inp_state_vectors = buf24;
+      fields.readString(24, _time_of_inp_state_vectors);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_pos_X_comp = buf22;
+      fields.readString(22, _inp_state_vect_pos_X_comp);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_pos_Y_comp = buf22;
+      fields.readString(22, _inp_state_vect_pos_Y_comp);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_pos_Z_comp = buf22;
+      fields.readString(22, _inp_state_vect_pos_Z_comp);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_vel_Vx_comp = buf22;
+      fields.readString(22, _inp_state_vect_vel_Vx_comp);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_vel_Vy_comp = buf22;
+      fields.readString(22, _inp_state_vect_vel_Vy_comp);
 
-      is.read(buf22, 22);
-      data._inp_state_vect_vel_Vz_comp = buf22;
+      fields.readString(22, _inp_state_vect_vel_Vz_comp);
 
-      is.read(buf4, 4);
-      data._inp_state_vector_type_flag = atoi(buf4);
+      _inp_state_vector_type_flag = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._win_coeff_for_range_match = atof(buf16);
+      _win_coeff_for_range_match = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._win_coeff_for_azi_match = atof(buf16);
+      _win_coeff_for_azi_match = fields.readDouble(16);
 
-      is.read(buf4, 4);
-      data._update_period_range_match = atoi(buf4);
+      _update_period_range_match = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_1 = atof(buf16);
+      _look_scalar_gain_1 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_2 = atof(buf16);
+      _look_scalar_gain_2 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_3 = atof(buf16);
+      _look_scalar_gain_3 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_4 = atof(buf16);
+      _look_scalar_gain_4 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_5 = atof(buf16);
+      _look_scalar_gain_5 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_6 = atof(buf16);
+      _look_scalar_gain_6 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_7 = atof(buf16);
+      _look_scalar_gain_7 = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._look_scalar_gain_8 = atof(buf16);
+      _look_scalar_gain_8 = fields.readDouble(16);
 
-      is.read(buf4, 4);
-      data._samp_window_start_time_bias = atoi(buf4);
+      _samp_window_start_time_bias = fields.readInt(4);
 
-      is.read(buf22, 22);
-      data._doppler_centroid_cubic_coeff = atof(buf22);
+      _doppler_centroid_cubic_coeff = fields.readDouble(22);
 
-      is.read(buf4, 4);
-      data._PRF_code_first_range_line = atoi(buf4);
+      _PRF_code_first_range_line = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._PRF_code_last_range_line = atoi(buf4);
+      _PRF_code_last_range_line = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._samp_win_start_first = atoi(buf4);
+      _samp_win_start_first = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._samp_win_start_last = atoi(buf4);
+      _samp_win_start_last = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._cal_syst_gain_last_proc = atoi(buf4);
+      _cal_syst_gain_last_proc = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._receiver_gain_last_proc = atoi(buf4);
+      _receiver_gain_last_proc = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._first_processed_range_sample = atoi(buf4);
+      _first_processed_range_sample = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._azimuth_FFT_IFFT_ratio = atoi(buf4);
+      _azimuth_FFT_IFFT_ratio = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._num_azimuth_blocks_proc = atoi(buf4);
+      _num_azimuth_blocks_proc = fields.readInt(4);
 
-      is.read(buf8, 8);
-      data._num_input_raw_data_lines = atol(buf8);
+      _num_input_raw_data_lines = fields.readInt(8);
 
-      is.read(buf4, 4);
-      data._initial_doppler_ambiguity_num = atoi(buf4);
+      _initial_doppler_ambiguity_num = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._thresh_no_1_flag = atof(buf16);
+      _thresh_no_1_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_2_flag = atof(buf16);
+      _thresh_no_2_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_3_flag = atof(buf16);
+      _thresh_no_3_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_4_flag = atof(buf16);
+      _thresh_no_4_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_5_flag = atof(buf16);
+      _thresh_no_5_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_6_flag = atof(buf16);
+      _thresh_no_6_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_7_flag = atof(buf16);
+      _thresh_no_7_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_8_flag = atof(buf16);
+      _thresh_no_8_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_9_flag = atof(buf16);
+      _thresh_no_9_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_10_flag = atof(buf16);
+      _thresh_no_10_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._thresh_no_11_flag = atof(buf16);
+      _thresh_no_11_flag = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._sat_binary_time_of_first = atol(buf16);
+      _sat_binary_time_of_first = fields.readInt(16);
 
-      is.read(buf4, 4);
-      data._num_valid_pixels_per_range = atoi(buf4);
+      _num_valid_pixels_per_range = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._num_range_samp_discarded = atoi(buf4);
+      _num_range_samp_discarded = fields.readInt(4);
 
-      is.read(buf16, 16);
-      data._I_gain_imb_lower_bound = atof(buf16);
+      _I_gain_imb_lower_bound = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._I_gain_imb_upper_bound = atof(buf16);
+      _I_gain_imb_upper_bound = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._I_Q_quad_depar_lower_bound = atof(buf16);
+      _I_Q_quad_depar_lower_bound = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._I_Q_quad_depar_upper_bound = atof(buf16);
+      _I_Q_quad_depar_upper_bound = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._3_dB_look_bandwidth = atof(buf16);
+      _3_dB_look_bandwidth = fields.readDouble(16);
 
-      is.read(buf16, 16);
-      data._3_dB_look_proc_dopp_bandw = atof(buf16);
+      _3_dB_look_proc_dopp_bandw = fields.readDouble(16);
 
-      is.read(buf4, 4);
-      data._range_spread_loss_comp_flag = atoi(buf4);
+      _range_spread_loss_comp_flag = fields.readInt(4);
 
-      is.read(buf1, 1);
-      data._datation_flag = atoi(buf1) != 0;
+      _datation_flag = fields.readInt(1) != 0;
 
-      is.read(buf7, 7);
-      data._max_error_range_line_timing = atoi(buf7);
+      _max_error_range_line_timing = fields.readInt(7);
 
-      is.read(buf7, 7);
-      data._form_num_range_line_used = atoi(buf7);
+      _form_num_range_line_used = fields.readInt(7);
 
-      is.read(buf1, 1);
-      data._autom_look_scal_gain_flag = atoi(buf1) != 0;
+      _autom_look_scal_gain_flag = fields.readInt(1) != 0;
 
-      is.read(buf4, 4);
-      data._max_value_look_scalar_gain = atoi(buf4);
+      _max_value_look_scalar_gain = fields.readInt(4);
 
-      is.read(buf4, 4);
-      data._replica_norm_method_flag = atoi(buf4);
+      _replica_norm_method_flag = fields.readInt(4);
 
-      is.read(buf20, 20);
-      data._coef_ground_range_1 = atof(buf20);
+      _coef_ground_range_1 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ground_range_2 = atof(buf20);
+      _coef_ground_range_2 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ground_range_3 = atof(buf20);
+      _coef_ground_range_3 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ground_range_4 = atof(buf20);
+      _coef_ground_range_4 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ant_elev_1 = atof(buf20);
+      _coef_ant_elev_1 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ant_elev_2 = atof(buf20);
+      _coef_ant_elev_2 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ant_elev_3 = atof(buf20);
+      _coef_ant_elev_3 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ant_elev_4 = atof(buf20);
+      _coef_ant_elev_4 = fields.readDouble(20);
 
-      is.read(buf20, 20);
-      data._coef_ant_elev_5 = atof(buf20);
+      _coef_ant_elev_5 = fields.readDouble(20);
 
-      is.read(buf16, 16);
-      data._range_time_origin_ant = atof(buf16);
+      _range_time_origin_ant = fields.readDouble(16);
 
-      char buf10238[10238];
-      is.read(buf10238, 10238);
-      return is;
+      fields.skip(10238);
    }
 
 
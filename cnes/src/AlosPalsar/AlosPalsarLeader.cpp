@@ -83,9 +83,7 @@ std::istream& operator>>(std::istream& is, AlosPalsarLeader& data)
       {
         if (header.get_length() > 12)
           {
-          char* buff = new char[header.get_length()-12];
-          is.read(buff, header.get_length() - 12);
-          delete [] buff;
+          is.ignore(header.get_length() - 12);
           }
       }
     }
@@ -14,6 +14,18 @@
 namespace ossimplugins
 {
 
+   // Bytes of the data set record, read in place when the stream is a
+   // mapping.
+   static const std::size_t MainProcessingParametersLength = 2009;
+
+   // A one byte flag, set if not zero.
+   static bool ReadFlag(ossimFixedWidthFieldReader& fields)
+   {
+      unsigned char flag;
+      fields.readBinary(&flag, 1);
+      return flag != 0;
+   }
+
    MainProcessingParameters::MainProcessingParameters() : EnvisatAsarRecord("MainProcessingParameters_rec")
    {
    }
@@ -269,436 +281,356 @@ namespace ossimplugins
 
    std::istream& operator>>(std::istream& is, MainProcessingParameters& data)
    {
-      char buf64[65];
-      buf64[64] = '\0';
-      char buf32[33];
-      buf32[32] = '\0';
-      // char buf27[28];
-      // buf27[27] = '\0';
-      char buf20[21];
-      buf20[20] = '\0';
-      char buf16[17];
-      buf16[16]='\0';
-      // char buf15[16];
-      // buf15[15] = '\0';
-      // char buf14[15];
-      // buf14[14] = '\0';
-      // char buf13[14];
-      // buf13[13] = '\0';
-      char buf12[13];
-      buf12[12] = '\0';
-      // char buf11[12];
-      // buf11[11] = '\0';
-      // char buf10[11];
-      // buf10[10] = '\0';
-      // char buf9[10];
-      // buf9[9] = '\0';
-      // char buf8[9];
-      // buf8[8] = '\0';
-      char buf7[8];
-      buf7[7] = '\0';
-      char buf6[7];
-      buf6[6] = '\0';
-      char buf5[6];
-      buf5[5] = '\0';
-      char buf4[5];
-      buf4[4] = '\0';
-      char buf3[4];
-      buf3[3] = '\0';
-      // char buf2[3];
-      // buf2[2] = '\0';
-//	char buf1[1]; // not used avoid warning
-
-//	int * var_long; // not used avoid warning
+      ossimFixedWidthFieldReader fields(is, MainProcessingParametersLength);
+      data.Read(fields);
+      return is;
+   }
 
-      is.read(buf12,12);
-      data._first_zero_doppler_time = buf12;
+   void MainProcessingParameters::Read(ossimFixedWidthFieldReader& fields)
+   {
+      fields.readString(12, _first_zero_doppler_time);
 
-      is.read((char*)&(data._attach_flag),1);
+      _attach_flag = ReadFlag(fields);
 
-      is.read(buf12,12);
-      data._last_zero_doppler_time = buf12;
+      fields.readString(12, _last_zero_doppler_time);
 
-      is.read(buf12,12);
-      data._work_order_id = buf12;
+      fields.readString(12, _work_order_id);
 
-      is.read((char*)&(data._time_diff),4);
-      data.SwitchEndian(data._time_diff);
+      fields.readBinary(&_time_diff, 4);
+      SwitchEndian(_time_diff);
 
-      is.read(buf3,3);
-      data._swath_num = buf3;
+      fields.readString(3, _swath_num);
 
-      is.read((char*)&(data._range_spacing),4);
-      data.SwitchEndian(data._range_spacing);
+      fields.readBinary(&_range_spacing, 4);
+      SwitchEndian(_range_spacing);
 
-      is.read((char*)&(data._azimut_spacing),4);
-      data.SwitchEndian(data._azimut_spacing);
+      fields.readBinary(&_azimut_spacing, 4);
+      SwitchEndian(_azimut_spacing);
 
-      is.read((char*)&(data._line_time_interval),4);
-      data.SwitchEndian(data._line_time_interval);
+      fields.readBinary(&_line_time_interval, 4);
+      SwitchEndian(_line_time_interval);
 
-      is.read((char*)&(data._num_output_lines),4);
-      data.SwitchEndian(data._num_output_lines);
+      fields.readBinary(&_num_output_lines, 4);
+      SwitchEndian(_num_output_lines);
 
-      is.read((char*)&(data._num_samples_per_line),4);
-      data.SwitchEndian(data._num_samples_per_line);
+      fields.readBinary(&_num_samples_per_line, 4);
+      SwitchEndian(_num_samples_per_line);
 
-      is.read(buf5,5);
-      data._data_type = buf5;
+      fields.readString(5, _data_type);
 
-      is.read((char*)&(data._num_range_lines_per_burst),4);
-      data.SwitchEndian(data._num_range_lines_per_burst);
+      fields.readBinary(&_num_range_lines_per_burst, 4);
+      SwitchEndian(_num_range_lines_per_burst);
 
-      is.read((char*)&(data._time_diff_zero_doppler),4);
-      data.SwitchEndian(data._time_diff_zero_doppler);
+      fields.readBinary(&_time_diff_zero_doppler, 4);
+      SwitchEndian(_time_diff_zero_doppler);
 
-      is.read(buf64,43);
+      fields.skip(43);
 
-      is.read((char*)&(data._data_analysis_flag),1);
+      _data_analysis_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._ant_elev_coor_flag),1);
+      _ant_elev_coor_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._chirp_extract_flag),1);
+      _chirp_extract_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._srgr_flag),1);
+      _srgr_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._dop_cen_flag),1);
+      _dop_cen_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._dop_amb_flag),1);
+      _dop_amb_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._range_spread_comp_flag),1);
+      _range_spread_comp_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._detected_flag),1);
+      _detected_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._look_sum_flag),1);
+      _look_sum_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._rms_equal_flag),1);
+      _rms_equal_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._ant_scal_flag),1);
+      _ant_scal_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._vga_com_echo_flag),1);
+      _vga_com_echo_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._vga_com_cal_flag),1);
+      _vga_com_cal_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._vga_com_nom_time_flag),1);
+      _vga_com_nom_time_flag = ReadFlag(fields);
 
-      is.read((char*)&(data._gm_rng_comp_inv_filter_flag),1);
+      _gm_rng_comp_inv_filter_flag = ReadFlag(fields);
 
-      is.read(buf6,6);
+      fields.skip(6);
 
-      char buf184[185];
-      buf184[184] = '\0';
-      is.read(buf184,184);
-      data._raw_data_analysis = buf184;
+      fields.readString(184, _raw_data_analysis);
 
-      is.read(buf32,32);
+      fields.skip(32);
 
-      is.read(buf20,20);
-      data._start_time_mds1 = buf20;
+      fields.readString(20, _start_time_mds1);
 
-      is.read(buf20,20);
-      data._start_time_mds2 = buf20;
+      fields.readString(20, _start_time_mds2);
 
-      char buf120[121];
-      buf120[120] = '\0';
-      is.read(buf120,120);
-      data._parameter_code = buf120;
+      fields.readString(120, _parameter_code);
 
-      is.read(buf64,60);
+      fields.skip(60);
 
-      is.read(buf64,40);
-      buf64[40] = '\0';
-      data._errors_counters = buf64;
+      fields.readString(40, _errors_counters);
 
-      is.read(buf32,26);
+      fields.skip(26);
 
-      is.read(buf64,60);
-      buf64[60] = '\0';
-      data._image_parameters1 = buf64;
+      fields.readString(60, _image_parameters1);
 
       for (int i = 0; i<5; i++)
       {
-         is.read((char*)&(data._prf_values[i]),4);
-         data.SwitchEndian(data._prf_values[i]);
+         fields.readBinary(&_prf_values[i], 4);
+         SwitchEndian(_prf_values[i]);
       }
 
-      char buf190[191];
-      buf190[190] = '\0';
-      is.read(buf190,190);
-      data._image_parameters2 = buf190;
+      fields.readString(190, _image_parameters2);
 
-      is.read(buf64,62);
+      fields.skip(62);
 
-      is.read((char*)&(data._first_proc_range_samp),4);
-      data.SwitchEndian(data._first_proc_range_samp);
+      fields.readBinary(&_first_proc_range_samp, 4);
+      SwitchEndian(_first_proc_range_samp);
 
-      is.read((char*)&(data._range_ref),4);
-      data.SwitchEndian(data._range_ref);
+      fields.readBinary(&_range_ref, 4);
+      SwitchEndian(_range_ref);
 
-      is.read((char*)&(data._range_samp_rate),4);
-      data.SwitchEndian(data._range_samp_rate);
+      fields.readBinary(&_range_samp_rate, 4);
+      SwitchEndian(_range_samp_rate);
 
-      is.read((char*)&(data._radar_freq),4);
-      data.SwitchEndian(data._radar_freq);
+      fields.readBinary(&_radar_freq, 4);
+      SwitchEndian(_radar_freq);
 
-      is.read((char*)&(data._num_looks_range),2);
-      data.SwitchEndian(data._num_looks_range);
+      fields.readBinary(&_num_looks_range, 2);
+      SwitchEndian(_num_looks_range);
 
-      is.read(buf7,7);
-      data._filter_range = buf7;
+      fields.readString(7, _filter_range);
 
-      is.read((char*)&(data._filter_coef_range),4);
-      data.SwitchEndian(data._filter_coef_range);
+      fields.readBinary(&_filter_coef_range, 4);
+      SwitchEndian(_filter_coef_range);
 
-      is.read(buf64,40);
-      buf64[40] = '\0';
-      data._bandwidth = buf64;
+      fields.readString(40, _bandwidth);
 
-      char buf160[161];
-      buf160[160] = '\0';
-      is.read(buf160,160);
-      data._nominal_chirp = buf160;
+      fields.readString(160, _nominal_chirp);
 
-      is.read(buf64,60);
+      fields.skip(60);
 
-      is.read((char*)&(data._num_lines_proc),4);
-      data.SwitchEndian(data._num_lines_proc);
+      fields.readBinary(&_num_lines_proc, 4);
+      SwitchEndian(_num_lines_proc);
 
-      is.read((char*)&(data._num_look_az),2);
-      data.SwitchEndian(data._num_look_az);
+      fields.readBinary(&_num_look_az, 2);
+      SwitchEndian(_num_look_az);
 
-      is.read((char*)&(data._look_bw_az),4);
-      data.SwitchEndian(data._look_bw_az);
+      fields.readBinary(&_look_bw_az, 4);
+      SwitchEndian(_look_bw_az);
 
-      is.read((char*)&(data._to_bw_az),4);
-      data.SwitchEndian(data._to_bw_az);
+      fields.readBinary(&_to_bw_az, 4);
+      SwitchEndian(_to_bw_az);
 
-      is.read(buf7,7);
-      data._filter_az = buf7;
+      fields.readString(7, _filter_az);
 
-      is.read((char*)&(data._filter_coef_az),4);
-      data.SwitchEndian(data._filter_coef_az);
+      fields.readBinary(&_filter_coef_az, 4);
+      SwitchEndian(_filter_coef_az);
 
       for (int i = 0; i <3; i++) {
-         is.read((char*)&(data._az_fm_rate[i]),4);
-         data.SwitchEndian(data._az_fm_rate[i]);
+         fields.readBinary(&_az_fm_rate[i], 4);
+         SwitchEndian(_az_fm_rate[i]);
       }
 
-      is.read((char*)&(data._ax_fm_origin),4);
-      data.SwitchEndian(data._ax_fm_origin);
+      fields.readBinary(&_ax_fm_origin, 4);
+      SwitchEndian(_ax_fm_origin);
 
-      is.read((char*)&(data._dop_amb_coef),4);
-      data.SwitchEndian(data._dop_amb_coef);
+      fields.readBinary(&_dop_amb_coef, 4);
+      SwitchEndian(_dop_amb_coef);
 
-      char buf128[129];
-      buf128[128] = '\0';
-      is.read(buf128,68);
+      fields.skip(68);
 
-      is.read(buf16,16);
-      data._calibration_factors = buf16;
+      fields.readString(16, _calibration_factors);
 
-      is.read(buf64,40);
-      buf64[40]='\0';
-      data._noise_estimation = buf64;
+      fields.readString(40, _noise_estimation);
 
-      is.read(buf64,64);
+      fields.skip(64);
 
-      is.read(buf12,12);
+      fields.skip(12);
 
-      is.read(buf32,32);
-      data._output_statistics = buf32;
+      fields.readString(32, _output_statistics);
 
-      is.read((char*)&(data._avg_scene_height_ellpsoid),4);
-      data.SwitchEndian(data._avg_scene_height_ellpsoid);
+      fields.readBinary(&_avg_scene_height_ellpsoid, 4);
+      SwitchEndian(_avg_scene_height_ellpsoid);
 
-      is.read(buf64,48);
+      fields.skip(48);
 
-      is.read(buf4,4);
-      data._echo_comp = buf4;
+      fields.readString(4, _echo_comp);
 
-      is.read(buf3,3);
-      data._echo_comp_ratio = buf3;
+      fields.readString(3, _echo_comp_ratio);
 
-      is.read(buf4,4);
-      data._init_cal_comp = buf4;
+      fields.readString(4, _init_cal_comp);
 
-      is.read(buf3,3);
-      data._init_cal_ratio = buf3;
+      fields.readString(3, _init_cal_ratio);
 
-      is.read(buf4,4);
-      data._per_cal_comp = buf4;
+      fields.readString(4, _per_cal_comp);
 
-      is.read(buf3,3);
-      data._per_cal_ratio = buf3;
+      fields.readString(3, _per_cal_ratio);
 
-      is.read(buf4,4);
-      data._noise_comp = buf4;
+      fields.readString(4, _noise_comp);
 
-      is.read(buf3,3);
-      data._noise_comp_ratio = buf3;
+      fields.readString(3, _noise_comp_ratio);
 
-      is.read(buf64,64);
+      fields.skip(64);
 
       for (int i=0;i<4;i++)
       {
-         is.read((char*)&(data._beam_overlap[i]),4);
-         data.SwitchEndian(data._beam_overlap[i]);
+         fields.readBinary(&_beam_overlap[i], 4);
+         SwitchEndian(_beam_overlap[i]);
       }
       for (int i=0;i<4;i++)
       {
-         is.read((char*)&(data._beam_param[i]),4);
-         data.SwitchEndian(data._beam_param[i]);
+         fields.readBinary(&_beam_param[i], 4);
+         SwitchEndian(_beam_param[i]);
       }
       for (int i=0;i<5;i++)
       {
-         is.read((char*)&(data._lines_per_burst[i]),4);
-         data.SwitchEndian(data._lines_per_burst[i]);
+         fields.readBinary(&_lines_per_burst[i], 4);
+         SwitchEndian(_lines_per_burst[i]);
       }
 
-      is.read(buf12,12);
-      data._time_first_SS1_echo = buf12;
-
-      is.read(buf16,16);
+      fields.readString(12, _time_first_SS1_echo);
 
-      is.read((char*)&(data._state_vector_time_1_day),4);
-      data.SwitchEndian(data._state_vector_time_1_day);
+      fields.skip(16);
 
-      is.read((char*)&(data._state_vector_time_1_sec),4);
-      data.SwitchEndian(data._state_vector_time_1_sec);
+      fields.readBinary(&_state_vector_time_1_day, 4);
+      SwitchEndian(_state_vector_time_1_day);
 
-      is.read((char*)&(data._state_vector_time_1_microsec),4);
-      data.SwitchEndian(data._state_vector_time_1_microsec);
+      fields.readBinary(&_state_vector_time_1_sec, 4);
+      SwitchEndian(_state_vector_time_1_sec);
 
-      is.read((char*)&(data._x_pos_1),4);
-      data.SwitchEndian(data._x_pos_1);
+      fields.readBinary(&_state_vector_time_1_microsec, 4);
+      SwitchEndian(_state_vector_time_1_microsec);
 
-      is.read((char*)&(data._y_pos_1),4);
-      data.SwitchEndian(data._y_pos_1);
+      fields.readBinary(&_x_pos_1, 4);
+      SwitchEndian(_x_pos_1);
 
-      is.read((char*)&(data._z_pos_1),4);
-      data.SwitchEndian(data._z_pos_1);
+      fields.readBinary(&_y_pos_1, 4);
+      SwitchEndian(_y_pos_1);
 
-      is.read((char*)&(data._x_vel_1),4);
-      data.SwitchEndian(data._x_vel_1);
+      fields.readBinary(&_z_pos_1, 4);
+      SwitchEndian(_z_pos_1);
 
-      is.read((char*)&(data._y_vel_1),4);
-      data.SwitchEndian(data._y_vel_1);
+      fields.readBinary(&_x_vel_1, 4);
+      SwitchEndian(_x_vel_1);
 
-      is.read((char*)&(data._z_vel_1),4);
-      data.SwitchEndian(data._z_vel_1);
+      fields.readBinary(&_y_vel_1, 4);
+      SwitchEndian(_y_vel_1);
 
-      is.read((char*)&(data._state_vector_time_2_day),4);
-      data.SwitchEndian(data._state_vector_time_2_day);
+      fields.readBinary(&_z_vel_1, 4);
+      SwitchEndian(_z_vel_1);
 
-      is.read((char*)&(data._state_vector_time_2_sec),4);
-      data.SwitchEndian(data._state_vector_time_2_sec);
+      fields.readBinary(&_state_vector_time_2_day, 4);
+      SwitchEndian(_state_vector_time_2_day);
 
-      is.read((char*)&(data._state_vector_time_2_microsec),4);
-      data.SwitchEndian(data._state_vector_time_2_microsec);
+      fields.readBinary(&_state_vector_time_2_sec, 4);
+      SwitchEndian(_state_vector_time_2_sec);
 
-      is.read((char*)&(data._x_pos_2),4);
-      data.SwitchEndian(data._x_pos_2);
+      fields.readBinary(&_state_vector_time_2_microsec, 4);
+      SwitchEndian(_state_vector_time_2_microsec);
 
-      is.read((char*)&(data._y_pos_2),4);
-      data.SwitchEndian(data._y_pos_2);
+      fields.readBinary(&_x_pos_2, 4);
+      SwitchEndian(_x_pos_2);
 
-      is.read((char*)&(data._z_pos_2),4);
-      data.SwitchEndian(data._z_pos_2);
+      fields.readBinary(&_y_pos_2, 4);
+      SwitchEndian(_y_pos_2);
 
-      is.read((char*)&(data._x_vel_2),4);
-      data.SwitchEndian(data._x_vel_2);
+      fields.readBinary(&_z_pos_2, 4);
+      SwitchEndian(_z_pos_2);
 
-      is.read((char*)&(data._y_vel_2),4);
-      data.SwitchEndian(data._y_vel_2);
+      fields.readBinary(&_x_vel_2, 4);
+      SwitchEndian(_x_vel_2);
 
-      is.read((char*)&(data._z_vel_2),4);
-      data.SwitchEndian(data._z_vel_2);
+      fields.readBinary(&_y_vel_2, 4);
+      SwitchEndian(_y_vel_2);
 
-      is.read((char*)&(data._state_vector_time_3_day),4);
-      data.SwitchEndian(data._state_vector_time_3_day);
+      fields.readBinary(&_z_vel_2, 4);
+      SwitchEndian(_z_vel_2);
 
-      is.read((char*)&(data._state_vector_time_3_sec),4);
-      data.SwitchEndian(data._state_vector_time_3_sec);
+      fields.readBinary(&_state_vector_time_3_day, 4);
+      SwitchEndian(_state_vector_time_3_day);
 
-      is.read((char*)&(data._state_vector_time_3_microsec),4);
-      data.SwitchEndian(data._state_vector_time_3_microsec);
+      fields.readBinary(&_state_vector_time_3_sec, 4);
+      SwitchEndian(_state_vector_time_3_sec);
 
-      is.read((char*)&(data._x_pos_3),4);
-      data.SwitchEndian(data._x_pos_3);
+      fields.readBinary(&_state_vector_time_3_microsec, 4);
+      SwitchEndian(_state_vector_time_3_microsec);
 
-      is.read((char*)&(data._y_pos_3),4);
-      data.SwitchEndian(data._y_pos_3);
+      fields.readBinary(&_x_pos_3, 4);
+      SwitchEndian(_x_pos_3);
 
-      is.read((char*)&(data._z_pos_3),4);
-      data.SwitchEndian(data._z_pos_3);
+      fields.readBinary(&_y_pos_3, 4);
+      SwitchEndian(_y_pos_3);
 
-      is.read((char*)&(data._x_vel_3),4);
-      data.SwitchEndian(data._x_vel_3);
+      fields.readBinary(&_z_pos_3, 4);
+      SwitchEndian(_z_pos_3);
 
-      is.read((char*)&(data._y_vel_3),4);
-      data.SwitchEndian(data._y_vel_3);
+      fields.readBinary(&_x_vel_3, 4);
+      SwitchEndian(_x_vel_3);
 
-      is.read((char*)&(data._z_vel_3),4);
-      data.SwitchEndian(data._z_vel_3);
+      fields.readBinary(&_y_vel_3, 4);
+      SwitchEndian(_y_vel_3);
 
-      is.read((char*)&(data._state_vector_time_4_day),4);
-      data.SwitchEndian(data._state_vector_time_4_day);
+      fields.readBinary(&_z_vel_3, 4);
+      SwitchEndian(_z_vel_3);
 
-      is.read((char*)&(data._state_vector_time_4_sec),4);
-      data.SwitchEndian(data._state_vector_time_4_sec);
+      fields.readBinary(&_state_vector_time_4_day, 4);
+      SwitchEndian(_state_vector_time_4_day);
 
-      is.read((char*)&(data._state_vector_time_4_microsec),4);
-      data.SwitchEndian(data._state_vector_time_4_microsec);
+      fields.readBinary(&_state_vector_time_4_sec, 4);
+      SwitchEndian(_state_vector_time_4_sec);
 
-      is.read((char*)&(data._x_pos_4),4);
-      data.SwitchEndian(data._x_pos_4);
+      fields.readBinary(&_state_vector_time_4_microsec, 4);
+      SwitchEndian(_state_vector_time_4_microsec);
 
-      is.read((char*)&(data._y_pos_4),4);
-      data.SwitchEndian(data._y_pos_4);
+      fields.readBinary(&_x_pos_4, 4);
+      SwitchEndian(_x_pos_4);
 
-      is.read((char*)&(data._z_pos_4),4);
-      data.SwitchEndian(data._z_pos_4);
+      fields.readBinary(&_y_pos_4, 4);
+      SwitchEndian(_y_pos_4);
 
-      is.read((char*)&(data._x_vel_4),4);
-      data.SwitchEndian(data._x_vel_4);
+      fields.readBinary(&_z_pos_4, 4);
+      SwitchEndian(_z_pos_4);
 
-      is.read((char*)&(data._y_vel_4),4);
-      data.SwitchEndian(data._y_vel_4);
+      fields.readBinary(&_x_vel_4, 4);
+      SwitchEndian(_x_vel_4);
 
-      is.read((char*)&(data._z_vel_4),4);
-      data.SwitchEndian(data._z_vel_4);
+      fields.readBinary(&_y_vel_4, 4);
+      SwitchEndian(_y_vel_4);
 
-      is.read((char*)&(data._state_vector_time_5_day),4);
-      data.SwitchEndian(data._state_vector_time_5_day);
+      fields.readBinary(&_z_vel_4, 4);
+      SwitchEndian(_z_vel_4);
 
-      is.read((char*)&(data._state_vector_time_5_sec),4);
-      data.SwitchEndian(data._state_vector_time_5_sec);
+      fields.readBinary(&_state_vector_time_5_day, 4);
+      SwitchEndian(_state_vector_time_5_day);
 
-      is.read((char*)&(data._state_vector_time_5_microsec),4);
-      data.SwitchEndian(data._state_vector_time_5_microsec);
+      fields.readBinary(&_state_vector_time_5_sec, 4);
+      SwitchEndian(_state_vector_time_5_sec);
 
-      is.read((char*)&(data._x_pos_5),4);
-      data.SwitchEndian(data._x_pos_5);
+      fields.readBinary(&_state_vector_time_5_microsec, 4);
+      SwitchEndian(_state_vector_time_5_microsec);
 
-      is.read((char*)&(data._y_pos_5),4);
-      data.SwitchEndian(data._y_pos_5);
+      fields.readBinary(&_x_pos_5, 4);
+      SwitchEndian(_x_pos_5);
 
-      is.read((char*)&(data._z_pos_5),4);
-      data.SwitchEndian(data._z_pos_5);
+      fields.readBinary(&_y_pos_5, 4);
+      SwitchEndian(_y_pos_5);
 
-      is.read((char*)&(data._x_vel_5),4);
-      data.SwitchEndian(data._x_vel_5);
+      fields.readBinary(&_z_pos_5, 4);
+      SwitchEndian(_z_pos_5);
 
-      is.read((char*)&(data._y_vel_5),4);
-      data.SwitchEndian(data._y_vel_5);
+      fields.readBinary(&_x_vel_5, 4);
+      SwitchEndian(_x_vel_5);
 
-      is.read((char*)&(data._z_vel_5),4);
-      data.SwitchEndian(data._z_vel_5);
+      fields.readBinary(&_y_vel_5, 4);
+      SwitchEndian(_y_vel_5);
 
-      is.read(buf64,64);
-
-      return is;
+      fields.readBinary(&_z_vel_5, 4);
+      SwitchEndian(_z_vel_5);
 
+      fields.skip(64);
    }
 
    MainProcessingParameters::MainProcessingParameters(const MainProcessingParameters& rhs):
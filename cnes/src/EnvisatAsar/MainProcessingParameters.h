@@ -15,6 +15,7 @@
 #include <iostream>
 #include <sstream>
 #include <EnvisatAsar/EnvisatAsarRecord.h>
+#include <ossimFixedWidthFieldReader.h>
 
 namespace ossimplugins
 {
@@ -79,6 +80,11 @@ public:
     is>>*this;
   };
 
+  /**
+   * @brief Reads the class data from the fixed width fields of a record
+   */
+  void Read(ossimFixedWidthFieldReader& fields);
+
   /**
    * @brief Writes the class to a stream
    */
@@ -36,34 +36,21 @@ std::ostream& operator<<(std::ostream& os, const AttitudeData& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, AttitudeData& data)
+void AttitudeData::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[6503];
-	buf[6502] = '\0';
-
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._npoint = atoi(buf);
+	_npoint = fields.readInt(4);
 
 	for (int i=0;i<20;i++)
 	{
-		is>>data._att_vect[i];
+		_att_vect[i].Read(fields);
 	}
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._pitch_bias = atof(buf);
-
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._roll_bias = atof(buf);
+    _pitch_bias = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._yaw_bias = atof(buf);
+    _roll_bias = fields.readDouble(14);
 
-	is.read(buf,6502);
+    _yaw_bias = fields.readDouble(14);
 
-	return is;
+	fields.skip(6502);
 }
 
 AttitudeData::AttitudeData(const AttitudeData& rhs):
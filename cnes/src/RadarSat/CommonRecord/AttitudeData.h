@@ -52,11 +52,6 @@ public:
    */
   friend std::ostream& operator<<(std::ostream& os, const AttitudeData& data);
 
-  /**
-   * @brief This function reads a AttitudeData from a stream
-   */
-  friend std::istream& operator>>(std::istream& is, AttitudeData& data);
-
   /**
    * @brief This function is able to create a new instance of the class
    */
@@ -74,12 +69,9 @@ public:
   };
 
   /**
-   * @brief Reads the class data from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  void Read(std::istream& is)
-  {
-    is>>*this;
-  };
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Writes the class to a stream
@@ -34,28 +34,15 @@ std::ostream& operator<<(std::ostream& os, const BeamInformationRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, BeamInformationRecord& data)
+void BeamInformationRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[17];
-	buf[16] = '\0';
+	fields.readString(3, _beam_type);
 
-	is.read(buf,3);
-	buf[3] = '\0';
-	data._beam_type = buf;
+	fields.readString(9, _beam_look_src);
 
-	is.read(buf,9);
-	buf[9] = '\0';
-	data._beam_look_src = buf;
+    _beam_look_ang = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._beam_look_ang = atof(buf);
-
-	is.read(buf,16);
-	buf[16] = '\0';
-	data._prf = atof(buf);
-
-	return is;
+	_prf = fields.readDouble(16);
 }
 
 BeamInformationRecord::BeamInformationRecord(const BeamInformationRecord& rhs):
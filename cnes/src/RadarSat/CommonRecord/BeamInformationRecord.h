@@ -51,9 +51,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const BeamInformationRecord& data);
 
   /**
-   * @brief This function reads a BeamInformationRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, BeamInformationRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Beam type
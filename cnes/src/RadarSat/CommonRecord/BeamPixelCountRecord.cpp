@@ -32,21 +32,14 @@ std::ostream& operator<<(std::ostream& os, const BeamPixelCountRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, BeamPixelCountRecord& data)
+void BeamPixelCountRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[23];
-	buf[22] = '\0';
-
-	is.read(buf,21);
-	data._pix_update = buf;
+	fields.readString(21, _pix_update);
 
 	for (int i=0;i<4;i++)
 	{
-		is.read(buf,8);
-		buf[8] = '\0';
-		data._n_pix[i] = atoi(buf);
+		_n_pix[i] = fields.readInt(8);
 	}
-	return is;
 }
 
 BeamPixelCountRecord::BeamPixelCountRecord(const BeamPixelCountRecord& rhs):
@@ -51,9 +51,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const BeamPixelCountRecord& data);
 
   /**
-   * @brief This function reads a BeamPixelCountRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, BeamPixelCountRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Pixel count update date/time
@@ -46,52 +46,28 @@ std::ostream& operator<<(std::ostream& os, const CompensationDataRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, CompensationDataRecord& data)
+void CompensationDataRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[33];
-	buf[32] = '\0';
+	fields.readString(8, _comp_desig);
 
+	fields.readString(32, _comp_descr);
 
-	is.read(buf,8);
-	buf[8] = '\0';
-	data._comp_desig = buf;
+    _n_comp_rec = fields.readInt(4);
 
-	is.read(buf,32);
-	buf[32] = '\0';
-	data._comp_descr = buf;
+    _comp_seq_no = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._n_comp_rec = atoi(buf);
-
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._comp_seq_no = atoi(buf);
-
-    is.read(buf,8);
-	buf[8] = '\0';
-	data._beam_tab_size = atoi(buf);
+    _beam_tab_size = fields.readInt(8);
 
 	for (int i=0;i<256;i++)
 	{
-		is.read(buf,16);
-		buf[16] = '\0';
-		data._beam_tab[i] = atof(buf);
+		_beam_tab[i] = fields.readDouble(16);
 	}
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._beam_type = buf;
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._look_angle = atof(buf);
+    fields.readString(16, _beam_type);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._beam_tab_inc = atof(buf);
+    _look_angle = fields.readDouble(16);
 
-	return is;
+    _beam_tab_inc = fields.readDouble(16);
 }
 
 CompensationDataRecord::CompensationDataRecord(const CompensationDataRecord& rhs)
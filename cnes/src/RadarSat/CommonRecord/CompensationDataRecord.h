@@ -51,9 +51,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const CompensationDataRecord& data);
 
   /**
-   * @brief This function reads a CompensationDataRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, CompensationDataRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Compensation data designator
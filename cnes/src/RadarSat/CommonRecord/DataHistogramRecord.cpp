@@ -128,109 +128,63 @@ std::ostream& operator<<(std::ostream& os, const DataHistogramRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DataHistogramRecord& data)
+void DataHistogramRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buff[33];
-	buff[32] = '\0';
+	fields.readString(32, _hist_desc);
 
-	is.read(buff,32);
-	data._hist_desc = buff;
+    _nrec = fields.readInt(4);
 
-    is.read(buff,4);
-	buff[4] = '\0';
-	data._nrec = atoi(buff);
+    _tab_seq = fields.readInt(4);
 
-    is.read(buff,4);
-	buff[4] = '\0';
-	data._tab_seq = atoi(buff);
+    _nbin = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._nbin = atoi(buff);
+    _ns_lin = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._ns_lin = atoi(buff);
+    _ns_pix = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._ns_pix = atoi(buff);
+    _ngrp_lin = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._ngrp_lin = atoi(buff);
+    _ngrp_pix = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._ngrp_pix = atoi(buff);
+    _nsamp_lin = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._nsamp_lin = atoi(buff);
+    _nsamp_pix = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._nsamp_pix = atoi(buff);
+    _min_smp = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._min_smp = atof(buff);
+    _max_smp = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._max_smp = atof(buff);
+    _mean_smp = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._mean_smp = atof(buff);
+    _std_smp = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._std_smp = atof(buff);
+    _smp_inc = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._smp_inc = atof(buff);
+    _min_hist = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._min_hist = atof(buff);
+    _max_hist = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._max_hist = atof(buff);
+    _mean_hist = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._mean_hist = atof(buff);
+    _std_hist = fields.readDouble(16);
 
-    is.read(buff,16);
-	buff[16] = '\0';
-	data._std_hist = atof(buff);
+    _nhist = fields.readInt(8);
 
-    is.read(buff,8);
-	buff[8] = '\0';
-	data._nhist = atoi(buff);
-
-	if(data._hist != NULL)
+	if(_hist != NULL)
 	{
-		delete[] data._hist;
+		delete[] _hist;
 	}
 
-	//for (int i=0;i<data._nhist;i++)
+	//for (int i=0;i<_nhist;i++)
 	int nhist ;
-	if (data._nhist == 256)
+	if (_nhist == 256)
 		{  nhist = 256 ; } // Signal Data
 	else {nhist = 1024 ; } // Processed Data
 
-	data._hist = new int[nhist];
+	_hist = new int[nhist];
 	for (int i=0;i<nhist;i++)
 	{
-		is.read(buff,8);
-		buff[8] = '\0';
-		data._hist[i] = atoi(buff);
+		_hist[i] = fields.readInt(8);
 	}
-
-	return is;
 }
 }
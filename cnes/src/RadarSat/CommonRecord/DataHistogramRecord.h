@@ -53,9 +53,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const DataHistogramRecord& data);
 
   /**
-   * @brief This function reads a DataHistogramRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, DataHistogramRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
 
 
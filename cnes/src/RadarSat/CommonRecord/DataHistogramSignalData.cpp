@@ -38,35 +38,19 @@ std::ostream& operator<<(std::ostream& os, const DataHistogramSignalData& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DataHistogramSignalData& data)
+void DataHistogramSignalData::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buff[33];
-	buff[32] = '\0';
+	_rec_seq = fields.readInt(4);
 
+    _sar_chn = fields.readInt(4);
 
-	is.read(buff,4);
-	buff[4] = '\0';
-	data._rec_seq = atoi(buff);
+	_ntab = fields.readInt(8);
 
-    is.read(buff,4);
-	buff[4] = '\0';
-	data._sar_chn = atoi(buff);
+	_ltab = fields.readInt(8);
 
-	is.read(buff,8);
-	buff[8] = '\0';
-	data._ntab = atoi(buff);
+	_histogram.Read(fields);
 
-	is.read(buff,8);
-	buff[8] = '\0';
-	data._ltab = atoi(buff);
-
-	is>>data._histogram;
-
-	char tmp[14589];
-	tmp[14588] = '\0';
-	is.read(tmp, 14588);
-
-	return is;
+	fields.skip(14588);
 }
 
 DataHistogramSignalData::DataHistogramSignalData(const DataHistogramSignalData& rhs) :
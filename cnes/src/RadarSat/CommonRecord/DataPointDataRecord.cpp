@@ -40,68 +40,35 @@ std::ostream& operator<<(std::ostream& os, const DataPointDataRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DataPointDataRecord& data)
+void DataPointDataRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[15];
-	buf[14] = '\0';
+	_gmt_day = fields.readInt(4);
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._gmt_day = atoi(buf);
+	_gmt_sec = fields.readInt(8);
 
-	is.read(buf,8);
-	buf[8] = '\0';
-	data._gmt_sec = atoi(buf);
+    _pitch_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._pitch_flag = atoi(buf);
+    _roll_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._roll_flag = atoi(buf);
+    _yaw_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._yaw_flag = atoi(buf);
+    _pitch = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._pitch = atof(buf);
+    _roll = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._roll = atof(buf);
+    _yaw = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._yaw = atof(buf);
+    _pitch_rate_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._pitch_rate_flag = atoi(buf);
+    _roll_rate_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._roll_rate_flag = atoi(buf);
+    _yaw_rate_flag = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._yaw_rate_flag = atoi(buf);
+    _pitch_rate = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._pitch_rate = atof(buf);
+    _roll_rate = fields.readDouble(14);
 
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._roll_rate = atof(buf);
-
-    is.read(buf,14);
-	buf[14] = '\0';
-	data._yaw_rate = atof(buf);
-
-	return is;
+    _yaw_rate = fields.readDouble(14);
 }
 
 DataPointDataRecord::DataPointDataRecord(const DataPointDataRecord& rhs)
@@ -51,9 +51,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const DataPointDataRecord& data);
 
   /**
-   * @brief This function reads a DataPointDataRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, DataPointDataRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Day of the year, GMT
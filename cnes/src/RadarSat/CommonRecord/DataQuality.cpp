@@ -88,126 +88,69 @@ std::ostream& operator<<(std::ostream& os, const DataQuality& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DataQuality& data)
+void DataQuality::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[2149];
-	buf[2148] = '\0';
+	_rec_seq = fields.readInt(4);
 
+	fields.readString(4, _sar_chn);
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._rec_seq = atoi(buf);
+    fields.readString(6, _cali_date);
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._sar_chn = buf;
+    _nchn = fields.readInt(4);
 
-    is.read(buf,6);
-	buf[6] = '\0';
-	data._cali_date = buf;
+    _islr = fields.readDouble(16);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._nchn = atoi(buf);
+    _pslr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._islr = atof(buf);
+    _azi_ambig = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._pslr = atof(buf);
+    _rng_ambig = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._azi_ambig = atof(buf);
+    _snr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rng_ambig = atof(buf);
+    _ber = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._snr = atof(buf);
+    _rng_res = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._ber = atof(buf);
+    _azi_res = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rng_res = atof(buf);
+    _rad_res = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._azi_res = atof(buf);
+    _dyn_rng = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rad_res = atof(buf);
+    _rad_unc_db = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._dyn_rng = atof(buf);
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rad_unc_db = atof(buf);
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rad_unc_deg = atof(buf);
+    _rad_unc_deg = fields.readDouble(16);
 
 	for (int i=0;i<16;i++)
 	{
-		is>>data._rad_unc[i];
+		_rad_unc[i].Read(fields);
 	}
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._alt_locerr = atof(buf);
+    _alt_locerr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._crt_locerr = atof(buf);
+    _crt_locerr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._alt_scale = atof(buf);
+    _alt_scale = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._crt_scale = atof(buf);
+    _crt_scale = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._dis_skew = atof(buf);
+    _dis_skew = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._ori_err = atof(buf);
+    _ori_err = fields.readDouble(16);
 
 	for (int i=0;i<16;i++)
 	{
-		is>>data._misreg[i];
+		_misreg[i].Read(fields);
 	}
 
-	is.read(buf,16);
-	buf[16] = '\0';
-	data._nesz = atof(buf);
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._enl = atof(buf);
-
-    is.read(buf,8);
-	buf[8] = '\0';
-	data._tb_update = buf;
+	_nesz = fields.readDouble(16);
 
-    is.read(buf,238);
+    _enl = fields.readDouble(16);
 
+    fields.readString(8, _tb_update);
 
-	return is;
+    fields.skip(238);
 }
 
 DataQuality::DataQuality(const DataQuality& rhs):
@@ -207,338 +207,222 @@ std::ostream& operator<<(std::ostream& os, const DataSetSummary& data)
 
 }
 
-std::istream& operator>>(std::istream& is, DataSetSummary& data)
+void DataSetSummary::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf16[17];
-	buf16[16]='\0';
-	char buf32[33];
-	buf32[32] = '\0';
-	char buf8[9];
-	buf8[8] = '\0';
-	char buf4[5];
-	buf4[4] = '\0';
+	_seq_num = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._seq_num = atoi(buf4);
+	_sar_chn = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._sar_chn = atoi(buf4);
+	fields.readString(16, _scene_id);
 
-	is.read(buf16,16);
-	data._scene_id = buf16;
+	fields.readString(32, _scene_des);
 
-	is.read(buf32,32);
-	data._scene_des = buf32;
+	fields.readString(32, _inp_sctim);
 
-	is.read(buf32,32);
-	data._inp_sctim = buf32;
+	fields.readString(16, _asc_des);
 
-	is.read(buf16,16);
-	data._asc_des = buf16;
+	_pro_lat = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._pro_lat = atof(buf16);
+    _pro_long = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._pro_long = atof(buf16);
+    _pro_head = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._pro_head = atof(buf16);
+	fields.readString(16, _ellip_des);
 
-	is.read(buf16,16);
-	data._ellip_des = buf16;
+	_ellip_maj = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._ellip_maj = atof(buf16);
+	_ellip_min = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._ellip_min = atof(buf16);
+	_earth_mass = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._earth_mass = atof(buf16);
+    _grav_const = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._grav_const = atof(buf16);
+	_ellip_j[0] = fields.readDouble(16);
+	_ellip_j[1] = fields.readDouble(16);
+	_ellip_j[2] = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._ellip_j[0] = atof(buf16);
-	is.read(buf16,16);
-	data._ellip_j[1] = atof(buf16);
-	is.read(buf16,16);
-	data._ellip_j[2] = atof(buf16);
+    fields.skip(16);
 
-    is.read(buf16,16);
+    _terrain_h = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._terrain_h = atof(buf16);
+	_sc_lin = fields.readInt(8);
 
-	is.read(buf8,8);
-	data._sc_lin = atoi(buf8);
+	_sc_pix = fields.readInt(8);
 
-	is.read(buf8,8);
-	data._sc_pix = atoi(buf8);
+	_scene_len = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._scene_len = atof(buf16);
+	_scene_wid = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._scene_wid = atof(buf16);
+	fields.skip(16);
 
-	is.read(buf16,16);
+	_nchn = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._nchn = atoi(buf4);
+	fields.skip(4);
 
-	is.read(buf4,4);
+	fields.readString(16, _mission_id);
 
-	is.read(buf16,16);
-	data._mission_id = buf16;
+	fields.readString(32, _sensor_id);
 
-	is.read(buf32,32);
-	data._sensor_id = buf32;
+	fields.readString(8, _orbit_num);
 
-	is.read(buf8,8);
-	data._orbit_num = buf8;
+	_plat_lat = fields.readDouble(8);
 
-	is.read(buf8,8);
-	data._plat_lat = atof(buf8);
+    _plat_long = fields.readDouble(8);
 
-    is.read(buf8,8);
-	data._plat_long = atof(buf8);
+    _plat_head = fields.readDouble(8);
 
-    is.read(buf8,8);
-	data._plat_head = atof(buf8);
+    _clock_ang = fields.readDouble(8);
 
-    is.read(buf8,8);
-	data._clock_ang = atof(buf8);
+    _incident_ang = fields.readDouble(8);
 
-    is.read(buf8,8);
-	data._incident_ang = atof(buf8);
+    fields.skip(8);
 
-    is.read(buf8,8);
+	_wave_length = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._wave_length = atof(buf16);
+	fields.readString(2, _motion_comp);
 
-	is.read(buf8,2);
-	buf8[2] = '\0';
-	data._motion_comp = buf8;
-
-	is.read(buf16,16);
-	data._pulse_code = buf16;
+	fields.readString(16, _pulse_code);
 
 	for (int i=0;i<5;i++)
 	{
-		is.read(buf16,16);
-		data._ampl_coef[i] = atof(buf16);
+		_ampl_coef[i] = fields.readDouble(16);
 	}
 
     for (int i=0;i<5;i++)
 	{
-		is.read(buf16,16);
-		data._phas_coef[i] = atof(buf16);
+		_phas_coef[i] = fields.readDouble(16);
 	}
 
-    is.read(buf8,8);
-	data._chirp_ext_ind = atoi(buf8);
-
-    is.read(buf8,8);
-
-    is.read(buf16,16);
-	data._fr = atof(buf16);
+    _chirp_ext_ind = fields.readInt(8);
 
-    is.read(buf16,16);
-	data._rng_gate = atof(buf16);
+    fields.skip(8);
 
-    is.read(buf16,16);
-	data._rng_length = atof(buf16);
+    _fr = fields.readDouble(16);
 
-    is.read(buf8,4);
-	buf8[4] = '\0';
-	data._baseband_f = buf8;
+    _rng_gate = fields.readDouble(16);
 
-    is.read(buf8,4);
-	buf8[4] = '\0';
-	data._rngcmp_f = buf8;
+    _rng_length = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._gn_polar = atof(buf16);
+    fields.readString(4, _baseband_f);
 
-    is.read(buf16,16);
-	data._gn_cross = atof(buf16);
+    fields.readString(4, _rngcmp_f);
 
-    is.read(buf8,8);
-	data._chn_bits = atoi(buf8);
+	_gn_polar = fields.readDouble(16);
 
-    is.read(buf16,12);
-	buf16[12] = '\0';
-	data._quant_desc = buf16;
+    _gn_cross = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._i_bias = atof(buf16);
+    _chn_bits = fields.readInt(8);
 
-    is.read(buf16,16);
-	data._q_bias = atof(buf16);
+    fields.readString(12, _quant_desc);
 
-    is.read(buf16,16);
-	data._iq_ratio = atof(buf16);
+    _i_bias = fields.readDouble(16);
 
-    is.read(buf16,16);
+    _q_bias = fields.readDouble(16);
 
-    is.read(buf16,16);
+    _iq_ratio = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._ele_sight = atof(buf16);
+    fields.skip(16);
 
-    is.read(buf16,16);
-	data._mech_sight = atof(buf16);
+    fields.skip(16);
 
-    is.read(buf4,4);
-	data._echo_track = buf4;
+    _ele_sight = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._fa = atof(buf16);
+    _mech_sight = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._elev_beam = atof(buf16);
+    fields.readString(4, _echo_track);
 
-    is.read(buf16,16);
-	data._azim_beam = atof(buf16);
+    _fa = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._sat_bintim = atoi(buf16);
+    _elev_beam = fields.readDouble(16);
 
-    is.read(buf32,32);
-	data._sat_clktim = atoi(buf32);
+    _azim_beam = fields.readDouble(16);
 
-    is.read(buf8,8);
-	data._sat_clkinc = atoi(buf8);
+    _sat_bintim = fields.readInt(16);
 
-    is.read(buf8,8);
+    _sat_clktim = fields.readInt(32);
 
-    is.read(buf16,16);
-	data._fac_id = buf16;
+    _sat_clkinc = fields.readInt(8);
 
-    is.read(buf8,8);
-	data._sys_id = buf8;
+    fields.skip(8);
 
-    is.read(buf8,8);
-	data._ver_id = buf8;
+    fields.readString(16, _fac_id);
 
-    is.read(buf16,16);
-	data._fac_code = buf16;
+    fields.readString(8, _sys_id);
 
-    is.read(buf16,16);
-	data._lev_code = buf16;
+    fields.readString(8, _ver_id);
 
-    is.read(buf32,32);
-	data._prod_type = buf32;
+    fields.readString(16, _fac_code);
 
-    is.read(buf32,32);
-	data._algor_id = buf32;
+    fields.readString(16, _lev_code);
 
-    is.read(buf16,16);
-	data._n_azilok = atof(buf16);
+    fields.readString(32, _prod_type);
 
-    is.read(buf16,16);
-	data._n_rnglok = atof(buf16);
+    fields.readString(32, _algor_id);
 
-    is.read(buf16,16);
-	data._bnd_azilok = atof(buf16);
+    _n_azilok = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._bnd_rnglok = atof(buf16);
+    _n_rnglok = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._bnd_azi = atof(buf16);
+    _bnd_azilok = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._bnd_rng = atof(buf16);
+    _bnd_rnglok = fields.readDouble(16);
 
-    is.read(buf32,32);
-	data._azi_weight = buf32;
+    _bnd_azi = fields.readDouble(16);
 
-    is.read(buf32,32);
-	data._rng_weight = buf32;
+    _bnd_rng = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._data_inpsrc = buf16;
+    fields.readString(32, _azi_weight);
 
-    is.read(buf16,16);
-	data._rng_res = atof(buf16);
+    fields.readString(32, _rng_weight);
 
-    is.read(buf16,16);
-	data._azi_res = atof(buf16);
+    fields.readString(16, _data_inpsrc);
 
-	is.read(buf16,16);
-	data._radi_stretch[0] = atof(buf16);
-	is.read(buf16,16);
-	data._radi_stretch[1] = atof(buf16);
+    _rng_res = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._alt_dopcen[0] = atof(buf16);
-	is.read(buf16,16);
-	data._alt_dopcen[1] = atof(buf16);
-	is.read(buf16,16);
-	data._alt_dopcen[2] = atof(buf16);
+    _azi_res = fields.readDouble(16);
 
-    is.read(buf16,16);
+	_radi_stretch[0] = fields.readDouble(16);
+	_radi_stretch[1] = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._crt_dopcen[0] = atof(buf16);
-	is.read(buf16,16);
-	data._crt_dopcen[1] = atof(buf16);
-	is.read(buf16,16);
-	data._crt_dopcen[2] = atof(buf16);
+	_alt_dopcen[0] = fields.readDouble(16);
+	_alt_dopcen[1] = fields.readDouble(16);
+	_alt_dopcen[2] = fields.readDouble(16);
 
-    is.read(buf8,8);
-	data._time_dir_pix = buf8;
+    fields.skip(16);
 
-	is.read(buf8,8);
-	data._time_dir_lin = buf8;
+    _crt_dopcen[0] = fields.readDouble(16);
+	_crt_dopcen[1] = fields.readDouble(16);
+	_crt_dopcen[2] = fields.readDouble(16);
 
-    is.read(buf16,16);
-	data._alt_rate[0] = atof(buf16);
-	is.read(buf16,16);
-	data._alt_rate[1] = atof(buf16);
-	is.read(buf16,16);
-	data._alt_rate[2] = atof(buf16);
+    fields.readString(8, _time_dir_pix);
 
-    is.read(buf16,16);
+	fields.readString(8, _time_dir_lin);
 
-    is.read(buf16,16);
-	data._crt_rate[0] = atof(buf16);
-	is.read(buf16,16);
-	data._crt_rate[1] = atof(buf16);
-	is.read(buf16,16);
-	data._crt_rate[2] = atof(buf16);
+    _alt_rate[0] = fields.readDouble(16);
+	_alt_rate[1] = fields.readDouble(16);
+	_alt_rate[2] = fields.readDouble(16);
 
-    is.read(buf16,16);
+    fields.skip(16);
 
-    is.read(buf8,8);
-	data._line_cont = buf8;
+    _crt_rate[0] = fields.readDouble(16);
+	_crt_rate[1] = fields.readDouble(16);
+	_crt_rate[2] = fields.readDouble(16);
 
-    is.read(buf4,4);
-	data._clutter_lock = buf4;
+    fields.skip(16);
 
-    is.read(buf4,4);
-	data._auto_focus = buf4;
+    fields.readString(8, _line_cont);
 
-    is.read(buf16,16);
-	data._line_spacing = atof(buf16);
+    fields.readString(4, _clutter_lock);
 
-    is.read(buf16,16);
-	data._pix_spacing = atof(buf16);
+    fields.readString(4, _auto_focus);
 
-    is.read(buf16,16);
-	data._rngcmp_desg = buf16;
+    _line_spacing = fields.readDouble(16);
 
-    char buf[2363];
-	buf[2362] = '\0';
+    _pix_spacing = fields.readDouble(16);
 
-	is.read(buf,2362);
+    fields.readString(16, _rngcmp_desg);
 
-	return is;
+	fields.skip(2362);
 }
 
 
@@ -40,11 +40,6 @@ public:
    */
   friend std::ostream& operator<<(std::ostream& os, const DataSetSummary& data);
 
-  /**
-   * @brief This function read a DataSetSummary from a stream
-   */
-  friend std::istream& operator>>(std::istream& is, DataSetSummary& data);
-
   /**
    * @brief Copy constructor
    */
@@ -72,12 +67,9 @@ public:
   };
 
   /**
-   * @brief Reads the class data from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  void Read(std::istream& is)
-  {
-    is>>*this;
-  };
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Writes the class to a stream
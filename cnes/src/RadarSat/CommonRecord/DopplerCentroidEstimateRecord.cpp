@@ -33,26 +33,16 @@ std::ostream& operator<<(std::ostream& os, const DopplerCentroidEstimateRecord&
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DopplerCentroidEstimateRecord& data)
+void DopplerCentroidEstimateRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[17];
-	buf[16] = '\0';
+	_dopcen_conf = fields.readDouble(16);
 
-	is.read(buf,16);
-	buf[16] = '\0';
-	data._dopcen_conf = atof(buf);
-
-	is.read(buf,16);
-	buf[16] = '\0';
-	data._dopcen_ref_tim = atof(buf);
+	_dopcen_ref_tim = fields.readDouble(16);
 
 	for (int i=0;i<4;i++)
 	{
-		is.read(buf,16);
-		buf[16] = '\0';
-		data._dopcen_coef[i] = atof(buf);
+		_dopcen_coef[i] = fields.readDouble(16);
 	}
-	return is;
 }
 
 DopplerCentroidEstimateRecord::DopplerCentroidEstimateRecord(const DopplerCentroidEstimateRecord& rhs):
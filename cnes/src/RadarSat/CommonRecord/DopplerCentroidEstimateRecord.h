@@ -51,9 +51,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const DopplerCentroidEstimateRecord& data);
 
   /**
-   * @brief This function reads a DopplerCentroidEstimateRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, DopplerCentroidEstimateRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Doppler centroid confidence measure
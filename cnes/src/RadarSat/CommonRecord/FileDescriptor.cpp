@@ -74,157 +74,85 @@ std::ostream& operator<<(std::ostream& os, const FileDescriptor& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, FileDescriptor& data)
+void FileDescriptor::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf2[3];
-	buf2[2] = '\0';
-	char buf12[13];
-	buf12[12] = '\0';
-	char buf16[17];
-	buf16[16] = '\0';
-	char buf4[5];
-	buf4[4] = '\0';
-	char buf6[7];
-	buf6[6] = '\0';
-	char buf8[9];
-	buf8[8] = '\0';
-	char buf64[65];
-	buf64[64] = '\0';
+	fields.readString(2, _ascii_flag);
 
-	char buf60[61];
-	buf60[60] = '\0';
+	fields.skip(2);
 
-	char buf288[289];
-	buf288[288] = '\0';
+	fields.readString(12, _format_doc);
 
-	is.read(buf2,2);
-	data._ascii_flag = buf2;
+	fields.readString(2, _format_ver);
 
-	is.read(buf2,2);
+	fields.readString(2, _design_rev);
 
-	is.read(buf12,12);
-	data._format_doc = buf12;
+	fields.readString(12, _software_id);
 
-	is.read(buf2,2);
-	data._format_ver = buf2;
+	_file_num = fields.readInt(4);
 
-	is.read(buf2,2);
-	data._design_rev = buf2;
+	fields.readString(16, _file_name);
 
-	is.read(buf12,12);
-	data._software_id = buf12;
+	fields.readString(4, _rec_seq);
 
-	is.read(buf4,4);
-	data._file_num = atoi(buf4);
+	_seq_loc = fields.readInt(8);
 
-	is.read(buf16,16);
-	data._file_name = buf16;
+	_seq_len = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._rec_seq = buf4;
+	fields.readString(4, _rec_code);
 
-	is.read(buf8,8);
-	data._seq_loc = atoi(buf8);
+	_code_loc = fields.readInt(8);
 
-	is.read(buf4,4);
-	data._seq_len = atoi(buf4);
+	_code_len = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._rec_code = buf4;
+	fields.readString(4, _rec_len);
 
-	is.read(buf8,8);
-	data._code_loc = atoi(buf8);
+	_rlen_loc = fields.readInt(8);
 
-	is.read(buf4,4);
-	data._code_len = atoi(buf4);
+	_rlen_len = fields.readInt(4);
 
-	is.read(buf4,4);
-	data._rec_len = buf4;
+	fields.skip(4);
 
-	is.read(buf8,8);
-	data._rlen_loc = atoi(buf8);
+	fields.skip(64);
 
-	is.read(buf4,4);
-	data._rlen_len = atoi(buf4);
+	_n_dataset = fields.readInt(6);
 
-	is.read(buf4,4);
+	_l_dataset = fields.readInt(6);
 
-	is.read(buf64,64);
+	_n_map_proj = fields.readInt(6);
 
-	is.read(buf6,6);
-	data._n_dataset = atoi(buf6);
+	_l_map_proj = fields.readInt(6);
 
-	is.read(buf6,6);
-	data._l_dataset = atoi(buf6);
+	_n_plat_pos = fields.readInt(6);
+	_l_plat_pos = fields.readInt(6);
+	_n_att_data = fields.readInt(6);
+	_l_att_data = fields.readInt(6);
+	_n_radi_data = fields.readInt(6);
+	_l_radi_data = fields.readInt(6);
+	_n_radi_comp = fields.readInt(6);
+	_l_radi_comp = fields.readInt(6);
+	_n_qual_sum = fields.readInt(6);
+	_l_qual_sum = fields.readInt(6);
+	_n_data_his = fields.readInt(6);
+	_l_data_his = fields.readInt(6);
 
-	is.read(buf6,6);
-	data._n_map_proj = atoi(buf6);
-
-	is.read(buf6,6);
-	data._l_map_proj = atoi(buf6);
-
-	is.read(buf6,6);
-	data._n_plat_pos = atoi(buf6);
-	is.read(buf6,6);
-	data._l_plat_pos = atoi(buf6);
-	is.read(buf6,6);
-	data._n_att_data = atoi(buf6);
-	is.read(buf6,6);
-	data._l_att_data = atoi(buf6);
-	is.read(buf6,6);
-	data._n_radi_data = atoi(buf6);
-	is.read(buf6,6);
-	data._l_radi_data = atoi(buf6);
-	is.read(buf6,6);
-	data._n_radi_comp = atoi(buf6);
-	is.read(buf6,6);
-	data._l_radi_comp = atoi(buf6);
-	is.read(buf6,6);
-	data._n_qual_sum = atoi(buf6);
-	is.read(buf6,6);
-	data._l_qual_sum = atoi(buf6);
-	is.read(buf6,6);
-	data._n_data_his = atoi(buf6);
-	is.read(buf6,6);
-	data._l_data_his = atoi(buf6);
-
-
-
-	is.read(buf6,6);
-	data._n_rang_spec = atoi(buf6);
-	is.read(buf6,6);
-	data._l_rang_spec = atoi(buf6);
-	is.read(buf6,6);
-	data._n_dem_desc = atoi(buf6);
-	is.read(buf6,6);
-	data._l_dem_desc = atoi(buf6);
-	is.read(buf6,6);
-	data._n_radar_par = atoi(buf6);
-	is.read(buf6,6);
-	data._l_radar_par = atoi(buf6);
-	is.read(buf6,6);
-	data._n_anno_data = atoi(buf6);
-	is.read(buf6,6);
-	data._l_anno_data = atoi(buf6);
-	is.read(buf6,6);
-	data._n_det_proc = atoi(buf6);
-	is.read(buf6,6);
-	data._l_det_proc = atoi(buf6);
-	is.read(buf6,6);
-	data._n_cal = atoi(buf6);
-	is.read(buf6,6);
-	data._l_cal = atoi(buf6);
-	is.read(buf6,6);
-	data._n_gcp = atoi(buf6);
-	is.read(buf6,6);
-	data._l_gcp = atoi(buf6);
-	is.read(buf60,60);
-	is.read(buf6,6);
-	data._n_fac_data = atoi(buf6);
-	is.read(buf6,6);
-	data._l_fac_data = atoi(buf6);
-	is.read(buf288,288);
-	return is;
+	_n_rang_spec = fields.readInt(6);
+	_l_rang_spec = fields.readInt(6);
+	_n_dem_desc = fields.readInt(6);
+	_l_dem_desc = fields.readInt(6);
+	_n_radar_par = fields.readInt(6);
+	_l_radar_par = fields.readInt(6);
+	_n_anno_data = fields.readInt(6);
+	_l_anno_data = fields.readInt(6);
+	_n_det_proc = fields.readInt(6);
+	_l_det_proc = fields.readInt(6);
+	_n_cal = fields.readInt(6);
+	_l_cal = fields.readInt(6);
+	_n_gcp = fields.readInt(6);
+	_l_gcp = fields.readInt(6);
+	fields.skip(60);
+	_n_fac_data = fields.readInt(6);
+	_l_fac_data = fields.readInt(6);
+	fields.skip(288);
 }
 
 FileDescriptor::FileDescriptor(const FileDescriptor& rhs):
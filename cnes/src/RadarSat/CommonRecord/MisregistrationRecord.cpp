@@ -28,17 +28,11 @@ std::ostream& operator<<(std::ostream& os, const MisregistrationRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, MisregistrationRecord& data)
+void MisregistrationRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf16[17];
-	buf16[16] = '\0';
+	_alt_m = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._alt_m = atof(buf16);
-
-	is.read(buf16,16);
-	data._crt_m = atof(buf16);
-	return is;
+	_crt_m = fields.readDouble(16);
 }
 
 MisregistrationRecord::MisregistrationRecord(const MisregistrationRecord& rhs):
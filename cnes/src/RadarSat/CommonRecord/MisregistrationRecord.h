@@ -50,9 +50,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const MisregistrationRecord& data);
 
   /**
-   * @brief This function reads a MisregistrationRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, MisregistrationRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Nominal along track misregistration
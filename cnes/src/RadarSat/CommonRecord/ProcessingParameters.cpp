@@ -261,435 +261,245 @@ namespace ossimplugins
       return os;
    }
 
-   std::istream& operator>>(std::istream& is, ProcessingParameters& data)
+   void ProcessingParameters::Read(ossimFixedWidthFieldReader& fields)
    {
-      char buf[2407];
-      buf[2406] = '\0';
+      _rec_seq = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._rec_seq = atoi(buf);
+      fields.skip(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
+      fields.readString(3, _inp_media);
 
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._inp_media = buf;
-
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_tape_id = atoi(buf);
+      _n_tape_id = fields.readInt(4);
 
       for (int i=0;i<10;i++)
       {
-         is.read(buf,8);
-         buf[8] = '\0';
-         data._tape_id[i] = buf;
+         fields.readString(8, _tape_id[i]);
       }
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._exp_ing_start = buf;
+      fields.readString(21, _exp_ing_start);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._exp_ing_stop = buf;
+      fields.readString(21, _exp_ing_stop);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._act_ing_start = buf;
+      fields.readString(21, _act_ing_start);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._act_ing_stop = buf;
+      fields.readString(21, _act_ing_stop);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._proc_start = buf;
+      fields.readString(21, _proc_start);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._proc_stop = buf;
+      fields.readString(21, _proc_stop);
 
       for (int i=0;i<10;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._mn_sig_lev[i] = atof(buf);
+         _mn_sig_lev[i] = fields.readDouble(16);
       }
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._scr_data_ind = atoi(buf);
+      _scr_data_ind = fields.readInt(4);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._miss_ln = atoi(buf);
+      _miss_ln = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_ln = atoi(buf);
+      _rej_ln = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._large_gap = atoi(buf);
+      _large_gap = fields.readInt(8);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._bit_err_rate = atof(buf);
+      _bit_err_rate = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._fm_crc_err = atof(buf);
+      _fm_crc_err = fields.readDouble(16);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._date_incons = atoi(buf);
+      _date_incons = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._prf_changes = atoi(buf);
+      _prf_changes = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._delay_changes = atoi(buf);
+      _delay_changes = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._skipd_frams = atoi(buf);
+      _skipd_frams = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_bf_start = atoi(buf);
+      _rej_bf_start = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_few_fram = atoi(buf);
+      _rej_few_fram = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_many_fram = atoi(buf);
+      _rej_many_fram = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_mchn_err = atoi(buf);
+      _rej_mchn_err = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_vchn_err = atoi(buf);
+      _rej_vchn_err = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rej_rec_type = atoi(buf);
+      _rej_rec_type = fields.readInt(8);
 
-      is.read(buf,10);
-      buf[10] = '\0';
-      data._sens_config = buf;
+      fields.readString(10, _sens_config);
 
-      is.read(buf,9);
-      buf[9] = '\0';
-      data._sens_orient = buf;
+      fields.readString(9, _sens_orient);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._sych_marker = buf;
+      fields.readString(8, _sych_marker);
 
-      is.read(buf,12);
-      buf[12] = '\0';
-      data._rng_ref_src = buf;
+      fields.readString(12, _rng_ref_src);
 
       for (int i=0;i<4;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._rng_amp_coef[i] = atof(buf);
+         _rng_amp_coef[i] = fields.readDouble(16);
       }
 
       for (int i=0;i<4;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._rng_phas_coef[i] = atof(buf);
+         _rng_phas_coef[i] = fields.readDouble(16);
       }
 
       for (int i=0;i<4;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._err_amp_coef[i] = atof(buf);
+         _err_amp_coef[i] = fields.readDouble(16);
       }
 
       for (int i=0;i<4;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._err_phas_coef[i] = atof(buf);
+         _err_phas_coef[i] = fields.readDouble(16);
       }
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._pulse_bandw = atoi(buf);
-
+      _pulse_bandw = fields.readInt(4);
 
-      is.read(buf,5);
-      buf[5] = '\0';
-      data._adc_samp_rate = buf;
+      fields.readString(5, _adc_samp_rate);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._rep_agc_attn = atof(buf);
+      _rep_agc_attn = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._gn_corctn_fctr = atof(buf);
+      _gn_corctn_fctr = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._rep_energy_gn = atof(buf);
+      _rep_energy_gn = fields.readDouble(16);
 
-      is.read(buf,11);
-      buf[11] = '\0';
-      data._orb_data_src = buf;
+      fields.readString(11, _orb_data_src);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._pulse_cnt_1 = atoi(buf);
+      _pulse_cnt_1 = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._pulse_cnt_2 = atoi(buf);
+      _pulse_cnt_2 = fields.readInt(4);
 
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._beam_edge_rqd = buf;
+      fields.readString(3, _beam_edge_rqd);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._beam_edge_conf = atof(buf);
+      _beam_edge_conf = fields.readDouble(16);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._pix_overlap = atoi(buf);
+      _pix_overlap = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_beams = atoi(buf);
+      _n_beams = fields.readInt(4);
 
       for (int i=0;i<4;i++)
       {
-         is>>data._beam_info[i];
+         _beam_info[i].Read(fields);
       }
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_pix_updates = atoi(buf);
+      _n_pix_updates = fields.readInt(4);
 
       for (int i=0;i<20;i++)
       {
-         is>>data._pix_count[i];
+         _pix_count[i].Read(fields);
       }
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._pwin_start = atof(buf);
+      _pwin_start = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._pwin_end = atof(buf);
+      _pwin_end = fields.readDouble(16);
 
-      is.read(buf,9);
-      buf[9] = '\0';
-      data._recd_type = buf;
+      fields.readString(9, _recd_type);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._temp_set_inc = atof(buf);
+      _temp_set_inc = fields.readDouble(16);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_temp_set = atoi(buf);
+      _n_temp_set = fields.readInt(4);
 
       for (int i=0;i<20;i++)
       {
-         is>>data._temp[i];
+         _temp[i].Read(fields);
       }
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._n_image_pix = atoi(buf);
+      _n_image_pix = fields.readInt(8);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._prc_zero_pix = atof(buf);
+      _prc_zero_pix = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._prc_satur_pix = atof(buf);
+      _prc_satur_pix = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._img_hist_mean = atof(buf);
+      _img_hist_mean = fields.readDouble(16);
 
       for (int i=0;i<3;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._img_cumu_dist[i] = atof(buf);
+         _img_cumu_dist[i] = fields.readDouble(16);
       }
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._pre_img_gn = atof(buf);
+      _pre_img_gn = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._post_img_gn = atof(buf);
+      _post_img_gn = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._dopcen_inc = atof(buf);
+      _dopcen_inc = fields.readDouble(16);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_dopcen = atoi(buf);
+      _n_dopcen = fields.readInt(4);
 
       for (int i=0;i<20;i++)
       {
-         is>>data._dopcen_est[i];
+         _dopcen_est[i].Read(fields);
       }
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._dop_amb_err = atoi(buf);
+      _dop_amb_err = fields.readInt(4);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._dopamb_conf = atof(buf);
+      _dopamb_conf = fields.readDouble(16);
 
       for (int i=0;i<7;i++)
       {
-         is.read(buf,16);
-         buf[16] = '\0';
-         data._eph_orb_data[i] = atof(buf);
+         _eph_orb_data[i] = fields.readDouble(16);
       }
 
-      is.read(buf,12);
-      buf[12] = '\0';
-      data._appl_type = buf;
+      fields.readString(12, _appl_type);
 
       for (int i=0;i<5;i++)
       {
-         is.read(buf,22);
-         buf[22] = '\0';
-         data._slow_time_coef[i] = atof(buf);
+         _slow_time_coef[i] = fields.readDouble(22);
       }
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_srgr = atoi(buf);
+      _n_srgr = fields.readInt(4);
 
       for (int i=0;i<20;i++)
       {
-         is>>data._srgr_coefset[i];
+         _srgr_coefset[i].Read(fields);
       }
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._pixel_spacing = atof(buf);
-
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._gics_reqd = buf;
+      _pixel_spacing = fields.readDouble(16);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._wo_number = buf;
+      fields.readString(3, _gics_reqd);
 
-      is.read(buf,20);
-      buf[20] = '\0';
-      data._wo_date = buf;
+      fields.readString(8, _wo_number);
 
-      is.read(buf,10);
-      buf[10] = '\0';
-      data._satellite_id = buf;
+      fields.readString(20, _wo_date);
 
-      is.read(buf,20);
-      buf[20] = '\0';
-      data._user_id = buf;
+      fields.readString(10, _satellite_id);
 
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._complete_msg = buf;
+      fields.readString(20, _user_id);
 
-      is.read(buf,15);
-      buf[15] = '\0';
-      data._scene_id = buf;
+      fields.readString(3, _complete_msg);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._density_in = buf;
+      fields.readString(15, _scene_id);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._media_id = buf;
+      fields.readString(4, _density_in);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._angle_first = atof(buf);
+      fields.readString(8, _media_id);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._angle_last = atof(buf);
+      _angle_first = fields.readDouble(16);
 
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._prod_type = buf;
+      _angle_last = fields.readDouble(16);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._map_system = buf;
+      fields.readString(3, _prod_type);
 
-      is.read(buf,22);
-      buf[22] = '\0';
-      data._centre_lat = atof(buf);
+      fields.readString(16, _map_system);
 
-      is.read(buf,22);
-      buf[22] = '\0';
-      data._centre_long = atof(buf);
+      _centre_lat = fields.readDouble(22);
 
-      is.read(buf,22);
-      buf[22] = '\0';
-      data._span_x = atof(buf);
+      _centre_long = fields.readDouble(22);
 
-      is.read(buf,22);
-      buf[22] = '\0';
-      data._span_y = atof(buf);
+      _span_x = fields.readDouble(22);
 
-      is.read(buf,3);
-      buf[3] = '\0';
-      data._apply_dtm = buf;
+      _span_y = fields.readDouble(22);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._density_out = buf;
+      fields.readString(3, _apply_dtm);
 
-      is.read(buf,21);
-      buf[21] = '\0';
-      data._state_time = buf;
+      fields.readString(4, _density_out);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._num_state_vectors = atoi(buf);
+      fields.readString(21, _state_time);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._state_time_inc = atof(buf);
+      _num_state_vectors = fields.readInt(4);
 
-      is.read(buf,206);
-      buf[206] = '\0';
+      _state_time_inc = fields.readDouble(16);
 
-      return is;
+      fields.skip(206);
    }
 
    ProcessingParameters::ProcessingParameters(const ProcessingParameters& rhs):
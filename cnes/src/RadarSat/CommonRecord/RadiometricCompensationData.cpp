@@ -38,33 +38,20 @@ namespace ossimplugins
       return os;
    }
 
-   std::istream& operator>>(std::istream& is, RadiometricCompensationData& data)
+   void RadiometricCompensationData::Read(ossimFixedWidthFieldReader& fields)
    {
-      char buf[9];
-      buf[8] = '\0';
+      _seq_num = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._seq_num = atoi(buf);
+      _chan_ind = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._chan_ind = atoi(buf);
+      _n_dset = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._n_dset = atoi(buf);
-
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._dset_size = atoi(buf);
+      _dset_size = fields.readInt(8);
 
       for (int i=0;i<4;i++)
       {
-         is>> data._dset[i];
+         _dset[i].Read(fields);
       }
-
-      return is;
    }
 
    RadiometricCompensationData::RadiometricCompensationData(const RadiometricCompensationData& rhs):
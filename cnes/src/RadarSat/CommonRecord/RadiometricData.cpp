@@ -54,72 +54,42 @@ std::ostream& operator<<(std::ostream& os, const RadiometricData& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, RadiometricData& data)
+void RadiometricData::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[1513];
-	buf[1512] = '\0';
+	_seq_num = fields.readInt(4);
 
+    _n_data = fields.readInt(4);
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._seq_num = atoi(buf);
+    _field_size = fields.readInt(8);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._n_data = atoi(buf);
+	fields.readString(4, _chan_ind);
 
-    is.read(buf,8);
-	buf[8] = '\0';
-	data._field_size = atoi(buf);
+    fields.skip(4);
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._chan_ind = buf;
+    fields.readString(24, _table_desig);
 
-    is.read(buf,4);
+    _n_samp = fields.readInt(8);
 
-    is.read(buf,24);
-	buf[24] = '\0';
-	data._table_desig = buf;
+    fields.readString(16, _samp_type);
 
-    is.read(buf,8);
-	buf[8] = '\0';
-	data._n_samp = atoi(buf);
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._samp_type = buf;
-
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._samp_inc = atoi(buf);
+    _samp_inc = fields.readInt(4);
 
 	for (int i=0;i<512;i++)
 	{
-		is.read(buf,16);
-		buf[16] = '\0';
-		data._lookup_tab[i] = atof(buf);
+		_lookup_tab[i] = fields.readDouble(16);
 	}
 
-    is.read(buf,4);
-
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._noise_scale = atof(buf);
+    fields.skip(4);
 
-    is.read(buf,16);
+    _noise_scale = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._offset = atof(buf);
+    fields.skip(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._calib_const = atof(buf);
+    _offset = fields.readDouble(16);
 
-	is.read(buf,1512);
+    _calib_const = fields.readDouble(16);
 
-	return is;
+	fields.skip(1512);
 }
 
 RadiometricData::RadiometricData(const RadiometricData& rhs):
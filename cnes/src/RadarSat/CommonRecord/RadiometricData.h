@@ -49,11 +49,6 @@ public:
    */
   friend std::ostream& operator<<(std::ostream& os, const RadiometricData& data);
 
-  /**
-   * @brief This function reads a RadiometricData from a stream
-   */
-  friend std::istream& operator>>(std::istream& is, RadiometricData& data);
-
   /**
    * @brief This function is able to create a new instance of the class
    */
@@ -71,12 +66,9 @@ public:
   };
 
   /**
-   * @brief Reads the class data from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  void Read(std::istream& is)
-  {
-    is>>*this;
-  };
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Writes the class to a stream
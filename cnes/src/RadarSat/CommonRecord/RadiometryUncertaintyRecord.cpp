@@ -28,17 +28,11 @@ std::ostream& operator<<(std::ostream& os, const RadiometryUncertaintyRecord& da
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, RadiometryUncertaintyRecord& data)
+void RadiometryUncertaintyRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf16[17];
-	buf16[16] = '\0';
+	_db = fields.readDouble(16);
 
-	is.read(buf16,16);
-	data._db = atof(buf16);
-
-	is.read(buf16,16);
-	data._deg = atof(buf16);
-	return is;
+	_deg = fields.readDouble(16);
 }
 
 RadiometryUncertaintyRecord::RadiometryUncertaintyRecord(const RadiometryUncertaintyRecord& rhs):
@@ -49,9 +49,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const RadiometryUncertaintyRecord& data);
 
   /**
-   * @brief This function reads a RadiometryUncertaintyRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, RadiometryUncertaintyRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Units of db
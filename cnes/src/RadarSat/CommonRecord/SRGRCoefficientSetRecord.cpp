@@ -32,22 +32,14 @@ std::ostream& operator<<(std::ostream& os, const SRGRCoefficientSetRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, SRGRCoefficientSetRecord& data)
+void SRGRCoefficientSetRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[22];
-	buf[21] = '\0';
-
-	is.read(buf,21);
-	buf[21] = '\0';
-	data._srgr_update = buf;
+	fields.readString(21, _srgr_update);
 
 	for (int i=0;i<6;i++)
 	{
-		is.read(buf,16);
-		buf[16] = '\0';
-		data._srgr_coef[i] = atof(buf);
+		_srgr_coef[i] = fields.readDouble(16);
 	}
-	return is;
 }
 
 SRGRCoefficientSetRecord::SRGRCoefficientSetRecord(const SRGRCoefficientSetRecord& rhs):
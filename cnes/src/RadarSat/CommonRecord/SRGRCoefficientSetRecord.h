@@ -50,9 +50,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const SRGRCoefficientSetRecord& data);
 
   /**
-   * @brief This function reads a SRGRCoefficientSetRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, SRGRCoefficientSetRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief SRGR update date/time
@@ -31,18 +31,12 @@ std::ostream& operator<<(std::ostream& os, const TemperatureSettingsRecord& data
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, TemperatureSettingsRecord& data)
+void TemperatureSettingsRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[5];
-	buf[4] = '\0';
-
 	for (int i=0;i<4;i++)
 	{
-		is.read(buf,4);
-		buf[4] = '\0';
-		data._temp_set[i] = atoi(buf);
+		_temp_set[i] = fields.readInt(4);
 	}
-	return is;
 }
 
 TemperatureSettingsRecord::TemperatureSettingsRecord(const TemperatureSettingsRecord& rhs)
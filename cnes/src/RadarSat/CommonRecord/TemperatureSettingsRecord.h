@@ -50,9 +50,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const TemperatureSettingsRecord& data);
 
   /**
-   * @brief This function reads a TemperatureSettingsRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, TemperatureSettingsRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Temperature settings
@@ -79,7 +79,8 @@ std::istream& operator>>(std::istream& is, Data& data)
 			  RadarSatRecord* record = factory.Instanciate(header.get_rec_seq());
 			  if (record != NULL)
 				  {
-			    record->Read(is);
+			    ossimFixedWidthFieldReader fields(is, header.get_length() - 12);
+			    record->Read(fields);
 					data._records[Data::ImageOptionsFileDescriptorID] = record;
 
 					nbLin  = ((ImageOptionsFileDescriptor *) record)->get_nlin() ;
@@ -90,9 +91,7 @@ std::istream& operator>>(std::istream& is, Data& data)
 				  }
 				else
 				  {
-					char* buff = new char[header.get_length()-12];
-					is.read(buff, header.get_length()-12);
-					delete[] buff;
+					is.ignore(header.get_length() - 12);
 				  }
 			  }
 			else if ((header.get_rec_seq() == 2))
@@ -101,18 +100,15 @@ std::istream& operator>>(std::istream& is, Data& data)
 				RadarSatRecord* record = factory.Instanciate(2);
 				if (record != NULL)
 			  	{
-				  record->Read(is);
+				  ossimFixedWidthFieldReader fields(is, 192 - 12);
+				  record->Read(fields);
 					data._records[Data::FirstProcessedDataRecordID] = record;
 
-					char* buff = new char[header.get_length()-192];
-					is.read(buff, header.get_length()-192);	// Reads the rest of the line
-					delete[] buff;
+					is.ignore(header.get_length() - 192);	// Reads the rest of the line
 				  }
 				else
 				  {
-				  char* buff = new char[header.get_length()-12];
-					is.read(buff, header.get_length()-12);
-					delete[] buff;
+				  is.ignore(header.get_length() - 12);
 				  }
 			  }
 			else if ((header.get_rec_seq() == (1+nbLin)))
@@ -120,18 +116,15 @@ std::istream& operator>>(std::istream& is, Data& data)
 			  RadarSatRecord* record = factory.Instanciate(2);
 				if (record != NULL)
 				  {
-				  record->Read(is);
+				  ossimFixedWidthFieldReader fields(is, 192 - 12);
+				  record->Read(fields);
 					data._records[Data::LastProcessedDataRecordID] = record;
 
-					char* buff = new char[header.get_length()-192];
-					is.read(buff, header.get_length()-192);	// Reads the rest of the line
-					delete[] buff;
+					is.ignore(header.get_length() - 192);	// Reads the rest of the line
 				  }
 				else
 				  {
-				  char* buff = new char[header.get_length()-12];
-					is.read(buff, header.get_length()-12);
-					delete[] buff;
+				  is.ignore(header.get_length() - 12);
 				  }
 			  }
 			else
@@ -130,245 +130,142 @@ namespace ossimplugins
       return os;
    }
 
-   std::istream& operator>>(std::istream& is, ImageOptionsFileDescriptor& data)
+   void ImageOptionsFileDescriptor::Read(ossimFixedWidthFieldReader& fields)
    {
-      char buf[15805];
-      buf[15804] = '\0';
+      fields.readString(2, _ascii_flag);
 
-      is.read(buf,2);
-      buf[2] = '\0';
-      data._ascii_flag = buf;
+      fields.skip(2);
 
-      is.read(buf,2);
+      fields.readString(12, _format_doc);
 
-      is.read(buf,12);
-      buf[12] = '\0';
-      data._format_doc = buf;
+      fields.readString(2, _format_rev);
 
-      is.read(buf,2);
-      buf[2] = '\0';
-      data._format_rev = buf;
+      fields.readString(2, _design_rev);
 
-      is.read(buf,2);
-      buf[2] = '\0';
-      data._design_rev = buf;
+      fields.readString(12, _software_id);
 
-      is.read(buf,12);
-      buf[12] = '\0';
-      data._software_id = buf;
+      _file_num = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._file_num = atoi(buf);
+      fields.readString(16, _file_name);
 
-      is.read(buf,16);
-      buf[16] = '\0';
-      data._file_name = buf;
+      fields.readString(4, _rec_seq);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._rec_seq = buf;
+      _seq_loc = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._seq_loc = atoi(buf);
+      _seq_len = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._seq_len = atoi(buf);
+      fields.readString(4, _rec_code);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._rec_code = buf;
+      _code_loc = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._code_loc = atoi(buf);
+      _code_len = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._code_len = atoi(buf);
+      fields.readString(4, _rec_len);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._rec_len = buf;
+      _rlen_loc = fields.readInt(8);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._rlen_loc = atoi(buf);
-
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._rlen_len = atoi(buf);
+      _rlen_len = fields.readInt(4);
 
       for (int i=0;i<4;i++)
       {
-         is.read(buf,1);
+         fields.skip(1);
       }
 
-      is.read(buf,64);
+      fields.skip(64);
 
-      is.read(buf,6);
-      buf[6] = '\0';
-      data._n_dataset = atoi(buf);
+      _n_dataset = fields.readInt(6);
 
-      is.read(buf,6);
-      buf[6] = '\0';
-      data._l_dataset = atoi(buf);
+      _l_dataset = fields.readInt(6);
 
-      is.read(buf,24);
+      fields.skip(24);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nbit = atoi(buf);
+      _nbit = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nsamp = atoi(buf);
+      _nsamp = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nbyte = atoi(buf);
+      _nbyte = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._justify = buf;
+      fields.readString(4, _justify);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nchn = atoi(buf);
+      _nchn = fields.readInt(4);
 
-      is.read(buf,8);
-      buf[8] = '\0';
+      std::string nlin;
+      fields.readString(8, nlin);
 
       // We should use strtol() to avoid wrong conversion with atoi()
       char* p;
-      int result = strtol(buf, &p, 10);
-      if ( *p != 0 || p == buf)
+      int result = strtol(nlin.c_str(), &p, 10);
+      if ( *p != 0 || p == nlin.c_str())
       {
          if(traceDebug())
          {
-            ossimNotify(ossimNotifyLevel_DEBUG) << "WARNING: strtol() try to convert an empty tab of characters. It may be possible in case of SCN and SCW format" << buf << "!" << std::endl;
+            ossimNotify(ossimNotifyLevel_DEBUG) << "WARNING: strtol() try to convert an empty tab of characters. It may be possible in case of SCN and SCW format" << nlin << "!" << std::endl;
             ossimNotify(ossimNotifyLevel_DEBUG) << "=> _nlin = -1" << std::endl;
          }
-         data._nlin = -1;
+         _nlin = -1;
       }
       else
       {
-         data._nlin = result;
+         _nlin = result;
       };
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nleft = atoi(buf);
-
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._ngrp = atoi(buf);
+      _nleft = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nright = atoi(buf);
+      _ngrp = fields.readInt(8);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._ntop = atoi(buf);
+      _nright = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._nbott = atoi(buf);
+      _ntop = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._intleav = buf;
+      _nbott = fields.readInt(4);
 
-      is.read(buf,2);
-      buf[2] = '\0';
-      data._nrec_lin = atoi(buf);
+      fields.readString(4, _intleav);
 
-      is.read(buf,2);
-      buf[2] = '\0';
-      data._nrec_chn = atoi(buf);
+      _nrec_lin = fields.readInt(2);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_prefix = atoi(buf);
+      _nrec_chn = fields.readInt(2);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._n_sar = atoi(buf);
+      _n_prefix = fields.readInt(4);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._n_suffix = atoi(buf);
+      _n_sar = fields.readInt(8);
 
-      is.read(buf,4);
+      _n_suffix = fields.readInt(4);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._lin_loc = buf;
+      fields.skip(4);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._chn_loc = buf;
+      fields.readString(8, _lin_loc);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._tim_loc = buf;
+      fields.readString(8, _chn_loc);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._left_loc = buf;
+      fields.readString(8, _tim_loc);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._right_loc = buf;
+      fields.readString(8, _left_loc);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._pad_ind = buf;
+      fields.readString(8, _right_loc);
 
-      is.read(buf,28);
+      fields.readString(4, _pad_ind);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._qual_loc = buf;
+      fields.skip(28);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._cali_loc = buf;
+      fields.readString(8, _qual_loc);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._gain_loc = buf;
+      fields.readString(8, _cali_loc);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._bias_loc = buf;
+      fields.readString(8, _gain_loc);
 
-      is.read(buf,28);
-      buf[28] = '\0';
-      data._type_id = buf;
+      fields.readString(8, _bias_loc);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._type_code = buf;
+      fields.readString(28, _type_id);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._left_fill = atoi(buf);
+      fields.readString(4, _type_code);
 
-      is.read(buf,4);
-      buf[4] = '\0';
-      data._right_fill = atoi(buf);
+      _left_fill = fields.readInt(4);
 
-      is.read(buf,8);
-      buf[8] = '\0';
-      data._pix_rng = atoi(buf);
+      _right_fill = fields.readInt(4);
 
-      is.read(buf,15804);
+      _pix_rng = fields.readInt(8);
 
-      return is;
+      fields.skip(15804);
    }
 
    ImageOptionsFileDescriptor::ImageOptionsFileDescriptor(const ImageOptionsFileDescriptor& rhs):
@@ -78,134 +78,132 @@ namespace ossimplugins
       memcpy(&value,res,4);
    }
 
-   std::istream& operator>>(std::istream& is, ProcessedDataRecord& data)
+   /**
+    * @brief Reads a big endian 2 byte binary integer
+    */
+   static int ReadInt16(ossimFixedWidthFieldReader& fields)
    {
-      char buf[193];
-      buf[192] = '\0';
-
-      is.read((char*)&(data._line_num),4);
-      data.SwitchEndian(data._line_num);
-
-      is.read((char*)&(data._rec_num),4);
-      data.SwitchEndian(data._rec_num);
-
-      is.read((char*)&(data._n_left_pixel),4);
-      data.SwitchEndian(data._n_left_pixel);
-
-      is.read((char*)&(data._n_data_pixel),4);
-      data.SwitchEndian(data._n_data_pixel);
+      unsigned char buffer[2];
+      fields.readBinary(buffer, 2);
+      return static_cast<short>((buffer[0] << 8) | buffer[1]);
+   }
 
-      is.read((char*)&(data._n_right_pixel),4);
-      data.SwitchEndian(data._n_right_pixel);
+   void ProcessedDataRecord::Read(ossimFixedWidthFieldReader& fields)
+   {
+      fields.readBinary(&_line_num, 4);
+      SwitchEndian(_line_num);
 
-      is.read((char*)&(data._sensor_updf),4);
-      data.SwitchEndian(data._sensor_updf);
+      fields.readBinary(&_rec_num, 4);
+      SwitchEndian(_rec_num);
 
-      is.read((char*)&(data._acq_year),4);
-      data.SwitchEndian(data._acq_year);
+      fields.readBinary(&_n_left_pixel, 4);
+      SwitchEndian(_n_left_pixel);
 
-      is.read((char*)&(data._acq_day),4);
-      data.SwitchEndian(data._acq_day);
+      fields.readBinary(&_n_data_pixel, 4);
+      SwitchEndian(_n_data_pixel);
 
-      is.read((char*)&(data._acq_msec),4);
-      data.SwitchEndian(data._acq_msec);
+      fields.readBinary(&_n_right_pixel, 4);
+      SwitchEndian(_n_right_pixel);
 
-      is.read((char*)&(data._sar_chan_ind),2);
-      data.SwitchEndian(data._sar_chan_ind);
+      fields.readBinary(&_sensor_updf, 4);
+      SwitchEndian(_sensor_updf);
 
-      is.read((char*)&(data._sar_chan_code),2);
-      data.SwitchEndian(data._sar_chan_code);
+      fields.readBinary(&_acq_year, 4);
+      SwitchEndian(_acq_year);
 
-      is.read((char*)&(data._tran_polar),2);
-      data.SwitchEndian(data._tran_polar );
+      fields.readBinary(&_acq_day, 4);
+      SwitchEndian(_acq_day);
 
-      is.read((char*)&(data._recv_polar),2);
-      data.SwitchEndian(data._recv_polar);
+      fields.readBinary(&_acq_msec, 4);
+      SwitchEndian(_acq_msec);
 
-      is.read((char*)&(data._prf),4);
-      data.SwitchEndian(data._prf );
+      _sar_chan_ind = ReadInt16(fields);
+      _sar_chan_code = ReadInt16(fields);
+      _tran_polar = ReadInt16(fields);
+      _recv_polar = ReadInt16(fields);
 
-      is.read(buf,4);
+      fields.readBinary(&_prf, 4);
+      SwitchEndian(_prf );
 
-      is.read((char*)&(data._sr_first),4);
-      data.SwitchEndian(data._sr_first);
+      fields.skip(4);
 
-      is.read((char*)&(data._sr_mid),4);
-      data.SwitchEndian(data._sr_mid);
+      fields.readBinary(&_sr_first, 4);
+      SwitchEndian(_sr_first);
 
-      is.read((char*)&(data._sr_last),4);
-      data.SwitchEndian(data._sr_last);
+      fields.readBinary(&_sr_mid, 4);
+      SwitchEndian(_sr_mid);
 
-      is.read((char*)&(data._fdc_first),4);
-      data.SwitchEndian(data._fdc_first);
+      fields.readBinary(&_sr_last, 4);
+      SwitchEndian(_sr_last);
 
-      is.read((char*)&(data._fdc_mid),4);
-      data.SwitchEndian(data._fdc_mid);
+      fields.readBinary(&_fdc_first, 4);
+      SwitchEndian(_fdc_first);
 
-      is.read((char*)&(data._fdc_last),4);
-      data.SwitchEndian(data._fdc_last);
+      fields.readBinary(&_fdc_mid, 4);
+      SwitchEndian(_fdc_mid);
 
-      is.read((char*)&(data._ka_first),4);
-      data.SwitchEndian(data._ka_first);
+      fields.readBinary(&_fdc_last, 4);
+      SwitchEndian(_fdc_last);
 
-      is.read((char*)&(data._ka_mid),4);
-      data.SwitchEndian(data._ka_mid);
+      fields.readBinary(&_ka_first, 4);
+      SwitchEndian(_ka_first);
 
-      is.read((char*)&(data._ka_last),4);
-      data.SwitchEndian(data._ka_last);
+      fields.readBinary(&_ka_mid, 4);
+      SwitchEndian(_ka_mid);
 
-      is.read((char*)&(data._nadir_ang),4);
-      data.SwitchEndian(data._nadir_ang);
+      fields.readBinary(&_ka_last, 4);
+      SwitchEndian(_ka_last);
 
-      is.read((char*)&(data._squint_ang),4);
-      data.SwitchEndian(data._squint_ang);
+      fields.readBinary(&_nadir_ang, 4);
+      SwitchEndian(_nadir_ang);
 
-      is.read(buf,4);
-      is.read(buf,16);
+      fields.readBinary(&_squint_ang, 4);
+      SwitchEndian(_squint_ang);
 
-      is.read((char*)&(data._geo_updf),4);
-      data.SwitchEndian(data._geo_updf);
+      fields.skip(4);
+      fields.skip(16);
 
-      is.read((char*)&(data._lat_first),4);
-      data.SwitchEndian(data._lat_first);
+      fields.readBinary(&_geo_updf, 4);
+      SwitchEndian(_geo_updf);
 
-      is.read((char*)&(data._lat_mid),4);
-      data.SwitchEndian(data._lat_mid);
+      fields.readBinary(&_lat_first, 4);
+      SwitchEndian(_lat_first);
 
-      is.read((char*)&(data._lat_last),4);
-      data.SwitchEndian(data._lat_last);
+      fields.readBinary(&_lat_mid, 4);
+      SwitchEndian(_lat_mid);
 
-      is.read((char*)&(data._lon_first),4);
-      data.SwitchEndian(data._lon_first);
+      fields.readBinary(&_lat_last, 4);
+      SwitchEndian(_lat_last);
 
-      is.read((char*)&(data._lon_mid),4);
-      data.SwitchEndian(data._lon_mid);
+      fields.readBinary(&_lon_first, 4);
+      SwitchEndian(_lon_first);
 
-      is.read((char*)&(data._lon_last),4);
-      data.SwitchEndian(data._lon_last);
+      fields.readBinary(&_lon_mid, 4);
+      SwitchEndian(_lon_mid);
 
-      is.read((char*)&(data._north_first),4);
-      data.SwitchEndian(data._north_first);
+      fields.readBinary(&_lon_last, 4);
+      SwitchEndian(_lon_last);
 
-      is.read(buf,4);
+      fields.readBinary(&_north_first, 4);
+      SwitchEndian(_north_first);
 
-      is.read((char*)&(data._north_last),4);
-      data.SwitchEndian(data._north_last);
+      fields.skip(4);
 
-      is.read((char*)&(data._east_first),4);
-      data.SwitchEndian(data._east_first);
+      fields.readBinary(&_north_last, 4);
+      SwitchEndian(_north_last);
 
-      is.read(buf,4);
+      fields.readBinary(&_east_first, 4);
+      SwitchEndian(_east_first);
 
-      is.read((char*)&(data._east_last),4);
-      data.SwitchEndian(data._east_last);
+      fields.skip(4);
 
-      is.read((char*)&(data._heading),4);
-      data.SwitchEndian(data._heading);
+      fields.readBinary(&_east_last, 4);
+      SwitchEndian(_east_last);
 
-      is.read(buf,8);
+      fields.readBinary(&_heading, 4);
+      SwitchEndian(_heading);
 
-      return is;
+      fields.skip(8);
    }
 
    ProcessedDataRecord::ProcessedDataRecord(const ProcessedDataRecord& rhs):
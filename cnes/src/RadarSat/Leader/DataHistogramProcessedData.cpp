@@ -38,35 +38,21 @@ std::ostream& operator<<(std::ostream& os, const DataHistogramProcessedData& dat
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, DataHistogramProcessedData& data)
+void DataHistogramProcessedData::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buff[33];
-	buff[32] = '\0';
+	_rec_seq = fields.readInt(4);
 
-	is.read(buff,4);
-	buff[4] = '\0';
-	data._rec_seq = atoi(buff);
+    _sar_chn = fields.readInt(4);
 
-    is.read(buff,4);
-	buff[4] = '\0';
-	data._sar_chn = atoi(buff);
+	_ntab = fields.readInt(8);
 
-	is.read(buff,8);
-	buff[8] = '\0';
-	data._ntab = atoi(buff);
+	_ltab = fields.readInt(8);
 
-	is.read(buff,8);
-	buff[8] = '\0';
-	data._ltab = atoi(buff);
+	_histogram1.Read(fields);
 
-	is>>data._histogram1;
+	_histogram2.Read(fields);
 
-	is>>data._histogram2;
-
-	char tmp[5];
-	tmp[4] = '\0';
-	is.read(tmp, 4);
-	return is;
+	fields.skip(4);
 }
 
 DataHistogramProcessedData::DataHistogramProcessedData(const DataHistogramProcessedData& rhs) :
@@ -51,6 +51,7 @@ Leader::~Leader()
 
 std::ostream& operator<<(std::ostream& os, const Leader& data)
 {
+	data.ParseRecords();
 	std::map<int, RadarSatRecord*>::const_iterator it = data._records.begin();
 	while(it != data._records.end())
 	{
@@ -78,43 +79,30 @@ std::istream& operator>>(std::istream& is, Leader& data)
 		  }
 		else
 		  {
-		  RadarSatRecord* record;
-		  if ( (header.get_rec_seq() == 2) && (header.get_length() == 8960) )
+		  int id = header.get_rec_seq();
+		  if ( (id == 2) && (header.get_length() == 8960) )
 		    {
-		    record = factory.Instanciate(header.get_rec_seq() + 5); // case of SCN, SCW
-        if (record != NULL)
-          {
-          record->Read(is);
-          data._records[header.get_rec_seq() + 5] = record;
-          }
-        else
-          {
-          char* buff = new char[header.get_length()-12];
-          is.read(buff, header.get_length()-12);
-          delete[] buff;
-          }
+		    id += 5; // case of SCN, SCW
+		    }
+		  if ( factory.IsRegistered(id) && (header.get_length() > 12) )
+		    {
+		    // Kept as read, parsed by get_Record on first use.
+		    std::string& raw = data._rawRecords[id];
+		    raw.resize(header.get_length() - 12);
+		    is.read(&raw[0], raw.size());
+		    raw.resize(is.gcount());
 		    }
 		  else
 		    {
-        record = factory.Instanciate(header.get_rec_seq());
-        if (record != NULL)
-          {
-          record->Read(is);
-          data._records[header.get_rec_seq()] = record;
-          }
-        else
-          {
-          char* buff = new char[header.get_length()-12];
-          is.read(buff, header.get_length()-12);
-          delete[] buff;
-          }
+		    is.ignore(header.get_length() - 12);
 		    }
 		  }
 	  }
 	return is;
 }
 
-Leader::Leader(const Leader& rhs)
+Leader::Leader(const Leader& rhs):
+	_rawRecords(rhs._rawRecords)
 {
 	std::map<int, RadarSatRecord*>::const_iterator it = rhs._records.begin();
 	while(it != rhs._records.end())
@@ -127,6 +115,7 @@ Leader::Leader(const Leader& rhs)
 Leader& Leader::operator=(const Leader& rhs)
 {
 	ClearRecords();
+	_rawRecords = rhs._rawRecords;
 	std::map<int, RadarSatRecord*>::const_iterator it = rhs._records.begin();
 	while(it != rhs._records.end())
 	{
@@ -146,55 +135,89 @@ void Leader::ClearRecords()
 		++it;
 	}
 	_records.clear();
+	_rawRecords.clear();
+}
+
+RadarSatRecord* Leader::get_Record(int id) const
+{
+	std::map<int, RadarSatRecord*>::const_iterator it = _records.find(id);
+	if(it != _records.end())
+	{
+		return (*it).second;
+	}
+
+	RadarSatRecord* record = NULL;
+	std::map<int, std::string>::iterator raw = _rawRecords.find(id);
+	if(raw != _rawRecords.end())
+	{
+		LeaderFactory factory;
+		record = factory.Instanciate(id);
+		if(record != NULL)
+		{
+			ossimFixedWidthFieldReader fields((*raw).second.data(), (*raw).second.size());
+			record->Read(fields);
+			_records[id] = record;
+		}
+		_rawRecords.erase(raw);
+	}
+	return record;
+}
+
+void Leader::ParseRecords() const
+{
+	while(!_rawRecords.empty())
+	{
+		get_Record((*_rawRecords.begin()).first);
+	}
 }
 
 RadiometricData * Leader::get_RadiometricData()
 {
-	return (RadiometricData*)_records[RadiometricDataID];
+	return (RadiometricData*)get_Record(RadiometricDataID);
 }
 
 RadiometricCompensationData * Leader::get_RadiometricCompensationData()
 {
-	return (RadiometricCompensationData*)_records[RadiometricCompensationDataID];
+	return (RadiometricCompensationData*)get_Record(RadiometricCompensationDataID);
 }
 
 AttitudeData * Leader::get_AttitudeData()
 {
-	return (AttitudeData*)_records[AttitudeDataID];
+	return (AttitudeData*)get_Record(AttitudeDataID);
 }
 
 PlatformPositionData * Leader::get_PlatformPositionData()
 {
-	return (PlatformPositionData*)_records[PlatformPositionDataID];
+	return (PlatformPositionData*)get_Record(PlatformPositionDataID);
 }
 
 ProcessingParameters * Leader::get_ProcessingParameters()
 {
-	return (ProcessingParameters*)_records[ProcessingParametersID];
+	return (ProcessingParameters*)get_Record(ProcessingParametersID);
 }
 
 DataHistogramProcessedData * Leader::get_DataHistogramProcessedData()
 {
-	return (DataHistogramProcessedData*)_records[DataHistogramProcessedDataID];
+	return (DataHistogramProcessedData*)get_Record(DataHistogramProcessedDataID);
 }
 
 DataHistogramSignalData * Leader::get_DataHistogramSignalData()
 {
-	return (DataHistogramSignalData*)_records[DataHistogramSignalDataID];
+	return (DataHistogramSignalData*)get_Record(DataHistogramSignalDataID);
 }
 
 DataQuality * Leader::get_DataQuality()
 {
-	return (DataQuality*)_records[DataQualityID];
+	return (DataQuality*)get_Record(DataQualityID);
 }
 
 DataSetSummary * Leader::get_DataSetSummary()
 {
-	return (DataSetSummary*)_records[DataSetSummaryID];
+	return (DataSetSummary*)get_Record(DataSetSummaryID);
 }
 
 FileDescriptor * Leader::get_FileDescriptor()
 {
-	return (FileDescriptor*)_records[FileDescriptorID];
+	return (FileDescriptor*)get_Record(FileDescriptorID);
 }
 }
@@ -68,91 +68,51 @@ std::ostream& operator<<(std::ostream& os, const PlatformPositionData& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, PlatformPositionData& data)
+void PlatformPositionData::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[1207];
-	buf[1206] = '\0';
-
-	is.read(buf,32);
-	buf[32] = '\0';
-	data._orbit_ele_desg = buf;
+	fields.readString(32, _orbit_ele_desg);
 
 	for(int i=0;i<6;i++)
 	{
-		is.read(buf,16);
-		buf[16] = '\0';
-		data._orbit_ele[i] = atof(buf);
+		_orbit_ele[i] = fields.readDouble(16);
 	}
 
-	is.read(buf,4);
-	buf[4] = '\0';
-	data._ndata = atoi(buf);
+	_ndata = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._year = atoi(buf);
+    _year = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._month = atoi(buf);
+    _month = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._day = atoi(buf);
+    _day = fields.readInt(4);
 
-    is.read(buf,4);
-	buf[4] = '\0';
-	data._gmt_day = atoi(buf);
+    _gmt_day = fields.readInt(4);
 
-    is.read(buf,22);
-	buf[22] = '\0';
-	data._gmt_sec = atof(buf);
+    _gmt_sec = fields.readDouble(22);
 
-    is.read(buf,22);
-	buf[22] = '\0';
-	data._data_int = atof(buf);
+    _data_int = fields.readDouble(22);
 
-    is.read(buf,64);
-	buf[64] = '\0';
-	data._ref_coord = buf;
+    fields.readString(64, _ref_coord);
 
-    is.read(buf,22);
-	buf[22] = '\0';
-	data._hr_angle = atof(buf);
+    _hr_angle = fields.readDouble(22);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._alt_poserr = atof(buf);
+    _alt_poserr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._crt_poserr = atof(buf);
+    _crt_poserr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rad_poserr = atof(buf);
+    _rad_poserr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._alt_velerr = atof(buf);
+    _alt_velerr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._crt_velerr = atof(buf);
+    _crt_velerr = fields.readDouble(16);
 
-    is.read(buf,16);
-	buf[16] = '\0';
-	data._rad_velerr = atof(buf);
+    _rad_velerr = fields.readDouble(16);
 
 	for (int i=0;i<64;i++)
 	{
-		is>>data._pos_vect[i];
+		_pos_vect[i].Read(fields);
 	}
 
-    is.read(buf,126);
-
-
-	return is;
+    fields.skip(126);
 }
 
 PlatformPositionData::PlatformPositionData(const PlatformPositionData& rhs):
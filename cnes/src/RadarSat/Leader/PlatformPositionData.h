@@ -51,11 +51,6 @@ public:
    */
   friend std::ostream& operator<<(std::ostream& os, const PlatformPositionData& data);
 
-  /**
-   * @brief This function reads a PlatformPositionData from a stream
-   */
-  friend std::istream& operator>>(std::istream& is, PlatformPositionData& data);
-
   /**
    * @brief This function is able to create a new instance of the class
    */
@@ -73,12 +68,9 @@ public:
   };
 
   /**
-   * @brief Reads the class data from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  void Read(std::istream& is)
-  {
-    is>>*this;
-  };
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Writes the class to a stream
@@ -35,23 +35,17 @@ std::ostream& operator<<(std::ostream& os, const PositionVectorRecord& data)
 	return os;
 }
 
-std::istream& operator>>(std::istream& is, PositionVectorRecord& data)
+void PositionVectorRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-	char buf[23];
-	buf[22] = '\0';
-
 	for (int i=0;i<3;i++)
 	{
-		is.read(buf,22);
-		data._pos[i] = atof(buf);
+		_pos[i] = fields.readDouble(22);
 	}
 
 	for (int i=0;i<3;i++)
 	{
-		is.read(buf,22);
-		data._vel[i] = atof(buf);
+		_vel[i] = fields.readDouble(22);
 	}
-	return is;
 }
 
 PositionVectorRecord::PositionVectorRecord(const PositionVectorRecord& rhs)
@@ -49,9 +49,9 @@ public:
   friend std::ostream& operator<<(std::ostream& os, const PositionVectorRecord& data);
 
   /**
-   * @brief This function reads a PositionVectorRecord from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  friend std::istream& operator>>(std::istream& is, PositionVectorRecord& data);
+  void Read(ossimFixedWidthFieldReader& fields);
 
   /**
    * @brief Data point position (m)
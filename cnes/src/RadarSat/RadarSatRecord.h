@@ -14,6 +14,7 @@
 
 
 #include <RadarSat/RadarSatRecordHeader.h>
+#include <ossimFixedWidthFieldReader.h>
 #include <iostream>
 #include <cstdlib>
 
@@ -52,9 +53,9 @@ public:
   virtual RadarSatRecord* Clone()=0;
 
   /**
-   * @brief Reads the class data from a stream
+   * @brief Reads the class data from the fixed width fields of a record
    */
-  virtual void Read(std::istream& is) =0;
+  virtual void Read(ossimFixedWidthFieldReader& fields) =0;
 
   /**
    * @brief Writes the class to a stream
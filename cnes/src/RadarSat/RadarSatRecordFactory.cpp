@@ -34,6 +34,12 @@ RadarSatRecord* RadarSatRecordFactory::Instanciate(int id)
 	}
 }
 
+bool RadarSatRecordFactory::IsRegistered(int id) const
+{
+	std::map<int, RadarSatRecord*>::const_iterator it = _availableRecords.find(id);
+	return (it != _availableRecords.end()) && ((*it).second != NULL);
+}
+
 void RadarSatRecordFactory::RegisterRecord(int id, RadarSatRecord * record)
 {
 	_availableRecords[id] = record;
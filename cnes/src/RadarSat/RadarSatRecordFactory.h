@@ -47,6 +47,12 @@ public:
    * @param id Id of the Record we want to instanciate
    */
   RadarSatRecord* Instanciate(int id) ;
+
+  /**
+   * @brief Tells if a Record type is available for the id
+   * @param id Id of the Record
+   */
+  bool IsRegistered(int id) const;
 protected:
 
   /**
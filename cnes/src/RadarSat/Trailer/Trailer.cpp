@@ -46,6 +46,7 @@ Trailer::~Trailer()
 
 std::ostream& operator<<(std::ostream& os, const Trailer& data)
 {
+  data.ParseRecords();
   std::map<int, RadarSatRecord*>::const_iterator it = data._records.begin();
   while(it != data._records.end())
   {
@@ -73,17 +74,17 @@ std::istream& operator>>(std::istream& is, Trailer& data)
     }
     else
     {
-      RadarSatRecord* record = factory.Instanciate(header.get_rec_seq());
-      if (record != NULL)
+      if (factory.IsRegistered(header.get_rec_seq()) && (header.get_length() > 12))
       {
-        record->Read(is);
-        data._records[header.get_rec_seq()] = record;
+        // Kept as read, parsed by get_Record on first use.
+        std::string& raw = data._rawRecords[header.get_rec_seq()];
+        raw.resize(header.get_length() - 12);
+        is.read(&raw[0], raw.size());
+        raw.resize(is.gcount());
       }
       else
       {
-        char* buff = new char[header.get_length()-12];
-        is.read(buff, header.get_length()-12);
-        delete[] buff;
+        is.ignore(header.get_length() - 12);
       }
     }
   }
@@ -91,7 +92,8 @@ std::istream& operator>>(std::istream& is, Trailer& data)
 }
 
 
-Trailer::Trailer(const Trailer& rhs)
+Trailer::Trailer(const Trailer& rhs):
+  _rawRecords(rhs._rawRecords)
 {
   std::map<int, RadarSatRecord*>::const_iterator it = rhs._records.begin();
   while(it != rhs._records.end())
@@ -104,6 +106,7 @@ Trailer::Trailer(const Trailer& rhs)
 Trailer& Trailer::operator=(const Trailer& rhs)
 {
   ClearRecords();
+  _rawRecords = rhs._rawRecords;
   std::map<int, RadarSatRecord*>::const_iterator it = rhs._records.begin();
   while(it != rhs._records.end())
   {
@@ -123,50 +126,84 @@ void Trailer::ClearRecords()
     ++it;
   }
   _records.clear();
+  _rawRecords.clear();
+}
+
+RadarSatRecord* Trailer::get_Record(int id) const
+{
+  std::map<int, RadarSatRecord*>::const_iterator it = _records.find(id);
+  if(it != _records.end())
+  {
+    return (*it).second;
+  }
+
+  RadarSatRecord* record = NULL;
+  std::map<int, std::string>::iterator raw = _rawRecords.find(id);
+  if(raw != _rawRecords.end())
+  {
+    TrailerFactory factory;
+    record = factory.Instanciate(id);
+    if(record != NULL)
+    {
+      ossimFixedWidthFieldReader fields((*raw).second.data(), (*raw).second.size());
+      record->Read(fields);
+      _records[id] = record;
+    }
+    _rawRecords.erase(raw);
+  }
+  return record;
+}
+
+void Trailer::ParseRecords() const
+{
+  while(!_rawRecords.empty())
+  {
+    get_Record((*_rawRecords.begin()).first);
+  }
 }
 
 RadiometricData * Trailer::get_RadiometricData()
 {
-  return (RadiometricData*)_records[RadiometricDataID];
+  return (RadiometricData*)get_Record(RadiometricDataID);
 }
 
 RadiometricCompensationData * Trailer::get_RadiometricCompensationData()
 {
-  return (RadiometricCompensationData*)_records[RadiometricCompensationDataID];
+  return (RadiometricCompensationData*)get_Record(RadiometricCompensationDataID);
 }
 
 AttitudeData * Trailer::get_AttitudeData()
 {
-  return (AttitudeData*)_records[AttitudeDataID];
+  return (AttitudeData*)get_Record(AttitudeDataID);
 }
 
 ProcessingParameters * Trailer::get_ProcessingParameters()
 {
-  return (ProcessingParameters*)_records[ProcessingParametersID];
+  return (ProcessingParameters*)get_Record(ProcessingParametersID);
 }
 
 DataHistogramProcessedData8 * Trailer::get_DataHistogramProcessedData8()
 {
-  return (DataHistogramProcessedData8*)_records[DataHistogramProcessedData8ID];
+  return (DataHistogramProcessedData8*)get_Record(DataHistogramProcessedData8ID);
 }
 
 DataHistogramSignalData * Trailer::get_DataHistogramSignalData()
 {
-  return (DataHistogramSignalData*)_records[DataHistogramSignalDataID];
+  return (DataHistogramSignalData*)get_Record(DataHistogramSignalDataID);
 }
 
 DataQuality * Trailer::get_DataQuality()
 {
-  return (DataQuality*)_records[DataQualityID];
+  return (DataQuality*)get_Record(DataQualityID);
 }
 
 DataSetSummary * Trailer::get_DataSetSummary()
 {
-  return (DataSetSummary*)_records[DataSetSummaryID];
+  return (DataSetSummary*)get_Record(DataSetSummaryID);
 }
 
 FileDescriptor * Trailer::get_FileDescriptor()
 {
-  return (FileDescriptor*)_records[FileDescriptorID];
+  return (FileDescriptor*)get_Record(FileDescriptorID);
 }
 }
@@ -18,6 +18,7 @@
 #include <RadarSat/CommonRecord/DataQuality.h>
 #include <RadarSat/CommonRecord/DataHistogramSignalData.h>
 #include <map>
+#include <string>
 
 namespace ossimplugins
 {
@@ -85,7 +86,23 @@ public:
   DataSetSummary * get_DataSetSummary();
   FileDescriptor * get_FileDescriptor();
 protected:
-  std::map<int, RadarSatRecord*> _records;
+  /**
+   * @brief Returns the Record of the given id, parsing it on first use
+   * @return The Record or NULL if the Trailer has none of this id
+   */
+  RadarSatRecord* get_Record(int id) const;
+
+  /**
+   * @brief Parses all the Records not used yet
+   */
+  void ParseRecords() const;
+
+  mutable std::map<int, RadarSatRecord*> _records;
+
+  /**
+   * @brief Registered Records not parsed yet, as read after their header
+   */
+  mutable std::map<int, std::string> _rawRecords;
 
   static const int RadiometricDataID;
   static const int RadiometricCompensationDataID;
@@ -42,81 +42,45 @@ std::ostream& operator<<(std::ostream& os, const FilePointerRecord& data)
   return os;
 }
 
-std::istream& operator>>(std::istream& is, FilePointerRecord& data)
+void FilePointerRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-  char buf[349]; // 361-12 (size of header)
-  buf[348] = '\0';
+  fields.readString(2, _ascii_flag);
 
-  is.read(buf, 2);
-  buf[2] = '\0';
-  data._ascii_flag = buf;
+  fields.skip(2); // spare1
 
-  is.read(buf, 2); // spare1
+  _file_num = fields.readInt(4);
 
-  is.read(buf, 4);
-  buf[4] = '\0';
-  data._file_num = atoi(buf);
+  fields.readString(16, _file_name);
 
-  is.read(buf, 16);
-  buf[16] = '\0';
-  data._file_name = buf;
+  fields.readString(28, _file_class);
 
-  is.read(buf, 28);
-  buf[28] = '\0';
-  data._file_class = buf;
+  fields.readString(4, _file_code);
 
-  is.read(buf, 4);
-  buf[4] = '\0';
-  data._file_code = buf;
+  fields.readString(28, _data_type);
 
-  is.read(buf, 28);
-  buf[28] = '\0';
-  data._data_type = buf;
+  fields.readString(4, _data_code);
 
-  is.read(buf, 4);
-  buf[4] = '\0';
-  data._data_code = buf;
+  _nrec = fields.readInt(8);
 
-  is.read(buf, 8);
-  buf[8] = '\0';
-  data._nrec = atoi(buf);
+  _first_len = fields.readInt(8);
 
-  is.read(buf, 8);
-  buf[8] = '\0';
-  data._first_len = atoi(buf);
+  _max_len = fields.readInt(8);
 
-  is.read(buf, 8);
-  buf[8] = '\0';
-  data._max_len = atoi(buf);
+  fields.readString(12, _len_type);
 
-  is.read(buf, 12);
-  buf[12] = '\0';
-  data._len_type = buf;
+  fields.readString(4, _len_code);
 
-  is.read(buf, 4);
-  buf[4] = '\0';
-  data._len_code = buf;
+  _first_phyvol = fields.readInt(2);
 
-  is.read(buf, 2);
-  buf[2] = '\0';
-  data._first_phyvol = atoi(buf);
+  _last_phyvol = fields.readInt(2);
 
-  is.read(buf, 2);
-  buf[2] = '\0';
-  data._last_phyvol = atoi(buf);
+  _first_rec = fields.readInt(8);
 
-  is.read(buf, 8);
-  buf[8] = '\0';
-  data._first_rec = atoi(buf);
+  _last_rec = fields.readInt(8);
 
-  is.read(buf, 8);
-  buf[8] = '\0';
-  data._last_rec = atoi(buf);
+  fields.skip(100); // spare2
 
-  is.read(buf, 100); // spare2
-
-  is.read(buf, 100); // spare3
-  return is;
+  fields.skip(100); // spare3
 }
 
 FilePointerRecord::FilePointerRecord(const FilePointerRecord& rhs):
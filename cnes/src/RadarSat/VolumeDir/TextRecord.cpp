@@ -34,46 +34,25 @@ std::ostream& operator<<(std::ostream& os, const TextRecord& data)
   return os;
 }
 
-std::istream& operator>>(std::istream& is, TextRecord& data)
+void TextRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-  char buf[349]; // 361-12
-  buf[348] = '\0';
+  fields.readString(2, _ascii_flag);
 
-  is.read(buf, 2);
-  buf[2] = '\0';
-  data._ascii_flag = buf;
+  fields.readString(2, _cont_flag);
 
-  is.read(buf, 2);
-  buf[2] = '\0';
-  data._cont_flag = buf;
+  fields.readString(40, _product_type);
 
-  is.read(buf, 40);
-  buf[40] = '\0';
-  data._product_type = buf;
+  fields.readString(60, _product_create);
 
-  is.read(buf, 60);
-  buf[60] = '\0';
-  data._product_create = buf;
+  fields.readString(40, _phyvol_id);
 
-  is.read(buf, 40);
-  buf[40] = '\0';
-  data._phyvol_id = buf;
+  fields.readString(40, _scene_id);
 
-  is.read(buf, 40);
-  buf[40] = '\0';
-  data._scene_id = buf;
+  fields.readString(40, _scene_loc);
 
-  is.read(buf, 40);
-  buf[40] = '\0';
-  data._scene_loc = buf;
+  fields.readString(20, _copyright_info);
 
-  is.read(buf, 20);
-  buf[20] = '\0';
-  data._copyright_info = buf;
-
-  is.read(buf, 104); // spare1
-
-  return is;
+  fields.skip(104); // spare1
 }
 
 TextRecord::TextRecord(const TextRecord& rhs):
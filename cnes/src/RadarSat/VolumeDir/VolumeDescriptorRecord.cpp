@@ -51,111 +51,59 @@ std::ostream& operator<<(std::ostream& os, const VolumeDescriptorRecord& data)
   return os;
 }
 
-std::istream& operator>>(std::istream& is, VolumeDescriptorRecord& data)
+void VolumeDescriptorRecord::Read(ossimFixedWidthFieldReader& fields)
 {
-  char buf[349]; // 361-12
-    buf[348] = '\0';
+    fields.readString(2, _ascii_flag);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._ascii_flag = buf;
+    fields.skip(2); // spare1
 
-    is.read(buf,2); // spare1
+    fields.readString(12, _format_doc);
 
-    is.read(buf,12);
-    buf[12] = '\0';
-    data._format_doc = buf;
+    fields.readString(2, _format_ver);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._format_ver = buf;
+    fields.readString(2, _format_rev);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._format_rev = buf;
+    fields.readString(12, _software_id);
 
-    is.read(buf,12);
-    buf[12] = '\0';
-    data._software_id = buf;
+    fields.readString(16, _phyvol_id);
 
-    is.read(buf,16);
-    buf[16] = '\0';
-    data._phyvol_id = buf;
+    fields.readString(16, _logvol_id);
 
-    is.read(buf,16);
-    buf[16] = '\0';
-    data._logvol_id = buf;
+    fields.readString(16, _volset_id);
 
-    is.read(buf,16);
-    buf[16] = '\0';
-    data._volset_id = buf;
+    _phyvol_cnt = fields.readInt(2);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._phyvol_cnt = atoi(buf);
+    _first_phyvol = fields.readInt(2);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._first_phyvol = atoi(buf);
+    _last_phyvol = fields.readInt(2);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._last_phyvol = atoi(buf);
+    _curr_phyvol = fields.readInt(2);
 
-    is.read(buf,2);
-    buf[2] = '\0';
-    data._curr_phyvol = atoi(buf);
+    _first_file = fields.readInt(4);
 
-    is.read(buf,4);
-    buf[4] = '\0';
-    data._first_file = atoi(buf);
+    _volset_log = fields.readInt(4);
 
-    is.read(buf,4);
-    buf[4] = '\0';
-    data._volset_log = atoi(buf);
+    _phyvol_log = fields.readInt(4);
 
-    is.read(buf,4);
-    buf[4] = '\0';
-    data._phyvol_log = atoi(buf);
+    fields.readString(8, _logvol_date);
 
-    is.read(buf,8);
-    buf[8] = '\0';
-    data._logvol_date = buf;
+    fields.readString(8, _logvol_time);
 
-    is.read(buf,8);
-    buf[8] = '\0';
-    data._logvol_time = buf;
+    fields.readString(12, _logvol_country);
 
-    is.read(buf,12);
-    buf[12] = '\0';
-    data._logvol_country = buf;
+    fields.readString(8, _logvol_agency);
 
+    fields.readString(12, _logvol_facility);
 
-    is.read(buf,8);
-    buf[8] = '\0';
-    data._logvol_agency = buf;
+    _n_filepoint = fields.readInt(4);
 
-    is.read(buf,12);
-    buf[12] = '\0';
-    data._logvol_facility = buf;
+    _n_voldir = fields.readInt(4);
 
-    is.read(buf,4);
-    buf[4] = '\0';
-    data._n_filepoint = atoi(buf);
+    fields.skip(92); // spare2
 
-    is.read(buf,4);
-    buf[4] = '\0';
-    data._n_voldir = atoi(buf);
+    fields.readString(8, _product_id);
 
-    is.read(buf,92); // spare2
-
-    is.read(buf,8);
-    buf[8] = '\0';
-    data._product_id = buf;
-
-    is.read(buf,92); // spare3
-
-  return is;
+    fields.skip(92); // spare3
 }
 
 VolumeDescriptorRecord::VolumeDescriptorRecord(const VolumeDescriptorRecord& rhs):
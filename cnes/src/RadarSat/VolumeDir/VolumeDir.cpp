@@ -63,14 +63,13 @@ std::istream& operator>>(std::istream& is, VolumeDir& data)
       RadarSatRecord* record = factory.Instanciate(header.get_rec_seq());
       if (record != NULL)
       {
-        record->Read(is);
+        ossimFixedWidthFieldReader fields(is, header.get_length() - 12);
+        record->Read(fields);
         data._records[header.get_rec_seq()] = record;
       }
       else
       {
-        char* buff = new char[header.get_length()-12];
-        is.read(buff, header.get_length()-12);
-        delete[] buff;
+        is.ignore(header.get_length() - 12);
       }
     }
   }
@@ -16,6 +16,7 @@
 #include <cstdlib>
 #include "erssar/ErsSarRecordHeader.h"
 #include "erssar/ErsSarRecord.h"
+#include "ossimFixedWidthFieldReader.h"
 
 namespace ossimplugins
 {
@@ -82,6 +83,11 @@ public:
     is >> *this;
   };
 
+  /**
+   * @brief Reads the class data from the fixed width fields of a record
+   */
+  void Read(ossimFixedWidthFieldReader& fields);
+
   /**
    * @brief Write the class to a stream
    */
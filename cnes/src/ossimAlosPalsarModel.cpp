@@ -22,6 +22,7 @@
 #include <otb/RefPoint.h>
 #include <AlosPalsar/AlosPalsarLeader.h>
 #include <AlosPalsar/AlosPalsarData.h>
+#include <ossimMappedFileStream.h>
 #include <otb/SensorParams.h>
 #include <otb/PlatformPosition.h>
 #include <ossim/base/ossimKeywordNames.h>
@@ -204,7 +205,7 @@ namespace ossimplugins
             /*
              * Leader file data reading
              */
-            std::ifstream leaderFile(leaFilename.c_str(), ios::in | ios::binary);
+            ossimMappedFileStream leaderFile(leaFilename);
             leaderFile >> *theAlosPalsarLeader;
             leaderFile.close();
 
@@ -228,7 +229,7 @@ namespace ossimplugins
                /*
                 * Read header of data file for image size info
                 */
-               std::ifstream dataFile(datFilename.c_str(), ios::in | ios::binary);
+               ossimMappedFileStream dataFile(datFilename);
                dataFile >> *theAlosPalsarData;
                dataFile.close();
 
@@ -388,6 +389,8 @@ namespace ossimplugins
         }
       */
 
+      resetProjectionCache();
+
       return result;
    }
 
@@ -0,0 +1,914 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: One pass reader of DIMAP metadata files.
+//
+//----------------------------------------------------------------------------
+
+#include <ossimDimapXmlReader.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/base/ossimXmlAttribute.h>
+#include <ossim/base/ossimXmlNode.h>
+#include <sys/stat.h>
+#if defined(_WIN32)
+#  include <process.h>
+#  define getpid _getpid
+#else
+#  include <unistd.h>
+#endif
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Define Trace flags for use within this file:
+static ossimTrace traceDebug ("ossimDimapXmlReader:debug");
+
+namespace ossimplugins
+{
+   const char* ossimDimapXmlReader::CACHE_DIRECTORY_PREF_KW = "dimap_xml_cache.directory";
+
+   // Cache file layout, native byte order:
+   //   magic[8], version, byte order mark, payload size, payload checksum,
+   //   xml file size, xml file mtime, xml file path, kept paths,
+   //   then the root node: tag, text, attributes (name, value), children.
+   static const char         CACHE_MAGIC[8]    = { 'O', 'D', 'I', 'M', 'A', 'P', 'X', 'C' };
+   static const ossim_uint32 CACHE_VERSION     = 1;
+   static const ossim_uint32 CACHE_BYTE_ORDER  = 0x01020304;
+
+   // Deepest element nesting accepted, in the xml and in cache files.  DIMAP
+   // goes about ten levels deep; the limit keeps the recursive parser off
+   // the end of the stack on hostile input.
+   static const ossim_uint32 MAX_DEPTH         = 256;
+
+   static ossim_uint64 fnv1a(const char* data, size_t size,
+                             ossim_uint64 hash = 14695981039346656037ULL)
+   {
+      for (size_t i = 0; i < size; ++i)
+      {
+         hash ^= static_cast<unsigned char>(data[i]);
+         hash *= 1099511628211ULL;
+      }
+      return hash;
+   }
+
+   /** @return true if b is a or is below a, e.g. "A/B" and "A/B/C". */
+   static bool isSameOrBelow(const std::string& a, const std::string& b)
+   {
+      return ( b.size() >= a.size() ) &&
+         ( b.compare(0, a.size(), a) == 0 ) &&
+         ( (b.size() == a.size()) || (b[a.size()] == '/') );
+   }
+
+   static bool isSpace(char c)
+   {
+      return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r');
+   }
+
+   static bool isNameEnd(char c)
+   {
+      return isSpace(c) || (c == '>') || (c == '/') || (c == '=');
+   }
+
+   //---
+   // Appends [b, e) to out with the predefined and numeric character
+   // references replaced.
+   //---
+   static void appendDecoded(std::string& out, const char* b, const char* e)
+   {
+      while (b < e)
+      {
+         const char* amp = static_cast<const char*>(std::memchr(b, '&', e - b));
+         if (!amp)
+         {
+            out.append(b, e);
+            return;
+         }
+         out.append(b, amp);
+         const char* semi = static_cast<const char*>(std::memchr(amp, ';', e - amp));
+         if (!semi)
+         {
+            out.append(amp, e);
+            return;
+         }
+         std::string name(amp + 1, semi);
+         if      (name == "lt")   out += '<';
+         else if (name == "gt")   out += '>';
+         else if (name == "amp")  out += '&';
+         else if (name == "quot") out += '"';
+         else if (name == "apos") out += '\'';
+         else if ( (name.size() > 1) && (name[0] == '#') )
+         {
+            unsigned long code = (name[1] == 'x') ?
+               std::strtoul(name.c_str() + 2, 0, 16) : std::strtoul(name.c_str() + 1, 0, 10);
+            if (code < 0x80)
+            {
+               out += static_cast<char>(code);
+            }
+            else if (code < 0x800)
+            {
+               out += static_cast<char>(0xC0 | (code >> 6));
+               out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else if (code < 0x10000)
+            {
+               out += static_cast<char>(0xE0 | (code >> 12));
+               out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+               out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+            else
+            {
+               out += static_cast<char>(0xF0 | (code >> 18));
+               out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+               out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+               out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+         }
+         else
+         {
+            out.append(amp, semi + 1);
+         }
+         b = semi + 1;
+      }
+   }
+
+   static void trim(std::string& s)
+   {
+      std::string::size_type first = 0;
+      while ( (first < s.size()) && isSpace(s[first]) )
+      {
+         ++first;
+      }
+      std::string::size_type last = s.size();
+      while ( (last > first) && isSpace(s[last - 1]) )
+      {
+         --last;
+      }
+      s = s.substr(first, last - first);
+   }
+
+   //---
+   // Recursive descent xml parser over a memory buffer.  Elements that are
+   // not kept are skipped by counting start and end tags, without creating
+   // anything.
+   //---
+   class ossimDimapXmlParser
+   {
+   public:
+      ossimDimapXmlParser(const char* begin, const char* end,
+                          const std::vector<std::string>* keptPaths)
+         : m_p(begin), m_end(end), m_keptPaths(keptPaths), m_depth(0)
+      {
+      }
+
+      ossimRefPtr<ossimXmlNode> parse()
+      {
+         ossimRefPtr<ossimXmlNode> root;
+         if (startsWith("\xEF\xBB\xBF")) // UTF-8 byte order mark
+         {
+            m_p += 3;
+         }
+         if ( !skipProlog() || (m_p >= m_end) )
+         {
+            return root;
+         }
+         std::string path;
+         if ( !parseElement(path, true, true, root) )
+         {
+            root = 0;
+         }
+         return root;
+      }
+
+   private:
+
+      bool startsWith(const char* s) const
+      {
+         size_t n = std::strlen(s);
+         return ( static_cast<size_t>(m_end - m_p) >= n ) && ( std::memcmp(m_p, s, n) == 0 );
+      }
+
+      /** Moves past the next occurrence of s. */
+      bool skipPast(const char* s)
+      {
+         size_t n = std::strlen(s);
+         while ( static_cast<size_t>(m_end - m_p) >= n )
+         {
+            const char* hit = static_cast<const char*>(
+               std::memchr(m_p, s[0], (m_end - m_p) - n + 1));
+            if (!hit)
+            {
+               break;
+            }
+            if (std::memcmp(hit, s, n) == 0)
+            {
+               m_p = hit + n;
+               return true;
+            }
+            m_p = hit + 1;
+         }
+         m_p = m_end;
+         return false;
+      }
+
+      void skipSpace()
+      {
+         while ( (m_p < m_end) && isSpace(*m_p) )
+         {
+            ++m_p;
+         }
+      }
+
+      /** Skips a comment, processing instruction, CDATA or declaration at m_p. */
+      bool skipMarkup()
+      {
+         if (startsWith("<!--"))
+         {
+            return skipPast("-->");
+         }
+         if (startsWith("<?"))
+         {
+            return skipPast("?>");
+         }
+         if (startsWith("<![CDATA["))
+         {
+            return skipPast("]]>");
+         }
+         // <!DOCTYPE ...>, internal subsets are not expected in DIMAP.
+         return skipPast(">");
+      }
+
+      /** Leaves m_p at the root element. */
+      bool skipProlog()
+      {
+         while (true)
+         {
+            skipSpace();
+            if (m_p >= m_end)
+            {
+               return true;
+            }
+            if (*m_p != '<')
+            {
+               return false;
+            }
+            if ( (m_p + 1 < m_end) && ( (m_p[1] == '?') || (m_p[1] == '!') ) )
+            {
+               if (!skipMarkup())
+               {
+                  return false;
+               }
+            }
+            else
+            {
+               return true;
+            }
+         }
+      }
+
+      bool readName(std::string& name)
+      {
+         const char* b = m_p;
+         while ( (m_p < m_end) && !isNameEnd(*m_p) )
+         {
+            ++m_p;
+         }
+         name.assign(b, m_p);
+         return !name.empty();
+      }
+
+      /**
+       * Reads attributes up to the end of the start tag.
+       * @param node Receives the attributes, may be 0 to skip them.
+       */
+      bool readAttributes(ossimXmlNode* node, bool& empty)
+      {
+         std::string name;
+         std::string value;
+         while (true)
+         {
+            skipSpace();
+            if (m_p >= m_end)
+            {
+               return false;
+            }
+            if (*m_p == '>')
+            {
+               ++m_p;
+               empty = false;
+               return true;
+            }
+            if (*m_p == '/')
+            {
+               ++m_p;
+               if ( (m_p >= m_end) || (*m_p != '>') )
+               {
+                  return false;
+               }
+               ++m_p;
+               empty = true;
+               return true;
+            }
+            if (!readName(name))
+            {
+               return false;
+            }
+            skipSpace();
+            if ( (m_p >= m_end) || (*m_p != '=') )
+            {
+               return false;
+            }
+            ++m_p;
+            skipSpace();
+            if ( (m_p >= m_end) || ( (*m_p != '"') && (*m_p != '\'') ) )
+            {
+               return false;
+            }
+            const char quote = *m_p++;
+            const char* b = m_p;
+            const char* e = static_cast<const char*>(std::memchr(m_p, quote, m_end - m_p));
+            if (!e)
+            {
+               return false;
+            }
+            m_p = e + 1;
+            if (node)
+            {
+               value.clear();
+               appendDecoded(value, b, e);
+               node->addAttribute(ossimString(name), ossimString(value));
+            }
+         }
+      }
+
+      /** Skips the content and end tag of an element whose start tag was read. */
+      bool skipContent()
+      {
+         int depth = 1;
+         bool empty;
+         while (depth > 0)
+         {
+            const char* lt = static_cast<const char*>(std::memchr(m_p, '<', m_end - m_p));
+            if (!lt)
+            {
+               return false;
+            }
+            m_p = lt;
+            if ( (m_p + 1 < m_end) && (m_p[1] == '/') )
+            {
+               if (!skipPast(">"))
+               {
+                  return false;
+               }
+               --depth;
+            }
+            else if ( (m_p + 1 < m_end) && ( (m_p[1] == '!') || (m_p[1] == '?') ) )
+            {
+               if (!skipMarkup())
+               {
+                  return false;
+               }
+            }
+            else
+            {
+               ++m_p;
+               while ( (m_p < m_end) && !isNameEnd(*m_p) )
+               {
+                  ++m_p;
+               }
+               if (!readAttributes(0, empty))
+               {
+                  return false;
+               }
+               if (!empty)
+               {
+                  ++depth;
+               }
+            }
+         }
+         return true;
+      }
+
+      bool isKept(const std::string& path, bool& wholeSubtree) const
+      {
+         if (!m_keptPaths)
+         {
+            wholeSubtree = true;
+            return true;
+         }
+         bool kept = false;
+         for (std::vector<std::string>::const_iterator i = m_keptPaths->begin();
+              i != m_keptPaths->end(); ++i)
+         {
+            if (isSameOrBelow(*i, path))
+            {
+               wholeSubtree = true;
+               return true;
+            }
+            if (isSameOrBelow(path, *i))
+            {
+               kept = true;
+            }
+         }
+         wholeSubtree = false;
+         return kept;
+      }
+
+      /**
+       * Parses the element at m_p.
+       * @param path Path of the parent below the root, "" for the root's
+       * children.  Restored on return.
+       * @param isRoot true for the document root, always kept.
+       * @param wholeSubtree true if the parent is kept with all its
+       * descendants.
+       * @param result The node, left invalid if the element is skipped.
+       */
+      bool parseElement(std::string& path, bool isRoot, bool wholeSubtree,
+                        ossimRefPtr<ossimXmlNode>& result)
+      {
+         ++m_p; // '<'
+         std::string tag;
+         if (!readName(tag))
+         {
+            return false;
+         }
+
+         const std::string::size_type parentSize = path.size();
+         if (!isRoot)
+         {
+            if (!path.empty())
+            {
+               path += '/';
+            }
+            path += tag;
+            if (!wholeSubtree && !isKept(path, wholeSubtree))
+            {
+               path.resize(parentSize);
+               bool empty;
+               return readAttributes(0, empty) && (empty || skipContent());
+            }
+         }
+         else if (m_keptPaths)
+         {
+            wholeSubtree = false;
+         }
+
+         result = new ossimXmlNode();
+         result->setTag(ossimString(tag));
+
+         bool empty;
+         if (!readAttributes(result.get(), empty))
+         {
+            return false;
+         }
+
+         bool ok = true;
+         if (!empty)
+         {
+            if (++m_depth > MAX_DEPTH)
+            {
+               return false;
+            }
+            ok = parseContent(tag, path, wholeSubtree, result.get());
+            --m_depth;
+         }
+         path.resize(parentSize);
+         return ok;
+      }
+
+      bool parseContent(const std::string& tag, std::string& path, bool wholeSubtree,
+                        ossimXmlNode* node)
+      {
+         std::string text;
+         while (true)
+         {
+            const char* lt = static_cast<const char*>(std::memchr(m_p, '<', m_end - m_p));
+            if (!lt)
+            {
+               return false;
+            }
+            appendDecoded(text, m_p, lt);
+            m_p = lt;
+
+            if ( (m_p + 1 < m_end) && (m_p[1] == '/') )
+            {
+               m_p += 2;
+               std::string endTag;
+               if ( !readName(endTag) || (endTag != tag) )
+               {
+                  return false;
+               }
+               skipSpace();
+               if ( (m_p >= m_end) || (*m_p != '>') )
+               {
+                  return false;
+               }
+               ++m_p;
+               break;
+            }
+            else if (startsWith("<![CDATA["))
+            {
+               const char* b = m_p + 9;
+               if (!skipPast("]]>"))
+               {
+                  return false;
+               }
+               text.append(b, m_p - 3);
+            }
+            else if ( (m_p + 1 < m_end) && ( (m_p[1] == '!') || (m_p[1] == '?') ) )
+            {
+               if (!skipMarkup())
+               {
+                  return false;
+               }
+            }
+            else
+            {
+               ossimRefPtr<ossimXmlNode> child;
+               if (!parseElement(path, false, wholeSubtree, child))
+               {
+                  return false;
+               }
+               if (child.valid())
+               {
+                  node->addChildNode(child);
+               }
+            }
+         }
+
+         trim(text);
+         if (!text.empty())
+         {
+            node->setText(ossimString(text));
+         }
+         return true;
+      }
+
+      const char*                     m_p;
+      const char*                     m_end;
+      const std::vector<std::string>* m_keptPaths;
+      ossim_uint32                    m_depth; // Elements being parsed.
+   };
+
+   //---
+   // Binary cache.
+   //---
+
+   static void putUInt32(std::string& out, ossim_uint32 v)
+   {
+      out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+   }
+
+   static void putUInt64(std::string& out, ossim_uint64 v)
+   {
+      out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+   }
+
+   static void putString(std::string& out, const std::string& s)
+   {
+      putUInt32(out, static_cast<ossim_uint32>(s.size()));
+      out.append(s);
+   }
+
+   static void putNode(std::string& out, const ossimXmlNode* node)
+   {
+      putString(out, node->getTag().string());
+      putString(out, node->getText().string());
+
+      const ossimXmlNode::AttributeListType& attributes = node->getAttributes();
+      putUInt32(out, static_cast<ossim_uint32>(attributes.size()));
+      for (ossim_uint32 i = 0; i < attributes.size(); ++i)
+      {
+         putString(out, attributes[i]->getName().string());
+         putString(out, attributes[i]->getValue().string());
+      }
+
+      const ossimXmlNode::ChildListType& children = node->getChildNodes();
+      putUInt32(out, static_cast<ossim_uint32>(children.size()));
+      for (ossim_uint32 i = 0; i < children.size(); ++i)
+      {
+         putNode(out, children[i].get());
+      }
+   }
+
+   class ossimDimapCacheInput
+   {
+   public:
+      ossimDimapCacheInput(const char* begin, const char* end)
+         : m_p(begin), m_end(end)
+      {
+      }
+
+      bool get(void* v, size_t size)
+      {
+         if (static_cast<size_t>(m_end - m_p) < size)
+         {
+            return false;
+         }
+         std::memcpy(v, m_p, size);
+         m_p += size;
+         return true;
+      }
+
+      bool skip(size_t size)
+      {
+         if (static_cast<size_t>(m_end - m_p) < size)
+         {
+            return false;
+         }
+         m_p += size;
+         return true;
+      }
+
+      bool getUInt32(ossim_uint32& v) { return get(&v, sizeof(v)); }
+      bool getUInt64(ossim_uint64& v) { return get(&v, sizeof(v)); }
+
+      bool getString(std::string& s)
+      {
+         ossim_uint32 size;
+         if ( !getUInt32(size) || (static_cast<size_t>(m_end - m_p) < size) )
+         {
+            return false;
+         }
+         s.assign(m_p, m_p + size);
+         m_p += size;
+         return true;
+      }
+
+      bool getNode(ossimRefPtr<ossimXmlNode>& node, ossim_uint32 depth)
+      {
+         std::string a;
+         std::string b;
+         ossim_uint32 count;
+         if ( (depth > MAX_DEPTH) || !getString(a) || !getString(b) )
+         {
+            return false;
+         }
+         node = new ossimXmlNode();
+         node->setTag(ossimString(a));
+         if (!b.empty())
+         {
+            node->setText(ossimString(b));
+         }
+         if (!getUInt32(count))
+         {
+            return false;
+         }
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            if ( !getString(a) || !getString(b) )
+            {
+               return false;
+            }
+            node->addAttribute(ossimString(a), ossimString(b));
+         }
+         if (!getUInt32(count))
+         {
+            return false;
+         }
+         for (ossim_uint32 i = 0; i < count; ++i)
+         {
+            ossimRefPtr<ossimXmlNode> child;
+            if (!getNode(child, depth + 1))
+            {
+               return false;
+            }
+            node->addChildNode(child);
+         }
+         return true;
+      }
+
+      bool atEnd() const { return m_p == m_end; }
+
+   private:
+      const char* m_p;
+      const char* m_end;
+   };
+
+   static bool readWholeFile(const std::string& file, std::vector<char>& buffer)
+   {
+      FILE* fp = std::fopen(file.c_str(), "rb");
+      if (!fp)
+      {
+         return false;
+      }
+      bool ok = false;
+      if (std::fseek(fp, 0, SEEK_END) == 0)
+      {
+         long size = std::ftell(fp);
+         if ( (size >= 0) && (std::fseek(fp, 0, SEEK_SET) == 0) )
+         {
+            buffer.resize(static_cast<size_t>(size));
+            ok = (size == 0) ||
+               (std::fread(&buffer.front(), 1, buffer.size(), fp) == buffer.size());
+         }
+      }
+      std::fclose(fp);
+      return ok;
+   }
+
+   /** Header fields that must match for a cache file to be used. */
+   static std::string cacheKey(const std::string& path, ossim_uint64 size, ossim_int64 mtime,
+                               const std::vector<std::string>* keptPaths)
+   {
+      std::string key;
+      putUInt64(key, size);
+      putUInt64(key, static_cast<ossim_uint64>(mtime));
+      putString(key, path);
+      if (keptPaths)
+      {
+         putUInt32(key, static_cast<ossim_uint32>(keptPaths->size()));
+         for (ossim_uint32 i = 0; i < keptPaths->size(); ++i)
+         {
+            putString(key, (*keptPaths)[i]);
+         }
+      }
+      else
+      {
+         putUInt32(key, 0xFFFFFFFF);
+      }
+      return key;
+   }
+
+   static ossimRefPtr<ossimXmlNode> loadCache(const ossimFilename& cacheFile,
+                                              const std::string& key)
+   {
+      ossimRefPtr<ossimXmlNode> root;
+      std::vector<char> buffer;
+      if ( !cacheFile.exists() || !readWholeFile(cacheFile.string(), buffer) || buffer.empty() )
+      {
+         return root;
+      }
+
+      ossimDimapCacheInput in(&buffer.front(), &buffer.front() + buffer.size());
+      char magic[8];
+      ossim_uint32 version;
+      ossim_uint32 byteOrder;
+      ossim_uint64 payloadSize;
+      ossim_uint64 checksum;
+      if ( !in.get(magic, sizeof(magic)) || (std::memcmp(magic, CACHE_MAGIC, sizeof(magic)) != 0) ||
+           !in.getUInt32(version) || (version != CACHE_VERSION) ||
+           !in.getUInt32(byteOrder) || (byteOrder != CACHE_BYTE_ORDER) ||
+           !in.getUInt64(payloadSize) || !in.getUInt64(checksum) )
+      {
+         return root;
+      }
+
+      const size_t headerSize = sizeof(magic) + 2 * sizeof(ossim_uint32) + 2 * sizeof(ossim_uint64);
+      if ( (payloadSize != buffer.size() - headerSize) ||
+           (fnv1a(&buffer.front() + headerSize, payloadSize) != checksum) ||
+           (buffer.size() - headerSize < key.size()) ||
+           (std::memcmp(&buffer.front() + headerSize, key.data(), key.size()) != 0) )
+      {
+         return root;
+      }
+
+      if ( !in.skip(key.size()) || !in.getNode(root, 0) || !in.atEnd() )
+      {
+         root = 0;
+      }
+      return root;
+   }
+
+   static void saveCache(const ossimFilename& cacheFile, const std::string& key,
+                         const ossimXmlNode* root)
+   {
+      std::string payload(key);
+      putNode(payload, root);
+
+      std::string data(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+      putUInt32(data, CACHE_VERSION);
+      putUInt32(data, CACHE_BYTE_ORDER);
+      putUInt64(data, payload.size());
+      putUInt64(data, fnv1a(payload.data(), payload.size()));
+      data += payload;
+
+      //---
+      // Written to a temporary file and renamed so readers never see a
+      // partial file.  The temporary name is unique to this process and
+      // call, so concurrent writers of the same entry never share it; the
+      // last rename wins and every version is complete.
+      //---
+      static std::atomic<ossim_uint32> tmpCount(0);
+      std::ostringstream tmpName;
+      tmpName << cacheFile << ".tmp." << getpid() << "." << tmpCount++;
+      ossimFilename tmpFile = tmpName.str();
+      FILE* fp = std::fopen(tmpFile.c_str(), "wb");
+      if (!fp)
+      {
+         return;
+      }
+      bool ok = (std::fwrite(data.data(), 1, data.size(), fp) == data.size());
+      ok = (std::fclose(fp) == 0) && ok;
+      if ( !ok || (std::rename(tmpFile.c_str(), cacheFile.c_str()) != 0) )
+      {
+         std::remove(tmpFile.c_str());
+         if (traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << "ossimDimapXmlReader DEBUG: Could not write cache file " << cacheFile << std::endl;
+         }
+      }
+   }
+
+   ossimRefPtr<ossimXmlDocument> ossimDimapXmlReader::read(const ossimFilename& file,
+                                                         const char* const* keptPaths)
+   {
+      static const char MODULE[] = "ossimDimapXmlReader::read";
+
+      ossimRefPtr<ossimXmlDocument> document;
+
+      std::vector<std::string> kept;
+      if (keptPaths)
+      {
+         for (const char* const* p = keptPaths; *p; ++p)
+         {
+            kept.push_back(*p);
+         }
+      }
+      const std::vector<std::string>* keptList = keptPaths ? &kept : 0;
+
+      //---
+      // Cache lookup:
+      //---
+      ossimFilename cacheFile;
+      std::string key;
+      const char* cacheDir = ossimPreferences::instance()->findPreference(CACHE_DIRECTORY_PREF_KW);
+      if (cacheDir && *cacheDir)
+      {
+         struct stat status;
+         ossimFilename path = file.expand();
+         if (stat(path.c_str(), &status) == 0)
+         {
+            key = cacheKey(path.string(), static_cast<ossim_uint64>(status.st_size),
+                           static_cast<ossim_int64>(status.st_mtime), keptList);
+
+            char name[32];
+            std::sprintf(name, "dimap_%016llx.bin",
+                         static_cast<unsigned long long>(fnv1a(key.data(), key.size())));
+            cacheFile = ossimFilename(cacheDir).dirCat(ossimFilename(name));
+
+            ossimRefPtr<ossimXmlNode> root = loadCache(cacheFile, key);
+            if (root.valid())
+            {
+               if (traceDebug())
+               {
+                  ossimNotify(ossimNotifyLevel_DEBUG)
+                     << MODULE << " DEBUG: " << file << " loaded from " << cacheFile << std::endl;
+               }
+               document = new ossimXmlDocument();
+               document->initRoot(root);
+               return document;
+            }
+         }
+      }
+
+      //---
+      // Parse:
+      //---
+      std::vector<char> buffer;
+      if ( !readWholeFile(file.string(), buffer) || buffer.empty() )
+      {
+         if (traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << MODULE << " DEBUG: Could not read " << file << std::endl;
+         }
+         return document;
+      }
+
+      ossimDimapXmlParser parser(&buffer.front(), &buffer.front() + buffer.size(), keptList);
+      ossimRefPtr<ossimXmlNode> root = parser.parse();
+      if (!root.valid())
+      {
+         if (traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << MODULE << " DEBUG: Unable to parse xml file " << file << std::endl;
+         }
+         return document;
+      }
+
+      if (!cacheFile.empty())
+      {
+         ossimFilename dir = cacheFile.path();
+         if (dir.exists() || dir.createDirectory(true))
+         {
+            saveCache(cacheFile, key, root.get());
+         }
+      }
+
+      document = new ossimXmlDocument();
+      document->initRoot(root);
+      return document;
+   }
+}
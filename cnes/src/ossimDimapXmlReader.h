@@ -0,0 +1,56 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: One pass reader of DIMAP metadata files.
+//
+// The support data classes only look at a small part of a DIMAP document.
+// Multi-strip products are mostly ephemeris, attitude and quality lists
+// that are never queried, yet ossimXmlDocument builds nodes for all of them
+// and every findNodes walks past them.  This reader tokenizes the file in
+// one pass and only creates nodes for the elements on a kept path list.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimDimapXmlReader_HEADER
+#define ossimDimapXmlReader_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimXmlDocument.h>
+
+namespace ossimplugins
+{
+   class OSSIM_PLUGINS_DLL ossimDimapXmlReader
+   {
+   public:
+
+      /**
+       * Preference keyword for the binary cache directory,
+       * "dimap_xml_cache.directory: <path>".  No cache if not set.
+       */
+      static const char* CACHE_DIRECTORY_PREF_KW;
+
+      /**
+       * @brief Reads file keeping only the elements under keptPaths.
+       *
+       * If the cache directory preference is set, the kept tree is saved
+       * there in a binary form keyed on the file path, size and
+       * modification time, and later reads of the same unchanged file load
+       * it without reading the xml.
+       *
+       * @param file Metadata file.
+       * @param keptPaths Null terminated list of element paths below the
+       * root element, e.g. "Raster_Data/Raster_Dimensions".  The ancestors
+       * and the whole subtree of each path are kept.  0 keeps everything.
+       * @return The document, or an invalid pointer if the file could not be
+       * read or is not well formed.
+       */
+      static ossimRefPtr<ossimXmlDocument> read(const ossimFilename& file,
+                                                const char* const* keptPaths);
+   };
+}
+
+#endif /* #ifndef ossimDimapXmlReader_HEADER */
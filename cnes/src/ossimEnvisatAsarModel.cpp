@@ -27,6 +27,7 @@
 #include <otb/SensorParams.h>
 #include <otb/RefPoint.h>
 #include <otb/SarSensor.h>
+#include <ossimMappedFileStream.h>
 
 namespace ossimplugins
 {
@@ -111,7 +112,7 @@ namespace ossimplugins
        * Opening and test of the file
        */
       ossimFilename Filename = file;
-      ifstream dataFile(Filename.c_str(), ios::in | ios::binary);
+      ossimMappedFileStream dataFile(Filename);
       if (dataFile.eof())
       {
          dataFile.close();
@@ -347,6 +348,7 @@ namespace ossimplugins
       InitPlatformPosition(kwl, prefix);
       InitRefPoint(kwl, prefix);
       InitSRGR(kwl, prefix);
+      resetProjectionCache();
       return true;
    }
 
@@ -20,6 +20,7 @@
 #include <ossim/base/ossimTrace.h>
 #include <otb/RefPoint.h>
 #include <erssar/ErsSarLeader.h>
+#include <ossimMappedFileStream.h>
 #include <otb/SensorParams.h>
 #include <otb/PlatformPosition.h>
 #include <ossim/base/ossimKeywordNames.h>
@@ -181,7 +182,7 @@ namespace ossimplugins
             /*
              * Leader file data reading
              */
-            std::ifstream leaderFile(leaFilename.c_str(), ios::in | ios::binary);
+            ossimMappedFileStream leaderFile(leaFilename);
             leaderFile >> *theErsSarleader;
             leaderFile.close();
 
@@ -328,6 +329,8 @@ namespace ossimplugins
          }
       }
 
+      resetProjectionCache();
+
       return result;
    }
 
@@ -0,0 +1,135 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Reader of the fixed width fields of a CEOS record.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimFixedWidthFieldReader.h>
+#include <ossimMappedFileStream.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace ossimplugins
+{
+
+// Numbers in CEOS records are at most 32 characters wide.  Wider fields
+// are copied to the heap to be nul terminated for strtol and strtod.
+static const std::size_t MAX_NUMBER_WIDTH = 64;
+
+ossimFixedWidthFieldReader::ossimFixedWidthFieldReader(const char* data, std::size_t size)
+   :
+   m_p(data),
+   m_end(data + size),
+   m_copy(),
+   m_good(true)
+{
+}
+
+ossimFixedWidthFieldReader::ossimFixedWidthFieldReader(std::istream& is, std::size_t size)
+   :
+   m_p(0),
+   m_end(0),
+   m_copy(),
+   m_good(true)
+{
+   std::size_t available = 0;
+   ossimMemoryStreamBuf* buffer = dynamic_cast<ossimMemoryStreamBuf*>(is.rdbuf());
+   if ( buffer && is.good() )
+   {
+      available = size;
+      m_p = buffer->take(available);
+   }
+   else if ( is.good() )
+   {
+      m_copy.resize(size);
+      if (size)
+      {
+         is.read(&m_copy.front(), size);
+         available = static_cast<std::size_t>(is.gcount());
+         m_p = &m_copy.front();
+      }
+   }
+   if (!m_p)
+   {
+      m_p = "";
+   }
+   m_end = m_p + available;
+   if (available < size)
+   {
+      is.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+   }
+}
+
+const char* ossimFixedWidthFieldReader::field(std::size_t& width)
+{
+   const char* start = m_p;
+   if (width > static_cast<std::size_t>(m_end - m_p))
+   {
+      width = m_end - m_p;
+      m_good = false;
+   }
+   m_p += width;
+   return start;
+}
+
+int ossimFixedWidthFieldReader::readInt(std::size_t width)
+{
+   const char* p = field(width);
+   if (width < MAX_NUMBER_WIDTH)
+   {
+      char buf[MAX_NUMBER_WIDTH];
+      std::memcpy(buf, p, width);
+      buf[width] = '\0';
+      return static_cast<int>(std::strtol(buf, 0, 10));
+   }
+   return static_cast<int>(std::strtol(std::string(p, width).c_str(), 0, 10));
+}
+
+double ossimFixedWidthFieldReader::readDouble(std::size_t width)
+{
+   const char* p = field(width);
+   if (width < MAX_NUMBER_WIDTH)
+   {
+      char buf[MAX_NUMBER_WIDTH];
+      std::memcpy(buf, p, width);
+      buf[width] = '\0';
+      return std::strtod(buf, 0);
+   }
+   return std::strtod(std::string(p, width).c_str(), 0);
+}
+
+void ossimFixedWidthFieldReader::readString(std::size_t width, std::string& value)
+{
+   const char* p = field(width);
+   const char* nul = static_cast<const char*>(std::memchr(p, '\0', width));
+   value.assign(p, nul ? nul : p + width);
+}
+
+void ossimFixedWidthFieldReader::readBinary(void* value, std::size_t width)
+{
+   const std::size_t size = width;
+   const char* p = field(width);
+   std::memcpy(value, p, width);
+   if (width < size)
+   {
+      std::memset(static_cast<char*>(value) + width, 0, size - width);
+   }
+}
+
+void ossimFixedWidthFieldReader::skip(std::size_t width)
+{
+   field(width);
+}
+
+bool ossimFixedWidthFieldReader::good() const
+{
+   return m_good;
+}
+
+}
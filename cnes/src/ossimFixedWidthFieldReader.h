@@ -0,0 +1,82 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Reader of the fixed width fields of a CEOS record.
+//
+// The record is a pointer and length.  When the file is read through an
+// ossimMappedFileStream it points into the mapping, so fields are parsed
+// where they are; otherwise the record is read into a buffer once.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimFixedWidthFieldReader_HEADER
+#define ossimFixedWidthFieldReader_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace ossimplugins
+{
+   /**
+    * @brief Parses consecutive fixed width fields of a record.
+    *
+    * Numbers are parsed with strtol and strtod, so they read like the
+    * atoi and atof the record classes used: leading blanks skipped,
+    * trailing characters ignored, 0 if there is no number.  A field past
+    * the end of the record is cut short and clears good().
+    */
+   class OSSIM_PLUGINS_DLL ossimFixedWidthFieldReader
+   {
+   public:
+
+      /**
+       * @brief Fields of [data, data + size).  The range must outlive the
+       * reader.
+       */
+      ossimFixedWidthFieldReader(const char* data, std::size_t size);
+
+      /**
+       * @brief Fields of the next size bytes of is, which is moved past
+       * them.  In place if is reads an ossimMemoryStreamBuf, e.g. a mapped
+       * ossimMappedFileStream, else copied once.  Sets the failbit and
+       * eofbit of is if fewer than size bytes are left.
+       */
+      ossimFixedWidthFieldReader(std::istream& is, std::size_t size);
+
+      /** @return Integer in the next width bytes. */
+      int readInt(std::size_t width);
+
+      /** @return Floating point number in the next width bytes. */
+      double readDouble(std::size_t width);
+
+      /** @brief Next width bytes as text, up to the first nul if any. */
+      void readString(std::size_t width, std::string& value);
+
+      /** @brief Copies the next width bytes as they are, for binary fields. */
+      void readBinary(void* value, std::size_t width);
+
+      /** @brief Moves past the next width bytes. */
+      void skip(std::size_t width);
+
+      /** @return false once a field ran past the end of the record. */
+      bool good() const;
+
+   private:
+
+      /** @return Start of the next field; width is cut to what is left. */
+      const char* field(std::size_t& width);
+
+      const char*       m_p;
+      const char*       m_end;
+      std::vector<char> m_copy;
+      bool              m_good;
+   };
+}
+
+#endif /* #ifndef ossimFixedWidthFieldReader_HEADER */
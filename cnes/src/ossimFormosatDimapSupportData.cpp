@@ -14,6 +14,7 @@
 #include <cstdlib>
 #include <iterator>
 #include <ossimFormosatDimapSupportData.h>
+#include <ossimDimapXmlReader.h>
 #include <ossim/base/ossimFilename.h>
 #include <ossim/base/ossimXmlDocument.h>
 #include <ossim/base/ossimXmlAttribute.h>
@@ -28,6 +29,31 @@
 // Define Trace flags for use within this file:
 static ossimTrace traceDebug ("ossimFormosatDimapSupportData:debug");
 
+//---
+// Elements looked at by the parse methods, below the document root.  Anything
+// else (raw attitudes, quality assessment...) is skipped when reading the
+// file, see ossimDimapXmlReader.  Must be kept in sync with the xpaths used in
+// this file.
+//---
+static const char* KEPT_XML_PATHS[] =
+{
+   "Metadata_Id",
+   "Production",
+   "Raster_Dimensions",
+   "Dataset_Frame",
+   "Dataset_Sources",
+   "Geoposition/Geoposition_Points",
+   "Data_Processing/Regions_Of_Interest",
+   "Data_Strip/Time_Stamp",
+   "Data_Strip/Ephemeris/SATELLITE_ALTITUDE",
+   "Data_Strip/Ephemeris/Raw_Ephemeris/Point_List",
+   "Data_Strip/Attitudes/Corrected_Attitudes",
+   "Data_Strip/Satellite_Attitudes/Corrected_Attitudes",
+   "Data_Strip/Sensor_Configuration",
+   "Data_Strip/Sensor_Calibration",
+   0
+};
+
 static const ossim_uint32  LAGRANGE_FILTER_SIZE = 8; // num samples considered
 
 ossimFormosatDimapSupportData::ossimFormosatDimapSupportData ()
@@ -246,56 +272,17 @@ bool ossimFormosatDimapSupportData::loadXmlFile(const ossimFilename& file)
    clearFields();
    theMetadataFile = file;
  
-   ossim_int64 fileSize = file.fileSize();
-   std::ifstream in(file.c_str(), std::ios::binary|std::ios::in);
-   std::vector<char> fullBuffer;
-   ossimString bufferedIo;
-   if(in.good()&&(fileSize > 0))
-   {
-      char buf[100];
-	  fullBuffer.resize(fileSize);
-      in.read(buf, ossim::min((ossim_int64)100, fileSize));
-      if(!in.fail())
-      {
-         ossimString testString = ossimString(buf,
-                                  buf + in.gcount());
-         if(testString.contains("xml"))
-         {
-            in.seekg(0);
-            in.read(&fullBuffer.front(), (std::streamsize)fullBuffer.size());
-            if(!in.fail())
-            {
-               bufferedIo = ossimString(fullBuffer.begin(),
-                                        fullBuffer.begin()+in.gcount());
-            }
-         }
-      }
-   }
-   else
+   if (file.fileSize() <= 0)
    {
       return false;
    }
+
    //---
-   // Instantiate the XML parser:
+   // Read the xml, keeping only the elements parsed below:
    //---
-   ossimRefPtr<ossimXmlDocument> xmlDocument;
-
-   if(bufferedIo.empty())
-   {
-      xmlDocument = new ossimXmlDocument(file);
-   }
-   else
-   {
-
-      xmlDocument = new ossimXmlDocument;
-      std::istringstream inStringStream(bufferedIo);
-      if(!xmlDocument->read(inStringStream))
-      {
-         return false;
-      }
-   }
- 
-   if (xmlDocument->getErrorStatus())
+   ossimRefPtr<ossimXmlDocument> xmlDocument =
+      ossimplugins::ossimDimapXmlReader::read(file, KEPT_XML_PATHS);
+   if (!xmlDocument.valid())
    {
       if(traceDebug())
       {
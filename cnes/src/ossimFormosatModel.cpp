@@ -13,6 +13,8 @@
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <atomic>
+#include <vector>
 using namespace std;
 
 #include <ossimFormosatModel.h>
@@ -67,6 +69,21 @@ static const ossim_float64 SIGMA[] = { 0.0001,   // degrees
                                        0.00005,  // delta degrees
                                        0.0001 }; // percent
 
+// Source of ossimFormosatModel::theGeometryId values.  Zero is never used.
+static std::atomic<ossim_uint64> geometryIdCounter(0);
+
+//---
+// 3x3 rotation times vector.  Same operation order as the NEWMAT::Matrix
+// times ossimColumnVector3d operator it replaces, so results are unchanged.
+//---
+static inline ossimColumnVector3d rotate(const ossim_float64 m[3][3],
+                                         const ossimColumnVector3d& v)
+{
+   return ossimColumnVector3d(m[0][0]*v[0] + m[0][1]*v[1] + m[0][2]*v[2],
+                              m[1][0]*v[0] + m[1][1]*v[1] + m[1][2]*v[2],
+                              m[2][0]*v[0] + m[2][1]*v[1] + m[2][2]*v[2]);
+}
+
 ossimplugins::ossimFormosatModel::ossimFormosatModel()
    :
    ossimSensorModel      (),
@@ -87,7 +104,8 @@ ossimplugins::ossimFormosatModel::ossimFormosatModel()
    theRollRate           (0.0),
    thePitchRate          (0.0),
    theYawRate            (0.0),
-   theFocalLenOffset     (0.0)
+   theFocalLenOffset     (0.0),
+   theGeometryId         (0)
 {
    initAdjustableParameters();
 }
@@ -112,7 +130,8 @@ ossimplugins::ossimFormosatModel::ossimFormosatModel(ossimFormosatDimapSupportDa
    theRollRate           (0.0),
    thePitchRate          (0.0),
    theYawRate            (0.0),
-   theFocalLenOffset     (0.0)
+   theFocalLenOffset     (0.0),
+   theGeometryId         (0)
 {
    if (traceExec())  ossimNotify(ossimNotifyLevel_DEBUG) << "DEBUG ossimFormosatModel(dimap_file) Constructor: entering..." << std::endl;
 
@@ -150,7 +169,8 @@ ossimplugins::ossimFormosatModel::~ossimFormosatModel()
 }
 
 ossimplugins::ossimFormosatModel::ossimFormosatModel(const ossimFormosatModel& rhs)
-   :ossimSensorModel(rhs)
+   :ossimSensorModel(rhs),
+    theGeometryId(0)
 {
    if(rhs.theSupportData.valid())
    {
@@ -161,7 +181,7 @@ ossimplugins::ossimFormosatModel::ossimFormosatModel(const ossimFormosatModel& r
 }
 
 
-void ossimplugins::ossimFormosatModel::computeSatToOrbRotation(NEWMAT::Matrix& result, ossim_float64 t)const
+void ossimplugins::ossimFormosatModel::computeSatToOrbRotation(ossim_float64 result[3][3], ossim_float64 t)const
 {
    if (traceExec())
    {
@@ -196,10 +216,15 @@ void ossimplugins::ossimFormosatModel::computeSatToOrbRotation(NEWMAT::Matrix& r
    //---
    // Populate rotation matrix:
    //---
-   result = NEWMAT::Matrix(3,3);
-   result << (cr*cy) << (-cr*sy) << (-sr)
-   << (cp*sy+sp*sr*cy) << (cp*cy-sp*sr*sy) << (sp*cr)
-   << (-sp*sy+cp*sr*cy) << (-sp*cy-cp*sr*sy) <<  cp*cr;
+   result[0][0] = cr*cy;
+   result[0][1] = -cr*sy;
+   result[0][2] = -sr;
+   result[1][0] = cp*sy+sp*sr*cy;
+   result[1][1] = cp*cy-sp*sr*sy;
+   result[1][2] = sp*cr;
+   result[2][0] = -sp*sy+cp*sr*cy;
+   result[2][1] = -sp*cy-cp*sr*sy;
+   result[2][2] = cp*cr;
 
 
    if (traceExec())  ossimNotify(ossimNotifyLevel_DEBUG) << "DEBUG ossimFormosatModel::computeSatToOrbRotation(): returning..." << std::endl;
@@ -289,6 +314,8 @@ void ossimplugins::ossimFormosatModel::updateModel()
          theYawRate        = computeParameterOffset(5);
          theFocalLenOffset = computeParameterOffset(6);
       }
+      theGeometryId = ++geometryIdCounter;
+      theProjectionCache.reset();
       theSeedFunction = 0;
       ossimGpt ulg, urg, lrg, llg;
       lineSampleToWorld(theImageClipRect.ul(), ulg);
@@ -536,18 +563,41 @@ bool ossimplugins::ossimFormosatModel::loadState(const ossimKeywordlist& kwl,
 void ossimplugins::ossimFormosatModel::imagingRay(const ossimDpt& image_point,
                                  ossimEcefRay&   image_ray) const
 {
-   bool runtime_dbflag = 0;
-   NEWMAT::Matrix satToOrbit;
    ossimDpt iPt = image_point;
    iPt.samp += theSpotSubImageOffset.samp;
    iPt.line += theSpotSubImageOffset.line;
 
+   //---
+   // Samples of a line share the ephemeris and attitude, so the last line
+   // is kept per thread.
+   //---
+   static thread_local LineGeometry geom;
+   static thread_local ossim_uint64 geomId = 0;
+   static thread_local ossim_float64 geomLine = 0.0;
+   if ( (geomId != theGeometryId) || (geomLine != iPt.line) || !theGeometryId )
+   {
+      computeLineGeometry(iPt.line, geom);
+      geomId = theGeometryId;
+      geomLine = iPt.line;
+   }
+   image_ray = imagingRay(geom, computeLookDirection(iPt.samp));
+
+   if (traceExec())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "DEBUG FormosatModel::imagingRay(): returning..." << std::endl;
+   }
+}
+
+void ossimplugins::ossimFormosatModel::computeLineGeometry(ossim_float64 line,
+                                                           LineGeometry& geom) const
+{
    //
    // 1. Establish time of line imaging:
    //
    double t_line = theRefImagingTime +
-                   theLineSamplingPeriod*(iPt.line - theRefImagingTimeLine);
-   if (traceDebug() || runtime_dbflag)
+                   theLineSamplingPeriod*(line - theRefImagingTimeLine);
+   if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << "DEBUG FormosatModel::imagingRay():------------ BEGIN DEBUG PASS ---------------" << std::endl;
       ossimNotify(ossimNotifyLevel_DEBUG) << "DEBUG FormosatModel::imagingRay(): t_line = " << t_line << std::endl;
@@ -557,101 +607,147 @@ void ossimplugins::ossimFormosatModel::imagingRay(const ossimDpt& image_point,
    // 2. Interpolate ephemeris position and velocity (in ECF):
    //
    ossimEcefPoint  tempEcefPoint;
-   ossimEcefPoint  P_ecf;
-   theSupportData->getPositionEcf(t_line, P_ecf);
+   theSupportData->getPositionEcf(t_line, geom.P_ecf);
    theSupportData->getVelocityEcf(t_line, tempEcefPoint);
    ossimEcefVector V_ecf(tempEcefPoint.x(),
                          tempEcefPoint.y(),
                          tempEcefPoint.z());
-   if (traceDebug() || runtime_dbflag)
+   if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
-         << "DEBUG:\n\tP_ecf = " << P_ecf
+         << "DEBUG:\n\tP_ecf = " << geom.P_ecf
          << "\n\t V_ecf = " << V_ecf << std::endl;
    }
 
    //
-   // 3. Establish the look direction in Vehicle LSR space (S_sat).
-   //    ANGLES IN RADIANS
+   // 4. Vehicle LSR space to orbital LSR space (S_orb) rotation:
    //
-    ossim_float64 Psi_x;
-    theSupportData->getPixelLookAngleX(iPt.samp, Psi_x);
-    ossim_float64 Psi_y;
-    theSupportData->getPixelLookAngleY(iPt.samp, Psi_y);
-    if (traceDebug() || runtime_dbflag)
-    {
-       ossimNotify(ossimNotifyLevel_DEBUG)
-          << "DEBUG:\n\t Psi_x = " << Psi_x
-          << "\n\t Psi_y = " << Psi_y << endl;
-    }
-
-    ossimColumnVector3d u_sat (-tan(Psi_y), tan(Psi_x), -(1.0 + theFocalLenOffset));
-    if (traceDebug() || runtime_dbflag)
-    {
-       ossimNotify(ossimNotifyLevel_DEBUG)
-          << "DEBUG \n\t u_sat = " << u_sat << endl;
-    }
+   computeSatToOrbRotation(geom.satToOrbit, t_line);
 
    //
-   // 4. Transform vehicle LSR space look direction vector to orbital LSR space
-   //    (S_orb):
-   //
-    computeSatToOrbRotation(satToOrbit, t_line);
-
-    ossimColumnVector3d u_orb = (satToOrbit*u_sat).unit();
-    if (traceDebug() || runtime_dbflag)
-    {
-       ossimNotify(ossimNotifyLevel_DEBUG)
-          << "DEBUG:\n\t theSatToOrbRotation = " << satToOrbit
-          << "\n\t u_orb = " << u_orb << endl;
-    }
-
-   //
-   // 5. Transform orbital LSR space look direction vector to ECF.
+   // 5. Orbital LSR space to ECF rotation.
    //
    //   a. S_orb space Z-axis (Z_orb) is || to the ECF radial vector (P_ecf),
    //   b. X_orb axis is computed as cross-product between velocity and radial,
    //   c. Y_orb completes the orthogonal S_orb coordinate system.
    //
-    ossimColumnVector3d Z_orb (P_ecf.x(),
-                               P_ecf.y(),
-                               P_ecf.z());
-    Z_orb = Z_orb.unit();
-
-    ossimColumnVector3d X_orb = ossimColumnVector3d(V_ecf.x(),
-                                                    V_ecf.y(),
-                                                    V_ecf.z()).cross(Z_orb).unit();
-    ossimColumnVector3d Y_orb = Z_orb.cross(X_orb);
-
-    NEWMAT::Matrix orbToEcfRotation = NEWMAT::Matrix(3, 3);
-    orbToEcfRotation << X_orb[0] << Y_orb[0] << Z_orb[0]
-                        << X_orb[1] << Y_orb[1] << Z_orb[1]
-                        << X_orb[2] << Y_orb[2] << Z_orb[2];
-
-
-   ossimColumnVector3d u_ecf  = (orbToEcfRotation*u_orb);
-    if (traceDebug() || runtime_dbflag)
-    {
-       ossimNotify(ossimNotifyLevel_DEBUG)
-          << "DEBUG:\n\t orbToEcfRotation = " << orbToEcfRotation
-          << "\n\t u_ecf = " << u_ecf << endl;
-    }
+   ossimColumnVector3d Z_orb (geom.P_ecf.x(),
+                              geom.P_ecf.y(),
+                              geom.P_ecf.z());
+   Z_orb = Z_orb.unit();
+
+   ossimColumnVector3d X_orb = ossimColumnVector3d(V_ecf.x(),
+                                                   V_ecf.y(),
+                                                   V_ecf.z()).cross(Z_orb).unit();
+   ossimColumnVector3d Y_orb = Z_orb.cross(X_orb);
 
+   for (int i = 0; i < 3; ++i)
+   {
+      geom.orbToEcf[i][0] = X_orb[i];
+      geom.orbToEcf[i][1] = Y_orb[i];
+      geom.orbToEcf[i][2] = Z_orb[i];
+   }
+   if (traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG) << "DEBUG:\n\t theSatToOrbRotation =";
+      for (int i = 0; i < 3; ++i)
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "\n\t " << geom.satToOrbit[i][0] << " " << geom.satToOrbit[i][1]
+            << " " << geom.satToOrbit[i][2];
+      }
+      ossimNotify(ossimNotifyLevel_DEBUG) << "\n\t orbToEcfRotation =";
+      for (int i = 0; i < 3; ++i)
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "\n\t " << geom.orbToEcf[i][0] << " " << geom.orbToEcf[i][1]
+            << " " << geom.orbToEcf[i][2];
+      }
+      ossimNotify(ossimNotifyLevel_DEBUG) << endl;
+   }
+}
+
+ossimColumnVector3d ossimplugins::ossimFormosatModel::computeLookDirection(ossim_float64 samp) const
+{
    //
-   // Establish the imaging ray given direction and origin:
+   // 3. Establish the look direction in Vehicle LSR space (S_sat).
+   //    ANGLES IN RADIANS
    //
-    image_ray = ossimEcefRay(P_ecf, ossimEcefVector(u_ecf[0], u_ecf[1], u_ecf[2]));
+   ossim_float64 Psi_x;
+   theSupportData->getPixelLookAngleX(samp, Psi_x);
+   ossim_float64 Psi_y;
+   theSupportData->getPixelLookAngleY(samp, Psi_y);
+   if (traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "DEBUG:\n\t Psi_x = " << Psi_x
+         << "\n\t Psi_y = " << Psi_y << endl;
+   }
+
+   return ossimColumnVector3d(-tan(Psi_y), tan(Psi_x), -(1.0 + theFocalLenOffset));
+}
+
+ossimEcefRay ossimplugins::ossimFormosatModel::imagingRay(const LineGeometry& geom,
+                                                          const ossimColumnVector3d& u_sat) const
+{
+   ossimColumnVector3d u_orb = rotate(geom.satToOrbit, u_sat).unit();
+   ossimColumnVector3d u_ecf = rotate(geom.orbToEcf, u_orb);
+   if (traceDebug())
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "DEBUG \n\t u_sat = " << u_sat
+         << "\n\t u_orb = " << u_orb
+         << "\n\t u_ecf = " << u_ecf << endl;
+   }
 
-    if (traceExec())
-    {
-       ossimNotify(ossimNotifyLevel_DEBUG)
-          << "DEBUG FormosatModel::imagingRay(): returning..." << std::endl;
-    }
+   //
+   // Establish the imaging ray given direction and origin:
+   //
+   return ossimEcefRay(geom.P_ecf, ossimEcefVector(u_ecf[0], u_ecf[1], u_ecf[2]));
 }
 
 void ossimplugins::ossimFormosatModel::lineSampleHeightToWorld(const ossimDpt& image_point,
                                               const ossim_float64& heightEllipsoid,
                                               ossimGpt& worldPoint) const
+{
+   ossimProjectionGridCache::ConstPtr cache = getProjectionCache();
+   if (!cache || !cache->lineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint))
+   {
+      rigorousLineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint);
+   }
+}
+
+void ossimplugins::ossimFormosatModel::worldToLineSample(const ossimGpt& world_point,
+                                                         ossimDpt&       image_point) const
+{
+   ossimProjectionGridCache::ConstPtr cache = getProjectionCache();
+   if (!cache || !cache->worldToLineSample(world_point, image_point))
+   {
+      ossimSensorModel::worldToLineSample(world_point, image_point);
+   }
+}
+
+ossimplugins::ossimProjectionGridCache::ConstPtr ossimplugins::ossimFormosatModel::getProjectionCache() const
+{
+   if (!theSupportData)
+   {
+      return ossimProjectionGridCache::ConstPtr();
+   }
+   return theProjectionCache.get(
+      theImageClipRect,
+      [this](const ossimDpt& ip, const double& h, ossimGpt& gp)
+      {
+         rigorousLineSampleHeightToWorld(ip, h, gp);
+      },
+      [this](const ossimGpt& gp, ossimDpt& ip)
+      {
+         ossimSensorModel::worldToLineSample(gp, ip);
+      });
+}
+
+void ossimplugins::ossimFormosatModel::rigorousLineSampleHeightToWorld(const ossimDpt& image_point,
+                                                                       const ossim_float64& heightEllipsoid,
+                                                                       ossimGpt& worldPoint) const
 {
    if (!insideImage(image_point))
    {
@@ -676,6 +772,86 @@ void ossimplugins::ossimFormosatModel::lineSampleHeightToWorld(const ossimDpt& i
    worldPoint = ossimGpt(Pecf);
 }
 
+void ossimplugins::ossimFormosatModel::lineSampleHeightToWorldGrid(const ossimDpt& origin,
+                                                                   const ossimDpt& spacing,
+                                                                   const ossimIpt& size,
+                                                                   const ossim_float64& heightEllipsoid,
+                                                                   ossimGpt* worldPoints) const
+{
+   if (!worldPoints || (size.x <= 0) || (size.y <= 0))
+   {
+      return;
+   }
+
+   const ossim_uint32 nCols = static_cast<ossim_uint32>(size.x);
+   const ossim_uint32 nRows = static_cast<ossim_uint32>(size.y);
+
+   // Look direction only depends on the sample.
+   std::vector<ossimColumnVector3d> u_sat(nCols);
+   for (ossim_uint32 c = 0; c < nCols; ++c)
+   {
+      u_sat[c] = computeLookDirection(origin.x + c*spacing.x + theSpotSubImageOffset.samp);
+   }
+
+   LineGeometry geom;
+   ossimGpt* worldPoint = worldPoints;
+   for (ossim_uint32 r = 0; r < nRows; ++r)
+   {
+      ossimDpt ipt(origin.x, origin.y + r*spacing.y);
+      bool haveGeom = false;
+      for (ossim_uint32 c = 0; c < nCols; ++c, ++worldPoint)
+      {
+         ipt.x = origin.x + c*spacing.x;
+         if (!insideImage(ipt))
+         {
+            lineSampleHeightToWorld(ipt, heightEllipsoid, *worldPoint);
+            continue;
+         }
+         if (!haveGeom)
+         {
+            // Ephemeris and attitude only depend on the line.
+            computeLineGeometry(ipt.y + theSpotSubImageOffset.line, geom);
+            haveGeom = true;
+         }
+         ossimEcefPoint Pecf (imagingRay(geom, u_sat[c]).intersectAboveEarthEllipsoid(heightEllipsoid));
+         *worldPoint = ossimGpt(Pecf);
+      }
+   }
+}
+
+void ossimplugins::ossimFormosatModel::lineSampleHeightToWorldArray(const ossimDpt* imagePoints,
+                                                                    const ossim_float64* heightsEllipsoid,
+                                                                    ossim_uint32 count,
+                                                                    ossimGpt* worldPoints) const
+{
+   if (!imagePoints || !heightsEllipsoid || !worldPoints)
+   {
+      return;
+   }
+
+   LineGeometry geom;
+   bool haveGeom = false;
+   ossim_float64 geomLine = 0.0;
+   for (ossim_uint32 i = 0; i < count; ++i)
+   {
+      const ossimDpt& ipt = imagePoints[i];
+      if (!insideImage(ipt))
+      {
+         lineSampleHeightToWorld(ipt, heightsEllipsoid[i], worldPoints[i]);
+         continue;
+      }
+      if (!haveGeom || (ipt.y != geomLine))
+      {
+         computeLineGeometry(ipt.y + theSpotSubImageOffset.line, geom);
+         geomLine = ipt.y;
+         haveGeom = true;
+      }
+      ossimEcefRay ray = imagingRay(geom, computeLookDirection(ipt.x + theSpotSubImageOffset.samp));
+      ossimEcefPoint Pecf (ray.intersectAboveEarthEllipsoid(heightsEllipsoid[i]));
+      worldPoints[i] = ossimGpt(Pecf);
+   }
+}
+
 // ossimDpt ossimplugins::ossimFormosatModel::extrapolate (const ossimGpt& gp) const
 // {
 //     ossimDpt temp;
@@ -26,6 +26,8 @@ using namespace std;
 #include <ossim/base/ossimEcefRay.h>
 #include <ossim/base/ossimEcefPoint.h>
 #include <ossim/base/ossimMatrix3x3.h>
+#include <ossim/base/ossimColumnVector3d.h>
+#include <ossimProjectionGridCache.h>
 
 class ossimFormosatDimapSupportData;
 
@@ -90,6 +92,13 @@ public:
    virtual void lineSampleHeightToWorld(const ossimDpt& image_point,
                                         const ossim_float64& heightEllipsoid,
                                         ossimGpt& worldPoint) const;
+
+   /*!
+    * Given a world point, initializes image_point.  Uses the projection
+    * cache if turned on, else ossimSensorModel::worldToLineSample.
+    */
+   virtual void worldToLineSample(const ossimGpt& world_point,
+                                  ossimDpt&       image_point) const;
    
    /*!
     * Given an image point, returns a ray originating at some arbitrarily high
@@ -98,6 +107,29 @@ public:
    virtual void imagingRay(const ossimDpt& image_point,
                            ossimEcefRay&   image_ray) const;
 
+   /*!
+    * Projects a regular grid of image points, e.g. the interpolation grid
+    * of an ortho tile or a full line, at one height into worldPoints
+    * (size.x * size.y points, row major).  Same points as
+    * lineSampleHeightToWorld on each node, but the ephemeris and attitude
+    * are interpolated once per grid row and the look angles computed once
+    * per grid column.
+    */
+   void lineSampleHeightToWorldGrid(const ossimDpt& origin,
+                                    const ossimDpt& spacing,
+                                    const ossimIpt& size,
+                                    const ossim_float64& heightEllipsoid,
+                                    ossimGpt* worldPoints) const;
+
+   /*!
+    * lineSampleHeightToWorld on an array of points.  The ephemeris and
+    * attitude are reused while consecutive points are on the same line.
+    */
+   void lineSampleHeightToWorldArray(const ossimDpt* imagePoints,
+                                     const ossim_float64* heightsEllipsoid,
+                                     ossim_uint32 count,
+                                     ossimGpt* worldPoints) const;
+
    /*!
     * Following a change to the adjustable parameter set, this virtual
     * is called to permit instances to compute derived quantities after
@@ -122,7 +154,47 @@ protected:
    void loadGeometry(FILE*);
    void loadSupportData();
    //void computeSatToOrbRotation(ossim_float64 t)const;
-   void computeSatToOrbRotation(NEWMAT::Matrix& result, ossim_float64 t)const;
+   void computeSatToOrbRotation(ossim_float64 result[3][3], ossim_float64 t)const;
+
+   /*!
+    * Sensor position and look direction rotations at one image line.
+    * Fixed size so nothing is allocated per point.
+    */
+   struct LineGeometry
+   {
+      ossimEcefPoint P_ecf;
+      ossim_float64  satToOrbit[3][3];
+      ossim_float64  orbToEcf[3][3];
+   };
+
+   /*!
+    * Fills geom for image line (sub image coordinates).
+    */
+   void computeLineGeometry(ossim_float64 line, LineGeometry& geom) const;
+
+   /*!
+    * Look direction in vehicle space of image sample (sub image coordinates).
+    */
+   ossimColumnVector3d computeLookDirection(ossim_float64 samp) const;
+
+   /*!
+    * Imaging ray of the look direction u_sat from a line.
+    */
+   ossimEcefRay imagingRay(const LineGeometry& geom,
+                           const ossimColumnVector3d& u_sat) const;
+
+   /*!
+    * lineSampleHeightToWorld without the projection cache.
+    */
+   void rigorousLineSampleHeightToWorld(const ossimDpt& image_point,
+                                        const ossim_float64& heightEllipsoid,
+                                        ossimGpt& worldPoint) const;
+
+   /*!
+    * Projection cache, or empty if not turned on by preference.
+    * See ossimProjectionGridCache.
+    */
+   ossimProjectionGridCache::ConstPtr getProjectionCache() const;
 
 /*    virtual ossimDpt extrapolate (const ossimGpt& gp) const; */
 /*    virtual ossimGpt extrapolate (const ossimDpt& ip, */
@@ -159,6 +231,13 @@ protected:
    ossim_float64  theYawRate;         // degrees/sec
    ossim_float64  theFocalLenOffset;  // percent deviation from nominal
 
+   /**
+    * New value on every updateModel.  Keys the per thread line geometry
+    * cache used by imagingRay.
+    */
+   ossim_uint64   theGeometryId;
+
+   ossimProjectionGridCache::Holder theProjectionCache;
 
 TYPE_DATA
 };
@@ -12,10 +12,12 @@
 #include <ossimGeometricSarSensorModel.h>
 
 #include <otb/Ephemeris.h>
+#include <otb/GeographicEphemeris.h>
 #include <otb/PlatformPosition.h>
 #include <otb/SensorParams.h>
 #include <otb/RefPoint.h>
 #include <otb/SarSensor.h>
+#include <ossim/base/ossimCommon.h>
 #include <ossim/base/ossimTrace.h>
 #include <ossim/base/ossimPreferences.h>
 #include <ossim/projection/ossimCoarseGridModel.h>
@@ -39,13 +41,39 @@ namespace ossimplugins
 
    static ossimTrace traceDebug("ossimGeometricSarSensorModel:debug");
 
+   //---
+   // Last solution of worldToLineSample and lineSampleToWorld on this thread,
+   // used as starting point for the next call.  Neighbouring points of a tile
+   // are close in azimuth time and on the ground.
+   //---
+   struct ossimSarProjectionSeed
+   {
+      const ossimGeometricSarSensorModel* model;
+      double   deltaTime;
+      double   col;
+      bool     hasGroundPoint;
+      ossimGpt groundPoint;
+   };
+   static thread_local ossimSarProjectionSeed projectionSeed = { 0, 0.0, 0.0, false, ossimGpt() };
+
+   static ossimSarProjectionSeed& getProjectionSeed(const ossimGeometricSarSensorModel* model)
+   {
+      if (projectionSeed.model != model)
+      {
+         projectionSeed.model = model;
+         projectionSeed.hasGroundPoint = false;
+         projectionSeed.deltaTime = ossim::nan();
+         projectionSeed.col = ossim::nan();
+      }
+      return projectionSeed;
+   }
+
    ossimGeometricSarSensorModel::ossimGeometricSarSensorModel()
       :
       ossimSensorModel(),
       _platformPosition(0),
       _sensor(0),
       _refPoint(0),
-      _sarSensor(0),
       _isProductGeoreferenced(false),
       _optimizationFactorX(0.0),
       _optimizationFactorY(0.0),
@@ -69,7 +97,6 @@ namespace ossimplugins
       _imageFilename(rhs._imageFilename),
       _productXmlFile(rhs._productXmlFile)
    {
-      _sarSensor = new SarSensor(_sensor,_platformPosition);
    }
 
    ossimGeometricSarSensorModel::~ossimGeometricSarSensorModel()
@@ -86,12 +113,6 @@ namespace ossimplugins
          _sensor = 0;
       }
 
-      if (_sarSensor != 0)
-      {
-         delete _sarSensor;
-         _sarSensor = 0;
-      }
-
       if(_refPoint != 0)
       {
          delete _refPoint;
@@ -130,11 +151,26 @@ namespace ossimplugins
       const double&   heightEllipsoid,
       ossimGpt&       worldPoint) const
    {
+      ossimProjectionGridCache::ConstPtr cache = getProjectionCache();
+      if ( !cache || !cache->lineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint) )
+      {
+         rigorousLineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint);
+      }
+   }
 
-      if (!_sarSensor)
+   void ossimGeometricSarSensorModel::rigorousLineSampleHeightToWorld(
+      const ossimDpt& image_point,
+      const double&   heightEllipsoid,
+      ossimGpt&       worldPoint) const
+   {
+      //---
+      // Nothing in here modifies the model, so one model may be shared by
+      // several threads.
+      //---
+      if (!_sensor || !_platformPosition || !_refPoint)
       {
-         // bad design consequence, should be fixed.
-         _sarSensor = new SarSensor(_sensor, _platformPosition);
+         worldPoint.makeNan();
+         return;
       }
       double lon, lat;
       // const double CLUM        = 2.99792458e+8 ;
@@ -156,7 +192,8 @@ namespace ossimplugins
          slantRange = getSlantRange(col) ;
       }
    
-      int etatLoc = _sarSensor->ImageToWorld(slantRange, azimuthTime, heightEllipsoid, lon, lat);
+      int etatLoc = SarSensor::ImageToWorld(*_sensor, *_platformPosition,
+                                            slantRange, azimuthTime, heightEllipsoid, lon, lat);
 
       if(traceDebug())
       {
@@ -182,6 +219,268 @@ namespace ossimplugins
       worldPoint.hgt = heightEllipsoid ;
    }
 
+   void ossimGeometricSarSensorModel::worldToLineSample(
+      const ossimGpt& world_point,
+      ossimDpt&       image_point) const
+   {
+      ossimProjectionGridCache::ConstPtr cache = getProjectionCache();
+      if ( !cache || !cache->worldToLineSample(world_point, image_point) )
+      {
+         rigorousWorldToLineSample(world_point, image_point);
+      }
+   }
+
+   void ossimGeometricSarSensorModel::rigorousWorldToLineSample(
+      const ossimGpt& world_point,
+      ossimDpt&       image_point) const
+   {
+      if ( world_point.isLatNan() || world_point.isLonNan() ||
+           !_sensor || !_platformPosition || !_refPoint || !_refPoint->get_ephemeris() )
+      {
+         image_point.makeNan();
+         return;
+      }
+
+      // Same bounding test as ossimSensorModel::worldToLineSample.
+      if ( (theBoundGndPolygon.getNumberOfVertices() > 0) &&
+           !theBoundGndPolygon.hasNans() &&
+           !theSeedFunction.valid() && !theExtrapolateGroundFlag )
+      {
+         if ( !theBoundGndPolygon.pointWithin(ossimDpt(world_point)) )
+         {
+            image_point = extrapolate(world_point);
+            return;
+         }
+      }
+
+      double height = world_point.hgt;
+      if ( ossim::isnan(height) )
+      {
+         height = 0.0;
+      }
+
+      ossimSarProjectionSeed& seed = getProjectionSeed(this);
+
+      // Reference time unless the last solution is usable.
+      const double refDeltaTime =
+         _platformPosition->getDeltaTime(_refPoint->get_ephemeris()->get_date());
+      double deltaTime = seed.deltaTime;
+      if ( ossim::isnan(deltaTime) || (deltaTime < 0.0) ||
+           (deltaTime > _platformPosition->getTimeSpan()) )
+      {
+         deltaTime = refDeltaTime;
+      }
+
+      double distance;
+      int state = SarSensor::WorldToImage(*_sensor, *_platformPosition,
+                                          world_point.lond(), world_point.latd(), height,
+                                          deltaTime, distance);
+
+      double col = seed.col;
+      if ( ossim::isnan(col) )
+      {
+         col = _refPoint->get_pix_col();
+      }
+      if ( (state == 2) || !getColFromSlantRange(distance, col) )
+      {
+         if (traceDebug())
+         {
+            ossimNotify(ossimNotifyLevel_DEBUG)
+               << "worldToLineSample : no convergence, using iterative scheme" << std::endl;
+         }
+         ossimSensorModel::worldToLineSample(world_point, image_point);
+         return;
+      }
+      if (state == 1)
+      {
+         // Point is on the side of the track the sensor does not look at.
+         image_point.makeNan();
+         return;
+      }
+
+      // Inverse of getTime.
+      double line = _refPoint->get_pix_line()
+         + (deltaTime - refDeltaTime) * _sensor->get_prf()
+         / (_sensor->get_lin_direction() * _sensor->get_nAzimuthLook());
+
+      seed.deltaTime = deltaTime;
+      seed.col = col;
+
+      // Inverse of the optimization applied in lineSampleHeightToWorld.
+      image_point.x = (col + _optimizationBiasX) / (1.0 - _optimizationFactorX);
+      image_point.y = (line + _optimizationBiasY) / (1.0 - _optimizationFactorY);
+   }
+
+   ossimProjectionGridCache::ConstPtr ossimGeometricSarSensorModel::getProjectionCache() const
+   {
+      if (!_sensor || !_platformPosition || !_refPoint)
+      {
+         return ossimProjectionGridCache::ConstPtr();
+      }
+      return _projectionCache.get(
+         theImageClipRect,
+         [this](const ossimDpt& ip, const double& h, ossimGpt& gp)
+         {
+            rigorousLineSampleHeightToWorld(ip, h, gp);
+         },
+         [this](const ossimGpt& gp, ossimDpt& ip)
+         {
+            rigorousWorldToLineSample(gp, ip);
+         });
+   }
+
+   void ossimGeometricSarSensorModel::resetProjectionCache()
+   {
+      _projectionCache.reset();
+   }
+
+   bool ossimGeometricSarSensorModel::getColFromSlantRange(double slantRange, double& col) const
+   {
+      const double CLUM = 2.99792458e+8 ;
+
+      if (!_isProductGeoreferenced)
+      {
+         // getSlantRange is linear in col.
+         double pixelSize = _sensor->get_col_direction()
+            * ((CLUM / 2.0) * _sensor->get_nRangeLook() / _sensor->get_sf());
+         if (pixelSize == 0.0)
+         {
+            return false;
+         }
+         col = _refPoint->get_pix_col() + (slantRange - _refPoint->get_distance()) / pixelSize;
+         return true;
+      }
+
+      // Secant steps on the ground to slant range polynomial.
+      const int    MAX_ITERATIONS = 20;
+      const double COL_EPSILON    = 1.0e-6;
+      double c0 = col;
+      double r0 = getSlantRangeFromGeoreferenced(c0) - slantRange;
+      double c1 = col + 1.0;
+      for (int i = 0; i < MAX_ITERATIONS; ++i)
+      {
+         double r1 = getSlantRangeFromGeoreferenced(c1) - slantRange;
+         if (r1 == r0)
+         {
+            return false;
+         }
+         double c2 = c1 - r1 * (c1 - c0) / (r1 - r0);
+         c0 = c1;
+         r0 = r1;
+         c1 = c2;
+         if (fabs(c1 - c0) < COL_EPSILON)
+         {
+            col = c1;
+            return true;
+         }
+      }
+      return false;
+   }
+
+   void ossimGeometricSarSensorModel::lineSampleHeightToWorldGrid(
+      const ossimDpt& origin,
+      const ossimDpt& spacing,
+      const ossimIpt& size,
+      const double&   heightEllipsoid,
+      ossimGpt*       worldPoints) const
+   {
+      if ( !worldPoints || (size.x <= 0) || (size.y <= 0) )
+      {
+         return;
+      }
+
+      const ossim_uint32 nCols = static_cast<ossim_uint32>(size.x);
+      const ossim_uint32 nRows = static_cast<ossim_uint32>(size.y);
+
+      if (!_sensor || !_platformPosition || !_refPoint)
+      {
+         for (ossim_uint32 i = 0; i < nCols * nRows; ++i)
+         {
+            worldPoints[i].makeNan();
+         }
+         return;
+      }
+
+      // Slant range only depends on the column.
+      std::vector<double> slantRange(nCols);
+      for (ossim_uint32 c = 0; c < nCols; ++c)
+      {
+         double x = origin.x + c * spacing.x;
+         double col = x - (x * _optimizationFactorX + _optimizationBiasX) ;
+         if (_isProductGeoreferenced)
+         {
+            slantRange[c] = getSlantRangeFromGeoreferenced(col) ;
+         }
+         else
+         {
+            slantRange[c] = getSlantRange(col) ;
+         }
+      }
+
+      double pos[3];
+      double speed[3];
+      double lon, lat;
+      ossimGpt* worldPoint = worldPoints;
+      for (ossim_uint32 r = 0; r < nRows; ++r)
+      {
+         // Azimuth time and orbit only depend on the line.
+         double y = origin.y + r * spacing.y;
+         double line = y - (y * _optimizationFactorY + _optimizationBiasY) ;
+         JSDDateTime azimuthTime = getTime(line) ;
+
+         if (!_platformPosition->Interpolate(azimuthTime, pos, speed))
+         {
+            for (ossim_uint32 c = 0; c < nCols; ++c, ++worldPoint)
+            {
+               worldPoint->makeNan();
+            }
+            continue;
+         }
+         GeographicEphemeris geoEph(azimuthTime, pos, speed);
+
+         for (ossim_uint32 c = 0; c < nCols; ++c, ++worldPoint)
+         {
+            SarSensor::ImageToWorld(*_sensor, geoEph, slantRange[c], heightEllipsoid, lon, lat);
+            worldPoint->lat = lat;
+            worldPoint->lon = lon;
+            worldPoint->hgt = heightEllipsoid ;
+         }
+      }
+   }
+
+   void ossimGeometricSarSensorModel::worldToLineSampleArray(
+      const ossimGpt* worldPoints,
+      ossimDpt*       imagePoints,
+      ossim_uint32    count) const
+   {
+      if ( !worldPoints || !imagePoints )
+      {
+         return;
+      }
+
+      // Warm start from the thread seed carries from one point to the next.
+      for (ossim_uint32 i = 0; i < count; ++i)
+      {
+         ossimGeometricSarSensorModel::worldToLineSample(worldPoints[i], imagePoints[i]);
+      }
+   }
+
+   bool ossimGeometricSarSensorModel::getCalibrationCoefficients(
+      ossimSarCalibration::Measure /* measure */,
+      bool                         /* removeNoise */,
+      double                       /* line */,
+      ossim_int32                  /* firstCol */,
+      std::vector<double>&         /* gain */,
+      std::vector<double>&         /* offset */) const
+   {
+      return false;
+   }
+
+   bool ossimGeometricSarSensorModel::isComplex() const
+   {
+      return false;
+   }
+
    void ossimGeometricSarSensorModel::clearGCPlist() {
       _optimizationGCPsGroundCoordinates.clear();
       _optimizationGCPsImageCoordinates.clear();
@@ -204,6 +503,7 @@ namespace ossimplugins
       _optimizationFactorY = 0.0 ;
       _optimizationBiasX = 0.0 ;
       _optimizationBiasY = 0.0 ;
+      resetProjectionCache();
 
       // appends the user input GCPs to the GCPs already present
       _optimizationGCPsGroundCoordinates.insert(_optimizationGCPsGroundCoordinates.end(), groundCoordinates.begin(), groundCoordinates.end()) ;
@@ -218,7 +518,7 @@ namespace ossimplugins
       while (itGround != _optimizationGCPsGroundCoordinates.end())
       {
          ossimDpt itLoc ;
-         this->worldToLineSample(*itGround,itLoc);
+         rigorousWorldToLineSample(*itGround,itLoc);
          inverseLocResults.push_back(itLoc) ;
          itGround++;
       }
@@ -289,6 +589,8 @@ namespace ossimplugins
       //_refPoint->set_pix_col(_refPoint->get_pix_col() - columnBias);
       //_refPoint->set_pix_line(_refPoint->get_pix_line() - lineBias);
 
+      resetProjectionCache();
+
       return true ;
    }
 
@@ -403,8 +705,6 @@ namespace ossimplugins
          result = false;
       }
 
-      _sarSensor = new SarSensor(_sensor, _platformPosition);
-
       // Load the ref point.
       if ( !_refPoint)
       {
@@ -527,6 +827,8 @@ namespace ossimplugins
 //          << "saveState result after loadState:"  << kwl2 << endl;
 //    }
 
+      resetProjectionCache();
+
       if (traceDebug())
       {
          ossimNotify(ossimNotifyLevel_DEBUG)
@@ -668,11 +970,20 @@ void ossimGeometricSarSensorModel::lineSampleToWorld(const ossimDpt& image_point
    int iters = 0;
 
    //
-   // Utilize iterative scheme for arriving at ground point. Begin with guess
-   // at RefGndPt:
+   // Utilize iterative scheme for arriving at ground point. Begin with the
+   // last solution on this thread, else RefGndPt:
    //
-   gpt.lond(theRefGndPt.lond());
-   gpt.latd(theRefGndPt.latd());
+   ossimSarProjectionSeed& seed = getProjectionSeed(this);
+   if (seed.hasGroundPoint)
+   {
+      gpt.lond(seed.groundPoint.lond());
+      gpt.latd(seed.groundPoint.latd());
+   }
+   else
+   {
+      gpt.lond(theRefGndPt.lond());
+      gpt.latd(theRefGndPt.latd());
+   }
    gpt.height(ossimElevManager::instance()->getHeightAboveEllipsoid(gpt));
 
    ossimGpt gpt_dlat;
@@ -745,6 +1056,12 @@ void ossimGeometricSarSensorModel::lineSampleToWorld(const ossimDpt& image_point
       iters++;
    } while ((!done) && (iters < MAX_NUM_ITERATIONS));
 
+   if (done)
+   {
+      seed.groundPoint = gpt;
+      seed.hasGroundPoint = true;
+   }
+
    if (traceDebug() || debug)
    {
       ossimNotify(ossimNotifyLevel_DEBUG) << "image_point = " << image_point << std::endl;
@@ -765,6 +1082,7 @@ void ossimGeometricSarSensorModel::set_platformPosition(PlatformPosition* platfo
       _platformPosition = 0;
    }
    _platformPosition = platformPosition->Clone();
+   resetProjectionCache();
 }
 
 void ossimGeometricSarSensorModel::set_sensorParams(SensorParams* sensorParams)
@@ -775,6 +1093,7 @@ void ossimGeometricSarSensorModel::set_sensorParams(SensorParams* sensorParams)
       _sensor = 0;
    }
    _sensor = sensorParams->Clone();
+   resetProjectionCache();
 }
 
 void ossimGeometricSarSensorModel::set_refPoint(RefPoint* refPoint)
@@ -785,6 +1104,7 @@ void ossimGeometricSarSensorModel::set_refPoint(RefPoint* refPoint)
       _refPoint = 0;
    }
    _refPoint = refPoint->Clone();
+   resetProjectionCache();
 }
 
 
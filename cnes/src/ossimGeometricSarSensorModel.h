@@ -15,6 +15,8 @@
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <ossim/projection/ossimSensorModel.h>
 #include <ossim/projection/ossimCoarseGridModel.h>
+#include <ossimProjectionGridCache.h>
+#include <ossimSarCalibration.h>
 
 #include <list>
 #include <vector>
@@ -25,7 +27,6 @@ namespace ossimplugins
 class PlatformPosition;
 class SensorParams;
 class RefPoint;
-class SarSensor;
 class JSDDateTime;
 
 /**
@@ -84,6 +85,98 @@ public:
                                         const double&   heightEllipsoid,
                                         ossimGpt&       worldPoint) const;
 
+   /**
+    * @brief Inverse of lineSampleHeightToWorld.
+    *
+    * Solves the Doppler equation for the azimuth time against the
+    * interpolated orbit (SarSensor::WorldToImage), then gets the column from
+    * the slant range at that time.  Starts from the previous solution on the
+    * calling thread.  Falls back to ossimSensorModel::worldToLineSample if
+    * the solution does not converge.
+    *
+    * @param world_point Coordinates of the world point
+    * @param image_point Coordinates of the image point (OUT)
+    */
+   virtual void worldToLineSample(const ossimGpt& world_point,
+                                  ossimDpt&       image_point) const;
+
+   /**
+    * @brief Inverse of getSlantRange or getSlantRangeFromGeoreferenced,
+    * depending on the product type.
+    * @param slantRange Slant range of the image point
+    * @param col Column coordinate, (IN) starting guess for georeferenced
+    * products, (OUT) result
+    * @return true on success, false if no column was found
+    */
+   virtual bool getColFromSlantRange(double slantRange, double& col) const;
+
+   /**
+    * @brief Projects a regular grid of image points, e.g. the interpolation
+    * grid of an ortho tile or a full line, at one height.
+    *
+    * Gives the same points as lineSampleHeightToWorld on each node, but the
+    * azimuth time and orbit interpolation are done once per grid row and
+    * the slant range once per grid column.
+    *
+    * @param origin Image point of the first node
+    * @param spacing Image distance between nodes in x and y
+    * @param size Number of nodes in x and y
+    * @param heightEllipsoid Altitude of the world points
+    * @param worldPoints size.x * size.y points, row major (OUT)
+    */
+   void lineSampleHeightToWorldGrid(const ossimDpt& origin,
+                                    const ossimDpt& spacing,
+                                    const ossimIpt& size,
+                                    const double&   heightEllipsoid,
+                                    ossimGpt*       worldPoints) const;
+
+   /**
+    * @brief worldToLineSample on an array of points.
+    *
+    * Each point starts from the solution of the one before, so points
+    * should come in image order, e.g. along a line or tile.
+    *
+    * @param worldPoints Coordinates of the world points
+    * @param imagePoints Coordinates of the image points (OUT)
+    * @param count Number of points
+    */
+   void worldToLineSampleArray(const ossimGpt* worldPoints,
+                               ossimDpt*       imagePoints,
+                               ossim_uint32    count) const;
+
+   /**
+    * @brief Radiometric calibration of one image line, see
+    * ossimSarCalibration.
+    *
+    * The calibrated value of pixel (firstCol + i, line) is
+    * gain[i] * |DN|^2 + offset[i], DN being the detected amplitude or the
+    * complex value of the pixel.
+    *
+    * @param measure Backscatter coefficient wanted.
+    * @param removeNoise If true offset also subtracts the noise floor.
+    * @param line Image line.
+    * @param firstCol Column of gain[0].
+    * @param gain Sized by the caller to the number of columns (OUT).
+    * @param offset Same size as gain (OUT).
+    * @return false if the product has no calibration for measure.  The
+    * default is false; each sensor implements its own.
+    */
+   virtual bool getCalibrationCoefficients(ossimSarCalibration::Measure measure,
+                                           bool removeNoise,
+                                           double line,
+                                           ossim_int32 firstCol,
+                                           std::vector<double>& gain,
+                                           std::vector<double>& offset) const;
+
+   /**
+    * @brief Tells if the product is single look complex, its pixels read as
+    * two bands holding I and Q.
+    *
+    * @return The default is false; each sensor with complex products
+    * implements its own from the product type.
+    */
+   virtual bool isComplex() const;
+
 
    /**
     * @brief This function optimizes the model according to a list of Ground
@@ -184,17 +277,38 @@ protected:
     */
    bool createReplacementOCG();
 
+   /**
+    * @brief lineSampleHeightToWorld without the projection cache.
+    */
+   void rigorousLineSampleHeightToWorld(const ossimDpt& image_point,
+                                        const double&   heightEllipsoid,
+                                        ossimGpt&       worldPoint) const;
+
+   /**
+    * @brief worldToLineSample without the projection cache.
+    */
+   void rigorousWorldToLineSample(const ossimGpt& world_point,
+                                  ossimDpt&       image_point) const;
+
+   /**
+    * @brief Projection cache, see ossimProjectionGridCache.
+    * @return The cache, or empty if not turned on by the ossim preferences
+    * keyword "projection_grid_cache.enabled: <bool>".
+    */
+   ossimProjectionGridCache::ConstPtr getProjectionCache() const;
+
+   /**
+    * @brief Drops the projection cache.  Must be called whenever the model
+    * parameters change.
+    */
+   void resetProjectionCache();
+
    /**
     * @brief Handle the position of the platform
     */
    PlatformPosition *_platformPosition;
    SensorParams * _sensor;
    RefPoint * _refPoint;
-   // Note that this is only mutable because of bad design of the
-   // classes, with a bunch of classes initializing the variables of
-   // the base class directly, the 3 variable above must be made
-   // private.
-   mutable SarSensor* _sarSensor;
 
    /**
     * @brief True iff the product is ground range
@@ -220,6 +334,8 @@ protected:
 
    ossimRefPtr<ossimCoarseGridModel> _replacementOcgModel;
 
+   ossimProjectionGridCache::Holder _projectionCache;
+
 private:
    /**
     * @brief Initializes the Platform Position from a projection keywordlist
@@ -0,0 +1,285 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Input stream over a memory mapped file.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimMappedFileStream.h>
+
+#if defined(_WIN32)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ossimplugins
+{
+
+//---
+// ossimMemoryStreamBuf
+//---
+
+ossimMemoryStreamBuf::ossimMemoryStreamBuf()
+   : std::streambuf()
+{
+   setBuffer(0, 0);
+}
+
+ossimMemoryStreamBuf::ossimMemoryStreamBuf(const char* data, std::size_t size)
+   : std::streambuf()
+{
+   setBuffer(data, size);
+}
+
+void ossimMemoryStreamBuf::setBuffer(const char* data, std::size_t size)
+{
+   // The get area is never written to.
+   char* begin = const_cast<char*>(data);
+   setg(begin, begin, begin + (data ? size : 0));
+}
+
+const char* ossimMemoryStreamBuf::take(std::size_t& size)
+{
+   const char* data = gptr();
+   const std::size_t available = egptr() - gptr();
+   if (size > available)
+   {
+      size = available;
+   }
+   setg(eback(), gptr() + size, egptr());
+   return data;
+}
+
+ossimMemoryStreamBuf::pos_type ossimMemoryStreamBuf::seekoff(
+   off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+   if ( !(which & std::ios_base::in) )
+   {
+      return pos_type(off_type(-1));
+   }
+
+   off_type base = 0;
+   if ( dir == std::ios_base::cur )
+   {
+      base = gptr() - eback();
+   }
+   else if ( dir == std::ios_base::end )
+   {
+      base = egptr() - eback();
+   }
+
+   const off_type pos = base + off;
+   if ( (pos < 0) || (pos > (egptr() - eback())) )
+   {
+      return pos_type(off_type(-1));
+   }
+   setg(eback(), eback() + pos, egptr());
+   return pos_type(pos);
+}
+
+ossimMemoryStreamBuf::pos_type ossimMemoryStreamBuf::seekpos(
+   pos_type pos, std::ios_base::openmode which)
+{
+   return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+std::streamsize ossimMemoryStreamBuf::showmanyc()
+{
+   const std::streamsize n = egptr() - gptr();
+   return n ? n : -1;
+}
+
+//---
+// ossimMappedFileStream
+//---
+
+ossimMappedFileStream::ossimMappedFileStream()
+   :
+   std::istream(0),
+   m_memoryBuf(),
+   m_fileBuf(),
+   m_data(0),
+   m_size(0),
+   m_isOpen(false)
+#if defined(_WIN32)
+   ,
+   m_fileHandle(0),
+   m_mapHandle(0)
+#endif
+{
+   setstate(std::ios_base::badbit);
+}
+
+ossimMappedFileStream::ossimMappedFileStream(const ossimFilename& file)
+   :
+   std::istream(0),
+   m_memoryBuf(),
+   m_fileBuf(),
+   m_data(0),
+   m_size(0),
+   m_isOpen(false)
+#if defined(_WIN32)
+   ,
+   m_fileHandle(0),
+   m_mapHandle(0)
+#endif
+{
+   open(file);
+}
+
+ossimMappedFileStream::~ossimMappedFileStream()
+{
+   close();
+}
+
+bool ossimMappedFileStream::open(const ossimFilename& file)
+{
+   close();
+
+   if ( map(file) )
+   {
+      m_memoryBuf.setBuffer(m_data, m_size);
+      rdbuf(&m_memoryBuf);
+      m_isOpen = true;
+   }
+   else if ( m_fileBuf.open(file.c_str(), std::ios_base::in | std::ios_base::binary) )
+   {
+      rdbuf(&m_fileBuf);
+      m_isOpen = true;
+   }
+   else
+   {
+      rdbuf(0);
+      setstate(std::ios_base::failbit);
+   }
+
+   return m_isOpen;
+}
+
+bool ossimMappedFileStream::is_open() const
+{
+   return m_isOpen;
+}
+
+bool ossimMappedFileStream::isMapped() const
+{
+   return m_isOpen && (rdbuf() == &m_memoryBuf);
+}
+
+void ossimMappedFileStream::close()
+{
+   if ( m_fileBuf.is_open() )
+   {
+      m_fileBuf.close();
+   }
+   m_memoryBuf.setBuffer(0, 0);
+   unmap();
+   rdbuf(0);
+   m_isOpen = false;
+}
+
+#if defined(_WIN32)
+
+bool ossimMappedFileStream::map(const ossimFilename& file)
+{
+   HANDLE fh = ::CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+   if ( fh == INVALID_HANDLE_VALUE )
+   {
+      return false;
+   }
+   LARGE_INTEGER size;
+   if ( !::GetFileSizeEx(fh, &size) || (size.QuadPart <= 0) ||
+        (static_cast<ossim_uint64>(size.QuadPart) >
+         static_cast<ossim_uint64>(static_cast<std::size_t>(-1))) )
+   {
+      ::CloseHandle(fh);
+      return false;
+   }
+   HANDLE mh = ::CreateFileMappingA(fh, 0, PAGE_READONLY, 0, 0, 0);
+   if ( !mh )
+   {
+      ::CloseHandle(fh);
+      return false;
+   }
+   const void* view = ::MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+   if ( !view )
+   {
+      ::CloseHandle(mh);
+      ::CloseHandle(fh);
+      return false;
+   }
+   m_fileHandle = fh;
+   m_mapHandle  = mh;
+   m_data = static_cast<const char*>(view);
+   m_size = static_cast<std::size_t>(size.QuadPart);
+   return true;
+}
+
+void ossimMappedFileStream::unmap()
+{
+   if ( m_data )
+   {
+      ::UnmapViewOfFile(m_data);
+      ::CloseHandle(static_cast<HANDLE>(m_mapHandle));
+      ::CloseHandle(static_cast<HANDLE>(m_fileHandle));
+      m_fileHandle = 0;
+      m_mapHandle  = 0;
+   }
+   m_data = 0;
+   m_size = 0;
+}
+
+#else
+
+bool ossimMappedFileStream::map(const ossimFilename& file)
+{
+   int fd = ::open(file.c_str(), O_RDONLY);
+   if ( fd < 0 )
+   {
+      return false;
+   }
+   struct stat st;
+   if ( (::fstat(fd, &st) != 0) || (st.st_size <= 0) ||
+        (static_cast<ossim_uint64>(st.st_size) >
+         static_cast<ossim_uint64>(static_cast<std::size_t>(-1))) )
+   {
+      ::close(fd);
+      return false;
+   }
+   const std::size_t size = static_cast<std::size_t>(st.st_size);
+   void* p = ::mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd); // The mapping keeps the file.
+   if ( p == MAP_FAILED )
+   {
+      return false;
+   }
+   m_data = static_cast<const char*>(p);
+   m_size = size;
+   return true;
+}
+
+void ossimMappedFileStream::unmap()
+{
+   if ( m_data )
+   {
+      ::munmap(const_cast<char*>(m_data), m_size);
+   }
+   m_data = 0;
+   m_size = 0;
+}
+
+#endif
+
+} // End: namespace ossimplugins
@@ -0,0 +1,99 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Input stream over a memory mapped file.
+//
+// The CEOS and ENVISAT record classes read their fixed width fields with
+// std::istream::read and seek from record to record.  On an std::ifstream
+// each read goes through the file buffer and each skipped record was read
+// into a heap buffer.  Here reads are copies out of the mapping and seeks
+// only move a pointer, so records that are not parsed are never touched.
+// The RadarSat records and the larger ERS, ALOS PALSAR and ENVISAT ones
+// go further and parse their fields from the mapping, see
+// ossimFixedWidthFieldReader.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimMappedFileStream_HEADER
+#define ossimMappedFileStream_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimFilename.h>
+
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <streambuf>
+
+namespace ossimplugins
+{
+   /**
+    * @brief Read only std::streambuf over a memory range, seekable, no copy.
+    * The range must outlive the buffer.
+    */
+   class OSSIM_PLUGINS_DLL ossimMemoryStreamBuf : public std::streambuf
+   {
+   public:
+      ossimMemoryStreamBuf();
+      ossimMemoryStreamBuf(const char* data, std::size_t size);
+
+      void setBuffer(const char* data, std::size_t size);
+
+      /**
+       * @brief Next bytes of the range in place, moving past them.
+       * @param size Bytes wanted, cut to the bytes left.
+       */
+      const char* take(std::size_t& size);
+
+   protected:
+      virtual pos_type seekoff(off_type off,
+                               std::ios_base::seekdir dir,
+                               std::ios_base::openmode which);
+      virtual pos_type seekpos(pos_type pos, std::ios_base::openmode which);
+      virtual std::streamsize showmanyc();
+   };
+
+   /**
+    * @brief std::istream on a read only mapping of a file.
+    *
+    * Drop in for the std::ifstream(file, ios::in|ios::binary) the models
+    * used.  Falls back to an std::filebuf when the file cannot be mapped,
+    * e.g. larger than the address space.
+    */
+   class OSSIM_PLUGINS_DLL ossimMappedFileStream : public std::istream
+   {
+   public:
+      ossimMappedFileStream();
+      explicit ossimMappedFileStream(const ossimFilename& file);
+      virtual ~ossimMappedFileStream();
+
+      /** @return true on success; sets failbit otherwise. */
+      bool open(const ossimFilename& file);
+      bool is_open() const;
+      void close();
+
+      /** @return true if reading from a mapping, false from the file buffer. */
+      bool isMapped() const;
+
+   private:
+      ossimMappedFileStream(const ossimMappedFileStream&);
+      ossimMappedFileStream& operator=(const ossimMappedFileStream&);
+
+      bool map(const ossimFilename& file);
+      void unmap();
+
+      ossimMemoryStreamBuf m_memoryBuf;
+      std::filebuf         m_fileBuf;
+      const char*          m_data;
+      std::size_t          m_size;
+      bool                 m_isOpen;
+#if defined(_WIN32)
+      void*                m_fileHandle;
+      void*                m_mapHandle;
+#endif
+   };
+}
+
+#endif /* #ifndef ossimMappedFileStream_HEADER */
@@ -24,6 +24,7 @@
 //*****************************************************************************
 
 #include <ossimPleiadesDimapSupportData.h>
+#include <ossimDimapXmlReader.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimNotify.h>
 #include <ossim/base/ossimKeywordNames.h>
@@ -51,6 +52,38 @@
 static ossimTrace traceExec  ("ossimPleiadesDimapSupportData:exec");
 static ossimTrace traceDebug ("ossimPleiadesDimapSupportData:debug");
 
+//---
+// Elements looked at by the parse methods, below the document root.  Anything
+// else (ephemeris and attitude lists, quality assessment...) is skipped when
+// reading the file, see ossimDimapXmlReader.  Must be kept in sync with the
+// xpaths used in this file.
+//---
+static const char* KEPT_XML_PATHS[] =
+{
+   "Metadata_Identification",
+   "Dataset_Content",
+   "Product_Information",
+   "Production",
+   "Product_Frame",
+   "Product_Characteristics",
+   "Image_Interpretation",
+   "Raster_Dimensions",
+   "Raster_Data",
+   "Processing_Information",
+   "Geoposition/Rational_Sensor_Model",
+   "Rational_Function_Model",
+   "Radiometric_Data/Radiometric_Calibration/Instrument_Calibration/Band_Measurement_List",
+   "Geometric_Data/Use_Area",
+   "Geometric_Data/Refined_Model/Time",
+   "Geometric_Data/Refined_Model/Geometric_Calibration/Instrument_Calibration/Swath_Range",
+   "Geometric_Data/Sensor_Model_Characteristics",
+   "Data_Strip/Data_Strip_Identification",
+   "Data_Strip/Geometric_Header_List",
+   "Data_Strip/UTC_Acquisition_Range",
+   "Dataset_Sources",
+   0
+};
+
 static std::string getVectorFloat64AsString(std::vector<ossim_float64> in)
 {
    std::vector<ossim_float64>::iterator it;
@@ -376,62 +409,23 @@ namespace ossimplugins
       if (allMetadataRead())
          clearFields();
 
-      //---
-      // Instantiate the file reading:
-      //---
-      ossim_int64 fileSize = file.fileSize();
-      std::ifstream in(file.c_str(), std::ios::binary|std::ios::in);
-      std::vector<char> fullBuffer;
-      ossimString bufferedIo;
-      if(in.good()&&(fileSize > 0))
-      {
-         char buf[100];
-         fullBuffer.resize(fileSize);
-         in.read(buf, std::min((ossim_int64)100, fileSize));
-         if(!in.fail())
-         {
-            ossimString testString = ossimString(buf,
-                                                 buf + in.gcount());
-            if(testString.contains("xml"))
-            {
-               in.seekg(0);
-               in.read(&fullBuffer.front(), (std::streamsize)fullBuffer.size());
-               if(!in.fail())
-               {
-                  bufferedIo = ossimString(fullBuffer.begin(),
-                                           fullBuffer.begin()+in.gcount());
-               }
-            }
-         }
-      }
-      else
+      if (file.fileSize() <= 0)
       {
          return false;
       }
+
       //---
-      // Instantiate the XML parser:
+      // Read the xml, keeping only the elements parsed below:
       //---
-      ossimRefPtr<ossimXmlDocument> xmlDocument;
-
-      if(bufferedIo.empty())
-      {
-         xmlDocument = new ossimXmlDocument(file);
-      }
-      else
-      {
-         xmlDocument = new ossimXmlDocument;
-         std::istringstream inStringStream(bufferedIo.string());
-         if(!xmlDocument->read(inStringStream))
-         {
-            return false;
-         }
-      }
-      if (xmlDocument->getErrorStatus())
+      ossimRefPtr<ossimXmlDocument> xmlDocument =
+         ossimDimapXmlReader::read(file, KEPT_XML_PATHS);
+      if (!xmlDocument.valid())
       {
          if(traceDebug())
          {
             ossimNotify(ossimNotifyLevel_FATAL)
-               << MODULE << " DEBUG:" << "ossimPleiadesDimapSupportData::parseXmlFile:"
+               << MODULE << " DEBUG:"
+               << "ossimPleiadesDimapSupportData::parseXmlFile:"
                << "\nUnable to parse xml file" << std::endl;
          }
          setErrorStatus();
@@ -164,6 +164,8 @@ namespace ossimplugins
          theSupportData = new ossimPleiadesDimapSupportData;
       }
 
+      theProjectionCache.reset();
+
       ossimString supportPrefix = ossimString(prefix) + "support_data.";
       theSupportData->loadState(kwl, supportPrefix);
 
@@ -180,6 +182,37 @@ namespace ossimplugins
       }
    }
 
+//*************************************************************************************************
+// Image to ground
+//*************************************************************************************************
+   void ossimPleiadesModel::lineSampleHeightToWorld(const ossimDpt& image_point,
+                                              const double&   heightEllipsoid,
+                                              ossimGpt&       worldPoint) const
+   {
+      // The RPC inverse is a direct polynomial evaluation, only the forward is cached.
+      ossimProjectionGridCache::ConstPtr cache = theProjectionCache.get(
+         theImageClipRect,
+         [this](const ossimDpt& ip, const double& h, ossimGpt& gp)
+         {
+            ossimRpcModel::lineSampleHeightToWorld(ip, h, gp);
+         },
+         ossimProjectionGridCache::InverseFunction());
+
+      if ( !cache || !cache->lineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint) )
+      {
+         ossimRpcModel::lineSampleHeightToWorld(image_point, heightEllipsoid, worldPoint);
+      }
+   }
+
+//*************************************************************************************************
+// Update model
+//*************************************************************************************************
+   void ossimPleiadesModel::updateModel()
+   {
+      theProjectionCache.reset();
+      ossimRpcModel::updateModel();
+   }
+
 
 
    bool
@@ -0,0 +1,484 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Cheap pre-check of the file formats handled by the plugin
+// factories.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimPluginFormatSniffer.h>
+#include <ossim/base/ossimDirectory.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/base/ossimNotifyContext.h>
+
+#include <cstdio>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// Static trace for debugging
+static ossimTrace traceDebug("ossimPluginFormatSniffer:debug");
+
+namespace
+{
+   /** Bytes read from the start of the file.  Covers the CEOS and ENVISAT
+    * headers and, in practice, the root element of the xml products. */
+   const std::size_t PREFIX_SIZE = 4096;
+
+   /** Bounds on the caches, emptied when reached. */
+   const std::size_t MAX_FAILED_ENTRIES = 100000;
+   const std::size_t MAX_DIRECTORIES    = 64;
+
+   /** @return true if buf holds s at pos. */
+   bool hasAt(const std::string& buf, std::string::size_type pos, const char* s)
+   {
+      const std::string::size_type n = std::strlen(s);
+      return (buf.size() >= pos + n) && (buf.compare(pos, n, s) == 0);
+   }
+
+   /**
+    * @return Name of the root element of the xml document starting in buf,
+    * or an empty string if buf ends before it.
+    */
+   std::string xmlRootName(const std::string& buf)
+   {
+      std::string::size_type pos = 0;
+      if ( hasAt(buf, 0, "\xEF\xBB\xBF") )
+      {
+         pos = 3;
+      }
+      while ( pos < buf.size() )
+      {
+         pos = buf.find('<', pos);
+         if ( pos == std::string::npos )
+         {
+            break;
+         }
+         const char* skipTo = 0;
+         if ( hasAt(buf, pos, "<?") )
+         {
+            skipTo = "?>";
+         }
+         else if ( hasAt(buf, pos, "<!--") )
+         {
+            skipTo = "-->";
+         }
+         else if ( hasAt(buf, pos, "<!") )
+         {
+            // DOCTYPE.  An internal subset may hold '>', give up on it.
+            std::string::size_type end = buf.find_first_of("[>", pos);
+            if ( (end == std::string::npos) || (buf[end] == '[') )
+            {
+               break;
+            }
+            pos = end + 1;
+            continue;
+         }
+         else
+         {
+            std::string::size_type end =
+               buf.find_first_of(" \t\r\n/>", pos + 1);
+            if ( end == std::string::npos )
+            {
+               break;
+            }
+            return buf.substr(pos + 1, end - pos - 1);
+         }
+         std::string::size_type end = buf.find(skipTo, pos);
+         if ( end == std::string::npos )
+         {
+            break;
+         }
+         pos = end + std::strlen(skipTo);
+      }
+      return std::string();
+   }
+
+   /** @return true if the xml root is name, or could not be found. */
+   bool xmlRootMayBe(const std::string& buf, const char* name)
+   {
+      const std::string root = xmlRootName(buf);
+      return root.empty() || (root == name);
+   }
+
+   std::string lowerName(const ossimString& s)
+   {
+      return ossimString::downcase(s).string();
+   }
+}
+
+namespace ossimplugins
+{
+
+ossimPluginFormatSniffer* ossimPluginFormatSniffer::instance()
+{
+   static ossimPluginFormatSniffer* sniffer = new ossimPluginFormatSniffer();
+   return sniffer;
+}
+
+ossimPluginFormatSniffer::ossimPluginFormatSniffer()
+   :
+   m_mutex(),
+   m_failed(),
+   m_directories()
+{
+}
+
+ossim_uint32 ossimPluginFormatSniffer::sniff(const ossimFilename& file,
+                                             ossim_uint32 formats)
+{
+   if ( file.empty() || !formats )
+   {
+      return 0;
+   }
+
+   ossimFilename dir = file.expand().path();
+   if ( dir.empty() )
+   {
+      dir = ".";
+   }
+
+   FileKey key;
+   bool isRegularFile = false;
+   const bool exists = getKey(file, dir, key, isRegularFile);
+
+   if ( exists )
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::map<std::string, FailedEntry>::iterator i =
+         m_failed.find(file.string());
+      if ( i != m_failed.end() )
+      {
+         if ( i->second.key == key )
+         {
+            formats &= ~(i->second.formats);
+         }
+         else
+         {
+            m_failed.erase(i);
+         }
+      }
+   }
+   if ( !formats )
+   {
+      return 0;
+   }
+
+   ossim_uint32 result = 0;
+
+   const ossimString ext      = ossimString::downcase(file.ext());
+   const ossimString baseName = ossimString::downcase(file.file());
+   const ossimString stem     = file.fileNoExtension();
+
+   //---
+   // Name only tests.
+   //---
+   if ( formats & TILE_MAP_MODEL )
+   {
+      if ( (file.beforePos(4) == "http") || (file.ext() == "otb") )
+      {
+         result |= TILE_MAP_MODEL;
+      }
+   }
+   if ( formats & RADARSAT_MODEL )
+   {
+      const std::string& s = file.string();
+      if ( (s.find("DAT_01") != std::string::npos) ||
+           (s.find("dat_01") != std::string::npos) ||
+           (s.find("VDF_DAT") != std::string::npos) ||
+           (s.find("vdf_dat") != std::string::npos) )
+      {
+         result |= RADARSAT_MODEL;
+      }
+   }
+   if ( (formats & FORMOSAT_MODEL) &&
+        ( (baseName == "icon.jpg") || (baseName == "preview.jpg") ) )
+   {
+      // Ancillary files of a Formosat product, never given a projection.
+      formats &= ~FORMOSAT_MODEL;
+   }
+   if ( (formats & FORMOSAT_MODEL) && !exists )
+   {
+      // Sidecars may be next to a missing file; no directory key to cache on.
+      ossimFilename test = file;
+      test.setExtension("geom");
+      if ( test.exists() ||
+           file.path().dirCat(ossimFilename("METADATA.DIM")).exists() ||
+           file.path().dirCat(ossimFilename("metadata.dim")).exists() )
+      {
+         result |= FORMOSAT_MODEL;
+      }
+   }
+
+   if ( !exists )
+   {
+      return result;
+   }
+
+   //---
+   // Content tests, on one read of the start of the file.
+   //---
+   const ossim_uint32 CONTENT_FORMATS = RADARSAT2_MODEL | TERRASAR_MODEL |
+      ERSSAR_MODEL | ENVISAT_ASAR_MODEL | ALOS_PALSAR_MODEL | ALL_READERS;
+   std::string prefix;
+   if ( isRegularFile && (formats & CONTENT_FORMATS) )
+   {
+      std::FILE* fp = std::fopen(file.c_str(), "rb");
+      if ( fp )
+      {
+         prefix.resize(PREFIX_SIZE);
+         prefix.resize(std::fread(&prefix[0], 1, PREFIX_SIZE, fp));
+         std::fclose(fp);
+      }
+   }
+
+   if ( isRegularFile && (ext == "xml") && !prefix.empty() )
+   {
+      if ( xmlRootMayBe(prefix, "product") )
+      {
+         result |= formats & (RADARSAT2_MODEL | RADARSAT2_READER);
+      }
+      if ( xmlRootMayBe(prefix, "level1Product") )
+      {
+         result |= formats & (TERRASAR_MODEL | TERRASAR_READER);
+      }
+   }
+
+   // CEOS leader: file descriptor name at byte 48.
+   bool ersLeader  = hasAt(prefix, 48, "ERS") && hasAt(prefix, 52, ".SAR.") &&
+      hasAt(prefix, 60, "LEAD");
+   bool alosLeader = hasAt(prefix, 48, "AL1 ") && hasAt(prefix, 52, "PSR") &&
+      hasAt(prefix, 56, "SARL");
+
+   if ( (formats & ENVISAT_ASAR_MODEL) && hasAt(prefix, 0, "PRODUCT=") )
+   {
+      result |= ENVISAT_ASAR_MODEL;
+   }
+
+   //---
+   // Neighbour tests, on one listing of the directory.
+   //---
+   const ossim_uint32 NEIGHBOUR_FORMATS = RADARSAT2_MODEL | PLEIADES_MODEL |
+      ERSSAR_MODEL | ALOS_PALSAR_MODEL | FORMOSAT_MODEL | SPOT6_MODEL;
+   const ossim_uint32 left = formats & ~result;
+   if ( left & NEIGHBOUR_FORMATS )
+   {
+      const std::string extSuffix = file.ext().empty() ? std::string() :
+         std::string(".") + ext.string();
+
+      // Names the models derive, computed before taking the lock.
+      std::string ersLeaderName;
+      if ( (stem == "DAT_01") || (stem == "NUL_DAT") || (stem == "LEA_01") )
+      {
+         ersLeaderName = std::string("lea_01") + extSuffix;
+      }
+      std::string alosLeaderName;
+      const ossimString alosPrefix = stem.substr(0, 3);
+      if ( (alosPrefix == "IMG") || (alosPrefix == "TRL") || (alosPrefix == "VOL") )
+      {
+         alosLeaderName = lowerName(ossimString("LED") + stem.substr(3)) +
+            extSuffix;
+      }
+      const std::string geomName = lowerName(stem) + ".geom";
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const DirectoryEntry* entry = getDirectory(dir, key.dirTime);
+      if ( !entry )
+      {
+         // Cannot tell, leave it to the models.
+         return result | left;
+      }
+      const std::set<std::string>* names = &(entry->names);
+
+      //---
+      // Pleiades and Spot6 derive the DIMAP name with regular expressions,
+      // only worth it when there is some xml file to find.
+      //---
+      std::string dimName;
+      std::string spot6DimName;
+      if ( entry->hasXml && (left & (PLEIADES_MODEL | SPOT6_MODEL)) &&
+           ( (ext == "jp2") || (ext == "tif") ) )
+      {
+         if ( left & PLEIADES_MODEL )
+         {
+            ossimFilename tmp = file.file().replaceStrThatMatch("^IMG_", "DIM_");
+            tmp = tmp.replaceStrThatMatch("_R[0-9]+C[0-9]", "");
+            tmp.setExtension("XML");
+            dimName = lowerName(tmp);
+         }
+         if ( left & SPOT6_MODEL )
+         {
+            ossimFilename tmp = file.file().replaceStrThatMatch("^IMG_", "DIM_");
+            tmp = tmp.replaceStrThatMatch("_R[0-9]+C[0-9]+\\.(JP2|TIF)$", ".XML");
+            if ( tmp.ext() == "XML" )
+            {
+               spot6DimName = lowerName(tmp);
+            }
+         }
+      }
+
+      if ( (left & RADARSAT2_MODEL) && isRegularFile && (ext != "xml") &&
+           names->count("product.xml") )
+      {
+         result |= RADARSAT2_MODEL;
+      }
+      if ( (left & PLEIADES_MODEL) && !dimName.empty() &&
+           ( names->count("phrdimap.xml") || names->count(dimName) ) )
+      {
+         result |= PLEIADES_MODEL;
+      }
+      if ( (left & SPOT6_MODEL) && !spot6DimName.empty() &&
+           names->count(spot6DimName) )
+      {
+         result |= SPOT6_MODEL;
+      }
+      if ( (left & ERSSAR_MODEL) &&
+           ( ersLeader ||
+             ( !ersLeaderName.empty() && names->count(ersLeaderName) ) ) )
+      {
+         result |= ERSSAR_MODEL;
+      }
+      if ( (left & ALOS_PALSAR_MODEL) &&
+           ( alosLeader ||
+             ( !alosLeaderName.empty() && names->count(alosLeaderName) ) ) )
+      {
+         result |= ALOS_PALSAR_MODEL;
+      }
+      if ( (left & FORMOSAT_MODEL) &&
+           ( names->count(geomName) || names->count("metadata.dim") ) )
+      {
+         result |= FORMOSAT_MODEL;
+      }
+   }
+
+   if ( traceDebug() )
+   {
+      ossimNotify(ossimNotifyLevel_DEBUG)
+         << "ossimPluginFormatSniffer::sniff DEBUG: " << file
+         << " formats: " << std::hex << result << std::dec << "\n";
+   }
+
+   if ( !result )
+   {
+      addFailed(file.string(), key, formats);
+   }
+
+   return result;
+}
+
+void ossimPluginFormatSniffer::addFailed(const std::string& path,
+                                         const FileKey& key,
+                                         ossim_uint32 formats)
+{
+   //---
+   // Times are in seconds.  A change later in the same second would not
+   // show, so files and directories changed just now are not recorded.
+   //---
+   const std::time_t now = std::time(0);
+   if ( (key.fileTime >= now - 1) || (key.dirTime >= now - 1) )
+   {
+      return;
+   }
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if ( m_failed.size() >= MAX_FAILED_ENTRIES )
+   {
+      m_failed.clear();
+   }
+   FailedEntry& entry = m_failed[path];
+   if ( entry.key == key )
+   {
+      entry.formats |= formats;
+   }
+   else
+   {
+      entry.key = key;
+      entry.formats = formats;
+   }
+}
+
+bool ossimPluginFormatSniffer::getKey(const ossimFilename& file,
+                                      const ossimFilename& dir,
+                                      FileKey& key,
+                                      bool& isRegularFile)
+{
+   struct stat fileStat;
+   struct stat dirStat;
+   if ( (stat(file.c_str(), &fileStat) != 0) ||
+        (stat(dir.c_str(), &dirStat) != 0) )
+   {
+      return false;
+   }
+   key.size     = static_cast<ossim_int64>(fileStat.st_size);
+   key.fileTime = fileStat.st_mtime;
+   key.dirTime  = dirStat.st_mtime;
+   isRegularFile = ((fileStat.st_mode & S_IFMT) == S_IFREG);
+   return true;
+}
+
+const ossimPluginFormatSniffer::DirectoryEntry*
+ossimPluginFormatSniffer::getDirectory(const ossimFilename& dir,
+                                       std::time_t dirTime)
+{
+   std::map<std::string, DirectoryEntry>::iterator i =
+      m_directories.find(dir.string());
+
+   //---
+   // A listing taken in the same second as the last change of the directory
+   // may miss part of that change, list again in that case.
+   //---
+   if ( (i != m_directories.end()) && (i->second.dirTime == dirTime) &&
+        (dirTime < i->second.listTime) )
+   {
+      return i->second.listed ? &(i->second) : 0;
+   }
+
+   if ( i == m_directories.end() )
+   {
+      if ( m_directories.size() >= MAX_DIRECTORIES )
+      {
+         m_directories.clear();
+      }
+      i = m_directories.insert(
+         std::make_pair(dir.string(), DirectoryEntry())).first;
+   }
+
+   DirectoryEntry& entry = i->second;
+   entry.dirTime  = dirTime;
+   entry.listTime = std::time(0);
+   entry.listed   = false;
+   entry.hasXml   = false;
+   entry.names.clear();
+
+   //---
+   // Names are lower cased: the models test with exists(), which ignores
+   // case on some file systems, so the sniffer has to as well.
+   //---
+   ossimDirectory directory(dir);
+   if ( directory.isOpened() )
+   {
+      entry.listed = true;
+      ossimFilename f;
+      bool more = directory.getFirst(f, ossimDirectory::OSSIM_DIR_DEFAULT);
+      while ( more )
+      {
+         const std::string name = lowerName(f.file());
+         if ( (name.size() >= 4) &&
+              (name.compare(name.size() - 4, 4, ".xml") == 0) )
+         {
+            entry.hasXml = true;
+         }
+         entry.names.insert(name);
+         more = directory.getNext(f);
+      }
+   }
+
+   return entry.listed ? &entry : 0;
+}
+
+} // End: namespace ossimplugins
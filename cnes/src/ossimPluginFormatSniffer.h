@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Cheap pre-check of the file formats handled by the plugin
+// factories.
+//
+// The factories used to construct and open every model in turn on each
+// file handed to them, which for an ordinary image means a dozen stats and
+// several opens and reads of the same header.  The sniffer reads one small
+// prefix of the file, looks the directory up once, and tells the factories
+// which of their formats can possibly accept the file.  Files the tests
+// rule out for every format are remembered until they or their directory
+// change.  Files a model failed to open are not: the model may have read a
+// neighbouring file, which can be edited without changing either.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPluginFormatSniffer_HEADER
+#define ossimPluginFormatSniffer_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimFilename.h>
+
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace ossimplugins
+{
+   class OSSIM_PLUGINS_DLL ossimPluginFormatSniffer
+   {
+   public:
+
+      /** Formats handled by ossimPluginProjectionFactory and
+       * ossimPluginReaderFactory. */
+      enum Format
+      {
+         RADARSAT2_MODEL    = 0x0001,
+         PLEIADES_MODEL     = 0x0002,
+         TERRASAR_MODEL     = 0x0004,
+         ERSSAR_MODEL       = 0x0008,
+         ENVISAT_ASAR_MODEL = 0x0010,
+         RADARSAT_MODEL     = 0x0020,
+         ALOS_PALSAR_MODEL  = 0x0040,
+         FORMOSAT_MODEL     = 0x0080,
+         TILE_MAP_MODEL     = 0x0100,
+         SPOT6_MODEL        = 0x0200,
+         ALL_MODELS         = 0x03ff,
+         RADARSAT2_READER   = 0x0400,
+         TERRASAR_READER    = 0x0800,
+         ALL_READERS        = 0x0c00
+      };
+
+      static ossimPluginFormatSniffer* instance();
+
+      /**
+       * @brief Finds the formats that may open file.
+       *
+       * Never drops a format whose open would have succeeded: each test is
+       * the cheap part of the corresponding open, on names and on the first
+       * bytes of the file, and errs on the side of keeping the format.
+       *
+       * @param file File handed to the factory.
+       * @param formats Mask of the Format values to test.
+       * @return Subset of formats left after the tests, 0 if none.
+       */
+      ossim_uint32 sniff(const ossimFilename& file, ossim_uint32 formats);
+
+   private:
+
+      /** Size and modification times of a file and of its directory. */
+      struct FileKey
+      {
+         ossim_int64 size;
+         std::time_t fileTime;
+         std::time_t dirTime;
+
+         bool operator==(const FileKey& rhs) const
+         {
+            return (size == rhs.size) && (fileTime == rhs.fileTime) &&
+               (dirTime == rhs.dirTime);
+         }
+      };
+
+      struct FailedEntry
+      {
+         FileKey key;
+         ossim_uint32 formats;
+      };
+
+      /** Lower cased entry names of a directory. */
+      struct DirectoryEntry
+      {
+         std::time_t dirTime;
+         std::time_t listTime;
+         bool listed;
+         bool hasXml;
+         std::set<std::string> names;
+      };
+
+      ossimPluginFormatSniffer();
+      ossimPluginFormatSniffer(const ossimPluginFormatSniffer&);
+      ossimPluginFormatSniffer& operator=(const ossimPluginFormatSniffer&);
+
+      /** @return false if file or its directory cannot be stat'ed. */
+      static bool getKey(const ossimFilename& file,
+                         const ossimFilename& dir,
+                         FileKey& key,
+                         bool& isRegularFile);
+
+      /**
+       * Records that the tests ruled out formats for path, so that later
+       * sniff calls drop them without looking at the file.  Forgotten as
+       * soon as the size or modification time of the file or of its
+       * directory changes, the only inputs of the tests.
+       */
+      void addFailed(const std::string& path,
+                     const FileKey& key,
+                     ossim_uint32 formats);
+
+      /**
+       * Lower cased names in dir, listed again only when the directory
+       * changes.  Caller holds m_mutex.
+       * @return The entry, or 0 if the directory cannot be listed.
+       */
+      const DirectoryEntry* getDirectory(const ossimFilename& dir,
+                                         std::time_t dirTime);
+
+      std::mutex m_mutex;
+      std::map<std::string, FailedEntry> m_failed;
+      std::map<std::string, DirectoryEntry> m_directories;
+   };
+}
+
+#endif /* #ifndef ossimPluginFormatSniffer_HEADER */
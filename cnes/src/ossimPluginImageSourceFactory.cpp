@@ -0,0 +1,98 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Image source (filter) factory for ossim plugins plugin.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimPluginImageSourceFactory.h>
+#include <ossimSarCalibrationFilter.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimRefPtr.h>
+#include <ossim/base/ossimString.h>
+#include <ossim/base/ossimTrace.h>
+
+namespace ossimplugins
+{
+   static const ossimTrace traceDebug("ossimPluginImageSourceFactory:debug");
+
+   RTTI_DEF1(ossimPluginImageSourceFactory,
+             "ossimPluginImageSourceFactory",
+             ossimImageSourceFactoryBase);
+
+   ossimPluginImageSourceFactory* ossimPluginImageSourceFactory::theInstance = 0;
+
+   ossimPluginImageSourceFactory::~ossimPluginImageSourceFactory()
+   {
+      theInstance = 0;
+   }
+
+   ossimPluginImageSourceFactory* ossimPluginImageSourceFactory::instance()
+   {
+      if(!theInstance)
+      {
+         theInstance = new ossimPluginImageSourceFactory;
+      }
+      return theInstance;
+   }
+
+   ossimObject* ossimPluginImageSourceFactory::createObject(
+      const ossimString& typeName)const
+   {
+      ossimRefPtr<ossimObject> result = 0;
+      if(typeName == "ossimSarCalibrationFilter")
+      {
+         result = new ossimSarCalibrationFilter;
+      }
+
+      return result.release();
+   }
+
+   ossimObject* ossimPluginImageSourceFactory::createObject(
+      const ossimKeywordlist& kwl, const char* prefix)const
+   {
+      ossimRefPtr<ossimObject> result = 0;
+
+      const char* lookup = kwl.find(prefix, ossimKeywordNames::TYPE_KW);
+      if(lookup)
+      {
+         result = createObject(ossimString(lookup));
+         if(result.valid())
+         {
+            if(result->loadState(kwl, prefix) == false)
+            {
+               result = 0;
+            }
+         }
+      }
+
+      if(traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimPluginImageSourceFactory::createObject(kwl, prefix) DEBUG:"
+            << " type: " << (lookup ? lookup : "not found")
+            << " result: " << (result.valid() ? "created" : "none")
+            << std::endl;
+      }
+
+      return result.release();
+   }
+
+   void ossimPluginImageSourceFactory::getTypeNameList(
+      std::vector<ossimString>& typeList)const
+   {
+      typeList.push_back(ossimString("ossimSarCalibrationFilter"));
+   }
+
+   ossimPluginImageSourceFactory::ossimPluginImageSourceFactory(){}
+
+   ossimPluginImageSourceFactory::ossimPluginImageSourceFactory(const ossimPluginImageSourceFactory&){}
+
+   void ossimPluginImageSourceFactory::operator=(const ossimPluginImageSourceFactory&){}
+}
@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Image source (filter) factory for ossim plugins plugin.
+//----------------------------------------------------------------------------
+// $Id$
+#ifndef ossimPluginImageSourceFactory_HEADER
+#define ossimPluginImageSourceFactory_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/imaging/ossimImageSourceFactoryBase.h>
+
+class ossimString;
+class ossimKeywordlist;
+
+namespace ossimplugins
+{
+   /** @brief Image source factory for ossim plugins plugin. */
+   class OSSIM_PLUGINS_DLL ossimPluginImageSourceFactory : public ossimImageSourceFactoryBase
+   {
+   public:
+
+      /** @brief virtual destructor */
+      virtual ~ossimPluginImageSourceFactory();
+
+      /**
+       * @brief static method to return instance (the only one) of this class.
+       * @return pointer to instance of this class.
+       */
+      static ossimPluginImageSourceFactory* instance();
+
+      /**
+       * @brief createObject that takes a class name.
+       * @param typeName The name of the class.
+       * @return pointer to image source on success, 0 on failure.
+       */
+      virtual ossimObject* createObject(const ossimString& typeName)const;
+
+      /**
+       * @brief Creates and object given a keyword list and prefix.
+       * @param kwl The keyword list.
+       * @param prefix the keyword list prefix.
+       * @return pointer to image source on success, 0 on failure.
+       */
+      virtual ossimObject* createObject(const ossimKeywordlist& kwl,
+                                        const char* prefix=0)const;
+
+      /**
+       * @brief Adds ossimSarCalibrationFilter to the typeList.
+       * @param typeList List to add to.
+       */
+      virtual void getTypeNameList(std::vector<ossimString>& typeList)const;
+
+   protected:
+      /** @brief hidden from use default constructor */
+      ossimPluginImageSourceFactory();
+
+      /** @brief hidden from use copy constructor */
+      ossimPluginImageSourceFactory(const ossimPluginImageSourceFactory&);
+
+      /** @brief hidden from use copy constructor */
+      void operator=(const ossimPluginImageSourceFactory&);
+
+      /** static instance of this class */
+      static ossimPluginImageSourceFactory* theInstance;
+
+   TYPE_DATA
+   };
+}
+
+#endif /* #ifndef ossimPluginImageSourceFactory_HEADER */
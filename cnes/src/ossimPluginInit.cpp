@@ -11,9 +11,11 @@
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <ossim/base/ossimObjectFactoryRegistry.h>
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
+#include <ossim/imaging/ossimImageSourceFactoryRegistry.h>
 #include <ossim/projection/ossimProjectionFactoryRegistry.h>
 #include <ossimPluginProjectionFactory.h>
 #include <ossimPluginReaderFactory.h>
+#include <ossimPluginImageSourceFactory.h>
 
 
 namespace ossimplugins
@@ -79,9 +81,14 @@ namespace ossimplugins
          ossimProjectionFactoryRegistry::instance()->
             registerFactoryToFront(ossimPluginProjectionFactory::instance());
 
+         /** Register the filters... */
+         ossimImageSourceFactoryRegistry::instance()->
+            registerFactory(ossimPluginImageSourceFactory::instance());
+
          setCnesDescription(cnesDescription);
          ossimPluginReaderFactory::instance()->getTypeNameList(cnesObjList);
          ossimPluginProjectionFactory::instance()->getTypeNameList(cnesObjList);
+         ossimPluginImageSourceFactory::instance()->getTypeNameList(cnesObjList);
       }
 
       /* Note symbols need to be exported on windoze... */
@@ -92,6 +99,9 @@ namespace ossimplugins
 
          ossimProjectionFactoryRegistry::instance()->
             unregisterFactory(ossimPluginProjectionFactory::instance());
+
+         ossimImageSourceFactoryRegistry::instance()->
+            unregisterFactory(ossimPluginImageSourceFactory::instance());
       }
 
    }
@@ -30,6 +30,7 @@
 #include <ossim/base/ossimNotifyContext.h>
 #include "ossimTileMapModel.h"
 #include "ossimSpot6Model.h"
+#include "ossimPluginFormatSniffer.h"
 
 //***
 // Define Trace flags for use within this file:
@@ -61,13 +62,27 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
    ossimRefPtr<ossimProjection> projection = 0;
    //traceDebug.setTraceFlag(true);
 
+   //---
+   // Only try the models that can accept the file.  The sniffer looks at
+   // the file name, the start of the file and the directory once, instead
+   // of each model stat'ing and reading the same things again.
+   //---
+   ossimPluginFormatSniffer* sniffer = ossimPluginFormatSniffer::instance();
+   const ossim_uint32 candidates =
+      sniffer->sniff(filename, ossimPluginFormatSniffer::ALL_MODELS);
+   if ( !candidates )
+   {
+      return 0;
+   }
+
    if(traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
          << MODULE << " DEBUG: testing ossimRadarSat2Model" << std::endl;
    }
 
-   if ( !projection )
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::RADARSAT2_MODEL) )
    {
       ossimRefPtr<ossimRadarSat2Model> model = new ossimRadarSat2Model();
       if ( model->open(filename) )
@@ -92,7 +107,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
    }
 
    // Pleiades
-   if ( !projection )
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::PLEIADES_MODEL) )
    {
       ossimRefPtr<ossimPleiadesModel> model = new ossimPleiadesModel();
       if ( model->open(filename) )
@@ -111,7 +127,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimTerraSarModel" << std::endl;
    }
 
-   if ( !projection )
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::TERRASAR_MODEL) )
    {
       ossimRefPtr<ossimTerraSarModel> model = new ossimTerraSarModel();
 
@@ -136,7 +153,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimErsSarModel" << std::endl;
    }
 
-   if ( !projection )
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::ERSSAR_MODEL) )
    {
       ossimRefPtr<ossimErsSarModel> model = new ossimErsSarModel();
       if ( model->open(filename) )
@@ -155,7 +173,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimEnvisatSarModel" << std::endl;
    }
 
-   if (!projection)
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::ENVISAT_ASAR_MODEL) )
    {
       ossimRefPtr<ossimEnvisatAsarModel> model = new ossimEnvisatAsarModel();
       if (model->open(filename))
@@ -174,7 +193,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimRadarSatModel" << std::endl;
    }
 
-   if (!projection)
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::RADARSAT_MODEL) )
    {
       ossimRefPtr<ossimRadarSatModel> model = new ossimRadarSatModel();
       if (model->open(filename))
@@ -193,7 +213,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimAlosPalsarModel" << std::endl;
    }
 
-   if (!projection)
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::ALOS_PALSAR_MODEL) )
    {
       ossimRefPtr<ossimAlosPalsarModel> model = new ossimAlosPalsarModel();
       if (model->open(filename))
@@ -212,40 +233,44 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimFormosatModel" << std::endl;
    }
    
-   ossimFilename formosatTest = filename;
-   formosatTest = formosatTest.setExtension("geom");
-   if(!formosatTest.exists())
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::FORMOSAT_MODEL) )
    {
-      formosatTest = filename.path();
-      formosatTest = formosatTest.dirCat(ossimFilename("METADATA.DIM"));
-      if (formosatTest.exists() == false)
+      ossimFilename formosatTest = filename;
+      formosatTest = formosatTest.setExtension("geom");
+      if(!formosatTest.exists())
       {
          formosatTest = filename.path();
-         formosatTest = formosatTest.dirCat(ossimFilename("metadata.dim"));
+         formosatTest = formosatTest.dirCat(ossimFilename("METADATA.DIM"));
+         if (formosatTest.exists() == false)
+         {
+            formosatTest = filename.path();
+            formosatTest = formosatTest.dirCat(ossimFilename("metadata.dim"));
+         }
       }
-   }
-   if(formosatTest.exists())
-   {
-      //---
-      // Check the basename of the input file. So we don't create a projection
-      // for ancillary files, icon.jpg amd preview.jpg.
-      //---
-      ossimFilename baseName = filename.file();
-      baseName.downcase();
-      
-      if ( (baseName != "icon.jpg" ) && ( baseName != "preview.jpg" ) )
+      if(formosatTest.exists())
       {
-         ossimRefPtr<ossimFormosatDimapSupportData> meta =
-            new ossimFormosatDimapSupportData;
-         if(meta->loadXmlFile(formosatTest))
+         //---
+         // Check the basename of the input file. So we don't create a projection
+         // for ancillary files, icon.jpg amd preview.jpg.
+         //---
+         ossimFilename baseName = filename.file();
+         baseName.downcase();
+      
+         if ( (baseName != "icon.jpg" ) && ( baseName != "preview.jpg" ) )
          {
-            ossimRefPtr<ossimFormosatModel> model = new ossimFormosatModel(meta.get());
-            if(!model->getErrorStatus())
+            ossimRefPtr<ossimFormosatDimapSupportData> meta =
+               new ossimFormosatDimapSupportData;
+            if(meta->loadXmlFile(formosatTest))
             {
-               projection = model.get();
+               ossimRefPtr<ossimFormosatModel> model = new ossimFormosatModel(meta.get());
+               if(!model->getErrorStatus())
+               {
+                  projection = model.get();
                
+               }
+               model = 0;
             }
-            model = 0;
          }
       }
    }
@@ -256,7 +281,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
          << MODULE << " DEBUG: testing ossimTileMapModel" << std::endl;
    }
 
-   if (!projection)
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::TILE_MAP_MODEL) )
    {
       ossimRefPtr<ossimTileMapModel> model = new ossimTileMapModel();
       if (model->open(filename))
@@ -276,7 +302,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
    }
 
    // Spot6
-   if ( !projection )
+   if ( !projection &&
+        (candidates & ossimPluginFormatSniffer::SPOT6_MODEL) )
    {
       ossimRefPtr<ossimSpot6Model> model = new ossimSpot6Model();
       if ( model->open(filename) )
@@ -291,6 +318,8 @@ ossimProjection* ossimPluginProjectionFactory::createProjection(
 
    //***
    // ADD_MODEL: (Please leave this comment for the next programmer)
+   // Also give the model a Format bit and a test in ossimPluginFormatSniffer,
+   // or it will never be tried.
    //***
    //if(traceDebug())
    //{
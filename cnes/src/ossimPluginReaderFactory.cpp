@@ -14,6 +14,7 @@
 #include <ossimPluginReaderFactory.h>
 #include <ossimRadarSat2TiffReader.h>
 #include <ossimTerraSarTiffReader.h>
+#include <ossimPluginFormatSniffer.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimRefPtr.h>
 #include <ossim/base/ossimString.h>
@@ -58,14 +59,24 @@ namespace ossimplugins
             << std::endl;
       }
 
-      ossimRefPtr<ossimImageHandler> reader = new ossimRadarSat2TiffReader();
-      reader->setOpenOverviewFlag(openOverview);
-      if(reader->open(fileName) == false)
+      // Both readers only take the product xml; skip everything else.
+      ossimPluginFormatSniffer* sniffer = ossimPluginFormatSniffer::instance();
+      const ossim_uint32 candidates =
+         sniffer->sniff(fileName, ossimPluginFormatSniffer::ALL_READERS);
+
+      ossimRefPtr<ossimImageHandler> reader = 0;
+      if ( candidates & ossimPluginFormatSniffer::RADARSAT2_READER )
       {
-         reader = 0;
+         reader = new ossimRadarSat2TiffReader();
+         reader->setOpenOverviewFlag(openOverview);
+         if(reader->open(fileName) == false)
+         {
+            reader = 0;
+         }
       }
 
-      if ( !reader.valid() )
+      if ( !reader.valid() &&
+           (candidates & ossimPluginFormatSniffer::TERRASAR_READER) )
       {
          if(traceDebug())
          {
@@ -0,0 +1,592 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: In memory approximation of an expensive sensor model.
+//
+//----------------------------------------------------------------------------
+
+#include <ossimProjectionGridCache.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimDatumFactory.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimString.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ossimplugins
+{
+   const char* ossimProjectionGridCache::ENABLED_PREF_KW   = "projection_grid_cache.enabled";
+   const char* ossimProjectionGridCache::TOLERANCE_PREF_KW = "projection_grid_cache.tolerance";
+
+   // Image size of the root cells.  Leaves are ROOT_CELL_PIXELS / 2^MAX_DEPTH.
+   static const double ROOT_CELL_PIXELS = 512.0;
+   static const int    MAX_DEPTH        = 5;
+
+   // Heights covered, ellipsoid meters.  Linear between levels.
+   static const double HEIGHT_MIN    = -500.0;
+   static const double HEIGHT_STEP   = 500.0;
+   static const int    HEIGHT_LEVELS = 20;
+
+   // Same as the replacement ossimCoarseGridModel of the SAR models.
+   static const double DEFAULT_TOLERANCE = 0.1; // pixels
+
+   static const double DEG_TO_METERS = 6378137.0 * M_PI / 180.0;
+
+   // Test points of a cell, as fractions of its size: centre, edge midpoints.
+   static const double TEST_POINTS[5][2] =
+   {
+      { 0.5, 0.5 }, { 0.5, 0.0 }, { 1.0, 0.5 }, { 0.5, 1.0 }, { 0.0, 0.5 }
+   };
+
+   //---
+   // Set while this thread builds a cell.  The rigorous model may come back
+   // into the cache (e.g. an iterative inverse using the forward), so any
+   // cell that would need building then is left to the rigorous model.
+   //---
+   static thread_local bool buildingCell = false;
+
+   struct ossimBuildingCellGuard
+   {
+      ossimBuildingCellGuard()  { buildingCell = true; }
+      ~ossimBuildingCellGuard() { buildingCell = false; }
+   };
+
+   /** @return lon shifted by 360 to be within 180 of ref. */
+   static double unwrapLongitude(double lon, double ref)
+   {
+      while ( (lon - ref) > 180.0 )
+      {
+         lon -= 360.0;
+      }
+      while ( (lon - ref) < -180.0 )
+      {
+         lon += 360.0;
+      }
+      return lon;
+   }
+
+   static void interpolateNode(const double corner[2][4][2],
+                               double a, double b, double th, double* out)
+   {
+      const double w0 = (1.0 - a) * (1.0 - b);
+      const double w1 = a * (1.0 - b);
+      const double w2 = a * b;
+      const double w3 = (1.0 - a) * b;
+      for (int i = 0; i < 2; ++i)
+      {
+         double lo = w0*corner[0][0][i] + w1*corner[0][1][i] + w2*corner[0][2][i] + w3*corner[0][3][i];
+         double hi = w0*corner[1][0][i] + w1*corner[1][1][i] + w2*corner[1][2][i] + w3*corner[1][3][i];
+         out[i] = lo + th * (hi - lo);
+      }
+   }
+
+   ossimProjectionGridCache::Node::Node()
+      :
+      m_valid(false)
+   {
+      for (int i = 0; i < 4; ++i)
+      {
+         m_child[i].store(0, std::memory_order_relaxed);
+      }
+   }
+
+   ossimProjectionGridCache::Node::~Node()
+   {
+      for (int i = 0; i < 4; ++i)
+      {
+         delete m_child[i].load(std::memory_order_relaxed);
+      }
+   }
+
+   ossimProjectionGridCache::Grid::Grid(double u0, double v0, double cellU, double cellV,
+                                        ossim_uint32 cellsU, ossim_uint32 cellsV,
+                                        bool forward, double tolerance,
+                                        const EvalFunction& eval)
+      :
+      m_u0(u0),
+      m_v0(v0),
+      m_cellU(cellU),
+      m_cellV(cellV),
+      m_cellsU(cellsU),
+      m_cellsV(cellsV),
+      m_forward(forward),
+      m_tolerance(tolerance),
+      m_eval(eval),
+      m_roots(cellsU * cellsV * HEIGHT_LEVELS)
+   {
+      for (size_t i = 0; i < m_roots.size(); ++i)
+      {
+         m_roots[i].store(0, std::memory_order_relaxed);
+      }
+   }
+
+   ossimProjectionGridCache::Grid::~Grid()
+   {
+      for (size_t i = 0; i < m_roots.size(); ++i)
+      {
+         delete m_roots[i].load(std::memory_order_relaxed);
+      }
+   }
+
+   bool ossimProjectionGridCache::Grid::interpolate(double u, double v, double h, double* out) const
+   {
+      const double fu = (u - m_u0) / m_cellU;
+      const double fv = (v - m_v0) / m_cellV;
+      const double fh = (h - HEIGHT_MIN) / HEIGHT_STEP;
+
+      // Written so NaNs fail.
+      if ( !( (fu >= 0.0) && (fu < m_cellsU) &&
+              (fv >= 0.0) && (fv < m_cellsV) &&
+              (fh >= 0.0) && (fh < HEIGHT_LEVELS) ) )
+      {
+         return false;
+      }
+
+      const ossim_uint32 iu = static_cast<ossim_uint32>(fu);
+      const ossim_uint32 iv = static_cast<ossim_uint32>(fv);
+      const int level = static_cast<int>(fh);
+
+      double a = fu - iu;
+      double b = fv - iv;
+      double nodeU0 = m_u0 + iu * m_cellU;
+      double nodeV0 = m_v0 + iv * m_cellV;
+      double sizeU = m_cellU;
+      double sizeV = m_cellV;
+
+      std::atomic<Node*>* slot = &m_roots[ (iv * m_cellsU + iu) * HEIGHT_LEVELS + level ];
+      for (int depth = 0; ; ++depth)
+      {
+         const Node* node = slot->load(std::memory_order_acquire);
+         if (!node)
+         {
+            node = build(*slot, nodeU0, nodeV0, sizeU, sizeV, level);
+            if (!node)
+            {
+               return false;
+            }
+         }
+         if (node->m_valid)
+         {
+            interpolateNode(node->m_corner, a, b, fh - level, out);
+            if (m_forward)
+            {
+               out[1] = unwrapLongitude(out[1], 0.0);
+            }
+            return true;
+         }
+         if (depth == MAX_DEPTH)
+         {
+            return false; // Could not be approximated within tolerance.
+         }
+
+         // Quadrant: 0 (lo u, lo v), 1 (hi u, lo v), 2 (lo u, hi v), 3 (hi u, hi v).
+         int q = 0;
+         sizeU *= 0.5;
+         sizeV *= 0.5;
+         a *= 2.0;
+         b *= 2.0;
+         if (a >= 1.0)
+         {
+            q |= 1;
+            a -= 1.0;
+            nodeU0 += sizeU;
+         }
+         if (b >= 1.0)
+         {
+            q |= 2;
+            b -= 1.0;
+            nodeV0 += sizeV;
+         }
+         slot = &node->m_child[q];
+      }
+   }
+
+   ossimProjectionGridCache::Node* ossimProjectionGridCache::Grid::build(
+      std::atomic<Node*>& slot, double u0, double v0, double sizeU, double sizeV, int level) const
+   {
+      if (buildingCell)
+      {
+         return 0;
+      }
+
+      ossimBuildingCellGuard guard;
+      Node* node = new Node();
+
+      const double h0 = HEIGHT_MIN + level * HEIGHT_STEP;
+      const double cu[4] = { u0, u0 + sizeU, u0 + sizeU, u0 };
+      const double cv[4] = { v0, v0, v0 + sizeV, v0 + sizeV };
+
+      bool valid = true;
+      for (int l = 0; (l < 2) && valid; ++l)
+      {
+         for (int c = 0; (c < 4) && valid; ++c)
+         {
+            valid = eval(cu[c], cv[c], h0 + l * HEIGHT_STEP, node->m_corner[l][c]);
+         }
+      }
+
+      if (valid && m_forward)
+      {
+         const double ref = node->m_corner[0][0][1];
+         for (int l = 0; l < 2; ++l)
+         {
+            for (int c = 0; c < 4; ++c)
+            {
+               node->m_corner[l][c][1] = unwrapLongitude(node->m_corner[l][c][1], ref);
+            }
+         }
+      }
+
+      for (int t = 0; (t < 5) && valid; ++t)
+      {
+         double rigorous[2];
+         double predicted[2];
+         valid = eval(u0 + TEST_POINTS[t][0] * sizeU, v0 + TEST_POINTS[t][1] * sizeV,
+                      h0 + 0.5 * HEIGHT_STEP, rigorous);
+         if (valid)
+         {
+            interpolateNode(node->m_corner, TEST_POINTS[t][0], TEST_POINTS[t][1], 0.5, predicted);
+            valid = ( error(node, sizeU, sizeV, predicted, rigorous) <= m_tolerance );
+         }
+      }
+
+      node->m_valid = valid;
+      Node* expected = 0;
+      if ( !slot.compare_exchange_strong(expected, node,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire) )
+      {
+         delete node; // Another thread published first.
+         node = expected;
+      }
+      return node;
+   }
+
+   bool ossimProjectionGridCache::Grid::eval(double u, double v, double h, double* out) const
+   {
+      return m_eval(u, v, h, out);
+   }
+
+   double ossimProjectionGridCache::Grid::error(const Node* node, double sizeU, double sizeV,
+                                                const double* predicted, const double* rigorous) const
+   {
+      if (!m_forward)
+      {
+         return std::sqrt( (predicted[0] - rigorous[0]) * (predicted[0] - rigorous[0]) +
+                           (predicted[1] - rigorous[1]) * (predicted[1] - rigorous[1]) );
+      }
+
+      //---
+      // Ground error to pixels using the ground size of a pixel in the cell,
+      // the smaller of the two directions.
+      //---
+      const double (*c)[2] = node->m_corner[0];
+      const double cosLat = std::cos(c[0][0] * M_PI / 180.0);
+      const double du = std::sqrt( ((c[1][0] - c[0][0]) * DEG_TO_METERS) * ((c[1][0] - c[0][0]) * DEG_TO_METERS) +
+                                   ((c[1][1] - c[0][1]) * DEG_TO_METERS * cosLat) *
+                                   ((c[1][1] - c[0][1]) * DEG_TO_METERS * cosLat) ) / sizeU;
+      const double dv = std::sqrt( ((c[3][0] - c[0][0]) * DEG_TO_METERS) * ((c[3][0] - c[0][0]) * DEG_TO_METERS) +
+                                   ((c[3][1] - c[0][1]) * DEG_TO_METERS * cosLat) *
+                                   ((c[3][1] - c[0][1]) * DEG_TO_METERS * cosLat) ) / sizeV;
+      const double gsd = std::min(du, dv);
+      if ( !(gsd > 0.0) )
+      {
+         return ossim::nan(); // Fails the tolerance test.
+      }
+
+      const double dn = (predicted[0] - rigorous[0]) * DEG_TO_METERS;
+      const double de = (predicted[1] - unwrapLongitude(rigorous[1], predicted[1])) * DEG_TO_METERS * cosLat;
+      return std::sqrt(dn*dn + de*de) / gsd;
+   }
+
+   ossimProjectionGridCache::ossimProjectionGridCache(const ossimIrect& imageRect,
+                                                      double tolerance,
+                                                      const ForwardFunction& forward,
+                                                      const InverseFunction& inverse)
+      :
+      m_tolerance(tolerance),
+      m_forwardFunction(forward),
+      m_inverseFunction(inverse),
+      m_wgs84(ossimDatumFactory::instance()->wgs84()),
+      m_forwardGrid(0),
+      m_inverseGrid(0),
+      m_lonCenter(0.0)
+   {
+      if ( imageRect.hasNans() || (imageRect.width() < 2) || (imageRect.height() < 2) || !forward )
+      {
+         return;
+      }
+
+      const ossim_uint32 cellsU = static_cast<ossim_uint32>(std::ceil(imageRect.width()  / ROOT_CELL_PIXELS));
+      const ossim_uint32 cellsV = static_cast<ossim_uint32>(std::ceil(imageRect.height() / ROOT_CELL_PIXELS));
+
+      // Pixel centres at integer coordinates, so cover half a pixel around.
+      m_forwardGrid = new Grid(imageRect.ul().x - 0.5, imageRect.ul().y - 0.5,
+                               static_cast<double>(imageRect.width())  / cellsU,
+                               static_cast<double>(imageRect.height()) / cellsV,
+                               cellsU, cellsV, true, m_tolerance,
+                               [this](double u, double v, double h, double* out) -> bool
+                               {
+                                  ossimGpt gpt;
+                                  m_forwardFunction(ossimDpt(u, v), h, gpt);
+                                  out[0] = gpt.latd();
+                                  out[1] = gpt.lond();
+                                  return !gpt.isLatNan() && !gpt.isLonNan();
+                               });
+
+      if (!m_inverseFunction)
+      {
+         return;
+      }
+
+      //---
+      // Inverse grid covers the ground footprint at the height levels around
+      // zero, padded so the footprint at other heights mostly fits.
+      //---
+      double latMin = 90.0;
+      double latMax = -90.0;
+      double lonMin = 0.0;
+      double lonMax = 0.0;
+      for (int j = 0; j < 3; ++j)
+      {
+         for (int i = 0; i < 3; ++i)
+         {
+            ossimDpt ipt(imageRect.ul().x + 0.5 * i * (imageRect.width()  - 1),
+                         imageRect.ul().y + 0.5 * j * (imageRect.height() - 1));
+            ossimGpt gpt;
+            m_forwardFunction(ipt, 0.0, gpt);
+            if ( gpt.isLatNan() || gpt.isLonNan() )
+            {
+               return;
+            }
+            if ( (i == 0) && (j == 0) )
+            {
+               m_lonCenter = gpt.lond();
+               lonMin = lonMax = m_lonCenter;
+            }
+            const double lon = unwrapLongitude(gpt.lond(), m_lonCenter);
+            latMin = std::min(latMin, gpt.latd());
+            latMax = std::max(latMax, gpt.latd());
+            lonMin = std::min(lonMin, lon);
+            lonMax = std::max(lonMax, lon);
+         }
+      }
+      m_lonCenter = 0.5 * (lonMin + lonMax);
+
+      const double padLat = 0.05 * (latMax - latMin) + 1.0e-3;
+      const double padLon = 0.05 * (lonMax - lonMin) + 1.0e-3;
+      latMin -= padLat;
+      latMax += padLat;
+      lonMin -= padLon;
+      lonMax += padLon;
+
+      m_inverseGrid = new Grid(lonMin, latMin,
+                               (lonMax - lonMin) / cellsU, (latMax - latMin) / cellsV,
+                               cellsU, cellsV, false, m_tolerance,
+                               [this](double u, double v, double h, double* out) -> bool
+                               {
+                                  ossimDpt ipt;
+                                  m_inverseFunction(ossimGpt(v, u, h), ipt);
+                                  out[0] = ipt.x;
+                                  out[1] = ipt.y;
+                                  return !ipt.hasNans();
+                               });
+   }
+
+   ossimProjectionGridCache::~ossimProjectionGridCache()
+   {
+      delete m_forwardGrid;
+      m_forwardGrid = 0;
+      delete m_inverseGrid;
+      m_inverseGrid = 0;
+   }
+
+   bool ossimProjectionGridCache::lineSampleHeightToWorld(const ossimDpt& imagePoint,
+                                                          const double&   heightEllipsoid,
+                                                          ossimGpt&       worldPoint) const
+   {
+      double latLon[2];
+      if ( m_forwardGrid &&
+           m_forwardGrid->interpolate(imagePoint.x, imagePoint.y, heightEllipsoid, latLon) )
+      {
+         worldPoint = ossimGpt(latLon[0], latLon[1], heightEllipsoid);
+         return true;
+      }
+      return false;
+   }
+
+   bool ossimProjectionGridCache::worldToLineSample(const ossimGpt& worldPoint,
+                                                    ossimDpt&       imagePoint) const
+   {
+      double xy[2];
+      if ( m_inverseGrid && (worldPoint.datum() == m_wgs84) &&
+           m_inverseGrid->interpolate(unwrapLongitude(worldPoint.lond(), m_lonCenter),
+                                      worldPoint.latd(), worldPoint.height(), xy) )
+      {
+         imagePoint.x = xy[0];
+         imagePoint.y = xy[1];
+         return true;
+      }
+      return false;
+   }
+
+   double ossimProjectionGridCache::getTolerance() const
+   {
+      return m_tolerance;
+   }
+
+   bool ossimProjectionGridCache::getPreferences(double& tolerance)
+   {
+      tolerance = DEFAULT_TOLERANCE;
+
+      ossimString enabled(ossimPreferences::instance()->findPreference(ENABLED_PREF_KW));
+      if (!enabled.toBool())
+      {
+         return false;
+      }
+
+      const char* lookup = ossimPreferences::instance()->findPreference(TOLERANCE_PREF_KW);
+      if (lookup)
+      {
+         double value = ossimString(lookup).toDouble();
+         if (value > 0.0)
+         {
+            tolerance = value;
+         }
+      }
+      return true;
+   }
+
+   //---
+   // This thread's references to the caches of the last holders it used,
+   // with the holder generation they were taken at.  Holder ids start at 1.
+   //---
+   struct ossimProjectionCacheCopy
+   {
+      ossim_uint64                       holder;
+      ossim_uint32                       generation;
+      ossimProjectionGridCache::ConstPtr cache;
+   };
+   static const int CACHE_COPIES = 4;
+   static thread_local ossimProjectionCacheCopy cacheCopies[CACHE_COPIES];
+   static thread_local int nextCacheCopy = 0;
+
+   static ossim_uint64 newHolderId()
+   {
+      static std::atomic<ossim_uint64> lastId(0);
+      return ++lastId;
+   }
+
+   ossimProjectionGridCache::Holder::Holder()
+      :
+      m_id(newHolderId()),
+      m_cache(),
+      m_state(STATE_UNKNOWN),
+      m_mutex(),
+      m_generation(0)
+   {
+   }
+
+   ossimProjectionGridCache::Holder::Holder(const Holder& /* rhs */)
+      :
+      m_id(newHolderId()),
+      m_cache(),
+      m_state(STATE_UNKNOWN),
+      m_mutex(),
+      m_generation(0)
+   {
+   }
+
+   ossimProjectionGridCache::Holder::~Holder()
+   {
+   }
+
+   const ossimProjectionGridCache::Holder& ossimProjectionGridCache::Holder::operator=(
+      const Holder& /* rhs */)
+   {
+      reset();
+      return *this;
+   }
+
+   void ossimProjectionGridCache::Holder::reset()
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_generation.fetch_add(1, std::memory_order_acq_rel);
+      m_state.store(STATE_UNKNOWN, std::memory_order_release);
+      std::atomic_store(&m_cache, ConstPtr());
+   }
+
+   ossimProjectionGridCache::ConstPtr ossimProjectionGridCache::Holder::find() const
+   {
+      //---
+      // Generation read first: if a reset comes in before the load below,
+      // the copy is taken at the old generation and dropped on the next call.
+      //---
+      const ossim_uint32 generation = m_generation.load(std::memory_order_acquire);
+      int slot = -1;
+      for (int i = 0; i < CACHE_COPIES; ++i)
+      {
+         if (cacheCopies[i].holder == m_id)
+         {
+            if (cacheCopies[i].generation == generation)
+            {
+               return cacheCopies[i].cache;
+            }
+            slot = i;
+         }
+      }
+
+      ConstPtr cache = std::atomic_load(&m_cache);
+      if (cache)
+      {
+         if (slot < 0)
+         {
+            slot = nextCacheCopy;
+            nextCacheCopy = (nextCacheCopy + 1) % CACHE_COPIES;
+         }
+         cacheCopies[slot].holder     = m_id;
+         cacheCopies[slot].generation = generation;
+         cacheCopies[slot].cache      = cache;
+      }
+      return cache;
+   }
+
+   ossimProjectionGridCache::ConstPtr ossimProjectionGridCache::Holder::create(
+      const ossimIrect& imageRect,
+      const ForwardFunction& forward,
+      const InverseFunction& inverse) const
+   {
+      const ossim_uint32 generation = m_generation.load(std::memory_order_acquire);
+
+      double tolerance;
+      if (!getPreferences(tolerance))
+      {
+         m_state.store(STATE_OFF, std::memory_order_release);
+         return ConstPtr();
+      }
+
+      if ( imageRect.hasNans() || (imageRect.width() < 2) || (imageRect.height() < 2) )
+      {
+         return ConstPtr(); // Model not set up yet, ask again next time.
+      }
+
+      // Built outside the lock, it projects the footprint.
+      ConstPtr cache(new ossimProjectionGridCache(imageRect, tolerance, forward, inverse));
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (generation != m_generation.load(std::memory_order_acquire))
+      {
+         return cache; // Reset meanwhile, may be from old parameters so not kept.
+      }
+      ConstPtr current = std::atomic_load(&m_cache);
+      if (current)
+      {
+         return current; // Another thread was first.
+      }
+      std::atomic_store(&m_cache, cache);
+      return cache;
+   }
+}
@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: In memory approximation of an expensive sensor model.
+//
+// Image to ground (at a set of height levels) and ground to image are each
+// approximated by a quadtree of bilinear cells, built lazily from the
+// rigorous model the first time a point falls in a cell.  A cell is
+// validated against the rigorous model at its centre and edge midpoints
+// and split until the error is under the tolerance.  Points outside
+// validated cells, or outside the covered heights, are not answered and
+// the caller uses the rigorous model.
+//
+// Cells are built without a lock and published with a compare and swap, so
+// threads only wait on each other for the pointer.  Two threads reaching
+// the same new cell both build it and the second one's copy is dropped.
+//
+// Unlike ossimCoarseGridModel nothing is written to disk and the model
+// keeps its type and all of its other behaviour.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimProjectionGridCache_HEADER
+#define ossimProjectionGridCache_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/base/ossimIrect.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ossimDatum;
+
+namespace ossimplugins
+{
+   class OSSIM_PLUGINS_DLL ossimProjectionGridCache
+   {
+   public:
+
+      /** Rigorous image to ground at height. */
+      typedef std::function<void(const ossimDpt&, const double&, ossimGpt&)> ForwardFunction;
+
+      /** Rigorous ground to image. */
+      typedef std::function<void(const ossimGpt&, ossimDpt&)> InverseFunction;
+
+      /** Preference keyword to turn the cache on, "projection_grid_cache.enabled: <bool>". */
+      static const char* ENABLED_PREF_KW;
+
+      /** Preference keyword for the error tolerance in pixels, "projection_grid_cache.tolerance: <double>". */
+      static const char* TOLERANCE_PREF_KW;
+
+      /**
+       * @param imageRect Image area to cover.
+       * @param tolerance Max error in pixels of an approximated point.
+       * @param forward Rigorous image to ground.  Must not use this cache.
+       * @param inverse Rigorous ground to image.  Must not use this cache.
+       * May be empty, then worldToLineSample never answers.
+       */
+      ossimProjectionGridCache(const ossimIrect& imageRect,
+                               double tolerance,
+                               const ForwardFunction& forward,
+                               const InverseFunction& inverse);
+
+      ~ossimProjectionGridCache();
+
+      /**
+       * @brief Approximated image to ground.
+       * @return true if answered, false if the caller must use the
+       * rigorous model.
+       */
+      bool lineSampleHeightToWorld(const ossimDpt& imagePoint,
+                                   const double&   heightEllipsoid,
+                                   ossimGpt&       worldPoint) const;
+
+      /**
+       * @brief Approximated ground to image.
+       * @return true if answered, false if the caller must use the
+       * rigorous model.
+       */
+      bool worldToLineSample(const ossimGpt& worldPoint,
+                             ossimDpt&       imagePoint) const;
+
+      /** @return Error tolerance in pixels. */
+      double getTolerance() const;
+
+      /**
+       * @brief Reads the preference keywords.
+       * @param tolerance Set to the tolerance keyword or the default.
+       * @return true if the cache is turned on.
+       */
+      static bool getPreferences(double& tolerance);
+
+      /** Shared so a projection in flight keeps its cache through a reset. */
+      typedef std::shared_ptr<const ossimProjectionGridCache> ConstPtr;
+
+      /**
+       * @brief Owner of the cache of one model.
+       *
+       * Creates the cache on first use if the preferences turn it on.
+       * Copies are empty, so a copied model builds its own cache.  Models
+       * call reset() whenever their parameters change.
+       *
+       * Each thread keeps its own reference to the caches of the last few
+       * holders it used, so projecting does not touch anything shared but
+       * the reference count.  A dropped cache is deleted once every thread
+       * has let go of it: when the thread next uses that holder, has used
+       * several others since or ends.
+       */
+      class OSSIM_PLUGINS_DLL Holder
+      {
+      public:
+         Holder();
+         Holder(const Holder& rhs);
+         ~Holder();
+         const Holder& operator=(const Holder& rhs);
+
+         /**
+          * @return The cache, or empty if turned off or the image rect is
+          * not usable.  forward and inverse are only used when the cache is
+          * created.
+          */
+         template <class F, class I>
+         ConstPtr get(const ossimIrect& imageRect,
+                      const F& forward,
+                      const I& inverse) const
+         {
+            ConstPtr cache = find();
+            if (cache || (m_state.load(std::memory_order_acquire) == STATE_OFF))
+            {
+               return cache;
+            }
+            return create(imageRect, ForwardFunction(forward), InverseFunction(inverse));
+         }
+
+         /**
+          * @brief Drops the cache.  Other threads may be projecting: they
+          * finish with the cache they hold.
+          */
+         void reset();
+
+      private:
+         enum
+         {
+            STATE_UNKNOWN = 0,
+            STATE_OFF     = 1
+         };
+
+         /** @return This thread's reference to the cache, if still current. */
+         ConstPtr find() const;
+
+         ConstPtr create(const ossimIrect& imageRect,
+                         const ForwardFunction& forward,
+                         const InverseFunction& inverse) const;
+
+         const ossim_uint64                m_id;         // Tells holders apart in the thread copies.
+         mutable ConstPtr                  m_cache;      // Only through std::atomic_load/store.
+         mutable std::atomic<int>          m_state;
+         mutable std::mutex                m_mutex;      // Orders create against reset.
+         mutable std::atomic<ossim_uint32> m_generation; // Counts resets.
+      };
+
+   private:
+
+      /** Quadtree cell.  Corners at two height levels. */
+      struct Node
+      {
+         Node();
+         ~Node();
+
+         // [height level k, k+1][corner (u0,v0), (u1,v0), (u1,v1), (u0,v1)][component]
+         double             m_corner[2][4][2];
+         bool               m_valid;
+         mutable std::atomic<Node*> m_child[4];
+      };
+
+      /** Regular array of quadtree roots over (u, v), one per height level. */
+      class Grid
+      {
+      public:
+         typedef std::function<bool(double, double, double, double*)> EvalFunction;
+
+         /**
+          * @param forward true for image (u=x, v=y) to ground (lat, lon),
+          * false for ground (u=lon, v=lat) to image (x, y).
+          */
+         Grid(double u0, double v0, double cellU, double cellV,
+              ossim_uint32 cellsU, ossim_uint32 cellsV,
+              bool forward, double tolerance,
+              const EvalFunction& eval);
+         ~Grid();
+
+         /** @return true and out if (u, v, h) is in a validated cell. */
+         bool interpolate(double u, double v, double h, double* out) const;
+
+      private:
+         /** @return The node of slot, built and published if empty. */
+         Node* build(std::atomic<Node*>& slot,
+                     double u0, double v0, double sizeU, double sizeV,
+                     int level) const;
+         bool eval(double u, double v, double h, double* out) const;
+         double error(const Node* node, double sizeU, double sizeV,
+                      const double* predicted, const double* rigorous) const;
+
+         double       m_u0;
+         double       m_v0;
+         double       m_cellU;
+         double       m_cellV;
+         ossim_uint32 m_cellsU;
+         ossim_uint32 m_cellsV;
+         bool         m_forward;
+         double       m_tolerance;
+         EvalFunction m_eval;
+         mutable std::vector< std::atomic<Node*> > m_roots;
+      };
+
+      // Not copyable.
+      ossimProjectionGridCache(const ossimProjectionGridCache& rhs);
+      const ossimProjectionGridCache& operator=(const ossimProjectionGridCache& rhs);
+
+      double             m_tolerance;
+      ForwardFunction    m_forwardFunction;
+      InverseFunction    m_inverseFunction;
+      const ossimDatum*  m_wgs84;
+      Grid*              m_forwardGrid;
+      Grid*              m_inverseGrid;
+      double             m_lonCenter;  // Inverse grid longitudes are kept within 180 of this.
+   };
+}
+
+#endif /* #ifndef ossimProjectionGridCache_HEADER */
@@ -11,6 +11,7 @@
 
 #include <cmath>
 #include <cstdio>
+#include <cstdlib>
 
 #include <ossimRadarSat2Model.h>
 #include <ossimPluginCommon.h>
@@ -60,7 +61,8 @@ ossimRadarSat2Model::ossimRadarSat2Model(const ossimRadarSat2Model& rhs)
    ossimGeometricSarSensorModel(rhs),
    _n_srgr(rhs._n_srgr),
    _srgr_update(rhs._srgr_update),
-   _SrGr_R0(rhs._SrGr_R0)
+   _SrGr_R0(rhs._SrGr_R0),
+   _noiseLevel(rhs._noiseLevel)
 {
 }
 
@@ -115,6 +117,100 @@ double ossimRadarSat2Model::getSlantRangeFromGeoreferenced(double col) const
    return  slantRange ;
 }
 
+bool ossimRadarSat2Model::getCalibrationCoefficients(
+   ossimSarCalibration::Measure measure,
+   bool                         removeNoise,
+   double                       /* line */,
+   ossim_int32                  firstCol,
+   std::vector<double>&         gain,
+   std::vector<double>&         offset) const
+{
+   //---
+   // Product LUTs and noise levels are named after the incidence angle
+   // correction, see InitRefNoiseLevel.  Neither depends on the line.
+   //---
+   ossimString name = "Sigma Nought";
+   if (measure == ossimSarCalibration::BETA0)
+   {
+      name = "Beta Nought";
+   }
+   else if (measure == ossimSarCalibration::GAMMA0)
+   {
+      name = "Gamma";
+   }
+
+   const RadarSat2NoiseLevel* level = 0;
+   for (ossim_uint32 i = 0; i < _noiseLevel.size(); ++i)
+   {
+      if (_noiseLevel[i].get_incidenceAngleCorrectionName() == name)
+      {
+         level = &_noiseLevel[i];
+         break;
+      }
+   }
+   if (!level)
+   {
+      return false;
+   }
+
+   // One gain per image column.
+   std::vector<double> lut;
+   const char* p = level->get_gain().c_str();
+   while (*p)
+   {
+      char* end = 0;
+      double v = std::strtod(p, &end);
+      if (end == p)
+      {
+         break;
+      }
+      lut.push_back(v);
+      p = end;
+   }
+   if (lut.empty())
+   {
+      return false;
+   }
+
+   // sigma0 = (DN^2 + B) / A
+   const double B = level->get_offset();
+   const std::vector<ossim_float64>& noise = level->get_noiseLevelValues();
+   const double first = level->get_pixelFirstNoiseValue();
+   const double step  = level->get_stepSize();
+   const bool useNoise = removeNoise && !noise.empty() && (step > 0.0);
+   const ossim_int32 lastLutCol = static_cast<ossim_int32>(lut.size()) - 1;
+
+   offset.resize(gain.size());
+   for (ossim_uint32 c = 0; c < gain.size(); ++c)
+   {
+      const ossim_int32 col = firstCol + static_cast<ossim_int32>(c);
+      const double A = lut[ (col < 0) ? 0 : ( (col > lastLutCol) ? lastLutCol : col ) ];
+      const double g = (A != 0.0) ? 1.0 / A : 0.0;
+      gain[c]   = g;
+      offset[c] = B * g;
+
+      if (useNoise)
+      {
+         // Noise equivalent level in dB every step columns from first.
+         double k = (col - first) / step;
+         const double kMax = static_cast<double>(noise.size() - 1);
+         k = (k < 0.0) ? 0.0 : ( (k > kMax) ? kMax : k );
+         const ossim_uint32 k0 = static_cast<ossim_uint32>(k);
+         const ossim_uint32 k1 = (k0 + 1 < noise.size()) ? k0 + 1 : k0;
+         const double dB = noise[k0] + (k - k0) * (noise[k1] - noise[k0]);
+         offset[c] -= std::pow(10.0, dB / 10.0);
+      }
+   }
+
+   return true;
+}
+
+bool ossimRadarSat2Model::isComplex() const
+{
+   // SLC is the one product left in slant range:
+   return !_isProductGeoreferenced;
+}
+
 bool ossimRadarSat2Model::open(const ossimFilename& file)
 {
    static const char MODULE[] = "ossimRadarSat2Model::open";
@@ -1513,6 +1609,8 @@ bool ossimRadarSat2Model::loadState (const ossimKeywordlist &kwl,
          << std::endl;
    }
 
+   resetProjectionCache();
+
    return result;
 }
 
@@ -72,6 +72,21 @@ public:
     */
    virtual double getSlantRangeFromGeoreferenced(double col) const;
 
+   /**
+    * @brief Calibration from the product LUT (lut*.xml) of measure, and
+    * the reference noise level of the same incidence angle correction.
+    * Same for all lines.
+    */
+   virtual bool getCalibrationCoefficients(ossimSarCalibration::Measure measure,
+                                           bool removeNoise,
+                                           double line,
+                                           ossim_int32 firstCol,
+                                           std::vector<double>& gain,
+                                           std::vector<double>& offset) const;
+
+   /** @brief True for SLC products. */
+   virtual bool isComplex() const;
+
    /**
     * @brief Method to intantial model from a file.  Attempts to find the
     * required xml file.
@@ -37,6 +37,7 @@
 #include <RadarSat/Data/ProcessedDataRecord.h>
 #include <RadarSat/CommonRecord/ProcessingParameters.h>
 #include <RadarSat/Leader/PlatformPositionData.h>
+#include <ossimMappedFileStream.h>
 
 namespace ossimplugins
 {
@@ -210,7 +211,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
 
   RadarSatRecordHeader headerVDF;
   VolumeDirFactory factoryVDF;
-  ifstream volumeDirFile (volumeDirectoryFilePath.c_str(), ios::in|ios::binary);
+  ossimMappedFileStream volumeDirFile(volumeDirectoryFilePath);
   volumeDirFile>>headerVDF;
   if(volumeDirFile.eof())
     {
@@ -255,7 +256,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
         //Reading of the remaining of the volume directory file
 
         volumeDirFile.close();
-        volumeDirFile.open(volumeDirectoryFilePath.c_str(), ios::in | ios::binary);
+        volumeDirFile.open(volumeDirectoryFilePath);
         volumeDirFile >> *_volumeDir;
         volumeDirFile.close();
 
@@ -266,7 +267,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
 
         RadarSatRecordHeader headerDAT;
         DataFactory factoryDAT;
-        ifstream dataFile (dataFilePath.c_str(), ios::in|ios::binary);
+        ossimMappedFileStream dataFile(dataFilePath);
         dataFile>>headerDAT;
         if(dataFile.eof())
           {
@@ -288,7 +289,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
             /*
              * Reading the remaining of the data file
              */
-            dataFile.open(dataFilePath.c_str(), ios::in|ios::binary);
+            dataFile.open(dataFilePath);
             dataFile>>*_data;
             dataFile.close();
 
@@ -341,7 +342,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
           /*
            * Leader file data reading
            */
-          ifstream leaderFile (leaderFilePath.c_str(), ios::in|ios::binary);
+          ossimMappedFileStream leaderFile(leaderFilePath);
           leaderFile>>*_leader;
           leaderFile.close();
           if(traceDebug())
@@ -381,7 +382,7 @@ bool ossimRadarSatModel::open(const ossimFilename& file)
           /*
            * Trailer file data reading
            */
-          ifstream trailerFile (trailerFilePath.c_str(), ios::in|ios::binary);
+          ossimMappedFileStream trailerFile(trailerFilePath);
           trailerFile>>*_trailer;
           trailerFile.close();
           if(traceDebug())
@@ -712,6 +713,8 @@ bool ossimRadarSatModel::loadState (const ossimKeywordlist &kwl,
   {
      ossimNotify(ossimNotifyLevel_DEBUG) << MODULE << " exit...\n";
   }
+  resetProjectionCache();
+
   return result;
 }
 
@@ -0,0 +1,240 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Radiometric calibration of SAR tiles.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimSarCalibration.h>
+#include <ossimGeometricSarSensorModel.h>
+
+#include <cstdlib>
+
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && (_M_IX86_FP >= 1) )
+#  define OSSIM_SAR_CALIBRATION_SSE 1
+#  include <xmmintrin.h>
+#endif
+
+namespace ossimplugins
+{
+   // Blocks kept per object.  A tile row of a few thousand columns spans
+   // one or two blocks; the rest is for tiles requested out of order.
+   static const std::size_t MAX_BLOCKS = 16;
+
+   ossimSarCalibration::ossimSarCalibration()
+      :
+      m_model(0),
+      m_measure(SIGMA0),
+      m_removeNoise(false),
+      m_width(0),
+      m_blockLines(1),
+      m_mutex(),
+      m_blocks()
+   {
+   }
+
+   ossimSarCalibration::~ossimSarCalibration()
+   {
+   }
+
+   bool ossimSarCalibration::initialize(const ossimGeometricSarSensorModel* model,
+                                        Measure measure,
+                                        bool removeNoise,
+                                        ossim_uint32 width,
+                                        ossim_uint32 blockLines)
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+
+      m_blocks.clear();
+      m_model       = 0;
+      m_measure     = measure;
+      m_removeNoise = removeNoise;
+      m_width       = width;
+      m_blockLines  = blockLines ? blockLines : 1;
+
+      if ( !model || !width )
+      {
+         return false;
+      }
+
+      // Probe one column so that a product without calibration is
+      // reported here rather than on the first tile.
+      std::vector<double> gain(1);
+      std::vector<double> offset(1);
+      if ( !model->getCalibrationCoefficients(measure, removeNoise, 0.0, 0, gain, offset) )
+      {
+         return false;
+      }
+
+      m_model = model;
+      return true;
+   }
+
+   std::shared_ptr<const ossimSarCalibration::Block> ossimSarCalibration::getBlock(
+      ossim_uint32 line)
+   {
+      const ossim_uint32 index = line / m_blockLines;
+      const ossimGeometricSarSensorModel* model = 0;
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         std::map<ossim_uint32, std::shared_ptr<const Block> >::const_iterator i =
+            m_blocks.find(index);
+         if ( i != m_blocks.end() )
+         {
+            return (*i).second;
+         }
+         model = m_model;
+      }
+      if ( !model )
+      {
+         return std::shared_ptr<const Block>();
+      }
+
+      //---
+      // Evaluated at the middle line of the block, without the lock: the
+      // model is not changed by this and two threads computing the same
+      // block get the same values.
+      //---
+      std::vector<double> gain(m_width);
+      std::vector<double> offset(m_width);
+      const double centerLine = index * static_cast<double>(m_blockLines) +
+         0.5 * (m_blockLines - 1);
+      if ( !model->getCalibrationCoefficients(m_measure, m_removeNoise, centerLine,
+                                              0, gain, offset) )
+      {
+         return std::shared_ptr<const Block>();
+      }
+
+      std::shared_ptr<Block> block(new Block);
+      block->m_gain.assign(gain.begin(), gain.end());
+      block->m_offset.assign(offset.begin(), offset.end());
+
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if ( m_blocks.size() >= MAX_BLOCKS )
+      {
+         // Drop the block farthest from this one.
+         const ossim_int64 toFirst = static_cast<ossim_int64>(index) - m_blocks.begin()->first;
+         const ossim_int64 toLast  = static_cast<ossim_int64>(m_blocks.rbegin()->first) - index;
+         if ( std::abs(toFirst) > std::abs(toLast) )
+         {
+            m_blocks.erase(m_blocks.begin());
+         }
+         else
+         {
+            m_blocks.erase(--m_blocks.end());
+         }
+      }
+      std::shared_ptr<const Block>& slot = m_blocks[index];
+      if ( !slot )
+      {
+         slot = block;
+      }
+      return slot;
+   }
+
+   ossim_uint32 ossimSarCalibration::getWidth() const
+   {
+      return m_width;
+   }
+
+   void ossimSarCalibration::applyDetected(const ossim_float32* dn,
+                                           const ossim_float32* gain,
+                                           const ossim_float32* offset,
+                                           ossim_float32* out,
+                                           ossim_uint32 count)
+   {
+      ossim_uint32 i = 0;
+#ifdef OSSIM_SAR_CALIBRATION_SSE
+      for ( ; i + 8 <= count; i += 8 )
+      {
+         __m128 a0 = _mm_loadu_ps(dn + i);
+         __m128 a1 = _mm_loadu_ps(dn + i + 4);
+         a0 = _mm_mul_ps(a0, a0);
+         a1 = _mm_mul_ps(a1, a1);
+         a0 = _mm_add_ps(_mm_mul_ps(a0, _mm_loadu_ps(gain + i)), _mm_loadu_ps(offset + i));
+         a1 = _mm_add_ps(_mm_mul_ps(a1, _mm_loadu_ps(gain + i + 4)), _mm_loadu_ps(offset + i + 4));
+         _mm_storeu_ps(out + i, a0);
+         _mm_storeu_ps(out + i + 4, a1);
+      }
+#endif
+      for ( ; i < count; ++i )
+      {
+         out[i] = dn[i] * dn[i] * gain[i] + offset[i];
+      }
+   }
+
+   void ossimSarCalibration::applyComplex(const ossim_float32* re,
+                                          const ossim_float32* im,
+                                          const ossim_float32* gain,
+                                          const ossim_float32* offset,
+                                          ossim_float32* out,
+                                          ossim_uint32 count)
+   {
+      ossim_uint32 i = 0;
+#ifdef OSSIM_SAR_CALIBRATION_SSE
+      for ( ; i + 4 <= count; i += 4 )
+      {
+         __m128 r = _mm_loadu_ps(re + i);
+         __m128 q = _mm_loadu_ps(im + i);
+         __m128 p = _mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(q, q));
+         p = _mm_add_ps(_mm_mul_ps(p, _mm_loadu_ps(gain + i)), _mm_loadu_ps(offset + i));
+         _mm_storeu_ps(out + i, p);
+      }
+#endif
+      for ( ; i < count; ++i )
+      {
+         out[i] = (re[i] * re[i] + im[i] * im[i]) * gain[i] + offset[i];
+      }
+   }
+
+   bool ossimSarCalibration::simdSupported()
+   {
+#ifdef OSSIM_SAR_CALIBRATION_SSE
+      return true;
+#else
+      return false;
+#endif
+   }
+
+   const char* ossimSarCalibration::measureToString(Measure measure)
+   {
+      switch ( measure )
+      {
+         case BETA0:
+            return "beta0";
+         case GAMMA0:
+            return "gamma0";
+         case SIGMA0:
+         default:
+            return "sigma0";
+      }
+   }
+
+   bool ossimSarCalibration::stringToMeasure(const ossimString& s, Measure& measure)
+   {
+      ossimString str = s.trim();
+      str.downcase();
+      if ( str == "sigma0" )
+      {
+         measure = SIGMA0;
+      }
+      else if ( str == "beta0" )
+      {
+         measure = BETA0;
+      }
+      else if ( str == "gamma0" )
+      {
+         measure = GAMMA0;
+      }
+      else
+      {
+         return false;
+      }
+      return true;
+   }
+
+} // End: namespace ossimplugins
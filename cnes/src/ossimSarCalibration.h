@@ -0,0 +1,118 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Radiometric calibration of SAR tiles.
+//
+// A calibrated value is gain * |DN|^2 + offset, with gain and offset
+// depending on the column (calibration LUT, incidence angle, noise
+// polynomial in range) and slowly on the line (noise records in azimuth).
+// The model evaluates gain and offset for a whole image line once per
+// block of lines; the tiles of the block are then calibrated with a
+// multiply-add per pixel.  On x86 the kernels use SSE2; the scalar code is
+// the reference for the results.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimSarCalibration_HEADER
+#define ossimSarCalibration_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimString.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ossimplugins
+{
+   class ossimGeometricSarSensorModel;
+
+   class OSSIM_PLUGINS_DLL ossimSarCalibration
+   {
+   public:
+
+      enum Measure
+      {
+         SIGMA0 = 0,
+         BETA0  = 1,
+         GAMMA0 = 2
+      };
+
+      /** Per column coefficients of one block of lines. */
+      struct Block
+      {
+         std::vector<ossim_float32> m_gain;
+         std::vector<ossim_float32> m_offset;
+      };
+
+      ossimSarCalibration();
+      ~ossimSarCalibration();
+
+      /**
+       * @brief Sets the model and drops the cached blocks.
+       * @param model Model of the image.  Must outlive this object.
+       * @param measure Backscatter coefficient to compute.
+       * @param removeNoise If true the noise floor is subtracted.
+       * @param width Number of image columns.
+       * @param blockLines Lines sharing one set of coefficients.
+       * @return false if the model has no calibration for measure.
+       */
+      bool initialize(const ossimGeometricSarSensorModel* model,
+                      Measure measure,
+                      bool removeNoise,
+                      ossim_uint32 width,
+                      ossim_uint32 blockLines);
+
+      /**
+       * @brief Coefficients of the block holding line, computed on first
+       * use.  Thread safe.
+       * @return The block, or a null pointer if not initialized.
+       */
+      std::shared_ptr<const Block> getBlock(ossim_uint32 line);
+
+      ossim_uint32 getWidth() const;
+
+      /** @brief out[i] = gain[i] * dn[i]^2 + offset[i] */
+      static void applyDetected(const ossim_float32* dn,
+                                const ossim_float32* gain,
+                                const ossim_float32* offset,
+                                ossim_float32* out,
+                                ossim_uint32 count);
+
+      /** @brief out[i] = gain[i] * (re[i]^2 + im[i]^2) + offset[i] */
+      static void applyComplex(const ossim_float32* re,
+                               const ossim_float32* im,
+                               const ossim_float32* gain,
+                               const ossim_float32* offset,
+                               ossim_float32* out,
+                               ossim_uint32 count);
+
+      /** @return true if the kernels use SIMD instructions. */
+      static bool simdSupported();
+
+      /** @return "sigma0", "beta0" or "gamma0". */
+      static const char* measureToString(Measure measure);
+
+      /** @return false if s is none of the measureToString strings. */
+      static bool stringToMeasure(const ossimString& s, Measure& measure);
+
+   private:
+      ossimSarCalibration(const ossimSarCalibration&);
+      ossimSarCalibration& operator=(const ossimSarCalibration&);
+
+      const ossimGeometricSarSensorModel* m_model;
+      Measure      m_measure;
+      bool         m_removeNoise;
+      ossim_uint32 m_width;
+      ossim_uint32 m_blockLines;
+
+      std::mutex m_mutex;
+      std::map<ossim_uint32, std::shared_ptr<const Block> > m_blocks;
+   };
+}
+
+#endif /* #ifndef ossimSarCalibration_HEADER */
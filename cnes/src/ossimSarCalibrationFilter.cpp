@@ -0,0 +1,522 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Tile filter computing sigma0, beta0 or gamma0 from a SAR
+// image opened with one of the plugin sensor models.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include <ossimSarCalibrationFilter.h>
+#include <ossimGeometricSarSensorModel.h>
+#include <ossim/base/ossimBooleanProperty.h>
+#include <ossim/base/ossimCommon.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimNumericProperty.h>
+#include <ossim/base/ossimStringProperty.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/projection/ossimProjection.h>
+
+#include <cmath>
+
+namespace ossimplugins
+{
+   RTTI_DEF1(ossimSarCalibrationFilter, "ossimSarCalibrationFilter", ossimImageSourceFilter);
+
+   static ossimTrace traceDebug("ossimSarCalibrationFilter:debug");
+
+   static const char MEASURE_KW[]            = "measure";
+   static const char REMOVE_NOISE_KW[]       = "remove_noise";
+   static const char AZIMUTH_BLOCK_SIZE_KW[] = "azimuth_block_size";
+
+   static const ossim_uint32 DEFAULT_BLOCK_LINES = 256;
+
+   template <class T>
+   static inline void toFloat(const T* src, ossim_float32* dst, ossim_uint32 count)
+   {
+      for ( ossim_uint32 i = 0; i < count; ++i )
+      {
+         dst[i] = static_cast<ossim_float32>(src[i]);
+      }
+   }
+
+   ossimSarCalibrationFilter::ossimSarCalibrationFilter()
+      :
+      ossimImageSourceFilter(),
+      m_measure(ossimSarCalibration::SIGMA0),
+      m_removeNoise(false),
+      m_blockLines(DEFAULT_BLOCK_LINES),
+      m_ready(false),
+      m_complex(false),
+      m_geometry(0),
+      m_calibration(),
+      m_tile(0),
+      m_re(),
+      m_im(),
+      m_gain(),
+      m_offset()
+   {
+   }
+
+   ossimSarCalibrationFilter::~ossimSarCalibrationFilter()
+   {
+   }
+
+   ossimRefPtr<ossimImageData> ossimSarCalibrationFilter::getTile(const ossimIrect& tileRect,
+                                                                  ossim_uint32 resLevel)
+   {
+      if ( !theInputConnection )
+      {
+         return ossimRefPtr<ossimImageData>();
+      }
+
+      ossimRefPtr<ossimImageData> input = theInputConnection->getTile(tileRect, resLevel);
+      if ( !isCalibrating() || !input.valid() )
+      {
+         return input;
+      }
+
+      if ( !m_tile.valid() )
+      {
+         m_tile = ossimImageDataFactory::instance()->create(this, this);
+         m_tile->initialize();
+      }
+      m_tile->setImageRectangle(tileRect);
+      m_tile->makeBlank();
+
+      if ( (input->getDataObjectStatus() == OSSIM_NULL) ||
+           (input->getDataObjectStatus() == OSSIM_EMPTY) ||
+           (m_complex && (input->getNumberOfBands() != 2)) )
+      {
+         return m_tile;
+      }
+
+      switch ( input->getScalarType() )
+      {
+         case OSSIM_UINT8:
+            calibrate(ossim_uint8(0), input, resLevel);
+            break;
+         case OSSIM_SINT8:
+            calibrate(ossim_sint8(0), input, resLevel);
+            break;
+         case OSSIM_UINT16:
+         case OSSIM_USHORT11:
+         case OSSIM_USHORT12:
+         case OSSIM_USHORT13:
+         case OSSIM_USHORT14:
+         case OSSIM_USHORT15:
+            calibrate(ossim_uint16(0), input, resLevel);
+            break;
+         case OSSIM_SINT16:
+            calibrate(ossim_sint16(0), input, resLevel);
+            break;
+         case OSSIM_UINT32:
+            calibrate(ossim_uint32(0), input, resLevel);
+            break;
+         case OSSIM_SINT32:
+            calibrate(ossim_sint32(0), input, resLevel);
+            break;
+         case OSSIM_FLOAT32:
+         case OSSIM_NORMALIZED_FLOAT:
+            calibrate(ossim_float32(0), input, resLevel);
+            break;
+         case OSSIM_FLOAT64:
+         case OSSIM_NORMALIZED_DOUBLE:
+            calibrate(ossim_float64(0), input, resLevel);
+            break;
+         default:
+            return input;
+      }
+
+      m_tile->validate();
+      return m_tile;
+   }
+
+   template <class T>
+   void ossimSarCalibrationFilter::calibrate(T /* dummy */,
+                                             const ossimRefPtr<ossimImageData>& input,
+                                             ossim_uint32 resLevel)
+   {
+      const ossimIrect rect = input->getImageRectangle();
+      const ossim_uint32 w = rect.width();
+      const ossim_uint32 h = rect.height();
+      const bool checkNulls = (input->getDataObjectStatus() != OSSIM_FULL);
+      const ossim_float32 outNull = static_cast<ossim_float32>(m_tile->getNullPix(0));
+
+      // The coefficients are per full resolution column and line.
+      ossimDpt decimation(1.0, 1.0);
+      if ( resLevel )
+      {
+         theInputConnection->getDecimationFactor(resLevel, decimation);
+         if ( decimation.hasNans() || (decimation.x <= 0.0) || (decimation.y <= 0.0) )
+         {
+            decimation = ossimDpt(1.0, 1.0);
+         }
+      }
+      const bool fullRes = (decimation.x == 1.0) && (decimation.y == 1.0);
+      const ossim_int32 lastCol = static_cast<ossim_int32>(m_calibration.getWidth()) - 1;
+      const ossim_int32 x0 = rect.ul().x;
+      const bool inside = fullRes && (x0 >= 0) &&
+         (x0 + static_cast<ossim_int32>(w) - 1 <= lastCol);
+
+      m_re.resize(w);
+      m_im.resize(w);
+      if ( !inside )
+      {
+         m_gain.resize(w);
+         m_offset.resize(w);
+      }
+
+      const ossim_uint32 outBands = m_tile->getNumberOfBands();
+      std::shared_ptr<const ossimSarCalibration::Block> block;
+      ossim_uint32 blockLine = 0;
+
+      for ( ossim_uint32 y = 0; y < h; ++y )
+      {
+         const double fullLine = std::floor( (rect.ul().y + static_cast<double>(y)) /
+                                             decimation.y + 0.5 );
+         const ossim_uint32 line = (fullLine > 0.0) ? static_cast<ossim_uint32>(fullLine) : 0;
+         if ( !block || ( (line / m_blockLines) != (blockLine / m_blockLines) ) )
+         {
+            block = m_calibration.getBlock(line);
+            blockLine = line;
+         }
+         if ( !block )
+         {
+            continue; // Left null.
+         }
+
+         const ossim_float32* gain   = 0;
+         const ossim_float32* offset = 0;
+         if ( inside )
+         {
+            gain   = &block->m_gain[x0];
+            offset = &block->m_offset[x0];
+         }
+         else
+         {
+            for ( ossim_uint32 x = 0; x < w; ++x )
+            {
+               double c = std::floor( (x0 + static_cast<double>(x)) / decimation.x + 0.5 );
+               ossim_int32 col = (c < 0.0) ? 0 : ( (c > lastCol) ? lastCol :
+                                                   static_cast<ossim_int32>(c) );
+               m_gain[x]   = block->m_gain[col];
+               m_offset[x] = block->m_offset[col];
+            }
+            gain   = &m_gain.front();
+            offset = &m_offset.front();
+         }
+
+         for ( ossim_uint32 band = 0; band < outBands; ++band )
+         {
+            ossim_float32* out = static_cast<ossim_float32*>(m_tile->getBuf(band)) + y * w;
+            if ( m_complex )
+            {
+               const T* re = static_cast<const T*>(input->getBuf(0)) + y * w;
+               const T* im = static_cast<const T*>(input->getBuf(1)) + y * w;
+               toFloat(re, &m_re.front(), w);
+               toFloat(im, &m_im.front(), w);
+               ossimSarCalibration::applyComplex(&m_re.front(), &m_im.front(),
+                                                 gain, offset, out, w);
+               if ( checkNulls )
+               {
+                  const T nullRe = static_cast<T>(input->getNullPix(0));
+                  const T nullIm = static_cast<T>(input->getNullPix(1));
+                  for ( ossim_uint32 x = 0; x < w; ++x )
+                  {
+                     if ( (re[x] == nullRe) && (im[x] == nullIm) )
+                     {
+                        out[x] = outNull;
+                     }
+                  }
+               }
+            }
+            else
+            {
+               const T* dn = static_cast<const T*>(input->getBuf(band)) + y * w;
+               toFloat(dn, &m_re.front(), w);
+               ossimSarCalibration::applyDetected(&m_re.front(), gain, offset, out, w);
+               if ( checkNulls )
+               {
+                  const T nullDn = static_cast<T>(input->getNullPix(band));
+                  for ( ossim_uint32 x = 0; x < w; ++x )
+                  {
+                     if ( dn[x] == nullDn )
+                     {
+                        out[x] = outNull;
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   void ossimSarCalibrationFilter::initialize()
+   {
+      ossimImageSourceFilter::initialize();
+
+      m_ready    = false;
+      m_complex  = false;
+      m_tile     = 0;
+      m_geometry = 0;
+      m_calibration.initialize(0, m_measure, m_removeNoise, 0, m_blockLines);
+
+      if ( !theInputConnection )
+      {
+         return;
+      }
+
+      m_geometry = theInputConnection->getImageGeometry();
+      const ossimGeometricSarSensorModel* model = 0;
+      if ( m_geometry.valid() )
+      {
+         model = dynamic_cast<const ossimGeometricSarSensorModel*>(
+            m_geometry->getProjection() );
+      }
+
+      //---
+      // The product type says if the pixels are complex; two bands may as
+      // well be two detected polarisations.
+      //---
+      if ( model && model->isComplex() )
+      {
+         if ( theInputConnection->getNumberOfOutputBands() == 2 )
+         {
+            m_complex = true;
+         }
+         else
+         {
+            ossimNotify(ossimNotifyLevel_WARN)
+               << "ossimSarCalibrationFilter::initialize WARNING:"
+               << "\nComplex product read as "
+               << theInputConnection->getNumberOfOutputBands()
+               << " bands, not I and Q; calibrating each as detected."
+               << std::endl;
+         }
+      }
+
+      const ossimIrect rect = theInputConnection->getBoundingRect(0);
+      const ossim_uint32 width = rect.hasNans() ? 0 : rect.lr().x + 1;
+      m_ready = m_calibration.initialize(model, m_measure, m_removeNoise, width, m_blockLines);
+
+      if ( traceDebug() )
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "ossimSarCalibrationFilter::initialize DEBUG:"
+            << "\nmodel:    " << (model ? model->getClassName().c_str() : "none")
+            << "\nmeasure:  " << ossimSarCalibration::measureToString(m_measure)
+            << "\ncomplex:  " << (m_complex ? "true" : "false")
+            << "\nsimd:     " << (ossimSarCalibration::simdSupported() ? "true" : "false")
+            << "\nready:    " << (m_ready ? "true" : "false") << std::endl;
+      }
+   }
+
+   bool ossimSarCalibrationFilter::isCalibrating() const
+   {
+      return m_ready && theInputConnection && isSourceEnabled();
+   }
+
+   ossimScalarType ossimSarCalibrationFilter::getOutputScalarType() const
+   {
+      if ( isCalibrating() )
+      {
+         return OSSIM_FLOAT32;
+      }
+      return ossimImageSourceFilter::getOutputScalarType();
+   }
+
+   ossim_uint32 ossimSarCalibrationFilter::getNumberOfOutputBands() const
+   {
+      if ( isCalibrating() && m_complex )
+      {
+         return 1;
+      }
+      return ossimImageSourceFilter::getNumberOfOutputBands();
+   }
+
+   double ossimSarCalibrationFilter::getNullPixelValue(ossim_uint32 band) const
+   {
+      if ( isCalibrating() )
+      {
+         return ossim::defaultNull(OSSIM_FLOAT32);
+      }
+      return ossimImageSourceFilter::getNullPixelValue(band);
+   }
+
+   double ossimSarCalibrationFilter::getMinPixelValue(ossim_uint32 band) const
+   {
+      if ( isCalibrating() )
+      {
+         // Negative where the noise floor is above the signal.
+         return ossim::defaultMin(OSSIM_FLOAT32);
+      }
+      return ossimImageSourceFilter::getMinPixelValue(band);
+   }
+
+   double ossimSarCalibrationFilter::getMaxPixelValue(ossim_uint32 band) const
+   {
+      if ( isCalibrating() )
+      {
+         return ossim::defaultMax(OSSIM_FLOAT32);
+      }
+      return ossimImageSourceFilter::getMaxPixelValue(band);
+   }
+
+   void ossimSarCalibrationFilter::setMeasure(ossimSarCalibration::Measure measure)
+   {
+      if ( measure != m_measure )
+      {
+         m_measure = measure;
+         initialize();
+      }
+   }
+
+   ossimSarCalibration::Measure ossimSarCalibrationFilter::getMeasure() const
+   {
+      return m_measure;
+   }
+
+   void ossimSarCalibrationFilter::setRemoveNoise(bool flag)
+   {
+      if ( flag != m_removeNoise )
+      {
+         m_removeNoise = flag;
+         initialize();
+      }
+   }
+
+   bool ossimSarCalibrationFilter::getRemoveNoise() const
+   {
+      return m_removeNoise;
+   }
+
+   void ossimSarCalibrationFilter::setAzimuthBlockSize(ossim_uint32 lines)
+   {
+      if ( lines && (lines != m_blockLines) )
+      {
+         m_blockLines = lines;
+         initialize();
+      }
+   }
+
+   ossim_uint32 ossimSarCalibrationFilter::getAzimuthBlockSize() const
+   {
+      return m_blockLines;
+   }
+
+   void ossimSarCalibrationFilter::setProperty(ossimRefPtr<ossimProperty> property)
+   {
+      if ( !property.valid() )
+      {
+         return;
+      }
+
+      ossimString name = property->getName();
+      if ( name == MEASURE_KW )
+      {
+         ossimSarCalibration::Measure measure;
+         if ( ossimSarCalibration::stringToMeasure(property->valueToString(), measure) )
+         {
+            setMeasure(measure);
+         }
+      }
+      else if ( name == REMOVE_NOISE_KW )
+      {
+         setRemoveNoise(property->valueToString().toBool());
+      }
+      else if ( name == AZIMUTH_BLOCK_SIZE_KW )
+      {
+         setAzimuthBlockSize(property->valueToString().toUInt32());
+      }
+      else
+      {
+         ossimImageSourceFilter::setProperty(property);
+      }
+   }
+
+   ossimRefPtr<ossimProperty> ossimSarCalibrationFilter::getProperty(const ossimString& name) const
+   {
+      ossimRefPtr<ossimProperty> result = 0;
+      if ( name == MEASURE_KW )
+      {
+         std::vector<ossimString> constraints;
+         constraints.push_back(ossimSarCalibration::measureToString(ossimSarCalibration::SIGMA0));
+         constraints.push_back(ossimSarCalibration::measureToString(ossimSarCalibration::BETA0));
+         constraints.push_back(ossimSarCalibration::measureToString(ossimSarCalibration::GAMMA0));
+         result = new ossimStringProperty(name,
+                                          ossimSarCalibration::measureToString(m_measure),
+                                          false,
+                                          constraints);
+      }
+      else if ( name == REMOVE_NOISE_KW )
+      {
+         result = new ossimBooleanProperty(name, m_removeNoise);
+      }
+      else if ( name == AZIMUTH_BLOCK_SIZE_KW )
+      {
+         ossimNumericProperty* p = new ossimNumericProperty(name,
+                                                            ossimString::toString(m_blockLines),
+                                                            1, 65536);
+         p->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+         result = p;
+      }
+      else
+      {
+         return ossimImageSourceFilter::getProperty(name);
+      }
+      result->setCacheRefreshBit();
+      return result;
+   }
+
+   void ossimSarCalibrationFilter::getPropertyNames(std::vector<ossimString>& propertyNames) const
+   {
+      ossimImageSourceFilter::getPropertyNames(propertyNames);
+      propertyNames.push_back(MEASURE_KW);
+      propertyNames.push_back(REMOVE_NOISE_KW);
+      propertyNames.push_back(AZIMUTH_BLOCK_SIZE_KW);
+   }
+
+   bool ossimSarCalibrationFilter::saveState(ossimKeywordlist& kwl, const char* prefix) const
+   {
+      kwl.add(prefix, MEASURE_KW, ossimSarCalibration::measureToString(m_measure), true);
+      kwl.add(prefix, REMOVE_NOISE_KW, (m_removeNoise ? "true" : "false"), true);
+      kwl.add(prefix, AZIMUTH_BLOCK_SIZE_KW, m_blockLines, true);
+      return ossimImageSourceFilter::saveState(kwl, prefix);
+   }
+
+   bool ossimSarCalibrationFilter::loadState(const ossimKeywordlist& kwl, const char* prefix)
+   {
+      bool result = ossimImageSourceFilter::loadState(kwl, prefix);
+
+      const char* lookup = kwl.find(prefix, MEASURE_KW);
+      if ( lookup )
+      {
+         ossimSarCalibration::Measure measure;
+         if ( ossimSarCalibration::stringToMeasure(ossimString(lookup), measure) )
+         {
+            m_measure = measure;
+         }
+      }
+      lookup = kwl.find(prefix, REMOVE_NOISE_KW);
+      if ( lookup )
+      {
+         m_removeNoise = ossimString(lookup).toBool();
+      }
+      lookup = kwl.find(prefix, AZIMUTH_BLOCK_SIZE_KW);
+      if ( lookup )
+      {
+         ossim_uint32 lines = ossimString(lookup).toUInt32();
+         m_blockLines = lines ? lines : DEFAULT_BLOCK_LINES;
+      }
+
+      initialize();
+      return result;
+   }
+
+} // End: namespace ossimplugins
@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Tile filter computing sigma0, beta0 or gamma0 from a SAR
+// image opened with one of the plugin sensor models.
+//
+// The input is either detected (each band is an amplitude) or complex,
+// i.e. two bands holding I and Q, which give one output band.  Which it is
+// comes from the sensor model's product type.  The output is float.  Without
+// a model that has calibration data the filter passes its input through.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimSarCalibrationFilter_HEADER
+#define ossimSarCalibrationFilter_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/imaging/ossimImageSourceFilter.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossimSarCalibration.h>
+
+#include <vector>
+
+namespace ossimplugins
+{
+   class OSSIM_PLUGINS_DLL ossimSarCalibrationFilter : public ossimImageSourceFilter
+   {
+   public:
+      ossimSarCalibrationFilter();
+
+      virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& tileRect,
+                                                  ossim_uint32 resLevel=0);
+
+      virtual void initialize();
+
+      virtual ossimScalarType getOutputScalarType() const;
+      virtual ossim_uint32 getNumberOfOutputBands() const;
+      virtual double getNullPixelValue(ossim_uint32 band=0) const;
+      virtual double getMinPixelValue(ossim_uint32 band=0) const;
+      virtual double getMaxPixelValue(ossim_uint32 band=0) const;
+
+      void setMeasure(ossimSarCalibration::Measure measure);
+      ossimSarCalibration::Measure getMeasure() const;
+
+      void setRemoveNoise(bool flag);
+      bool getRemoveNoise() const;
+
+      /** @brief Lines sharing one evaluation of the calibration. */
+      void setAzimuthBlockSize(ossim_uint32 lines);
+      ossim_uint32 getAzimuthBlockSize() const;
+
+      virtual void setProperty(ossimRefPtr<ossimProperty> property);
+      virtual ossimRefPtr<ossimProperty> getProperty(const ossimString& name) const;
+      virtual void getPropertyNames(std::vector<ossimString>& propertyNames) const;
+
+      virtual bool saveState(ossimKeywordlist& kwl, const char* prefix=0) const;
+      virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
+
+   protected:
+      virtual ~ossimSarCalibrationFilter();
+
+   private:
+      /** @return true if the calibration is set up and the filter enabled. */
+      bool isCalibrating() const;
+
+      /** @brief Calibrates input into m_tile. */
+      template <class T> void calibrate(T dummy,
+                                        const ossimRefPtr<ossimImageData>& input,
+                                        ossim_uint32 resLevel);
+
+      ossimSarCalibration::Measure m_measure;
+      bool                         m_removeNoise;
+      ossim_uint32                 m_blockLines;
+
+      bool                         m_ready;
+      bool                         m_complex;
+      ossimRefPtr<ossimImageGeometry> m_geometry; // Owns the model.
+      ossimSarCalibration          m_calibration;
+      ossimRefPtr<ossimImageData>  m_tile;
+
+      // Line buffers.
+      std::vector<ossim_float32>   m_re;
+      std::vector<ossim_float32>   m_im;
+      std::vector<ossim_float32>   m_gain;
+      std::vector<ossim_float32>   m_offset;
+
+      TYPE_DATA
+   };
+}
+
+#endif /* #ifndef ossimSarCalibrationFilter_HEADER */
@@ -29,6 +29,7 @@
 #include <ossim/plugin/ossimPluginConstants.h>
 
 #include <ossim/projection/ossimRpcModel.h>
+#include <ossimProjectionGridCache.h>
 #include "ossimSpot6DimapSupportData.h"
 
 #include <ossim/base/ossimFilename.h>
@@ -78,6 +79,20 @@ namespace ossimplugins
       virtual bool loadState(const ossimKeywordlist& kwl,
                              const char* prefix=NULL);
 
+      /**
+       * @brief Image to ground.  Uses the projection cache if turned on,
+       * else ossimRpcModel::lineSampleHeightToWorld.  See
+       * ossimProjectionGridCache.
+       */
+      virtual void lineSampleHeightToWorld(const ossimDpt& image_point,
+                                           const double&   heightEllipsoid,
+                                           ossimGpt&       worldPoint) const;
+
+      /**
+       * @brief Drops the projection cache, then ossimRpcModel::updateModel.
+       */
+      virtual void updateModel();
+
       void setSupportData(ossimSpot6DimapSupportData* supportData)
       {
          theSupportData = supportData;
@@ -106,6 +121,8 @@ namespace ossimplugins
 
       ossimFilename _productXmlFile;
 
+      ossimProjectionGridCache::Holder theProjectionCache;
+
 
       TYPE_DATA
    };
@@ -29,6 +29,7 @@
 #include <otb/SensorParams.h>
 #include <otb/RefPoint.h>
 #include <otb/SarSensor.h>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <sstream>
@@ -173,6 +174,149 @@ double ossimplugins::ossimTerraSarModel::getSlantRangeFromGeoreferenced(double c
    return tn * (c/2.0);
 }
 
+bool ossimplugins::ossimTerraSarModel::getCalibrationCoefficients(
+   ossimSarCalibration::Measure measure,
+   bool                         removeNoise,
+   double                       line,
+   ossim_int32                  firstCol,
+   std::vector<double>&         gain,
+   std::vector<double>&         offset) const
+{
+   const double CLUM = 2.99792458e+8;
+
+   // Layer of this image, as in saveState.
+   ossim_uint32 polLayerIdx = 0;
+   for (ossim_uint32 idx = 0 ; idx < _polLayerList.size(); ++idx)
+   {
+      if (_polLayerList[idx] == _polLayer)
+      {
+         polLayerIdx = idx;
+      }
+   }
+   if ( (polLayerIdx >= _calFactor.size()) || (_calFactor[polLayerIdx] <= 0.0) )
+   {
+      return false;
+   }
+   const double ks = _calFactor[polLayerIdx];
+
+   //---
+   // Incidence angle, linear in the column: least squares fit on the
+   // scene center and corners.  Not needed for beta0.
+   //---
+   double theta0 = 0.0;
+   double dTheta = 0.0;
+   if (measure != ossimSarCalibration::BETA0)
+   {
+      if (!_sceneCoord)
+      {
+         return false;
+      }
+      std::vector<InfoSceneCoord> points = _sceneCoord->get_cornersSceneCoord();
+      points.push_back(_sceneCoord->get_centerSceneCoord());
+
+      double n = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+      for (ossim_uint32 i = 0; i < points.size(); ++i)
+      {
+         const double x = points[i].get_refColumn();
+         const double y = points[i].get_incidenceAngle();
+         if (y <= 0.0)
+         {
+            continue; // Not set.
+         }
+         n += 1.0; sx += x; sy += y; sxx += x * x; sxy += x * y;
+      }
+      if (n == 0.0)
+      {
+         return false;
+      }
+      const double det = n * sxx - sx * sx;
+      dTheta = (std::fabs(det) > 1.0e-12) ? (n * sxy - sx * sy) / det : 0.0;
+      theta0 = (sy - dTheta * sx) / n;
+      theta0 *= M_PI / 180.0;
+      dTheta *= M_PI / 180.0;
+   }
+
+   //---
+   // Noise: the record closest in time to the line.  Its polynomial gives
+   // the noise equivalent beta naught over ks as a function of the range
+   // time.
+   //---
+   const ImageNoise* imageNoise = 0;
+   if ( removeNoise && (polLayerIdx < _noise.size()) && _sensor && _refPoint )
+   {
+      const std::vector<ImageNoise>& records = _noise[polLayerIdx].get_imageNoise();
+      const JSDDateTime lineTime = getTime(line);
+      double best = -1.0;
+      for (ossim_uint32 i = 0; i < records.size(); ++i)
+      {
+         CivilDateTime civil;
+         if ( !ossim::iso8601TimeStringToCivilDate(records[i].get_timeUTC(), civil) )
+         {
+            continue;
+         }
+         JSDDateTime t(civil);
+         const double dt = std::fabs(
+            (t.get_day0hTU().get_julianDate() - lineTime.get_day0hTU().get_julianDate()) * 86400.0
+            + (t.get_second() - lineTime.get_second())
+            + (t.get_decimal() - lineTime.get_decimal()) );
+         if ( (best < 0.0) || (dt < best) )
+         {
+            best = dt;
+            imageNoise = &records[i];
+         }
+      }
+   }
+
+   offset.resize(gain.size());
+   for (ossim_uint32 c = 0; c < gain.size(); ++c)
+   {
+      const double col = firstCol + static_cast<double>(c);
+
+      double f = 1.0;
+      if (measure != ossimSarCalibration::BETA0)
+      {
+         const double theta = theta0 + dTheta * col;
+         f = (measure == ossimSarCalibration::SIGMA0) ? std::sin(theta) : std::tan(theta);
+      }
+
+      double nebn = 0.0;
+      if (imageNoise)
+      {
+         double slantRange = 0.0;
+         if (_isProductGeoreferenced)
+         {
+            slantRange = getSlantRangeFromGeoreferenced(col);
+         }
+         else
+         {
+            slantRange = getSlantRange(col);
+         }
+         double tau = 2.0 * slantRange / CLUM;
+         tau = std::max(tau, imageNoise->get_validityRangeMin());
+         tau = std::min(tau, imageNoise->get_validityRangeMax());
+         tau -= imageNoise->get_referencePoint();
+
+         const std::vector<double>& coeffs = imageNoise->get_polynomialCoefficients();
+         for (ossim_int32 i = static_cast<ossim_int32>(coeffs.size()) - 1; i >= 0; --i)
+         {
+            nebn = nebn * tau + coeffs[i];
+         }
+      }
+
+      // beta0 = ks * (DN^2 - NEBN), sigma0 = beta0 * sin, gamma0 = beta0 * tan
+      gain[c]   = ks * f;
+      offset[c] = -ks * nebn * f;
+   }
+
+   return true;
+}
+
+bool ossimplugins::ossimTerraSarModel::isComplex() const
+{
+   // Single look slant range complex, e.g. "SSC______SM_S_SRA":
+   return _productType.contains("SSC");
+}
+
 bool ossimplugins::ossimTerraSarModel::open(const ossimFilename& file)
 {
    static const char MODULE[] = "ossimplugins::ossimTerraSarModel::open() -- ";
@@ -454,6 +598,12 @@ bool ossimplugins::ossimTerraSarModel::loadState (const ossimKeywordlist &kwl,
 
    if (result)
    {
+      lookup = kwl.find(prefix, PRODUCT_TYPE);
+      if (lookup)
+      {
+         _productType = lookup;
+      }
+
       lookup = kwl.find(prefix,SR_GR_R0_KW);
       if (lookup)
       {
@@ -833,6 +983,8 @@ bool ossimplugins::ossimTerraSarModel::loadState (const ossimKeywordlist &kwl,
          << std::endl;
    }
    
+   resetProjectionCache();
+
    return result;
 }
 
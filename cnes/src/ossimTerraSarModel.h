@@ -70,6 +70,21 @@ namespace ossimplugins
        */
       virtual double getSlantRangeFromGeoreferenced(double col) const;
 
+      /**
+       * @brief Calibration constant of the image layer, incidence angle
+       * fitted on the scene coordinates, and the noise record closest in
+       * time to line.
+       */
+      virtual bool getCalibrationCoefficients(ossimSarCalibration::Measure measure,
+                                              bool removeNoise,
+                                              double line,
+                                              ossim_int32 firstCol,
+                                              std::vector<double>& gain,
+                                              std::vector<double>& offset) const;
+
+      /** @brief True for SSC products. */
+      virtual bool isComplex() const;
+
       /**
        * @brief Method to intantial model from a file.  Attempts to find the
        * required xml file.
@@ -12,6 +12,7 @@
 #include <otb/HermiteInterpolator.h>
 
 #include <string>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -21,6 +22,8 @@ namespace ossimplugins
 
 HermiteInterpolator::HermiteInterpolator():
   theNPointsAvailable(0),
+  theWindowSize(0),
+  theNWindows(0),
   theXValues(NULL),
   theYValues(NULL),
   thedYValues(NULL),
@@ -30,8 +33,11 @@ HermiteInterpolator::HermiteInterpolator():
 {
 }
 
-HermiteInterpolator::HermiteInterpolator(int nbrPoints, double* x, double* y, double* dy):
+HermiteInterpolator::HermiteInterpolator(int nbrPoints, double* x, double* y, double* dy,
+                                         int windowSize):
   theNPointsAvailable(nbrPoints),
+  theWindowSize(windowSize),
+  theNWindows(0),
    prodC(NULL),
    sumC(NULL),
   isComputed(false)
@@ -88,6 +94,8 @@ HermiteInterpolator::HermiteInterpolator(int nbrPoints, double* x, double* y, do
 //      std::cerr << "WARNING: Hermite interpolation assumes increasing x values" << std::endl;
     assert(theXValues[i] > theXValues[i-1]);
   }
+
+  Precompute();
 }
 
 HermiteInterpolator::~HermiteInterpolator()
@@ -97,6 +105,8 @@ HermiteInterpolator::~HermiteInterpolator()
 
 HermiteInterpolator::HermiteInterpolator(const HermiteInterpolator& rhs):
   theNPointsAvailable(rhs.theNPointsAvailable),
+  theWindowSize(rhs.theWindowSize),
+  theNWindows(0),
   prodC(NULL),
   sumC(NULL),
   isComputed(false)
@@ -139,12 +149,19 @@ HermiteInterpolator::HermiteInterpolator(const HermiteInterpolator& rhs):
   {
     thedYValues = NULL;
   }
+
+  Precompute();
 }
 
 HermiteInterpolator& HermiteInterpolator::operator =(const HermiteInterpolator& rhs)
 {
+  if (this == &rhs)
+  {
+    return *this;
+  }
   Clear();
   theNPointsAvailable = rhs.theNPointsAvailable;
+  theWindowSize = rhs.theWindowSize;
   isComputed = false;
   if(rhs.theXValues != NULL)
   {
@@ -184,9 +201,8 @@ HermiteInterpolator& HermiteInterpolator::operator =(const HermiteInterpolator&
   {
     thedYValues = NULL;
   }
-  prodC = NULL; 
-  sumC = NULL;
-   
+  Precompute();
+
   return *this;
 }
 
@@ -203,13 +219,16 @@ int HermiteInterpolator::Interpolate(double x, double& y, double& dy) const
 
   double epsilon = 0.0000000000001;
 
-  //Precompute useful value if they are not available
-  if (!isComputed)
-  {
-    Precompute();
-  }
+  // Coefficients are built by the constructors so calls never modify the
+  // object and may be made from several threads.
+  if (!isComputed) return -1;
+
+  const int first = FindWindow(x);
+  const int last = first + theWindowSize;
+  const double* windowProdC = prodC + (first * theWindowSize - first);
+  const double* windowSumC = sumC + (first * theWindowSize - first);
 
-  for (int i = 0; i < theNPointsAvailable; i++)
+  for (int i = first; i < last; i++)
   {
     double si = 0.0;
     double hi = 1.0;
@@ -224,7 +243,7 @@ int HermiteInterpolator::Interpolate(double x, double& y, double& dy) const
       return 0;
     }
 
-    for (int j = 0; j < theNPointsAvailable; j++)
+    for (int j = first; j < last; j++)
     {
       if (j != i)
       {
@@ -232,8 +251,8 @@ int HermiteInterpolator::Interpolate(double x, double& y, double& dy) const
         ui = ui + 1 / (x - theXValues[j]);//derivative computation
       }
     }
-    hi *= prodC[i];
-    si = sumC[i];
+    hi *= windowProdC[i];
+    si = windowSumC[i];
 
     double f = 1.0 - 2.0 * r * si;
 
@@ -263,27 +282,30 @@ int HermiteInterpolator::Interpolate(double x, double& y) const
 
   y = 0.0;
 
-  //Precompute useful value if they are not available
-  if (!isComputed)
-  {
-    Precompute();
-  }
+  // Coefficients are built by the constructors so calls never modify the
+  // object and may be made from several threads.
+  if (!isComputed) return -1;
 
-  for (int i = 0; i < theNPointsAvailable; i++)
+  const int first = FindWindow(x);
+  const int last = first + theWindowSize;
+  const double* windowProdC = prodC + (first * theWindowSize - first);
+  const double* windowSumC = sumC + (first * theWindowSize - first);
+
+  for (int i = first; i < last; i++)
   {
     double si = 0.0;
     double hi = 1.0;
     double r = x - theXValues[i];
 
-    for (int j = 0; j < theNPointsAvailable; j++)
+    for (int j = first; j < last; j++)
     {
       if (j != i)
       {
         hi = hi * (x - theXValues[j]);
       }
     }
-    hi *= prodC[i];
-    si = sumC[i];
+    hi *= windowProdC[i];
+    si = windowSumC[i];
 
     double f = 1.0 - 2.0 * r * si;
 
@@ -294,22 +316,40 @@ int HermiteInterpolator::Interpolate(double x, double& y) const
   return 0;
 }
 
-int HermiteInterpolator::Precompute() const
+int HermiteInterpolator::Precompute()
 {
-  prodC = new double[theNPointsAvailable];
-  sumC= new double[theNPointsAvailable];
+  if ((theNPointsAvailable < 2) || (theXValues == NULL))
+  {
+    return -1;
+  }
+
+  if ((theWindowSize <= 0) || (theWindowSize > theNPointsAvailable))
+  {
+    theWindowSize = theNPointsAvailable;
+  }
+  theNWindows = theNPointsAvailable - theWindowSize + 1;
 
-  for (int i = 0; i < theNPointsAvailable; i++)
+  delete[] prodC;
+  delete[] sumC;
+  prodC = new double[theNWindows * theWindowSize];
+  sumC = new double[theNWindows * theWindowSize];
+
+  for (int w = 0; w < theNWindows; w++)
   {
-    prodC[i] = 1;
-    sumC[i] = 0;
-    for (int j = 0; j < theNPointsAvailable; j++)
+    double* windowProdC = prodC + w * theWindowSize;
+    double* windowSumC = sumC + w * theWindowSize;
+    for (int i = 0; i < theWindowSize; i++)
     {
-      if (j != i)
+      windowProdC[i] = 1;
+      windowSumC[i] = 0;
+      for (int j = 0; j < theWindowSize; j++)
       {
-        double v = 1.0 / (theXValues[i] - theXValues[j]);
-        prodC[i] *= v;
-        sumC[i]  += v;
+        if (j != i)
+        {
+          double v = 1.0 / (theXValues[w + i] - theXValues[w + j]);
+          windowProdC[i] *= v;
+          windowSumC[i]  += v;
+        }
       }
     }
   }
@@ -317,6 +357,33 @@ int HermiteInterpolator::Precompute() const
   return 0;
 }
 
+int HermiteInterpolator::FindWindow(double x) const
+{
+  if (theNWindows <= 1)
+  {
+    return 0;
+  }
+
+  // Interval [k, k+1] holding x, then center the window on it.
+  int k = static_cast<int>(std::upper_bound(theXValues, theXValues + theNPointsAvailable, x)
+                           - theXValues) - 1;
+  int first = k - (theWindowSize / 2 - 1);
+  if (first < 0)
+  {
+    first = 0;
+  }
+  else if (first > theNWindows - 1)
+  {
+    first = theNWindows - 1;
+  }
+  return first;
+}
+
+int HermiteInterpolator::GetWindowSize() const
+{
+  return theWindowSize;
+}
+
 void HermiteInterpolator::Clear()
 {
   if (theXValues != NULL)
@@ -346,9 +413,10 @@ void HermiteInterpolator::Clear()
   if (sumC != NULL)
   {
     delete[] sumC;
-    prodC = NULL;
+    sumC = NULL;
   }
   isComputed = false;
   theNPointsAvailable = 0;
+  theNWindows = 0;
 }
 }
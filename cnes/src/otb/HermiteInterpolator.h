@@ -21,6 +21,13 @@ namespace ossimplugins
 
 /**
  * @brief Abstract interpolator
+ *
+ * By default every point takes part in each interpolation, which costs
+ * O(N^2) per call.  With a window size K only the K points around the
+ * interval holding x are used: the interval is found by binary search and
+ * the coefficients for every window are computed once up front, so a call
+ * is O(K^2 + log N).
+ *
  * @see Interpolate
  */
 class OSSIM_PLUGINS_DLL HermiteInterpolator
@@ -37,8 +44,11 @@ public:
     * @param x Values of the points abscissa
     * @param y Values of the points
     * @param dy Values of the differential coefficients
+    * @param windowSize Number of points used for each interpolation, 0 or
+    * anything not less than nbrPoints for all of them
     */
-   HermiteInterpolator(int nbrPoints, double* x, double* y, double* dy);
+   HermiteInterpolator(int nbrPoints, double* x, double* y, double* dy,
+                       int windowSize = 0);
 
    /**
     * @brief Destructor
@@ -72,19 +82,33 @@ public:
     */
    int Interpolate(double x, double& y) const;
 
+   /**
+    * @return Number of points used for each interpolation
+    */
+   int GetWindowSize() const;
+
 protected:
 
    void Clear();
+
+   /**
+    * @brief Index of the first point of the window used for abscissa x
+    */
+   int FindWindow(double x) const;
+
    int theNPointsAvailable;
+   int theWindowSize;
+   int theNWindows;
    double* theXValues;
    double* theYValues;
    double* thedYValues;
 
-   mutable double* prodC;
-   mutable double* sumC;
-   mutable bool isComputed;
+   // Coefficients of window w, point i are at [w*theWindowSize + i].
+   double* prodC;
+   double* sumC;
+   bool isComputed;
 
-   int Precompute() const; // const in a semantic way
+   int Precompute();
 
 
 private:
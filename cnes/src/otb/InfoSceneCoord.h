@@ -93,6 +93,19 @@ public:
       _incidenceAngle = value;
    }
 
+   ossim_uint32 get_refRow() const
+   {
+      return _refRow;
+   }
+   ossim_uint32 get_refColumn() const
+   {
+      return _refColumn;
+   }
+   double get_incidenceAngle() const
+   {
+      return _incidenceAngle;
+   }
+
 
 protected:
 
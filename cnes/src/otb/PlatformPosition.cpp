@@ -25,6 +25,13 @@ namespace ossimplugins
 
 static const char NUMBER_PLATFORM_POSITIONS_KW[] = "platform_positions_count";
 
+/*
+ * Number of ephemeris around the date used by the interpolation.  Products
+ * carry up to a few hundred state vectors; using all of them costs O(N^2)
+ * per call and adds nothing to the accuracy.
+ */
+static const int INTERPOLATION_WINDOW_SIZE = 8;
+
 PlatformPosition::PlatformPosition():
    _nbrData(0),
    _data(NULL),
@@ -47,25 +54,29 @@ void PlatformPosition::Clear()
       for (int i=0;i<_nbrData;i++)
       {
          delete _data[i];
-            }
-         delete [] _data;
-            }
-      _data = NULL;
-         _nbrData = 0;
-            
-            delete[] _t;
-               if ((_p != NULL) && (_dp != NULL)) {
-                  for (int j=0; j<3; ++j) {
-                     delete[] _p[j];
-                        delete[] _dp[j];
-                           delete _interpolator[j];
-                              }
-                     }
-                  delete[] _p;
-                     delete[] _dp;
-                        
-                        delete[] _interpolator;
-                           }
+      }
+      delete [] _data;
+   }
+   _data = NULL;
+   _nbrData = 0;
+
+   delete[] _t;
+   if ((_p != NULL) && (_dp != NULL)) {
+      for (int j=0; j<3; ++j) {
+         delete[] _p[j];
+         delete[] _dp[j];
+         delete _interpolator[j];
+      }
+   }
+   delete[] _p;
+   delete[] _dp;
+
+   delete[] _interpolator;
+   _t = NULL;
+   _p = NULL;
+   _dp = NULL;
+   _interpolator = NULL;
+}
 
 PlatformPosition::PlatformPosition(const PlatformPosition& rhs)
 {
@@ -123,68 +134,88 @@ void PlatformPosition::InitAuxiliaryData()
                                  _p[j][i] = _data[i]->get_position()[j];
                                     _dp[j][i] = _data[i]->get_speed()[j];
                                        }
-                                 _interpolator[j] = new HermiteInterpolator(_nbrData, _t, _p[j], _dp[j]);
+                                 _interpolator[j] = new HermiteInterpolator(_nbrData, _t, _p[j], _dp[j],
+                                                                   INTERPOLATION_WINDOW_SIZE);
                                     }
                               
                               }
 
 Ephemeris* PlatformPosition::Interpolate(JSDDateTime date) const
+{
+   if (_nbrData <= 1)
+   {
+      return NULL;
+   }
+   /*
+    * The first element of the list is cloned to ensure that the
+    * output ephemeris is expressed in the same coordinate system as
+    * input ones
+    */
+   Ephemeris* ephem = _data[0]->Clone();
+   if (ephem != NULL)
+   {
+      ephem->set_date(date);
+
+      double pos[3];
+      double speed[3];
+      Interpolate(date, pos, speed);
+      ephem->set_position(pos);
+      ephem->set_speed(speed);
+   }
+   return ephem;
+}
+
+bool PlatformPosition::Interpolate(const JSDDateTime& date, double* position, double* speed) const
+{
+   if (_nbrData <= 1)
+   {
+      return false;
+   }
+   return InterpolateDeltaTime(getDeltaTime(date), position, speed);
+}
+
+bool PlatformPosition::InterpolateDeltaTime(double dt, double* position, double* speed) const
+{
+   if (_nbrData <= 1)
+   {
+      return false;
+   }
+
+   /* Computation by Everett  */
+   /*---------------------*/
+   for (int j = 0; j < 3; j++)
+   {
+      _interpolator[j]->Interpolate(dt, position[j], speed[j]);
+   }
+   return true;
+}
+
+double PlatformPosition::getDeltaTime(const JSDDateTime& date) const
 {
    const double JOURCIVIL_LENGTH = 86400.0;
-      Ephemeris* ephem = NULL;
-         if (_nbrData <= 1)
-         {
-            return NULL;
-               }
-            /*
-             * The first element of the list is cloned to ensure that the
-             * output ephemeris is expressed in the same coordinate system as
-             * input ones
-             */
-            ephem = _data[0]->Clone();
-               
-               /* NORMAL CASE */
-               /*------------*/
-               double dt = 0.0;
-                  
-                  if (ephem != NULL)
-                  {
-                     ephem->set_date(date);
-                        
-                        dt =  (date.get_day0hTU().get_julianDate()
-                               - _data[0]->get_date().get_day0hTU().get_julianDate())
-                           * JOURCIVIL_LENGTH
-                           + date.get_second() - _data[0]->get_date().get_second()
-                           + date.get_decimal() - _data[0]->get_date().get_decimal();
-                           
-                           /* Computation by Everett  */
-                           /*---------------------*/
-                           double pos[3];
-                              double speed[3];
-                                 for (int j = 0; j < 3; j++)
-                                 {
-                                    _interpolator[j]->Interpolate(dt, pos[j], speed[j]);
-                                       }
-                                    ephem->set_position(pos);
-                                       ephem->set_speed(speed);
-                                          }
-                     return ephem;
-                        }
+   if (_nbrData < 1)
+   {
+      return 0.0;
+   }
 
-bool PlatformPosition::getPlatformPositionAtTime(JSDDateTime time, std::vector<double>& position, std::vector<double>& speed)
+   const JSDDateTime& date0 = _data[0]->get_date();
+   return (date.get_day0hTU().get_julianDate()
+           - date0.get_day0hTU().get_julianDate())
+      * JOURCIVIL_LENGTH
+      + date.get_second() - date0.get_second()
+      + date.get_decimal() - date0.get_decimal();
+}
+
+double PlatformPosition::getTimeSpan() const
+{
+   return (_nbrData > 1) ? _t[_nbrData - 1] : 0.0;
+}
+
+bool PlatformPosition::getPlatformPositionAtTime(JSDDateTime time, std::vector<double>& position, std::vector<double>& speed) const
 {
-   Ephemeris* ephemeris = this->Interpolate(time);
-   double* position_ptr = ephemeris->get_position();
-   double* speed_ptr = ephemeris->get_speed();
    if (position.size() != 3) position.resize(3);
    if (speed.size() != 3) speed.resize(3);
-   position[0] = position_ptr[0];
-   position[1] = position_ptr[1];
-   position[2] = position_ptr[2];
-   speed[0] = speed_ptr[0];
-   speed[1] = speed_ptr[1];
-   speed[2] = speed_ptr[2];
-   return true;
+   return Interpolate(time, &position[0], &speed[0]);
 }
    
 
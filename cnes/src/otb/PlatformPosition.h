@@ -68,13 +68,39 @@ namespace ossimplugins
        */
       Ephemeris* Interpolate(JSDDateTime date) const;
 
+      /**
+       * @brief This function interpolates its ephemeris to get the platform's position and speed
+       * without allocating anything
+       * @param date Date and time at wich the interpolation have to be done
+       * @param position [out] Three values, in the coordinate system of the ephemeris
+       * @param speed [out] Three values, in the coordinate system of the ephemeris
+       * @return true, or false if an error occurs
+       */
+      bool Interpolate(const JSDDateTime& date, double* position, double* speed) const;
+
+      /**
+       * @brief Same as Interpolate, with the date given as seconds from the first ephemeris
+       * @see getDeltaTime
+       */
+      bool InterpolateDeltaTime(double dt, double* position, double* speed) const;
+
+      /**
+       * @brief Seconds from the date of the first ephemeris to date
+       */
+      double getDeltaTime(const JSDDateTime& date) const;
+
+      /**
+       * @brief Seconds from the first to the last ephemeris
+       */
+      double getTimeSpan() const;
+
 
       /**
        * @brief This function interpolates its ephemeris to create and extract platform's position and speed
        * @param date Date and time at wich the interpolation have to be done
        * @return true, or false if an error occurs
        */
-      bool getPlatformPositionAtTime(JSDDateTime time, std::vector<double>& position, std::vector<double>& speed);
+      bool getPlatformPositionAtTime(JSDDateTime time, std::vector<double>& position, std::vector<double>& speed) const;
 
       PlatformPosition* Clone() const
       {
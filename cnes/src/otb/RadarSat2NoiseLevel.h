@@ -111,6 +111,22 @@ public:
    {
    		return _gain;
    }
+   ossim_uint32 get_pixelFirstNoiseValue() const
+   {
+   		return _pixelFirstNoiseValue;
+   }
+   ossim_uint32 get_stepSize() const
+   {
+   		return _stepSize;
+   }
+   const std::vector<ossim_float64> & get_noiseLevelValues() const
+   {
+   		return _noiseLevelValues;
+   }
+   ossim_float64 get_offset() const
+   {
+   		return _offset;
+   }
 
 protected:
 
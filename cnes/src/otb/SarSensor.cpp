@@ -19,6 +19,7 @@
 #include <otb/Equation.h>
 #include <otb/RectangularCoordinate.h>
 #include <otb/GeodesicCoordinate.h>
+#include <cmath>
 #include <complex>
 
 
@@ -35,47 +36,194 @@ SarSensor::~SarSensor()
 }
 
 int SarSensor::ImageToWorld(double distance, JSDDateTime time, double height, double& lon, double& lat) const
+{
+  return ImageToWorld(*_params, *_position, distance, time, height, lon, lat);
+}
+
+int SarSensor::ImageToWorld(const SensorParams& params, const PlatformPosition& position,
+                            double distance, const JSDDateTime& time, double height,
+                            double& lon, double& lat)
+{
+  double pos[3];
+  double speed[3];
+  if (!position.Interpolate(time, pos, speed))
+  {
+    return -1;
+  }
+  GeographicEphemeris geoEph(time, pos, speed);
+
+  return ImageToWorld(params, geoEph, distance, height, lon, lat);
+}
+
+int SarSensor::ImageToWorld(const SensorParams& params, const GeographicEphemeris& posSpeed,
+                            double distance, double height,
+                            double& lon, double& lat)
 {
   const double TWOPI      = 6.28318530717958647693 ;
 
-  double semiMajorAxis = _params->get_semiMajorAxis() ;  // default : WGS84
-  double semiMinorAxis = _params->get_semiMinorAxis() ; // default : WGS84
+  double semiMajorAxis = params.get_semiMajorAxis() ;  // default : WGS84
+  double semiMinorAxis = params.get_semiMinorAxis() ; // default : WGS84
 
-  double lambda = _params->get_rwl();
+  double lambda = params.get_rwl();
   int sensVisee ;
-  if (_params->get_sightDirection() == SensorParams::Right) sensVisee = 1 ;
+  if (params.get_sightDirection() == SensorParams::Right) sensVisee = 1 ;
   else sensVisee = -1 ;
 
-  Ephemeris* satPosition = _position->Interpolate(time);
-
-  GeographicEphemeris *geoEph = (GeographicEphemeris*)satPosition;
-
   RectangularCoordinate cart;
 
-  double dopplerCentroid = _params->get_dopcen();
-  double dopcenLinear = _params->get_dopcenLinear();
+  double dopplerCentroid = params.get_dopcen();
+  double dopcenLinear = params.get_dopcenLinear();
   if (dopcenLinear != 0.0)
   {
 	  dopplerCentroid += dopcenLinear * distance/1000; // Hz/km
   }
 
   // note : the Doppler frequency is set to zero
-  int etatLoc = localisationSAR(*geoEph, lambda, distance, dopplerCentroid, sensVisee, semiMajorAxis , semiMinorAxis , height, &cart);
+  int etatLoc = localisationSAR(posSpeed, lambda, distance, dopplerCentroid, sensVisee, semiMajorAxis , semiMinorAxis , height, &cart);
 
   GeodesicCoordinate geo;
   cart.AsGeodesicCoordinates(semiMajorAxis , semiMinorAxis, &geo);
   lon = (geo.get_x())*360.0/TWOPI;
   lat = (geo.get_y())*360.0/TWOPI;
 
-  delete satPosition;
-
   return etatLoc ;
 }
 
-int SarSensor::localisationSAR ( GeographicEphemeris posSpeed , double lambda ,
+int SarSensor::WorldToImage(const SensorParams& params, const PlatformPosition& position,
+                            double lon, double lat, double height,
+                            double& deltaTime, double& distance)
+{
+  const double PI             = 3.14159265358979323846 ;
+  const int    MAX_ITERATIONS = 20 ;
+  const double TIME_EPSILON   = 1.0e-9 ;  /* seconds */
+  const double HEIGHT_EPSILON = 1.0e-6 ;  /* meters */
+
+  double semiMajorAxis = params.get_semiMajorAxis() ;
+  double semiMinorAxis = params.get_semiMinorAxis() ;
+  double lambda        = params.get_rwl() ;
+  double dopcen        = params.get_dopcen() ;
+  double dopcenLinear  = params.get_dopcenLinear() ;
+  int sensVisee ;
+  if (params.get_sightDirection() == SensorParams::Right) sensVisee = 1 ;
+  else sensVisee = -1 ;
+
+  /*
+   * Ground point.  localisationSAR intersects the ellipsoid grown by height
+   * on both axes rather than the surface at that geodetic height, so take
+   * the point of this latitude/longitude on the same surface.
+   */
+  double phi    = lat * PI / 180.0 ;
+  double lam    = lon * PI / 180.0 ;
+  double cosPhi = cos(phi) ;
+  double sinPhi = sin(phi) ;
+  double cosLam = cos(lam) ;
+  double sinLam = sin(lam) ;
+  double e2     = 1.0 - (semiMinorAxis * semiMinorAxis) / (semiMajorAxis * semiMajorAxis) ;
+  double n      = semiMajorAxis / sqrt(1.0 - e2 * sinPhi * sinPhi) ;
+  double he2    = (semiMajorAxis + height) * (semiMajorAxis + height) ;
+  double hp2    = (semiMinorAxis + height) * (semiMinorAxis + height) ;
+
+  double ground[3] ;
+  double h = height ;
+  for (int i = 0 ; i < MAX_ITERATIONS ; i++)
+  {
+    ground[0] = (n + h) * cosPhi * cosLam ;
+    ground[1] = (n + h) * cosPhi * sinLam ;
+    ground[2] = (n * (1.0 - e2) + h) * sinPhi ;
+    double g  = (ground[0] * ground[0] + ground[1] * ground[1]) / he2
+              + ground[2] * ground[2] / hp2 - 1.0 ;
+    double dg = 2.0 * ((ground[0] * cosPhi * cosLam + ground[1] * cosPhi * sinLam) / he2
+                       + ground[2] * sinPhi / hp2) ;
+    double dh = g / dg ;
+    h -= dh ;
+    if (fabs(dh) < HEIGHT_EPSILON) break ;
+  }
+  ground[0] = (n + h) * cosPhi * cosLam ;
+  ground[1] = (n + h) * cosPhi * sinLam ;
+  ground[2] = (n * (1.0 - e2) + h) * sinPhi ;
+
+  /*
+   * Doppler equation, same convention as localisationSAR:
+   *   f(t) = V.(P - S) - lambda * R * fDop(R) / 2 = 0
+   */
+  double pos[3] ;
+  double speed[3] ;
+  double d[3] ;
+  double t = deltaTime ;
+  double f = 0.0 ;
+  double tPrev = 0.0 ;
+  double fPrev = 0.0 ;
+  double r = 0.0 ;
+  bool converged = false ;
+  for (int i = 0 ; i < MAX_ITERATIONS ; i++)
+  {
+    if (!position.InterpolateDeltaTime(t, pos, speed))
+    {
+      return 2 ;
+    }
+    d[0] = ground[0] - pos[0] ;
+    d[1] = ground[1] - pos[1] ;
+    d[2] = ground[2] - pos[2] ;
+    r = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) ;
+    f = speed[0] * d[0] + speed[1] * d[1] + speed[2] * d[2]
+      - lambda * r * (dopcen + dopcenLinear * r / 1000.0) / 2.0 ;
+
+    double df ;
+    if ((i == 0) || (t == tPrev))
+    {
+      df = - (speed[0] * speed[0] + speed[1] * speed[1] + speed[2] * speed[2]) ;
+    }
+    else
+    {
+      df = (f - fPrev) / (t - tPrev) ;
+    }
+    if (df == 0.0)
+    {
+      return 2 ;
+    }
+
+    double dt = f / df ;
+    tPrev = t ;
+    fPrev = f ;
+    t -= dt ;
+    if (fabs(dt) < TIME_EPSILON)
+    {
+      converged = true ;
+      break ;
+    }
+  }
+  if (!converged)
+  {
+    return 2 ;
+  }
+
+  /* Slant range at the solution */
+  if (!position.InterpolateDeltaTime(t, pos, speed))
+  {
+    return 2 ;
+  }
+  d[0] = ground[0] - pos[0] ;
+  d[1] = ground[1] - pos[1] ;
+  d[2] = ground[2] - pos[2] ;
+  deltaTime = t ;
+  distance  = sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) ;
+
+  /* Same side test as localisationSAR, which works with -V */
+  double u = pos[1] * speed[2] - pos[2] * speed[1] ;
+  double v = pos[2] * speed[0] - pos[0] * speed[2] ;
+  double w = pos[0] * speed[1] - pos[1] * speed[0] ;
+  if ((d[0] * u + d[1] * v + d[2] * w) * sensVisee > 0.0)
+  {
+    return 1 ;
+  }
+
+  return 0 ;
+}
+
+int SarSensor::localisationSAR ( const GeographicEphemeris& posSpeed , double lambda ,
                         double dist , double fDop , int sensVisee ,
                         double equRadius , double polRadius ,
-                        double h , RectangularCoordinate* cart ) const
+                        double h , RectangularCoordinate* cart )
 {
   double coordCart[3];
   coordCart[0]=0.0;
@@ -54,15 +54,55 @@ public:
    * @remark : the doppler frequency is set to zero in this implementation
    */
   virtual int ImageToWorld(double distance, JSDDateTime time, double height, double& lon, double& lat) const;
+
+  /**
+   * @brief Same as ImageToWorld, using params and position in place instead of
+   * copies.  Nothing is allocated or modified, so callers may share params and
+   * position between threads.
+   */
+  static int ImageToWorld(const SensorParams& params, const PlatformPosition& position,
+                          double distance, const JSDDateTime& time, double height,
+                          double& lon, double& lat);
+
+  /**
+   * @brief Same as ImageToWorld, with the platform position and speed at the
+   * azimuth time already interpolated.  Lets callers projecting several
+   * points of one line interpolate the orbit once.
+   */
+  static int ImageToWorld(const SensorParams& params, const GeographicEphemeris& posSpeed,
+                          double distance, double height,
+                          double& lon, double& lat);
+
+  /**
+   * @brief Inverse of ImageToWorld: finds the azimuth time at which the
+   * Doppler of the ground point equals the Doppler centroid, then the slant
+   * range at that time
+   *
+   * The time is found by Newton steps on the Doppler equation, the first
+   * using -|V|^2 as derivative and the rest the secant through the last two
+   * iterates.
+   *
+   * @param lon :       Longitude of the world point, degrees
+   * @param lat :       Latitude of the world point, degrees
+   * @param height :    Altitude of the world point
+   * @param deltaTime : [in] Starting guess, [out] azimuth time, both as
+   *                    seconds from the first ephemeris of position
+   * @retval distance : Slant range of the image point
+   * @return 0 on success, 1 if the point is not in the imaging direction,
+   *         2 if the iterations did not converge
+   */
+  static int WorldToImage(const SensorParams& params, const PlatformPosition& position,
+                          double lon, double lat, double height,
+                          double& deltaTime, double& distance);
 protected:
 
   /**
    * @brief This function is able to convert image coordinates into rectangular world coordinates
    */
-  int localisationSAR ( GeographicEphemeris posSpeed , double lambda ,
-                        double dist , double fDop , int sensVisee ,
-                        double equRadius , double polRadius ,
-                        double h , RectangularCoordinate* cart ) const;
+  static int localisationSAR ( const GeographicEphemeris& posSpeed , double lambda ,
+                               double dist , double fDop , int sensVisee ,
+                               double equRadius , double polRadius ,
+                               double h , RectangularCoordinate* cart );
 private:
 };
 
@@ -81,6 +81,14 @@ public:
   {
     _tabCornersSceneCoord = cornersSceneCoord;
   }
+  const InfoSceneCoord& get_centerSceneCoord() const
+  {
+    return _centerSceneCoord;
+  }
+  const std::vector<InfoSceneCoord>& get_cornersSceneCoord() const
+  {
+    return _tabCornersSceneCoord;
+  }
 
 protected:
 
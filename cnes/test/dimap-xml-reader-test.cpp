@@ -0,0 +1,305 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Tests for ossimDimapXmlReader: entities, CDATA, comments and attributes, pruning to the kept
+// paths, rejection of malformed and too deeply nested files, and the binary cache, including
+// several threads writing the same cache entry at once.
+//
+// Usage: dimap-xml-reader-test [work directory]
+
+#include "../src/ossimDimapXmlReader.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimDirectory.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/base/ossimXmlNode.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const char DOCUMENT[] =
+   "\xEF\xBB\xBF<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+   "<!-- Product -->\n"
+   "<Dimap_Document name=\"a &amp; b\" version='2.0'>\n"
+   "  <Metadata_Identification>\n"
+   "    <METADATA_FORMAT version=\"2.0\">DIMAP</METADATA_FORMAT>\n"
+   "  </Metadata_Identification>\n"
+   "  <Raster_Data>\n"
+   "    <Raster_Dimensions>\n"
+   "      <NROWS> 100 </NROWS>\n"
+   "      <NCOLS>200</NCOLS>\n"
+   "      <!-- comment <NBANDS>9</NBANDS> -->\n"
+   "      <NBANDS>4</NBANDS>\n"
+   "    </Raster_Dimensions>\n"
+   "    <Raster_Encoding><DATA_TYPE>&lt;x&gt; &#65;&#x42; &quot;q&quot;</DATA_TYPE></Raster_Encoding>\n"
+   "  </Raster_Data>\n"
+   "  <Geometric_Data>\n"
+   "    <Ephemeris><Point><X>1</X><Y>2</Y></Point><Point><X>3</X><Y>4</Y></Point></Ephemeris>\n"
+   "    <Note><![CDATA[<kept as is> & ]]>text</Note>\n"
+   "    <Empty flag=\"1\"/>\n"
+   "  </Geometric_Data>\n"
+   "</Dimap_Document>\n";
+
+static bool writeFile(const ossimFilename& file, const string& data)
+{
+   ofstream out(file.c_str(), ios::binary);
+   out << data;
+   return out.good();
+}
+
+static ossimRefPtr<ossimXmlNode> readRoot(const ossimFilename& file,
+                                          const char* const* keptPaths = 0)
+{
+   ossimRefPtr<ossimXmlNode> root;
+   ossimRefPtr<ossimXmlDocument> document = ossimDimapXmlReader::read(file, keptPaths);
+   if (document.valid())
+      root = document->getRoot();
+   return root;
+}
+
+static ossimString text(const ossimRefPtr<ossimXmlNode>& root, const char* xpath)
+{
+   ossimRefPtr<ossimXmlNode> node = root->findFirstNode(ossimString(xpath));
+   return node.valid() ? node->getText() : ossimString("<missing>");
+}
+
+static bool found(const ossimRefPtr<ossimXmlNode>& root, const char* xpath)
+{
+   return root->findFirstNode(ossimString(xpath)).valid();
+}
+
+// Tags, text and attributes of the whole tree.
+static void dump(const ossimXmlNode* node, ostream& out)
+{
+   out << '<' << node->getTag();
+   const ossimXmlNode::AttributeListType& attributes = node->getAttributes();
+   for (size_t i = 0; i < attributes.size(); ++i)
+      out << ' ' << attributes[i]->getName() << "=\"" << attributes[i]->getValue() << '"';
+   out << '>' << node->getText();
+   const ossimXmlNode::ChildListType& children = node->getChildNodes();
+   for (size_t i = 0; i < children.size(); ++i)
+      dump(children[i].get(), out);
+   out << "</" << node->getTag() << '>';
+}
+
+static string dump(const ossimRefPtr<ossimXmlNode>& root)
+{
+   ostringstream out;
+   if (root.valid())
+      dump(root.get(), out);
+   return out.str();
+}
+
+static string nested(int depth)
+{
+   string xml;
+   for (int i = 0; i < depth; ++i)
+      xml += "<a>";
+   xml += "x";
+   for (int i = 0; i < depth; ++i)
+      xml += "</a>";
+   return xml;
+}
+
+static void testParse(const ossimFilename& dir)
+{
+   cout << "Parse:" << endl;
+   ossimFilename file = dir.dirCat("document.xml");
+   writeFile(file, DOCUMENT);
+
+   ossimRefPtr<ossimXmlNode> root = readRoot(file);
+   check(root.valid(), "well formed document read");
+   if (!root.valid())
+      return;
+   check(root->getTag() == "Dimap_Document", "root tag");
+   check(root->getAttributeValue("name") == "a & b", "entity in attribute");
+   check(root->getAttributeValue("version") == "2.0", "single quoted attribute");
+   check(text(root, "Raster_Data/Raster_Dimensions/NROWS") == "100", "text trimmed");
+   check(text(root, "Raster_Data/Raster_Dimensions/NBANDS") == "4", "comment skipped");
+   check(text(root, "Raster_Data/Raster_Encoding/DATA_TYPE") == "<x> AB \"q\"",
+         "predefined and numeric references");
+   check(text(root, "Geometric_Data/Note") == "<kept as is> & text", "CDATA kept as is");
+   check(found(root, "Geometric_Data/Empty"), "empty element");
+   check(root->findFirstNode("Geometric_Data/Empty")->getAttributeValue("flag") == "1",
+         "empty element attribute");
+   check(root->findFirstNode("Geometric_Data/Ephemeris")->getChildNodes().size() == 2,
+         "repeated elements");
+}
+
+static void testKeptPaths(const ossimFilename& dir)
+{
+   cout << "Kept paths:" << endl;
+   ossimFilename file = dir.dirCat("document.xml");
+   writeFile(file, DOCUMENT);
+
+   static const char* const KEPT[] =
+   {
+      "Raster_Data/Raster_Dimensions",
+      "Geometric_Data/Empty",
+      0
+   };
+   ossimRefPtr<ossimXmlNode> root = readRoot(file, KEPT);
+   check(root.valid(), "pruned document read");
+   if (!root.valid())
+      return;
+   check(root->getAttributeValue("name") == "a & b", "root attributes kept");
+   check(text(root, "Raster_Data/Raster_Dimensions/NCOLS") == "200", "kept subtree");
+   check(found(root, "Geometric_Data/Empty"), "kept leaf");
+   check(!found(root, "Raster_Data/Raster_Encoding"), "sibling of kept path dropped");
+   check(!found(root, "Geometric_Data/Ephemeris"), "skipped list dropped");
+   check(!found(root, "Geometric_Data/Note"), "skipped CDATA dropped");
+   check(!found(root, "Metadata_Identification"), "unkept branch dropped");
+
+   // Skipped sections are still checked for truncation.
+   string truncated(DOCUMENT);
+   truncated.resize(truncated.find("<Point><X>3"));
+   writeFile(file, truncated);
+   check(!readRoot(file, KEPT).valid(), "truncated inside a skipped section rejected");
+}
+
+static void testMalformed(const ossimFilename& dir)
+{
+   cout << "Malformed:" << endl;
+   ossimFilename file = dir.dirCat("malformed.xml");
+   static const char* const CASES[][2] =
+   {
+      { "",                                  "empty file" },
+      { "just text",                         "no element" },
+      { "<a><b></a></b>",                    "mismatched end tag" },
+      { "<a><b>text</b>",                    "missing end tag" },
+      { "<a x=\"1></a>",                     "unterminated attribute" },
+      { "<a x=1></a>",                       "unquoted attribute" },
+      { "<a><![CDATA[never ends</a>",        "unterminated CDATA" },
+      { "<a><!-- never ends --</a>",         "unterminated comment" },
+      { "<a/",                               "truncated empty element" }
+   };
+   for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); ++i)
+   {
+      writeFile(file, CASES[i][0]);
+      check(!readRoot(file).valid(), string(CASES[i][1]) + " rejected");
+   }
+   check(!readRoot(dir.dirCat("no-such-file.xml")).valid(), "missing file rejected");
+}
+
+static void testDepth(const ossimFilename& dir)
+{
+   cout << "Depth:" << endl;
+   ossimFilename file = dir.dirCat("nested.xml");
+
+   writeFile(file, nested(200));
+   ossimRefPtr<ossimXmlNode> root = readRoot(file);
+   check(root.valid(), "200 levels read");
+
+   writeFile(file, nested(100000));
+   check(!readRoot(file).valid(), "100000 levels rejected");
+
+   // Skipping does not recurse, so a deep section that is not kept is fine.
+   writeFile(file, "<r><k>1</k><s>" + nested(100000) + "</s></r>");
+   static const char* const KEPT[] = { "k", 0 };
+   root = readRoot(file, KEPT);
+   check(root.valid() && (text(root, "k") == "1"), "100000 levels in a skipped section");
+}
+
+static void testCache(const ossimFilename& dir)
+{
+   cout << "Cache:" << endl;
+   ossimFilename cacheDir = dir.dirCat("cache");
+   ossimFilename file = dir.dirCat("cached.xml");
+   writeFile(file, DOCUMENT);
+
+   ossimPreferences::instance()->addPreference(ossimDimapXmlReader::CACHE_DIRECTORY_PREF_KW,
+                                               cacheDir.c_str());
+
+   const string expected = dump(readRoot(file));
+   check(!expected.empty(), "first read");
+   check(dump(readRoot(file)) == expected, "read from cache same as parsed");
+
+   vector<ossimFilename> entries;
+   ossimDirectory directory(cacheDir);
+   ossimFilename entry;
+   if (directory.getFirst(entry))
+   {
+      do
+         entries.push_back(entry);
+      while (directory.getNext(entry));
+   }
+   check(entries.size() == 1, "one cache file");
+
+   // A corrupt entry is ignored and rewritten.
+   if (entries.size() == 1)
+   {
+      writeFile(entries[0], "ODIMAPXC garbage");
+      check(dump(readRoot(file)) == expected, "corrupt cache file ignored");
+      check(dump(readRoot(file)) == expected, "cache file rewritten");
+   }
+
+   // Threads writing the same new entry each use their own temporary file.
+   for (size_t i = 0; i < entries.size(); ++i)
+      remove(entries[i].c_str());
+   const int THREADS = 8;
+   vector<string> results(THREADS);
+   vector<thread> threads;
+   for (int t = 0; t < THREADS; ++t)
+   {
+      threads.push_back(thread([&results, &file, t]()
+      {
+         for (int pass = 0; pass < 20; ++pass)
+         {
+            string result = dump(readRoot(file));
+            if (result != results[t])
+               results[t] = pass ? string("changed") : result;
+         }
+      }));
+   }
+   for (int t = 0; t < THREADS; ++t)
+      threads[t].join();
+   bool same = true;
+   for (int t = 0; t < THREADS; ++t)
+      same = same && (results[t] == expected);
+   check(same, "concurrent reads and cache writes all return the document");
+
+   entries.clear();
+   if (directory.getFirst(entry))
+   {
+      do
+         entries.push_back(entry);
+      while (directory.getNext(entry));
+   }
+   check(entries.size() == 1, "no temporary files left behind");
+   for (size_t i = 0; i < entries.size(); ++i)
+      remove(entries[i].c_str());
+
+   ossimPreferences::instance()->addPreference(ossimDimapXmlReader::CACHE_DIRECTORY_PREF_KW, "");
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename dir = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("dimap-xml-reader-test");
+   if (!dir.exists() && !dir.createDirectory(true))
+   {
+      cout << "Could not create " << dir << endl;
+      return 1;
+   }
+
+   testParse(dir);
+   testKeptPaths(dir);
+   testMalformed(dir);
+   testDepth(dir);
+   testCache(dir);
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,352 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Tests for ossimPluginFormatSniffer. Each format gets a minimal fixture, the names and first
+// bytes its model looks for, in a directory of its own, and the sniffer has to keep exactly that
+// format. Every model and reader is then opened on every fixture: an open that succeeds on a file
+// the sniffer dropped the format for is a failure, as the factories would never have tried it.
+// Last, the cache of ruled out files: forgotten when a neighbour appears, and never holding a
+// file a model was tried on, whose neighbours may be edited in place.
+//
+// Products given after the work directory get the same open check, and at least one model or
+// reader has to open each.
+//
+// Usage: format-sniffer-test [work directory] [product ...]
+
+#include "../src/ossimPluginFormatSniffer.h"
+#include "../src/ossimAlosPalsarModel.h"
+#include "../src/ossimEnvisatAsarModel.h"
+#include "../src/ossimErsSarModel.h"
+#include "../src/ossimFormosatDimapSupportData.h"
+#include "../src/ossimFormosatModel.h"
+#include "../src/ossimPleiadesModel.h"
+#include "../src/ossimPluginProjectionFactory.h"
+#include "../src/ossimRadarSat2Model.h"
+#include "../src/ossimRadarSat2TiffReader.h"
+#include "../src/ossimRadarSatModel.h"
+#include "../src/ossimSpot6Model.h"
+#include "../src/ossimTerraSarModel.h"
+#include "../src/ossimTerraSarTiffReader.h"
+#include "../src/ossimTileMapModel.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimFilename.h>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utime.h>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+typedef ossimPluginFormatSniffer Sniffer;
+
+static const ossim_uint32 ALL_FORMATS = Sniffer::ALL_MODELS | Sniffer::ALL_READERS;
+
+// Files and directories made, removed last first.
+static vector<ossimFilename> made;
+
+// Sets the times of path seconds back, by default old enough for the sniffer to cache.
+static void age(const ossimFilename& path, int seconds=3600)
+{
+   struct utimbuf times;
+   times.actime = times.modtime = time(0) - seconds;
+   utime(path.c_str(), &times);
+}
+
+static ossimFilename makeDir(const ossimFilename& parent, const char* name)
+{
+   ossimFilename dir = parent.dirCat(name);
+   dir.createDirectory(true);
+   made.push_back(dir);
+   return dir;
+}
+
+// Writes contents to dir/name and ages both.
+static ossimFilename makeFile(const ossimFilename& dir, const char* name, const string& contents)
+{
+   ossimFilename file = dir.dirCat(name);
+   ofstream out(file.c_str(), ios::binary);
+   out << contents;
+   out.close();
+   made.push_back(file);
+   age(file);
+   age(dir);
+   return file;
+}
+
+// A CEOS file descriptor record: 720 bytes, the file name from byte 48.
+static string ceosRecord(const char* name)
+{
+   string record(720, ' ');
+   record.replace(48, string(name).size(), name);
+   return record;
+}
+
+static string formatNames(ossim_uint32 formats)
+{
+   static const char* NAMES[] = { "RADARSAT2_MODEL", "PLEIADES_MODEL", "TERRASAR_MODEL",
+                                  "ERSSAR_MODEL", "ENVISAT_ASAR_MODEL", "RADARSAT_MODEL",
+                                  "ALOS_PALSAR_MODEL", "FORMOSAT_MODEL", "TILE_MAP_MODEL",
+                                  "SPOT6_MODEL", "RADARSAT2_READER", "TERRASAR_READER" };
+   string result;
+   for (int i = 0; i < 12; ++i)
+   {
+      if (formats & (1u << i))
+         result += (result.empty() ? "" : "|") + string(NAMES[i]);
+   }
+   return result.empty() ? "none" : result;
+}
+
+//---
+// The opens, as the factories do them.
+//---
+template <class T> static bool openWith(const ossimFilename& file)
+{
+   ossimRefPtr<T> object = new T();
+   return object->open(file);
+}
+
+static bool openFormosat(const ossimFilename& file)
+{
+   ossimFilename metadata = file;
+   metadata.setExtension("geom");
+   if (!metadata.exists())
+   {
+      metadata = file.path().dirCat(ossimFilename("METADATA.DIM"));
+      if (!metadata.exists())
+         metadata = file.path().dirCat(ossimFilename("metadata.dim"));
+   }
+   ossimFilename baseName = file.file();
+   baseName.downcase();
+   if (!metadata.exists() || (baseName == "icon.jpg") || (baseName == "preview.jpg"))
+      return false;
+
+   ossimRefPtr<ossimFormosatDimapSupportData> meta = new ossimFormosatDimapSupportData;
+   if (!meta->loadXmlFile(metadata))
+      return false;
+   ossimRefPtr<ossimFormosatModel> model = new ossimFormosatModel(meta.get());
+   return !model->getErrorStatus();
+}
+
+struct Opener
+{
+   ossim_uint32 format;
+   bool (*open)(const ossimFilename&);
+};
+
+static const Opener OPENERS[] =
+{
+   { Sniffer::RADARSAT2_MODEL,    openWith<ossimRadarSat2Model> },
+   { Sniffer::PLEIADES_MODEL,     openWith<ossimPleiadesModel> },
+   { Sniffer::TERRASAR_MODEL,     openWith<ossimTerraSarModel> },
+   { Sniffer::ERSSAR_MODEL,       openWith<ossimErsSarModel> },
+   { Sniffer::ENVISAT_ASAR_MODEL, openWith<ossimEnvisatAsarModel> },
+   { Sniffer::RADARSAT_MODEL,     openWith<ossimRadarSatModel> },
+   { Sniffer::ALOS_PALSAR_MODEL,  openWith<ossimAlosPalsarModel> },
+   { Sniffer::FORMOSAT_MODEL,     openFormosat },
+   { Sniffer::TILE_MAP_MODEL,     openWith<ossimTileMapModel> },
+   { Sniffer::SPOT6_MODEL,        openWith<ossimSpot6Model> },
+   { Sniffer::RADARSAT2_READER,   openWith<ossimRadarSat2TiffReader> },
+   { Sniffer::TERRASAR_READER,    openWith<ossimTerraSarTiffReader> }
+};
+
+// Formats whose open succeeds on file.
+static ossim_uint32 openFormats(const ossimFilename& file)
+{
+   ossim_uint32 result = 0;
+   for (size_t i = 0; i < sizeof(OPENERS) / sizeof(OPENERS[0]); ++i)
+   {
+      if (OPENERS[i].open(file))
+         result |= OPENERS[i].format;
+   }
+   return result;
+}
+
+struct Fixture
+{
+   ossimFilename file;
+   ossim_uint32 expected;
+};
+
+static vector<Fixture> makeFixtures(const ossimFilename& root)
+{
+   vector<Fixture> fixtures;
+   Fixture f;
+
+   ossimFilename dir = makeDir(root, "radarsat2");
+   f.file = makeFile(dir, "product.xml",
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<product xmlns=\"http://www.rsi.ca/rs2/prod/xml/schemas\">\n</product>\n");
+   f.expected = Sniffer::RADARSAT2_MODEL | Sniffer::RADARSAT2_READER;
+   fixtures.push_back(f);
+   f.file = makeFile(dir, "imagery_HH.tif", "II*");
+   f.expected = Sniffer::RADARSAT2_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "terrasar");
+   f.file = makeFile(dir, "TSX1_SAR__SSC.xml",
+                     "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                     "<!-- TerraSAR-X level 1b -->\n<level1Product>\n</level1Product>\n");
+   f.expected = Sniffer::TERRASAR_MODEL | Sniffer::TERRASAR_READER;
+   fixtures.push_back(f);
+
+   // Pleiades and Spot6 products are named alike; the sniffer keeps both.
+   dir = makeDir(root, "pleiades");
+   makeFile(dir, "DIM_PHR1A_P_001.XML", "<Dimap_Document>\n</Dimap_Document>\n");
+   f.file = makeFile(dir, "IMG_PHR1A_P_001_R1C1.JP2", "jP2");
+   f.expected = Sniffer::PLEIADES_MODEL | Sniffer::SPOT6_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "erssar");
+   f.file = makeFile(dir, "LEA_01.001", ceosRecord("ERS1.SAR.PRILEAD"));
+   f.expected = Sniffer::ERSSAR_MODEL;
+   fixtures.push_back(f);
+   f.file = makeFile(dir, "DAT_01.001", ceosRecord("ERS1.SAR.PRIDATA"));
+   f.expected = Sniffer::ERSSAR_MODEL | Sniffer::RADARSAT_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "envisat");
+   f.file = makeFile(dir, "ASA_IMS_1PNPDE.N1",
+                     "PRODUCT=\"ASA_IMS_1PNPDE20040101_000000_000000000000_00000_00000_0000.N1\"\n");
+   f.expected = Sniffer::ENVISAT_ASAR_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "radarsat");
+   f.file = makeFile(dir, "DAT_01.001", ceosRecord("RSAT-1-SAR-SLC DATA"));
+   f.expected = Sniffer::RADARSAT_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "alos");
+   f.file = makeFile(dir, "LED-ALPSRP000000000-H1.1__A", ceosRecord("AL1 PSR SARL"));
+   f.expected = Sniffer::ALOS_PALSAR_MODEL;
+   fixtures.push_back(f);
+   f.file = makeFile(dir, "IMG-ALPSRP000000000-H1.1__A", ceosRecord("AL1 PSR IMOP"));
+   f.expected = Sniffer::ALOS_PALSAR_MODEL;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "formosat");
+   makeFile(dir, "METADATA.DIM", "<Dimap_Document>\n</Dimap_Document>\n");
+   f.file = makeFile(dir, "IMAGERY.TIF", "II*");
+   f.expected = Sniffer::FORMOSAT_MODEL;
+   fixtures.push_back(f);
+   f.file = makeFile(dir, "ICON.JPG", "\xff\xd8\xff");
+   f.expected = 0;
+   fixtures.push_back(f);
+
+   dir = makeDir(root, "tilemap");
+   f.file = makeFile(dir, "tiles.otb", "");
+   f.expected = Sniffer::TILE_MAP_MODEL;
+   fixtures.push_back(f);
+
+   // Nothing the plugin reads:
+   dir = makeDir(root, "none");
+   f.file = makeFile(dir, "image.tif", "II*");
+   f.expected = 0;
+   fixtures.push_back(f);
+   f.file = makeFile(dir, "doc.xml", "<?xml version=\"1.0\"?>\n<kml>\n</kml>\n");
+   f.expected = 0;
+   fixtures.push_back(f);
+
+   return fixtures;
+}
+
+static void testFixtures(const vector<Fixture>& fixtures)
+{
+   cout << "Fixtures:" << endl;
+   Sniffer* sniffer = Sniffer::instance();
+   for (size_t i = 0; i < fixtures.size(); ++i)
+   {
+      const ossimFilename& file = fixtures[i].file;
+      const ossim_uint32 kept = sniffer->sniff(file, ALL_FORMATS);
+      const string name = file.path().file() + "/" + file.file();
+      check(kept == fixtures[i].expected,
+            name + ": kept " + formatNames(kept) + ", expected " +
+            formatNames(fixtures[i].expected));
+
+      const ossim_uint32 opened = openFormats(file);
+      check((opened & ~kept) == 0,
+            name + ": every format that opens was kept (opened " + formatNames(opened) + ")");
+   }
+}
+
+static void testProducts(const vector<ossimFilename>& products)
+{
+   cout << "Products:" << endl;
+   for (size_t i = 0; i < products.size(); ++i)
+   {
+      const ossim_uint32 kept = Sniffer::instance()->sniff(products[i], ALL_FORMATS);
+      const ossim_uint32 opened = openFormats(products[i]);
+      check(opened != 0, products[i].string() + ": opened by " + formatNames(opened));
+      check((opened & ~kept) == 0,
+            products[i].string() + ": every format that opens was kept (kept " +
+            formatNames(kept) + ")");
+   }
+}
+
+static void testCache(const ossimFilename& root)
+{
+   cout << "Cache:" << endl;
+   Sniffer* sniffer = Sniffer::instance();
+
+   // Ruled out and cached, then a Formosat metadata file appears next to it.
+   ossimFilename dir = makeDir(root, "cache");
+   ossimFilename image = makeFile(dir, "IMAGERY.TIF", "II*");
+   check(sniffer->sniff(image, ALL_FORMATS) == 0, "lone image ruled out");
+   check(sniffer->sniff(image, ALL_FORMATS) == 0, "lone image ruled out again from the cache");
+   ossimFilename metadata = makeFile(dir, "METADATA.DIM", "<Dimap_Document/>\n");
+   age(dir, 1800);
+   check(sniffer->sniff(image, ALL_FORMATS) == Sniffer::FORMOSAT_MODEL,
+         "cached result dropped when a neighbour appears");
+
+   //---
+   // The metadata is broken, so the factory finds no model, then it is fixed in place, which
+   // changes neither the image nor the directory: the image must still go to the model.
+   //---
+   ossimRefPtr<ossimProjection> projection =
+      ossimPluginProjectionFactory::instance()->createProjection(image, 0);
+   check(!projection.valid(), "no projection from the broken metadata");
+   ofstream out(metadata.c_str(), ios::trunc);
+   out << "<Dimap_Document>\n<!-- edited -->\n</Dimap_Document>\n";
+   out.close();
+   age(metadata, 1800);
+   age(dir, 1800);
+   check(sniffer->sniff(image, ALL_FORMATS) == Sniffer::FORMOSAT_MODEL,
+         "failed open not cached, file kept after its neighbour is edited in place");
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename root = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("format-sniffer-test");
+   if (!root.exists() && !root.createDirectory(true))
+   {
+      cout << "Could not create " << root << endl;
+      return 1;
+   }
+
+   testFixtures(makeFixtures(root));
+   testCache(root);
+
+   vector<ossimFilename> products;
+   for (int i = 2; i < argc; ++i)
+      products.push_back(ossimFilename(argv[i]));
+   if (!products.empty())
+      testProducts(products);
+
+   for (size_t i = made.size(); i > 0; --i)
+      remove(made[i - 1].c_str());
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,174 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Regression test for ossimFormosatModel::imagingRay after the NEWMAT rotations were replaced by
+// fixed arrays and the per thread line geometry cache was added. Rays over a grid of image
+// points, several samples per line so the cache is hit, are compared with rays computed by the
+// imagingRay of before the change, copied here, from the support data alone. The difference, as
+// ground distance at the imaging range over the model's GSD, must stay under 1e-9 pixel. It is
+// checked again after an adjustable parameter change, which must not be masked by the cache.
+//
+// Usage: formosat-ray-test <METADATA.DIM>
+
+#include "../src/ossimFormosatModel.h"
+#include "../src/ossimFormosatDimapSupportData.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimColumnVector3d.h>
+#include <ossim/base/ossimDpt3d.h>
+#include <ossim/base/ossimEcefRay.h>
+#include <ossim/matrix/newmat.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const double MAX_PIXEL_ERROR = 1e-9;
+
+// Opens the model's protected state to build the reference ray.
+class TestModel : public ossimFormosatModel
+{
+public:
+   TestModel(ossimFormosatDimapSupportData* sd) : ossimFormosatModel(sd) {}
+
+   //---
+   // imagingRay as it was before the line geometry was cached, NEWMAT::Matrix rotations built
+   // from the support data and the adjustable parameters, none of the model's new code used.
+   //---
+   void referenceRay(const ossimDpt& image_point, ossimEcefRay& image_ray) const
+   {
+      ossimDpt iPt = image_point;
+      iPt.samp += theSpotSubImageOffset.samp;
+      iPt.line += theSpotSubImageOffset.line;
+
+      // 1. Time of line imaging:
+      double t_line = theRefImagingTime +
+                      theLineSamplingPeriod*(iPt.line - theRefImagingTimeLine);
+
+      // 2. Ephemeris position and velocity (in ECF):
+      ossimEcefPoint tempEcefPoint;
+      ossimEcefPoint P_ecf;
+      theSupportData->getPositionEcf(t_line, P_ecf);
+      theSupportData->getVelocityEcf(t_line, tempEcefPoint);
+      ossimEcefVector V_ecf(tempEcefPoint.x(), tempEcefPoint.y(), tempEcefPoint.z());
+
+      // 3. Look direction in vehicle LSR space:
+      ossim_float64 Psi_x;
+      theSupportData->getPixelLookAngleX(iPt.samp, Psi_x);
+      ossim_float64 Psi_y;
+      theSupportData->getPixelLookAngleY(iPt.samp, Psi_y);
+      ossimColumnVector3d u_sat(-tan(Psi_y), tan(Psi_x), -(1.0 + theFocalLenOffset));
+
+      // 4. To orbital LSR space, with the adjusted attitude:
+      ossimDpt3d att;
+      theSupportData->getAttitude(t_line, att);
+      double dt = theRefImagingTime - t_line;
+      att.x += thePitchOffset + dt*thePitchRate;
+      att.y += theRollOffset  + dt*theRollRate;
+      att.z += theYawOffset   + dt*theYawRate;
+      double cp = cos(att.x);
+      double sp = sin(att.x);
+      double cr = cos(att.y);
+      double sr = sin(att.y);
+      double cy = cos(att.z);
+      double sy = sin(att.z);
+      NEWMAT::Matrix satToOrbit(3, 3);
+      satToOrbit << (cr*cy) << (-cr*sy) << (-sr)
+                 << (cp*sy+sp*sr*cy) << (cp*cy-sp*sr*sy) << (sp*cr)
+                 << (-sp*sy+cp*sr*cy) << (-sp*cy-cp*sr*sy) << cp*cr;
+      ossimColumnVector3d u_orb = (satToOrbit*u_sat).unit();
+
+      // 5. To ECF:
+      ossimColumnVector3d Z_orb(P_ecf.x(), P_ecf.y(), P_ecf.z());
+      Z_orb = Z_orb.unit();
+      ossimColumnVector3d X_orb =
+         ossimColumnVector3d(V_ecf.x(), V_ecf.y(), V_ecf.z()).cross(Z_orb).unit();
+      ossimColumnVector3d Y_orb = Z_orb.cross(X_orb);
+      NEWMAT::Matrix orbToEcf(3, 3);
+      orbToEcf << X_orb[0] << Y_orb[0] << Z_orb[0]
+               << X_orb[1] << Y_orb[1] << Z_orb[1]
+               << X_orb[2] << Y_orb[2] << Z_orb[2];
+      ossimColumnVector3d u_ecf = (orbToEcf*u_orb);
+
+      image_ray = ossimEcefRay(P_ecf, ossimEcefVector(u_ecf[0], u_ecf[1], u_ecf[2]));
+   }
+
+   const ossimIrect& getClipRect() const { return theImageClipRect; }
+};
+
+// Largest ray difference in pixels over a grid of the image.
+static double maxPixelError(const TestModel& model, bool& sameRays)
+{
+   const ossimIrect& rect = model.getClipRect();
+   const ossimDpt METERS = model.getMetersPerPixel();
+   const double GSD = (METERS.x + METERS.y) / 2.0;
+   double maxError = 0.0;
+   sameRays = true;
+   for (int row = 0; row <= 16; ++row)
+   {
+      double line = rect.ul().y + (rect.height() - 1) * row / 16.0 + 0.25;
+      for (int col = 0; col <= 16; ++col)
+      {
+         ossimDpt pt(rect.ul().x + (rect.width() - 1) * col / 16.0 + 0.5, line);
+         ossimEcefRay ray;
+         ossimEcefRay reference;
+         model.imagingRay(pt, ray);
+         model.referenceRay(pt, reference);
+
+         // Ground offset at the imaging range from the direction, plus the origin offset.
+         ossimGpt ground;
+         model.lineSampleToWorld(pt, ground);
+         double range = (ossimEcefPoint(ground) - reference.origin()).magnitude();
+         double angle = (ray.direction() - reference.direction()).magnitude();
+         double error = (angle * range + (ray.origin() - reference.origin()).magnitude()) / GSD;
+         maxError = max(maxError, error);
+         sameRays = sameRays && (ray.origin() == reference.origin()) &&
+            (ray.direction() == reference.direction());
+      }
+   }
+   return maxError;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+   if (argc < 2)
+   {
+      cout << "Usage: " << argv[0] << " <METADATA.DIM>" << endl;
+      return 1;
+   }
+
+   ossimFormosatDimapSupportData* sd = new ossimFormosatDimapSupportData();
+   if (!sd->loadXmlFile(ossimFilename(argv[1])))
+   {
+      cout << "Could not load " << argv[1] << endl;
+      delete sd;
+      return 1;
+   }
+   TestModel model(sd);
+
+   bool sameRays = false;
+   double error = maxPixelError(model, sameRays);
+   ostringstream what;
+   what << "rays within " << MAX_PIXEL_ERROR << " pixel of NEWMAT (" << error << ")";
+   check(error < MAX_PIXEL_ERROR, what.str());
+   cout << "  rays " << (sameRays ? "" : "not ") << "bit for bit the same as NEWMAT" << endl;
+
+   // A new geometry must not reuse the cached line.
+   model.setAdjustableParameter(0, 1.0, true);
+   model.updateModel();
+   error = maxPixelError(model, sameRays);
+   ostringstream adjusted;
+   adjusted << "after adjusting roll, within " << MAX_PIXEL_ERROR << " pixel (" << error << ")";
+   check(error < MAX_PIXEL_ERROR, adjusted.str());
+
+   return ossimPluginTest::summary();
+}
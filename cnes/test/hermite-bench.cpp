@@ -0,0 +1,62 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Cost of one HermiteInterpolator call, value and derivative, full span against the 8 point
+// window PlatformPosition uses, for arcs of 10 s state vectors of various lengths.
+//
+// Usage: hermite-bench [calls]
+
+#include "../src/otb/HermiteInterpolator.h"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using ossimplugins::HermiteInterpolator;
+
+static double timeCalls(const HermiteInterpolator& interp, double span, int calls, double& sum)
+{
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (int i = 0; i < calls; ++i)
+   {
+      double y = 0.0;
+      double dy = 0.0;
+      interp.Interpolate(span * (i + 0.5) / calls, y, dy);
+      sum += y + dy;
+   }
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count() / calls;
+}
+
+int main(int argc, char* argv[])
+{
+   int calls = (argc > 1) ? atoi(argv[1]) : 20000;
+
+   const int POINTS[] = { 10, 30, 100, 300 };
+   double sum = 0.0;
+   for (int n = 0; n < 4; ++n)
+   {
+      vector<double> t, p, dp;
+      for (int i = 0; i < POINTS[n]; ++i)
+      {
+         t.push_back(i * 10.0);
+         p.push_back(7.0e6 * cos(2.0 * M_PI * i * 10.0 / 5700.0));
+         dp.push_back(-7.0e6 * 2.0 * M_PI / 5700.0 * sin(2.0 * M_PI * i * 10.0 / 5700.0));
+      }
+      HermiteInterpolator full(POINTS[n], &t[0], &p[0], &dp[0]);
+      HermiteInterpolator windowed(POINTS[n], &t[0], &p[0], &dp[0], 8);
+
+      double fullCall = timeCalls(full, t.back(), calls, sum);
+      double windowedCall = timeCalls(windowed, t.back(), calls, sum);
+      cout << POINTS[n] << " points: full span " << fullCall * 1e6 << " us/call, window 8 "
+           << windowedCall * 1e6 << " us/call" << endl;
+   }
+
+   // Keeps the calls from being optimized away.
+   return (sum == 0.123) ? 1 : 0;
+}
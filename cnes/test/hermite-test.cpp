@@ -0,0 +1,171 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Accuracy test for the windowed HermiteInterpolator that PlatformPosition uses for ephemeris.
+// State vectors are sampled every 10 s from a circular 5700 s orbit, so the true position and
+// speed are known at every date:
+//
+//   - with no more points than the window, windowed and full span results must be identical;
+//   - on long arcs the 8 point window must stay within 1e-6 m and 1e-6 m/s of the orbit,
+//     where the full span interpolation is already unstable;
+//   - the state vectors themselves are returned exactly, copies interpolate the same.
+
+#include "../src/otb/HermiteInterpolator.h"
+#include "../../test/ossimPluginTest.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using ossimplugins::HermiteInterpolator;
+
+static const double RADIUS = 7.0e6;
+static const double PERIOD = 5700.0;
+static const double STEP = 10.0;
+static const int WINDOW = 8;
+
+static double truePosition(double t) { return RADIUS * cos(2.0 * M_PI * t / PERIOD); }
+static double trueSpeed(double t)
+{
+   return -RADIUS * 2.0 * M_PI / PERIOD * sin(2.0 * M_PI * t / PERIOD);
+}
+
+struct Orbit
+{
+   vector<double> t;
+   vector<double> p;
+   vector<double> dp;
+
+   explicit Orbit(int points)
+   {
+      for (int i = 0; i < points; ++i)
+      {
+         t.push_back(i * STEP);
+         p.push_back(truePosition(i * STEP));
+         dp.push_back(trueSpeed(i * STEP));
+      }
+   }
+
+   double span() const { return t.back(); }
+};
+
+// Largest position and speed errors of interp against the orbit over random dates.
+static void maxError(const HermiteInterpolator& interp, const Orbit& orbit, double& posError,
+                     double& speedError)
+{
+   posError = 0.0;
+   speedError = 0.0;
+   srand(3);
+   for (int i = 0; i < 10000; ++i)
+   {
+      double x = orbit.span() * rand() / RAND_MAX;
+      double y = 0.0;
+      double dy = 0.0;
+      interp.Interpolate(x, y, dy);
+      posError = max(posError, fabs(y - truePosition(x)));
+      speedError = max(speedError, fabs(dy - trueSpeed(x)));
+   }
+}
+
+int main()
+{
+   // Short arcs: the window is the whole arc.
+   for (int points = 2; points <= WINDOW; points += 3)
+   {
+      Orbit orbit(points);
+      HermiteInterpolator full(points, &orbit.t[0], &orbit.p[0], &orbit.dp[0]);
+      HermiteInterpolator windowed(points, &orbit.t[0], &orbit.p[0], &orbit.dp[0], WINDOW);
+      bool same = (windowed.GetWindowSize() == points);
+      srand(1);
+      for (int i = 0; (i < 1000) && same; ++i)
+      {
+         double x = orbit.span() * rand() / RAND_MAX;
+         double y1 = 0.0, dy1 = 0.0, y2 = 0.0, dy2 = 0.0, y3 = 0.0;
+         full.Interpolate(x, y1, dy1);
+         windowed.Interpolate(x, y2, dy2);
+         windowed.Interpolate(x, y3);
+         same = (y1 == y2) && (dy1 == dy2) && (y2 == y3);
+      }
+      ostringstream what;
+      what << points << " points: window " << WINDOW << " identical to full span";
+      check(same, what.str());
+   }
+
+   // Long arcs.
+   const int POINTS[] = { 30, 100, 300 };
+   for (int n = 0; n < 3; ++n)
+   {
+      Orbit orbit(POINTS[n]);
+      HermiteInterpolator windowed(POINTS[n], &orbit.t[0], &orbit.p[0], &orbit.dp[0], WINDOW);
+      double posError = 0.0;
+      double speedError = 0.0;
+      maxError(windowed, orbit, posError, speedError);
+      ostringstream what;
+      what << POINTS[n] << " points: window " << WINDOW << " error " << posError << " m, "
+           << speedError << " m/s";
+      check((windowed.GetWindowSize() == WINDOW) && (posError < 1e-6) && (speedError < 1e-6),
+            what.str());
+
+      if (POINTS[n] <= 100)
+      {
+         HermiteInterpolator full(POINTS[n], &orbit.t[0], &orbit.p[0], &orbit.dp[0]);
+         double fullPosError = 0.0;
+         double fullSpeedError = 0.0;
+         maxError(full, orbit, fullPosError, fullSpeedError);
+         ostringstream fullWhat;
+         fullWhat << POINTS[n] << " points: window no worse than full span (" << fullPosError
+                  << " m, " << fullSpeedError << " m/s)";
+         check((posError <= fullPosError) || (fullPosError < 1e-6), fullWhat.str());
+      }
+   }
+
+   // Samples, ends and copies.
+   {
+      Orbit orbit(100);
+      HermiteInterpolator windowed(100, &orbit.t[0], &orbit.p[0], &orbit.dp[0], WINDOW);
+      bool exact = true;
+      for (int i = 0; i < 100; ++i)
+      {
+         double y = 0.0;
+         double dy = 0.0;
+         windowed.Interpolate(orbit.t[i], y, dy);
+         exact = exact && (y == orbit.p[i]) && (dy == orbit.dp[i]);
+      }
+      check(exact, "state vectors returned exactly");
+
+      double y = 0.0;
+      double dy = 0.0;
+      bool ends = (windowed.Interpolate(-STEP / 2, y, dy) == 0) &&
+         (fabs(y - truePosition(-STEP / 2)) < 1e-3) &&
+         (windowed.Interpolate(orbit.span() + STEP / 2, y, dy) == 0) &&
+         (fabs(y - truePosition(orbit.span() + STEP / 2)) < 1e-3);
+      check(ends, "half a step outside the arc extrapolates from the end windows");
+
+      HermiteInterpolator copied(windowed);
+      HermiteInterpolator assigned;
+      assigned = windowed;
+      assigned = assigned;
+      bool same = (copied.GetWindowSize() == WINDOW) && (assigned.GetWindowSize() == WINDOW);
+      srand(2);
+      for (int i = 0; (i < 1000) && same; ++i)
+      {
+         double x = orbit.span() * rand() / RAND_MAX;
+         double y1 = 0.0, y2 = 0.0, y3 = 0.0;
+         windowed.Interpolate(x, y1);
+         copied.Interpolate(x, y2);
+         assigned.Interpolate(x, y3);
+         same = (y1 == y2) && (y1 == y3);
+      }
+      check(same, "copy and assignment interpolate the same");
+   }
+
+   return ossimPluginTest::summary();
+}
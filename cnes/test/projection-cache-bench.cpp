@@ -0,0 +1,267 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Cost per point of ossimProjectionGridCache against the rigorous SarSensor model it stands in
+// for, on a synthetic 20000 x 20000 SAR image: image to ground and ground to image, the first
+// pass that builds the cells and a second pass over the same points, from one thread and then
+// from several threads sharing one cache through an ossimProjectionGridCache::Holder. Points
+// come in 256 pixel tiles, as a resampler asks for them.
+//
+// Usage: projection-cache-bench [threads] [tolerance in pixels] [points per thread]
+
+#include "../src/ossimProjectionGridCache.h"
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimPreferences.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+
+static const ossimIrect IMAGE_RECT(0, 0, 19999, 19999);
+static const double NEAR_RANGE = 850.0e3;
+static const double RANGE_STEP = 2.5;
+static const double FIRST_TIME = 150.0;
+static const double LINE_TIME = 1.0e-3;
+static const int TILE = 256;
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+struct SarModel
+{
+   SensorParams params;
+   PlatformPosition* position;
+
+   void forward(const ossimDpt& ip, const double& h, ossimGpt& gp) const
+   {
+      double lon = 0.0;
+      double lat = 0.0;
+      if (SarSensor::ImageToWorld(params, *position, NEAR_RANGE + RANGE_STEP * ip.x,
+                                  makeDate(FIRST_TIME + LINE_TIME * ip.y), h, lon, lat))
+         gp.makeNan();
+      else
+         gp = ossimGpt(lat, lon, h);
+   }
+
+   void inverse(const ossimGpt& gp, ossimDpt& ip) const
+   {
+      double time = FIRST_TIME + LINE_TIME * 0.5 * IMAGE_RECT.height();
+      double distance = 0.0;
+      if (SarSensor::WorldToImage(params, *position, gp.lond(), gp.latd(), gp.height(), time,
+                                  distance))
+         ip.makeNan();
+      else
+         ip = ossimDpt((distance - NEAR_RANGE) / RANGE_STEP, (time - FIRST_TIME) / LINE_TIME);
+   }
+};
+
+struct Points
+{
+   vector<ossimDpt> image;
+   vector<ossimGpt> ground;
+};
+
+// Every 8th pixel of 256 pixel tiles scattered over the image, a different set per thread.
+static Points makePoints(const SarModel& model, int count, int seed)
+{
+   Points points;
+   const unsigned tiles = IMAGE_RECT.width() / TILE;
+   for (int k = 0; k < count; ++k)
+   {
+      const unsigned tile = k / 1024 + seed * 7919;
+      const int j = k % 1024;
+      const unsigned tx = (tile * 7919u) % tiles;
+      const unsigned ty = (tile * 104729u) % tiles;
+      points.image.push_back(ossimDpt(tx * TILE + (j % 32) * 8 + 0.3,
+                                      ty * TILE + (j / 32) * 8 + 0.7));
+      ossimGpt gp;
+      model.forward(points.image.back(), 100.0 + 300.0 * (tile % 8), gp);
+      points.ground.push_back(gp);
+   }
+   return points;
+}
+
+// Microseconds per point, forward and inverse, of each thread's points.
+struct Timing
+{
+   double forward;
+   double inverse;
+};
+
+template <class Forward, class Inverse>
+static Timing run(const vector<Points>& points, const Forward& forward, const Inverse& inverse)
+{
+   vector<thread> threads;
+   vector<Timing> timings(points.size());
+   for (size_t t = 0; t < points.size(); ++t)
+   {
+      threads.push_back(thread([&, t]()
+      {
+         const Points& p = points[t];
+         const size_t n = p.image.size();
+         chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         for (size_t i = 0; i < n; ++i)
+         {
+            ossimGpt gp;
+            forward(p.image[i], p.ground[i].height(), gp);
+         }
+         timings[t].forward = 1.0e6 * seconds(start) / n;
+         start = chrono::steady_clock::now();
+         for (size_t i = 0; i < n; ++i)
+         {
+            ossimDpt ip;
+            inverse(p.ground[i], ip);
+         }
+         timings[t].inverse = 1.0e6 * seconds(start) / n;
+      }));
+   }
+   Timing worst = { 0.0, 0.0 };
+   for (size_t t = 0; t < threads.size(); ++t)
+   {
+      threads[t].join();
+      worst.forward = max(worst.forward, timings[t].forward);
+      worst.inverse = max(worst.inverse, timings[t].inverse);
+   }
+   return worst;
+}
+
+static void report(const string& name, const Timing& timing, const Timing& rigorous)
+{
+   cout << setw(34) << left << name << right << fixed << setprecision(3)
+        << setw(10) << timing.forward << setw(8) << setprecision(0)
+        << rigorous.forward / timing.forward << "x" << setprecision(3)
+        << setw(10) << timing.inverse << setw(8) << setprecision(0)
+        << rigorous.inverse / timing.inverse << "x" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   unsigned cores = thread::hardware_concurrency();
+   const int threads = (argc > 1) ? atoi(argv[1]) : (cores ? (int)cores : 1);
+   const char* tolerance = (argc > 2) ? argv[2] : "0.1";
+   const int count = (argc > 3) ? atoi(argv[3]) : 100000;
+
+   ossimPreferences::instance()->addPreference(ossimProjectionGridCache::ENABLED_PREF_KW, "true");
+   ossimPreferences::instance()->addPreference(ossimProjectionGridCache::TOLERANCE_PREF_KW,
+                                               tolerance);
+
+   SarModel model;
+   model.params.set_rwl(0.0555);
+   model.params.set_sightDirection(SensorParams::Right);
+   model.params.set_semiMajorAxis(6378137.0);
+   model.params.set_semiMinorAxis(6356752.3141);
+   model.params.set_dopcen(120.0);
+   model.params.set_dopcenLinear(-3.0);
+   model.position = makePlatformPosition();
+
+   auto rigorousForward = [&model](const ossimDpt& ip, const double& h, ossimGpt& gp)
+   {
+      model.forward(ip, h, gp);
+   };
+   auto rigorousInverse = [&model](const ossimGpt& gp, ossimDpt& ip)
+   {
+      model.inverse(gp, ip);
+   };
+
+   cout << IMAGE_RECT.width() << " x " << IMAGE_RECT.height() << " image, tolerance "
+        << tolerance << " px, " << count << " points per thread" << endl;
+   cout << "                                  forward (us/pt)       inverse (us/pt)" << endl;
+
+   const int RUNS[] = { 1, threads };
+   for (int r = 0; r < ((threads > 1) ? 2 : 1); ++r)
+   {
+      vector<Points> points;
+      for (int t = 0; t < RUNS[r]; ++t)
+         points.push_back(makePoints(model, count, t));
+
+      const Timing rigorous = run(points, rigorousForward, rigorousInverse);
+
+      ossimProjectionGridCache::Holder holder;
+      auto cachedForward = [&](const ossimDpt& ip, const double& h, ossimGpt& gp)
+      {
+         ossimProjectionGridCache::ConstPtr cache =
+            holder.get(IMAGE_RECT, rigorousForward, rigorousInverse);
+         if (!cache || !cache->lineSampleHeightToWorld(ip, h, gp))
+            model.forward(ip, h, gp);
+      };
+      auto cachedInverse = [&](const ossimGpt& gp, ossimDpt& ip)
+      {
+         ossimProjectionGridCache::ConstPtr cache =
+            holder.get(IMAGE_RECT, rigorousForward, rigorousInverse);
+         if (!cache || !cache->worldToLineSample(gp, ip))
+            model.inverse(gp, ip);
+      };
+      const Timing first = run(points, cachedForward, cachedInverse);
+      const Timing second = run(points, cachedForward, cachedInverse);
+
+      ostringstream name;
+      name << RUNS[r] << " thread" << ((RUNS[r] > 1) ? "s" : "") << ", ";
+      report(name.str() + "rigorous", rigorous, rigorous);
+      report(name.str() + "cache, first pass", first, rigorous);
+      report(name.str() + "cache, second pass", second, rigorous);
+   }
+
+   delete model.position;
+   return 0;
+}
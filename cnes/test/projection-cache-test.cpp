@@ -0,0 +1,377 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Accuracy of ossimProjectionGridCache over a synthetic SAR image, columns mapped to slant range
+// and lines to azimuth time, located with SarSensor. Image to ground and ground to image are
+// checked against the rigorous model on a dense grid of points, every pixel of the four edges
+// and the four corners, at the lowest, highest and in between heights the cache covers, to
+// within the tolerance plus the rigorous model's own noise. Points
+// off the image or above the covered heights must be left to the rigorous model. Then threads
+// project through an ossimProjectionGridCache::Holder while the main thread resets it, as a
+// model does when its parameters are adjusted.
+//
+// Best run under -fsanitize=address or -fsanitize=thread as well.
+
+#include "../src/ossimProjectionGridCache.h"
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimPreferences.h>
+#include <atomic>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+
+// Image: 5000 columns of 2.5 m slant range from 850 km, 3001 lines of 1 ms from 150 s. Neither
+// size is a multiple of the 512 pixel root cells.
+static const ossimIrect IMAGE_RECT(0, 0, 4999, 3000);
+static const double NEAR_RANGE = 850.0e3;
+static const double RANGE_STEP = 2.5;
+static const double FIRST_TIME = 150.0;
+static const double LINE_TIME = 1.0e-3;
+
+static const double TOLERANCE = 0.1; // pixels
+static const int GRID_STEP = 16;     // pixels between the dense grid points
+static const int THREADS = 4;
+static const int RESETS = 200;
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+// The rigorous model the cache approximates.
+struct SarModel
+{
+   SensorParams params;
+   PlatformPosition* position;
+
+   void forward(const ossimDpt& ip, const double& h, ossimGpt& gp) const
+   {
+      double lon = 0.0;
+      double lat = 0.0;
+      if (SarSensor::ImageToWorld(params, *position, NEAR_RANGE + RANGE_STEP * ip.x,
+                                  makeDate(FIRST_TIME + LINE_TIME * ip.y), h, lon, lat))
+         gp.makeNan();
+      else
+         gp = ossimGpt(lat, lon, h);
+   }
+
+   void inverse(const ossimGpt& gp, ossimDpt& ip) const
+   {
+      double time = FIRST_TIME + LINE_TIME * 0.5 * IMAGE_RECT.height();
+      double distance = 0.0;
+      if (SarSensor::WorldToImage(params, *position, gp.lond(), gp.latd(), gp.height(), time,
+                                  distance))
+         ip.makeNan();
+      else
+         ip = ossimDpt((distance - NEAR_RANGE) / RANGE_STEP, (time - FIRST_TIME) / LINE_TIME);
+   }
+};
+
+// The dense grid, the last column and line, and every pixel of the edges.
+static vector<ossimDpt> testPoints()
+{
+   const int w = (int)IMAGE_RECT.width();
+   const int h = (int)IMAGE_RECT.height();
+   vector<ossimDpt> points;
+   for (int y = 0; y < h; y += GRID_STEP)
+      for (int x = 0; x < w; x += GRID_STEP)
+         points.push_back(ossimDpt(x, y));
+   for (int x = 0; x < w; ++x)
+   {
+      points.push_back(ossimDpt(x, 0));
+      points.push_back(ossimDpt(x, h - 1));
+   }
+   for (int y = 0; y < h; ++y)
+   {
+      points.push_back(ossimDpt(0, y));
+      points.push_back(ossimDpt(w - 1, y));
+   }
+   // Outer edges of the corner pixels.
+   points.push_back(ossimDpt(-0.5, -0.5));
+   points.push_back(ossimDpt(w - 0.51, -0.5));
+   points.push_back(ossimDpt(w - 0.51, h - 0.51));
+   points.push_back(ossimDpt(-0.5, h - 0.51));
+   return points;
+}
+
+//---
+// Distance in pixels from ip of a ground point near its rigorous projection, through the
+// rigorous model's derivatives at ip. The rigorous inverse is only solved to a few hundredths
+// of a pixel, too coarse to measure the cache with.
+//---
+static double pixelError(const SarModel& model, const ossimDpt& ip, double height,
+                         const ossimGpt& gp)
+{
+   ossimGpt g0;
+   ossimGpt gx;
+   ossimGpt gy;
+   model.forward(ip, height, g0);
+   model.forward(ossimDpt(ip.x + 1.0, ip.y), height, gx);
+   model.forward(ossimDpt(ip.x, ip.y + 1.0), height, gy);
+   const double a = gx.latd() - g0.latd();
+   const double b = gy.latd() - g0.latd();
+   const double c = gx.lond() - g0.lond();
+   const double d = gy.lond() - g0.lond();
+   const double dLat = gp.latd() - g0.latd();
+   const double dLon = gp.lond() - g0.lond();
+   const double det = a * d - b * c;
+   const double dx = (d * dLat - b * dLon) / det;
+   const double dy = (a * dLon - c * dLat) / det;
+   return hypot(dx, dy);
+}
+
+//---
+// Noise of the rigorous image to ground in pixels: the largest distance of a point from the
+// middle of its neighbours half a pixel either side, along columns and along lines. SarSensor
+// solves a quartic in closed form, good to a few hundredths of a pixel; the cache is built from
+// those points so it can be off by its tolerance plus this.
+//---
+static double rigorousNoise(const SarModel& model, const vector<ossimDpt>& points, double height)
+{
+   double noise = 0.0;
+   for (size_t i = 0; i < points.size(); ++i)
+   {
+      for (int along = 0; along < 2; ++along)
+      {
+         const double dx = along ? 0.0 : 0.5;
+         const double dy = along ? 0.5 : 0.0;
+         ossimGpt before;
+         ossimGpt after;
+         model.forward(ossimDpt(points[i].x - dx, points[i].y - dy), height, before);
+         model.forward(ossimDpt(points[i].x + dx, points[i].y + dy), height, after);
+         const ossimGpt middle(0.5 * (before.latd() + after.latd()),
+                               0.5 * (before.lond() + after.lond()), height);
+         noise = max(noise, pixelError(model, points[i], height, middle));
+      }
+   }
+   return noise;
+}
+
+static string heightName(double height)
+{
+   ostringstream name;
+   name << "height " << height << " m";
+   return name.str();
+}
+
+static void testForward(const SarModel& model, const ossimProjectionGridCache& cache,
+                        const vector<ossimDpt>& points, double height, double noise)
+{
+   int unanswered = 0;
+   double maxError = 0.0;
+   for (size_t i = 0; i < points.size(); ++i)
+   {
+      ossimGpt gp;
+      if (!cache.lineSampleHeightToWorld(points[i], height, gp))
+      {
+         ++unanswered;
+         continue;
+      }
+      maxError = max(maxError, pixelError(model, points[i], height, gp));
+   }
+   ostringstream what;
+   what << "image to ground, " << heightName(height) << ", " << points.size()
+        << " points: " << unanswered << " unanswered, max error " << maxError << " px";
+   check((unanswered == 0) && (maxError <= TOLERANCE + noise), what.str());
+}
+
+static void testInverse(const SarModel& model, const ossimProjectionGridCache& cache,
+                        const vector<ossimDpt>& points, double height, double noise,
+                        bool allAnswered)
+{
+   int unanswered = 0;
+   double maxError = 0.0;
+   for (size_t i = 0; i < points.size(); ++i)
+   {
+      ossimGpt gp;
+      model.forward(points[i], height, gp);
+      ossimDpt ip;
+      if (!cache.worldToLineSample(gp, ip))
+      {
+         ++unanswered;
+         continue;
+      }
+      ossimDpt rigorous;
+      model.inverse(gp, rigorous);
+      maxError = max(maxError, hypot(ip.x - rigorous.x, ip.y - rigorous.y));
+   }
+   ostringstream what;
+   what << "ground to image, " << heightName(height) << ", " << points.size()
+        << " points: " << unanswered << " unanswered, max error " << maxError << " px";
+   check(((unanswered == 0) || !allAnswered) && (unanswered < (int)points.size()) &&
+         (maxError <= TOLERANCE + noise), what.str());
+}
+
+static void testOutside(const SarModel& model, const ossimProjectionGridCache& cache)
+{
+   const double w = IMAGE_RECT.width();
+   const double h = IMAGE_RECT.height();
+   const ossimDpt OFF_IMAGE[] = { ossimDpt(-0.6, 100.0), ossimDpt(w - 0.5, 100.0),
+                                  ossimDpt(100.0, -0.6), ossimDpt(100.0, h - 0.5),
+                                  ossimDpt(-10.0, -10.0), ossimDpt(w + 10.0, h + 10.0) };
+   bool leftOut = true;
+   ossimGpt gp;
+   for (int i = 0; i < 6; ++i)
+      leftOut = leftOut && !cache.lineSampleHeightToWorld(OFF_IMAGE[i], 0.0, gp);
+   leftOut = leftOut && !cache.lineSampleHeightToWorld(ossimDpt(100.0, 100.0), -500.1, gp);
+   leftOut = leftOut && !cache.lineSampleHeightToWorld(ossimDpt(100.0, 100.0), 9500.0, gp);
+   leftOut = leftOut && !cache.lineSampleHeightToWorld(ossimDpt(ossim::nan(), 100.0), 0.0, gp);
+   check(leftOut, "image to ground off the image or the covered heights is not answered");
+
+   model.forward(ossimDpt(100.0, 100.0), 9500.0, gp);
+   ossimDpt ip;
+   leftOut = !cache.worldToLineSample(gp, ip);
+   model.forward(ossimDpt(-2000.0, 100.0), 0.0, gp);
+   leftOut = leftOut && !cache.worldToLineSample(gp, ip);
+   model.forward(ossimDpt(100.0, h + 2000.0), 0.0, gp);
+   leftOut = leftOut && !cache.worldToLineSample(gp, ip);
+   check(leftOut, "ground to image off the footprint or the covered heights is not answered");
+}
+
+// Threads project through the holder while it is reset. Returns the number of points that came
+// back wrong.
+static int testReset(const SarModel& model, const vector<ossimDpt>& points)
+{
+   ossimProjectionGridCache::Holder holder;
+   auto forward = [&model](const ossimDpt& ip, const double& h, ossimGpt& gp)
+   {
+      model.forward(ip, h, gp);
+   };
+   auto inverse = [&model](const ossimGpt& gp, ossimDpt& ip)
+   {
+      model.inverse(gp, ip);
+   };
+
+   atomic<bool> done(false);
+   atomic<int> wrong(0);
+   vector<thread> threads;
+   for (int t = 0; t < THREADS; ++t)
+   {
+      threads.push_back(thread([&, t]()
+      {
+         for (size_t n = t; !done; n = (n + 97) % points.size())
+         {
+            ossimProjectionGridCache::ConstPtr cache = holder.get(IMAGE_RECT, forward, inverse);
+            ossimGpt gp;
+            if (!cache || !cache->lineSampleHeightToWorld(points[n], 250.0, gp))
+               model.forward(points[n], 250.0, gp);
+            ossimDpt ip;
+            if (!cache || !cache->worldToLineSample(gp, ip))
+               model.inverse(gp, ip);
+            if (!(hypot(ip.x - points[n].x, ip.y - points[n].y) <= 2.0 * TOLERANCE))
+               ++wrong;
+         }
+      }));
+   }
+   for (int r = 0; r < RESETS; ++r)
+   {
+      this_thread::sleep_for(chrono::milliseconds(2));
+      holder.reset();
+   }
+   done = true;
+   for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+   return wrong;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   SarModel model;
+   model.params.set_rwl(0.0555);
+   model.params.set_sightDirection(SensorParams::Right);
+   model.params.set_semiMajorAxis(6378137.0);
+   model.params.set_semiMinorAxis(6356752.3141);
+   model.params.set_dopcen(120.0);
+   model.params.set_dopcenLinear(-3.0);
+   model.position = makePlatformPosition();
+
+   const vector<ossimDpt> points = testPoints();
+   {
+      ossimProjectionGridCache cache(
+         IMAGE_RECT, TOLERANCE,
+         [&model](const ossimDpt& ip, const double& h, ossimGpt& gp) { model.forward(ip, h, gp); },
+         [&model](const ossimGpt& gp, ossimDpt& ip) { model.inverse(gp, ip); });
+
+      const double HEIGHTS[] = { -500.0, 0.0, 1234.5, 9499.0 };
+      double noise = 0.0;
+      for (int i = 0; i < 4; ++i)
+         noise = max(noise, rigorousNoise(model, points, HEIGHTS[i]));
+      ostringstream what;
+      what << "rigorous model noise " << noise << " px, under the tolerance";
+      check(noise < TOLERANCE, what.str());
+
+      for (int i = 0; i < 4; ++i)
+         testForward(model, cache, points, HEIGHTS[i], noise);
+
+      // The ground grid covers the footprint around height 0, higher up it may run off it.
+      testInverse(model, cache, points, 0.0, noise, true);
+      testInverse(model, cache, points, -500.0, noise, true);
+      testInverse(model, cache, points, 1234.5, noise, false);
+      testOutside(model, cache);
+   }
+
+   ossimPreferences::instance()->addPreference(ossimProjectionGridCache::ENABLED_PREF_KW, "true");
+   const int wrong = testReset(model, points);
+   ostringstream what;
+   what << THREADS << " threads projecting through a holder reset " << RESETS << " times: "
+        << wrong << " wrong";
+   check(wrong == 0, what.str());
+
+   delete model.position;
+
+   return ossimPluginTest::summary();
+}
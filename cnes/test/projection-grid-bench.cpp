@@ -0,0 +1,343 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Cost per point of the grid and array projection calls of the SAR and Formosat models against
+// one call per point, on the 16 x 16 interpolation grids of ortho tiles and on full 1024 point
+// lines, with the largest difference between the two.
+//
+// First on a synthetic SAR image with SarSensor alone, the way
+// ossimGeometricSarSensorModel::lineSampleHeightToWorldGrid uses it: orbit interpolated once per
+// grid row against once per point. Then each product given is opened through the plugin
+// projection factory and its model timed: lineSampleHeightToWorldGrid against
+// lineSampleHeightToWorld for SAR and Formosat models, lineSampleHeightToWorldArray for Formosat
+// and worldToLineSampleArray against worldToLineSample for SAR. The projection grid cache is
+// turned off so both sides run the rigorous model.
+//
+// Usage: projection-grid-bench [points] [product ...]
+
+#include "../src/ossimFormosatModel.h"
+#include "../src/ossimGeometricSarSensorModel.h"
+#include "../src/ossimPluginProjectionFactory.h"
+#include "../src/ossimProjectionGridCache.h"
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimPreferences.h>
+#include <ossim/projection/ossimProjection.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+
+static const int IMAGE_SIZE = 20000;
+static const double NEAR_RANGE = 850.0e3;
+static const double RANGE_STEP = 2.5;
+static const double FIRST_TIME = 150.0;
+static const double LINE_TIME = 1.0e-3;
+
+// Shapes timed: the 16 x 16 nodes of a 256 pixel tile, and one line of 1024 points.
+struct Shape
+{
+   const char* name;
+   int cols;
+   int rows;
+   double spacing;
+};
+static const Shape SHAPES[] = { { "16 x 16 grid", 16, 16, 16.0 },
+                                { "1024 point line", 1024, 1, 1.0 } };
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+// Origin of the n-th shape, scattered over an image of the size given.
+static ossimDpt origin(int n, const Shape& shape, const ossimDpt& size)
+{
+   const double w = max(1.0, size.x - shape.cols * shape.spacing);
+   const double h = max(1.0, size.y - shape.rows * shape.spacing);
+   return ossimDpt(fmod(n * 7919.3, w), fmod(n * 104729.7, h));
+}
+
+static double groundDistance(const ossimGpt& a, const ossimGpt& b)
+{
+   if (a.isLatNan() || b.isLatNan())
+      return (a.isLatNan() && b.isLatNan()) ? 0.0 : ossim::nan();
+   const double dlat = (a.latd() - b.latd()) * 111320.0;
+   const double dlon = (a.lond() - b.lond()) * 111320.0 * cos(a.latr());
+   return sqrt(dlat * dlat + dlon * dlon);
+}
+
+static void report(const string& name, double perPoint, double batch, double difference,
+                   const char* unit)
+{
+   cout << "  " << setw(34) << left << name << right << fixed << setprecision(3) << setw(10)
+        << perPoint << setw(10) << batch << setw(8) << setprecision(2) << perPoint / batch
+        << "x" << setw(12) << setprecision(6) << difference << " " << unit << endl;
+}
+
+// SarSensor alone: orbit interpolated for every point, then once per grid row.
+static void benchSarSensor(int points)
+{
+   SensorParams params;
+   params.set_rwl(0.0555);
+   params.set_sightDirection(SensorParams::Right);
+   params.set_semiMajorAxis(6378137.0);
+   params.set_semiMinorAxis(6356752.3141);
+   params.set_dopcen(120.0);
+   params.set_dopcenLinear(-3.0);
+   PlatformPosition* position = makePlatformPosition();
+   const ossimDpt size(IMAGE_SIZE, IMAGE_SIZE);
+
+   cout << "SarSensor, synthetic " << IMAGE_SIZE << " x " << IMAGE_SIZE
+        << " image     per point (us)  grid (us)    gain  difference" << endl;
+   for (size_t s = 0; s < sizeof(SHAPES) / sizeof(SHAPES[0]); ++s)
+   {
+      const Shape& shape = SHAPES[s];
+      const int shapes = max(1, points / (shape.cols * shape.rows));
+      const size_t n = (size_t) shapes * shape.cols * shape.rows;
+      vector<double> perPoint(2 * n);
+      vector<double> grid(2 * n);
+
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      double* p = &perPoint[0];
+      for (int k = 0; k < shapes; ++k)
+      {
+         const ossimDpt o = origin(k, shape, size);
+         for (int r = 0; r < shape.rows; ++r)
+         {
+            const JSDDateTime date = makeDate(FIRST_TIME + LINE_TIME * (o.y + r * shape.spacing));
+            for (int c = 0; c < shape.cols; ++c, p += 2)
+            {
+               SarSensor::ImageToWorld(params, *position,
+                                       NEAR_RANGE + RANGE_STEP * (o.x + c * shape.spacing),
+                                       date, 100.0, p[0], p[1]);
+            }
+         }
+      }
+      const double perPointTime = 1.0e6 * seconds(start) / n;
+
+      start = chrono::steady_clock::now();
+      p = &grid[0];
+      vector<double> range(shape.cols);
+      for (int k = 0; k < shapes; ++k)
+      {
+         const ossimDpt o = origin(k, shape, size);
+         for (int c = 0; c < shape.cols; ++c)
+            range[c] = NEAR_RANGE + RANGE_STEP * (o.x + c * shape.spacing);
+         for (int r = 0; r < shape.rows; ++r)
+         {
+            const JSDDateTime date = makeDate(FIRST_TIME + LINE_TIME * (o.y + r * shape.spacing));
+            double pos[3];
+            double speed[3];
+            position->Interpolate(date, pos, speed);
+            const GeographicEphemeris geoEph(date, pos, speed);
+            for (int c = 0; c < shape.cols; ++c, p += 2)
+               SarSensor::ImageToWorld(params, geoEph, range[c], 100.0, p[0], p[1]);
+         }
+      }
+      const double gridTime = 1.0e6 * seconds(start) / n;
+
+      double difference = 0.0;
+      for (size_t i = 0; i < 2 * n; ++i)
+         difference = max(difference, fabs(perPoint[i] - grid[i]));
+      report(shape.name, perPointTime, gridTime, difference, "deg");
+   }
+   delete position;
+}
+
+// Image to ground on the model: one call per node against the grid call, and the array call.
+static void benchForward(const ossimSensorModel& model, int points, const ossimDpt& size,
+                         const ossimGeometricSarSensorModel* sar,
+                         const ossimFormosatModel* formosat)
+{
+   for (size_t s = 0; s < sizeof(SHAPES) / sizeof(SHAPES[0]); ++s)
+   {
+      const Shape& shape = SHAPES[s];
+      const int shapes = max(1, points / (shape.cols * shape.rows));
+      const size_t count = (size_t) shape.cols * shape.rows;
+      const size_t n = shapes * count;
+      const double HEIGHT = 100.0;
+      vector<ossimDpt> imagePoints(n);
+      for (int k = 0; k < shapes; ++k)
+      {
+         const ossimDpt o = origin(k, shape, size);
+         for (int r = 0; r < shape.rows; ++r)
+            for (int c = 0; c < shape.cols; ++c)
+               imagePoints[k * count + r * shape.cols + c] =
+                  ossimDpt(o.x + c * shape.spacing, o.y + r * shape.spacing);
+      }
+      vector<ossimGpt> perPoint(n);
+      vector<ossimGpt> grid(n);
+
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (size_t i = 0; i < n; ++i)
+         model.lineSampleHeightToWorld(imagePoints[i], HEIGHT, perPoint[i]);
+      const double perPointTime = 1.0e6 * seconds(start) / n;
+
+      const ossimDpt spacing(shape.spacing, shape.spacing);
+      const ossimIpt gridSize(shape.cols, shape.rows);
+      start = chrono::steady_clock::now();
+      for (int k = 0; k < shapes; ++k)
+      {
+         if (sar)
+            sar->lineSampleHeightToWorldGrid(imagePoints[k * count], spacing, gridSize, HEIGHT,
+                                             &grid[k * count]);
+         else
+            formosat->lineSampleHeightToWorldGrid(imagePoints[k * count], spacing, gridSize,
+                                                  HEIGHT, &grid[k * count]);
+      }
+      const double gridTime = 1.0e6 * seconds(start) / n;
+
+      double difference = 0.0;
+      for (size_t i = 0; i < n; ++i)
+         difference = max(difference, groundDistance(perPoint[i], grid[i]));
+      report(string(shape.name) + ", grid", perPointTime, gridTime, difference, "m");
+
+      if (formosat)
+      {
+         const vector<double> heights(n, HEIGHT);
+         start = chrono::steady_clock::now();
+         formosat->lineSampleHeightToWorldArray(&imagePoints[0], &heights[0], n, &grid[0]);
+         const double arrayTime = 1.0e6 * seconds(start) / n;
+         difference = 0.0;
+         for (size_t i = 0; i < n; ++i)
+            difference = max(difference, groundDistance(perPoint[i], grid[i]));
+         report(string(shape.name) + ", array", perPointTime, arrayTime, difference, "m");
+      }
+   }
+}
+
+// Ground to image on a SAR model: one call per point against the array call.
+static void benchInverse(const ossimGeometricSarSensorModel& sar, int points,
+                         const ossimDpt& size)
+{
+   for (size_t s = 0; s < sizeof(SHAPES) / sizeof(SHAPES[0]); ++s)
+   {
+      const Shape& shape = SHAPES[s];
+      const int shapes = max(1, points / (shape.cols * shape.rows));
+      const size_t count = (size_t) shape.cols * shape.rows;
+      const size_t n = shapes * count;
+      vector<ossimGpt> worldPoints(n);
+      vector<ossimDpt> perPoint(n);
+      vector<ossimDpt> array(n);
+      for (int k = 0; k < shapes; ++k)
+      {
+         const ossimDpt o = origin(k, shape, size);
+         sar.lineSampleHeightToWorldGrid(o, ossimDpt(shape.spacing, shape.spacing),
+                                         ossimIpt(shape.cols, shape.rows), 100.0,
+                                         &worldPoints[k * count]);
+      }
+
+      chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (size_t i = 0; i < n; ++i)
+         sar.worldToLineSample(worldPoints[i], perPoint[i]);
+      const double perPointTime = 1.0e6 * seconds(start) / n;
+
+      start = chrono::steady_clock::now();
+      for (int k = 0; k < shapes; ++k)
+         sar.worldToLineSampleArray(&worldPoints[k * count], &array[k * count], count);
+      const double arrayTime = 1.0e6 * seconds(start) / n;
+
+      double difference = 0.0;
+      for (size_t i = 0; i < n; ++i)
+      {
+         if (perPoint[i].hasNans() != array[i].hasNans())
+            difference = ossim::nan();
+         else if (!perPoint[i].hasNans())
+            difference = max(difference, (perPoint[i] - array[i]).length());
+      }
+      report(string(shape.name) + ", inverse array", perPointTime, arrayTime, difference, "px");
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const int points = (argc > 1) ? atoi(argv[1]) : 100000;
+   ossimPreferences::instance()->addPreference(ossimProjectionGridCache::ENABLED_PREF_KW,
+                                               "false");
+
+   benchSarSensor(points);
+
+   for (int i = 2; i < argc; ++i)
+   {
+      const ossimFilename product(argv[i]);
+      ossimRefPtr<ossimProjection> projection =
+         ossimPluginProjectionFactory::instance()->createProjection(product, 0);
+      const ossimGeometricSarSensorModel* sar =
+         dynamic_cast<const ossimGeometricSarSensorModel*>(projection.get());
+      const ossimFormosatModel* formosat =
+         dynamic_cast<const ossimFormosatModel*>(projection.get());
+      if (!sar && !formosat)
+      {
+         cout << product << ": not a SAR or Formosat model" << endl;
+         continue;
+      }
+      const ossimSensorModel* model = sar ? (const ossimSensorModel*) sar : formosat;
+      const ossimDpt size(model->getImageClipRect().width(),
+                          model->getImageClipRect().height());
+      cout << product << ", " << size.x << " x " << size.y << "   per point (us)  batch (us)"
+           << "    gain  difference" << endl;
+      benchForward(*model, points, size, sar, formosat);
+      if (sar)
+         benchInverse(*sar, points, size);
+   }
+   return 0;
+}
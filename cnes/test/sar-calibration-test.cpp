@@ -0,0 +1,476 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Accuracy tests for ossimSarCalibration. The kernels are checked against the scalar formula and
+// a double precision per pixel reference, for detected and complex data and every tail length.
+// A model with known gain and offset, varying with the column and slowly with the line, checks
+// the per block coefficients: each block holds the model at its center line, and a calibrated
+// tile stays within the error the line variation allows over half a block. The block cache is
+// also read from several threads at once. Last, two band images go through
+// ossimSarCalibrationFilter: a detected product's bands are calibrated each on its own, a complex
+// product's are taken as I and Q.
+
+#include "../src/ossimSarCalibration.h"
+#include "../src/ossimGeometricSarSensorModel.h"
+#include "../src/ossimSarCalibrationFilter.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const ossim_uint32 WIDTH = 1531; // Not a multiple of the SIMD width.
+static const ossim_uint32 HEIGHT = 1024;
+
+// Relative change of the gain per line. Over half a block of 256 lines the gain moves by
+// 128 * LINE_SLOPE = 1.3e-4 relative.
+static const double LINE_SLOPE = 1.0e-6;
+
+// Known calibration: sigma0 gain rises across the swath, the noise floor dips mid swath.
+class TestModel : public ossimGeometricSarSensorModel
+{
+public:
+   virtual ossimObject* dup() const
+   {
+      return new TestModel(*this);
+   }
+
+   virtual double getSlantRangeFromGeoreferenced(double col) const
+   {
+      return col;
+   }
+
+   static double gain(ossimSarCalibration::Measure measure, double line, double col)
+   {
+      double g = 2.0e-6 * (1.0 + col / WIDTH) * (1.0 + LINE_SLOPE * line);
+      if (measure == ossimSarCalibration::BETA0)
+         g *= 0.8;
+      return g;
+   }
+
+   static double offset(bool removeNoise, double line, double col)
+   {
+      double o = -1.0e-3;
+      if (removeNoise)
+      {
+         const double x = (col - 0.5 * WIDTH) / WIDTH;
+         o -= 1.0e-2 * (1.0 - x * x) * (1.0 + LINE_SLOPE * line);
+      }
+      return o;
+   }
+
+   virtual bool getCalibrationCoefficients(ossimSarCalibration::Measure measure,
+                                           bool removeNoise,
+                                           double line,
+                                           ossim_int32 firstCol,
+                                           vector<double>& gain,
+                                           vector<double>& offset) const
+   {
+      if (measure == ossimSarCalibration::GAMMA0)
+         return false;
+      offset.resize(gain.size());
+      for (size_t c = 0; c < gain.size(); ++c)
+      {
+         const double col = firstCol + static_cast<double>(c);
+         gain[c] = TestModel::gain(measure, line, col);
+         offset[c] = TestModel::offset(removeNoise, line, col);
+      }
+      return true;
+   }
+
+private:
+   virtual bool InitPlatformPosition(const ossimKeywordlist&, const char*) { return false; }
+   virtual bool InitSensorParams(const ossimKeywordlist&, const char*) { return false; }
+   virtual bool InitRefPoint(const ossimKeywordlist&, const char*) { return false; }
+   virtual bool InitSRGR(const ossimKeywordlist&, const char*) { return false; }
+};
+
+// A model without calibration, the base class default.
+class UncalibratedModel : public TestModel
+{
+public:
+   virtual bool getCalibrationCoefficients(ossimSarCalibration::Measure measure,
+                                           bool removeNoise,
+                                           double line,
+                                           ossim_int32 firstCol,
+                                           vector<double>& gain,
+                                           vector<double>& offset) const
+   {
+      return ossimGeometricSarSensorModel::getCalibrationCoefficients(
+         measure, removeNoise, line, firstCol, gain, offset);
+   }
+};
+
+// A complex product with the same calibration.
+class ComplexModel : public TestModel
+{
+public:
+   virtual bool isComplex() const
+   {
+      return true;
+   }
+};
+
+static float randomFloat(float low, float high)
+{
+   return low + (high - low) * (static_cast<float>(rand()) / RAND_MAX);
+}
+
+static void testKernels()
+{
+   cout << "Kernels (" << (ossimSarCalibration::simdSupported() ? "SIMD" : "scalar") << "):"
+        << endl;
+   const ossim_uint32 SIZE = 4099;
+   vector<ossim_float32> re(SIZE), im(SIZE), gain(SIZE), offset(SIZE), out(SIZE);
+   for (ossim_uint32 i = 0; i < SIZE; ++i)
+   {
+      re[i] = randomFloat(-3000.0f, 3000.0f);
+      im[i] = randomFloat(-3000.0f, 3000.0f);
+      gain[i] = randomFloat(1.0e-7f, 1.0e-5f);
+      offset[i] = randomFloat(-1.0e-3f, 1.0e-3f);
+   }
+
+   // Every tail length after the vector loop, then a whole line.
+   vector<ossim_uint32> counts;
+   for (ossim_uint32 n = 0; n <= 17; ++n)
+      counts.push_back(n);
+   counts.push_back(SIZE);
+
+   bool detectedSame = true;
+   bool complexSame = true;
+   bool untouched = true;
+   double detectedError = 0.0;
+   double complexError = 0.0;
+   for (size_t k = 0; k < counts.size(); ++k)
+   {
+      const ossim_uint32 n = counts[k];
+      out.assign(SIZE, -7.0f);
+      ossimSarCalibration::applyDetected(&re[0], &gain[0], &offset[0], &out[0], n);
+      for (ossim_uint32 i = 0; i < n; ++i)
+      {
+         const ossim_float32 scalar = re[i] * re[i] * gain[i] + offset[i];
+         detectedSame = detectedSame && (out[i] == scalar);
+         const double exact = static_cast<double>(re[i]) * re[i] * gain[i] + offset[i];
+         // Relative to the signal term, offset may cancel it.
+         const double scale = static_cast<double>(re[i]) * re[i] * gain[i] + fabs(offset[i]);
+         detectedError = max(detectedError, fabs(out[i] - exact) / scale);
+      }
+      untouched = untouched && (n == SIZE || out[n] == -7.0f);
+
+      out.assign(SIZE, -7.0f);
+      ossimSarCalibration::applyComplex(&re[0], &im[0], &gain[0], &offset[0], &out[0], n);
+      for (ossim_uint32 i = 0; i < n; ++i)
+      {
+         const ossim_float32 scalar = (re[i] * re[i] + im[i] * im[i]) * gain[i] + offset[i];
+         complexSame = complexSame && (out[i] == scalar);
+         const double power = static_cast<double>(re[i]) * re[i] +
+            static_cast<double>(im[i]) * im[i];
+         const double exact = power * gain[i] + offset[i];
+         const double scale = power * gain[i] + fabs(offset[i]);
+         complexError = max(complexError, fabs(out[i] - exact) / scale);
+      }
+      untouched = untouched && (n == SIZE || out[n] == -7.0f);
+   }
+   check(detectedSame, "detected kernel equals the scalar formula for every length");
+   check(complexSame, "complex kernel equals the scalar formula for every length");
+   check(untouched, "nothing written past count");
+
+   ostringstream what;
+   what << "within float rounding of the double reference (detected " << detectedError
+        << ", complex " << complexError << ")";
+   check((detectedError < 1.0e-6) && (complexError < 1.0e-6), what.str());
+}
+
+static void testInitialize()
+{
+   cout << "Initialize:" << endl;
+   TestModel model;
+   UncalibratedModel uncalibrated;
+   ossimSarCalibration calibration;
+   check(!calibration.initialize(0, ossimSarCalibration::SIGMA0, false, WIDTH, 256),
+         "no model rejected");
+   check(!calibration.getBlock(0), "no block before a successful initialize");
+   check(!calibration.initialize(&model, ossimSarCalibration::SIGMA0, false, 0, 256),
+         "zero width rejected");
+   check(!calibration.initialize(&uncalibrated, ossimSarCalibration::SIGMA0, false, WIDTH, 256),
+         "model without calibration rejected");
+   check(!calibration.initialize(&model, ossimSarCalibration::GAMMA0, false, WIDTH, 256),
+         "measure the model lacks rejected");
+   check(calibration.initialize(&model, ossimSarCalibration::BETA0, true, WIDTH, 0) &&
+         (calibration.getWidth() == WIDTH),
+         "calibrated model accepted");
+
+   ossimSarCalibration::Measure measure = ossimSarCalibration::SIGMA0;
+   bool roundTrip = true;
+   for (int m = ossimSarCalibration::SIGMA0; m <= ossimSarCalibration::GAMMA0; ++m)
+   {
+      const ossimSarCalibration::Measure expected = static_cast<ossimSarCalibration::Measure>(m);
+      roundTrip = roundTrip &&
+         ossimSarCalibration::stringToMeasure(ossimSarCalibration::measureToString(expected),
+                                              measure) &&
+         (measure == expected);
+   }
+   check(roundTrip, "measure names round trip");
+   check(ossimSarCalibration::stringToMeasure(" Gamma0 ", measure) &&
+         (measure == ossimSarCalibration::GAMMA0), "measure names trimmed, any case");
+   check(!ossimSarCalibration::stringToMeasure("sigma", measure), "unknown measure rejected");
+}
+
+// Block of line holds the model at the block center line, rounded to float.
+static bool blockMatchesModel(const ossimSarCalibration::Block& block,
+                              ossimSarCalibration::Measure measure,
+                              bool removeNoise,
+                              ossim_uint32 line,
+                              ossim_uint32 blockLines)
+{
+   if ((block.m_gain.size() != WIDTH) || (block.m_offset.size() != WIDTH))
+      return false;
+   const double center = (line / blockLines) * static_cast<double>(blockLines) +
+      0.5 * (blockLines - 1);
+   for (ossim_uint32 c = 0; c < WIDTH; ++c)
+   {
+      if ((block.m_gain[c] != static_cast<ossim_float32>(TestModel::gain(measure, center, c))) ||
+          (block.m_offset[c] != static_cast<ossim_float32>(TestModel::offset(removeNoise, center,
+                                                                             c))))
+         return false;
+   }
+   return true;
+}
+
+static void testBlocks()
+{
+   cout << "Blocks:" << endl;
+   const ossim_uint32 BLOCK = 256;
+   TestModel model;
+   ossimSarCalibration calibration;
+   calibration.initialize(&model, ossimSarCalibration::SIGMA0, true, WIDTH, BLOCK);
+
+   shared_ptr<const ossimSarCalibration::Block> first = calibration.getBlock(0);
+   check(first && blockMatchesModel(*first, ossimSarCalibration::SIGMA0, true, 0, BLOCK),
+         "block holds the model at its center line");
+   check(calibration.getBlock(BLOCK - 1) == first, "lines of a block share it");
+   shared_ptr<const ossimSarCalibration::Block> second = calibration.getBlock(BLOCK);
+   check(second && (second != first) &&
+         blockMatchesModel(*second, ossimSarCalibration::SIGMA0, true, BLOCK, BLOCK),
+         "next line starts the next block");
+
+   // More blocks than are cached, then back to the first.
+   bool allMatch = true;
+   for (ossim_uint32 line = 0; line < 40 * BLOCK; line += BLOCK / 2)
+   {
+      shared_ptr<const ossimSarCalibration::Block> block = calibration.getBlock(line);
+      allMatch = allMatch && block &&
+         blockMatchesModel(*block, ossimSarCalibration::SIGMA0, true, line, BLOCK);
+   }
+   shared_ptr<const ossimSarCalibration::Block> again = calibration.getBlock(0);
+   allMatch = allMatch && again &&
+      blockMatchesModel(*again, ossimSarCalibration::SIGMA0, true, 0, BLOCK);
+   check(allMatch, "blocks recomputed after eviction hold the same values");
+   check(blockMatchesModel(*first, ossimSarCalibration::SIGMA0, true, 0, BLOCK),
+         "evicted block still valid for its holder");
+
+   calibration.initialize(&model, ossimSarCalibration::BETA0, false, WIDTH, BLOCK);
+   shared_ptr<const ossimSarCalibration::Block> beta = calibration.getBlock(0);
+   check(beta && (beta != first) &&
+         blockMatchesModel(*beta, ossimSarCalibration::BETA0, false, 0, BLOCK),
+         "initialize drops the cached blocks");
+}
+
+// Calibrates HEIGHT lines of complex data with blocks of blockLines and returns the largest
+// error relative to the per pixel double evaluation of the model.
+static double tileError(ossim_uint32 blockLines, const vector<ossim_float32>& re,
+                        const vector<ossim_float32>& im)
+{
+   TestModel model;
+   ossimSarCalibration calibration;
+   calibration.initialize(&model, ossimSarCalibration::SIGMA0, true, WIDTH, blockLines);
+   vector<ossim_float32> out(WIDTH);
+   double error = 0.0;
+   for (ossim_uint32 line = 0; line < HEIGHT; ++line)
+   {
+      shared_ptr<const ossimSarCalibration::Block> block = calibration.getBlock(line);
+      if (!block)
+         return 1.0;
+      const ossim_float32* r = &re[line * WIDTH];
+      const ossim_float32* q = &im[line * WIDTH];
+      ossimSarCalibration::applyComplex(r, q, &block->m_gain[0], &block->m_offset[0], &out[0],
+                                        WIDTH);
+      for (ossim_uint32 c = 0; c < WIDTH; ++c)
+      {
+         const double power = static_cast<double>(r[c]) * r[c] + static_cast<double>(q[c]) * q[c];
+         const double g = TestModel::gain(ossimSarCalibration::SIGMA0, line, c);
+         const double o = TestModel::offset(true, line, c);
+         error = max(error, fabs(out[c] - (g * power + o)) / (g * power + fabs(o)));
+      }
+   }
+   return error;
+}
+
+static void testAccuracy()
+{
+   cout << "Accuracy:" << endl;
+   vector<ossim_float32> re(WIDTH * HEIGHT);
+   vector<ossim_float32> im(WIDTH * HEIGHT);
+   for (size_t i = 0; i < re.size(); ++i)
+   {
+      re[i] = randomFloat(-500.0f, 500.0f);
+      im[i] = randomFloat(-500.0f, 500.0f);
+   }
+
+   const double perLine = tileError(1, re, im);
+   ostringstream what;
+   what << "one block per line within float rounding (" << perLine << ")";
+   check(perLine < 1.0e-6, what.str());
+
+   // The coefficients move by LINE_SLOPE per line, at most half a block away from the center.
+   const ossim_uint32 BLOCKS[] = { 16, 256 };
+   for (size_t i = 0; i < sizeof(BLOCKS) / sizeof(BLOCKS[0]); ++i)
+   {
+      const double bound = 0.5 * BLOCKS[i] * LINE_SLOPE + 1.0e-6;
+      const double error = tileError(BLOCKS[i], re, im);
+      ostringstream blockWhat;
+      blockWhat << "blocks of " << BLOCKS[i] << " lines within " << bound << " (" << error << ")";
+      check(error < bound, blockWhat.str());
+   }
+}
+
+static void testThreads()
+{
+   cout << "Threads:" << endl;
+   const ossim_uint32 BLOCK = 64;
+   const int THREADS = 8;
+   TestModel model;
+   ossimSarCalibration calibration;
+   calibration.initialize(&model, ossimSarCalibration::SIGMA0, true, WIDTH, BLOCK);
+
+   atomic<int> mismatches(0);
+   vector<thread> threads;
+   for (int t = 0; t < THREADS; ++t)
+   {
+      threads.push_back(thread([&, t]() {
+         // Interleaved walks over more blocks than are cached.
+         for (ossim_uint32 n = 0; n < 4 * HEIGHT; n += 7)
+         {
+            const ossim_uint32 line = (n + t * HEIGHT / THREADS) % (4 * HEIGHT);
+            shared_ptr<const ossimSarCalibration::Block> block = calibration.getBlock(line);
+            if (!block ||
+                !blockMatchesModel(*block, ossimSarCalibration::SIGMA0, true, line, BLOCK))
+               ++mismatches;
+         }
+      }));
+   }
+   for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+
+   ostringstream what;
+   what << THREADS << " threads read the right blocks (" << mismatches.load()
+        << " mismatches)";
+   check(mismatches.load() == 0, what.str());
+}
+
+// Largest error of the filter's tile relative to the model at each pixel, for sigma0 without noise
+// removal, the filter's default. Complex takes the image's two bands as I and Q.
+static double filterError(const ossimRefPtr<ossimImageData>& image,
+                          const ossimRefPtr<ossimImageData>& tile,
+                          bool complex)
+{
+   const ossim_uint32 w = image->getWidth();
+   const ossim_uint32 h = image->getHeight();
+   const ossim_uint32 bands = complex ? 1 : image->getNumberOfBands();
+   if (!tile.valid() || (tile->getNumberOfBands() != bands) ||
+       (tile->getScalarType() != OSSIM_FLOAT32))
+      return 1.0;
+
+   double error = 0.0;
+   for (ossim_uint32 band = 0; band < bands; ++band)
+   {
+      const ossim_float32* out = static_cast<const ossim_float32*>(tile->getBuf(band));
+      const ossim_float32* re = static_cast<const ossim_float32*>(image->getBuf(band));
+      const ossim_float32* im = static_cast<const ossim_float32*>(image->getBuf(1));
+      for (ossim_uint32 y = 0; y < h; ++y)
+      {
+         for (ossim_uint32 x = 0; x < w; ++x)
+         {
+            const ossim_uint32 i = y * w + x;
+            double power = static_cast<double>(re[i]) * re[i];
+            if (complex)
+               power += static_cast<double>(im[i]) * im[i];
+            const double g = TestModel::gain(ossimSarCalibration::SIGMA0, y, x);
+            const double o = TestModel::offset(false, y, x);
+            error = max(error, fabs(out[i] - (g * power + o)) / (g * power + fabs(o)));
+         }
+      }
+   }
+   return error;
+}
+
+static void testFilter()
+{
+   cout << "Filter:" << endl;
+   const ossim_uint32 W = 300;
+   const ossim_uint32 H = 64;
+   ossimRefPtr<ossimImageData> image = new ossimImageData(0, OSSIM_FLOAT32, 2, W, H);
+   image->initialize();
+   for (ossim_uint32 band = 0; band < 2; ++band)
+   {
+      ossim_float32* buf = static_cast<ossim_float32*>(image->getBuf(band));
+      for (ossim_uint32 i = 0; i < W * H; ++i)
+         buf[i] = randomFloat(1.0f, 500.0f);
+   }
+   image->validate();
+
+   // The line moves the coefficients by at most half the default block of 256 lines.
+   const double bound = 128 * LINE_SLOPE + 1.0e-6;
+   for (int complex = 0; complex < 2; ++complex)
+   {
+      ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource;
+      source->setImage(image);
+      ossimSensorModel* model = complex ? new ComplexModel : new TestModel;
+      source->setImageGeometry(new ossimImageGeometry(0, model));
+
+      ossimRefPtr<ossimSarCalibrationFilter> filter = new ossimSarCalibrationFilter;
+      filter->connectMyInputTo(source.get());
+      filter->initialize();
+      const ossim_uint32 outBands = filter->getNumberOfOutputBands();
+      const double error = filterError(image, filter->getTile(image->getImageRectangle()),
+                                       complex != 0);
+
+      const string product = complex ? "complex product: " : "detected product: ";
+      check(outBands == (complex ? 1u : 2u),
+            product + to_string(outBands) + " output band" + (outBands > 1 ? "s" : ""));
+      ostringstream what;
+      what << product << (complex ? "I and Q calibrated together" : "each band calibrated")
+           << " within " << bound << " (" << error << ")";
+      check(error < bound, what.str());
+
+   }
+}
+
+int main()
+{
+   srand(40);
+
+   testKernels();
+   testInitialize();
+   testBlocks();
+   testAccuracy();
+   testThreads();
+   testFilter();
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,234 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Cost per point of SarSensor::WorldToImage, the direct range-Doppler inverse behind
+// ossimGeometricSarSensorModel::worldToLineSample, against the ossimSensorModel::worldToLineSample
+// iteration it replaced, on a synthetic 20000 x 20000 SAR image. The direct inverse is timed
+// from the image centre, as a model's first call, and from the last point, as the model seeds
+// it on each thread. Points come in 256 pixel tiles at heights from 0 to 4 km, as a resampler
+// asks for them; SarSensor::ImageToWorld is timed on the same points for reference.
+//
+// Usage: sar-inverse-bench [points] [right|left]
+
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include <ossim/init/ossimInit.h>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+
+static const int IMAGE_SIZE = 20000;
+static const double NEAR_RANGE = 850.0e3;
+static const double RANGE_STEP = 2.5;
+static const double FIRST_TIME = 150.0;
+static const double LINE_TIME = 1.0e-3;
+static const int TILE = 256;
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+struct Point
+{
+   double x;
+   double y;
+   double height;
+   double lon;
+   double lat;
+};
+
+static bool forward(const SensorParams& params, const PlatformPosition& position, Point& p)
+{
+   return SarSensor::ImageToWorld(params, position, NEAR_RANGE + RANGE_STEP * p.x,
+                                  makeDate(FIRST_TIME + LINE_TIME * p.y), p.height,
+                                  p.lon, p.lat) == 0;
+}
+
+//---
+// The ossimSensorModel::worldToLineSample iteration: from the image centre, Newton steps on the
+// forward model with partials taken over one pixel, until a step is below 0.1 pixel. Returns
+// the number of forward localisations.
+//---
+static int iterative(const SensorParams& params, const PlatformPosition& position,
+                     const Point& target, double& x, double& y)
+{
+   x = 0.5 * (IMAGE_SIZE - 1);
+   y = 0.5 * (IMAGE_SIZE - 1);
+   int forwards = 0;
+   for (int i = 0; i < 20; ++i)
+   {
+      Point p0 = { x, y, target.height, 0.0, 0.0 };
+      Point px = { x + 1.0, y, target.height, 0.0, 0.0 };
+      Point py = { x, y + 1.0, target.height, 0.0, 0.0 };
+      forwards += 3;
+      if (!forward(params, position, p0) || !forward(params, position, px) ||
+          !forward(params, position, py))
+         break;
+      const double det = (px.lon - p0.lon) * (py.lat - p0.lat) -
+         (py.lon - p0.lon) * (px.lat - p0.lat);
+      if (det == 0.0)
+         break;
+      const double dlon = target.lon - p0.lon;
+      const double dlat = target.lat - p0.lat;
+      const double dx = ((py.lat - p0.lat) * dlon - (py.lon - p0.lon) * dlat) / det;
+      const double dy = ((px.lon - p0.lon) * dlat - (px.lat - p0.lat) * dlon) / det;
+      x += dx;
+      y += dy;
+      if ((fabs(dx) < 0.1) && (fabs(dy) < 0.1))
+         break;
+   }
+   return forwards;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const int count = (argc > 1) ? atoi(argv[1]) : 100000;
+   const bool left = (argc > 2) && !strcmp(argv[2], "left");
+
+   SensorParams params;
+   params.set_rwl(0.0555);
+   params.set_sightDirection(left ? SensorParams::Left : SensorParams::Right);
+   params.set_semiMajorAxis(6378137.0);
+   params.set_semiMinorAxis(6356752.3141);
+   params.set_dopcen(120.0);
+   params.set_dopcenLinear(-3.0);
+   PlatformPosition* position = makePlatformPosition();
+
+   // Every 8th pixel of 256 pixel tiles scattered over the image.
+   vector<Point> points;
+   const unsigned tiles = IMAGE_SIZE / TILE;
+   for (int k = 0; k < count; ++k)
+   {
+      const unsigned tile = k / 1024;
+      const int j = k % 1024;
+      Point p = { ((tile * 7919u) % tiles) * TILE + (j % 32) * 8 + 0.3,
+                  ((tile * 104729u) % tiles) * TILE + (j / 32) * 8 + 0.7,
+                  500.0 * (tile % 9), 0.0, 0.0 };
+      if (forward(params, *position, p))
+         points.push_back(p);
+   }
+   const size_t n = points.size();
+
+   cout << IMAGE_SIZE << " x " << IMAGE_SIZE << " image, "
+        << (left ? "left" : "right") << " looking, " << n << " points" << endl;
+   cout << "                                   us/pt  worst (px)   ImageToWorld calls" << endl;
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; ++i)
+   {
+      Point p = points[i];
+      forward(params, *position, p);
+   }
+   const double forwardTime = 1.0e6 * seconds(start) / n;
+   cout << "ImageToWorld                " << fixed << setprecision(3) << setw(12)
+        << forwardTime << endl;
+
+   // Direct inverse from the image centre, then from the last point.
+   for (int warm = 0; warm < 2; ++warm)
+   {
+      double worst = 0.0;
+      int failures = 0;
+      double seed = FIRST_TIME + LINE_TIME * 0.5 * (IMAGE_SIZE - 1);
+      start = chrono::steady_clock::now();
+      for (size_t i = 0; i < n; ++i)
+      {
+         double time = seed;
+         double distance = 0.0;
+         if (SarSensor::WorldToImage(params, *position, points[i].lon, points[i].lat,
+                                     points[i].height, time, distance))
+         {
+            ++failures;
+            continue;
+         }
+         if (warm)
+            seed = time;
+         const double dx = (distance - NEAR_RANGE) / RANGE_STEP - points[i].x;
+         const double dy = (time - FIRST_TIME) / LINE_TIME - points[i].y;
+         worst = max(worst, sqrt(dx * dx + dy * dy));
+      }
+      const double t = 1.0e6 * seconds(start) / n;
+      cout << (warm ? "WorldToImage, last point    " : "WorldToImage, image centre  ")
+           << setprecision(3) << setw(12) << t << setw(12) << worst << "   "
+           << setprecision(2) << setw(10) << t / forwardTime << " in time";
+      if (failures)
+         cout << ", " << failures << " FAILED";
+      cout << endl;
+   }
+
+   double worst = 0.0;
+   long forwards = 0;
+   start = chrono::steady_clock::now();
+   for (size_t i = 0; i < n; ++i)
+   {
+      double x = 0.0;
+      double y = 0.0;
+      forwards += iterative(params, *position, points[i], x, y);
+      worst = max(worst, sqrt((x - points[i].x) * (x - points[i].x) +
+                              (y - points[i].y) * (y - points[i].y)));
+   }
+   const double t = 1.0e6 * seconds(start) / n;
+   cout << "iteration on ImageToWorld   " << setprecision(3) << setw(12) << t << setw(12)
+        << worst << setprecision(2) << setw(10) << t / forwardTime << " in time, "
+        << setprecision(1) << (double) forwards / n << " made" << endl;
+
+   delete position;
+   return 0;
+}
@@ -0,0 +1,283 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Round trips of SarSensor::WorldToImage, the direct range-Doppler inverse behind
+// ossimGeometricSarSensorModel::worldToLineSample, against the iteration of
+// ossimSensorModel::worldToLineSample it replaced. Image points of a synthetic SAR image, columns
+// mapped to slant range and lines to azimuth time, are located with SarSensor::ImageToWorld and
+// brought back both ways. The points cover the four corners, the four edges and the inside of
+// the image and a ring of points off it, at heights from below the ellipsoid to mountain tops,
+// for right and left looking sensors, with and without a range dependent Doppler centroid.
+//
+// The forward model solves a quartic and is only good to a few centimetres of range, so the
+// round trips are held to the 0.1 pixel the iteration stops at, and the direct inverse must do
+// at least as well as the iteration at every point.
+//
+// Usage: sar-inverse-test
+
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+
+// Image: 20000 columns of 2.5 m slant range from 850 km, 20000 lines of 1 ms from 150 s.
+static const int IMAGE_SIZE = 20000;
+static const double NEAR_RANGE = 850.0e3;
+static const double RANGE_STEP = 2.5;
+static const double FIRST_TIME = 150.0;
+static const double LINE_TIME = 1.0e-3;
+
+// Pixels of the points along each axis: a ring off the image, both edges and the inside.
+static const double COORDINATES[] = { -1000.0, 0.0, 0.5, 2500.3, 7777.7, 10000.0, 15000.9,
+                                      19998.5, 19999.0, 21000.0 };
+static const double HEIGHTS[] = { -400.0, 0.0, 1500.0, 8800.0 };
+
+// ossimSensorModel::worldToLineSample stops once a step is below this.
+static const double PIXEL_THRESHOLD = 0.1;
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+struct SarModel
+{
+   SensorParams params;
+   PlatformPosition* position;
+
+   // Ground point of image point (x, y) at height, false if it has none.
+   bool forward(double x, double y, double height, double& lon, double& lat) const
+   {
+      return SarSensor::ImageToWorld(params, *position, NEAR_RANGE + RANGE_STEP * x,
+                                     makeDate(FIRST_TIME + LINE_TIME * y), height, lon, lat) == 0;
+   }
+
+   // Direct inverse from the line seedLine, as rigorousWorldToLineSample calls it.
+   int direct(double lon, double lat, double height, double seedLine, double& x, double& y) const
+   {
+      double time = FIRST_TIME + LINE_TIME * seedLine;
+      double distance = 0.0;
+      const int status = SarSensor::WorldToImage(params, *position, lon, lat, height, time,
+                                                 distance);
+      x = (distance - NEAR_RANGE) / RANGE_STEP;
+      y = (time - FIRST_TIME) / LINE_TIME;
+      return status;
+   }
+
+   //---
+   // The ossimSensorModel::worldToLineSample iteration: from the image centre, Newton steps on
+   // the forward model with partials taken over one pixel, until a step is below the threshold.
+   // Returns the number of forward localisations, 0 if it failed.
+   //---
+   int iterative(double lon, double lat, double height, double& x, double& y) const
+   {
+      const int MAX_NUM_ITERATIONS = 20;
+      x = 0.5 * (IMAGE_SIZE - 1);
+      y = 0.5 * (IMAGE_SIZE - 1);
+      int forwards = 0;
+      for (int i = 0; i < MAX_NUM_ITERATIONS; ++i)
+      {
+         double lon0, lat0, lonX, latX, lonY, latY;
+         forwards += 3;
+         if (!forward(x, y, height, lon0, lat0) || !forward(x + 1.0, y, height, lonX, latX) ||
+             !forward(x, y + 1.0, height, lonY, latY))
+            return 0;
+         const double dlonDx = lonX - lon0;
+         const double dlatDx = latX - lat0;
+         const double dlonDy = lonY - lon0;
+         const double dlatDy = latY - lat0;
+         const double det = dlonDx * dlatDy - dlonDy * dlatDx;
+         if (det == 0.0)
+            return 0;
+         const double dlon = lon - lon0;
+         const double dlat = lat - lat0;
+         const double dx = (dlatDy * dlon - dlonDy * dlat) / det;
+         const double dy = (dlonDx * dlat - dlatDx * dlon) / det;
+         x += dx;
+         y += dy;
+         if ((fabs(dx) < PIXEL_THRESHOLD) && (fabs(dy) < PIXEL_THRESHOLD))
+            return forwards;
+      }
+      return 0;
+   }
+};
+
+static double pixelDistance(double x0, double y0, double x1, double y1)
+{
+   return sqrt((x1 - x0) * (x1 - x0) + (y1 - y0) * (y1 - y0));
+}
+
+static void testRoundTrips(const string& name, const SarModel& model, const SarModel& otherSide)
+{
+   const int n = sizeof(COORDINATES) / sizeof(COORDINATES[0]);
+   int points = 0;
+   int located = 0;
+   int directFailures = 0;
+   int iterativeFailures = 0;
+   int worse = 0;
+   int otherSideAnswers = 0;
+   int forwards = 0;
+   double directError = 0.0;
+   double warmError = 0.0;
+   double iterativeError = 0.0;
+   double seedLine = 0.5 * (IMAGE_SIZE - 1);
+   for (size_t h = 0; h < sizeof(HEIGHTS) / sizeof(HEIGHTS[0]); ++h)
+   {
+      for (int j = 0; j < n; ++j)
+      {
+         for (int i = 0; i < n; ++i)
+         {
+            const double x0 = COORDINATES[i];
+            const double y0 = COORDINATES[j];
+            ++points;
+            double lon = 0.0;
+            double lat = 0.0;
+            if (!model.forward(x0, y0, HEIGHTS[h], lon, lat))
+               continue;
+            ++located;
+
+            // From the image centre, as a model's first call, then from the last point.
+            double x = 0.0;
+            double y = 0.0;
+            double e = 0.0;
+            if (model.direct(lon, lat, HEIGHTS[h], 0.5 * (IMAGE_SIZE - 1), x, y) == 0)
+               directError = max(directError, e = pixelDistance(x0, y0, x, y));
+            else
+               ++directFailures;
+            if (model.direct(lon, lat, HEIGHTS[h], seedLine, x, y) == 0)
+               warmError = max(warmError, pixelDistance(x0, y0, x, y));
+            else
+               ++directFailures;
+            seedLine = y0;
+
+            const int calls = model.iterative(lon, lat, HEIGHTS[h], x, y);
+            if (calls)
+            {
+               const double iterative = pixelDistance(x0, y0, x, y);
+               iterativeError = max(iterativeError, iterative);
+               forwards += calls;
+               if (e > max(iterative, PIXEL_THRESHOLD))
+               {
+                  ++worse;
+                  cout << "    (" << x0 << ", " << y0 << ") at " << HEIGHTS[h] << " m: direct "
+                       << e << " px, iterative " << iterative << " px" << endl;
+               }
+            }
+            else
+            {
+               ++iterativeFailures;
+            }
+
+            // A ground point on this side is not seen by a sensor looking the other way.
+            if (otherSide.direct(lon, lat, HEIGHTS[h], 0.5 * (IMAGE_SIZE - 1), x, y) != 1)
+               ++otherSideAnswers;
+         }
+      }
+   }
+
+   ostringstream what;
+   what << name << ": " << located << " of " << points << " points located";
+   check(located == points, what.str());
+   what.str("");
+   what << name << ": direct inverse answers every point, round trip within "
+        << PIXEL_THRESHOLD << " px (" << directError << " px from the image centre, "
+        << warmError << " px from the last point)";
+   check(!directFailures && (directError <= PIXEL_THRESHOLD) && (warmError <= PIXEL_THRESHOLD),
+         what.str());
+   what.str("");
+   what << name << ": iterative inverse answers every point (" << iterativeError
+        << " px, " << (located ? (double) forwards / located : 0.0)
+        << " forward localisations per point)";
+   check(!iterativeFailures, what.str());
+   what.str("");
+   what << name << ": direct inverse as close as the iterative one at every point";
+   check(!worse, what.str());
+   what.str("");
+   what << name << ": the other look direction turns every point down";
+   check(!otherSideAnswers, what.str());
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   PlatformPosition* position = makePlatformPosition();
+   const SensorParams::SightDirection SIGHTS[] = { SensorParams::Right, SensorParams::Left };
+   const char* sightNames[] = { "right looking", "left looking" };
+   const double DOPCEN[] = { 0.0, 120.0 };
+   const double DOPCEN_LINEAR[] = { 0.0, -3.0 };
+   for (int s = 0; s < 2; ++s)
+   {
+      for (int d = 0; d < 2; ++d)
+      {
+         SarModel model;
+         model.params.set_rwl(0.0555);
+         model.params.set_sightDirection(SIGHTS[s]);
+         model.params.set_semiMajorAxis(6378137.0);
+         model.params.set_semiMinorAxis(6356752.3141);
+         model.params.set_dopcen(DOPCEN[d]);
+         model.params.set_dopcenLinear(DOPCEN_LINEAR[d]);
+         model.position = position;
+         SarModel otherSide = model;
+         otherSide.params.set_sightDirection(SIGHTS[1 - s]);
+
+         string name = string(sightNames[s]) + (d ? ", Doppler centroid" : ", zero Doppler");
+         testRoundTrips(name, model, otherSide);
+      }
+   }
+   delete position;
+
+   return ossimPluginTest::summary();
+}
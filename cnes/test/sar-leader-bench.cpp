@@ -0,0 +1,214 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Time to read the leader files of the RadarSat, ERS and ALOS PALSAR models, through std::ifstream
+// and through ossimMappedFileStream. The leaders are synthetic: the records each model parses,
+// blank, then large records none of them parse, as in real leaders. The RadarSat leader parses
+// its records on first use, so it is also timed with the records the model asks for. Then each
+// product given is opened through the plugin projection factory, as ossim opens it.
+//
+// Usage: sar-leader-bench [work directory] [reads] [product ...]
+
+#include "../src/AlosPalsar/AlosPalsarLeader.h"
+#include "../src/AlosPalsar/AlosPalsarLeaderFactory.h"
+#include "../src/AlosPalsar/AlosPalsarRecord.h"
+#include "../src/RadarSat/Leader/Leader.h"
+#include "../src/erssar/ErsSarLeader.h"
+#include "../src/erssar/ErsSarLeaderFactory.h"
+#include "../src/erssar/ErsSarRecord.h"
+#include "../src/ossimMappedFileStream.h"
+#include "../src/ossimPluginProjectionFactory.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/projection/ossimProjection.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace ossimplugins;
+
+// Records no model parses, 720 KB each, as the signal data histograms of real leaders.
+static const int SKIPPED_RECORDS = 36;
+static const int SKIPPED_LENGTH = 720 * 1024;
+
+// Length of the RadarSat records: they are read whole whatever the header says.
+static const int RADARSAT_LENGTH = 4096;
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// The 12 byte CEOS record header, big endian.
+static void writeHeader(ostream& out, int seq, int length)
+{
+   const unsigned char header[12] =
+   {
+      (unsigned char)(seq >> 24), (unsigned char)(seq >> 16), (unsigned char)(seq >> 8),
+      (unsigned char)seq, 0, 0, 0, 0,
+      (unsigned char)(length >> 24), (unsigned char)(length >> 16),
+      (unsigned char)(length >> 8), (unsigned char)length
+   };
+   out.write((const char*)header, 12);
+}
+
+static void writeRecord(ostream& out, int seq, int length)
+{
+   writeHeader(out, seq, length);
+   out << string(length - 12, ' ');
+}
+
+static void writeSkipped(ostream& out, int firstSeq)
+{
+   for (int i = 0; i < SKIPPED_RECORDS; ++i)
+      writeRecord(out, firstSeq + i, SKIPPED_LENGTH);
+}
+
+//---
+// Bytes a record of the factory reads after its header, from blanks. The ALOS radiometric data
+// record seeks past the 12 MB of records that follow it to the facility data record.
+//---
+template <class Factory, class Record>
+static int recordLength(Factory& factory, int seq)
+{
+   Record* record = factory.Instanciate(seq);
+   if (!record)
+      return 0;
+   istringstream blanks(string(16 * 1024 * 1024, ' '));
+   record->Read(blanks);
+   delete record;
+   return 12 + (int)blanks.tellg();
+}
+
+template <class Factory, class Record>
+static ossimFilename writeLeader(const ossimFilename& dir, const char* name, int lastSeq)
+{
+   ossimFilename file = dir.dirCat(name);
+   ofstream out(file.c_str(), ios::binary);
+   Factory factory;
+   for (int seq = 1; seq <= lastSeq; ++seq)
+   {
+      const int length = recordLength<Factory, Record>(factory, seq);
+      if (length)
+         writeRecord(out, seq, length);
+   }
+   writeSkipped(out, lastSeq + 1);
+   return file;
+}
+
+static ossimFilename writeRadarSatLeader(const ossimFilename& dir)
+{
+   ossimFilename file = dir.dirCat("radarsat-lea_01.001");
+   ofstream out(file.c_str(), ios::binary);
+   for (int seq = 1; seq <= 10; ++seq)
+      writeRecord(out, seq, RADARSAT_LENGTH);
+   writeSkipped(out, 11);
+   return file;
+}
+
+// The records ossimRadarSatModel reads from the leader.
+static void useRadarSatRecords(Leader& leader)
+{
+   leader.get_FileDescriptor();
+   leader.get_DataSetSummary();
+   leader.get_PlatformPositionData();
+   leader.get_ProcessingParameters();
+}
+
+// Milliseconds per read of the leader into T, through Stream, then use if given.
+template <class T, class Stream>
+static double readTime(const ossimFilename& file, int reads, void (*use)(T&))
+{
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (int i = 0; i < reads; ++i)
+   {
+      Stream in(file.c_str(), ios::in | ios::binary);
+      T leader;
+      in >> leader;
+      if (use)
+         use(leader);
+   }
+   return 1000.0 * seconds(start) / reads;
+}
+
+// ossimMappedFileStream takes the file name only.
+struct MappedStream : public ossimMappedFileStream
+{
+   MappedStream(const char* file, ios::openmode) : ossimMappedFileStream(ossimFilename(file)) {}
+};
+
+template <class T>
+static void report(const char* name, const ossimFilename& file, int reads,
+                   void (*use)(T&)=0)
+{
+   const double ifstreamTime = readTime<T, ifstream>(file, reads, use);
+   const double mappedTime = readTime<T, MappedStream>(file, reads, use);
+   cout << setw(28) << left << name << right << fixed << setprecision(3) << setw(12)
+        << ifstreamTime << setw(12) << mappedTime << endl;
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename dir = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("sar-leader-bench");
+   const int reads = (argc > 2) ? atoi(argv[2]) : 200;
+   if (!dir.exists() && !dir.createDirectory(true))
+   {
+      cout << "Could not create " << dir << endl;
+      return 1;
+   }
+
+   ossimFilename radarSat = writeRadarSatLeader(dir);
+   ossimFilename ers =
+      writeLeader<ErsSarLeaderFactory, ErsSarRecord>(dir, "ers-lea_01.001", 5);
+   ossimFilename alos =
+      writeLeader<AlosPalsarLeaderFactory, AlosPalsarRecord>(dir, "LED-ALPSRP000000000", 17);
+
+   cout << "Synthetic leaders, " << SKIPPED_RECORDS << " skipped records of "
+        << SKIPPED_LENGTH / 1024 << " KB, " << reads << " reads" << endl;
+   cout << "leader                      ifstream (ms)  mapped (ms)" << endl;
+   report<Leader>("RadarSat", radarSat, reads);
+   report<Leader>("RadarSat, model's records", radarSat, reads, useRadarSatRecords);
+   report<ErsSarLeader>("ERS", ers, reads);
+   report<AlosPalsarLeader>("ALOS PALSAR", alos, reads);
+
+   remove(radarSat.c_str());
+   remove(ers.c_str());
+   remove(alos.c_str());
+   remove(dir.c_str());
+
+   if (argc > 3)
+   {
+      cout << "product opens through ossimPluginProjectionFactory, ms per open:" << endl;
+      for (int i = 3; i < argc; ++i)
+      {
+         const ossimFilename product(argv[i]);
+         const int opens = (reads + 9) / 10;
+         bool opened = true;
+         const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         for (int j = 0; j < opens && opened; ++j)
+         {
+            ossimRefPtr<ossimProjection> projection =
+               ossimPluginProjectionFactory::instance()->createProjection(product, 0);
+            opened = projection.valid();
+         }
+         if (opened)
+            cout << fixed << setprecision(3) << setw(12) << 1000.0 * seconds(start) / opens
+                 << "  " << product << endl;
+         else
+            cout << "  not opened  " << product << endl;
+      }
+   }
+   return 0;
+}
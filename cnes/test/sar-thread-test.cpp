@@ -0,0 +1,201 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Multithreaded stress test for the SAR localisation path behind ossimGeometricSarSensorModel.
+// One SensorParams and one PlatformPosition, built from a synthetic 700 km orbit, are
+// shared by 8 threads that each project every image point forward with SarSensor::ImageToWorld
+// and back with SarSensor::WorldToImage several times over. Every result must match the single
+// threaded run bit for bit. The single threaded run itself is checked against the SarSensor
+// instance path, which works on its own copies.
+//
+// Best run under -fsanitize=thread as well.
+
+#include "../src/otb/SarSensor.h"
+#include "../src/otb/SensorParams.h"
+#include "../src/otb/PlatformPosition.h"
+#include "../src/otb/GeographicEphemeris.h"
+#include "../src/otb/JSDDateTime.h"
+#include "../src/otb/JulianDate.h"
+#include "../../test/ossimPluginTest.h"
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+using namespace ossimplugins;
+
+static const double JULIAN_DAY0 = 2455000.5;
+static const double ORBIT_RADIUS = 6378137.0 + 700.0e3;
+static const double ORBIT_PERIOD = 5900.0;
+static const int EPHEMERIS_COUNT = 60;
+static const double EPHEMERIS_STEP = 10.0;
+static const int THREADS = 8;
+static const int PASSES = 5;
+
+static JSDDateTime makeDate(double t)
+{
+   double second = floor(t);
+   return JSDDateTime(JulianDate(JULIAN_DAY0), second, t - second);
+}
+
+// Earth fixed circular orbit, ascending node at longitude 30, 80 degrees inclination.
+static PlatformPosition* makePlatformPosition()
+{
+   const double W = 2.0 * M_PI / ORBIT_PERIOD;
+   const double NODE = 30.0 * M_PI / 180.0;
+   const double INCLINATION = 80.0 * M_PI / 180.0;
+   const double E1[3] = { cos(NODE), sin(NODE), 0.0 };
+   const double E2[3] = { -sin(NODE) * cos(INCLINATION), cos(NODE) * cos(INCLINATION),
+                          sin(INCLINATION) };
+   vector<Ephemeris*> data;
+   for (int i = 0; i < EPHEMERIS_COUNT; ++i)
+   {
+      double t = i * EPHEMERIS_STEP;
+      double pos[3];
+      double speed[3];
+      for (int j = 0; j < 3; ++j)
+      {
+         pos[j] = ORBIT_RADIUS * (cos(W * t) * E1[j] + sin(W * t) * E2[j]);
+         speed[j] = ORBIT_RADIUS * W * (-sin(W * t) * E1[j] + cos(W * t) * E2[j]);
+      }
+      data.push_back(new GeographicEphemeris(makeDate(t), pos, speed));
+   }
+   PlatformPosition* position = new PlatformPosition(&data[0], EPHEMERIS_COUNT);
+   for (size_t i = 0; i < data.size(); ++i)
+      delete data[i];
+   return position;
+}
+
+struct ImagePoint
+{
+   double time;     // Seconds from the first ephemeris.
+   double distance; // Slant range.
+};
+
+struct Result
+{
+   int forwardStatus;
+   double lon;
+   double lat;
+   int inverseStatus;
+   double time;
+   double distance;
+
+   bool operator==(const Result& rhs) const
+   {
+      return (forwardStatus == rhs.forwardStatus) && (lon == rhs.lon) && (lat == rhs.lat) &&
+         (inverseStatus == rhs.inverseStatus) && (time == rhs.time) &&
+         (distance == rhs.distance);
+   }
+};
+
+static Result project(const SensorParams& params, const PlatformPosition& position,
+                      const ImagePoint& point, double height)
+{
+   Result r;
+   r.forwardStatus = SarSensor::ImageToWorld(params, position, point.distance,
+                                             makeDate(point.time), height, r.lon, r.lat);
+   r.time = point.time + 3.0; // Starting guess a few lines off.
+   r.distance = 0.0;
+   r.inverseStatus = SarSensor::WorldToImage(params, position, r.lon, r.lat, height, r.time,
+                                             r.distance);
+   return r;
+}
+
+int main()
+{
+   SensorParams params;
+   params.set_rwl(0.0555);
+   params.set_sightDirection(SensorParams::Right);
+   params.set_semiMajorAxis(6378137.0);
+   params.set_semiMinorAxis(6356752.3141);
+   params.set_dopcen(0.0);
+   params.set_dopcenLinear(0.0);
+
+   PlatformPosition* position = makePlatformPosition();
+
+   vector<ImagePoint> points;
+   srand(5);
+   const double SPAN = (EPHEMERIS_COUNT - 1) * EPHEMERIS_STEP;
+   for (int i = 0; i < 2000; ++i)
+   {
+      ImagePoint p;
+      p.time = 50.0 + (SPAN - 100.0) * rand() / RAND_MAX;
+      p.distance = 800.0e3 + 150.0e3 * rand() / RAND_MAX;
+      points.push_back(p);
+   }
+   const double HEIGHT = 120.0;
+
+   // Single threaded reference.
+   vector<Result> reference;
+   for (size_t i = 0; i < points.size(); ++i)
+      reference.push_back(project(params, *position, points[i], HEIGHT));
+
+   {
+      bool allLocated = true;
+      for (size_t i = 0; i < reference.size(); ++i)
+      {
+         allLocated = allLocated && (reference[i].forwardStatus == 0) &&
+            (reference[i].inverseStatus == 0);
+      }
+      check(allLocated, "every point located forward and back");
+   }
+
+   {
+      // The instance path clones params and position.
+      SarSensor sensor(&params, position);
+      bool same = true;
+      for (size_t i = 0; (i < points.size()) && same; ++i)
+      {
+         double lon = 0.0;
+         double lat = 0.0;
+         int status = sensor.ImageToWorld(points[i].distance, makeDate(points[i].time), HEIGHT,
+                                          lon, lat);
+         same = (status == reference[i].forwardStatus) && (lon == reference[i].lon) &&
+            (lat == reference[i].lat);
+      }
+      check(same, "shared params and position match the SarSensor copies");
+   }
+
+   {
+      atomic<int> mismatches(0);
+      vector<thread> threads;
+      for (int t = 0; t < THREADS; ++t)
+      {
+         threads.push_back(thread([&, t]() {
+            for (int pass = 0; pass < PASSES; ++pass)
+            {
+               // Each thread walks the points from a different start.
+               for (size_t n = 0; n < points.size(); ++n)
+               {
+                  size_t i = (n + t * points.size() / THREADS) % points.size();
+                  if (!(project(params, *position, points[i], HEIGHT) == reference[i]))
+                     ++mismatches;
+               }
+            }
+         }));
+      }
+      for (size_t t = 0; t < threads.size(); ++t)
+         threads[t].join();
+
+      ostringstream what;
+      what << THREADS << " threads x " << PASSES << " passes x " << points.size()
+           << " points match the single threaded run (" << mismatches.load()
+           << " mismatches)";
+      check(mismatches.load() == 0, what.str());
+   }
+
+   delete position;
+
+   return ossimPluginTest::summary();
+}
@@ -9,30 +9,257 @@
 #include "ossimFftw3Filter.h"
 #include <ossim/imaging/ossimImageDataFactory.h>
 #include <ossim/imaging/ossimScalarRemapper.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimNumericProperty.h>
 #include <ossim/base/ossimStringProperty.h>
-#include <complex.h>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <fftw3.h>
 
 RTTI_DEF1(ossimFftw3Filter, "ossimFftw3Filter", ossimFftFilter);
 
+static const char PLANNER_EFFORT_KW[] = "planner_effort";
+static const char NUM_THREADS_KW[]    = "num_threads";
+static const char WISDOM_FILE_KW[]    = "wisdom_file";
+
+static const char* EFFORT_NAMES[] = { "estimate", "measure", "patient", "exhaustive" };
+static const unsigned EFFORT_FLAGS[] = { FFTW_ESTIMATE, FFTW_MEASURE, FFTW_PATIENT,
+                                         FFTW_EXHAUSTIVE };
+
+// Plans for the most tile sizes kept before all are dropped:
+static const size_t MAX_PLANS = 8;
+
+//---
+// FFTW's planner and wisdom are global and not thread safe; only executing a plan is. Everything
+// else is done holding this lock, taken after a filter's m_plansMutex when both are needed.
+//---
+static std::mutex plannerMutex;
+static std::set<std::string> wisdomLoaded;
+
+/** A plan, shared by the threads transforming tiles of its size. */
+class ossimFftw3Filter::Plan
+{
+public:
+   Plan() : m_plan(0) {}
+   ~Plan()
+   {
+      if (m_plan)
+      {
+         std::lock_guard<std::mutex> lock(plannerMutex);
+         fftw_destroy_plan(m_plan);
+      }
+   }
+
+   fftw_plan m_plan;
+};
+
+//---
+// A thread's transform buffers, grown to the largest tile it has seen. Plans are executed on
+// them with fftw's new-array functions; all come from fftw_alloc, so have the alignment the
+// plans were made for.
+//---
+namespace
+{
+   class FftBuffers
+   {
+   public:
+      FftBuffers() : m_real(0), m_half(0), m_realSize(0), m_halfSize(0) {}
+      ~FftBuffers()
+      {
+         fftw_free(m_real);
+         fftw_free(m_half);
+      }
+
+      /** Makes room for a w x h tile. False if out of memory. */
+      bool reserve(ossim_uint32 w, ossim_uint32 h)
+      {
+         const size_t realSize = (size_t) w * h;
+         const size_t halfSize = (size_t) (w/2 + 1) * h;
+         if (realSize > m_realSize)
+         {
+            fftw_free(m_real);
+            m_real = fftw_alloc_real(realSize);
+            m_realSize = m_real ? realSize : 0;
+         }
+         if (halfSize > m_halfSize)
+         {
+            fftw_free(m_half);
+            m_half = fftw_alloc_complex(halfSize);
+            m_halfSize = m_half ? halfSize : 0;
+         }
+         return m_real && m_half;
+      }
+
+      double* m_real;          // width x height pixels.
+      fftw_complex* m_half;    // width/2+1 x height, the non-redundant half of the spectrum.
+
+   private:
+      size_t m_realSize;
+      size_t m_halfSize;
+   };
+
+   FftBuffers& threadBuffers()
+   {
+      static thread_local FftBuffers buffers;
+      return buffers;
+   }
+}
+
+static bool stringToEffort(const ossimString& s, ossimFftw3Filter::PlannerEffort& effort)
+{
+   ossimString str = s.trim();
+   str.downcase();
+   for (int i=0; i<4; ++i)
+   {
+      if (str == EFFORT_NAMES[i])
+      {
+         effort = (ossimFftw3Filter::PlannerEffort) i;
+         return true;
+      }
+   }
+   return false;
+}
+
 ossimFftw3Filter::ossimFftw3Filter(ossimObject* owner)
-   :ossimFftFilter(owner)
+   :ossimFftFilter(owner),
+    m_effort(MEASURE),
+    m_numThreads(1)
 {
 }
 
 ossimFftw3Filter::ossimFftw3Filter(ossimImageSource* inputSource)
-   :ossimFftFilter(inputSource)
+   :ossimFftFilter(inputSource),
+    m_effort(MEASURE),
+    m_numThreads(1)
 {
 }
 
 ossimFftw3Filter::ossimFftw3Filter(ossimObject* owner,
                                ossimImageSource* inputSource)
-   :ossimFftFilter(owner, inputSource)
+   :ossimFftFilter(owner, inputSource),
+    m_effort(MEASURE),
+    m_numThreads(1)
 {
 }
 
 ossimFftw3Filter::~ossimFftw3Filter()
 {
+   clearPlans();
+}
+
+void ossimFftw3Filter::setPlannerEffort(PlannerEffort effort)
+{
+   if (effort != m_effort)
+   {
+      m_effort = effort;
+      clearPlans();
+   }
+}
+
+ossimFftw3Filter::PlannerEffort ossimFftw3Filter::getPlannerEffort() const
+{
+   return m_effort;
+}
+
+void ossimFftw3Filter::setNumThreads(ossim_uint32 numThreads)
+{
+   if (numThreads != m_numThreads)
+   {
+      m_numThreads = numThreads;
+      clearPlans();
+   }
+}
+
+ossim_uint32 ossimFftw3Filter::getNumThreads() const
+{
+   return m_numThreads;
+}
+
+void ossimFftw3Filter::setWisdomFile(const ossimFilename& file)
+{
+   m_wisdomFile = file;
+}
+
+const ossimFilename& ossimFftw3Filter::getWisdomFile() const
+{
+   return m_wisdomFile;
+}
+
+void ossimFftw3Filter::clearPlans()
+{
+   // Plans still in use by runFft are destroyed when it lets go of them:
+   std::lock_guard<std::mutex> lock(m_plansMutex);
+   m_plans.clear();
+}
+
+std::shared_ptr<ossimFftw3Filter::Plan> ossimFftw3Filter::getPlan(ossim_uint32 w,
+                                                                  ossim_uint32 h,
+                                                                  bool forward)
+{
+   const PlanKey key (std::make_pair(w, h), forward);
+   std::lock_guard<std::mutex> plansLock(m_plansMutex);
+   std::map<PlanKey, std::shared_ptr<Plan> >::iterator i = m_plans.find(key);
+   if (i != m_plans.end())
+      return (*i).second;
+
+   if (m_plans.size() >= MAX_PLANS)
+      m_plans.clear();
+
+   // Planning overwrites the arrays, so is done on this thread's, which are refilled anyway:
+   FftBuffers& buffers = threadBuffers();
+   std::shared_ptr<Plan> plan (new Plan);
+   if (buffers.reserve(w, h))
+   {
+      std::lock_guard<std::mutex> lock(plannerMutex);
+
+#ifdef OSSIM_FFTW3_THREADS
+      // Before any wisdom is read, as wisdom only matches a planner with the same solvers:
+      static bool threadsReady = (fftw_init_threads() != 0);
+      if (threadsReady)
+      {
+         ossim_uint32 numThreads = m_numThreads ? m_numThreads
+                                                : std::thread::hardware_concurrency();
+         fftw_plan_with_nthreads(numThreads ? numThreads : 1);
+      }
+#endif
+
+      if (!m_wisdomFile.empty() && !wisdomLoaded.count(m_wisdomFile.string()))
+      {
+         // A missing file is not an error, it is written after the first plan:
+         wisdomLoaded.insert(m_wisdomFile.string());
+         if (m_wisdomFile.exists() && !fftw_import_wisdom_from_filename(m_wisdomFile.chars()))
+         {
+            ossimNotify(ossimNotifyLevel_WARN) << "ossimFftw3Filter: Could not read wisdom file <"
+                                               << m_wisdomFile << ">." << std::endl;
+         }
+      }
+
+      // The image is h rows of w pixels, row major:
+      const unsigned flags = EFFORT_FLAGS[m_effort];
+      if (forward)
+         plan->m_plan = fftw_plan_dft_r2c_2d(h, w, buffers.m_real, buffers.m_half, flags);
+      else
+         plan->m_plan = fftw_plan_dft_c2r_2d(h, w, buffers.m_half, buffers.m_real, flags);
+
+      if (plan->m_plan && !m_wisdomFile.empty() && (m_effort != ESTIMATE) &&
+          !fftw_export_wisdom_to_filename(m_wisdomFile.chars()))
+      {
+         ossimNotify(ossimNotifyLevel_WARN) << "ossimFftw3Filter: Could not write wisdom file <"
+                                            << m_wisdomFile << ">." << std::endl;
+      }
+   }
+   if (!plan->m_plan)
+   {
+      ossimNotify(ossimNotifyLevel_WARN) << "ossimFftw3Filter: Could not make a plan for "
+                                         << w << " x " << h << " tiles." << std::endl;
+      return std::shared_ptr<Plan>();
+   }
+
+   m_plans[key] = plan;
+   return plan;
 }
 
 void ossimFftw3Filter::runFft(ossimRefPtr<ossimImageData>& input,
@@ -41,102 +268,162 @@ void ossimFftw3Filter::runFft(ossimRefPtr<ossimImageData>& input,
    ossim_uint32 w = input->getWidth();
    ossim_uint32 h = input->getHeight();
    ossim_uint32 n = w*h;
-   double realVal, imagVal;
-   double nullPix = getNullPixelValue();
+   ossim_uint32 hw = w/2 + 1; // Columns of the stored half of the spectrum.
+   bool forward = (theDirectionType == FORWARD);
    ossim_uint32 numBands = input->getNumberOfBands();
-   if (theDirectionType == INVERSE)
+   if (!forward)
       numBands /= 2;
 
-   fftw_complex* indata  = fftw_alloc_complex(n);
-   fftw_complex* outdata = fftw_alloc_complex(n);
-   ossim_uint32 flags = 0;
-
-   int dir = 1; // inverse
-   if (theDirectionType == FORWARD)
-      dir = -1;
+   std::shared_ptr<Plan> plan = getPlan(w, h, forward);
+   FftBuffers& buffers = threadBuffers();
+   if (!plan || !buffers.reserve(w, h))
+      return;
 
-   fftw_plan fp = fftw_plan_dft_2d(w, h, indata, outdata, dir, flags);
+   double* real = buffers.m_real;
+   fftw_complex* half = buffers.m_half;
    double* realBuf = 0;
    double* imagBuf = 0;
 
-   // Transfer the image data to the FFTW data structure:
    ossim_uint32 cplx_band_idx = 0;
    for(ossim_uint32 band = 0; band < numBands; ++band)
    {
       cplx_band_idx = 2*band;
 
-      // Fill the FFTW3 complex buffer with pixel values representing real part and imaginary
-      // part (if doing inverse) of input:
-      if (theDirectionType == FORWARD)
+      if (forward)
       {
-         realBuf = (double*) input->getBuf(band);
-         imagBuf = 0;
-      }
-      else
-      {
-         realBuf = (double*) input->getBuf(cplx_band_idx);
-         imagBuf = (double*) input->getBuf(cplx_band_idx+1);
-      }
+         // Transform the pixels:
+         memcpy(real, input->getBuf(band), n*sizeof(double));
+         fftw_execute_dft_r2c(plan->m_plan, real, half);
 
-      ossim_uint32 i = 0;
-      int sign = 1.0;
-      for(ossim_uint32 y = 0; y < h; ++y)
-      {
-         for(ossim_uint32 x = 0; x < w; ++x)
+         // Copy out the stored half, scaled as the inverse does not scale:
+         realBuf = (double*) output->getBuf(cplx_band_idx);
+         imagBuf = (double*) output->getBuf(cplx_band_idx+1);
+         double scale = 1.0 / (double) n;
+         for(ossim_uint32 y = 0; y < h; ++y)
          {
-            if (theDirectionType == FORWARD)
+            for(ossim_uint32 x = 0; x < hw; ++x)
             {
-               indata[i][0] = sign*realBuf[i];
-               indata[i][1] = 0;
+               realBuf[y*w + x] = half[y*hw + x][0] * scale;
+               imagBuf[y*w + x] = half[y*hw + x][1] * scale;
             }
-            else
+         }
+
+         // The other half mirrors it, as the spectrum of real pixels has X(-k) = conj(X(k)):
+         for(ossim_uint32 y = 0; y < h; ++y)
+         {
+            ossim_uint32 my = (h - y) % h;
+            for(ossim_uint32 x = hw; x < w; ++x)
             {
-               indata[i][0] = sign*realBuf[i];
-               indata[i][1] = sign*imagBuf[i];
+               realBuf[y*w + x] =  realBuf[my*w + w - x];
+               imagBuf[y*w + x] = -imagBuf[my*w + w - x];
             }
-            i++;
-
-            //sign *= -1;
          }
-         //sign *= -1;
-      }
-
-      // Compute the FFT (or inverse FFT):
-      fftw_execute(fp);
-
-      // Pull data out of FFTW3 structure and into OSSIM output tile:
-      if (theDirectionType == FORWARD)
-      {
-         realBuf = (double*) output->getBuf(cplx_band_idx);
-         imagBuf = (double*) output->getBuf(cplx_band_idx+1);
       }
       else
       {
-         realBuf = (double*) output->getBuf(band);
-         imagBuf = 0;
-      }
-
-      i = 0;
-      for(ossim_uint32 y = 0; y < h; ++y)
-      {
-         for(ossim_uint32 x = 0; x < w; ++x)
+         //---
+         // The output is the real part of the inverse, which is the inverse of the Hermitian
+         // part of the input, (X(k) + conj(X(-k)))/2. That needs only the stored half, and
+         // makes a complex to real transform exact for any input:
+         //---
+         realBuf = (double*) input->getBuf(cplx_band_idx);
+         imagBuf = (double*) input->getBuf(cplx_band_idx+1);
+         for(ossim_uint32 y = 0; y < h; ++y)
          {
-            if (theDirectionType == FORWARD)
+            ossim_uint32 my = (h - y) % h;
+            for(ossim_uint32 x = 0; x < hw; ++x)
             {
-               realBuf[i] = outdata[i][0] / (double)n;
-               imagBuf[i] = outdata[i][1] / (double)n;
+               ossim_uint32 k = y*w + x;
+               ossim_uint32 mk = my*w + (w - x) % w;
+               half[y*hw + x][0] = 0.5 * (realBuf[k] + realBuf[mk]);
+               half[y*hw + x][1] = 0.5 * (imagBuf[k] - imagBuf[mk]);
             }
-            else
-            {
-               realBuf[i] = outdata[i][0];
-            }
-            i++;
          }
+         fftw_execute_dft_c2r(plan->m_plan, half, real);
+         memcpy(output->getBuf(band), real, n*sizeof(double));
       }
+   }
+}
 
-      band++;
+void ossimFftw3Filter::setProperty(ossimRefPtr<ossimProperty> property)
+{
+   if (!property.valid())
+      return;
+
+   ossimString name = property->getName();
+   if (name == PLANNER_EFFORT_KW)
+   {
+      PlannerEffort effort;
+      if (stringToEffort(property->valueToString(), effort))
+         setPlannerEffort(effort);
+   }
+   else if (name == NUM_THREADS_KW)
+      setNumThreads(property->valueToString().toUInt32());
+   else if (name == WISDOM_FILE_KW)
+      setWisdomFile(ossimFilename(property->valueToString()));
+   else
+      ossimFftFilter::setProperty(property);
+}
+
+ossimRefPtr<ossimProperty> ossimFftw3Filter::getProperty(const ossimString& name) const
+{
+   ossimRefPtr<ossimProperty> result = 0;
+   if (name == PLANNER_EFFORT_KW)
+   {
+      std::vector<ossimString> constraints (EFFORT_NAMES, EFFORT_NAMES + 4);
+      result = new ossimStringProperty(name, EFFORT_NAMES[m_effort], false, constraints);
    }
-   
-   fftw_cleanup();
+   else if (name == NUM_THREADS_KW)
+   {
+      ossimNumericProperty* p = new ossimNumericProperty(name,
+                                                         ossimString::toString(m_numThreads),
+                                                         0, 256);
+      p->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      result = p;
+   }
+   else if (name == WISDOM_FILE_KW)
+   {
+      result = new ossimStringProperty(name, m_wisdomFile);
+   }
+   else
+      return ossimFftFilter::getProperty(name);
+
+   result->setCacheRefreshBit();
+   return result;
 }
 
+void ossimFftw3Filter::getPropertyNames(std::vector<ossimString>& propertyNames) const
+{
+   ossimFftFilter::getPropertyNames(propertyNames);
+   propertyNames.push_back(PLANNER_EFFORT_KW);
+   propertyNames.push_back(NUM_THREADS_KW);
+   propertyNames.push_back(WISDOM_FILE_KW);
+}
+
+bool ossimFftw3Filter::saveState(ossimKeywordlist& kwl, const char* prefix) const
+{
+   kwl.add(prefix, PLANNER_EFFORT_KW, EFFORT_NAMES[m_effort], true);
+   kwl.add(prefix, NUM_THREADS_KW, m_numThreads, true);
+   kwl.add(prefix, WISDOM_FILE_KW, m_wisdomFile.c_str(), true);
+   return ossimFftFilter::saveState(kwl, prefix);
+}
+
+bool ossimFftw3Filter::loadState(const ossimKeywordlist& kwl, const char* prefix)
+{
+   bool result = ossimFftFilter::loadState(kwl, prefix);
+
+   const char* lookup = kwl.find(prefix, PLANNER_EFFORT_KW);
+   PlannerEffort effort;
+   if (lookup && stringToEffort(ossimString(lookup), effort))
+      setPlannerEffort(effort);
+
+   lookup = kwl.find(prefix, NUM_THREADS_KW);
+   if (lookup)
+      setNumThreads(ossimString(lookup).toUInt32());
+
+   lookup = kwl.find(prefix, WISDOM_FILE_KW);
+   if (lookup)
+      setWisdomFile(ossimFilename(lookup));
+
+   return result;
+}
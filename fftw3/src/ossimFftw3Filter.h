@@ -8,19 +8,76 @@
 #ifndef ossimFftw3Filter_HEADER
 #define ossimFftw3Filter_HEADER
 #include <ossim/imaging/ossimFftFilter.h>
+#include <ossim/base/ossimFilename.h>
+#include <map>
+#include <memory>
+#include <mutex>
 
+/**
+ * FFT filter using FFTW3. Pixels are real, so the forward transform is done real to complex and
+ * the full spectrum filled in by symmetry; the inverse is done complex to real on the Hermitian
+ * part of the input spectrum, which has the same real inverse. Plans are made once per tile size
+ * and direction and kept for the life of the filter. Each thread transforms in its own aligned
+ * buffers, so runFft may be called from several threads at once. FFTW_MEASURE plans take a while
+ * to make, so the planner's wisdom can be loaded from and saved to a file.
+ */
 class ossimFftw3Filter : public ossimFftFilter
 {
 public:
+   enum PlannerEffort { ESTIMATE, MEASURE, PATIENT, EXHAUSTIVE };
+
    ossimFftw3Filter(ossimObject* owner=NULL);
    ossimFftw3Filter(ossimImageSource* inputSource);
    ossimFftw3Filter(ossimObject* owner, ossimImageSource* inputSource);
-   
+
+   /** @brief Sets how hard FFTW looks for a fast plan. Default is MEASURE. */
+   void setPlannerEffort(PlannerEffort effort);
+   PlannerEffort getPlannerEffort() const;
+
+   /**
+    * @brief Sets the threads each transform is split across, 0 for one per core. Default is 1,
+    * leaving the cores to the tiles. Has no effect unless built with the FFTW3 threads library.
+    */
+   void setNumThreads(ossim_uint32 numThreads);
+   ossim_uint32 getNumThreads() const;
+
+   /**
+    * @brief Sets a file of FFTW wisdom, read before the first plan is made and rewritten after
+    * each new plan. Empty (default) for none.
+    */
+   void setWisdomFile(const ossimFilename& file);
+   const ossimFilename& getWisdomFile() const;
+
+   virtual void setProperty(ossimRefPtr<ossimProperty> property);
+   virtual ossimRefPtr<ossimProperty> getProperty(const ossimString& name) const;
+   virtual void getPropertyNames(std::vector<ossimString>& propertyNames) const;
+
+   virtual bool saveState(ossimKeywordlist& kwl, const char* prefix=0) const;
+   virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
+
 protected:
    virtual void runFft(ossimRefPtr<ossimImageData>& input, ossimRefPtr<ossimImageData>& output);
 
    virtual ~ossimFftw3Filter();
 
+private:
+   class Plan;
+
+   typedef std::pair<std::pair<ossim_uint32, ossim_uint32>, bool> PlanKey;
+
+   /**
+    * @brief Cached plan for a tile size and direction, made if needed. Null on failure. The plan
+    * stays valid while the pointer is held, even if the cache is cleared meanwhile.
+    */
+   std::shared_ptr<Plan> getPlan(ossim_uint32 width, ossim_uint32 height, bool forward);
+   void clearPlans();
+
+   PlannerEffort m_effort;
+   ossim_uint32 m_numThreads;
+   ossimFilename m_wisdomFile;
+   std::map<PlanKey, std::shared_ptr<Plan> > m_plans;
+   std::mutex m_plansMutex; // Guards m_plans.
+
 TYPE_DATA
 };
 
@@ -0,0 +1,134 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+//
+// Tiles per second of ossimFftw3Filter for 256, 512 and 1024 pixel square tiles, forward and
+// inverse, from one thread and then from one thread per core sharing the filter. The first tile,
+// which makes the plan, is timed on its own.
+//
+// Usage: fftw3-bench [seconds per run] [estimate|measure|patient|exhaustive]
+
+#include "../src/ossimFftw3Filter.h"
+#include <ossim/imaging/ossimImageData.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class BenchFilter : public ossimFftw3Filter
+{
+public:
+   BenchFilter(bool forward)
+   {
+      theDirectionType = forward ? FORWARD : INVERSE;
+   }
+
+   void transform(ossimRefPtr<ossimImageData>& input, ossimRefPtr<ossimImageData>& output)
+   {
+      runFft(input, output);
+   }
+
+protected:
+   virtual ~BenchFilter() {}
+};
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+static ossimRefPtr<ossimImageData> makeTile(ossim_uint32 size, ossim_uint32 bands)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_DOUBLE, bands, size, size);
+   tile->initialize();
+   unsigned state = size + bands;
+   for (ossim_uint32 b=0; b<bands; ++b)
+   {
+      double* buf = (double*) tile->getBuf(b);
+      for (ossim_uint32 i=0; i<size*size; ++i)
+      {
+         state = state*1664525u + 1013904223u;
+         buf[i] = (state >> 8) / 16777216.0;
+      }
+   }
+   return tile;
+}
+
+// Tiles per second from the given number of threads, each with its own tiles.
+static double rate(BenchFilter* filter, ossim_uint32 size, bool forward, ossim_uint32 numThreads,
+                   double duration)
+{
+   atomic<long> tiles(0);
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   vector<thread> threads;
+   for (ossim_uint32 t=0; t<numThreads; ++t)
+   {
+      threads.push_back(thread([filter, size, forward, duration, &start, &tiles]()
+      {
+         ossimRefPtr<ossimImageData> input = makeTile(size, forward ? 1 : 2);
+         ossimRefPtr<ossimImageData> output = makeTile(size, forward ? 2 : 1);
+         do
+         {
+            filter->transform(input, output);
+            ++tiles;
+         } while (seconds(start) < duration);
+      }));
+   }
+   for (size_t t=0; t<threads.size(); ++t)
+      threads[t].join();
+   return tiles / seconds(start);
+}
+
+int main(int argc, char *argv[])
+{
+   const double duration = (argc > 1) ? atof(argv[1]) : 3.0;
+   const string effortName = (argc > 2) ? argv[2] : "measure";
+   ossimFftw3Filter::PlannerEffort effort = ossimFftw3Filter::MEASURE;
+   if (effortName == "estimate")
+      effort = ossimFftw3Filter::ESTIMATE;
+   else if (effortName == "patient")
+      effort = ossimFftw3Filter::PATIENT;
+   else if (effortName == "exhaustive")
+      effort = ossimFftw3Filter::EXHAUSTIVE;
+
+   ossim_uint32 cores = thread::hardware_concurrency();
+   if (cores == 0)
+      cores = 1;
+
+   cout << "Planner effort " << effortName << ", " << duration << " s per run" << endl;
+   cout << "  size  direction  first tile (s)  1 thread (tiles/s)  " << cores
+        << " threads (tiles/s)" << endl;
+
+   const ossim_uint32 SIZES[] = { 256, 512, 1024 };
+   for (int s=0; s<3; ++s)
+   {
+      for (int f=1; f>=0; --f)
+      {
+         const bool forward = (f == 1);
+         ossimRefPtr<BenchFilter> filter = new BenchFilter(forward);
+         filter->setPlannerEffort(effort);
+
+         ossimRefPtr<ossimImageData> input = makeTile(SIZES[s], forward ? 1 : 2);
+         ossimRefPtr<ossimImageData> output = makeTile(SIZES[s], forward ? 2 : 1);
+         const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         filter->transform(input, output);
+         const double first = seconds(start);
+
+         const double one = rate(filter.get(), SIZES[s], forward, 1, duration);
+         const double all = rate(filter.get(), SIZES[s], forward, cores, duration);
+         cout << setw(6) << SIZES[s] << "  " << setw(9) << (forward ? "forward" : "inverse")
+              << "  " << fixed << setprecision(3) << setw(14) << first << "  "
+              << setprecision(1) << setw(18) << one << "  " << setw(18) << all << endl;
+      }
+   }
+   return 0;
+}
@@ -0,0 +1,192 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+//
+// Checks ossimFftw3Filter on non-square tiles: the forward transform against a direct DFT, and
+// forward then inverse giving back the pixels, for even and odd sizes and several bands. Then
+// several threads share a forward and an inverse filter, cycling through more tile sizes than
+// they keep plans for, so plans are dropped while other threads are still transforming with them.
+
+#include "../src/ossimFftw3Filter.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/imaging/ossimImageData.h>
+#include <atomic>
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const double TOLERANCE = 1.0e-10;
+
+// Opens up the transform, which ossimFftFilter::getTile otherwise runs on its input's tiles.
+class TestFilter : public ossimFftw3Filter
+{
+public:
+   TestFilter(bool forward, PlannerEffort effort)
+   {
+      theDirectionType = forward ? FORWARD : INVERSE;
+      setPlannerEffort(effort);
+   }
+
+   void transform(ossimRefPtr<ossimImageData>& input, ossimRefPtr<ossimImageData>& output)
+   {
+      runFft(input, output);
+   }
+
+protected:
+   virtual ~TestFilter() {}
+};
+
+static ossimRefPtr<ossimImageData> makeTile(ossim_uint32 w, ossim_uint32 h, ossim_uint32 bands)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_DOUBLE, bands, w, h);
+   tile->initialize();
+   return tile;
+}
+
+// Pseudo-random pixels in [0, 1), different for each seed.
+static ossimRefPtr<ossimImageData> makeImage(ossim_uint32 w, ossim_uint32 h, ossim_uint32 bands,
+                                             unsigned seed)
+{
+   ossimRefPtr<ossimImageData> tile = makeTile(w, h, bands);
+   unsigned state = seed*2654435761u + 1;
+   for (ossim_uint32 b=0; b<bands; ++b)
+   {
+      double* buf = (double*) tile->getBuf(b);
+      for (ossim_uint32 i=0; i<w*h; ++i)
+      {
+         state = state*1664525u + 1013904223u;
+         buf[i] = (state >> 8) / 16777216.0;
+      }
+   }
+   return tile;
+}
+
+static double maxDifference(ossimImageData* a, ossimImageData* b, ossim_uint32 bands)
+{
+   const ossim_uint32 n = a->getWidth()*a->getHeight();
+   double result = 0.0;
+   for (ossim_uint32 band=0; band<bands; ++band)
+   {
+      const double* p = (const double*) a->getBuf(band);
+      const double* q = (const double*) b->getBuf(band);
+      for (ossim_uint32 i=0; i<n; ++i)
+         result = max(result, fabs(p[i] - q[i]));
+   }
+   return result;
+}
+
+// Largest difference of the forward output from the DFT of the input, scaled by 1/(w*h).
+static double dftDifference(ossimImageData* input, ossimImageData* spectrum)
+{
+   const int w = (int) input->getWidth();
+   const int h = (int) input->getHeight();
+   double result = 0.0;
+   for (ossim_uint32 band=0; band<input->getNumberOfBands(); ++band)
+   {
+      const double* pixels = (const double*) input->getBuf(band);
+      const double* re = (const double*) spectrum->getBuf(2*band);
+      const double* im = (const double*) spectrum->getBuf(2*band + 1);
+      for (int ky=0; ky<h; ++ky)
+      {
+         for (int kx=0; kx<w; ++kx)
+         {
+            complex<double> sum = 0.0;
+            for (int y=0; y<h; ++y)
+            {
+               for (int x=0; x<w; ++x)
+               {
+                  const double phase = -2.0*M_PI*((double) (kx*x) / w + (double) (ky*y) / h);
+                  sum += pixels[y*w + x] * polar(1.0, phase);
+               }
+            }
+            sum /= (double) (w*h);
+            result = max(result, abs(sum - complex<double>(re[ky*w + kx], im[ky*w + kx])));
+         }
+      }
+   }
+   return result;
+}
+
+static void testSize(TestFilter* forward, TestFilter* inverse, ossim_uint32 w, ossim_uint32 h,
+                     ossim_uint32 bands)
+{
+   ostringstream name;
+   name << w << " x " << h << ", " << bands << " band" << (bands > 1 ? "s" : "");
+
+   ossimRefPtr<ossimImageData> input = makeImage(w, h, bands, w*h);
+   ossimRefPtr<ossimImageData> spectrum = makeTile(w, h, 2*bands);
+   forward->transform(input, spectrum);
+   check(dftDifference(input.get(), spectrum.get()) < TOLERANCE,
+         name.str() + ": forward matches the direct DFT");
+
+   ossimRefPtr<ossimImageData> output = makeTile(w, h, bands);
+   inverse->transform(spectrum, output);
+   check(maxDifference(input.get(), output.get(), bands) < TOLERANCE,
+         name.str() + ": inverse of the forward gives the pixels back");
+}
+
+// Round trips through shared filters from several threads, returning the number that came back
+// wrong.
+static int testThreads(TestFilter* forward, TestFilter* inverse, ossim_uint32 numThreads,
+                       int rounds)
+{
+   // Ten plans each way, more than a filter keeps:
+   static const ossim_uint32 SIZES[][2] = { {32, 16}, {16, 32}, {48, 20}, {20, 48}, {64, 8},
+                                            {8, 64}, {30, 18}, {18, 30}, {40, 24}, {24, 40} };
+   atomic<int> wrong(0);
+   vector<thread> threads;
+   for (ossim_uint32 t=0; t<numThreads; ++t)
+   {
+      threads.push_back(thread([forward, inverse, t, rounds, &wrong]()
+      {
+         for (int r=0; r<rounds; ++r)
+         {
+            const ossim_uint32* size = SIZES[(t + r) % 10];
+            ossimRefPtr<ossimImageData> input = makeImage(size[0], size[1], 2, t*rounds + r);
+            ossimRefPtr<ossimImageData> spectrum = makeTile(size[0], size[1], 4);
+            ossimRefPtr<ossimImageData> output = makeTile(size[0], size[1], 2);
+            forward->transform(input, spectrum);
+            inverse->transform(spectrum, output);
+            if (maxDifference(input.get(), output.get(), 2) >= TOLERANCE)
+               ++wrong;
+         }
+      }));
+   }
+   for (size_t t=0; t<threads.size(); ++t)
+      threads[t].join();
+   return wrong;
+}
+
+int main()
+{
+   ossimRefPtr<TestFilter> forward = new TestFilter(true, ossimFftw3Filter::ESTIMATE);
+   ossimRefPtr<TestFilter> inverse = new TestFilter(false, ossimFftw3Filter::ESTIMATE);
+   testSize(forward.get(), inverse.get(), 12, 6, 1);
+   testSize(forward.get(), inverse.get(), 6, 12, 3);
+   testSize(forward.get(), inverse.get(), 15, 9, 2);
+   testSize(forward.get(), inverse.get(), 7, 32, 1);
+   testSize(forward.get(), inverse.get(), 1, 10, 1);
+
+   // Planned for the more expensive tiles:
+   forward->setPlannerEffort(ossimFftw3Filter::MEASURE);
+   inverse->setPlannerEffort(ossimFftw3Filter::MEASURE);
+   testSize(forward.get(), inverse.get(), 64, 24, 2);
+   testSize(forward.get(), inverse.get(), 25, 40, 1);
+
+   forward->setPlannerEffort(ossimFftw3Filter::ESTIMATE);
+   inverse->setPlannerEffort(ossimFftw3Filter::ESTIMATE);
+   const int wrong = testThreads(forward.get(), inverse.get(), 4, 200);
+   check(wrong == 0, "4 threads sharing the filters, 800 round trips over 10 tile sizes: " +
+         to_string(wrong) + " wrong");
+
+   return ossimPluginTest::summary();
+}
@@ -15,11 +15,15 @@
 #include <ossim/imaging/ossimImageSourceSequencer.h>
 #include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimImageDataFactory.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimProcessProgressEvent.h>
 #include <cpl_string.h>
+#include <exception>
 
 static GDALDriver	*poMEMTiledDriver = NULL;
 
+static const char READ_AHEAD_ROWS_KW[] = "gdal_writer_read_ahead_rows";
+
 #include <ossim/base/ossimTrace.h>
 static ossimTrace traceDebug(ossimString("ossimGdalTiledDataset:debug"));
 
@@ -102,26 +106,7 @@ CPLErr MEMTiledRasterBand::IReadBlock( int nBlockXOff,
       return CE_None;
    }
 
-   ossimIrect bufferRect = theDataset->theData->getImageRectangle();
-
-   ossimIpt ul(theDataset->theAreaOfInterest.ul().x + nBlockXOff*nBlockXSize,
-               theDataset->theAreaOfInterest.ul().y + nBlockYOff*nBlockYSize);
-
-   ossimIrect requestRect(ul.x,
-                          ul.y,
-                          ul.x + nBlockXSize - 1,
-                          ul.y + nBlockYSize - 1);
-#if 0
-   if (traceDebug())
-   {
-      ossimNotify(ossimNotifyLevel_DEBUG)
-         << "\nrequestRect:  " << requestRect
-         << "\nbufferRect:   " << bufferRect
-         << endl;
-   }
-#endif
-
-   if(requestRect.height() > 1)
+   if ( nBlockYSize > 1 )
    {
       ossimNotify(ossimNotifyLevel_WARN)
          << "MEMTiledRasterBand::IReadBlock WARN!"
@@ -129,131 +114,29 @@ CPLErr MEMTiledRasterBand::IReadBlock( int nBlockXOff,
       return CE_None;
    }
 
-   if(nBlockYOff==0)
-   {
-      theDataset->theInterface->setToStartOfSequence();
-   }
-
-   bool loadBuffer = false;
-   
-   if ( (requestRect.completely_within(bufferRect) == false)  ||
-        (theDataset->theData->getDataObjectStatus() == OSSIM_EMPTY) )
-   {
-      loadBuffer = true;
-   }
-
-#if 0
-   ossim_int32 scanlineTile = ((nBlockYOff*nBlockYSize)%theDataset->theTileSize.y);
-   if (traceDebug())
-   {
-      ossimNotify(ossimNotifyLevel_DEBUG)
-         << "\nscanlineTile: " << scanlineTile
-         << endl;
-   }
-#endif
+   int nWordSize = GDALGetDataTypeSize( eDataType ) / 8;
+   CPLAssert( nBlockXOff == 0 );
 
-   if(loadBuffer)
+   if( nPixelOffset == nWordSize )
    {
-      theDataset->theData->makeBlank();
-      theDataset->theData->setOrigin(requestRect.ul());
-      // fill the tile with one row;
-      ossim_uint32 numberOfTiles = (ossim_uint32)theDataset->theInterface->getNumberOfTilesHorizontal();
-      for(ossim_uint32 i = 0; i < numberOfTiles; ++i)
+      bool copied = false;
+      if ( theDataset->copyLine( nBand-1, nBlockYOff*nBlockYSize, pImage,
+                                 copied ) != CE_None )
       {
-         ossimIpt tileOrigin(ul.x+theDataset->theTileSize.x*i, ul.y);
-#if 0
-         if (traceDebug())
-         {
-            ossimNotify(ossimNotifyLevel_DEBUG)
-               << "\ntileOrigin:  " << tileOrigin << endl;
-         }
-#endif
-         ossimRefPtr<ossimImageData> data =
-            theDataset->theInterface->getTile(
-               ossimIrect(tileOrigin.x,
-                          tileOrigin.y,
-                          tileOrigin.x + (theDataset->theTileSize.x - 1),
-                          tileOrigin.y + (theDataset->theTileSize.y - 1)));
-         if(data.valid())
-         {
-            if (data->getBuf())
-            {
-               theDataset->theData->loadTile(data.get());
-            }
-            else
-            {
-               // Hmmm???
-               ossimRefPtr<ossimImageData> tempData =
-                  (ossimImageData*)data->dup();
-               tempData->initialize();
-               theDataset->theData->loadTile(tempData.get());
-            }
-         }
+         return CE_Failure;
+      }
+      if ( copied == false )
+      {
+         copyNulls(pImage, nBlockYSize * nBlockXSize);
       }
-      theDataset->theData->validate();
-
-      // Capture the buffer rectangle.
-      bufferRect = theDataset->theData->getImageRectangle();
    }
-
-#if 0
-   if (traceDebug())
+   else
    {
-      ossimNotify(ossimNotifyLevel_DEBUG)
-         << "nBlockYOff:  " << nBlockYOff
-         << "\ntheDataset->theData->getImageRectangle()"
-         << theDataset->theData->getImageRectangle()
+      ossimNotify(ossimNotifyLevel_WARN)
+         << "MEMTiledRasterBand::IReadBlock WARN!"
+         << "\nUnhandled wordsize..."
          << endl;
    }
-#endif
-   
-   // Bytes per pixel.
-   const ossim_int32 BPP = static_cast<ossim_int32>(
-      theDataset->theData->getScalarSizeInBytes());
-
-   if(theDataset->theData->getDataObjectStatus() == OSSIM_EMPTY)
-   {
-      copyNulls(pImage, nBlockYSize * nBlockXSize);
-   }
-   else 
-   {
-      int nWordSize = GDALGetDataTypeSize( eDataType ) / 8;
-      CPLAssert( nBlockXOff == 0 );
-
-      if( nPixelOffset == nWordSize )
-      {
-         ossim_uint32 offset = (ul.y - bufferRect.ul().y) *
-            bufferRect.width() * BPP +
-            (ul.x - bufferRect.ul().x) * BPP;
-
-         GByte *pabyCur = ((GByte*) (theDataset->theData->getBuf(nBand-1)))
-            + offset;
-
-         memcpy( pImage,
-                 pabyCur,
-                 nPixelOffset * nBlockXSize);
-      }
-      else
-      {
-         ossimNotify(ossimNotifyLevel_WARN)
-            << "MEMTiledRasterBand::IReadBlock WARN!"
-            << "\nUnhandled wordsize..."
-            << endl;
-#if 0
-         // shift to start of scanline
-         GByte *pabyCur = (GByte*) (theDataset->theData->getBuf(nBand-1))
-                          + (theDataset->theData->getScalarSizeInBytes()*
-                             theDataset->theData->getWidth()*scanlineTile);
-         
-         for( int iPixel = 0; iPixel < nBlockXSize; iPixel++ )
-         {
-            memcpy( (GByte *) pImage+ iPixel*nWordSize, 
-                    pabyCur + iPixel*nPixelOffset,
-                    nWordSize );
-         }
-#endif
-      }
-   }
 
    return CE_None;
 }
@@ -309,7 +192,20 @@ MEMTiledDataset::MEMTiledDataset()
    theTileSize(),
    theAreaOfInterest(),
    theJustCreatedFlag(false),
-   theSetNoDataValueFlag(true)
+   theSetNoDataValueFlag(true),
+   theReadAheadRowCount(2),
+   theReadAheadThread(),
+   theReadAheadMutex(),
+   theReadAheadCondition(),
+   theReadyRows(),
+   theFreeRows(),
+   theFirstReadyRow(0),
+   theNextRowToLoad(0),
+   theCurrentRow(-1),
+   theNumberOfRows(0),
+   theSequentialFlag(true),
+   theStopReadAheadFlag(false),
+   theReadAheadError()
 {
 }
 
@@ -321,7 +217,20 @@ MEMTiledDataset::MEMTiledDataset(ossimImageSourceSequencer* iface)
    theTileSize(),
    theAreaOfInterest(),
    theJustCreatedFlag(false),
-   theSetNoDataValueFlag(true)
+   theSetNoDataValueFlag(true),
+   theReadAheadRowCount(2),
+   theReadAheadThread(),
+   theReadAheadMutex(),
+   theReadAheadCondition(),
+   theReadyRows(),
+   theFreeRows(),
+   theFirstReadyRow(0),
+   theNextRowToLoad(0),
+   theCurrentRow(-1),
+   theNumberOfRows(0),
+   theSequentialFlag(true),
+   theStopReadAheadFlag(false),
+   theReadAheadError()
 {
    create(theInterface);
 }
@@ -333,6 +242,7 @@ MEMTiledDataset::MEMTiledDataset(ossimImageSourceSequencer* iface)
 MEMTiledDataset::~MEMTiledDataset()
 
 {
+    stopReadAhead();
     FlushCache();
 }
 
@@ -436,6 +346,13 @@ void MEMTiledDataset::create(ossimImageSourceSequencer* iface)
       CPLFree( papBandData );
 
       theAreaOfInterest = theInterface->getBoundingRect();
+      theNumberOfRows = (theAreaOfInterest.height() + theTileSize.y - 1) / theTileSize.y;
+
+      const char* lookup = ossimPreferences::instance()->findPreference(READ_AHEAD_ROWS_KW);
+      if ( lookup )
+      {
+         theReadAheadRowCount = ossimString::toUInt32(lookup);
+      }
 /* -------------------------------------------------------------------- */
 /*      Try to return a regular handle on the file.                     */
 /* -------------------------------------------------------------------- */
@@ -455,6 +372,285 @@ void MEMTiledDataset::setNoDataValueFlag(bool flag)
    theSetNoDataValueFlag = flag;
 }
 
+void MEMTiledDataset::setReadAheadRows(ossim_uint32 rows)
+{
+   std::lock_guard<std::mutex> lock(theReadAheadMutex);
+   theReadAheadRowCount = rows;
+}
+
+void MEMTiledDataset::stopReadAhead()
+{
+   std::unique_lock<std::mutex> lock(theReadAheadMutex);
+   theStopReadAheadFlag = true;
+   theReadAheadCondition.notify_all();
+   if ( theReadAheadThread.joinable() )
+   {
+      lock.unlock();
+      theReadAheadThread.join();
+      lock.lock();
+   }
+   theStopReadAheadFlag = false;
+}
+
+CPLErr MEMTiledDataset::copyLine(ossim_uint32 band, ossim_int32 line,
+                                 void* pImage, bool& copied)
+{
+   std::unique_lock<std::mutex> lock(theReadAheadMutex);
+
+   copied = false;
+
+   const ossim_int32 row = line / theTileSize.y;
+   
+   if ( row != theCurrentRow )
+   {
+      if ( theReadAheadRowCount == 0 )
+      {
+         // Synchronous mode:
+         if ( row == 0 )
+         {
+            theInterface->setToStartOfSequence();
+         }
+         loadTileRow( row, false, theData.get() );
+      }
+      else
+      {
+         //---
+         // Restart if going backwards (e.g. band interleaved copy starting
+         // the next band) or jumping past what the thread is loading.
+         //---
+         if ( !theReadAheadThread.joinable() ||
+              (row < theFirstReadyRow) || (row > theNextRowToLoad) )
+         {
+            restartReadAhead(row, lock);
+         }
+
+         // Recycle rows behind the cursor.
+         while ( !theReadyRows.empty() && (theFirstReadyRow < row) )
+         {
+            theFreeRows.push_back( theReadyRows.front() );
+            theReadyRows.pop_front();
+            ++theFirstReadyRow;
+         }
+         if ( theFirstReadyRow < row )
+         {
+            // Thread has not caught up yet; it will skip ahead.
+            theFirstReadyRow = row;
+         }
+         theReadAheadCondition.notify_all();
+
+         // Wait for the thread to load our row.
+         while ( theReadyRows.empty() && theReadAheadThread.joinable() &&
+                 !theStopReadAheadFlag )
+         {
+            theReadAheadCondition.wait(lock);
+         }
+
+         if ( theReadyRows.empty() )
+         {
+            if ( theReadAheadError.size() )
+            {
+               CPLError( CE_Failure, CPLE_AppDefined,
+                         "MEMTiledDataset: read ahead of tile row %d failed: %s",
+                         row, theReadAheadError.c_str() );
+               return CE_Failure;
+            }
+            return CE_None;
+         }
+         theData = theReadyRows.front();
+      }
+      theCurrentRow = row;
+   }
+
+   if ( theData->getDataObjectStatus() == OSSIM_EMPTY )
+   {
+      return CE_None;
+   }
+
+   const ossimIrect bufferRect = theData->getImageRectangle();
+   const ossim_uint32 BPP = theData->getScalarSizeInBytes();
+   const ossim_uint32 offset = (theAreaOfInterest.ul().y + line - bufferRect.ul().y) *
+      bufferRect.width() * BPP +
+      (theAreaOfInterest.ul().x - bufferRect.ul().x) * BPP;
+   
+   memcpy( pImage,
+           static_cast<const GByte*>( theData->getBuf(band) ) + offset,
+           nRasterXSize * BPP );
+
+   copied = true;
+   return CE_None;
+}
+
+void MEMTiledDataset::restartReadAhead(ossim_int32 row,
+                                       std::unique_lock<std::mutex>& lock)
+{
+   theStopReadAheadFlag = true;
+   theReadAheadCondition.notify_all();
+   if ( theReadAheadThread.joinable() )
+   {
+      lock.unlock();
+      theReadAheadThread.join();
+      lock.lock();
+   }
+   theStopReadAheadFlag = false;
+   theReadAheadError.clear();
+
+   while ( theReadyRows.size() )
+   {
+      theFreeRows.push_back( theReadyRows.front() );
+      theReadyRows.pop_front();
+   }
+   theFirstReadyRow = row;
+   theNextRowToLoad = row;
+
+   //---
+   // Only the natural in order case goes through getNextTile; anything
+   // else is random access by rectangle.
+   //---
+   theSequentialFlag = (row == 0);
+   if ( theSequentialFlag )
+   {
+      theInterface->setToStartOfSequence();
+   }
+
+   theReadAheadThread = std::thread(&MEMTiledDataset::readAheadLoop, this);
+}
+
+void MEMTiledDataset::readAheadLoop()
+{
+   std::unique_lock<std::mutex> lock(theReadAheadMutex);
+   
+   //---
+   // Nothing may escape the thread (std::terminate).  Anything thrown by the
+   // input chain ends the read ahead and is handed to copyLine.
+   //---
+   try
+   {
+      while ( !theStopReadAheadFlag && (theNextRowToLoad < theNumberOfRows) )
+      {
+         if ( theNextRowToLoad < theFirstReadyRow )
+         {
+            // Consumer skipped ahead.
+            theNextRowToLoad = theFirstReadyRow;
+            theSequentialFlag = false;
+            continue;
+         }
+         if ( (theNextRowToLoad - theFirstReadyRow) >=
+              static_cast<ossim_int32>(theReadAheadRowCount) )
+         {
+            theReadAheadCondition.wait(lock);
+            continue;
+         }
+
+         const ossim_int32 row = theNextRowToLoad;
+         const bool sequential = theSequentialFlag;
+         ossimRefPtr<ossimImageData> buffer = getFreeRow();
+      
+         lock.unlock();
+         loadTileRow(row, sequential, buffer.get());
+         lock.lock();
+
+         if ( theStopReadAheadFlag )
+         {
+            break;
+         }
+         if ( row == theFirstReadyRow + static_cast<ossim_int32>(theReadyRows.size()) )
+         {
+            theReadyRows.push_back(buffer);
+         }
+         else
+         {
+            theFreeRows.push_back(buffer);
+         }
+         ++theNextRowToLoad;
+         theReadAheadCondition.notify_all();
+      }
+   }
+   catch ( const std::exception& e )
+   {
+      if ( !lock.owns_lock() )
+      {
+         lock.lock();
+      }
+      theReadAheadError = e.what();
+   }
+   catch ( ... )
+   {
+      if ( !lock.owns_lock() )
+      {
+         lock.lock();
+      }
+      theReadAheadError = "unknown exception";
+   }
+
+   // Let a waiting consumer see the end.
+   theStopReadAheadFlag = true;
+   theReadAheadCondition.notify_all();
+}
+
+ossimRefPtr<ossimImageData> MEMTiledDataset::getFreeRow()
+{
+   ossimRefPtr<ossimImageData> result = 0;
+   while ( theFreeRows.size() )
+   {
+      result = theFreeRows.back();
+      theFreeRows.pop_back();
+
+      // Do not hand out the buffer GDAL is reading from.
+      if ( result != theData )
+      {
+         return result;
+      }
+   }
+   result = static_cast<ossimImageData*>( theData->dup() );
+   return result;
+}
+
+void MEMTiledDataset::loadTileRow(ossim_int32 row, bool sequential,
+                                  ossimImageData* buffer)
+{
+   const ossimIpt ul( theAreaOfInterest.ul().x,
+                      theAreaOfInterest.ul().y + row * theTileSize.y );
+   
+   buffer->makeBlank();
+   buffer->setOrigin(ul);
+
+   // fill the tile with one row;
+   ossim_uint32 numberOfTiles = (ossim_uint32)theInterface->getNumberOfTilesHorizontal();
+   for(ossim_uint32 i = 0; i < numberOfTiles; ++i)
+   {
+      ossimRefPtr<ossimImageData> data = 0;
+      if ( sequential )
+      {
+         data = theInterface->getNextTile();
+      }
+      else
+      {
+         ossimIpt tileOrigin(ul.x+theTileSize.x*i, ul.y);
+         data = theInterface->getTile(
+            ossimIrect(tileOrigin.x,
+                       tileOrigin.y,
+                       tileOrigin.x + (theTileSize.x - 1),
+                       tileOrigin.y + (theTileSize.y - 1)));
+      }
+      if(data.valid())
+      {
+         if (data->getBuf())
+         {
+            buffer->loadTile(data.get());
+         }
+         else
+         {
+            // Hmmm???
+            ossimRefPtr<ossimImageData> tempData =
+               (ossimImageData*)data->dup();
+            tempData->initialize();
+            buffer->loadTile(tempData.get());
+         }
+      }
+   }
+   buffer->validate();
+}
+
 /************************************************************************/
 /*                          GDALRegister_MEM()                          */
 /************************************************************************/
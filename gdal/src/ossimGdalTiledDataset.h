@@ -18,6 +18,12 @@
 #include <ossim/base/ossimListenerManager.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimIrect.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 class MEMTiledRasterBand;
 class ossimImageSourceSequencer;
@@ -41,9 +47,72 @@ private:
     * value.
     */
    bool theSetNoDataValueFlag;
+
+   /**
+    * Read ahead state.  A single producer thread pulls tile rows from
+    * theInterface into theReadyRows while GDAL consumes scanlines from the
+    * front.  Only the producer thread touches theInterface once started.
+    * All fields below are guarded by theReadAheadMutex.
+    */
+   ossim_uint32                                 theReadAheadRowCount;
+   std::thread                                  theReadAheadThread;
+   std::mutex                                   theReadAheadMutex;
+   std::condition_variable                      theReadAheadCondition;
+   std::deque< ossimRefPtr<ossimImageData> >    theReadyRows;
+   std::vector< ossimRefPtr<ossimImageData> >   theFreeRows;
+   ossim_int32                                  theFirstReadyRow;
+   ossim_int32                                  theNextRowToLoad;
+   ossim_int32                                  theCurrentRow;
+   ossim_int32                                  theNumberOfRows;
+   bool                                         theSequentialFlag;
+   bool                                         theStopReadAheadFlag;
+
+   /** What stopped the read ahead thread, empty if nothing went wrong. */
+   std::string                                  theReadAheadError;
    
    void create(ossimImageSourceSequencer* iface);
 
+   /**
+    * @brief Copies one scanline of a band into pImage.
+    *
+    * Loads (or waits for the read ahead thread to load) the tile row
+    * containing line.  Thread safe.
+    *
+    * @param band Zero based band.
+    * @param line Zero based line relative to the area of interest.
+    * @param pImage Buffer to copy to.  Must hold nRasterXSize pixels.
+    * @param copied Set to true if data was copied, false if the row is
+    * empty and the caller should fill with nulls.
+    * @return CE_Failure if the read ahead thread failed to load the row
+    * (reported through CPLError), else CE_None.
+    */
+   CPLErr copyLine(ossim_uint32 band, ossim_int32 line, void* pImage,
+                   bool& copied);
+
+   /**
+    * @brief Positions the read ahead at tile row, restarting the producer
+    * thread if enabled.  Caller must hold lock.
+    */
+   void restartReadAhead(ossim_int32 row,
+                         std::unique_lock<std::mutex>& lock);
+
+   /**
+    * @brief Producer thread body.  Exceptions from the input chain are
+    * caught here and left in theReadAheadError for copyLine to report.
+    */
+   void readAheadLoop();
+
+   /** @return A blank buffer for one tile row. Caller must hold lock. */
+   ossimRefPtr<ossimImageData> getFreeRow();
+
+   /**
+    * @brief Fills buffer with the tiles of tile row.
+    * @param row Zero based tile row.
+    * @param sequential If true theInterface->getNextTile() is used so
+    * a multi-threaded sequencer can fetch tiles in parallel; else tiles
+    * are requested by rectangle.
+    */
+   void loadTileRow(ossim_int32 row, bool sequential, ossimImageData* buffer);
  
 
 public:
@@ -67,6 +136,28 @@ public:
     * performed.  If false it will be bypassed.
     */
    void setNoDataValueFlag(bool flag);
+
+   /**
+    * @brief Sets the number of tile rows to load ahead of GDAL's read
+    * cursor on a background thread.
+    *
+    * Defaults to the "gdal_writer_read_ahead_rows" preference or 2.  Zero
+    * disables the background thread and tile rows are loaded on the
+    * calling thread as GDAL requests them.  Tiles come from the
+    * sequencer's getNextTile so a multi-threaded sequencer will produce
+    * the tiles of a row in parallel.
+    *
+    * Must be called before the first block is read.
+    */
+   void setReadAheadRows(ossim_uint32 rows);
+
+   /**
+    * @brief Stops and joins the read ahead thread.
+    *
+    * Call after GDALCreateCopy returns, before the input connection is
+    * touched again by the caller.
+    */
+   void stopReadAhead();
 };
 
 /************************************************************************/
@@ -653,6 +653,9 @@ bool ossimGdalWriter::writeBlockFile()
                                 theGdalDriverOptions,
                                 (GDALProgressFunc)&gdalProgressFunc,
                                 this);
+
+   // Join the read ahead thread before anyone else touches the sequencer.
+   tiledDataset->stopReadAhead();
    
    if(theDataset&&!needsAborting())
    {
@@ -0,0 +1,344 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Checks the tile row read ahead of MEMTiledDataset, the GDAL dataset ossimGdalWriter hands to
+// GDALCreateCopy, against the same dataset with read ahead off. A three band 16 bit image with
+// a known pattern is fed through a slow filter and an ossimImageSourceSequencer, and the blocks
+// are read band after band, line after line with the bands interleaved, and in jumps forward
+// and back, with 0, 1, 2 and 4 rows read ahead. Every read must give the same pixels, which must
+// be the pattern, and the input chain must never be called from two threads at once.
+//
+// The dataset is then closed halfway through the image while the read ahead thread is loading:
+// the close must come back within a row's worth of tiles and nothing may touch the input after
+// it. stopReadAhead() in the middle of a read, as ossimGdalWriter calls it, must leave the rest
+// readable. A tile row the input throws on must come back as CE_Failure, and the rows before it
+// as they are.
+//
+// Usage: read-ahead-test
+
+#include "../src/ossimGdalTiledDataset.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimException.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageSourceFilter.h>
+#include <ossim/imaging/ossimImageSourceSequencer.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <cpl_error.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const int BANDS = 3;
+static const int TILE_SIZE = 64;
+
+// The image, and the area of interest inside it: ragged last tile column and row.
+static const int IMAGE_WIDTH = 1024;
+static const int IMAGE_HEIGHT = 712;
+static const ossimIrect AOI(5, 3, 5 + 1000 - 1, 3 + 700 - 1);
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Never 0 so no pixel reads as null.
+static ossim_uint16 pattern(int x, int y, int band)
+{
+   return (ossim_uint16) ((x*7 + y*13 + band*1000) % 60000 + 1);
+}
+
+//---
+// Pass through filter that takes its time over each tile, counts the tiles, notes if two threads
+// are ever in it at once and throws on the tile row it is told to.
+//---
+class SlowFilter : public ossimImageSourceFilter
+{
+public:
+   SlowFilter(ossimImageSource* input, int microseconds)
+      : ossimImageSourceFilter(input),
+        m_microseconds(microseconds),
+        m_throwRow(-1),
+        m_tiles(0),
+        m_active(0),
+        m_overlap(false)
+   {
+   }
+
+   using ossimImageSourceFilter::getTile;
+
+   virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& rect, ossim_uint32 resLevel=0)
+   {
+      Active active(*this);
+      ++m_tiles;
+      if (m_microseconds)
+         this_thread::sleep_for(chrono::microseconds(m_microseconds));
+      if ((m_throwRow >= 0) && ((rect.ul().y - AOI.ul().y) / TILE_SIZE == m_throwRow))
+         throw ossimException("tile row is corrupt");
+      return ossimImageSourceFilter::getTile(rect, resLevel);
+   }
+
+   int m_microseconds;
+   int m_throwRow;
+   atomic<int> m_tiles;
+   atomic<int> m_active;
+   atomic<bool> m_overlap;
+
+private:
+   struct Active
+   {
+      Active(SlowFilter& f) : filter(f)
+      {
+         if (++filter.m_active > 1)
+            filter.m_overlap = true;
+      }
+      ~Active() { --filter.m_active; }
+      SlowFilter& filter;
+   };
+};
+
+// The pattern image through a SlowFilter and a sequencer over AOI.
+struct Chain
+{
+   Chain(int microseconds)
+   {
+      ossimRefPtr<ossimImageData> image =
+         new ossimImageData(0, OSSIM_UINT16, BANDS, IMAGE_WIDTH, IMAGE_HEIGHT);
+      image->initialize();
+      for (int b=0; b<BANDS; ++b)
+      {
+         ossim_uint16* buf = (ossim_uint16*) image->getBuf(b);
+         for (int y=0; y<IMAGE_HEIGHT; ++y)
+            for (int x=0; x<IMAGE_WIDTH; ++x)
+               buf[y*IMAGE_WIDTH + x] = pattern(x, y, b);
+      }
+      image->validate();
+      memory = new ossimMemoryImageSource;
+      memory->setImage(image);
+
+      filter = new SlowFilter(memory.get(), microseconds);
+      filter->initialize();
+
+      sequencer = new ossimImageSourceSequencer;
+      sequencer->connectMyInputTo(0, filter.get());
+      sequencer->setTileSize(ossimIpt(TILE_SIZE, TILE_SIZE));
+      sequencer->setAreaOfInterest(AOI);
+      sequencer->setToStartOfSequence();
+   }
+
+   ~Chain()
+   {
+      sequencer->disconnect();
+      filter->disconnect();
+   }
+
+   ossimRefPtr<ossimMemoryImageSource> memory;
+   ossimRefPtr<SlowFilter> filter;
+   ossimRefPtr<ossimImageSourceSequencer> sequencer;
+};
+
+// One block read: zero based band, line.
+typedef vector< pair<int, int> > Order;
+
+static Order bandInterleaved()
+{
+   Order order;
+   for (int b=0; b<BANDS; ++b)
+      for (int line=0; line<(int) AOI.height(); ++line)
+         order.push_back(make_pair(b, line));
+   return order;
+}
+
+static Order lineInterleaved()
+{
+   Order order;
+   for (int line=0; line<(int) AOI.height(); ++line)
+      for (int b=0; b<BANDS; ++b)
+         order.push_back(make_pair(b, line));
+   return order;
+}
+
+// Runs of a few lines from all over the image, forward and back, far and near.
+static Order jumps()
+{
+   Order order;
+   for (int k=0; k<200; ++k)
+   {
+      const int first = (k*263) % AOI.height();
+      for (int line=first; (line < first + 5) && (line < (int) AOI.height()); ++line)
+         order.push_back(make_pair(k % BANDS, line));
+   }
+   return order;
+}
+
+// Reads the blocks of order from index begin to end onto pixels. False on the first failed read.
+static bool readBlocks(GDALDataset* ds, const Order& order, size_t begin, size_t end,
+                       vector<ossim_uint16>& pixels)
+{
+   const int width = ds->GetRasterXSize();
+   vector<ossim_uint16> block(width);
+   for (size_t i=begin; i<end; ++i)
+   {
+      GDALRasterBand* band = ds->GetRasterBand(order[i].first + 1);
+      if (band->ReadBlock(0, order[i].second, &block[0]) != CE_None)
+         return false;
+      pixels.insert(pixels.end(), block.begin(), block.end());
+   }
+   return true;
+}
+
+// Index of the first read of order that does not show the pattern, order.size() if none.
+static size_t firstWrongRead(const Order& order, const vector<ossim_uint16>& pixels)
+{
+   const int width = AOI.width();
+   for (size_t i=0; i<order.size(); ++i)
+   {
+      if ((i + 1)*width > pixels.size())
+         return i;
+      const int y = AOI.ul().y + order[i].second;
+      for (int x=0; x<width; ++x)
+         if (pixels[i*width + x] != pattern(AOI.ul().x + x, y, order[i].first))
+            return i;
+   }
+   return order.size();
+}
+
+static void testOrder(const string& name, const Order& order)
+{
+   vector<ossim_uint16> reference;
+   const int ROWS[] = { 0, 1, 2, 4 };
+   for (size_t r=0; r<sizeof(ROWS)/sizeof(ROWS[0]); ++r)
+   {
+      Chain chain(200);
+      MEMTiledDataset* ds = new MEMTiledDataset(chain.sequencer.get());
+      ds->setReadAheadRows(ROWS[r]);
+      vector<ossim_uint16> pixels;
+      const bool ok = readBlocks(ds, order, 0, order.size(), pixels);
+      GDALClose((GDALDatasetH) ds);
+
+      ostringstream what;
+      what << name << ", " << ROWS[r] << " rows read ahead: ";
+      if (ROWS[r] == 0)
+      {
+         reference = pixels;
+         check(ok && (firstWrongRead(order, pixels) == order.size()),
+               what.str() + "every block shows the image");
+      }
+      else
+      {
+         check(ok && (pixels == reference), what.str() + "same blocks as with read ahead off");
+      }
+      check(!chain.filter->m_overlap, what.str() + "input called from one thread at a time");
+   }
+}
+
+// Closes the dataset with the read ahead thread busy halfway down the image.
+static void testCloseMidRead()
+{
+   // 2 ms a tile: a tile row takes about 32 ms to load.
+   Chain chain(2000);
+   MEMTiledDataset* ds = new MEMTiledDataset(chain.sequencer.get());
+   ds->setReadAheadRows(4);
+   const Order order = lineInterleaved();
+   vector<ossim_uint16> pixels;
+   const bool ok = readBlocks(ds, order, 0, order.size()/2, pixels);
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   GDALClose((GDALDatasetH) ds);
+   const double closeTime = seconds(start);
+
+   const int tiles = chain.filter->m_tiles;
+   this_thread::sleep_for(chrono::milliseconds(100));
+
+   ostringstream what;
+   what << "close halfway down the image returns in " << closeTime << " s";
+   check(ok && (closeTime < 1.0), what.str());
+   check((chain.filter->m_tiles == tiles) && (chain.filter->m_active == 0),
+         "close halfway down the image: no tile asked for after it");
+   check(!chain.filter->m_overlap, "close halfway down the image: input called from one thread "
+         "at a time");
+}
+
+// stopReadAhead() halfway down the image, as ossimGdalWriter calls it, then reads the rest.
+static void testStopAndResume()
+{
+   Chain chain(500);
+   MEMTiledDataset* ds = new MEMTiledDataset(chain.sequencer.get());
+   ds->setReadAheadRows(2);
+   const Order order = lineInterleaved();
+   // Stop part way into a tile row so the rest of it comes from the row already loaded.
+   const size_t half = (order.size()/2/BANDS + TILE_SIZE/2)*BANDS;
+   vector<ossim_uint16> pixels;
+   bool ok = readBlocks(ds, order, 0, half, pixels);
+
+   ds->stopReadAhead();
+   const int tiles = chain.filter->m_tiles;
+   this_thread::sleep_for(chrono::milliseconds(50));
+   check(ok && (chain.filter->m_tiles == tiles) && (chain.filter->m_active == 0),
+         "stopReadAhead halfway down the image: no tile asked for after it");
+
+   ok = readBlocks(ds, order, half, order.size(), pixels);
+   GDALClose((GDALDatasetH) ds);
+   check(ok && (firstWrongRead(order, pixels) == order.size()),
+         "stopReadAhead halfway down the image: the rest reads as the image");
+}
+
+// The input throws on one tile row.
+static void testInputError()
+{
+   const int BAD_ROW = 5;
+   Chain chain(0);
+   chain.filter->m_throwRow = BAD_ROW;
+   MEMTiledDataset* ds = new MEMTiledDataset(chain.sequencer.get());
+   ds->setReadAheadRows(2);
+   const Order order = bandInterleaved();
+   const size_t badRead = BAD_ROW*TILE_SIZE;
+
+   CPLPushErrorHandler(CPLQuietErrorHandler);
+   CPLErrorReset();
+   vector<ossim_uint16> pixels;
+   const bool before = readBlocks(ds, order, 0, badRead, pixels);
+   vector<ossim_uint16> bad;
+   const bool failed = !readBlocks(ds, order, badRead, badRead + 1, bad);
+   const string message = CPLGetLastErrorMsg();
+   CPLPopErrorHandler();
+
+   // Back to the top: the read ahead starts again.
+   vector<ossim_uint16> again;
+   const bool restarted = readBlocks(ds, order, 0, TILE_SIZE, again);
+   GDALClose((GDALDatasetH) ds);
+
+   check(before && (firstWrongRead(Order(order.begin(), order.begin() + badRead), pixels) ==
+                    badRead), "input error: the rows before the bad one read as the image");
+   check(failed && (message.find("tile row is corrupt") != string::npos),
+         "input error: the bad row reads as CE_Failure with the input's message (" + message +
+         ")");
+   check(restarted && (firstWrongRead(Order(order.begin(), order.begin() + TILE_SIZE), again) ==
+                       (size_t) TILE_SIZE), "input error: reading from the top again works");
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   testOrder("band interleaved", bandInterleaved());
+   testOrder("line interleaved", lineInterleaved());
+   testOrder("jumps", jumps());
+   testCloseMidRead();
+   testStopAndResume();
+   testInputError();
+
+   return ossimPluginTest::summary();
+}
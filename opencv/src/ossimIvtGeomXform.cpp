@@ -1,4 +1,40 @@
 #include "ossimIvtGeomXform.h"
+#include <ossim/imaging/ossimImageGeometry.h>
+
+
+ossimIvtGeomXform* ossimIvtGeomXform::clone() const
+{
+  ossimRefPtr<ossimImageViewTransform> ivt;
+  ossimRefPtr<ossimImageGeometry> geom;
+  const ossimImageViewProjectionTransform* ivpt =
+    dynamic_cast<const ossimImageViewProjectionTransform*>(m_ivt.get());
+  if(ivpt)
+  {
+    // Copied through the geometries, whose copies own their projections
+    ossimRefPtr<ossimImageGeometry> viewGeom;
+    if(ivpt->getImageGeometry())
+    {
+      geom = new ossimImageGeometry(*ivpt->getImageGeometry());
+    }
+    if(ivpt->getViewGeometry())
+    {
+      viewGeom = new ossimImageGeometry(*ivpt->getViewGeometry());
+    }
+    ivt = new ossimImageViewProjectionTransform(geom.get(), viewGeom.get());
+  }
+  else
+  {
+    if(m_ivt.valid())
+    {
+      ivt = dynamic_cast<ossimImageViewTransform*>(m_ivt->dup());
+    }
+    if(m_geom.valid())
+    {
+      geom = new ossimImageGeometry(*m_geom);
+    }
+  }
+  return new ossimIvtGeomXform(ivt.get(), geom.get());
+}
 
 
 void ossimIvtGeomXform::viewToImage(const ossimDpt& viewPt, ossimDpt& ipt)
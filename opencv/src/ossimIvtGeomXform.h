@@ -17,6 +17,10 @@ public:
     m_geom(geom)
     {}
 
+    // Copy with its own transform and geometry, so it can project while the
+    // original is in use on another thread
+    ossimIvtGeomXform* clone() const;
+
     void viewToImage(const ossimDpt& viewPt, ossimDpt& ipt);
     void imageToView(const ossimDpt& ipt, ossimDpt& viewPt);
     void imageToGround(const ossimDpt& ipt, ossimGpt& gpt);
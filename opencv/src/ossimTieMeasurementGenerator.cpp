@@ -28,17 +28,46 @@
 #include <opencv2/flann/flann.hpp>
 #include <opencv2/features2d.hpp>
 #include <opencv2/imgproc.hpp>
+#include <opencv2/calib3d.hpp>
 // Note: These are purposely commented out to indicate non-use.
 // #include <opencv2/nonfree/nonfree.hpp>
 // #include <opencv2/nonfree/features2d.hpp>
 // Note: These are purposely commented out to indicate non-use.
 
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <thread>
 #include <vector>
 #include <iostream>
 
 static ossimTrace traceExec  ("ossimTieMeasurementGenerator:exec");
 static ossimTrace traceDebug ("ossimTieMeasurementGenerator:debug");
 
+// Keypoints closer than this to an image edge are dropped by the detector or
+// extractor.  Used for the algorithms that do not tell; covers the 31 pixel
+// ORB/BRISK default.
+static const int DEFAULT_FEATURE_BORDER = 32;
+
+// Edge distance below which the algorithm drops keypoints
+static int algorithmBorder(const cv::Ptr<cv::Feature2D>& algorithm)
+{
+   const cv::Ptr<cv::ORB> orb = algorithm.dynamicCast<cv::ORB>();
+   if (orb)
+      return std::max(orb->getEdgeThreshold(), orb->getPatchSize()) + 1;
+   return DEFAULT_FEATURE_BORDER;
+}
+
+// Orders matches by query keypoint
+struct DMatchQueryLess
+{
+   bool operator()(const cv::DMatch& a, const cv::DMatch& b) const
+   {
+      return a.queryIdx < b.queryIdx;
+   }
+};
+
 
 //*****************************************************************************
 //  METHOD: ossimTieMeasurementGenerator::ossimTieMeasurementGenerator()
@@ -53,6 +82,10 @@ ossimTieMeasurementGenerator::ossimTieMeasurementGenerator()
    m_igxB(0),
    m_imgA(),
    m_imgB(),
+   m_tileA(0),
+   m_tileB(0),
+   m_patchExtractorA(),
+   m_patchExtractorB(),
    m_numMeasurements(0),
    m_maxMatches(5),
    m_spIndexA(0),
@@ -61,6 +94,16 @@ ossimTieMeasurementGenerator::ossimTieMeasurementGenerator()
    m_patchSizeB(),
    m_validBox(false),   
    m_useGrid(false),
+   m_gridSize(1,1),
+   m_numThreads(0),
+   m_cellA(),
+   m_searchA(),
+   m_searchB(),
+   m_guided(false),
+   m_searchRadius(20.0),
+   m_matchRatio(0.8),
+   m_geometricModel("affine"),
+   m_ransacThreshold(3.0),
    m_showCvWindow(false),
    m_patchRefA(),
    m_patchRefB(),
@@ -77,6 +120,9 @@ ossimTieMeasurementGenerator::ossimTieMeasurementGenerator()
    m_maxCvWindowDim(500),
    m_cvWindowName("Correlation Patch")
 {
+   m_predictAB[0] = 0.0; m_predictAB[1] = 1.0; m_predictAB[2] = 0.0;
+   m_predictAB[3] = 0.0; m_predictAB[4] = 0.0; m_predictAB[5] = 1.0;
+
    if (traceExec())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -144,17 +190,53 @@ ossimTieMeasurementGenerator::~ossimTieMeasurementGenerator()
 //*****************************************************************************
 //  METHOD: ossimTieMeasurementGenerator::refreshCollectionTraits()
 //  
-//  Collection trait initializer.
+//  Collection trait initializer.  Splits the patches into the grid cells.
 //*****************************************************************************
 bool ossimTieMeasurementGenerator::refreshCollectionTraits()
 {
    bool initOK = true;
 
+   m_cellA.clear();
+   m_searchA.clear();
+   m_searchB.clear();
+
+   int gridRows = 1;
+   int gridCols = 1;
    if (m_useGrid)
    {
-      int gridRows = m_gridSize.y;
-      int gridCols = m_gridSize.x;
-      //cv::ORB::create("");
+      gridRows = m_gridSize.y;
+      gridCols = m_gridSize.x;
+   }
+   if (gridRows<1 || gridCols<1 || m_patchSizeA.x<gridCols || m_patchSizeA.y<gridRows ||
+       m_patchSizeB.x<gridCols || m_patchSizeB.y<gridRows)
+   {
+      return false;
+   }
+
+   //---
+   // A cells are widened by the feature border so keypoints near their
+   // edges are still detected; a single cell is the whole patch.  The B
+   // search regions depend on the predicted offset and are set by run().
+   //---
+   const int margin = (gridRows*gridCols > 1) ? featureBorder() : 0;
+   const cv::Rect patchA(0, 0, m_patchSizeA.x, m_patchSizeA.y);
+   const cv::Rect patchB(0, 0, m_patchSizeB.x, m_patchSizeB.y);
+
+   for (int r=0; r<gridRows; ++r)
+   {
+      for (int c=0; c<gridCols; ++c)
+      {
+         cv::Rect cellA(c*m_patchSizeA.x/gridCols, r*m_patchSizeA.y/gridRows, 0, 0);
+         cellA.width  = (c+1)*m_patchSizeA.x/gridCols - cellA.x;
+         cellA.height = (r+1)*m_patchSizeA.y/gridRows - cellA.y;
+
+         cv::Rect searchA(cellA.x-margin, cellA.y-margin,
+                          cellA.width+2*margin, cellA.height+2*margin);
+
+         m_cellA.push_back(cellA);
+         m_searchA.push_back(searchA & patchA);
+         m_searchB.push_back(patchB);
+      }
    }
 
    return initOK;
@@ -164,7 +246,10 @@ bool ossimTieMeasurementGenerator::refreshCollectionTraits()
 //*****************************************************************************
 //  METHOD: ossimTieMeasurementGenerator::run()
 //  
-//  
+//  Fetches the patches once, then detects, describes and matches each grid
+//  cell on a pool of worker threads.  Each cell keeps at most m_maxMatches
+//  so a single textured area cannot take all the ties.  Cell results are
+//  merged in cell order, so the output does not depend on the thread count.
 //*****************************************************************************
 bool ossimTieMeasurementGenerator::run()
 {
@@ -174,6 +259,7 @@ bool ossimTieMeasurementGenerator::run()
    runOK = refreshCollectionTraits();
    if(!m_detector) runOK = false;
    if(!m_extractor) runOK = false;
+   if(!m_matcher) runOK = false;
    if (runOK)
    {
       // ossimIrect constructor center-based constructor
@@ -191,18 +277,19 @@ bool ossimTieMeasurementGenerator::run()
          ossimNotify(ossimNotifyLevel_DEBUG)<<" rectB = "<<rectB<<endl;
          ossimNotify(ossimNotifyLevel_DEBUG)<<" m_src A ossimScalarType = "<<m_src[m_spIndexA]->getOutputScalarType()<<endl;
          ossimNotify(ossimNotifyLevel_DEBUG)<<" m_src B ossimScalarType = "<<m_src[m_spIndexB]->getOutputScalarType()<<endl;
+         ossimNotify(ossimNotifyLevel_DEBUG)<<" grid cells = "<<m_cellA.size()<<endl;
       }
 
       // Get the patches
-      ossimRefPtr<ossimImageData> idA = m_src[m_spIndexA]->getTile(rectA);   
-      ossimRefPtr<ossimImageData> idB = m_src[m_spIndexB]->getTile(rectB);
+      m_tileA = m_src[m_spIndexA]->getTile(rectA);   
+      m_tileB = m_src[m_spIndexB]->getTile(rectB);
 
-      // Create the OpenCV images
-      m_imgA.create(cv::Size(rectA.width(), rectA.height()), CV_8UC1);
-      m_imgB.create(cv::Size(rectB.width(), rectB.height()), CV_8UC1);
-
-      memcpy(m_imgA.ptr(), (void*) idA->getBuf(), rectA.area());
-      memcpy(m_imgB.ptr(), (void*) idB->getBuf(), rectB.area());
+      //---
+      // Create the OpenCV images: 8-bit bands are used in place, other
+      // types are stretched to 8 bits.
+      //---
+      m_patchExtractorA.extract(m_tileA.get(), m_imgA);
+      m_patchExtractorB.extract(m_tileB.get(), m_imgB);
 
       if(m_imgA.empty())
       {
@@ -216,92 +303,200 @@ bool ossimTieMeasurementGenerator::run()
       }
       else
       {
-         // Detector
+         m_distEditFactor = 3; //TODO
+
+         //---
+         // Each cell is looked for in B where the geometries put it, widened
+         // by the search radius (the expected prediction error) and the
+         // feature border.  A single cell matched by brute force searches
+         // the whole B patch.
+         //---
+         computePrediction();
+         if (m_guided || (m_cellA.size() > 1))
+         {
+            const cv::Rect patchB(0, 0, m_patchSizeB.x, m_patchSizeB.y);
+            const float pad = (float)(m_searchRadius + featureBorder());
+            for (ossim_uint32 c=0; c<m_cellA.size(); ++c)
+            {
+               const cv::Rect& cellA = m_cellA[c];
+               const cv::Point2f corners[4] =
+               {
+                  predictB(cv::Point2f(cellA.x, cellA.y)),
+                  predictB(cv::Point2f(cellA.x+cellA.width, cellA.y)),
+                  predictB(cv::Point2f(cellA.x, cellA.y+cellA.height)),
+                  predictB(cv::Point2f(cellA.x+cellA.width, cellA.y+cellA.height))
+               };
+               float x0 = corners[0].x, x1 = corners[0].x, y0 = corners[0].y, y1 = corners[0].y;
+               for (int i=1; i<4; ++i)
+               {
+                  x0 = std::min(x0, corners[i].x); x1 = std::max(x1, corners[i].x);
+                  y0 = std::min(y0, corners[i].y); y1 = std::max(y1, corners[i].y);
+               }
+               const cv::Rect searchB((int)std::floor(x0-pad), (int)std::floor(y0-pad),
+                                      (int)std::ceil(x1-x0+2*pad), (int)std::ceil(y1-y0+2*pad));
+               m_searchB[c] = searchB & patchB;
+            }
+         }
+
+         //---
+         // Process the cells.  The calling thread is a worker too and uses
+         // the configured detector/extractor/matcher; the other workers use
+         // their own copies since OpenCV algorithm objects are not safe to
+         // share between threads.
+         //---
+         const ossim_uint32 numCells = (ossim_uint32)m_cellA.size();
+         ossim_uint32 numThreads = m_numThreads;
+         if (numThreads == 0)
+            numThreads = std::thread::hardware_concurrency();
+         if (numThreads == 0)
+            numThreads = 1;
+         if (numThreads > numCells)
+            numThreads = numCells;
+
+         std::vector<CellResult> cellResults(numCells);
+         std::atomic<ossim_uint32> cellIdx(0);
+         std::vector<std::thread> workers;
+         for (ossim_uint32 t=1; t<numThreads; ++t)
+         {
+            workers.push_back(std::thread(&ossimTieMeasurementGenerator::processCells, this,
+                                          std::ref(cellResults), std::ref(cellIdx), true));
+         }
+         processCells(cellResults, cellIdx, false);
+         for (ossim_uint32 t=0; t<workers.size(); ++t)
+         {
+            workers[t].join();
+         }
+
+         //---
+         // Merge in cell order.  Keypoints are appended to one list per
+         // image and the match indices shifted to point into those lists.
+         //---
          vector<cv::KeyPoint> keypointsA;
          vector<cv::KeyPoint> keypointsB;
-         m_detector->detect(m_imgA, keypointsA);
-         m_detector->detect(m_imgB, keypointsB);
-         
-         // Extractor
-         //    32 byte uchar arrays   CV_8U (0) ..........
-         //    cout << desc.rows << " " << desc.cols << " " << desc.type() << std::endl;
-         //    uchar d = desc.at<uchar>(row,col);
-         cv::Mat descriptorsA;
-         cv::Mat descriptorsB;
-         m_extractor->compute(m_imgA, keypointsA, descriptorsA);
-         m_extractor->compute(m_imgB, keypointsB, descriptorsB);
-         
-         // Execute matcher
-         //  TODO add cross-check process here?
-         //----------
-         // BruteForceMatcher<L2<float> > descriptorMatcher;
-         // vector<DMatch> filteredMatches12, matches12, matches21;
-         // descriptorMatcher.match( descriptors1, descriptors2, matches12 );
-         // descriptorMatcher.match( descriptors2, descriptors1, matches21 );
-         // for( size_t i = 0; i < matches12.size(); i++ )
-         // {
-         //     DMatch forward = matches12[i];
-         //     DMatch backward = matches21[forward.trainIdx];
-         //     if( backward.trainIdx == forward.queryIdx )
-         //         filteredMatches12.push_back( forward );
-         // }
-         //----------
-         std::vector<cv::DMatch> matches;
-         std::vector<cv::DMatch> matchesAB;
-         m_matcher->match(descriptorsA, descriptorsB, matchesAB);
-         
-         matches = matchesAB;
-
-         // Symmetry
-         // void symmetryTest(const std::vector<cv::DMatch> &matches1,const std::vector<cv::DMatch> &matches2,std::vector<cv::DMatch>& symMatches)
-         // {
-         //     symMatches.clear();
-         //     for (vector<DMatch>::const_iterator matchIterator1= matches1.begin();matchIterator1!= matches1.end(); ++matchIterator1)
-         //     {
-         //         for (vector<DMatch>::const_iterator matchIterator2= matches2.begin();matchIterator2!= matches2.end();++matchIterator2)
-         //         {
-         //             if ((*matchIterator1).queryIdx ==(*matchIterator2).trainIdx &&(*matchIterator2).queryIdx ==(*matchIterator1).trainIdx)
-         //             {
-         //                 symMatches.push_back(DMatch((*matchIterator1).queryIdx,(*matchIterator1).trainIdx,(*matchIterator1).distance));
-         //                 break;
-         //             }
-         //         }
-         //     }
-         // }
-
-         *m_rep<<" Match resulted in "<<descriptorsA.rows<<" points..."<<std::endl;
-
-         //-- Calculate max and min distances between keypoints
+         std::vector<cv::DMatch> goodMatches;
+         std::vector<ossim_uint32> matchCell;
+         double numCandidates = 0;
+         double matchSeconds = 0;
+         int numDescriptors = 0;
+         int numGood = 0;
+         int numFailed = 0;
          double maxDist = 0;
          double minDist = 500;
-         int maxRows = matches.size();
-         if(maxRows > descriptorsA.rows) maxRows = descriptorsA.rows;
-         for( int i = 0; i < maxRows; i++ )
+         for (ossim_uint32 c=0; c<numCells; ++c)
          {
-            double dist = matches[i].distance;
-            if( dist < minDist ) minDist = dist;
-            if( dist > maxDist ) maxDist = dist;
-         }
+            const CellResult& cell = cellResults[c];
+            if (!cell.ok)
+            {
+               ++numFailed;
+               continue;
+            }
+            numDescriptors += cell.numDescriptors;
+            numGood += cell.numGood;
+            numCandidates += cell.numCandidates;
+            matchSeconds += cell.matchSeconds;
+            if (cell.numDescriptors > 0)
+            {
+               if (cell.minDist < minDist) minDist = cell.minDist;
+               if (cell.maxDist > maxDist) maxDist = cell.maxDist;
+            }
 
-         //-- Check for "good" matches (i.e. whose distance is less than 2*minDist )
-         //-- TODO -> radiusMatch can also be used here?
-         m_distEditFactor = 3; //TODO
-         std::vector<cv::DMatch> goodMatches;
-         for( int i = 0; i < maxRows; i++ )
-         {
-            if( matches[i].distance < m_distEditFactor*minDist )
+            const int baseA = (int)keypointsA.size();
+            const int baseB = (int)keypointsB.size();
+            keypointsA.insert(keypointsA.end(), cell.keypointsA.begin(), cell.keypointsA.end());
+            keypointsB.insert(keypointsB.end(), cell.keypointsB.begin(), cell.keypointsB.end());
+            for (ossim_uint32 i=0; i<cell.matches.size(); ++i)
             {
-               goodMatches.push_back( matches[i]);
+               cv::DMatch m = cell.matches[i];
+               m.queryIdx += baseA;
+               m.trainIdx += baseB;
+               goodMatches.push_back(m);
+               matchCell.push_back(c);
             }
          }
-         *m_rep<<" Distance filter ("<<std::setw(1)<<m_distEditFactor<<"X min) resulted in "<<goodMatches.size()<<" points..."<<std::endl;
+
+         *m_rep<<" Match resulted in "<<numDescriptors<<" points..."<<std::endl;
+         if (m_guided)
+         {
+            *m_rep<<" Guided match (radius "<<m_searchRadius<<", ratio "<<m_matchRatio<<") resulted in "<<numGood<<" points..."<<std::endl;
+            *m_rep<<"  -- Comparisons : "<<std::setprecision(1)<<std::fixed
+                  <<(numDescriptors ? numCandidates/numDescriptors : 0.0)<<" per point"<<std::endl;
+         }
+         else
+         {
+            *m_rep<<" Distance filter ("<<std::setw(1)<<m_distEditFactor<<"X min) resulted in "<<numGood<<" points..."<<std::endl;
+         }
          *m_rep<<"  -- Max dist : "<<maxDist<<std::endl;
          *m_rep<<"  -- Min dist : "<<minDist<<std::endl;
-      
-         if (m_maxMatches<(int)goodMatches.size())
+         *m_rep<<"  -- Match time : "<<std::setprecision(2)<<std::fixed<<1000.0*matchSeconds<<" ms"<<std::endl;
+         if (numCells > 1)
+         {
+            *m_rep<<"  -- Grid     : "<<m_gridSize<<", "<<numThreads<<" thread(s)"<<std::endl;
+            *m_rep<<"  -- Cells    : "<<numCells-numFailed<<" of "<<numCells<<" processed"<<std::endl;
+         }
+         else if (numFailed)
          {
-            nth_element(goodMatches.begin(),goodMatches.begin()+m_maxMatches,goodMatches.end());
-            goodMatches.erase(goodMatches.begin()+m_maxMatches,goodMatches.end());
+            *m_rep<<"  -- Detection or matching failed"<<std::endl;
+         }
+
+         //---
+         // Guided mode: drop the matches inconsistent with one geometric
+         // model over the patch, then apply the cell quota to what is left.
+         //---
+         if (m_guided && !goodMatches.empty())
+         {
+            const int minPoints = (m_geometricModel == "homography") ? 4 : 3;
+            std::vector<uchar> inliers(goodMatches.size(), 1);
+            if ((m_geometricModel != "none") && ((int)goodMatches.size() >= minPoints))
+            {
+               std::vector<cv::Point2f> ptsA;
+               std::vector<cv::Point2f> ptsB;
+               for (ossim_uint32 i=0; i<goodMatches.size(); ++i)
+               {
+                  ptsA.push_back(keypointsA[goodMatches[i].queryIdx].pt);
+                  ptsB.push_back(keypointsB[goodMatches[i].trainIdx].pt);
+               }
+               cv::Mat model;
+               if (m_geometricModel == "homography")
+                  model = cv::findHomography(ptsA, ptsB, cv::RANSAC, m_ransacThreshold, inliers);
+               else
+                  model = cv::estimateAffine2D(ptsA, ptsB, inliers, cv::RANSAC, m_ransacThreshold);
+               if (model.empty())
+                  inliers.assign(goodMatches.size(), 0);
+            }
+
+            std::vector<cv::DMatch> kept;
+            std::vector<ossim_uint32> keptCell;
+            for (ossim_uint32 i=0; i<goodMatches.size(); ++i)
+            {
+               if (inliers[i])
+               {
+                  kept.push_back(goodMatches[i]);
+                  keptCell.push_back(matchCell[i]);
+               }
+            }
+            *m_rep<<" RANSAC ("<<m_geometricModel<<", "<<m_ransacThreshold<<" px) kept "
+                  <<kept.size()<<" of "<<goodMatches.size()<<" points ("
+                  <<std::setprecision(1)<<std::fixed<<100.0*kept.size()/goodMatches.size()
+                  <<"% inliers)..."<<std::endl;
+
+            // Cell quota over the inliers, cells still in order
+            goodMatches.clear();
+            ossim_uint32 first = 0;
+            while (first < kept.size())
+            {
+               ossim_uint32 last = first;
+               while (last < kept.size() && keptCell[last] == keptCell[first])
+                  ++last;
+               std::vector<cv::DMatch> cellMatches(kept.begin()+first, kept.begin()+last);
+               if (m_maxMatches<(int)cellMatches.size())
+               {
+                  nth_element(cellMatches.begin(),cellMatches.begin()+m_maxMatches,cellMatches.end());
+                  cellMatches.erase(cellMatches.begin()+m_maxMatches,cellMatches.end());
+                  std::sort(cellMatches.begin(), cellMatches.end(), DMatchQueryLess());
+               }
+               goodMatches.insert(goodMatches.end(), cellMatches.begin(), cellMatches.end());
+               first = last;
+            }
          }
          
          // Load measurements
@@ -367,6 +562,419 @@ bool ossimTieMeasurementGenerator::run()
 }
 
 
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::processCells()
+//  
+//  Worker loop.  Takes the next unprocessed cell until all are done.
+//*****************************************************************************
+void ossimTieMeasurementGenerator::processCells(std::vector<CellResult>& results,
+                                                std::atomic<ossim_uint32>& cellIdx,
+                                                const bool cloneAlgorithms)
+{
+   cv::Ptr<cv::Feature2D> detector = m_detector;
+   cv::Ptr<cv::DescriptorExtractor> extractor = m_extractor;
+   cv::Ptr<cv::DescriptorMatcher> matcher = m_matcher;
+
+   try
+   {
+      if (cloneAlgorithms)
+      {
+         detector = createFeature2D(m_detectorName);
+         if (m_extractorName == m_detectorName)
+            extractor = detector;
+         else
+            extractor = createFeature2D(m_extractorName);
+         matcher = m_matcher->clone(true);
+      }
+   }
+   catch(...)
+   {
+      detector.release();
+   }
+
+   if (!detector || !extractor || !matcher)
+   {
+      // Leave the cells to the other workers
+      return;
+   }
+
+   ossim_uint32 cell;
+   while ((cell = cellIdx++) < (ossim_uint32)results.size())
+   {
+      try
+      {
+         processCell(cell, detector, extractor, matcher, results[cell]);
+      }
+      catch(...)
+      {
+         results[cell] = CellResult();
+      }
+   }
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::processCell()
+//  
+//  Detect, describe and match one grid cell.
+//*****************************************************************************
+void ossimTieMeasurementGenerator::processCell(const ossim_uint32 cell,
+                                               cv::Ptr<cv::Feature2D>& detector,
+                                               cv::Ptr<cv::DescriptorExtractor>& extractor,
+                                               cv::Ptr<cv::DescriptorMatcher>& matcher,
+                                               CellResult& result) const
+{
+   const cv::Rect& cellA   = m_cellA[cell];
+   const cv::Rect& searchA = m_searchA[cell];
+   const cv::Rect& searchB = m_searchB[cell];
+
+   result = CellResult();
+   if (searchB.area() == 0)
+   {
+      // Cell predicted to fall outside of B
+      result.ok = true;
+      return;
+   }
+
+   // Views into the patches, no copy
+   const cv::Mat imgA = m_imgA(searchA);
+   const cv::Mat imgB = m_imgB(searchB);
+
+   // Detector
+   vector<cv::KeyPoint> keypointsA;
+   vector<cv::KeyPoint> keypointsB;
+   detector->detect(imgA, keypointsA);
+   detector->detect(imgB, keypointsB);
+
+   // Keep the A keypoints inside the cell proper; those in the margin
+   // belong to a neighbour
+   vector<cv::KeyPoint> cellKeypointsA;
+   for (ossim_uint32 i=0; i<keypointsA.size(); ++i)
+   {
+      const cv::Point2f pt(keypointsA[i].pt.x+searchA.x, keypointsA[i].pt.y+searchA.y);
+      if (pt.x >= cellA.x && pt.x < cellA.x+cellA.width &&
+          pt.y >= cellA.y && pt.y < cellA.y+cellA.height)
+      {
+         cellKeypointsA.push_back(keypointsA[i]);
+      }
+   }
+   keypointsA.swap(cellKeypointsA);
+
+   // Extractor
+   cv::Mat descriptorsA;
+   cv::Mat descriptorsB;
+   if (!keypointsA.empty())
+      extractor->compute(imgA, keypointsA, descriptorsA);
+   if (!keypointsB.empty())
+      extractor->compute(imgB, keypointsB, descriptorsB);
+
+   result.ok = true;
+   if (descriptorsA.empty() || descriptorsB.empty())
+   {
+      return;
+   }
+
+   // Execute matcher
+   std::vector<cv::DMatch> matches;
+   const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   if (m_guided)
+   {
+      guidedMatch(keypointsA, cv::Point2f(searchA.x, searchA.y), descriptorsA,
+                  keypointsB, cv::Point2f(searchB.x, searchB.y), descriptorsB,
+                  matches, result.numCandidates);
+   }
+   else
+   {
+      matcher->match(descriptorsA, descriptorsB, matches);
+      result.numCandidates = (double)descriptorsA.rows * descriptorsB.rows;
+   }
+   result.matchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+   result.numDescriptors = descriptorsA.rows;
+
+   //-- Calculate max and min distances between keypoints
+   double maxDist = 0;
+   double minDist = 500;
+   int maxRows = matches.size();
+   if(maxRows > descriptorsA.rows) maxRows = descriptorsA.rows;
+   for( int i = 0; i < maxRows; i++ )
+   {
+      double dist = matches[i].distance;
+      if( dist < minDist ) minDist = dist;
+      if( dist > maxDist ) maxDist = dist;
+   }
+   result.minDist = minDist;
+   result.maxDist = maxDist;
+
+   //-- Check for "good" matches (i.e. whose distance is less than m_distEditFactor*minDist )
+   //-- Guided matches have passed the ratio test and go to RANSAC instead.
+   for( int i = 0; i < maxRows; i++ )
+   {
+      if( m_guided || (matches[i].distance < m_distEditFactor*minDist) )
+      {
+         result.matches.push_back( matches[i]);
+      }
+   }
+   result.numGood = (int)result.matches.size();
+
+   // Cell quota, after RANSAC in guided mode
+   if (!m_guided && (m_maxMatches<(int)result.matches.size()))
+   {
+      nth_element(result.matches.begin(),result.matches.begin()+m_maxMatches,result.matches.end());
+      result.matches.erase(result.matches.begin()+m_maxMatches,result.matches.end());
+   }
+
+   //---
+   // Keep only the matched keypoints, moved to patch coordinates.  Sorting
+   // by query index keeps the merged report in a stable spatial order.
+   //---
+   std::sort(result.matches.begin(), result.matches.end(), DMatchQueryLess());
+   for (ossim_uint32 i=0; i<result.matches.size(); ++i)
+   {
+      cv::KeyPoint kpA = keypointsA[result.matches[i].queryIdx];
+      cv::KeyPoint kpB = keypointsB[result.matches[i].trainIdx];
+      kpA.pt.x += searchA.x;
+      kpA.pt.y += searchA.y;
+      kpB.pt.x += searchB.x;
+      kpB.pt.y += searchB.y;
+      result.keypointsA.push_back(kpA);
+      result.keypointsB.push_back(kpB);
+      result.matches[i].queryIdx = (int)i;
+      result.matches[i].trainIdx = (int)i;
+   }
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::computePrediction()
+//  
+//  Affine map from A to B patch coordinates through the view-image-ground
+//  transforms, exact at three patch corners.  Falls back to the shared
+//  view space mapping if a point cannot be transformed.
+//*****************************************************************************
+void ossimTieMeasurementGenerator::computePrediction()
+{
+   const ossimDpt offsetA = m_patchRefA - m_patchSizeA/2;
+   const ossimDpt offsetB = m_patchRefB - m_patchSizeB/2;
+
+   // Same view space
+   m_predictAB[0] = offsetA.x - offsetB.x; m_predictAB[1] = 1.0; m_predictAB[2] = 0.0;
+   m_predictAB[3] = offsetA.y - offsetB.y; m_predictAB[4] = 0.0; m_predictAB[5] = 1.0;
+
+   if (!m_igxA.valid() || !m_igxB.valid() || m_patchSizeA.x<1 || m_patchSizeA.y<1)
+   {
+      return;
+   }
+
+   const ossimDpt ptsA[3] =
+   {
+      ossimDpt(0.0, 0.0), ossimDpt(m_patchSizeA.x, 0.0), ossimDpt(0.0, m_patchSizeA.y)
+   };
+   ossimDpt ptsB[3];
+   for (int i=0; i<3; ++i)
+   {
+      ossimGpt gpt;
+      ossimDpt vptB;
+      m_igxA->viewToGround(ptsA[i] + offsetA, gpt);
+      if (gpt.hasNans())
+         return;
+      m_igxB->groundToView(gpt, vptB);
+      if (vptB.hasNans())
+         return;
+      ptsB[i] = vptB - offsetB;
+   }
+
+   m_predictAB[0] = ptsB[0].x;
+   m_predictAB[1] = (ptsB[1].x - ptsB[0].x) / m_patchSizeA.x;
+   m_predictAB[2] = (ptsB[2].x - ptsB[0].x) / m_patchSizeA.y;
+   m_predictAB[3] = ptsB[0].y;
+   m_predictAB[4] = (ptsB[1].y - ptsB[0].y) / m_patchSizeA.x;
+   m_predictAB[5] = (ptsB[2].y - ptsB[0].y) / m_patchSizeA.y;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::featureBorder()
+//  
+//  Distance from the image edges within which the detector or the
+//  extractor drops keypoints.
+//*****************************************************************************
+int ossimTieMeasurementGenerator::featureBorder() const
+{
+   int border = DEFAULT_FEATURE_BORDER;
+   if (m_detector)
+      border = algorithmBorder(m_detector);
+   if (m_extractor)
+      border = std::max(border, algorithmBorder(m_extractor));
+   return border;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::predictB()
+//  
+//*****************************************************************************
+cv::Point2f ossimTieMeasurementGenerator::predictB(const cv::Point2f& ptA) const
+{
+   return cv::Point2f((float)(m_predictAB[0] + m_predictAB[1]*ptA.x + m_predictAB[2]*ptA.y),
+                      (float)(m_predictAB[3] + m_predictAB[4]*ptA.x + m_predictAB[5]*ptA.y));
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::guidedMatch()
+//  
+//  Keypoint coordinates are relative to their search regions, whose patch
+//  positions are offsetA and offsetB.  B keypoints are binned on a grid of
+//  search radius sized bins, so each A descriptor is compared with the few
+//  B descriptors near its predicted position only.
+//*****************************************************************************
+void ossimTieMeasurementGenerator::guidedMatch(const std::vector<cv::KeyPoint>& keypointsA,
+                                               const cv::Point2f& offsetA,
+                                               const cv::Mat& descriptorsA,
+                                               const std::vector<cv::KeyPoint>& keypointsB,
+                                               const cv::Point2f& offsetB,
+                                               const cv::Mat& descriptorsB,
+                                               std::vector<cv::DMatch>& matches,
+                                               double& numCandidates) const
+{
+   matches.clear();
+   numCandidates = 0;
+   if (keypointsB.empty())
+      return;
+
+   // Binary descriptors are compared by Hamming distance
+   const int normType = (descriptorsA.depth() == CV_8U) ? cv::NORM_HAMMING : cv::NORM_L2;
+
+   // Bin B
+   const float binSize = (float)std::max(m_searchRadius, 4.0);
+   float maxX = 0.0f;
+   float maxY = 0.0f;
+   for (ossim_uint32 j=0; j<keypointsB.size(); ++j)
+   {
+      maxX = std::max(maxX, keypointsB[j].pt.x);
+      maxY = std::max(maxY, keypointsB[j].pt.y);
+   }
+   const int binCols = (int)(maxX/binSize) + 1;
+   const int binRows = (int)(maxY/binSize) + 1;
+   std::vector< std::vector<int> > bins(binCols*binRows);
+   for (ossim_uint32 j=0; j<keypointsB.size(); ++j)
+   {
+      const int bc = (int)(keypointsB[j].pt.x/binSize);
+      const int br = (int)(keypointsB[j].pt.y/binSize);
+      bins[br*binCols+bc].push_back((int)j);
+   }
+
+   const float radius2 = (float)(m_searchRadius*m_searchRadius);
+   for (int i=0; i<descriptorsA.rows; ++i)
+   {
+      // Predicted position relative to the B search region
+      const cv::Point2f pt = predictB(keypointsA[i].pt + offsetA) - offsetB;
+
+      const int c0 = std::max(0, (int)std::floor((pt.x - m_searchRadius)/binSize));
+      const int c1 = std::min(binCols-1, (int)std::floor((pt.x + m_searchRadius)/binSize));
+      const int r0 = std::max(0, (int)std::floor((pt.y - m_searchRadius)/binSize));
+      const int r1 = std::min(binRows-1, (int)std::floor((pt.y + m_searchRadius)/binSize));
+
+      double best = DBL_MAX;
+      double second = DBL_MAX;
+      int bestIdx = -1;
+      for (int r=r0; r<=r1; ++r)
+      {
+         for (int c=c0; c<=c1; ++c)
+         {
+            const std::vector<int>& bin = bins[r*binCols+c];
+            for (ossim_uint32 k=0; k<bin.size(); ++k)
+            {
+               const cv::Point2f d = keypointsB[bin[k]].pt - pt;
+               if (d.x*d.x + d.y*d.y > radius2)
+                  continue;
+               const double dist = cv::norm(descriptorsA.row(i), descriptorsB.row(bin[k]), normType);
+               numCandidates += 1;
+               if (dist < best)
+               {
+                  second = best;
+                  best = dist;
+                  bestIdx = bin[k];
+               }
+               else if (dist < second)
+               {
+                  second = dist;
+               }
+            }
+         }
+      }
+
+      // Ratio test against the runner-up, if any
+      if ((bestIdx >= 0) && ((second == DBL_MAX) || (best < m_matchRatio*second)))
+      {
+         matches.push_back(cv::DMatch(i, bestIdx, (float)best));
+      }
+   }
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::setSearchRadius()
+//  
+//*****************************************************************************
+bool ossimTieMeasurementGenerator::setSearchRadius(const double radius)
+{
+   if (radius > 0.0)
+   {
+      m_searchRadius = radius;
+      return true;
+   }
+   return false;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::setMatchRatio()
+//  
+//*****************************************************************************
+bool ossimTieMeasurementGenerator::setMatchRatio(const double ratio)
+{
+   if (ratio > 0.0 && ratio <= 1.0)
+   {
+      m_matchRatio = ratio;
+      return true;
+   }
+   return false;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::setGeometricModel()
+//  
+//*****************************************************************************
+bool ossimTieMeasurementGenerator::setGeometricModel(const ossimString& model)
+{
+   ossimString name = model;
+   name.downcase();
+   if (name == "affine" || name == "homography" || name == "none")
+   {
+      m_geometricModel = name;
+      return true;
+   }
+   return false;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::setRansacThreshold()
+//  
+//*****************************************************************************
+bool ossimTieMeasurementGenerator::setRansacThreshold(const double pixels)
+{
+   if (pixels > 0.0)
+   {
+      m_ransacThreshold = pixels;
+      return true;
+   }
+   return false;
+}
+
+
 cv::Ptr<cv::Feature2D> ossimTieMeasurementGenerator::createFeature2D(const ossimString& name)
 {
    cv::Ptr<cv::Feature2D> feature2d;
@@ -573,6 +1181,28 @@ bool ossimTieMeasurementGenerator::setImageList(std::vector<ossimImageSource*> s
 
    m_spIndexA = 0;
    m_spIndexB = 1;
+
+   // New images, new stretches
+   m_patchExtractorA.reset();
+   m_patchExtractorB.reset();
+
+   return true;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::setPatchBand()
+//  
+//*****************************************************************************
+void ossimTieMeasurementGenerator::setPatchBand(const ossim_uint32 band)
+{
+   if (band != m_patchExtractorA.getBand())
+   {
+      m_patchExtractorA.setBand(band);
+      m_patchExtractorB.setBand(band);
+      m_patchExtractorA.reset();
+      m_patchExtractorB.reset();
+   }
 }
 
 bool ossimTieMeasurementGenerator::setROIs(std::vector<ossimIrect> roi)
@@ -593,18 +1223,25 @@ bool ossimTieMeasurementGenerator::setROIs(std::vector<ossimIrect> roi)
    m_patchSizeB.x = roi[m_spIndexB].width();
    m_patchSizeB.y = roi[m_spIndexB].height();
 
-   // Set the IvtGeometryXforms
+   //---
+   // Set the IvtGeometryXforms.  Own copies: the chains' geometries may be
+   // projecting on other threads (other generators, tile requests), and
+   // projections are not thread safe.  The chains must not render while
+   // this runs.
+   //---
+   m_igxA = 0;
+   m_igxB = 0;
    ossimIvtGeomXformVisitor visitorA;
    m_src[m_spIndexA]->accept(visitorA);
    if (visitorA.getTransformList().size() == 1)
    {
-      m_igxA = visitorA.getTransformList()[0].get();
+      m_igxA = visitorA.getTransformList()[0]->clone();
    }
    ossimIvtGeomXformVisitor visitorB;
    m_src[m_spIndexB]->accept(visitorB);
    if (visitorB.getTransformList().size() == 1)
    {
-      m_igxB = visitorB.getTransformList()[0].get();
+      m_igxB = visitorB.getTransformList()[0]->clone();
    }
 
    m_validBox = true;
@@ -643,6 +1280,79 @@ bool ossimTieMeasurementGenerator::setMaxMatches(const int& maxMatches)
 }
 
 
+//*****************************************************************************
+//  METHOD: ossimTieMeasurementGenerator::loadState()
+//  
+//  Lets callers holding only the ossimTieMeasurementGeneratorInterface
+//  (e.g. through the object factory) set the options without a setter each.
+//*****************************************************************************
+bool ossimTieMeasurementGenerator::loadState(const ossimKeywordlist& kwl, const char* prefix)
+{
+   bool loadOK = true;
+   ossimString value;
+
+   value = kwl.find(prefix, "detector");
+   if (!value.empty())
+      loadOK = setFeatureDetector(value) && loadOK;
+
+   value = kwl.find(prefix, "extractor");
+   if (!value.empty())
+      loadOK = setDescriptorExtractor(value) && loadOK;
+
+   value = kwl.find(prefix, "matcher");
+   if (!value.empty())
+      loadOK = setDescriptorMatcher(value) && loadOK;
+
+   value = kwl.find(prefix, "max_matches");
+   if (!value.empty())
+      loadOK = setMaxMatches(value.toInt()) && loadOK;
+
+   value = kwl.find(prefix, "use_grid");
+   if (!value.empty())
+      setUseGrid(value.toBool());
+
+   value = kwl.find(prefix, "grid_size");
+   if (!value.empty())
+   {
+      std::vector<ossimString> dims = value.split(" ", true);
+      if (dims.size() == 2)
+         loadOK = setGridSize(ossimIpt(dims[0].toInt(), dims[1].toInt())) && loadOK;
+      else
+         loadOK = false;
+   }
+
+   value = kwl.find(prefix, "threads");
+   if (!value.empty())
+      setNumThreads(value.toUInt32());
+
+   value = kwl.find(prefix, "patch_band");
+   if (!value.empty())
+      setPatchBand(value.toUInt32());
+
+   value = kwl.find(prefix, "guided");
+   if (!value.empty())
+      setGuidedMatching(value.toBool());
+
+   value = kwl.find(prefix, "search_radius");
+   if (!value.empty())
+      loadOK = setSearchRadius(value.toDouble()) && loadOK;
+
+   value = kwl.find(prefix, "match_ratio");
+   if (!value.empty())
+      loadOK = setMatchRatio(value.toDouble()) && loadOK;
+
+   value = kwl.find(prefix, "geometric_model");
+   if (!value.empty())
+      loadOK = setGeometricModel(value) && loadOK;
+
+   value = kwl.find(prefix, "ransac_threshold");
+   if (!value.empty())
+      loadOK = setRansacThreshold(value.toDouble()) && loadOK;
+
+   return loadOK;
+}
+
+
 //*****************************************************************************
 //  METHOD: ossimTieMeasurementGenerator::pointIndexedAt()
 //  
@@ -13,10 +13,14 @@
 #include <ossim/base/ossimObject.h>
 #include <ossim/base/ossimDpt.h>
 #include <ossim/base/ossimString.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimRefPtr.h>
 #include <ossim/base/ossimTieMeasurementGeneratorInterface.h>
 #include "ossimIvtGeomXform.h"
+#include "ossimTiePatchExtractor.h"
 #include <opencv/cv.h>
 #include <opencv2/features2d/features2d.hpp>
+#include <atomic>
 #include <ctime>
 #include <vector>
 #include <iostream>
@@ -24,6 +28,7 @@
 typedef std::vector<ossimDpt> DptVec_t;
 
 class ossimImageSource;
+class ossimImageData;
 
 
 class OSSIM_DLL ossimTieMeasurementGenerator : 
@@ -58,7 +63,33 @@ public:
    bool setGridSize(const ossimIpt& gridDimensions);
    ossimIpt getGridSize() const {return m_gridSize;}
 
-   // Max matches in patch accessors
+   // Worker thread count accessors (0 = one per hardware thread)
+   void setNumThreads(const ossim_uint32 numThreads) {m_numThreads = numThreads;}
+   ossim_uint32 getNumThreads() const {return m_numThreads;}
+
+   // Each grid cell is searched for in B around its position predicted
+   // through the image geometries, the search radius (pixels) beyond.
+   // Guided matching: each A descriptor is only compared with the B keypoints
+   // within the search radius of its predicted position, and must beat the
+   // runner-up by the ratio.  The ties
+   // are then filtered with RANSAC on the geometric model ("affine",
+   // "homography" or "none") and the cell quota applied to the inliers.
+   void setGuidedMatching(const bool guided) {m_guided = guided;}
+   bool getGuidedMatching() const {return m_guided;}
+   bool setSearchRadius(const double radius);
+   double getSearchRadius() const {return m_searchRadius;}
+   bool setMatchRatio(const double ratio);
+   double getMatchRatio() const {return m_matchRatio;}
+   bool setGeometricModel(const ossimString& model);
+   ossimString getGeometricModel() const {return m_geometricModel;}
+   bool setRansacThreshold(const double pixels);
+   double getRansacThreshold() const {return m_ransacThreshold;}
+
+   // Band of the images used for matching
+   void setPatchBand(const ossim_uint32 band);
+   ossim_uint32 getPatchBand() const {return m_patchExtractorA.getBand();}
+
+   // Max matches per grid cell accessors
    bool setMaxMatches(const int& maxMatches);
    int getMaxMatches() const {return m_maxMatches;}
 
@@ -74,6 +105,12 @@ public:
    bool setDescriptorMatcher(const ossimString& name);
    ossimString getDescriptorMatcher() const {return m_matcherName;}
 
+   // Configuration from keywords: detector, extractor, matcher, max_matches,
+   // use_grid, grid_size ("<cols> <rows>"), threads, patch_band, guided,
+   // search_radius, match_ratio, geometric_model, ransac_threshold.  Call
+   // after init().
+   virtual bool loadState(const ossimKeywordlist& kwl, const char* prefix=0);
+
    // Measured point accessors
    int numMeasurements() const { return m_numMeasurements; }
    ossimDpt pointIndexedAt(const ossim_uint32 imgIdx, const ossim_uint32 measIdx);
@@ -87,9 +124,51 @@ protected:
 
    bool m_initOK;
 
-   // Initialize patch reference positions
+   // Initialize patch reference positions and grid cells
    bool refreshCollectionTraits();
 
+   // Matches of one grid cell, keypoints in patch coordinates
+   struct CellResult
+   {
+      CellResult() : numDescriptors(0), numGood(0), numCandidates(0), minDist(0), maxDist(0),
+                     matchSeconds(0), ok(false) {}
+      std::vector<cv::KeyPoint> keypointsA;
+      std::vector<cv::KeyPoint> keypointsB;
+      std::vector<cv::DMatch> matches;
+      int numDescriptors;
+      int numGood;
+      double numCandidates; // Descriptor comparisons made
+      double minDist;
+      double maxDist;
+      double matchSeconds;
+      bool ok;
+   };
+
+   // Grid cell processing; each worker takes cells off cellIdx until none are left
+   void processCells(std::vector<CellResult>& results,
+                     std::atomic<ossim_uint32>& cellIdx,
+                     const bool cloneAlgorithms);
+   void processCell(const ossim_uint32 cell,
+                    cv::Ptr<cv::Feature2D>& detector,
+                    cv::Ptr<cv::DescriptorExtractor>& extractor,
+                    cv::Ptr<cv::DescriptorMatcher>& matcher,
+                    CellResult& result) const;
+
+   // Edge distance within which keypoints are dropped
+   int featureBorder() const;
+
+   // Guided matching support
+   void computePrediction();
+   cv::Point2f predictB(const cv::Point2f& ptA) const;
+   void guidedMatch(const std::vector<cv::KeyPoint>& keypointsA,
+                    const cv::Point2f& offsetA,
+                    const cv::Mat& descriptorsA,
+                    const std::vector<cv::KeyPoint>& keypointsB,
+                    const cv::Point2f& offsetB,
+                    const cv::Mat& descriptorsB,
+                    std::vector<cv::DMatch>& matches,
+                    double& numCandidates) const;
+
    cv::Ptr<cv::Feature2D> createFeature2D(const ossimString& name);
 
    // Image-related members
@@ -99,6 +178,12 @@ protected:
    cv::Mat m_imgA;
    cv::Mat m_imgB;
 
+   // Patch tiles (m_imgA/m_imgB may point into them) and their 8-bit conversion
+   ossimRefPtr<ossimImageData> m_tileA;
+   ossimRefPtr<ossimImageData> m_tileB;
+   ossimTiePatchExtractor m_patchExtractorA;
+   ossimTiePatchExtractor m_patchExtractorB;
+
    // Measurement count parameters
    int m_numMeasurements;
    int m_maxMatches;
@@ -113,6 +198,24 @@ protected:
    // Grid size for matcher
    bool m_useGrid;
    ossimIpt m_gridSize;
+   ossim_uint32 m_numThreads;
+
+   // Grid cells (patch coordinates): cells of A, the regions of A searched
+   // for their keypoints, widened by the feature border, and the regions of
+   // B around their predicted positions
+   std::vector<cv::Rect> m_cellA;
+   std::vector<cv::Rect> m_searchA;
+   std::vector<cv::Rect> m_searchB;
+
+   // Guided matching parameters
+   bool m_guided;
+   double m_searchRadius;
+   double m_matchRatio;
+   ossimString m_geometricModel;
+   double m_ransacThreshold;
+
+   // Predicted A to B patch coordinates: x' = p[0]+p[1]x+p[2]y, y' = p[3]+p[4]x+p[5]y
+   double m_predictAB[6];
 
    // Patch reference point (center)
    ossimDpt m_patchRefA;
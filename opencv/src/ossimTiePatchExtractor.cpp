@@ -0,0 +1,249 @@
+//----------------------------------------------------------------------------
+//
+// License:  See top level LICENSE.txt file.
+//
+// Description: Conversion of image tiles to the 8-bit single band patches
+//              used by the OpenCV feature detectors.
+//
+//----------------------------------------------------------------------------
+// $Id$
+
+#include "ossimTiePatchExtractor.h"
+#include <ossim/base/ossimNotify.h>
+#include <ossim/base/ossimTrace.h>
+#include <ossim/imaging/ossimImageData.h>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+static ossimTrace traceDebug ("ossimTiePatchExtractor:debug");
+
+// Histogram bins for STRETCH_PERCENTILE
+static const int STRETCH_BINS = 1024;
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::ossimTiePatchExtractor()
+//  
+//  Constructor.
+//*****************************************************************************
+ossimTiePatchExtractor::ossimTiePatchExtractor()
+   :
+   m_band(0),
+   m_stretchMode(STRETCH_PERCENTILE),
+   m_clipFraction(0.01),
+   m_hasStretch(false),
+   m_stretchMin(0.0),
+   m_stretchMax(0.0)
+{
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::setClipFraction()
+//  
+//*****************************************************************************
+void ossimTiePatchExtractor::setClipFraction(const double fraction)
+{
+   if (fraction >= 0.0 && fraction < 0.5)
+   {
+      m_clipFraction = fraction;
+   }
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::reset()
+//  
+//*****************************************************************************
+void ossimTiePatchExtractor::reset()
+{
+   m_hasStretch = false;
+   m_stretchMin = 0.0;
+   m_stretchMax = 0.0;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::extract()
+//  
+//*****************************************************************************
+bool ossimTiePatchExtractor::extract(const ossimImageData* tile, cv::Mat& patch)
+{
+   patch.release();
+
+   if (!tile || (m_band >= tile->getNumberOfBands()) || !tile->getBuf(m_band))
+   {
+      return false;
+   }
+
+   const int rows = (int)tile->getHeight();
+   const int cols = (int)tile->getWidth();
+   if (rows<1 || cols<1)
+   {
+      return false;
+   }
+
+   // Band sequential buffer, so a band is a contiguous plane
+   void* buf = const_cast<void*>(tile->getBuf(m_band));
+   const ossimScalarType scalarType = tile->getScalarType();
+
+   if (scalarType == OSSIM_UINT8)
+   {
+      // Layout already matches: header only, no copy
+      patch = cv::Mat(rows, cols, CV_8UC1, buf);
+      return true;
+   }
+
+   cv::Mat band;
+   const int depth = getCvDepth(scalarType);
+   if (depth >= 0)
+   {
+      band = cv::Mat(rows, cols, CV_MAKETYPE(depth, 1), buf);
+   }
+   else if (scalarType == OSSIM_UINT32)
+   {
+      band.create(rows, cols, CV_64FC1);
+      const ossim_uint32* s = static_cast<const ossim_uint32*>(buf);
+      double* d = band.ptr<double>();
+      const int n = rows*cols;
+      for (int i=0; i<n; ++i)
+         d[i] = s[i];
+   }
+   else
+   {
+      return false;
+   }
+
+   if (!m_hasStretch)
+   {
+      m_hasStretch = computeStretch(band, tile->getNullPix(m_band));
+      if (!m_hasStretch)
+      {
+         // Nothing valid yet: leave the stretch to the next patch
+         patch = cv::Mat::zeros(rows, cols, CV_8UC1);
+         return true;
+      }
+      if (traceDebug())
+      {
+         ossimNotify(ossimNotifyLevel_DEBUG)
+            << "DEBUG: ...ossimTiePatchExtractor::extract stretch = ["
+            << m_stretchMin << ", " << m_stretchMax << "]" << std::endl;
+      }
+   }
+
+   // Linear stretch with saturation, vectorised by OpenCV
+   double alpha = 0.0;
+   double beta  = 0.0;
+   if (m_stretchMax > m_stretchMin)
+   {
+      alpha = 255.0 / (m_stretchMax - m_stretchMin);
+      beta  = -m_stretchMin * alpha;
+   }
+   band.convertTo(patch, CV_8U, alpha, beta);
+
+   return true;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::computeStretch()
+//  
+//  Range of the non-null pixels, clipped in STRETCH_PERCENTILE mode.
+//*****************************************************************************
+bool ossimTiePatchExtractor::computeStretch(const cv::Mat& band, const double nullPix)
+{
+   cv::Mat values;
+   band.convertTo(values, CV_32F);
+   cv::Mat mask = (values != (float)nullPix);
+
+   const int count = cv::countNonZero(mask);
+   if (count == 0)
+   {
+      return false;
+   }
+
+   double minValue = 0.0;
+   double maxValue = 0.0;
+   cv::minMaxLoc(values, &minValue, &maxValue, 0, 0, mask);
+
+   if ((m_stretchMode == STRETCH_PERCENTILE) && (m_clipFraction > 0.0) && (maxValue > minValue))
+   {
+      const double binWidth = (maxValue - minValue) / (STRETCH_BINS - 1);
+      const float range[] = { (float)minValue, (float)(minValue + STRETCH_BINS*binWidth) };
+      const float* ranges[] = { range };
+      const int channels[] = { 0 };
+      const int bins = STRETCH_BINS;
+      cv::Mat hist;
+      cv::calcHist(&values, 1, channels, mask, hist, 1, &bins, ranges);
+
+      const double clip = m_clipFraction * count;
+      int lo = 0;
+      double sum = 0.0;
+      for ( ; lo < STRETCH_BINS-1; ++lo)
+      {
+         sum += hist.at<float>(lo);
+         if (sum > clip) break;
+      }
+      int hi = STRETCH_BINS-1;
+      sum = 0.0;
+      for ( ; hi > lo; --hi)
+      {
+         sum += hist.at<float>(hi);
+         if (sum > clip) break;
+      }
+
+      const double clipMin = minValue + lo*binWidth;
+      const double clipMax = minValue + (hi+1)*binWidth;
+      if (clipMax < maxValue) maxValue = clipMax;
+      minValue = clipMin;
+   }
+
+   m_stretchMin = minValue;
+   m_stretchMax = maxValue;
+   return true;
+}
+
+
+//*****************************************************************************
+//  METHOD: ossimTiePatchExtractor::getCvDepth()
+//  
+//*****************************************************************************
+int ossimTiePatchExtractor::getCvDepth(const ossimScalarType scalarType)
+{
+   int depth = -1;
+   switch (scalarType)
+   {
+      case OSSIM_UINT8:
+         depth = CV_8U;
+         break;
+      case OSSIM_SINT8:
+         depth = CV_8S;
+         break;
+      case OSSIM_UINT11:
+      case OSSIM_UINT12:
+      case OSSIM_UINT13:
+      case OSSIM_UINT14:
+      case OSSIM_UINT15:
+      case OSSIM_UINT16:
+         depth = CV_16U;
+         break;
+      case OSSIM_SINT16:
+         depth = CV_16S;
+         break;
+      case OSSIM_SINT32:
+         depth = CV_32S;
+         break;
+      case OSSIM_FLOAT32:
+      case OSSIM_NORMALIZED_FLOAT:
+         depth = CV_32F;
+         break;
+      case OSSIM_FLOAT64:
+      case OSSIM_NORMALIZED_DOUBLE:
+         depth = CV_64F;
+         break;
+      default:
+         break;
+   }
+   return depth;
+}
@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------
+//
+// License:  See top level LICENSE.txt file.
+//
+// Description: Conversion of image tiles to the 8-bit single band patches
+//              used by the OpenCV feature detectors.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimTiePatchExtractor_HEADER
+#define ossimTiePatchExtractor_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <opencv/cv.h>
+
+class ossimImageData;
+
+//---
+// One extractor is used per image.  An 8-bit band is wrapped as is, without
+// a copy, so the patch is only valid as long as the tile buffer is.  Other
+// types are stretched to 8 bits with a linear stretch computed from the
+// first patch of the image and kept for the following ones, so that patches
+// of the same image stay radiometrically consistent.
+//---
+class OSSIM_DLL ossimTiePatchExtractor
+{
+public:
+
+   enum StretchMode
+   {
+      STRETCH_MINMAX     = 0, // Full range of the valid pixels
+      STRETCH_PERCENTILE = 1  // Range clipped by the clip fraction at each end
+   };
+
+   ossimTiePatchExtractor();
+
+   // Band of the tile used for the patch, 0 by default
+   void setBand(const ossim_uint32 band) {m_band = band;}
+   ossim_uint32 getBand() const {return m_band;}
+
+   void setStretchMode(const StretchMode mode) {m_stretchMode = mode;}
+   StretchMode getStretchMode() const {return m_stretchMode;}
+
+   // Fraction of the valid pixels clipped at each end in STRETCH_PERCENTILE mode
+   void setClipFraction(const double fraction);
+   double getClipFraction() const {return m_clipFraction;}
+
+   // Forget the stretch, e.g. when the image changes
+   void reset();
+
+   bool hasStretch() const {return m_hasStretch;}
+   double getStretchMin() const {return m_stretchMin;}
+   double getStretchMax() const {return m_stretchMax;}
+
+   // Sets patch to the selected band of tile as CV_8UC1.  Returns false
+   // if the tile has no data or no such band.
+   bool extract(const ossimImageData* tile, cv::Mat& patch);
+
+   // OpenCV depth holding the scalar type without loss, -1 if there is none
+   static int getCvDepth(const ossimScalarType scalarType);
+
+protected:
+
+   bool computeStretch(const cv::Mat& band, const double nullPix);
+
+   ossim_uint32 m_band;
+   StretchMode m_stretchMode;
+   double m_clipFraction;
+   bool m_hasStretch;
+   double m_stretchMin;
+   double m_stretchMax;
+};
+#endif // #ifndef ossimTiePatchExtractor_HEADER
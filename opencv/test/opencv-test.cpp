@@ -0,0 +1,125 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+#include "../src/ossimTiePatchExtractor.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <opencv2/core/core.hpp>
+#include <cstring>
+#include <iostream>
+
+using namespace std;
+using ossimPluginTest::check;
+
+// Tile with band b holding (b+1)*(offset + x + y*width) and a null border pixel
+template <class T>
+ossimRefPtr<ossimImageData> makeTile(ossimScalarType type, ossim_uint32 bands, double offset)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, type, bands, 64, 64);
+   tile->initialize();
+   for (ossim_uint32 b=0; b<bands; ++b)
+   {
+      T* buf = static_cast<T*>(tile->getBuf(b));
+      for (ossim_uint32 i=0; i<64*64; ++i)
+         buf[i] = (T)((b+1)*(offset + i));
+      buf[0] = (T)tile->getNullPix(b);
+   }
+   tile->validate();
+   return tile;
+}
+
+void test8Bit(ossim_uint32 bands)
+{
+   cout << "8-bit, " << bands << " band(s)" << endl;
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_UINT8, bands, 64, 64);
+   tile->initialize();
+   for (ossim_uint32 b=0; b<bands; ++b)
+      memset(tile->getBuf(b), (int)(10*(b+1)), 64*64);
+
+   for (ossim_uint32 b=0; b<bands; ++b)
+   {
+      ossimTiePatchExtractor extractor;
+      extractor.setBand(b);
+      cv::Mat patch;
+      check(extractor.extract(tile.get(), patch), "extract");
+      check(patch.type() == CV_8UC1 && patch.rows == 64 && patch.cols == 64, "CV_8UC1 64x64");
+      check(patch.data == (uchar*)tile->getBuf(b), "band wrapped without copy");
+      check(patch.at<uchar>(10, 10) == 10*(b+1), "band value");
+      check(!extractor.hasStretch(), "no stretch");
+   }
+}
+
+void test16Bit(ossim_uint32 bands)
+{
+   cout << "16-bit, " << bands << " band(s)" << endl;
+   ossimRefPtr<ossimImageData> tile = makeTile<ossim_uint16>(OSSIM_UINT16, bands, 100.0);
+
+   for (ossim_uint32 b=0; b<bands; ++b)
+   {
+      ossimTiePatchExtractor extractor;
+      extractor.setBand(b);
+      extractor.setStretchMode(ossimTiePatchExtractor::STRETCH_MINMAX);
+      cv::Mat patch;
+      check(extractor.extract(tile.get(), patch), "extract");
+      check(patch.type() == CV_8UC1 && patch.rows == 64 && patch.cols == 64, "CV_8UC1 64x64");
+
+      // Null pixel excluded from the range
+      const double lo = (b+1)*101.0;
+      const double hi = (b+1)*(100.0 + 64*64 - 1);
+      check(extractor.getStretchMin() == lo && extractor.getStretchMax() == hi, "min/max range");
+      check(patch.at<uchar>(0, 1) == 0 && patch.at<uchar>(63, 63) == 255, "full 8-bit range");
+
+      bool monotonic = true;
+      const uchar* p = patch.ptr<uchar>();
+      for (int i=2; i<64*64; ++i)
+         if (p[i] < p[i-1]) monotonic = false;
+      check(monotonic, "monotonic");
+
+      // Same stretch on a later patch of the same image
+      ossimRefPtr<ossimImageData> dark = makeTile<ossim_uint16>(OSSIM_UINT16, bands, 0.0);
+      check(extractor.extract(dark.get(), patch), "extract second patch");
+      check(extractor.getStretchMin() == lo && patch.at<uchar>(0, 1) == 0, "stretch kept");
+   }
+
+   // Percentile stretch clips the tails
+   ossimTiePatchExtractor extractor;
+   extractor.setClipFraction(0.05);
+   cv::Mat patch;
+   extractor.extract(tile.get(), patch);
+   check(extractor.getStretchMin() > 101.0 + 0.04*64*64 &&
+         extractor.getStretchMax() < 100.0 + 0.96*64*64, "percentile clip");
+
+   // Band out of range
+   extractor.setBand(bands);
+   check(!extractor.extract(tile.get(), patch) && patch.empty(), "bad band rejected");
+}
+
+void testFloat()
+{
+   cout << "32-bit float, 1 band" << endl;
+   ossimRefPtr<ossimImageData> tile = makeTile<ossim_float32>(OSSIM_FLOAT32, 1, -0.5);
+   ossimTiePatchExtractor extractor;
+   extractor.setStretchMode(ossimTiePatchExtractor::STRETCH_MINMAX);
+   cv::Mat patch;
+   check(extractor.extract(tile.get(), patch), "extract");
+   check(patch.at<uchar>(0, 1) == 0 && patch.at<uchar>(63, 63) == 255, "full 8-bit range");
+}
+
+int main(int argc, char *argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   test8Bit(1);
+   test8Bit(3);
+   test16Bit(1);
+   test16Bit(3);
+   testFloat();
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,172 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+//
+// Tie collection throughput of ossimTieMeasurementGenerator for 1, 2, 4... threads up to the
+// hardware thread count.  Image B is image A shifted by a known offset, both rendered to the
+// geographic view of A, so the ties are also checked against the offset.
+//
+// Usage: tie-generator-bench [patch size] [grid size] [runs]
+
+#include "../src/ossimTieMeasurementGenerator.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimIrect.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimImageRenderer.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <ossim/projection/ossimImageViewProjectionTransform.h>
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static const int OFFSET_X = 37;
+static const int OFFSET_Y = 21;
+static const double DEGREES_PER_PIXEL = 1.0e-4;
+
+// Random rectangles and disks, lightly blurred: corners and blobs everywhere.
+static cv::Mat makeScene(int width, int height)
+{
+   cv::Mat scene(height, width, CV_8UC1, cv::Scalar(128));
+   cv::RNG rng(41);
+   const int shapes = width*height/400;
+   for (int i=0; i<shapes; ++i)
+   {
+      const cv::Point center(rng.uniform(0, width), rng.uniform(0, height));
+      const int size = rng.uniform(3, 20);
+      const cv::Scalar gray(rng.uniform(0, 256));
+      if (i % 2)
+         cv::rectangle(scene, center, center + cv::Point(size, size), gray, cv::FILLED);
+      else
+         cv::circle(scene, center, size/2, gray, cv::FILLED);
+   }
+   cv::GaussianBlur(scene, scene, cv::Size(3, 3), 0.8);
+   return scene;
+}
+
+// 8-bit image source for the pixels of img, upper left pixel at lat, lon, rendered to view.
+static ossimRefPtr<ossimImageRenderer> makeChain(const cv::Mat& img, double lat, double lon,
+                                                 ossimRefPtr<ossimImageGeometry>& view)
+{
+   ossimRefPtr<ossimImageData> tile = new ossimImageData(0, OSSIM_UINT8, 1, img.cols, img.rows);
+   tile->initialize();
+   ossim_uint8* buf = static_cast<ossim_uint8*>(tile->getBuf(0));
+   for (int r=0; r<img.rows; ++r)
+      memcpy(buf + r*img.cols, img.ptr<uchar>(r), img.cols);
+   tile->validate();
+
+   ossimRefPtr<ossimEquDistCylProjection> proj = new ossimEquDistCylProjection;
+   proj->setOrigin(ossimGpt(0.0, 0.0, 0.0));
+   proj->setUlGpt(ossimGpt(lat, lon));
+   proj->setDecimalDegreesPerPixel(ossimDpt(DEGREES_PER_PIXEL, DEGREES_PER_PIXEL));
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry(0, proj.get());
+   if (!view.valid())
+      view = geom;
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource;
+   source->setImage(tile);
+   source->setImageGeometry(geom.get());
+
+   ossimRefPtr<ossimImageRenderer> renderer = new ossimImageRenderer;
+   renderer->connectMyInputTo(source.get());
+   renderer->setImageViewTransform(new ossimImageViewProjectionTransform(geom.get(), view.get()));
+   renderer->initialize();
+   return renderer;
+}
+
+int main(int argc, char *argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   const int patchSize = (argc > 1) ? atoi(argv[1]) : 2048;
+   const int gridSize  = (argc > 2) ? atoi(argv[2]) : 8;
+   const int runs      = (argc > 3) ? atoi(argv[3]) : 3;
+
+   // A is the scene, B the scene moved OFFSET_X, OFFSET_Y pixels up and left.
+   const int sceneSize = patchSize + 2*(OFFSET_X + OFFSET_Y);
+   const cv::Mat scene = makeScene(sceneSize + OFFSET_X, sceneSize + OFFSET_Y);
+   const cv::Mat imgA = scene(cv::Rect(0, 0, sceneSize, sceneSize));
+   const cv::Mat imgB = scene(cv::Rect(OFFSET_X, OFFSET_Y, sceneSize, sceneSize));
+
+   ossimRefPtr<ossimImageGeometry> view;
+   ossimRefPtr<ossimImageRenderer> chainA = makeChain(imgA, 45.0, 5.0, view);
+   ossimRefPtr<ossimImageRenderer> chainB =
+      makeChain(imgB, 45.0 - OFFSET_Y*DEGREES_PER_PIXEL, 5.0 + OFFSET_X*DEGREES_PER_PIXEL, view);
+
+   // Same patch of the view from both images
+   const int margin = (sceneSize - patchSize)/2;
+   const ossimIrect patch(margin, margin, margin + patchSize - 1, margin + patchSize - 1);
+
+   unsigned int maxThreads = std::thread::hardware_concurrency();
+   if (maxThreads == 0)
+      maxThreads = 1;
+
+   cout << "Patch " << patchSize << "x" << patchSize << ", grid " << gridSize << "x" << gridSize
+        << ", " << runs << " run(s) per thread count" << endl;
+   cout << "threads     ties  seconds   ties/sec  speedup  within 1 px" << endl;
+
+   double baseRate = 0.0;
+   for (unsigned int threads=1; ; threads*=2)
+   {
+      if (threads > maxThreads)
+         threads = maxThreads;
+
+      ostringstream report;
+      ossimTieMeasurementGenerator generator;
+      generator.init(report);
+      vector<ossimImageSource*> src;
+      src.push_back(chainA.get());
+      src.push_back(chainB.get());
+      generator.setImageList(src);
+      vector<ossimIrect> roi(2, patch);
+      generator.setROIs(roi);
+      generator.setUseGrid(true);
+      generator.setGridSize(ossimIpt(gridSize, gridSize));
+      generator.setNumThreads(threads);
+
+      const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+      for (int run=0; run<runs; ++run)
+         generator.run();
+      const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+      // Image B coordinates are image A coordinates less the offset
+      const int ties = generator.numMeasurements();
+      int accurate = 0;
+      for (int i=0; i<ties; ++i)
+      {
+         const ossimDpt a = generator.pointIndexedAt(0, i);
+         const ossimDpt b = generator.pointIndexedAt(1, i);
+         if (fabs(a.x - OFFSET_X - b.x) <= 1.0 && fabs(a.y - OFFSET_Y - b.y) <= 1.0)
+            ++accurate;
+      }
+
+      const double rate = ties/seconds;
+      if (threads == 1)
+         baseRate = rate;
+      cout << setw(7) << threads << " " << setw(8) << ties << " " << fixed << setprecision(3)
+           << setw(8) << seconds << " " << setprecision(0) << setw(10) << rate << " "
+           << setprecision(2) << setw(8) << (baseRate > 0.0 ? rate/baseRate : 0.0) << " "
+           << setprecision(1) << setw(11) << (ties ? 100.0*accurate/ties : 0.0) << "%" << endl;
+
+      if (threads == maxThreads)
+         break;
+   }
+
+   return 0;
+}
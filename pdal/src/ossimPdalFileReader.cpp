@@ -13,11 +13,15 @@
 #include <ossim/base/ossimGpt.h>
 #include <ossim/base/ossimUnitConversionTool.h>
 #include <ossim/point_cloud/ossimPointRecord.h>
+#include <ossim/base/ossimPreferences.h>
 #include <pdal/pdal.hpp>
 #include <pdal/PointViewIter.hpp>
+#include <pdal/PointTable.hpp>
 #include <pdal/StatsFilter.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/FauxReader.hpp>
+#include <condition_variable>
+#include <thread>
 
 
 RTTI_DEF1(ossimPdalFileReader, "ossimPdalFileReader" , ossimPdalReader)
@@ -25,13 +29,198 @@ RTTI_DEF1(ossimPdalFileReader, "ossimPdalFileReader" , ossimPdalReader)
 using namespace pdal;
 using namespace pdal::Dimension;
 
+static const char STREAM_CHUNK_SIZE_KW[] = "pdal_reader_stream_chunk_size";
+static const ossim_uint32 DEFAULT_STREAM_CHUNK_SIZE = 1000000;
+
+namespace
+{
+   // Thrown from the reader thread to unwind PDAL when the stream is closed early.
+   struct StreamStopped {};
+}
+
+/**
+ * Point table the reader thread streams a file through, one chunk at a time. PDAL calls reset()
+ * each time the table is full and after the last points; that hands the chunk to getFileBlock()
+ * and blocks the reader thread until a later chunk is wanted. The stream makes its reader with a
+ * factory of its own, so replacing the stream to go back frees the old reader and its file.
+ */
+class ossimPdalFileReader::Stream : public FixedPointTable
+{
+public:
+   /** Creates a reader for the driver and options, prepares it and starts the thread. */
+   Stream(const std::string& driver, const Options& options, ossim_uint32 chunkSize)
+   :  FixedPointTable(chunkSize),
+      m_reader(m_factory.createStage(driver)),
+      m_numFilled(0),
+      m_nextStart(0),
+      m_chunkStart(0),
+      m_chunkSize(0),
+      m_ready(false),
+      m_done(false),
+      m_stop(false)
+   {
+      if (!m_reader)
+         throw pdal_error("No reader created by PDAL");
+      m_reader->setOptions(options);
+      m_reader->prepare(*this);
+      m_thread = std::thread(&Stream::run, this);
+   }
+
+   ~Stream()
+   {
+      {
+         std::lock_guard<std::mutex> lock(m_mutex);
+         m_stop = true;
+      }
+      m_cond.notify_all();
+      m_thread.join();
+   }
+
+   /**
+    * Waits for the chunk holding the point index, releasing earlier chunks to the reader. The
+    * index must not be before the current chunk. Returns FALSE past the last point.
+    */
+   bool seek(ossim_uint64 index)
+   {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      while (true)
+      {
+         m_cond.wait(lock, [this]{ return m_ready || m_done; });
+         if (!m_ready)
+            return false;
+         if (index < m_chunkStart + m_chunkSize)
+            return true;
+         m_ready = false;
+         m_cond.notify_all();
+      }
+   }
+
+   /** Returns TRUE once the last chunk has been released. */
+   bool isExhausted()
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      return m_done && !m_ready;
+   }
+
+   /** The current chunk. Valid after seek() returns TRUE. */
+   ossim_uint64 getChunkStart() const { return m_chunkStart; }
+   ossim_uint32 getChunkSize() const { return m_chunkSize; }
+
+   /** Reason the reader stopped early, empty if it didn't. Valid after seek() returns FALSE. */
+   const std::string& getError() const { return m_error; }
+
+   /** Start of a point's data in the current chunk. Valid after seek() returns TRUE. */
+   const char* getPointData(PointId idx) { return FixedPointTable::getPoint(idx); }
+
+   /** Set by prepare(), so safe to read while the thread runs. */
+   const SpatialReference& getSpatialReference() const { return m_reader->getSpatialReference(); }
+
+   virtual void reset()
+   {
+      if (m_numFilled)
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         m_chunkStart = m_nextStart;
+         m_chunkSize = (ossim_uint32) m_numFilled;
+         m_nextStart += m_numFilled;
+         m_ready = true;
+         m_cond.notify_all();
+         m_cond.wait(lock, [this]{ return !m_ready || m_stop; });
+         if (m_stop)
+            throw StreamStopped();
+      }
+      m_numFilled = 0;
+      FixedPointTable::reset();
+   }
+
+protected:
+   // Points are filled in order, so the highest one touched gives the chunk's size. Reads of the
+   // chunk handed over can't raise it past that, and it is zeroed before the next fill.
+   virtual char* getPoint(PointId idx)
+   {
+      if (idx >= m_numFilled)
+         m_numFilled = idx + 1;
+      return FixedPointTable::getPoint(idx);
+   }
+
+private:
+   void run()
+   {
+      try
+      {
+         m_reader->execute(*this);
+
+         // In case the last points weren't followed by a reset:
+         reset();
+      }
+      catch (const StreamStopped&)
+      {
+      }
+      catch (const std::exception& e)
+      {
+         m_error = e.what();
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_done = true;
+      m_cond.notify_all();
+   }
+
+   // The factory owns the reader, and goes after the thread is joined:
+   StageFactory m_factory;
+   pdal::Stage* m_reader;
+   std::thread m_thread;
+   std::mutex m_mutex;
+   std::condition_variable m_cond;
+   PointId m_numFilled;
+   ossim_uint64 m_nextStart;
+   ossim_uint64 m_chunkStart;
+   ossim_uint32 m_chunkSize;
+   bool m_ready;
+   bool m_done;
+   bool m_stop;
+   std::string m_error;
+};
+
 ossimPdalFileReader::ossimPdalFileReader()
+:  m_streamChunkSize(DEFAULT_STREAM_CHUNK_SIZE),
+   m_stream(0),
+   m_numStreamPoints(0),
+   m_numLatched(0)
 {
+   const char* lookup = ossimPreferences::instance()->findPreference(STREAM_CHUNK_SIZE_KW);
+   if (lookup)
+      m_streamChunkSize = ossimString::toUInt32(lookup);
 }
 
 /** virtual destructor */
 ossimPdalFileReader::~ossimPdalFileReader()
 {
+   // The stream's thread runs the reader, so stop it first:
+   delete m_stream;
+}
+
+void ossimPdalFileReader::close()
+{
+   std::lock_guard<std::mutex> lock(m_streamMutex);
+   delete m_stream;
+   m_stream = 0;
+   m_numStreamPoints = 0;
+   ossimPdalReader::close();
+}
+
+void ossimPdalFileReader::setStreamChunkSize(ossim_uint32 numPoints)
+{
+   m_streamChunkSize = numPoints;
+}
+
+ossim_uint32 ossimPdalFileReader::getStreamChunkSize() const
+{
+   return m_streamChunkSize;
+}
+
+bool ossimPdalFileReader::isStreaming() const
+{
+   return m_stream != 0;
 }
 
 bool ossimPdalFileReader::open(const ossimFilename& fname)
@@ -54,17 +243,30 @@ bool ossimPdalFileReader::open(const ossimFilename& fname)
       }
       else
       {
-         StageFactory factory;
-         const string driver = factory.inferReaderDriver(m_inputFilename.string());
+         const string driver = m_stageFactory.inferReaderDriver(m_inputFilename.string());
          if (driver == "")
             throw pdal_error("File type not supported by PDAL");
-         reader = factory.createStage(driver);
+         reader = m_stageFactory.createStage(driver);
          if (!reader)
             throw pdal_error("No reader created by PDAL");
 
          m_pdalOptions.add("filename", m_inputFilename.string());
          reader->setOptions(m_pdalOptions);
 
+         // Large files are streamed if the reader can say how large from the header. The stream
+         // reads with a reader of its own; this one only previewed, so if the file can't be
+         // streamed it still reads the whole file:
+         if (m_streamChunkSize)
+         {
+            const QuickInfo info = reader->preview();
+            if (info.valid() && (info.m_pointCount > m_streamChunkSize))
+            {
+               m_driver = driver;
+               if (openStream(info))
+                  return true;
+            }
+         }
+
          // Stick a stats filter in the pipeline:
          m_pdalPipe = new StatsFilter();
          m_pdalPipe->setInput(*reader);
@@ -101,6 +303,9 @@ bool ossimPdalFileReader::open(const ossimFilename& fname)
 
 ossim_uint32 ossimPdalFileReader::getNumPoints() const
 {
+   if (m_stream)
+      return m_numStreamPoints;
+
    if (!m_currentPV)
       return 0;
 
@@ -112,6 +317,12 @@ void ossimPdalFileReader::getFileBlock(ossim_uint32 offset,
                                        ossimPointBlock& block,
                                        ossim_uint32 requested) const
 {
+   if (m_stream)
+   {
+      getStreamBlock(offset, block, requested);
+      return;
+   }
+
    // A single input file means a single point view coming out of the manager:
    if (!m_currentPV)
    {
@@ -130,9 +341,219 @@ void ossimPdalFileReader::getFileBlock(ossim_uint32 offset,
    }
 
    m_currentPID = offset;
+   m_currentPvOffset = offset;
    parsePointView(block, requested);
 }
 
+bool ossimPdalFileReader::openStream(const QuickInfo& info)
+{
+   if (!startStream())
+      return false;
+
+   m_numStreamPoints = (info.m_pointCount < 0xFFFFFFFF) ? (ossim_uint32) info.m_pointCount :
+      0xFFFFFFFF;
+   const PointLayoutPtr layout = m_stream->layout();
+   m_currentPV = 0;
+   m_availableFields = 0;
+   if (layout->hasDim(Id::Enum::Intensity))
+      m_availableFields |= ossimPointRecord::Intensity;
+   if (layout->hasDim(Id::Enum::ReturnNumber))
+      m_availableFields |= ossimPointRecord::ReturnNumber;
+   if (layout->hasDim(Id::Enum::NumberOfReturns))
+      m_availableFields |= ossimPointRecord::NumberOfReturns;
+   if (layout->hasDim(Id::Enum::Red))
+      m_availableFields |= ossimPointRecord::Red;
+   if (layout->hasDim(Id::Enum::Green))
+      m_availableFields |= ossimPointRecord::Green;
+   if (layout->hasDim(Id::Enum::Blue))
+      m_availableFields |= ossimPointRecord::Blue;
+   if (layout->hasDim(Id::Enum::GpsTime))
+      m_availableFields |= ossimPointRecord::GpsTime;
+   if (layout->hasDim(Id::Enum::Infrared))
+      m_availableFields |= ossimPointRecord::Infrared;
+
+   const SpatialReference& srs = m_stream->getSpatialReference();
+   m_geometry = new ossimPointCloudGeometry(srs.getWKT(SpatialReference::eCompoundOK, false));
+
+   // Position bounds from the header, other fields from the first chunk for now:
+   m_minRecord = new ossimPointRecord(getFieldCode());
+   m_maxRecord = new ossimPointRecord(getFieldCode());
+   ossimGpt gpt;
+   m_geometry->convertPos(ossimDpt3d(info.m_bounds.minx, info.m_bounds.miny, info.m_bounds.minz),
+                          gpt);
+   m_minRecord->setPosition(gpt);
+   m_geometry->convertPos(ossimDpt3d(info.m_bounds.maxx, info.m_bounds.maxy, info.m_bounds.maxz),
+                          gpt);
+   m_maxRecord->setPosition(gpt);
+   m_numLatched = 0;
+   latchStreamMinMax();
+
+   return true;
+}
+
+bool ossimPdalFileReader::startStream() const
+{
+   // The old stream's reader goes with it:
+   delete m_stream;
+   m_stream = 0;
+   try
+   {
+      m_stream = new Stream(m_driver, m_pdalOptions, m_streamChunkSize);
+   }
+   catch (std::exception& e)
+   {
+      ossimNotify(ossimNotifyLevel_WARN) << "ossimPdalFileReader::startStream -- " << e.what()
+            << endl;
+      return false;
+   }
+
+   // The first chunk tells if the reader can stream at all:
+   if (!m_stream->seek(0))
+   {
+      if (!m_stream->getError().empty())
+      {
+         ossimNotify(ossimNotifyLevel_WARN) << "ossimPdalFileReader::startStream -- "
+               << m_stream->getError() << endl;
+      }
+      delete m_stream;
+      m_stream = 0;
+      return false;
+   }
+   return true;
+}
+
+bool ossimPdalFileReader::seekStream(ossim_uint32 offset) const
+{
+   if (!m_stream || (offset >= m_numStreamPoints))
+      return false;
+
+   // Going back means reading the file again:
+   if (((offset < m_stream->getChunkStart()) || m_stream->isExhausted()) && !startStream())
+      return false;
+
+   if (!m_stream->seek(offset))
+      return false;
+
+   latchStreamMinMax();
+   return true;
+}
+
+ossim_uint32 ossimPdalFileReader::parseStream(ossim_uint32 offset,
+                                              ossim_uint32 maxNumPoints,
+                                              ossim_uint32 fieldCode,
+                                              bool classification,
+                                              ossimPdalPointColumns& columns) const
+{
+   const ossim_uint64 chunkStart = m_stream->getChunkStart();
+   ossim_uint32 numPoints = (ossim_uint32) (chunkStart + m_stream->getChunkSize() - offset);
+   if (numPoints > maxNumPoints)
+      numPoints = maxNumPoints;
+   std::vector<const char*> points (numPoints);
+   for (ossim_uint32 i=0; i<numPoints; ++i)
+      points[i] = m_stream->getPointData(offset - chunkStart + i);
+   parsePoints(*m_stream->layout(), points, fieldCode, classification, columns);
+   columns.setFirstPointId(offset);
+   return numPoints;
+}
+
+void ossimPdalFileReader::getStreamBlock(ossim_uint32 offset,
+                                         ossimPointBlock& block,
+                                         ossim_uint32 requested) const
+{
+   std::lock_guard<std::mutex> lock(m_streamMutex);
+   if ((requested == 0) || !seekStream(offset))
+   {
+      block.clear();
+      return;
+   }
+
+   // Like parsePointView(), a block holding the points requested already is left as is:
+   if (block.size() >= requested)
+      return;
+
+   // A chunk at a time:
+   m_currentPID = offset;
+   do
+   {
+      m_currentPID += parseStream(m_currentPID, requested - block.size(), block.getFieldCode(),
+                                  false, m_columns);
+      m_columns.addToBlock(block);
+   }
+   while ((block.size() < requested) && seekStream(m_currentPID));
+}
+
+void ossimPdalFileReader::getFileColumns(ossim_uint32 offset,
+                                         ossimPdalPointColumns& columns,
+                                         ossim_uint32 fieldCode,
+                                         ossim_uint32 maxNumPoints) const
+{
+   if (m_stream)
+   {
+      std::lock_guard<std::mutex> lock(m_streamMutex);
+      if ((maxNumPoints == 0) || !seekStream(offset))
+         columns.clear();
+      else
+         parseStream(offset, maxNumPoints, fieldCode, true, columns);
+      return;
+   }
+
+   if (!m_currentPV || (maxNumPoints == 0) || (offset >= m_currentPV->size()))
+   {
+      columns.clear();
+      return;
+   }
+
+   ossim_uint32 numPoints = (ossim_uint32) (m_currentPV->size() - offset);
+   if (numPoints > maxNumPoints)
+      numPoints = maxNumPoints;
+   std::vector<const char*> points;
+   getPointData(*m_currentPV, offset, numPoints, points);
+   parsePoints(*m_currentPV->layout(), points, fieldCode, true, columns);
+   columns.setFirstPointId(offset);
+}
+
+void ossimPdalFileReader::latchStreamMinMax() const
+{
+   static const ossimPointRecord::FIELD_CODES FIELDS[] = {
+      ossimPointRecord::Intensity, ossimPointRecord::ReturnNumber,
+      ossimPointRecord::NumberOfReturns, ossimPointRecord::Red, ossimPointRecord::Green,
+      ossimPointRecord::Blue, ossimPointRecord::GpsTime, ossimPointRecord::Infrared };
+   static const Id::Enum DIMS[] = {
+      Id::Enum::Intensity, Id::Enum::ReturnNumber, Id::Enum::NumberOfReturns, Id::Enum::Red,
+      Id::Enum::Green, Id::Enum::Blue, Id::Enum::GpsTime, Id::Enum::Infrared };
+
+   const ossim_uint64 chunkStart = m_stream->getChunkStart();
+   const ossim_uint64 chunkEnd = chunkStart + m_stream->getChunkSize();
+   if (chunkEnd <= m_numLatched)
+      return;
+
+   const PointId first = (m_numLatched > chunkStart) ? m_numLatched - chunkStart : 0;
+   const PointId last = chunkEnd - chunkStart;
+   for (int f = 0; f < 8; ++f)
+   {
+      if (!hasFields(FIELDS[f]))
+         continue;
+
+      PointRef point (*m_stream, first);
+      ossim_float32 minValue = point.getFieldAs<float>(DIMS[f]);
+      ossim_float32 maxValue = minValue;
+      for (PointId idx = first + 1; idx < last; ++idx)
+      {
+         point.setPointId(idx);
+         const ossim_float32 value = point.getFieldAs<float>(DIMS[f]);
+         if (value < minValue)
+            minValue = value;
+         else if (value > maxValue)
+            maxValue = value;
+      }
+      if ((m_numLatched == 0) || (minValue < m_minRecord->getField(FIELDS[f])))
+         m_minRecord->setField(FIELDS[f], minValue);
+      if ((m_numLatched == 0) || (maxValue > m_maxRecord->getField(FIELDS[f])))
+         m_maxRecord->setField(FIELDS[f], maxValue);
+   }
+   m_numLatched = (ossim_uint32) chunkEnd;
+}
+
 void ossimPdalFileReader::establishMinMax()
 {
    if (!m_pdalPipe || !m_currentPV || !m_geometry.valid())
@@ -13,12 +13,20 @@
 #include "ossimPdalReader.h"
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <pdal/pdal.hpp>
+#include <mutex>
 
 class ossimPointRecord;
 class Stage;
 
 #define USE_FULL_POINT_CLOUD_BUFFERING
 
+/**
+ * Reads a point cloud file through PDAL. Files up to the stream chunk size are loaded whole behind
+ * a stats filter. Larger ones are streamed: a reader thread fills one chunk of points at a time,
+ * on demand from getFileBlock(), so memory stays at a chunk however large the file. The point
+ * count and position bounds then come from the file header, and the other fields' ranges are
+ * widened as chunks are read the first time through.
+ */
 class OSSIM_PLUGINS_DLL ossimPdalFileReader : public ossimPdalReader
 {
 public:
@@ -42,11 +50,68 @@ public:
                              ossimPointBlock& block,
                              ossim_uint32 maxNumPoints=0xFFFFFFFF) const;
 
+   /**
+    * Columnar counterpart of getFileBlock(): fills the columns with up to maxNumPoints points from
+    * the offset on, with the fields in fieldCode that the file has, and the classification if it
+    * has one. When streaming, stops at the end of the chunk, so may return fewer; call again from
+    * offset + columns.size(). The columns are empty past the last point.
+    */
+   void getFileColumns(ossim_uint32 offset,
+                       ossimPdalPointColumns& columns,
+                       ossim_uint32 fieldCode,
+                       ossim_uint32 maxNumPoints=0xFFFFFFFF) const;
+
    virtual ossim_uint32 getNumPoints() const;
 
+   virtual void close();
+
+   /**
+    * Files with more points than this are streamed in chunks of this many points, 0 to always load
+    * the whole file. Takes effect at the next open(). Defaults to the
+    * "pdal_reader_stream_chunk_size" preference, or 1000000.
+    */
+   void setStreamChunkSize(ossim_uint32 numPoints);
+   ossim_uint32 getStreamChunkSize() const;
+
+   /** Returns TRUE if the open file is being streamed rather than held in memory. */
+   bool isStreaming() const;
+
 private:
+   class Stream;
+
    virtual void establishMinMax();
 
+   /** Starts streaming the file. Returns FALSE if the reader can't stream it. */
+   bool openStream(const pdal::QuickInfo& info);
+
+   /** (Re)starts the reader thread from the first point, with a new reader for m_driver. */
+   bool startStream() const;
+
+   /** Restarts the stream if need be and waits for the chunk holding the offset. */
+   bool seekStream(ossim_uint32 offset) const;
+
+   /** Parses from the offset to the end of its chunk, at most maxNumPoints. Returns the count. */
+   ossim_uint32 parseStream(ossim_uint32 offset,
+                            ossim_uint32 maxNumPoints,
+                            ossim_uint32 fieldCode,
+                            bool classification,
+                            ossimPdalPointColumns& columns) const;
+
+   void getStreamBlock(ossim_uint32 offset, ossimPointBlock& block, ossim_uint32 requested) const;
+
+   /** Widens the field ranges with the points of the current chunk not seen before. */
+   void latchStreamMinMax() const;
+
+   ossim_uint32 m_streamChunkSize;
+   std::string m_driver;
+
+   /** Owns the reader the file is opened with, which the stats filter reads from. */
+   pdal::StageFactory m_stageFactory;
+   mutable Stream* m_stream;
+   mutable std::mutex m_streamMutex;
+   ossim_uint32 m_numStreamPoints;
+   mutable ossim_uint32 m_numLatched;
+
 
 TYPE_DATA
 };
@@ -0,0 +1,110 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+
+#include "ossimPdalPointColumns.h"
+#include <ossim/base/ossimGpt.h>
+#include <ossim/point_cloud/ossimPointBlock.h>
+
+static const ossimPointRecord::FIELD_CODES FIELDS[ossimPdalPointColumns::NUM_FIELDS] = {
+   ossimPointRecord::Intensity, ossimPointRecord::ReturnNumber,
+   ossimPointRecord::NumberOfReturns, ossimPointRecord::Red, ossimPointRecord::Green,
+   ossimPointRecord::Blue, ossimPointRecord::GpsTime, ossimPointRecord::Infrared };
+
+ossimPdalPointColumns::ossimPdalPointColumns()
+:  m_numPoints(0),
+   m_fieldCode(0),
+   m_firstId(0),
+   m_hasClassification(false)
+{
+}
+
+ossimPointRecord::FIELD_CODES ossimPdalPointColumns::fieldAt(int index)
+{
+   return FIELDS[index];
+}
+
+void ossimPdalPointColumns::resize(ossim_uint32 numPoints, ossim_uint32 fieldCode)
+{
+   m_numPoints = numPoints;
+   m_fieldCode = fieldCode;
+   m_x.resize(numPoints);
+   m_y.resize(numPoints);
+   m_z.resize(numPoints);
+   for (int f=0; f<NUM_FIELDS; ++f)
+   {
+      if (fieldCode & FIELDS[f])
+         m_fields[f].resize(numPoints);
+      else
+         m_fields[f].clear();
+   }
+   m_classification.resize(m_hasClassification ? numPoints : 0);
+}
+
+void ossimPdalPointColumns::clear()
+{
+   resize(0, m_fieldCode);
+}
+
+ossim_float32* ossimPdalPointColumns::field(ossimPointRecord::FIELD_CODES field)
+{
+   for (int f=0; f<NUM_FIELDS; ++f)
+   {
+      if (FIELDS[f] == field)
+         return (m_fieldCode & field) ? m_fields[f].data() : 0;
+   }
+   return 0;
+}
+
+const ossim_float32* ossimPdalPointColumns::field(ossimPointRecord::FIELD_CODES field) const
+{
+   return const_cast<ossimPdalPointColumns*>(this)->field(field);
+}
+
+ossim_uint8* ossimPdalPointColumns::classification()
+{
+   return m_hasClassification ? m_classification.data() : 0;
+}
+
+const ossim_uint8* ossimPdalPointColumns::classification() const
+{
+   return m_hasClassification ? m_classification.data() : 0;
+}
+
+void ossimPdalPointColumns::setHasClassification(bool hasClassification)
+{
+   m_hasClassification = hasClassification;
+}
+
+void ossimPdalPointColumns::addToBlock(ossimPointBlock& block) const
+{
+   const ossim_uint32 blockCode = block.getFieldCode();
+
+   // Only the fields held and wanted:
+   const ossim_float32* fields[NUM_FIELDS];
+   int numFields = 0;
+   ossimPointRecord::FIELD_CODES codes[NUM_FIELDS];
+   for (int f=0; f<NUM_FIELDS; ++f)
+   {
+      if ((blockCode & m_fieldCode & FIELDS[f]) && !m_fields[f].empty())
+      {
+         fields[numFields] = m_fields[f].data();
+         codes[numFields++] = FIELDS[f];
+      }
+   }
+
+   for (ossim_uint32 i=0; i<m_numPoints; ++i)
+   {
+      ossimRefPtr<ossimPointRecord> opr = new ossimPointRecord(blockCode);
+      for (int f=0; f<numFields; ++f)
+         opr->setField(codes[f], fields[f][i]);
+      opr->setPosition(ossimGpt(m_y[i], m_x[i], m_z[i]));
+      opr->setPointId(m_firstId + i);
+      block.addPoint(opr.get());
+   }
+}
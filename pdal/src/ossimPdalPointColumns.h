@@ -0,0 +1,87 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+// $Id$
+
+#ifndef ossimPdalPointColumns_HEADER
+#define ossimPdalPointColumns_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/point_cloud/ossimPointRecord.h>
+#include <vector>
+
+class ossimPointBlock;
+
+/**
+ * A run of points stored a field at a time: one contiguous array each for the position and for
+ * every field requested, rather than an ossimPointRecord per point. Filled by ossimPdalReader a
+ * PDAL dimension at a time. Positions are ground positions, converted by the reader's geometry:
+ * x is longitude, y latitude and z height.
+ */
+class OSSIM_PLUGINS_DLL ossimPdalPointColumns
+{
+public:
+   ossimPdalPointColumns();
+
+   /**
+    * Sizes the arrays for numPoints points of the fields in fieldCode (@see
+    * ossimPointRecord::FIELD_CODES). Fields not in the code get no array. Values are not cleared.
+    */
+   void resize(ossim_uint32 numPoints, ossim_uint32 fieldCode);
+
+   void clear();
+
+   ossim_uint32 size() const { return m_numPoints; }
+   bool empty() const { return m_numPoints == 0; }
+   ossim_uint32 getFieldCode() const { return m_fieldCode; }
+
+   /** ID of the first point; the rest follow in order. */
+   ossim_uint32 getFirstPointId() const { return m_firstId; }
+   void setFirstPointId(ossim_uint32 id) { m_firstId = id; }
+
+   ossim_float64* x() { return m_x.data(); }
+   ossim_float64* y() { return m_y.data(); }
+   ossim_float64* z() { return m_z.data(); }
+   const ossim_float64* x() const { return m_x.data(); }
+   const ossim_float64* y() const { return m_y.data(); }
+   const ossim_float64* z() const { return m_z.data(); }
+
+   /** Array of a single field, 0 if the field code doesn't have it. */
+   ossim_float32* field(ossimPointRecord::FIELD_CODES field);
+   const ossim_float32* field(ossimPointRecord::FIELD_CODES field) const;
+
+   /** LAS classification, 0 unless setHasClassification(true) was called before resize(). */
+   ossim_uint8* classification();
+   const ossim_uint8* classification() const;
+   void setHasClassification(bool hasClassification);
+
+   /**
+    * Appends a record per point to the block, for consumers of the per-record API. Each
+    * record has the fields of the block's field code that are held here.
+    */
+   void addToBlock(ossimPointBlock& block) const;
+
+   /** Number of per-field arrays, one per bit of ossimPointRecord::FIELD_CODES. */
+   static const int NUM_FIELDS = 8;
+
+   /** The field code bit of each array. */
+   static ossimPointRecord::FIELD_CODES fieldAt(int index);
+
+private:
+   ossim_uint32 m_numPoints;
+   ossim_uint32 m_fieldCode;
+   ossim_uint32 m_firstId;
+   bool m_hasClassification;
+   std::vector<ossim_float64> m_x;
+   std::vector<ossim_float64> m_y;
+   std::vector<ossim_float64> m_z;
+   std::vector<ossim_float32> m_fields[NUM_FIELDS];
+   std::vector<ossim_uint8> m_classification;
+};
+
+#endif /* #ifndef ossimPdalPointColumns_HEADER */
@@ -14,6 +14,8 @@
 #include <ossim/base/ossimUnitConversionTool.h>
 #include <ossim/point_cloud/ossimPointRecord.h>
 #include <pdal/PointViewIter.hpp>
+#include <algorithm>
+#include <cstring>
 
 RTTI_DEF1(ossimPdalReader, "ossimPdalReader" , ossimPointCloudHandler)
 
@@ -48,64 +50,212 @@ void ossimPdalReader::rewind() const
 
 void ossimPdalReader::parsePointView(ossimPointBlock& block, ossim_uint32 maxNumPoints) const
 {
-   ossim_uint32 field_code = block.getFieldCode();
-   while (m_currentPvOffset < m_currentPV->size())
-   {
-      if (block.size() == maxNumPoints)
-         break;
+   if ((block.size() >= maxNumPoints) || (m_currentPvOffset >= m_currentPV->size()))
+      return;
 
-      // Convert point data to OSSIM-friendly format:
+   ossim_uint32 numPoints = maxNumPoints - block.size();
+   if (numPoints > m_currentPV->size() - m_currentPvOffset)
+      numPoints = (ossim_uint32) (m_currentPV->size() - m_currentPvOffset);
+
+   // Read a field at a time into columns, then make the records from those:
+   std::vector<const char*> points;
+   getPointData(*m_currentPV, m_currentPvOffset, numPoints, points);
+   parsePoints(*m_currentPV->layout(), points, block.getFieldCode(), false, m_columns);
+
+   // Normalize intensity and color:
 #ifdef NORMALIZE_FIELDS
-      ossim_float32 minI, delI, minC, delC;
-      bool hasIntensity = false;
-      bool hasRGB = false;
-      if (field_code & ossimPointRecord::Intensity)
-      {
-         hasIntensity = true;
-         minI = m_minRecord->getField(ossimPointRecord::Intensity);
-         delI = m_maxRecord->getField(ossimPointRecord::Intensity) - minI;
-      }
-      ossim_uint32 rgb_code = ossimPointRecord::Red | ossimPointRecord::Green | ossimPointRecord::Blue;
-      if ((field_code & rgb_code) == rgb_code)
+   ossim_float32* intensity = m_columns.field(ossimPointRecord::Intensity);
+   if (intensity)
+   {
+      ossim_float32 minI = m_minRecord->getField(ossimPointRecord::Intensity);
+      ossim_float32 delI = m_maxRecord->getField(ossimPointRecord::Intensity) - minI;
+      for (ossim_uint32 i=0; i<numPoints; ++i)
+         intensity[i] = (intensity[i] - minI) / delI;
+   }
+   ossim_float32* red = m_columns.field(ossimPointRecord::Red);
+   ossim_float32* green = m_columns.field(ossimPointRecord::Green);
+   ossim_float32* blue = m_columns.field(ossimPointRecord::Blue);
+   if (red && green && blue)
+   {
+      ossim_float32 minC = m_minRecord->getField(ossimPointRecord::Red);
+      ossim_float32 delC = m_maxRecord->getField(ossimPointRecord::Red) - minC;
+      for (ossim_uint32 i=0; i<numPoints; ++i)
       {
-         hasRGB = true;
-         minC = m_minRecord->getField(ossimPointRecord::Red);
-         delC = m_maxRecord->getField(ossimPointRecord::Red) - minC;
+         red[i] = (red[i] - minC) / delC;
+         green[i] = (green[i] - minC) / delC;
+         blue[i] = (blue[i] - minC) / delC;
       }
+   }
 #endif
 
-      //   cout << "ossimPdalReader::parsePointView() -- point_id = "<< point_id<<endl;
+   // Add these points to the output block:
+   m_columns.setFirstPointId(m_currentPID);
+   m_columns.addToBlock(block);
+   m_currentPID += numPoints;
+   m_currentPvOffset += numPoints;
+}
+
+/** The record field of a PDAL dimension, 0 if none. */
+static ossim_uint32 fieldOf(Id::Enum id)
+{
+   switch (id)
+   {
+   case Id::Enum::Intensity:
+      return ossimPointRecord::Intensity;
+   case Id::Enum::ReturnNumber:
+      return ossimPointRecord::ReturnNumber;
+   case Id::Enum::NumberOfReturns:
+      return ossimPointRecord::NumberOfReturns;
+   case Id::Enum::Red:
+      return ossimPointRecord::Red;
+   case Id::Enum::Green:
+      return ossimPointRecord::Green;
+   case Id::Enum::Blue:
+      return ossimPointRecord::Blue;
+   case Id::Enum::GpsTime:
+      return ossimPointRecord::GpsTime;
+   case Id::Enum::Infrared:
+      return ossimPointRecord::Infrared;
+   default:
+      return 0;
+   }
+}
 
-      // Reads directly from the PDAL point buffer:
-      ossimRefPtr<ossimPointRecord> opr = new ossimPointRecord(field_code);
-      parsePoint(opr.get());
+template <class S, class T>
+static void copyColumn(const std::vector<const char*>& points, std::size_t offset, T* column)
+{
+   const std::size_t count = points.size();
+   for (std::size_t i=0; i<count; ++i)
+   {
+      S value;
+      memcpy(&value, points[i] + offset, sizeof(S));
+      column[i] = (T) value;
+   }
+}
 
-      // Normalize intensity and color:
-#ifdef NORMALIZE_FIELDS
-      if (hasIntensity)
-      {
-         float normI = (opr->getField(ossimPointRecord::Intensity) - minI) / delI;
-         opr->setField(ossimPointRecord::Intensity, normI);
-      }
-      if (hasRGB)
+/** Copies one dimension of every point into the column, converting from the stored type. */
+template <class T>
+static void parseColumn(const PointLayout& layout,
+                        Id::Enum id,
+                        const std::vector<const char*>& points,
+                        T* column)
+{
+   const std::size_t offset = layout.dimOffset(id);
+   switch (layout.dimType(id))
+   {
+   case Type::Signed8:
+      copyColumn<int8_t>(points, offset, column);
+      break;
+   case Type::Signed16:
+      copyColumn<int16_t>(points, offset, column);
+      break;
+   case Type::Signed32:
+      copyColumn<int32_t>(points, offset, column);
+      break;
+   case Type::Signed64:
+      copyColumn<int64_t>(points, offset, column);
+      break;
+   case Type::Unsigned8:
+      copyColumn<uint8_t>(points, offset, column);
+      break;
+   case Type::Unsigned16:
+      copyColumn<uint16_t>(points, offset, column);
+      break;
+   case Type::Unsigned32:
+      copyColumn<uint32_t>(points, offset, column);
+      break;
+   case Type::Unsigned64:
+      copyColumn<uint64_t>(points, offset, column);
+      break;
+   case Type::Float:
+      copyColumn<float>(points, offset, column);
+      break;
+   case Type::Double:
+      copyColumn<double>(points, offset, column);
+      break;
+   default:
+      std::fill(column, column + points.size(), T(0));
+      break;
+   }
+}
+
+void ossimPdalReader::getPointData(PointView& view,
+                                   PointId first,
+                                   ossim_uint32 count,
+                                   std::vector<const char*>& points)
+{
+   points.resize(count);
+   for (ossim_uint32 i=0; i<count; ++i)
+      points[i] = view.getPoint(first + i);
+}
+
+void ossimPdalReader::parsePoints(const PointLayout& layout,
+                                  const std::vector<const char*>& points,
+                                  ossim_uint32 fieldCode,
+                                  bool classification,
+                                  ossimPdalPointColumns& columns) const
+{
+   const ossim_uint32 count = (ossim_uint32) points.size();
+   const IdList& dims = layout.dims();
+
+   // Columns for the fields both wanted and present:
+   ossim_uint32 columnCode = 0;
+   bool hasClassification = false;
+   IdList::const_iterator dim_iter = dims.begin();
+   while (dim_iter != dims.end())
+   {
+      columnCode |= fieldOf(*dim_iter);
+      if (classification && (*dim_iter == Id::Enum::Classification))
+         hasClassification = true;
+      ++dim_iter;
+   }
+   columns.setHasClassification(hasClassification);
+   columns.resize(count, columnCode & fieldCode);
+
+   // Each dimension in turn, down its whole column, straight from the point data:
+   dim_iter = dims.begin();
+   while (dim_iter != dims.end())
+   {
+      Id::Enum id = *dim_iter;
+      ossim_uint32 field = fieldOf(id);
+      if (id == Id::Enum::X)
+         parseColumn(layout, id, points, columns.x());
+      else if (id == Id::Enum::Y)
+         parseColumn(layout, id, points, columns.y());
+      else if (id == Id::Enum::Z)
+         parseColumn(layout, id, points, columns.z());
+      else if ((id == Id::Enum::Classification) && hasClassification)
+         parseColumn(layout, id, points, columns.classification());
+      else if (field & columns.getFieldCode())
       {
-         float normC = (opr->getField(ossimPointRecord::Red) - minC) / delC;
-         opr->setField(ossimPointRecord::Red, normC);
-         normC = (opr->getField(ossimPointRecord::Green) - minC) / delC;
-         opr->setField(ossimPointRecord::Green, normC);
-         normC = (opr->getField(ossimPointRecord::Blue) - minC) / delC;
-         opr->setField(ossimPointRecord::Blue, normC);
+         parseColumn(layout, id, points, columns.field((ossimPointRecord::FIELD_CODES) field));
       }
-#endif
+      ++dim_iter;
+   }
 
-      // Add this point to the output block:
-      opr->setPointId(m_currentPID++);
-      block.addPoint(opr.get());
-      ++m_currentPvOffset;
+   // Need to convert X, Y, Z to geographic point (if necessary).
+   ossim_float64* x = columns.x();
+   ossim_float64* y = columns.y();
+   ossim_float64* z = columns.z();
+   ossimGpt pos;
+   for (ossim_uint32 i=0; i<count; ++i)
+   {
+      m_geometry->convertPos(ossimDpt3d(x[i], y[i], z[i]), pos);
+      x[i] = pos.lon;
+      y[i] = pos.lat;
+      z[i] = pos.hgt;
    }
 }
 
 void ossimPdalReader::parsePoint(ossimPointRecord* point) const
+{
+   PointRef pdalPoint (m_currentPV->point(m_currentPvOffset));
+   parsePoint(pdalPoint, m_currentPV->dims(), point);
+}
+
+void ossimPdalReader::parsePoint(PointRef& pdalPoint,
+                                 const IdList& idList,
+                                 ossimPointRecord* point) const
 {
    if (!point)
       return;
@@ -116,7 +266,6 @@ void ossimPdalReader::parsePoint(ossimPointRecord* point) const
 
    // The ossimPointRecord should already be initialized with the desired fields set to default
    // values (i.e., their NULL values):
-   const IdList& idList = m_currentPV->dims();
    IdList::const_iterator dim_iter = idList.begin();
    while (dim_iter != idList.end())
    {
@@ -124,67 +273,67 @@ void ossimPdalReader::parsePoint(ossimPointRecord* point) const
       switch (id)
       {
       case Id::Enum::X: // always do position
-         dpt3d.x = m_currentPV->getFieldAs<double>(Id::Enum::X, m_currentPvOffset);
+         dpt3d.x = pdalPoint.getFieldAs<double>(Id::Enum::X);
          break;
       case Id::Enum::Y: // always do position
-         dpt3d.y = m_currentPV->getFieldAs<double>(Id::Enum::Y, m_currentPvOffset);
+         dpt3d.y = pdalPoint.getFieldAs<double>(Id::Enum::Y);
          break;
       case Id::Enum::Z: // always do position
-         dpt3d.z = m_currentPV->getFieldAs<double>(Id::Enum::Z, m_currentPvOffset);
+         dpt3d.z = pdalPoint.getFieldAs<double>(Id::Enum::Z);
          break;
       case Id::Enum::ReturnNumber:
          if (point->hasFields(ossimPointRecord::ReturnNumber))
          {
-            I8 = m_currentPV->getFieldAs<uint8_t>(Id::Enum::ReturnNumber, m_currentPvOffset);
+            I8 = pdalPoint.getFieldAs<uint8_t>(Id::Enum::ReturnNumber);
             point->setField(ossimPointRecord::ReturnNumber, (ossim_float32) I8);
          }
          break;
       case Id::Enum::NumberOfReturns:
          if (point->hasFields(ossimPointRecord::NumberOfReturns))
          {
-            I8 = m_currentPV->getFieldAs<uint8_t>(Id::Enum::NumberOfReturns, m_currentPvOffset);
+            I8 = pdalPoint.getFieldAs<uint8_t>(Id::Enum::NumberOfReturns);
             point->setField(ossimPointRecord::NumberOfReturns, (ossim_float32) I8);
          }
          break;
       case Id::Enum::Intensity:
          if (point->hasFields(ossimPointRecord::Intensity))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::Intensity, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::Intensity);
             point->setField(ossimPointRecord::Intensity, (ossim_float32) F32);
          }
          break;
       case Id::Enum::Red:
          if (point->hasFields(ossimPointRecord::Red))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::Red, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::Red);
             point->setField(ossimPointRecord::Red, (ossim_float32) F32);
          }
          break;
       case Id::Enum::Green:
          if (point->hasFields(ossimPointRecord::Green))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::Green, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::Green);
             point->setField(ossimPointRecord::Green, (ossim_float32) F32);
          }
          break;
       case Id::Enum::Blue:
          if (point->hasFields(ossimPointRecord::Blue))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::Blue, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::Blue);
             point->setField(ossimPointRecord::Blue, (ossim_float32) F32);
          }
          break;
       case Id::Enum::Infrared:
          if (point->hasFields(ossimPointRecord::Infrared))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::Infrared, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::Infrared);
             point->setField(ossimPointRecord::Infrared, (ossim_float32) F32);
          }
          break;
       case Id::Enum::GpsTime:
          if (point->hasFields(ossimPointRecord::GpsTime))
          {
-            F32 = m_currentPV->getFieldAs<float>(Id::Enum::GpsTime, m_currentPvOffset);
+            F32 = pdalPoint.getFieldAs<float>(Id::Enum::GpsTime);
             point->setField(ossimPointRecord::GpsTime, (ossim_float32) F32);
          }
          break;
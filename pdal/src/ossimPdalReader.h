@@ -13,6 +13,8 @@
 #include <ossim/point_cloud/ossimPointCloudHandler.h>
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <pdal/pdal.hpp>
+#include <pdal/PointRef.hpp>
+#include "ossimPdalPointColumns.h"
 
 class ossimPointRecord;
 #define USE_FULL_POINT_CLOUD_BUFFERING
@@ -56,10 +58,33 @@ protected:
     *  or get overwritten if pid matches existing. */
    void parsePointView(ossimPointBlock& block, ossim_uint32 maxNumPoints = 0xFFFFFFFF) const;
 
+   /**
+    * Reads points into the columns a dimension at a time, straight from PDAL's point data:
+    * points[i] is where the data of point i start, laid out as the layout says. Only fields in
+    * fieldCode that the layout has get columns, and the classification if asked for and present.
+    * Positions are converted to ground. The first point ID is left to the caller.
+    */
+   void parsePoints(const pdal::PointLayout& layout,
+                    const std::vector<const char*>& points,
+                    ossim_uint32 fieldCode,
+                    bool classification,
+                    ossimPdalPointColumns& columns) const;
+
+   /** Where the data of count points of the view start, from first on, for parsePoints(). */
+   static void getPointData(pdal::PointView& view,
+                            pdal::PointId first,
+                            ossim_uint32 count,
+                            std::vector<const char*>& points);
+
    /** Need to pass allocated ossimPointRecord with field code set to desired fields. The pointNum
     * is the point index into the point view */
    void parsePoint(ossimPointRecord* precord) const;
 
+   /** Same as above for a point in any PDAL point container, with the dimensions it has. */
+   void parsePoint(pdal::PointRef& point,
+                   const pdal::Dimension::IdList& dims,
+                   ossimPointRecord* precord) const;
+
    /** Computes min and max records using points in the current PointViewSet */
    virtual void establishMinMax();
 
@@ -73,6 +98,9 @@ protected:
    mutable pdal::Options m_pdalOptions;
    ossim_uint32 m_availableFields;
 
+   /** Scratch columns for parsePointView(). */
+   mutable ossimPdalPointColumns m_columns;
+
    TYPE_DATA
 };
 
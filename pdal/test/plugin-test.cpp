@@ -12,6 +12,7 @@
 #include <ossim/base/ossimStringProperty.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <assert.h>
+#include <ctime>
 #include <ossim/point_cloud/ossimPointCloudImageHandler.h>
 #include <ossim/imaging/ossimTiffWriter.h>
 #include <pdal/pdal.hpp>
@@ -25,7 +26,7 @@ using namespace pdal;
 
 int usage(char* app_name)
 {
-   cout << "\nUsage: "<<app_name<<" <pdal|rialto|genlas> [filename]\n" << endl;
+   cout << "\nUsage: "<<app_name<<" <pdal|stream|columns|rialto|genlas> [filename]\n" << endl;
    return 1;
 }
 
@@ -96,6 +97,131 @@ bool test_pdal(const ossimFilename& fname)
    return 0;
 }
 
+bool test_stream(const ossimFilename& fname)
+{
+   cout << "Testing pdal streaming with <"<<fname<<">"<<endl;
+
+   // Whole file in memory for reference:
+   ossimRefPtr<ossimPdalFileReader> whole = new ossimPdalFileReader;
+   whole->setStreamChunkSize(0);
+   whole->open(fname);
+
+   // Same file streamed in chunks of 1000 points:
+   ossimRefPtr<ossimPdalFileReader> reader = new ossimPdalFileReader;
+   reader->setStreamChunkSize(1000);
+   if (!reader->open(fname) || !reader->isStreaming())
+   {
+      cout << "FAILED: file not streamed" << endl;
+      return false;
+   }
+   if (reader->getNumPoints() != whole->getNumPoints())
+   {
+      cout << "FAILED: point count " << reader->getNumPoints() << " != "
+           << whole->getNumPoints() << endl;
+      return false;
+   }
+
+   // Blocks straddling chunks, then going back to the start:
+   ossim_uint32 offsets[] = { 0, 900, 2500, reader->getNumPoints() - 5, 10 };
+   for (int i=0; i<5; ++i)
+   {
+      ossimPointBlock streamed;
+      ossimPointBlock expected;
+      reader->getFileBlock(offsets[i], streamed, 300);
+      whole->getFileBlock(offsets[i], expected, 300);
+      if (streamed.size() != expected.size())
+      {
+         cout << "FAILED: block at "<<offsets[i]<<" has "<<streamed.size()<<" points" << endl;
+         return false;
+      }
+      for (ossim_uint32 p=0; p<streamed.size(); ++p)
+      {
+         const ossimPointRecord* s = streamed.getPoint(p);
+         const ossimPointRecord* e = expected.getPoint(p);
+         if ((s->getPointId() != e->getPointId()) || !(s->getPosition() == e->getPosition()))
+         {
+            cout << "FAILED: point "<<e->getPointId()<<" differs" << endl;
+            return false;
+         }
+      }
+   }
+
+   ossimGrect bounds;
+   reader->getBounds(bounds);
+   cout <<"bounds = "<<bounds<<endl;
+
+   writeRaster(reader.get(), "stream");
+
+   return true;
+}
+
+bool test_columns(const ossimFilename& fname)
+{
+   cout << "Testing pdal point columns with <"<<fname<<">"<<endl;
+
+   ossimRefPtr<ossimPdalFileReader> reader = new ossimPdalFileReader;
+   if (!reader->open(fname))
+   {
+      cout << "FAILED: file not opened" << endl;
+      return false;
+   }
+   const ossim_uint32 fields = reader->getFieldCode();
+   const ossim_uint32 numPoints = reader->getNumPoints();
+
+   // Whole file both ways, timed:
+   ossimPointBlock block;
+   block.setFieldCode(fields);
+   ossim_uint32 pass = 0;
+   clock_t start = clock();
+   for (int i=0; i<10; ++i)
+   {
+      block.clear();
+      reader->getFileBlock(0, block, numPoints);
+   }
+   double blockSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+   ossimPdalPointColumns columns;
+   start = clock();
+   for (int i=0; i<10; ++i)
+   {
+      for (ossim_uint32 offset=0; offset<numPoints; offset+=columns.size())
+      {
+         reader->getFileColumns(offset, columns, fields, numPoints);
+         if (columns.empty())
+            break;
+      }
+   }
+   double columnSeconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+   cout << "records: " << blockSeconds << " s, columns: " << columnSeconds << " s for 10 passes"
+        << endl;
+
+   // Columns against the records, a block at a time:
+   for (ossim_uint32 offset=0; offset<numPoints; offset+=columns.size())
+   {
+      reader->getFileColumns(offset, columns, fields, 1000);
+      if (columns.empty() || (columns.getFirstPointId() != offset))
+      {
+         cout << "FAILED: no columns at "<<offset << endl;
+         return false;
+      }
+      const ossim_float32* intensity = columns.field(ossimPointRecord::Intensity);
+      for (ossim_uint32 i=0; i<columns.size(); ++i, ++pass)
+      {
+         const ossimPointRecord* p = block.getPoint(offset + i);
+         if ((p->getPointId() != offset + i) ||
+             !(p->getPosition() == ossimGpt(columns.y()[i], columns.x()[i], columns.z()[i])) ||
+             (intensity && (p->getField(ossimPointRecord::Intensity) != intensity[i])))
+         {
+            cout << "FAILED: point "<<offset + i<<" differs" << endl;
+            return false;
+         }
+      }
+   }
+   cout << pass << " points match" << endl;
+
+   return pass == numPoints;
+}
+
 bool genlas(const ossimFilename& fname)
 {
    cout << "Generating file <"<<fname<<">"<<endl;
@@ -152,6 +278,18 @@ int main(int argc, char** argv)
          fname = "autzen.las";
       passed = test_pdal(fname);
    }
+   else if (test_name.downcase() == "stream")
+   {
+      if (fname.empty())
+         fname = "autzen.las";
+      passed = test_stream(fname);
+   }
+   else if (test_name.downcase() == "columns")
+   {
+      if (fname.empty())
+         fname = "autzen.las";
+      passed = test_columns(fname);
+   }
    else if (test_name.downcase() == "genlas")
    {
       if (fname.empty())
@@ -0,0 +1,163 @@
+//**************************************************************************************************
+//
+// OSSIM (http://trac.osgeo.org/ossim/)
+//
+// License:  LGPL -- See LICENSE.txt file in the top level directory for more details.
+//
+//**************************************************************************************************
+//
+// Time to the first block, resident memory and full pass time of ossimPdalFileReader, streamed
+// and loaded whole, on autzen.las scaled up: the file is written again with the given number of
+// copies of its points side by side. Then the streamed reader goes back to the start repeatedly,
+// which restarts its reader each time, to show memory stays put.
+//
+// Usage: ossim-pdal-stream-bench [copies] [input.las] [chunk size]
+
+#include "../src/ossimPdalFileReader.h"
+#include <ossim/point_cloud/ossimPointBlock.h>
+#include <pdal/pdal.hpp>
+#include <pdal/BufferReader.hpp>
+#include <pdal/LasReader.hpp>
+#include <pdal/LasWriter.hpp>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace pdal;
+
+static const ossim_uint32 FIRST_BLOCK = 1000;
+static const ossim_uint32 PASS_BLOCK = 10000;
+static const int REWINDS = 20;
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Resident set size in MB, 0 where /proc isn't there.
+static double residentMb()
+{
+   ifstream status("/proc/self/status");
+   string line;
+   while (getline(status, line))
+   {
+      if (line.compare(0, 6, "VmRSS:") == 0)
+         return atof(line.c_str() + 6) / 1024.0;
+   }
+   return 0.0;
+}
+
+// Writes copies of the input's points side by side in x.
+static point_count_t writeScaled(const string& input, int copies, const string& output)
+{
+   Options readOptions;
+   readOptions.add("filename", input);
+   LasReader reader;
+   reader.setOptions(readOptions);
+   PointTable table;
+   reader.prepare(table);
+   PointViewPtr view = *reader.execute(table).begin();
+
+   BOX3D bounds;
+   view->calculateBounds(bounds);
+   const double width = bounds.maxx - bounds.minx + 1.0;
+   PointViewPtr scaled(new PointView(table));
+   for (int c=0; c<copies; ++c)
+   {
+      for (PointId idx=0; idx<view->size(); ++idx)
+      {
+         scaled->appendPoint(*view, idx);
+         const PointId last = scaled->size() - 1;
+         scaled->setField(Dimension::Id::X, last,
+                          view->getFieldAs<double>(Dimension::Id::X, idx) + c*width);
+      }
+   }
+
+   BufferReader buffer;
+   buffer.addView(scaled);
+   Options writeOptions;
+   writeOptions.add("filename", output);
+   writeOptions.add("forward", "all");
+   writeOptions.add("offset_x", "auto");
+   LasWriter writer;
+   writer.setOptions(writeOptions);
+   writer.setInput(buffer);
+   writer.prepare(table);
+   writer.execute(table);
+   return scaled->size();
+}
+
+static void run(const char* mode, const string& fname, ossim_uint32 chunkSize)
+{
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   ossimRefPtr<ossimPdalFileReader> reader = new ossimPdalFileReader;
+   reader->setStreamChunkSize(chunkSize);
+   if (!reader->open(fname))
+   {
+      cout << mode << ": could not open " << fname << endl;
+      return;
+   }
+   ossimPointBlock block(reader->getFieldCode());
+   reader->getFileBlock(0, block, FIRST_BLOCK);
+   const double firstBlock = seconds(start);
+   const double firstResident = residentMb();
+
+   const chrono::steady_clock::time_point passStart = chrono::steady_clock::now();
+   ossim_uint32 numRead = 0;
+   while (true)
+   {
+      ossimPointBlock pass(reader->getFieldCode());
+      reader->getFileBlock(numRead, pass, PASS_BLOCK);
+      if (pass.size() == 0)
+         break;
+      numRead += pass.size();
+   }
+   const double passTime = seconds(passStart);
+   const double passResident = residentMb();
+
+   cout << setw(8) << mode << " " << setw(10) << numRead << " " << fixed << setprecision(3)
+        << setw(11) << firstBlock << " " << setprecision(1) << setw(11) << firstResident << " "
+        << setprecision(3) << setw(9) << passTime << " " << setprecision(1) << setw(10)
+        << passResident << endl;
+
+   if (reader->isStreaming())
+   {
+      // Back to the start from the end, restarting the reader each time:
+      for (int i=0; i<REWINDS; ++i)
+      {
+         ossimPointBlock last(reader->getFieldCode());
+         reader->getFileBlock(reader->getNumPoints() - 1, last, 1);
+         ossimPointBlock first(reader->getFieldCode());
+         reader->getFileBlock(0, first, 1);
+      }
+      cout << "         " << 2*REWINDS << " restarts: " << setprecision(1) << residentMb()
+           << " MB resident" << endl;
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   const int copies = (argc > 1) ? atoi(argv[1]) : 100;
+   const string input = (argc > 2) ? argv[2] : "autzen.las";
+   const ossim_uint32 chunkSize = (argc > 3) ? (ossim_uint32) atoi(argv[3]) : 100000;
+
+   ostringstream scaledName;
+   scaledName << "stream-bench-x" << copies << ".las";
+   const point_count_t numPoints = writeScaled(input, copies, scaledName.str());
+   cout << input << " x " << copies << ": " << numPoints << " points in " << scaledName.str()
+        << ", chunks of " << chunkSize << endl;
+   cout << "    mode     points  first (s)  first (MB)  pass (s)  pass (MB)" << endl;
+
+   // Streamed first, so the loaded run's memory doesn't count against it:
+   run("streamed", scaledName.str(), chunkSize);
+   run("whole", scaledName.str(), 0);
+
+   remove(scaledName.str().c_str());
+   return 0;
+}
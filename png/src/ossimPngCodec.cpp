@@ -1,9 +1,18 @@
 #include "ossimPngCodec.h"
+#include "ossimPngEncoder.h"
+#include <ossim/base/ossimBooleanProperty.h>
 #include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimNumericProperty.h>
+#include <ossim/base/ossimStringProperty.h>
 #include <png.h>
+#include <zlib.h>
 #include <cstdlib>
+#include <cstring>
 
 static const char ADD_ALPHA_CHANNEL_KW[] = "add_alpha_channel";
+static const char COMPRESSION_LEVEL_KW[] = "compression_level";
+static const char FILTER_KW[]            = "filter";
+static const char STRATEGY_KW[]          = "strategy";
 
 static void user_read_data (png_structp png_ptr, png_bytep data, png_size_t length)
 {
@@ -13,21 +22,80 @@ static void user_read_data (png_structp png_ptr, png_bytep data, png_size_t leng
    (*input_pointer) += length;
 }
 
-static void PngWriteCallback(png_structp  png_ptr, png_bytep data, png_size_t length) 
+/**
+ * Per thread encode state reused across calls: the BIP interleave buffer
+ * and the encoder with its zlib stream.
+ */
+struct ossimPngEncodeContext
 {
-   std::vector<ossim_uint8> *p = (std::vector<ossim_uint8>*)png_get_io_ptr(png_ptr);
-   p->insert(p->end(), data, data + length);
-}
- 
-struct TPngDestructor {
-   png_struct *p;
-   TPngDestructor(png_struct *p) : p(p)  {}
-   ~TPngDestructor() { if (p) {  png_destroy_write_struct(&p, NULL); } }
+   ossimPngEncoder           m_encoder;
+   std::vector<ossim_uint8>  m_buffer;
 };
 
+static ossimPngEncodeContext& getEncodeContext()
+{
+   static thread_local ossimPngEncodeContext ctx;
+   return ctx;
+}
+
+static ossim_int32 filterFromString(const ossimString& value)
+{
+   ossimString s = value.downcase();
+   if (s == "none")  return PNG_FILTER_NONE;
+   if (s == "sub")   return PNG_FILTER_SUB;
+   if (s == "up")    return PNG_FILTER_UP;
+   if (s == "avg")   return PNG_FILTER_AVG;
+   if (s == "paeth") return PNG_FILTER_PAETH;
+   if (s == "all")   return PNG_ALL_FILTERS;
+   return -1; // "default", let libpng choose.
+}
+
+static ossimString filterToString(ossim_int32 filter)
+{
+   switch (filter)
+   {
+      case PNG_FILTER_NONE:  return "none";
+      case PNG_FILTER_SUB:   return "sub";
+      case PNG_FILTER_UP:    return "up";
+      case PNG_FILTER_AVG:   return "avg";
+      case PNG_FILTER_PAETH: return "paeth";
+      case PNG_ALL_FILTERS:  return "all";
+      default:               break;
+   }
+   return "default";
+}
+
+static ossim_int32 strategyFromString(const ossimString& value)
+{
+   ossimString s = value.downcase();
+   if (s == "z_filtered")     return Z_FILTERED;
+   if (s == "z_huffman_only") return Z_HUFFMAN_ONLY;
+   if (s == "z_rle")          return Z_RLE;
+   if (s == "z_fixed")        return Z_FIXED;
+   if (s == "z_default_strategy") return Z_DEFAULT_STRATEGY;
+   return -1; // "default", let libpng choose.
+}
+
+static ossimString strategyToString(ossim_int32 strategy)
+{
+   switch (strategy)
+   {
+      case Z_FILTERED:         return "z_filtered";
+      case Z_HUFFMAN_ONLY:     return "z_huffman_only";
+      case Z_RLE:              return "z_rle";
+      case Z_FIXED:            return "z_fixed";
+      case Z_DEFAULT_STRATEGY: return "z_default_strategy";
+      default:                 break;
+   }
+   return "default";
+}
+
 ossimPngCodec::ossimPngCodec(bool addAlpha)
    :m_addAlphaChannel(addAlpha),
-    m_ext("png")
+    m_ext("png"),
+    m_compressionLevel(1),
+    m_filter(-1),
+    m_strategy(-1)
 {
 
 }
@@ -49,16 +117,19 @@ bool ossimPngCodec::encode(const ossimRefPtr<ossimImageData>& in,
    out.clear();
    ossim_int32 colorType = -1;
    ossim_int32 bitDepth = 0;
+   ossim_uint32 channels = 0;
    if(!in->getBuf()) return false;
    if(in->getNumberOfBands() == 1)
    {
       if(m_addAlphaChannel)
       {
          colorType = PNG_COLOR_TYPE_GRAY_ALPHA;
+         channels = 2;
       }
       else
       {
          colorType = PNG_COLOR_TYPE_GRAY;
+         channels = 1;
       }
    }
    else if(in->getNumberOfBands() == 3)
@@ -66,10 +137,12 @@ bool ossimPngCodec::encode(const ossimRefPtr<ossimImageData>& in,
       if(m_addAlphaChannel)
       {
          colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+         channels = 4;
       }
       else
       {
          colorType = PNG_COLOR_TYPE_RGB;
+         channels = 3;
       }
    }
    if(colorType < 0) return false;
@@ -96,149 +169,38 @@ bool ossimPngCodec::encode(const ossimRefPtr<ossimImageData>& in,
    // std::cout << "bitDepth = " << bitDepth << ", BANDS = " << in->getNumberOfBands() << std::endl;
    ossim_int32 w = in->getWidth();
    ossim_int32 h = in->getHeight();
-   png_structp p = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-   TPngDestructor destroyPng(p);
-   png_infop info_ptr = png_create_info_struct(p);
-   setjmp(png_jmpbuf(p));
+   const size_t ROW_BYTES = w * channels * (bitDepth/8);
 
-   png_set_IHDR(p, info_ptr, w, h, bitDepth,
-                colorType,
-                PNG_INTERLACE_NONE,
-                PNG_COMPRESSION_TYPE_DEFAULT,
-                PNG_FILTER_TYPE_DEFAULT);
-   png_set_compression_level(p, 1);
+   ossimPngEncodeContext& ctx = getEncodeContext();
 
-   switch(colorType)
+   //---
+   // Single band without alpha goes straight from the tile buffer; all
+   // else is interleaved into the reused context buffer.
+   //---
+   ossim_uint8* bufPtr = 0;
+   if(colorType == PNG_COLOR_TYPE_GRAY)
    {
-      case PNG_COLOR_TYPE_GRAY:
-      {
-         if(bitDepth == 8)
-         {
-            ossim_uint8* buf = (ossim_uint8*)in->getBuf();
-            std::vector<ossim_uint8*> rows(h);
-            for(ossim_int32 y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(buf + y * w) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         else if(bitDepth == 16)
-         {
-            ossim_uint16* buf = (ossim_uint16*)in->getBuf();
-            std::vector<ossim_uint8*> rows(h);
-            for(int y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(buf + y * w) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         break;
-      }
-      case PNG_COLOR_TYPE_GRAY_ALPHA:
+      bufPtr = (ossim_uint8*)in->getBuf();
+   }
+   else
+   {
+      if(ctx.m_buffer.size() < ROW_BYTES*h)
       {
-         if(bitDepth == 8)
-         {
-            std::vector<ossim_uint8> buf(w*h*2);
-            std::vector<ossim_uint8*> rows(h);
-            ossim_uint8* bufPtr = &buf.front();
-            in->unloadTileToBipAlpha(&buf.front(), in->getImageRectangle(), in->getImageRectangle());
-            for(int y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*2)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-
-         }
-         else
-         {
-            std::vector<ossim_uint16> buf(w*h*2);
-            std::vector<ossim_uint8*> rows(h);
-            ossim_uint16* bufPtr = &buf.front();
-            in->unloadTileToBipAlpha(&buf.front(), in->getImageRectangle(), in->getImageRectangle());
-            for(ossim_int32 y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*2)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-
-         break;
+         ctx.m_buffer.resize(ROW_BYTES*h);
       }
-      case PNG_COLOR_TYPE_RGB:
+      bufPtr = &ctx.m_buffer.front();
+      if(m_addAlphaChannel)
       {
-         if(bitDepth == 8)
-         {
-            std::vector<ossim_uint8> buf(w*h*3);
-            std::vector<ossim_uint8*> rows(h);
-            in->unloadTile(&buf.front(), in->getImageRectangle(), in->getImageRectangle(), OSSIM_BIP);
-            ossim_uint8* bufPtr = &buf.front();
-            for(ossim_int32 y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*3)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         else
-         {
-            std::vector<ossim_uint16> buf(w*h*3);
-            std::vector<ossim_uint8*> rows(h);
-            ossim_uint16* bufPtr = &buf.front();
-            in->unloadTile(&buf.front(), in->getImageRectangle(), in->getImageRectangle(),OSSIM_BIP);
-            for(ossim_int32 y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*3)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         break;
+         in->unloadTileToBipAlpha(bufPtr, in->getImageRectangle(), in->getImageRectangle());
       }
-      case PNG_COLOR_TYPE_RGB_ALPHA:
+      else
       {
-         if(bitDepth == 8)
-         {
-            std::vector<ossim_uint8> buf(w*h*4);
-            std::vector<ossim_uint8*> rows(h);
-            in->unloadTileToBipAlpha(&buf.front(), in->getImageRectangle(), in->getImageRectangle());
-            ossim_uint8* bufPtr = &buf.front();
-            for(int y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*4)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         else
-         {
-            std::vector<ossim_uint16> buf(w*h*4);
-            std::vector<ossim_uint8*> rows(h);
-            in->unloadTileToBipAlpha(&buf.front(), in->getImageRectangle(), in->getImageRectangle());
-            ossim_uint16* bufPtr = &buf.front();
-            for(ossim_int32 y=0; y<h;++y)
-            {
-               rows[y] = (ossim_uint8*)(bufPtr + y * (w*4)) ;    		
-            }
-            png_set_rows(p, info_ptr, &rows[0]);
-            png_set_write_fn(p, &out, PngWriteCallback, NULL);
-            png_write_png(p, info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
-         }
-         break;
+         in->unloadTile(bufPtr, in->getImageRectangle(), in->getImageRectangle(), OSSIM_BIP);
       }
    }
-
-   return true;
+   
+   return ctx.m_encoder.encode(bufPtr, w, h, bitDepth, colorType,
+                               m_compressionLevel, m_filter, m_strategy, out);
 }
 
 bool ossimPngCodec::decode(const std::vector<ossim_uint8>& in,
@@ -457,6 +419,18 @@ void ossimPngCodec::setProperty(ossimRefPtr<ossimProperty> property)
    {
       m_addAlphaChannel = property->valueToString().toBool();
    }
+   else if(property->getName() == COMPRESSION_LEVEL_KW)
+   {
+      m_compressionLevel = property->valueToString().toInt32();
+   }
+   else if(property->getName() == FILTER_KW)
+   {
+      m_filter = filterFromString(property->valueToString());
+   }
+   else if(property->getName() == STRATEGY_KW)
+   {
+      m_strategy = strategyFromString(property->valueToString());
+   }
    else
    {
       ossimCodecBase::setProperty(property);
@@ -469,7 +443,38 @@ ossimRefPtr<ossimProperty> ossimPngCodec::getProperty(const ossimString& name)co
 
    if(name == ADD_ALPHA_CHANNEL_KW)
    {
-
+      result = new ossimBooleanProperty(name, m_addAlphaChannel);
+   }
+   else if(name == COMPRESSION_LEVEL_KW)
+   {
+      result = new ossimNumericProperty(name,
+                                        ossimString::toString(m_compressionLevel),
+                                        Z_NO_COMPRESSION, Z_BEST_COMPRESSION);
+   }
+   else if(name == FILTER_KW)
+   {
+      ossimStringProperty* stringProp =
+         new ossimStringProperty(name, filterToString(m_filter), false);
+      stringProp->addConstraint(ossimString("default"));
+      stringProp->addConstraint(ossimString("none"));
+      stringProp->addConstraint(ossimString("sub"));
+      stringProp->addConstraint(ossimString("up"));
+      stringProp->addConstraint(ossimString("avg"));
+      stringProp->addConstraint(ossimString("paeth"));
+      stringProp->addConstraint(ossimString("all"));
+      result = stringProp;
+   }
+   else if(name == STRATEGY_KW)
+   {
+      ossimStringProperty* stringProp =
+         new ossimStringProperty(name, strategyToString(m_strategy), false);
+      stringProp->addConstraint(ossimString("default"));
+      stringProp->addConstraint(ossimString("z_default_strategy"));
+      stringProp->addConstraint(ossimString("z_filtered"));
+      stringProp->addConstraint(ossimString("z_huffman_only"));
+      stringProp->addConstraint(ossimString("z_rle"));
+      stringProp->addConstraint(ossimString("z_fixed"));
+      result = stringProp;
    }
    else
    {
@@ -482,6 +487,9 @@ ossimRefPtr<ossimProperty> ossimPngCodec::getProperty(const ossimString& name)co
 void ossimPngCodec::getPropertyNames(std::vector<ossimString>& propertyNames)const
 {
    propertyNames.push_back(ADD_ALPHA_CHANNEL_KW);
+   propertyNames.push_back(COMPRESSION_LEVEL_KW);
+   propertyNames.push_back(FILTER_KW);
+   propertyNames.push_back(STRATEGY_KW);
 }
 
 bool ossimPngCodec::loadState(const ossimKeywordlist& kwl, const char* prefix)
@@ -493,12 +501,31 @@ bool ossimPngCodec::loadState(const ossimKeywordlist& kwl, const char* prefix)
       m_addAlphaChannel = addAlphaChannel.toBool();
    }
 
+   ossimString value = kwl.find(prefix, COMPRESSION_LEVEL_KW);
+   if(!value.empty())
+   {
+      m_compressionLevel = value.toInt32();
+   }
+   value = kwl.find(prefix, FILTER_KW);
+   if(!value.empty())
+   {
+      m_filter = filterFromString(value);
+   }
+   value = kwl.find(prefix, STRATEGY_KW);
+   if(!value.empty())
+   {
+      m_strategy = strategyFromString(value);
+   }
+
    return ossimCodecBase::loadState(kwl, prefix);
 }
 
 bool ossimPngCodec::saveState(ossimKeywordlist& kwl, const char* prefix)const
 {
    kwl.add(prefix, ADD_ALPHA_CHANNEL_KW, m_addAlphaChannel);
+   kwl.add(prefix, COMPRESSION_LEVEL_KW, m_compressionLevel);
+   kwl.add(prefix, FILTER_KW, filterToString(m_filter).c_str());
+   kwl.add(prefix, STRATEGY_KW, strategyToString(m_strategy).c_str());
 
    return ossimCodecBase::saveState(kwl, prefix);
 }
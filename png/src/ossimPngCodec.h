@@ -16,6 +16,9 @@ public:
     *
     * type: png
     *
+    * Thread safe.  The interleave buffer and the zlib stream are kept
+    * per thread and reused on the next call (see ossimPngEncoder).
+    *
     * @param in Input data to encode.
     * 
     * @param out Encoded output data.
@@ -60,8 +63,11 @@ public:
    virtual ossimRefPtr<ossimProperty> getProperty(const ossimString& name)const; 
    
    /**
-   * Get a list of all supported property names.  Currently only "quality" property 
-   * is exposed
+   * Get a list of all supported property names:
+   * "add_alpha_channel", "compression_level" (0-9), "filter" (default,
+   * none, sub, up, avg, paeth, all) and "strategy" (default,
+   * z_default_strategy, z_filtered, z_huffman_only, z_rle, z_fixed).
+   * "filter" none with "strategy" z_rle is the fast choice for tiles.
    *
    * @param out proeprtyNames.  push the list of proeprty names to the list
    */
@@ -89,6 +95,15 @@ public:
 protected:
    bool m_addAlphaChannel;
    std::string m_ext;
+
+   /** zlib level, default 1. */
+   ossim_int32 m_compressionLevel;
+
+   /** PNG_FILTER_* mask or -1 for the libpng default. */
+   ossim_int32 m_filter;
+
+   /** zlib Z_* strategy or -1 for the libpng default. */
+   ossim_int32 m_strategy;
 };
 
 #endif
@@ -0,0 +1,458 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Line copy kernels for ossimPngReader.
+//
+//----------------------------------------------------------------------------
+
+#include "ossimPngCopyKernels.h"
+#include <atomic>
+#include <cmath>   /* for floor */
+#include <cstring> /* for memcpy */
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#  define OSSIM_PNG_SSSE3 1
+#  include <tmmintrin.h>
+#  define OSSIM_PNG_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+
+// Read by every reader thread, may be set from another.
+static std::atomic<bool> simdEnabled( ossimPngCopyKernels::simdSupported() );
+
+//---
+// Scalar code.  This is the reference; the vector code hands it any pixels
+// it does not handle itself.
+//---
+
+static inline ossim_uint8 toNative( ossim_uint8 v, bool /* swap */ )
+{
+   return v;
+}
+
+static inline ossim_uint16 toNative( ossim_uint16 v, bool swap )
+{
+   return swap ? (ossim_uint16)( ( v >> 8 ) | ( v << 8 ) ) : v;
+}
+
+template <class T>
+static void copyScalar( const T* src,
+                        ossim_uint32 first,
+                        ossim_uint32 samples,
+                        ossim_uint32 bands,
+                        bool swap,
+                        T* const* dst,
+                        ossim_uint32 dstOffset )
+{
+   const T* s = src + first * bands;
+   for ( ossim_uint32 sample = first; sample < samples; ++sample )
+   {
+      for ( ossim_uint32 band = 0; band < bands; ++band )
+      {
+         dst[band][dstOffset+sample] = toNative( *s++, swap );
+      }
+   }
+}
+
+template <class T>
+static void copyWithAlphaScalar( const T* src,
+                                 ossim_uint32 first,
+                                 ossim_uint32 last,
+                                 ossim_uint32 outputBands,
+                                 bool swap,
+                                 const ossimPngCopyKernels::AlphaParams& params,
+                                 T* const* dst,
+                                 ossim_uint32 dstOffset )
+{
+   const ossim_uint32 BANDS = outputBands + 1;
+   const T NULL_VALUE = static_cast<T>( params.m_nullPix );
+
+   for ( ossim_uint32 sample = first; sample < last; ++sample )
+   {
+      const T* p = src + sample * BANDS;
+      const ossim_uint32 dstIdx = dstOffset + sample;
+
+      ossim_float64 alpha = toNative( p[outputBands], swap );
+      alpha = alpha / params.m_denominator;
+
+      ossim_uint32 band;
+      if ( alpha == 1.0 )
+      {
+         for ( band = 0; band < outputBands; ++band )
+         {
+            dst[band][dstIdx] = toNative( p[band], swap );
+         }
+      }
+      else if ( alpha == 0.0 )
+      {
+         for ( band = 0; band < outputBands; ++band )
+         {
+            dst[band][dstIdx] = NULL_VALUE;
+         }
+      }
+      else
+      {
+         for ( band = 0; band < outputBands; ++band )
+         {
+            ossim_float64 f = toNative( p[band], swap );
+            f = f * alpha;
+            if ( f != params.m_nullPix )
+            {
+               dst[band][dstIdx] =
+                  static_cast<T>( (f>=params.m_minPix) ?
+                                  ( (f<=params.m_maxPix) ? f : params.m_maxPix ) :
+                                  params.m_minPix );
+            }
+            else
+            {
+               dst[band][dstIdx] = NULL_VALUE;
+            }
+         }
+      }
+   }
+}
+
+#ifdef OSSIM_PNG_SSSE3
+
+//---
+// SSSE3 code.  One block is 16 bytes per band, i.e. 16 pixels of 8 bit or
+// 8 pixels of 16 bit data.  Band "ch" of a block is gathered with one
+// pshufb per input register; the masks also do the byte swap.
+//---
+
+static void buildMasks( ossim_uint32 bytesPerValue,
+                        ossim_uint32 bands,
+                        bool swap,
+                        ossim_uint8 masks[4][4][16] )
+{
+   for ( ossim_uint32 ch = 0; ch < bands; ++ch )
+   {
+      for ( ossim_uint32 reg = 0; reg < bands; ++reg )
+      {
+         for ( ossim_uint32 i = 0; i < 16; ++i )
+         {
+            ossim_uint32 value = i / bytesPerValue;
+            ossim_uint32 byte  = i % bytesPerValue;
+            if ( swap )
+            {
+               byte = bytesPerValue - 1 - byte;
+            }
+            ossim_uint32 srcByte = ( value * bands + ch ) * bytesPerValue + byte;
+            masks[ch][reg][i] = ( srcByte / 16 == reg ) ?
+               (ossim_uint8)( srcByte % 16 ) : 0x80;
+         }
+      }
+   }
+}
+
+template <ossim_uint32 BANDS>
+OSSIM_PNG_TARGET_SSSE3
+static inline void loadBlock( const __m128i* in,
+                              const __m128i masks[4][4],
+                              __m128i* channels )
+{
+   __m128i v[BANDS];
+   ossim_uint32 i;
+   for ( i = 0; i < BANDS; ++i )
+   {
+      v[i] = _mm_loadu_si128( in + i );
+   }
+   for ( ossim_uint32 ch = 0; ch < BANDS; ++ch )
+   {
+      __m128i r = _mm_shuffle_epi8( v[0], masks[ch][0] );
+      for ( i = 1; i < BANDS; ++i )
+      {
+         r = _mm_or_si128( r, _mm_shuffle_epi8( v[i], masks[ch][i] ) );
+      }
+      channels[ch] = r;
+   }
+}
+
+template <class T, ossim_uint32 BANDS>
+OSSIM_PNG_TARGET_SSSE3
+static ossim_uint32 copySsse3( const T* src,
+                               ossim_uint32 samples,
+                               bool swap,
+                               T* const* dst,
+                               ossim_uint32 dstOffset )
+{
+   const ossim_uint32 PIXELS = 16 / sizeof(T);
+   const ossim_uint32 BLOCKS = samples / PIXELS;
+
+   ossim_uint8 m[4][4][16];
+   buildMasks( sizeof(T), BANDS, swap && ( sizeof(T) == 2 ), m );
+   __m128i masks[4][4];
+   for ( ossim_uint32 ch = 0; ch < BANDS; ++ch )
+   {
+      for ( ossim_uint32 reg = 0; reg < BANDS; ++reg )
+      {
+         masks[ch][reg] = _mm_loadu_si128( (const __m128i*)m[ch][reg] );
+      }
+   }
+
+   const __m128i* in = (const __m128i*)src;
+   __m128i channels[BANDS];
+   for ( ossim_uint32 block = 0; block < BLOCKS; ++block )
+   {
+      loadBlock<BANDS>( in, masks, channels );
+      in += BANDS;
+
+      const ossim_uint32 IDX = dstOffset + block * PIXELS;
+      for ( ossim_uint32 ch = 0; ch < BANDS; ++ch )
+      {
+         _mm_storeu_si128( (__m128i*)( dst[ch] + IDX ), channels[ch] );
+      }
+   }
+
+   return BLOCKS * PIXELS;
+}
+
+template <class T, ossim_uint32 BANDS>
+OSSIM_PNG_TARGET_SSSE3
+static ossim_uint32 copyWithAlphaSsse3( const T* src,
+                                        ossim_uint32 samples,
+                                        bool swap,
+                                        const ossimPngCopyKernels::AlphaParams& params,
+                                        T* const* dst,
+                                        ossim_uint32 dstOffset )
+{
+   //---
+   // Only all opaque/all transparent blocks are done here.  The compare
+   // needs the opaque value as a T, so anything else goes to scalar.
+   //---
+   const ossim_float64 MAX_T = ( sizeof(T) == 1 ) ? 255.0 : 65535.0;
+   if ( ( params.m_denominator < 1.0 ) || ( params.m_denominator > MAX_T ) ||
+        ( std::floor( params.m_denominator ) != params.m_denominator ) )
+   {
+      copyWithAlphaScalar( src, 0, samples, BANDS - 1, swap, params, dst, dstOffset );
+      return samples;
+   }
+
+   const ossim_uint32 PIXELS = 16 / sizeof(T);
+   const ossim_uint32 BLOCKS = samples / PIXELS;
+   const ossim_uint32 ALPHA  = BANDS - 1;
+
+   ossim_uint8 m[4][4][16];
+   buildMasks( sizeof(T), BANDS, swap && ( sizeof(T) == 2 ), m );
+   __m128i masks[4][4];
+   for ( ossim_uint32 ch = 0; ch < BANDS; ++ch )
+   {
+      for ( ossim_uint32 reg = 0; reg < BANDS; ++reg )
+      {
+         masks[ch][reg] = _mm_loadu_si128( (const __m128i*)m[ch][reg] );
+      }
+   }
+
+   const T OPAQUE     = static_cast<T>( params.m_denominator );
+   const T NULL_VALUE = static_cast<T>( params.m_nullPix );
+   __m128i opaque;
+   __m128i nullValue;
+   if ( sizeof(T) == 1 )
+   {
+      opaque    = _mm_set1_epi8( (char)OPAQUE );
+      nullValue = _mm_set1_epi8( (char)NULL_VALUE );
+   }
+   else
+   {
+      opaque    = _mm_set1_epi16( (short)OPAQUE );
+      nullValue = _mm_set1_epi16( (short)NULL_VALUE );
+   }
+   const __m128i zero = _mm_setzero_si128();
+
+   const __m128i* in = (const __m128i*)src;
+   __m128i channels[BANDS];
+   for ( ossim_uint32 block = 0; block < BLOCKS; ++block )
+   {
+      loadBlock<BANDS>( in, masks, channels );
+      in += BANDS;
+
+      __m128i isOpaque;
+      __m128i isClear;
+      if ( sizeof(T) == 1 )
+      {
+         isOpaque = _mm_cmpeq_epi8( channels[ALPHA], opaque );
+         isClear  = _mm_cmpeq_epi8( channels[ALPHA], zero );
+      }
+      else
+      {
+         isOpaque = _mm_cmpeq_epi16( channels[ALPHA], opaque );
+         isClear  = _mm_cmpeq_epi16( channels[ALPHA], zero );
+      }
+
+      const ossim_uint32 FIRST = block * PIXELS;
+      if ( _mm_movemask_epi8( _mm_or_si128( isOpaque, isClear ) ) == 0xffff )
+      {
+         for ( ossim_uint32 ch = 0; ch < ALPHA; ++ch )
+         {
+            __m128i r = _mm_or_si128( _mm_and_si128( isOpaque, channels[ch] ),
+                                      _mm_andnot_si128( isOpaque, nullValue ) );
+            _mm_storeu_si128( (__m128i*)( dst[ch] + dstOffset + FIRST ), r );
+         }
+      }
+      else
+      {
+         // Partial alpha somewhere in block.
+         copyWithAlphaScalar( src, FIRST, FIRST + PIXELS, ALPHA, swap,
+                              params, dst, dstOffset );
+      }
+   }
+
+   return BLOCKS * PIXELS;
+}
+
+template <class T>
+static ossim_uint32 copyVector( const T* src,
+                                ossim_uint32 samples,
+                                ossim_uint32 bands,
+                                bool swap,
+                                T* const* dst,
+                                ossim_uint32 dstOffset )
+{
+   switch ( bands )
+   {
+      case 1:
+         return copySsse3<T, 1>( src, samples, swap, dst, dstOffset );
+      case 2:
+         return copySsse3<T, 2>( src, samples, swap, dst, dstOffset );
+      case 3:
+         return copySsse3<T, 3>( src, samples, swap, dst, dstOffset );
+      case 4:
+         return copySsse3<T, 4>( src, samples, swap, dst, dstOffset );
+      default:
+         break;
+   }
+   return 0;
+}
+
+template <class T>
+static ossim_uint32 copyWithAlphaVector( const T* src,
+                                         ossim_uint32 samples,
+                                         ossim_uint32 outputBands,
+                                         bool swap,
+                                         const ossimPngCopyKernels::AlphaParams& params,
+                                         T* const* dst,
+                                         ossim_uint32 dstOffset )
+{
+   switch ( outputBands )
+   {
+      case 1:
+         return copyWithAlphaSsse3<T, 2>( src, samples, swap, params, dst, dstOffset );
+      case 3:
+         return copyWithAlphaSsse3<T, 4>( src, samples, swap, params, dst, dstOffset );
+      default:
+         break;
+   }
+   return 0;
+}
+
+#else /* #ifdef OSSIM_PNG_SSSE3 */
+
+template <class T>
+static ossim_uint32 copyVector( const T*, ossim_uint32, ossim_uint32, bool,
+                                T* const*, ossim_uint32 )
+{
+   return 0;
+}
+
+template <class T>
+static ossim_uint32 copyWithAlphaVector( const T*, ossim_uint32, ossim_uint32, bool,
+                                         const ossimPngCopyKernels::AlphaParams&,
+                                         T* const*, ossim_uint32 )
+{
+   return 0;
+}
+
+#endif /* #ifdef OSSIM_PNG_SSSE3 */
+
+void ossimPngCopyKernels::copyLine( const ossim_uint8* src,
+                                    ossim_uint32 samples,
+                                    ossim_uint32 bands,
+                                    bool /* swap */,
+                                    ossim_uint8* const* dst,
+                                    ossim_uint32 dstOffset )
+{
+   if ( bands == 1 )
+   {
+      memcpy( dst[0] + dstOffset, src, samples );
+      return;
+   }
+
+   ossim_uint32 done = 0;
+   if ( simdEnabled )
+   {
+      done = copyVector( src, samples, bands, false, dst, dstOffset );
+   }
+   copyScalar( src, done, samples, bands, false, dst, dstOffset );
+}
+
+void ossimPngCopyKernels::copyLine( const ossim_uint16* src,
+                                    ossim_uint32 samples,
+                                    ossim_uint32 bands,
+                                    bool swap,
+                                    ossim_uint16* const* dst,
+                                    ossim_uint32 dstOffset )
+{
+   ossim_uint32 done = 0;
+   if ( simdEnabled )
+   {
+      done = copyVector( src, samples, bands, swap, dst, dstOffset );
+   }
+   copyScalar( src, done, samples, bands, swap, dst, dstOffset );
+}
+
+void ossimPngCopyKernels::copyLineWithAlpha( const ossim_uint8* src,
+                                             ossim_uint32 samples,
+                                             ossim_uint32 outputBands,
+                                             bool /* swap */,
+                                             const AlphaParams& params,
+                                             ossim_uint8* const* dst,
+                                             ossim_uint32 dstOffset )
+{
+   ossim_uint32 done = 0;
+   if ( simdEnabled )
+   {
+      done = copyWithAlphaVector( src, samples, outputBands, false,
+                                  params, dst, dstOffset );
+   }
+   copyWithAlphaScalar( src, done, samples, outputBands, false,
+                        params, dst, dstOffset );
+}
+
+void ossimPngCopyKernels::copyLineWithAlpha( const ossim_uint16* src,
+                                             ossim_uint32 samples,
+                                             ossim_uint32 outputBands,
+                                             bool swap,
+                                             const AlphaParams& params,
+                                             ossim_uint16* const* dst,
+                                             ossim_uint32 dstOffset )
+{
+   ossim_uint32 done = 0;
+   if ( simdEnabled )
+   {
+      done = copyWithAlphaVector( src, samples, outputBands, swap,
+                                  params, dst, dstOffset );
+   }
+   copyWithAlphaScalar( src, done, samples, outputBands, swap,
+                        params, dst, dstOffset );
+}
+
+bool ossimPngCopyKernels::simdSupported()
+{
+#ifdef OSSIM_PNG_SSSE3
+   return __builtin_cpu_supports( "ssse3" );
+#else
+   return false;
+#endif
+}
+
+void ossimPngCopyKernels::setSimdEnabled( bool flag )
+{
+   simdEnabled = flag && simdSupported();
+}
+
+bool ossimPngCopyKernels::getSimdEnabled()
+{
+   return simdEnabled;
+}
@@ -0,0 +1,100 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Line copy kernels for ossimPngReader.
+//
+// Splits one band interleaved by pixel (BIP) png row into band separate
+// tile buffers, swapping 16 bit samples to native order on the way, and
+// optionally burns the alpha channel into the other bands.  On x86 an
+// SSSE3 version is picked at run time when the cpu has it; the scalar
+// code is used otherwise and is the reference for the results.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPngCopyKernels_HEADER
+#define ossimPngCopyKernels_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+
+class ossimPngCopyKernels
+{
+public:
+
+   /** Values used to burn alpha into the other bands. */
+   struct AlphaParams
+   {
+      ossim_float64 m_denominator; // Max alpha value, i.e. fully opaque.
+      ossim_float64 m_minPix;
+      ossim_float64 m_maxPix;
+      ossim_float64 m_nullPix;
+   };
+
+   /**
+    * @brief Copies one BIP row to band separate buffers.
+    * @param src Row of samples * bands values.
+    * @param samples Pixels in row.
+    * @param bands Bands in row, also number of dst buffers.
+    * @param swap If true 16 bit values are byte swapped.  Ignored for 8 bit.
+    * @param dst Band buffers.
+    * @param dstOffset Index in each band buffer for the first pixel.
+    */
+   static void copyLine( const ossim_uint8* src,
+                         ossim_uint32 samples,
+                         ossim_uint32 bands,
+                         bool swap,
+                         ossim_uint8* const* dst,
+                         ossim_uint32 dstOffset );
+   static void copyLine( const ossim_uint16* src,
+                         ossim_uint32 samples,
+                         ossim_uint32 bands,
+                         bool swap,
+                         ossim_uint16* const* dst,
+                         ossim_uint32 dstOffset );
+
+   /**
+    * @brief Copies one BIP row where the last band is alpha to outputBands
+    * band separate buffers.
+    *
+    * Opaque pixels are copied, transparent pixels set to null and all
+    * others scaled by alpha/denominator and clamped to min/max.
+    *
+    * @param src Row of samples * (outputBands+1) values.
+    * @param samples Pixels in row.
+    * @param outputBands Bands not counting alpha.
+    * @param swap If true 16 bit values are byte swapped.  Ignored for 8 bit.
+    * @param params Alpha scaling and pixel range.
+    * @param dst Band buffers.
+    * @param dstOffset Index in each band buffer for the first pixel.
+    */
+   static void copyLineWithAlpha( const ossim_uint8* src,
+                                  ossim_uint32 samples,
+                                  ossim_uint32 outputBands,
+                                  bool swap,
+                                  const AlphaParams& params,
+                                  ossim_uint8* const* dst,
+                                  ossim_uint32 dstOffset );
+   static void copyLineWithAlpha( const ossim_uint16* src,
+                                  ossim_uint32 samples,
+                                  ossim_uint32 outputBands,
+                                  bool swap,
+                                  const AlphaParams& params,
+                                  ossim_uint16* const* dst,
+                                  ossim_uint32 dstOffset );
+
+   /** @return true if the cpu supports the vector kernels. */
+   static bool simdSupported();
+
+   /**
+    * @brief Turns the vector kernels on or off.  They are on by default
+    * when supported.  Turning off forces the scalar code, e.g. to compare
+    * results.
+    */
+   static void setSimdEnabled( bool flag );
+
+   /** @return true if the vector kernels are in use. */
+   static bool getSimdEnabled();
+};
+
+#endif /* #ifndef ossimPngCopyKernels_HEADER */
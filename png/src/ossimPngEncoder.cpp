@@ -0,0 +1,237 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Reusable in-memory PNG encoder for ossimPngCodec.
+//
+//----------------------------------------------------------------------------
+
+#include "ossimPngEncoder.h"
+#include <png.h>
+#include <cstring>
+
+static const ossim_uint8 PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+// Largest chunk length the format allows.
+static const size_t MAX_CHUNK_SIZE = 0x7fffffff;
+
+static inline void putUint32( ossim_uint8* p, ossim_uint32 v )
+{
+   p[0] = (ossim_uint8)( v >> 24 );
+   p[1] = (ossim_uint8)( v >> 16 );
+   p[2] = (ossim_uint8)( v >> 8 );
+   p[3] = (ossim_uint8)( v );
+}
+
+ossimPngEncoder::ossimPngEncoder()
+   :
+   m_zstream(),
+   m_zstreamInitialized( false ),
+   m_level( 0 ),
+   m_strategy( 0 ),
+   m_filter(),
+   m_row(),
+   m_lastOutputSize( 0 )
+{
+   memset( &m_zstream, 0, sizeof(z_stream) );
+}
+
+ossimPngEncoder::~ossimPngEncoder()
+{
+   if ( m_zstreamInitialized )
+   {
+      deflateEnd( &m_zstream );
+      m_zstreamInitialized = false;
+   }
+}
+
+bool ossimPngEncoder::encode( const ossim_uint8* buf,
+                              ossim_uint32 width,
+                              ossim_uint32 height,
+                              ossim_int32 bitDepth,
+                              ossim_int32 colorType,
+                              ossim_int32 compressionLevel,
+                              ossim_int32 filters,
+                              ossim_int32 strategy,
+                              std::vector<ossim_uint8>& out )
+{
+   out.clear();
+
+   ossim_uint32 channels = 0;
+   switch ( colorType )
+   {
+      case PNG_COLOR_TYPE_GRAY:       channels = 1; break;
+      case PNG_COLOR_TYPE_GRAY_ALPHA: channels = 2; break;
+      case PNG_COLOR_TYPE_RGB:        channels = 3; break;
+      case PNG_COLOR_TYPE_RGB_ALPHA:  channels = 4; break;
+      default:                        break;
+   }
+   if ( !buf || !channels || ( ( bitDepth != 8 ) && ( bitDepth != 16 ) ) ||
+        !width || !height || ( width > MAX_CHUNK_SIZE ) || ( height > MAX_CHUNK_SIZE ) )
+   {
+      return false;
+   }
+
+   const ossim_uint32 BPP = channels * bitDepth / 8;
+   const size_t ROW_BYTES = (size_t)width * BPP;
+   if ( ROW_BYTES >= MAX_CHUNK_SIZE )
+   {
+      return false;
+   }
+
+   if ( filters < 0 )
+   {
+      filters = PNG_ALL_FILTERS;
+   }
+   if ( strategy < 0 )
+   {
+      // What libpng picks when the caller does not.
+      strategy = ( ( filters & PNG_ALL_FILTERS ) == PNG_FILTER_NONE ) ?
+         Z_DEFAULT_STRATEGY : Z_FILTERED;
+   }
+   if ( startDeflate( compressionLevel, strategy ) == false )
+   {
+      return false;
+   }
+
+   m_filter.reset( filters, BPP, (ossim_uint32)ROW_BYTES, height );
+   m_row.resize( ROW_BYTES + 1 );
+
+   // Size the output from the last image so it rarely grows.
+   out.reserve( m_lastOutputSize ?
+                ( m_lastOutputSize + m_lastOutputSize / 2 ) :
+                ( ROW_BYTES * height / 2 + 1024 ) );
+
+   out.insert( out.end(), PNG_SIGNATURE, PNG_SIGNATURE + 8 );
+
+   ossim_uint8 ihdr[13];
+   putUint32( ihdr, width );
+   putUint32( ihdr + 4, height );
+   ihdr[8]  = (ossim_uint8)bitDepth;
+   ihdr[9]  = (ossim_uint8)colorType;
+   ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+   ihdr[11] = PNG_FILTER_TYPE_BASE;
+   ihdr[12] = PNG_INTERLACE_NONE;
+   writeChunk( "IHDR", ihdr, 13, out );
+
+   // IDAT length and type are filled in once the data size is known.
+   const size_t IDAT_START = out.size();
+   size_t used = IDAT_START + 8;
+   out.resize( out.capacity() > used ? out.capacity() : used + 1024 );
+
+   bool status = true;
+   int ret = Z_OK;
+   for ( ossim_uint32 y = 0; ( y < height ) && status; ++y )
+   {
+      m_filter.filterRow( buf + y * ROW_BYTES, &m_row.front() );
+
+      const int FLUSH = ( y + 1 == height ) ? Z_FINISH : Z_NO_FLUSH;
+      m_zstream.next_in  = &m_row.front();
+      m_zstream.avail_in = (uInt)m_row.size();
+
+      do
+      {
+         if ( used == out.size() )
+         {
+            out.resize( out.size() * 2 );
+         }
+         m_zstream.next_out  = &out[used];
+         m_zstream.avail_out = (uInt)( out.size() - used );
+
+         ret = deflate( &m_zstream, FLUSH );
+
+         used = m_zstream.next_out - &out.front();
+         if ( ( ret != Z_OK ) && ( ret != Z_STREAM_END ) && ( ret != Z_BUF_ERROR ) )
+         {
+            status = false;
+         }
+      } while ( status && ( m_zstream.avail_in || ( m_zstream.avail_out == 0 ) ||
+                            ( ( FLUSH == Z_FINISH ) && ( ret != Z_STREAM_END ) ) ) );
+   }
+
+   const size_t IDAT_SIZE = used - IDAT_START - 8;
+   if ( status && ( IDAT_SIZE <= MAX_CHUNK_SIZE ) )
+   {
+      putUint32( &out[IDAT_START], (ossim_uint32)IDAT_SIZE );
+      memcpy( &out[IDAT_START + 4], "IDAT", 4 );
+      uLong crc = crc32( 0L, &out[IDAT_START + 4], (uInt)( IDAT_SIZE + 4 ) );
+      out.resize( used );
+
+      ossim_uint8 crcBytes[4];
+      putUint32( crcBytes, (ossim_uint32)crc );
+      out.insert( out.end(), crcBytes, crcBytes + 4 );
+
+      writeChunk( "IEND", 0, 0, out );
+
+      m_lastOutputSize = out.size();
+   }
+   else
+   {
+      out.clear();
+      status = false;
+
+      // Leave the stream mid image; startDeflate resets it next time.
+   }
+
+   return status;
+}
+
+bool ossimPngEncoder::startDeflate( ossim_int32 level, ossim_int32 strategy )
+{
+   if ( m_zstreamInitialized )
+   {
+      if ( deflateReset( &m_zstream ) != Z_OK )
+      {
+         deflateEnd( &m_zstream );
+         m_zstreamInitialized = false;
+      }
+      else if ( ( level != m_level ) || ( strategy != m_strategy ) )
+      {
+         // Nothing compressed since the reset so this cannot flush.
+         if ( deflateParams( &m_zstream, level, strategy ) != Z_OK )
+         {
+            deflateEnd( &m_zstream );
+            m_zstreamInitialized = false;
+         }
+      }
+   }
+
+   if ( !m_zstreamInitialized )
+   {
+      memset( &m_zstream, 0, sizeof(z_stream) );
+      m_zstreamInitialized =
+         ( deflateInit2( &m_zstream, level, Z_DEFLATED, 15, 8, strategy ) == Z_OK );
+   }
+
+   if ( m_zstreamInitialized )
+   {
+      m_level    = level;
+      m_strategy = strategy;
+   }
+
+   return m_zstreamInitialized;
+}
+
+void ossimPngEncoder::writeChunk( const char* type,
+                                  const ossim_uint8* data,
+                                  ossim_uint32 size,
+                                  std::vector<ossim_uint8>& out )
+{
+   ossim_uint8 head[8];
+   putUint32( head, size );
+   memcpy( head + 4, type, 4 );
+   out.insert( out.end(), head, head + 8 );
+
+   uLong crc = crc32( 0L, head + 4, 4 );
+   if ( size )
+   {
+      out.insert( out.end(), data, data + size );
+      crc = crc32( crc, data, size );
+   }
+
+   ossim_uint8 crcBytes[4];
+   putUint32( crcBytes, (ossim_uint32)crc );
+   out.insert( out.end(), crcBytes, crcBytes + 4 );
+}
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Reusable in-memory PNG encoder for ossimPngCodec.
+//
+// Writes the signature, IHDR, one IDAT and IEND straight into the caller's
+// vector.  libpng cannot reset a png_struct for another image, so rows are
+// filtered and deflated here instead, and the z_stream is kept between
+// images and restarted with deflateReset rather than set up again.  One
+// instance per thread.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPngEncoder_HEADER
+#define ossimPngEncoder_HEADER 1
+
+#include "ossimPngRowFilter.h"
+#include <ossim/base/ossimConstants.h>
+#include <zlib.h>
+#include <vector>
+
+class ossimPngEncoder
+{
+public:
+
+   /** default constructor */
+   ossimPngEncoder();
+
+   /** destructor, frees the zlib state */
+   ~ossimPngEncoder();
+
+   /**
+    * @brief Encodes one non-interlaced 8 or 16 bit gray, gray alpha, rgb or
+    * rgba image.
+    *
+    * @param buf Pixels interleaved by pixel, rows packed.  Samples are
+    * written in buffer byte order.
+    * @param width Width in pixels.
+    * @param height Height in lines.
+    * @param bitDepth 8 or 16.
+    * @param colorType PNG_COLOR_TYPE_GRAY, GRAY_ALPHA, RGB or RGB_ALPHA.
+    * @param compressionLevel zlib level 0 to 9.
+    * @param filters PNG_FILTER_* mask, or -1 for the libpng default
+    * (PNG_ALL_FILTERS).
+    * @param strategy zlib Z_* strategy, or -1 for the libpng default
+    * (Z_FILTERED if rows are filtered, else Z_DEFAULT_STRATEGY).
+    * @param out Initialized to the encoded file.
+    * @return true on success, false on bad arguments or zlib error.
+    */
+   bool encode( const ossim_uint8* buf,
+                ossim_uint32 width,
+                ossim_uint32 height,
+                ossim_int32 bitDepth,
+                ossim_int32 colorType,
+                ossim_int32 compressionLevel,
+                ossim_int32 filters,
+                ossim_int32 strategy,
+                std::vector<ossim_uint8>& out );
+
+private:
+
+   /** @brief Sets up or resets m_zstream for level and strategy. */
+   bool startDeflate( ossim_int32 level, ossim_int32 strategy );
+
+   /** @brief Appends a complete chunk to out. */
+   static void writeChunk( const char* type,
+                           const ossim_uint8* data,
+                           ossim_uint32 size,
+                           std::vector<ossim_uint8>& out );
+
+   z_stream                  m_zstream;
+   bool                      m_zstreamInitialized;
+   ossim_int32               m_level;
+   ossim_int32               m_strategy;
+
+   ossimPngRowFilter         m_filter;
+   std::vector<ossim_uint8>  m_row;             // Filter byte + row.
+   size_t                    m_lastOutputSize;
+};
+
+#endif /* #ifndef ossimPngEncoder_HEADER */
@@ -0,0 +1,248 @@
+//----------------------------------------------------------------------------
+//
+// License:  See top level LICENSE.txt file
+//
+// Description: Multi-threaded IDAT writer for ossimPngWriter.
+//
+//----------------------------------------------------------------------------
+
+#include "ossimPngParallelDeflater.h"
+#include <cstring>
+#include <ostream>
+#include <system_error>
+
+// Uncompressed bytes per deflate job, rounded up to whole rows.
+static const size_t MIN_CHUNK_SIZE = 512 * 1024;
+
+// Deflate window size; the dictionary carried between jobs.
+static const size_t WINDOW_SIZE = 32768;
+
+static inline void putUint32( ossim_uint8* p, ossim_uint32 v )
+{
+   p[0] = (ossim_uint8)( v >> 24 );
+   p[1] = (ossim_uint8)( v >> 16 );
+   p[2] = (ossim_uint8)( v >> 8 );
+   p[3] = (ossim_uint8)( v );
+}
+
+ossimPngParallelDeflater::ossimPngParallelDeflater( std::ostream* str,
+                                                    ossim_int32 compressionLevel,
+                                                    ossim_int32 strategy,
+                                                    ossim_int32 filters,
+                                                    ossim_uint32 bytesPerPixel,
+                                                    ossim_uint32 rowBytes,
+                                                    ossim_uint32 rows,
+                                                    ossim_uint32 threads )
+   :
+   m_str( str ),
+   m_level( compressionLevel ),
+   m_strategy( strategy ),
+   m_rowBytes( rowBytes ),
+   m_threads( threads ? threads : 1 ),
+   m_chunkSize( 0 ),
+   m_filter(),
+   m_pending(),
+   m_window(),
+   m_jobs(),
+   m_adler( adler32( 0L, Z_NULL, 0 ) ),
+   m_headerWritten( false )
+{
+   m_filter.reset( filters, bytesPerPixel, rowBytes, rows );
+   size_t rowsPerChunk = MIN_CHUNK_SIZE / ( m_rowBytes + 1 ) + 1;
+   m_chunkSize = rowsPerChunk * ( m_rowBytes + 1 );
+   m_pending.reserve( m_chunkSize );
+}
+
+ossimPngParallelDeflater::~ossimPngParallelDeflater()
+{
+   // Jobs hold pointers into themselves; let them finish before freeing.
+   while ( m_jobs.size() )
+   {
+      m_jobs.front().second.wait();
+      m_jobs.pop_front();
+   }
+}
+
+bool ossimPngParallelDeflater::addRows( const ossim_uint8* rows, ossim_uint32 count )
+{
+   bool status = true;
+   for ( ossim_uint32 row = 0; ( row < count ) && status; ++row )
+   {
+      size_t offset = m_pending.size();
+      m_pending.resize( offset + m_rowBytes + 1 );
+      m_filter.filterRow( rows + row * m_rowBytes, &m_pending[offset] );
+
+      if ( m_pending.size() >= m_chunkSize )
+      {
+         status = submit( false );
+      }
+   }
+   return status;
+}
+
+bool ossimPngParallelDeflater::finish()
+{
+   bool status = submit( true );
+   while ( status && m_jobs.size() )
+   {
+      status = writeOldest();
+   }
+   return status;
+}
+
+bool ossimPngParallelDeflater::submit( bool last )
+{
+   bool status = true;
+
+   // Bound the number of chunks in flight.
+   while ( status && ( m_jobs.size() >= m_threads ) )
+   {
+      status = writeOldest();
+   }
+
+   if ( status )
+   {
+      std::unique_ptr<Job> job( new Job() );
+      job->m_input.swap( m_pending );
+      job->m_dictionary = m_window;
+      job->m_adler  = 0;
+      job->m_last   = last;
+      job->m_status = false;
+
+      if ( !m_headerWritten )
+      {
+         // zlib header, FLEVEL set the way deflateInit would.
+         ossim_uint32 flevel = 2;
+         if ( ( m_strategy >= Z_HUFFMAN_ONLY ) || ( ( m_level >= 0 ) && ( m_level < 2 ) ) )
+         {
+            flevel = 0;
+         }
+         else if ( ( m_level >= 0 ) && ( m_level < 6 ) )
+         {
+            flevel = 1;
+         }
+         else if ( m_level > 6 )
+         {
+            flevel = 3;
+         }
+         ossim_uint32 head = 0x7800 | ( flevel << 6 );
+         head += 31 - ( head % 31 );
+         job->m_output.push_back( (ossim_uint8)( head >> 8 ) );
+         job->m_output.push_back( (ossim_uint8)( head & 0xff ) );
+         m_headerWritten = true;
+      }
+
+      // Keep the last 32k for the next job's dictionary.
+      m_window.insert( m_window.end(), job->m_input.begin(), job->m_input.end() );
+      if ( m_window.size() > WINDOW_SIZE )
+      {
+         m_window.erase( m_window.begin(), m_window.end() - WINDOW_SIZE );
+      }
+
+      m_pending.reserve( m_chunkSize );
+
+      try
+      {
+         std::future<void> done = std::async( std::launch::async,
+                                              &ossimPngParallelDeflater::deflateJob,
+                                              job.get(), m_level, m_strategy );
+         m_jobs.push_back( std::make_pair( std::move( job ), std::move( done ) ) );
+      }
+      catch ( const std::system_error& )
+      {
+         status = false; // No thread for it.
+      }
+   }
+
+   return status;
+}
+
+bool ossimPngParallelDeflater::writeOldest()
+{
+   m_jobs.front().second.wait();
+   std::unique_ptr<Job> job( std::move( m_jobs.front().first ) );
+   m_jobs.pop_front();
+
+   bool status = job->m_status;
+   if ( status )
+   {
+      m_adler = adler32_combine( m_adler, job->m_adler, (z_off_t)job->m_input.size() );
+
+      if ( job->m_last )
+      {
+         ossim_uint8 trailer[4];
+         putUint32( trailer, (ossim_uint32)m_adler );
+         job->m_output.insert( job->m_output.end(), trailer, trailer + 4 );
+      }
+
+      if ( job->m_output.size() )
+      {
+         status = writeIdat( job->m_output );
+      }
+   }
+
+   return status;
+}
+
+bool ossimPngParallelDeflater::writeIdat( const std::vector<ossim_uint8>& data )
+{
+   ossim_uint8 head[8];
+   putUint32( head, (ossim_uint32)data.size() );
+   memcpy( head + 4, "IDAT", 4 );
+
+   uLong crc = crc32( 0L, head + 4, 4 );
+   crc = crc32( crc, &data.front(), (uInt)data.size() );
+   ossim_uint8 tail[4];
+   putUint32( tail, (ossim_uint32)crc );
+
+   m_str->write( (const char*)head, 8 );
+   m_str->write( (const char*)&data.front(), data.size() );
+   m_str->write( (const char*)tail, 4 );
+
+   return m_str->good();
+}
+
+void ossimPngParallelDeflater::deflateJob( Job* job, ossim_int32 level, ossim_int32 strategy )
+{
+   z_stream z;
+   memset( &z, 0, sizeof(z_stream) );
+
+   // Raw deflate; header and trailer are written by the caller.
+   if ( deflateInit2( &z, level, Z_DEFLATED, -15, 8, strategy ) != Z_OK )
+   {
+      return;
+   }
+
+   if ( job->m_dictionary.size() )
+   {
+      deflateSetDictionary( &z, &job->m_dictionary.front(),
+                            (uInt)job->m_dictionary.size() );
+   }
+
+   size_t offset = job->m_output.size();
+   job->m_output.resize( offset + deflateBound( &z, job->m_input.size() ) + 64 );
+
+   z.next_in   = job->m_input.size() ? &job->m_input.front() : Z_NULL;
+   z.avail_in  = (uInt)job->m_input.size();
+   z.next_out  = &job->m_output[offset];
+   z.avail_out = (uInt)( job->m_output.size() - offset );
+
+   int ret = deflate( &z, job->m_last ? Z_FINISH : Z_SYNC_FLUSH );
+
+   if ( job->m_last )
+   {
+      job->m_status = ( ret == Z_STREAM_END );
+   }
+   else
+   {
+      // Output space left means the flush completed.
+      job->m_status = ( ret == Z_OK ) && ( z.avail_in == 0 ) && ( z.avail_out != 0 );
+   }
+
+   job->m_output.resize( offset + z.total_out );
+   deflateEnd( &z );
+
+   job->m_adler = adler32( adler32( 0L, Z_NULL, 0 ),
+                           job->m_input.size() ? &job->m_input.front() : Z_NULL,
+                           (uInt)job->m_input.size() );
+}
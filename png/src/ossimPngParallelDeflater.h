@@ -0,0 +1,115 @@
+//----------------------------------------------------------------------------
+//
+// License:  See top level LICENSE.txt file
+//
+// Description: Multi-threaded IDAT writer for ossimPngWriter.
+//
+// Rows are filtered on the calling thread and cut into chunks.  Each chunk
+// is raw deflated on its own thread, primed with the last 32k of the
+// previous chunk as dictionary and ended with Z_SYNC_FLUSH so the outputs
+// concatenate into one zlib stream (same scheme as pigz).  The zlib header
+// and combined Adler-32 trailer are added here and the result is written
+// to the stream as IDAT chunks, in order.  libpng is never called, so no
+// libpng error can longjmp out of this class.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPngParallelDeflater_HEADER
+#define ossimPngParallelDeflater_HEADER 1
+
+#include "ossimPngRowFilter.h"
+#include <ossim/base/ossimConstants.h>
+#include <zlib.h>
+#include <deque>
+#include <future>
+#include <iosfwd>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class ossimPngParallelDeflater
+{
+public:
+
+   /**
+    * @param str Stream the png is written to.  Everything up to the first
+    * IDAT (png_write_info) must have been written.
+    * @param compressionLevel zlib level.
+    * @param strategy zlib strategy.
+    * @param filters PNG_FILTER_* mask as passed to png_set_filter, e.g.
+    * PNG_FILTER_NONE for palette images.
+    * @param bytesPerPixel Bytes in one complete pixel, used by filters.
+    * @param rowBytes Bytes in one row, not including the filter byte.
+    * @param rows Rows in the image.
+    * @param threads Number of deflate threads.
+    */
+   ossimPngParallelDeflater( std::ostream* str,
+                             ossim_int32 compressionLevel,
+                             ossim_int32 strategy,
+                             ossim_int32 filters,
+                             ossim_uint32 bytesPerPixel,
+                             ossim_uint32 rowBytes,
+                             ossim_uint32 rows,
+                             ossim_uint32 threads );
+
+   /** Waits for any outstanding jobs.  Nothing more is written. */
+   ~ossimPngParallelDeflater();
+
+   /**
+    * @brief Filters and queues rows for compression.  Writes any finished
+    * chunks.
+    * @param rows Rows packed rowBytes apart, in file byte order.
+    * @param count Number of rows.
+    * @return true on success, false on deflate or stream error.
+    */
+   bool addRows( const ossim_uint8* rows, ossim_uint32 count );
+
+   /**
+    * @brief Compresses the remaining rows as the final block, writes
+    * all IDAT data including the Adler-32 trailer.  The caller writes IEND.
+    * @return true on success, false on deflate or stream error.
+    */
+   bool finish();
+
+private:
+
+   /** One chunk of filtered rows and its compressed output. */
+   struct Job
+   {
+      std::vector<ossim_uint8> m_input;
+      std::vector<ossim_uint8> m_dictionary;
+      std::vector<ossim_uint8> m_output;
+      uLong                    m_adler;
+      bool                     m_last;
+      bool                     m_status;
+   };
+
+   /** @brief Deflates job->m_input into job->m_output.  Worker thread. */
+   static void deflateJob( Job* job, ossim_int32 level, ossim_int32 strategy );
+
+   /** @brief Queues m_pending as a job. */
+   bool submit( bool last );
+
+   /** @brief Waits for the oldest job and writes its output. */
+   bool writeOldest();
+
+   /** @brief Writes one IDAT chunk to m_str. */
+   bool writeIdat( const std::vector<ossim_uint8>& data );
+
+   std::ostream* m_str;
+   ossim_int32   m_level;
+   ossim_int32   m_strategy;
+   ossim_uint32  m_rowBytes;
+   ossim_uint32  m_threads;
+   size_t        m_chunkSize;
+
+   ossimPngRowFilter        m_filter;
+   std::vector<ossim_uint8> m_pending;  // Filtered rows not yet queued.
+   std::vector<ossim_uint8> m_window;   // Last 32k queued, next dictionary.
+
+   std::deque< std::pair< std::unique_ptr<Job>, std::future<void> > > m_jobs;
+
+   uLong m_adler;
+   bool  m_headerWritten;
+};
+
+#endif /* #ifndef ossimPngParallelDeflater_HEADER */
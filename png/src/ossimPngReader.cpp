@@ -13,14 +13,16 @@
 
 
 #include "ossimPngReader.h"
+#include "ossimPngCopyKernels.h"
+#include "ossimPngRowReader.h"
 #include <ossim/base/ossimBooleanProperty.h>
 #include <ossim/base/ossimConstants.h>
-#include <ossim/base/ossimEndian.h>
 #include <ossim/base/ossimIoStream.h>
 #include <ossim/base/ossimIpt.h>
 #include <ossim/base/ossimIrect.h>
 #include <ossim/base/ossimKeywordlist.h>
 #include <ossim/base/ossimNotifyContext.h>
+#include <ossim/base/ossimPreferences.h>
 #include <ossim/base/ossimProperty.h>
 #include <ossim/base/ossimStreamFactoryRegistry.h>
 #include <ossim/base/ossimTrace.h>
@@ -30,11 +32,18 @@
 
 #include <cstddef> /* for NULL */
 #include <cmath>   /* for pow */
+#include <cstring> /* for memset */
 #include <fstream>
 
 // If true alpha channel is passed as a layer.
 static const std::string USE_ALPHA_KW = "use_alpha"; // boolean
 
+//---
+// Rows between zlib checkpoints for random access.  Defaults to the cache
+// tile height.  0 disables and falls back to restarting libpng.
+//---
+static const char CHECKPOINT_ROWS_KW[] = "png_reader_checkpoint_rows";
+
 RTTI_DEF1(ossimPngReader, "ossimPngReader", ossimImageHandler)
 
 #ifdef OSSIM_ID_ENABLED
@@ -50,6 +59,7 @@ ossimPngReader::ossimPngReader()
    m_cacheTile(0),
    m_lineBuffer(0),
    m_lineBufferSizeInBytes(0),
+   m_rowReader(0),
    m_str(0),
    m_bufferRect(0, 0, 0, 0),
    m_imageRect(0, 0, 0, 0),
@@ -110,6 +120,12 @@ void ossimPngReader::destroy()
       m_lineBuffer = 0;
    }
 
+   if (m_rowReader)
+   {
+      delete m_rowReader;
+      m_rowReader = 0;
+   }
+
    if (m_pngReadPtr)
    {
       png_destroy_read_struct(&m_pngReadPtr, &m_pngReadInfoPtr, NULL);
@@ -149,6 +165,30 @@ void ossimPngReader::allocate()
    }
    m_lineBuffer = new ossim_uint8[m_lineBufferSizeInBytes];
 
+   // Random access row reader:
+   if (m_rowReader)
+   {
+      delete m_rowReader;
+      m_rowReader = 0;
+   }
+   ossim_uint32 checkpointRows = static_cast<ossim_uint32>(m_cacheSize.y);
+   const char* lookup = ossimPreferences::instance()->findPreference(CHECKPOINT_ROWS_KW);
+   if (lookup)
+   {
+      checkpointRows = ossimString::toUInt32(lookup);
+   }
+   if ( checkpointRows && (m_interlacePasses == 1) )
+   {
+      m_rowReader = new ossimPngRowReader();
+      if ( !m_rowReader->open(m_str, checkpointRows) ||
+           (m_rowReader->getRowBytes() != m_lineBufferSizeInBytes) )
+      {
+         // Layout needs libpng transforms.
+         delete m_rowReader;
+         m_rowReader = 0;
+      }
+   }
+
    if (traceDebug())
    {
       ossimNotify(ossimNotifyLevel_DEBUG)
@@ -160,6 +200,7 @@ void ossimPngReader::allocate()
          << "\nimage height:              " << m_imageRect.height()
          << "\nnumber of bands:           " << m_numberOfOutputBands
          << "\nline buffer size:          " << m_lineBufferSizeInBytes
+         << "\nrandom access row reader:  " << (m_rowReader?"on":"off")
          << endl;
    }
 }
@@ -307,7 +348,25 @@ void ossimPngReader::fillTile(const ossimIrect& clip_rect,
             m_cacheTile->makeBlank();
          }
 
-         if (startLine < m_currentRow)
+         if (m_rowReader)
+         {
+            // Jump to the nearest checkpoint if it beats reading forward.
+            if ( m_rowReader->seek(startLine) )
+            {
+               m_currentRow = m_rowReader->getCurrentRow();
+            }
+            else
+            {
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << "ossimPngReader::fillTile WARN! Seek to line "
+                  << startLine << " failed for " << theImageFile
+                  << std::endl;
+
+               // Position unknown.  Each readRow fails and nulls the row.
+               m_currentRow = startLine;
+            }
+         }
+         else if (startLine < m_currentRow)
          {
             // Must restart the compression process again.
             restart();
@@ -316,7 +375,7 @@ void ossimPngReader::fillTile(const ossimIrect& clip_rect,
          // Gobble any not needed lines.
          while(m_currentRow < startLine)
          {
-            png_read_row(m_pngReadPtr, m_lineBuffer, NULL);
+            readRow();
             ++m_currentRow;
          }
             
@@ -1182,12 +1241,30 @@ void ossimPngReader::setMaxPixelValue()
    }
 }
 
+void ossimPngReader::readRow()
+{
+   if (m_rowReader)
+   {
+      if ( m_rowReader->readRow(m_lineBuffer) == false )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "ossimPngReader::readRow WARN! Error reading line "
+            << m_currentRow << " of " << theImageFile << std::endl;
+         memset(m_lineBuffer, 0, m_lineBufferSizeInBytes);
+      }
+   }
+   else
+   {
+      png_read_row(m_pngReadPtr, m_lineBuffer, NULL);
+   }
+}
+
 template <class T>  void ossimPngReader::copyLines(
    T /*dummy*/,  ossim_uint32 stopLine)
 {
    const ossim_uint32 SAMPLES = m_imageRect.width();
 
-   T* src = (T*)m_lineBuffer;
+   const T* src = (const T*)m_lineBuffer;
    std::vector<T*> dst(m_numberOfOutputBands);
 
    ossim_uint32 band = 0;
@@ -1196,62 +1273,38 @@ template <class T>  void ossimPngReader::copyLines(
       dst[band] = (T*) m_cacheTile->getBuf(band);
    }
    
-   ossim_int32 bufIdx = 0;
+   ossim_uint32 bufIdx = 0;
    
    while (m_currentRow <= stopLine)
    {
-      // Read a line from the jpeg file.
-      png_read_row(m_pngReadPtr, m_lineBuffer, NULL);
+      // Read a line from the png file.
+      readRow();
       ++m_currentRow;
 
-      if(m_swapFlag)
-      {
-         ossimEndian endian;
-         endian.swap(src, SAMPLES*m_numberOfInputBands);
-      }
-
       //---
       // Copy the line which is band interleaved by pixel the the band
-      // separate buffers.
+      // separate buffers.  Swaps to native byte order on the way.
       //---
-      ossim_uint32 index = 0;
-      for (ossim_uint32 sample = 0; sample < SAMPLES; ++sample)
-      {
-         for (band = 0; band < m_numberOfOutputBands; ++band)
-         {
-            dst[band][bufIdx] = src[index];
-            ++index;
-         }
-         ++bufIdx;
-      }
+      ossimPngCopyKernels::copyLine(src, SAMPLES, m_numberOfOutputBands,
+                                    m_swapFlag, &dst.front(), bufIdx);
+      bufIdx += SAMPLES;
    }
 }
 
 template <class T> void ossimPngReader::copyLinesWithAlpha(
    T, ossim_uint32 stopLine)
 {
-   ossim_float64 denominator;
-   if (m_outputScalarType == OSSIM_UINT8)
-   {
-      denominator = m_maxPixelValue[m_numberOfInputBands-1];
-   }
-   else
-   {
-      denominator = m_maxPixelValue[m_numberOfInputBands-1];
-   }
+   ossimPngCopyKernels::AlphaParams params;
+   params.m_denominator = m_maxPixelValue[m_numberOfInputBands-1];
+   params.m_minPix      = m_cacheTile->getMinPix(0);
+   params.m_maxPix      = m_cacheTile->getMaxPix(0);
+   params.m_nullPix     = m_cacheTile->getNullPix(0);
 
    const ossim_uint32 SAMPLES = m_imageRect.width();
    
-   T* src = (T*) m_lineBuffer;
+   const T* src = (const T*) m_lineBuffer;
 
    std::vector<T*> dst(m_numberOfOutputBands);
-   std::vector<T> p(m_numberOfOutputBands);
-   
-   ossim_float64 alpha;
-
-   const ossim_float64 MIN_PIX  = m_cacheTile->getMinPix(0);
-   const ossim_float64 MAX_PIX  = m_cacheTile->getMaxPix(0);
-   const ossim_float64 NULL_PIX = m_cacheTile->getNullPix(0);
  
    ossim_uint32 band = 0;
    for (band = 0; band < m_numberOfOutputBands; ++band)
@@ -1259,73 +1312,22 @@ template <class T> void ossimPngReader::copyLinesWithAlpha(
       dst[band] = (T*)m_cacheTile->getBuf(band);
    }
 
-   ossim_int32 dstIdx = 0;
+   ossim_uint32 dstIdx = 0;
    
    while (m_currentRow <= stopLine)
    {
-      // Read a line from the jpeg file.
-      png_read_row(m_pngReadPtr, m_lineBuffer, NULL);
+      // Read a line from the png file.
+      readRow();
       ++m_currentRow;
 
-      if(m_swapFlag)
-      {
-         ossimEndian endian;
-         endian.swap(src, SAMPLES*m_numberOfInputBands);
-      }
-      
       //---
       // Copy the line which is band interleaved by pixel the the band
-      // separate buffers.
+      // separate buffers burning the alpha value into the other bands.
       //---
-      ossim_uint32 srcIdx = 0;
-      for (ossim_uint32 sample = 0; sample < SAMPLES; ++sample)
-      {
-         // Copy the pixels.
-         for (band = 0; band < m_numberOfOutputBands; ++band)
-         {
-            p[band] = src[srcIdx++];
-         }
-         
-         // Get the alpha channel.
-         alpha = src[srcIdx++];
-         alpha = alpha / denominator;
-         
-         if (alpha == 1.0)
-         {
-            for (band = 0; band < m_numberOfOutputBands; ++band)
-            {
-               dst[band][dstIdx] = p[band];
-            }
-         }
-         else if (alpha == 0.0)
-         {
-            for (band = 0; band < m_numberOfOutputBands; ++band)
-            {
-               dst[band][dstIdx] = static_cast<T>(NULL_PIX);
-            }
-         }
-         else
-         {
-            for (band = 0; band < m_numberOfOutputBands; ++band)
-            {
-               ossim_float64 f = p[band];
-               f = f * alpha;
-               if (f != NULL_PIX)
-               {
-                  dst[band][dstIdx] =
-                     static_cast<T>( (f>=MIN_PIX) ?
-                                     ( (f<=MAX_PIX) ? f : MAX_PIX ) :
-                                     MIN_PIX );
-               }
-               else
-               {
-                  dst[band][dstIdx] = static_cast<T>(NULL_PIX);
-               }
-            }
-         }
-         ++dstIdx; // next sample...
-            
-      } // End of sample loop.
+      ossimPngCopyKernels::copyLineWithAlpha(src, SAMPLES, m_numberOfOutputBands,
+                                             m_swapFlag, params,
+                                             &dst.front(), dstIdx);
+      dstIdx += SAMPLES;
       
    } // End of line loop.
 }
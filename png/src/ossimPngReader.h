@@ -22,6 +22,7 @@
 #include <vector>
 
 class ossimImageData;
+class ossimPngRowReader;
 
 class ossimPngReader : public ossimImageHandler, public ossimStreamReaderInterface
 {
@@ -273,6 +274,12 @@ protected:
     */
    void fillTile(const ossimIrect& clip_rect, ossimImageData* tile);
 
+   /**
+    * @brief Reads the next row into m_lineBuffer from m_rowReader if set,
+    * else libpng.  Does not increment m_currentRow.
+    */
+   void readRow();
+
    template <class T> void copyLines(T dummy,  ossim_uint32 stopLine);
    template <class T> void copyLinesWithAlpha(T, ossim_uint32 stopLine);
 
@@ -290,6 +297,13 @@ protected:
    ossim_uint8*  m_lineBuffer;
    ossim_uint32  m_lineBufferSizeInBytes;
 
+   /**
+    * Random access row reader with lazily built zlib checkpoint index.
+    * Used in place of libpng reads when the image layout allows; null if
+    * not.
+    */
+   ossimPngRowReader* m_rowReader;
+
    std::shared_ptr<ossim::istream> m_str;
    
    ossimIrect    m_bufferRect;
@@ -0,0 +1,228 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: PNG row filtering for the encoders that feed zlib directly.
+//
+//----------------------------------------------------------------------------
+
+#include "ossimPngRowFilter.h"
+#include <png.h>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+
+// Paeth predictor, written without branches so it vectorizes.
+static inline ossim_uint8 paeth( ossim_int32 a, ossim_int32 b, ossim_int32 c )
+{
+   ossim_int32 p  = b - c;
+   ossim_int32 q  = a - c;
+   ossim_int32 pa = std::abs( p );
+   ossim_int32 pb = std::abs( q );
+   ossim_int32 pc = std::abs( p + q );
+   ossim_int32 pred = ( pb < pa ) ? b : a;
+   pa = ( pb < pa ) ? pb : pa;
+   return (ossim_uint8)( ( pc < pa ) ? c : pred );
+}
+
+// Absolute value of a filtered byte taken as signed.
+static inline ossim_uint32 absByte( ossim_uint8 v )
+{
+   return (ossim_uint32)std::abs( (ossim_int32)(ossim_int8)v );
+}
+
+//---
+// Writes a filtered row, lead(i) for the first bpp bytes (no left neighbor)
+// and rest(i) after.  With a limit the sum of absolute values is returned,
+// stopping early once it reaches limit; limit zero skips the sum.
+//---
+template <class Lead, class Rest>
+static inline ossim_uint64 filterLoop( Lead lead, Rest rest,
+                                       ossim_uint32 leadBytes,
+                                       ossim_uint32 rowBytes,
+                                       ossim_uint8* dst,
+                                       ossim_uint64 limit )
+{
+   size_t i = 0;
+   if ( limit == 0 )
+   {
+      for ( ; i < leadBytes; ++i )
+      {
+         dst[i] = lead( i );
+      }
+      for ( ; i < rowBytes; ++i )
+      {
+         dst[i] = rest( i );
+      }
+      return 0;
+   }
+
+   ossim_uint64 sum = 0;
+   for ( ; i < leadBytes; ++i )
+   {
+      dst[i] = lead( i );
+      sum += absByte( dst[i] );
+   }
+   while ( ( i < rowBytes ) && ( sum < limit ) )
+   {
+      // Checked every block so the inner loop stays simple.
+      const size_t END = std::min<size_t>( i + 64, rowBytes );
+      for ( ; i < END; ++i )
+      {
+         dst[i] = rest( i );
+         sum += absByte( dst[i] );
+      }
+   }
+   return sum;
+}
+
+// png_set_filter mask bit of a filter type.
+static inline ossim_int32 filterBit( ossim_uint8 type )
+{
+   return PNG_FILTER_NONE << type;
+}
+
+ossimPngRowFilter::ossimPngRowFilter()
+   :
+   m_filters( PNG_FILTER_NONE ),
+   m_bpp( 1 ),
+   m_rowBytes( 0 ),
+   m_prior(),
+   m_trial()
+{
+}
+
+void ossimPngRowFilter::reset( ossim_int32 filters,
+                               ossim_uint32 bytesPerPixel,
+                               ossim_uint32 rowBytes,
+                               ossim_uint32 rows )
+{
+   m_filters  = filters & PNG_ALL_FILTERS;
+
+   // Filters that cannot help, dropped as png_write_start_row does.
+   if ( rows == 1 )
+   {
+      m_filters &= ~( PNG_FILTER_UP | PNG_FILTER_AVG | PNG_FILTER_PAETH );
+   }
+   if ( rowBytes <= bytesPerPixel )
+   {
+      m_filters &= ~( PNG_FILTER_SUB | PNG_FILTER_AVG | PNG_FILTER_PAETH );
+   }
+   if ( m_filters == 0 )
+   {
+      m_filters = PNG_FILTER_NONE;
+   }
+   m_bpp      = bytesPerPixel ? bytesPerPixel : 1;
+   m_rowBytes = rowBytes;
+   m_prior.assign( rowBytes, 0 );
+   m_trial.resize( rowBytes );
+}
+
+ossim_uint32 ossimPngRowFilter::getFilteredRowBytes() const
+{
+   return m_rowBytes + 1;
+}
+
+void ossimPngRowFilter::filterRow( const ossim_uint8* row, ossim_uint8* dst )
+{
+   ossim_uint8* best  = dst + 1;
+   ossim_uint8* trial = m_rowBytes ? &m_trial.front() : 0;
+   bool haveBest = false;
+   ossim_uint64 bestSum = 0;
+
+   for ( ossim_uint8 type = PNG_FILTER_VALUE_NONE; type <= PNG_FILTER_VALUE_PAETH; ++type )
+   {
+      if ( ( m_filters & filterBit( type ) ) == 0 )
+      {
+         continue;
+      }
+
+      if ( !haveBest )
+      {
+         dst[0] = type;
+         if ( m_filters == filterBit( type ) )
+         {
+            apply( type, row, best, 0 ); // Only one allowed, nothing to compare.
+            break;
+         }
+         bestSum  = apply( type, row, best, ~(ossim_uint64)0 );
+         haveBest = true;
+      }
+      else
+      {
+         // Gives up as soon as the sum passes the best so far.
+         ossim_uint64 sum = apply( type, row, trial, bestSum );
+         if ( sum < bestSum )
+         {
+            bestSum = sum;
+            dst[0]  = type;
+            std::swap( best, trial );
+         }
+      }
+   }
+
+   if ( m_rowBytes )
+   {
+      if ( best != dst + 1 )
+      {
+         memcpy( dst + 1, best, m_rowBytes );
+      }
+      memcpy( &m_prior.front(), row, m_rowBytes );
+   }
+}
+
+ossim_uint64 ossimPngRowFilter::apply( ossim_uint8 type,
+                                       const ossim_uint8* row,
+                                       ossim_uint8* dst,
+                                       ossim_uint64 limit ) const
+{
+   const ossim_uint8* prior = m_rowBytes ? &m_prior.front() : 0;
+   const ossim_uint32 LEAD  = std::min( m_bpp, m_rowBytes );
+
+   // Left and upper left neighbors, only read past the lead bytes.
+   const ossim_uint8* left      = row - m_bpp;
+   const ossim_uint8* priorLeft = prior - m_bpp;
+
+   switch ( type )
+   {
+      case PNG_FILTER_VALUE_SUB:
+      {
+         return filterLoop(
+            [=]( size_t i ) { return row[i]; },
+            [=]( size_t i ) { return (ossim_uint8)( row[i] - left[i] ); },
+            LEAD, m_rowBytes, dst, limit );
+      }
+      case PNG_FILTER_VALUE_UP:
+      {
+         return filterLoop(
+            [=]( size_t i ) { return (ossim_uint8)( row[i] - prior[i] ); },
+            [=]( size_t i ) { return (ossim_uint8)( row[i] - prior[i] ); },
+            LEAD, m_rowBytes, dst, limit );
+      }
+      case PNG_FILTER_VALUE_AVG:
+      {
+         return filterLoop(
+            [=]( size_t i ) { return (ossim_uint8)( row[i] - ( prior[i] >> 1 ) ); },
+            [=]( size_t i )
+            { return (ossim_uint8)( row[i] - ( ( left[i] + prior[i] ) >> 1 ) ); },
+            LEAD, m_rowBytes, dst, limit );
+      }
+      case PNG_FILTER_VALUE_PAETH:
+      {
+         return filterLoop(
+            [=]( size_t i ) { return (ossim_uint8)( row[i] - prior[i] ); },
+            [=]( size_t i )
+            { return (ossim_uint8)( row[i] - paeth( left[i], prior[i], priorLeft[i] ) ); },
+            LEAD, m_rowBytes, dst, limit );
+      }
+      default:
+      {
+         return filterLoop(
+            [=]( size_t i ) { return row[i]; },
+            [=]( size_t i ) { return row[i]; },
+            LEAD, m_rowBytes, dst, limit );
+      }
+   }
+}
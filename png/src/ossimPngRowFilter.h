@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: PNG row filtering for the encoders that feed zlib directly.
+//
+// Applies the png_set_filter() choice the way libpng does: a single filter
+// is used as is; with several allowed each row gets the one with the lowest
+// sum of absolute differences.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPngRowFilter_HEADER
+#define ossimPngRowFilter_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <vector>
+
+class ossimPngRowFilter
+{
+public:
+
+   /** default constructor */
+   ossimPngRowFilter();
+
+   /**
+    * @brief Starts a new image.
+    * @param filters PNG_FILTER_* mask, e.g. PNG_ALL_FILTERS.  Zero or no
+    * known bit is taken as PNG_FILTER_NONE.
+    * @param bytesPerPixel Bytes in one complete pixel, at least one.
+    * @param rowBytes Bytes in one row, not including the filter byte.
+    * @param rows Rows in the image.  Like libpng, filters that cannot help a
+    * one row or one pixel wide image are dropped from the mask.
+    */
+   void reset( ossim_int32 filters,
+               ossim_uint32 bytesPerPixel,
+               ossim_uint32 rowBytes,
+               ossim_uint32 rows );
+
+   /**
+    * @brief Filters the next row.
+    * @param row Unfiltered row of rowBytes.
+    * @param dst Filter type byte followed by the filtered row: rowBytes+1.
+    */
+   void filterRow( const ossim_uint8* row, ossim_uint8* dst );
+
+   /** @return Bytes in one filtered row including the filter byte. */
+   ossim_uint32 getFilteredRowBytes() const;
+
+private:
+
+   /**
+    * @brief Writes row filtered with type to dst.
+    * @param limit Zero to skip the sum of absolute values, else the sum to
+    * give up at.  dst is incomplete when that happens.
+    * @return The sum, or at least limit if it gave up.
+    */
+   ossim_uint64 apply( ossim_uint8 type,
+                       const ossim_uint8* row,
+                       ossim_uint8* dst,
+                       ossim_uint64 limit ) const;
+
+   ossim_int32              m_filters;
+   ossim_uint32             m_bpp;
+   ossim_uint32             m_rowBytes;
+   std::vector<ossim_uint8> m_prior;  // Previous unfiltered row.
+   std::vector<ossim_uint8> m_trial;  // Trial filter output.
+};
+
+#endif /* #ifndef ossimPngRowFilter_HEADER */
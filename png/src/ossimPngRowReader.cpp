@@ -0,0 +1,461 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Random access row reader for non-interlaced PNG images.
+//
+//----------------------------------------------------------------------------
+
+#include "ossimPngRowReader.h"
+#include <cstdlib> /* for abs */
+#include <cstring> /* for memset, memcmp */
+#include <istream>
+
+// Input buffer size.  One fill never spans an IDAT chunk boundary.
+static const ossim_uint32 IN_BUF_SIZE = 65536;
+
+static ossim_uint32 getUint32BE( const ossim_uint8* p )
+{
+   return ( (ossim_uint32)p[0] << 24 ) | ( (ossim_uint32)p[1] << 16 ) |
+          ( (ossim_uint32)p[2] << 8 )  |   (ossim_uint32)p[3];
+}
+
+ossimPngRowReader::ossimPngRowReader()
+   :
+   m_str(0),
+   m_zstream(),
+   m_zstreamInitialized(false),
+   m_inBuf(),
+   m_filePos(0),
+   m_chunkRemaining(0),
+   m_firstIdatOffset(0),
+   m_firstIdatLength(0),
+   m_row(),
+   m_prior(),
+   m_width(0),
+   m_height(0),
+   m_rowBytes(0),
+   m_bytesPerPixel(0),
+   m_currentRow(0),
+   m_checkpointInterval(0),
+   m_checkpoints()
+{
+   memset( &m_zstream, 0, sizeof(z_stream) );
+}
+
+ossimPngRowReader::~ossimPngRowReader()
+{
+   close();
+}
+
+bool ossimPngRowReader::open( std::shared_ptr<ossim::istream>& str,
+                              ossim_uint32 checkpointInterval )
+{
+   bool result = false;
+
+   close();
+
+   if ( str && checkpointInterval )
+   {
+      m_str = str;
+      m_checkpointInterval = checkpointInterval;
+
+      if ( readHeader() )
+      {
+         m_inBuf.resize( IN_BUF_SIZE );
+         m_row.resize( m_rowBytes + 1 );
+         m_prior.resize( m_rowBytes );
+         result = rewind();
+      }
+   }
+
+   if ( !result )
+   {
+      close();
+   }
+
+   return result;
+}
+
+void ossimPngRowReader::close()
+{
+   std::vector<Checkpoint*>::iterator i = m_checkpoints.begin();
+   while ( i != m_checkpoints.end() )
+   {
+      inflateEnd( &((*i)->m_zstream) );
+      delete (*i);
+      ++i;
+   }
+   m_checkpoints.clear();
+
+   if ( m_zstreamInitialized )
+   {
+      inflateEnd( &m_zstream );
+      m_zstreamInitialized = false;
+   }
+
+   m_inBuf.clear();
+   m_row.clear();
+   m_prior.clear();
+   m_str = 0;
+}
+
+bool ossimPngRowReader::seek( ossim_uint32 row )
+{
+   bool result = false;
+
+   if ( m_zstreamInitialized && ( row < m_height ) )
+   {
+      ossim_uint32 idx = row / m_checkpointInterval;
+      if ( idx > m_checkpoints.size() )
+      {
+         // Not indexed that far yet.  Decode forward from the last one.
+         idx = (ossim_uint32)m_checkpoints.size();
+      }
+      ossim_uint32 cpRow = idx * m_checkpointInterval;
+
+      if ( ( m_currentRow >= cpRow ) && ( m_currentRow <= row ) )
+      {
+         result = true; // Reading forward from here is cheapest.
+      }
+      else if ( idx == 0 )
+      {
+         result = rewind();
+      }
+      else
+      {
+         result = restore( m_checkpoints[idx-1], cpRow );
+      }
+   }
+
+   return result;
+}
+
+bool ossimPngRowReader::readRow( ossim_uint8* buf )
+{
+   if ( !m_zstreamInitialized || ( m_currentRow >= m_height ) || !buf )
+   {
+      return false;
+   }
+
+   // Index built lazily on the first pass.
+   if ( m_currentRow == ( m_checkpoints.size() + 1 ) * m_checkpointInterval )
+   {
+      addCheckpoint();
+   }
+
+   m_zstream.next_out  = &m_row.front();
+   m_zstream.avail_out = m_rowBytes + 1;
+
+   while ( m_zstream.avail_out )
+   {
+      if ( ( m_zstream.avail_in == 0 ) && ( fillInput() == false ) )
+      {
+         invalidate();
+         return false;
+      }
+
+      int ret = inflate( &m_zstream, Z_NO_FLUSH );
+      if ( ret == Z_STREAM_END )
+      {
+         if ( m_zstream.avail_out )
+         {
+            invalidate();
+            return false; // Short data.
+         }
+         break;
+      }
+      if ( ret != Z_OK )
+      {
+         invalidate();
+         return false;
+      }
+   }
+
+   if ( unfilter() == false )
+   {
+      invalidate();
+      return false;
+   }
+
+   memcpy( &m_prior.front(), &m_row[1], m_rowBytes );
+   memcpy( buf, &m_row[1], m_rowBytes );
+   ++m_currentRow;
+
+   return true;
+}
+
+ossim_uint32 ossimPngRowReader::getCurrentRow() const
+{
+   return m_currentRow;
+}
+
+ossim_uint32 ossimPngRowReader::getRowBytes() const
+{
+   return m_rowBytes;
+}
+
+bool ossimPngRowReader::readHeader()
+{
+   bool ihdrFound = false;
+   std::streamoff pos = 8; // Past the signature.
+   ossim_uint8 hdr[13];
+
+   while ( true )
+   {
+      m_str->clear();
+      m_str->seekg( pos, std::ios_base::beg );
+      m_str->read( (char*)hdr, 8 );
+      if ( !m_str->good() )
+      {
+         break;
+      }
+      pos += 8;
+
+      ossim_uint32 length = getUint32BE( hdr );
+      const ossim_uint8* type = hdr + 4;
+
+      if ( memcmp( type, "IHDR", 4 ) == 0 )
+      {
+         m_str->read( (char*)hdr, 13 );
+         if ( !m_str->good() || ( length != 13 ) )
+         {
+            break;
+         }
+
+         m_width  = getUint32BE( hdr );
+         m_height = getUint32BE( hdr + 4 );
+         ossim_uint8 bitDepth  = hdr[8];
+         ossim_uint8 colorType = hdr[9];
+         ossim_uint8 interlace = hdr[12];
+
+         ossim_uint32 channels = 0;
+         switch ( colorType )
+         {
+            case 0: // Gray
+               channels = 1;
+               break;
+            case 2: // RGB
+               channels = 3;
+               break;
+            case 4: // Gray alpha
+               channels = 2;
+               break;
+            case 6: // RGBA
+               channels = 4;
+               break;
+            default: // Palette needs expansion.
+               break;
+         }
+         if ( !channels || interlace || ( (bitDepth != 8) && (bitDepth != 16) ) )
+         {
+            break;
+         }
+
+         m_bytesPerPixel = channels * bitDepth / 8;
+         m_rowBytes      = m_width * m_bytesPerPixel;
+         ihdrFound = true;
+      }
+      else if ( memcmp( type, "tRNS", 4 ) == 0 )
+      {
+         break; // libpng expands this to an alpha channel.
+      }
+      else if ( memcmp( type, "IDAT", 4 ) == 0 )
+      {
+         if ( ihdrFound )
+         {
+            m_firstIdatOffset = pos;
+            m_firstIdatLength = length;
+            return true;
+         }
+         break;
+      }
+      else if ( memcmp( type, "IEND", 4 ) == 0 )
+      {
+         break;
+      }
+
+      pos += length + 4; // data + crc
+   }
+
+   return false;
+}
+
+bool ossimPngRowReader::rewind()
+{
+   if ( m_zstreamInitialized )
+   {
+      inflateEnd( &m_zstream );
+      m_zstreamInitialized = false;
+   }
+
+   memset( &m_zstream, 0, sizeof(z_stream) );
+   if ( inflateInit( &m_zstream ) == Z_OK )
+   {
+      m_zstreamInitialized = true;
+      m_filePos        = m_firstIdatOffset;
+      m_chunkRemaining = m_firstIdatLength;
+      memset( &m_prior.front(), 0, m_rowBytes );
+      m_currentRow = 0;
+   }
+
+   return m_zstreamInitialized;
+}
+
+void ossimPngRowReader::invalidate()
+{
+   // Past the end: seek() sees no usable position and readRow() fails.
+   m_currentRow = m_height;
+}
+
+bool ossimPngRowReader::restore( const Checkpoint* cp, ossim_uint32 row )
+{
+   if ( m_zstreamInitialized )
+   {
+      inflateEnd( &m_zstream );
+      m_zstreamInitialized = false;
+   }
+
+   if ( inflateCopy( &m_zstream, const_cast<z_streamp>(&cp->m_zstream) ) == Z_OK )
+   {
+      m_zstreamInitialized = true;
+
+      // Input pointers in the copy point at a stale buffer.
+      m_zstream.next_in  = 0;
+      m_zstream.avail_in = 0;
+
+      m_filePos        = cp->m_offset;
+      m_chunkRemaining = cp->m_chunkRemaining;
+      m_prior          = cp->m_prior;
+      m_currentRow     = row;
+   }
+
+   return m_zstreamInitialized;
+}
+
+void ossimPngRowReader::addCheckpoint()
+{
+   Checkpoint* cp = new Checkpoint();
+   memset( &cp->m_zstream, 0, sizeof(z_stream) );
+
+   if ( inflateCopy( &cp->m_zstream, &m_zstream ) == Z_OK )
+   {
+      // Unconsumed input is re-read from the file on restore.
+      cp->m_offset         = m_filePos - m_zstream.avail_in;
+      cp->m_chunkRemaining = m_chunkRemaining + m_zstream.avail_in;
+      cp->m_prior          = m_prior;
+      m_checkpoints.push_back( cp );
+   }
+   else
+   {
+      delete cp;
+   }
+}
+
+bool ossimPngRowReader::fillInput()
+{
+   m_str->clear();
+
+   while ( m_chunkRemaining == 0 )
+   {
+      // Skip the crc of this chunk, then read the next chunk header.
+      ossim_uint8 hdr[12];
+      m_str->seekg( m_filePos, std::ios_base::beg );
+      m_str->read( (char*)hdr, 12 );
+      if ( !m_str->good() || ( memcmp( hdr + 8, "IDAT", 4 ) != 0 ) )
+      {
+         return false;
+      }
+      m_filePos += 12;
+      m_chunkRemaining = getUint32BE( hdr + 4 );
+   }
+
+   ossim_uint32 bytes = ( m_chunkRemaining < IN_BUF_SIZE ) ?
+      m_chunkRemaining : IN_BUF_SIZE;
+
+   m_str->seekg( m_filePos, std::ios_base::beg );
+   m_str->read( (char*)&m_inBuf.front(), bytes );
+   if ( m_str->gcount() != (std::streamsize)bytes )
+   {
+      return false;
+   }
+
+   m_filePos        += bytes;
+   m_chunkRemaining -= bytes;
+
+   m_zstream.next_in  = &m_inBuf.front();
+   m_zstream.avail_in = bytes;
+
+   return true;
+}
+
+bool ossimPngRowReader::unfilter()
+{
+   ossim_uint8* row = &m_row[1];
+   const ossim_uint8* prior = &m_prior.front();
+   const ossim_uint32 BPP = m_bytesPerPixel;
+   ossim_uint32 i;
+
+   switch ( m_row[0] )
+   {
+      case 0: // None
+      {
+         break;
+      }
+      case 1: // Sub
+      {
+         for ( i = BPP; i < m_rowBytes; ++i )
+         {
+            row[i] = (ossim_uint8)( row[i] + row[i-BPP] );
+         }
+         break;
+      }
+      case 2: // Up
+      {
+         for ( i = 0; i < m_rowBytes; ++i )
+         {
+            row[i] = (ossim_uint8)( row[i] + prior[i] );
+         }
+         break;
+      }
+      case 3: // Average
+      {
+         for ( i = 0; i < BPP; ++i )
+         {
+            row[i] = (ossim_uint8)( row[i] + ( prior[i] >> 1 ) );
+         }
+         for ( ; i < m_rowBytes; ++i )
+         {
+            row[i] = (ossim_uint8)( row[i] + ( ( row[i-BPP] + prior[i] ) >> 1 ) );
+         }
+         break;
+      }
+      case 4: // Paeth
+      {
+         for ( i = 0; i < BPP; ++i )
+         {
+            row[i] = (ossim_uint8)( row[i] + prior[i] );
+         }
+         for ( ; i < m_rowBytes; ++i )
+         {
+            int a = row[i-BPP];
+            int b = prior[i];
+            int c = prior[i-BPP];
+            int pa = std::abs( b - c );
+            int pb = std::abs( a - c );
+            int pc = std::abs( a + b - c - c );
+            int p = ( (pa <= pb) && (pa <= pc) ) ? a : ( (pb <= pc) ? b : c );
+            row[i] = (ossim_uint8)( row[i] + p );
+         }
+         break;
+      }
+      default:
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
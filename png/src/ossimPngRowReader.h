@@ -0,0 +1,149 @@
+//----------------------------------------------------------------------------
+//
+// License:  LGPL
+//
+// See LICENSE.txt file in the top level directory for more details.
+//
+// Description: Random access row reader for non-interlaced PNG images.
+//
+// Decodes IDAT data directly with zlib and records a checkpoint (copy of
+// the inflate state, input position and previous unfiltered row) every N
+// rows on the first pass.  Backing up or jumping forward resumes from the
+// nearest checkpoint instead of re-inflating from the start of the file.
+// Same idea as zlib's examples/zran.c.
+//
+//----------------------------------------------------------------------------
+#ifndef ossimPngRowReader_HEADER
+#define ossimPngRowReader_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimIosFwd.h>
+#include <zlib.h>
+#include <ios>
+#include <memory>
+#include <vector>
+
+class ossimPngRowReader
+{
+public:
+
+   /** default constructor */
+   ossimPngRowReader();
+
+   /** destructor */
+   ~ossimPngRowReader();
+
+   /**
+    * @brief Parses the header chunks and positions at the first row.
+    *
+    * Only images that libpng would hand back untransformed are
+    * handled: non-interlaced, 8 or 16 bit, gray, gray alpha, rgb or rgba
+    * with no tRNS chunk.
+    *
+    * @param str Stream to png.  Shared with the caller.  This class seeks
+    * it before every read so the caller may use it in between.
+    * @param checkpointInterval Rows between checkpoints.  Each checkpoint
+    * costs about 40k bytes of zlib state plus one row.
+    * @return true on success, false if image is not handled.
+    */
+   bool open( std::shared_ptr<ossim::istream>& str,
+              ossim_uint32 checkpointInterval );
+
+   /** @brief Frees all zlib state and checkpoints. */
+   void close();
+
+   /**
+    * @brief Positions at the closest known point at or before row.
+    *
+    * Nothing is done if the current row is already between the closest
+    * checkpoint and row.  Caller reads forward with readRow until
+    * getCurrentRow() == row.
+    *
+    * @param row Zero based row.
+    * @return true on success, false on error.
+    */
+   bool seek( ossim_uint32 row );
+
+   /**
+    * @brief Decodes the current row and advances.
+    * @param buf Buffer to hold getRowBytes() bytes.  Samples are in file
+    * (big endian) byte order, band interleaved by pixel.
+    * @return true on success, false on error or past end of image.  After
+    * an error the position is lost and readRow keeps failing until the
+    * next seek.
+    */
+   bool readRow( ossim_uint8* buf );
+
+   /** @return Zero based row the next readRow will return. */
+   ossim_uint32 getCurrentRow() const;
+
+   /** @return Bytes in one row, not including the filter byte. */
+   ossim_uint32 getRowBytes() const;
+
+private:
+
+   /** Inflate state, input position and prior row at a row boundary. */
+   struct Checkpoint
+   {
+      z_stream                  m_zstream;
+      std::streamoff            m_offset;
+      ossim_uint32              m_chunkRemaining;
+      std::vector<ossim_uint8>  m_prior;
+   };
+
+   /** @brief Parses chunks up to the first IDAT. */
+   bool readHeader();
+
+   /** @brief Back to row 0. */
+   bool rewind();
+
+   /**
+    * @brief Marks the position unknown after a failed read.  The inflate
+    * state is part way into a row so the next seek must rewind or restore.
+    */
+   void invalidate();
+
+   /** @brief Restores state from checkpoint. */
+   bool restore( const Checkpoint* cp, ossim_uint32 row );
+
+   /** @brief Stores a checkpoint for the current row. */
+   void addCheckpoint();
+
+   /**
+    * @brief Reads more IDAT data into m_inBuf, crossing chunk boundaries
+    * as needed.  Never spans two chunks in one fill.
+    * @return false at end of IDAT data or on error.
+    */
+   bool fillInput();
+
+   /** @brief Reverses the PNG filter on m_row using m_prior. */
+   bool unfilter();
+
+   std::shared_ptr<ossim::istream> m_str;
+
+   z_stream                   m_zstream;
+   bool                       m_zstreamInitialized;
+
+   std::vector<ossim_uint8>   m_inBuf;
+   std::streamoff             m_filePos;         // Next byte to read.
+   ossim_uint32               m_chunkRemaining;  // Unread bytes in IDAT.
+
+   std::streamoff             m_firstIdatOffset;
+   ossim_uint32               m_firstIdatLength;
+
+   std::vector<ossim_uint8>   m_row;             // Filter byte + row.
+   std::vector<ossim_uint8>   m_prior;           // Previous unfiltered row.
+
+   ossim_uint32               m_width;
+   ossim_uint32               m_height;
+   ossim_uint32               m_rowBytes;
+   ossim_uint32               m_bytesPerPixel;
+   ossim_uint32               m_currentRow;
+
+   ossim_uint32               m_checkpointInterval;
+
+   // m_checkpoints[i] is for row (i+1)*m_checkpointInterval.
+   std::vector<Checkpoint*>   m_checkpoints;
+};
+
+#endif /* #ifndef ossimPngRowReader_HEADER */
@@ -11,6 +11,7 @@
 // $Id: ossimPngWriter.cpp 22466 2013-10-24 18:23:51Z dburken $
 
 #include "ossimPngWriter.h"
+#include "ossimPngParallelDeflater.h"
 #include <ossim/base/ossimBooleanProperty.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossimTrace.h>
@@ -27,6 +28,7 @@
 #include <zlib.h>
 #include <cstdlib>
 #include <ctime>
+#include <thread>
 
 RTTI_DEF1(ossimPngWriter,
 	  "ossimPngWriter",
@@ -34,6 +36,7 @@ RTTI_DEF1(ossimPngWriter,
 
 static const char COMPRESSION_LEVEL_KW[] = "compression_level";
 static const char ADD_ALPHA_CHANNEL_KW[] = "add_alpha_channel";
+static const char COMPRESSION_THREADS_KW[] = "compression_threads";
 
 //---
 // For trace debugging (to enable at runtime do:
@@ -56,6 +59,7 @@ ossimPngWriter::ossimPngWriter()
      theCompressionLevel(Z_BEST_COMPRESSION),
      theInterlaceSupport(PNG_INTERLACE_NONE),
      theCompressionStratagy(Z_FILTERED),
+     theCompressionThreads(0),
      thePngFilter(PNG_FILTER_NONE),
      theGammaFlag(false),
      theGamma(0.0),
@@ -238,6 +242,8 @@ bool ossimPngWriter::writeStream()
    setProcessStatus(ossimProcessInterface::PROCESS_STATUS_EXECUTING);
    setPercentComplete(0.0);
 
+   bool status = true;
+
    if(theInputConnection->isMaster())
    {
       ossimScalarType outputScalar = theInputConnection->getOutputScalarType();
@@ -285,11 +291,21 @@ bool ossimPngWriter::writeStream()
       png_structp pp   = png_create_write_struct (PNG_LIBPNG_VER_STRING, 0, 0, 0);
       png_infop   info = png_create_info_struct (pp);
 
+      //---
+      // Parallel mode: we filter and deflate the rows and write the IDAT
+      // chunks; libpng still writes everything else.  volatile as it is set
+      // after the setjmp and must be freed on the longjmp path.
+      //---
+      ossimPngParallelDeflater* volatile deflater = 0;
+
       if ( setjmp( png_jmpbuf(pp) ) )
       {
          ossimNotify(ossimNotifyLevel_WARN)
             << "Error writing image:  " << theFilename.c_str()
             << std::endl;
+         delete deflater;
+         png_destroy_write_struct(&pp, &info);
+         close();
          return false;
       }
 
@@ -306,17 +322,26 @@ bool ossimPngWriter::writeStream()
       png_set_compression_level(pp, theCompressionLevel);
 
       //---
-      // Set the filtering.
+      // Set the filtering.  Both write paths use these.
       // Note that palette images should usually not be filtered.
-      if (isLutEnabled())
-      {
-         png_set_filter(pp, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
-         png_set_compression_strategy(pp, Z_DEFAULT_STRATEGY);
-      }
-      else
+      // PNG_ALL_FILTERS is what libpng picks for 8 and 16 bit on its own.
+      //---
+      const ossim_int32 filters =
+         isLutEnabled() ? thePngFilter : PNG_ALL_FILTERS;
+      const ossim_int32 strategy =
+         isLutEnabled() ? Z_DEFAULT_STRATEGY : theCompressionStratagy;
+      png_set_filter(pp, PNG_FILTER_TYPE_BASE, filters);
+      png_set_compression_strategy(pp, strategy);
+
+      //---
+      // More deflate threads than cores only adds overhead, and with one
+      // thread libpng does the same work without the sync flushes.
+      //---
+      ossim_uint32 threads = theCompressionThreads;
+      const ossim_uint32 CPUS = std::thread::hardware_concurrency();
+      if ( CPUS && ( threads > CPUS ) )
       {
-         // leave default filter selection alone
-         png_set_compression_strategy(pp, Z_FILTERED);
+         threads = CPUS;
       }
 
       if (traceDebug())
@@ -336,6 +361,7 @@ bool ossimPngWriter::writeStream()
             << "\nimageHeight:         " << imageHeight
             << "\ngitDepth:            " << getBitDepth(outputScalar)
             << "\ngetColorType(bands): " << colorType
+            << "\ncompression threads: " << threads
             << endl;
       }
 
@@ -356,6 +382,9 @@ bool ossimPngWriter::writeStream()
 
       // png_set_packing(pp);
 
+      // Lines handed to libpng or the deflater.
+      ossim_int32 linesWritten = 0;
+
       // Write the image.
       if(theInterlaceSupport) // interlaced...
       {
@@ -363,7 +392,7 @@ bool ossimPngWriter::writeStream()
          ossimNotify(ossimNotifyLevel_WARN)
             << "Interlace support not implemented yet!"
             << std::endl;
-         return false;
+         status = false;
       }
       else // not interlaced...
       {
@@ -371,6 +400,19 @@ bool ossimPngWriter::writeStream()
          theInputConnection->setToStartOfSequence();
          ossim_uint32 maxY = theInputConnection->getNumberOfTilesVertical();
 
+         if ( threads > 1 )
+         {
+            deflater = new ossimPngParallelDeflater(
+               theOutputStream,
+               theCompressionLevel,
+               strategy,
+               filters,
+               bands*bytesPerPixel,
+               bytesPerRow,
+               imageHeight,
+               threads );
+         }
+
          //---
          // Loop through and grab a row of tiles and copy to the buffer.
          // Then write the buffer to the png file.
@@ -378,7 +420,7 @@ bool ossimPngWriter::writeStream()
          //---
 
          // Row loop, in line direction...
-         for (ossim_uint32 i=0; ( (i<maxY) && (!needsAborting()) ); ++i)
+         for (ossim_uint32 i=0; ( (i<maxY) && status && (!needsAborting()) ); ++i)
          {
             ossimIrect buf_rect = theAreaOfInterest;
             buf_rect.set_uly(theAreaOfInterest.ul().y+i*tileHeight);
@@ -425,12 +467,29 @@ bool ossimPngWriter::writeStream()
                   }
 
                   ossim_uint8* buf = (ossim_uint8*)bipBuf;
-                  ossim_int32 buf_offset = 0;
-                  for (ossim_int32 line=0; line<lines_to_copy; ++line)
+                  if ( deflater )
+                  {
+                     if ( deflater->addRows(buf, lines_to_copy) == false )
+                     {
+                        ossimNotify(ossimNotifyLevel_WARN)
+                           << "Error compressing image:  " << theFilename.c_str()
+                           << std::endl;
+                        status = false;
+                     }
+                  }
+                  else
+                  {
+                     ossim_int32 buf_offset = 0;
+                     for (ossim_int32 line=0; line<lines_to_copy; ++line)
+                     {
+                        png_bytep rowp = (png_bytep)&buf[buf_offset];
+                        png_write_row(pp, rowp);
+                        buf_offset += bytesPerRow;
+                     }
+                  }
+                  if ( status )
                   {
-                     png_bytep rowp = (png_bytep)&buf[buf_offset];
-                     png_write_row(pp, rowp);
-                     buf_offset += bytesPerRow;
+                     linesWritten += lines_to_copy;
                   }
 
                } // if ( !getProcessStatus() )
@@ -439,16 +498,66 @@ bool ossimPngWriter::writeStream()
                setPercentComplete( dPercentComplete );
  
             } // if ( t.valid() )
+            else
+            {
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << "Missing tile row " << i << " writing image:  "
+                  << theFilename.c_str() << std::endl;
+               status = false;
+            }
 
          } // End of loop through tiles in the y direction.
 
       } // Not interlace write block.
 
-      png_write_end(pp, 0);
+      //---
+      // Only a complete image is finished off.  After an abort or error the
+      // compressed stream and IEND are left out so the file is not taken for
+      // a good one.
+      //---
+      if ( status && ( linesWritten != imageHeight ) )
+      {
+         status = false;
+      }
+
+      if ( status )
+      {
+         if ( deflater )
+         {
+            status = deflater->finish();
+            delete deflater;
+            deflater = 0;
+            if ( status )
+            {
+               // libpng did not see the IDATs so png_write_end would refuse.
+               png_write_chunk(pp, (png_const_bytep)"IEND", NULL, 0);
+            }
+            else
+            {
+               ossimNotify(ossimNotifyLevel_WARN)
+                  << "Error compressing image:  " << theFilename.c_str()
+                  << std::endl;
+            }
+         }
+         else
+         {
+            png_write_end(pp, 0);
+         }
+      }
+
+      delete deflater;
+      deflater = 0;
       png_destroy_write_struct(&pp, &info);
 
       close();
 
+      if ( !status )
+      {
+         ossimNotify(ossimNotifyLevel_WARN)
+            << "Incomplete image written:  " << theFilename.c_str()
+            << std::endl;
+      }
+
    } // End of if(theInputConnection->isMaster()) block.
 
    else   // slave process
@@ -465,7 +574,7 @@ bool ossimPngWriter::writeStream()
       setProcessStatus(ossimProcessInterface::PROCESS_STATUS_NOT_EXECUTING);
    }
 
-   return true;
+   return status;
 }
 
 void ossimPngWriter::pngWriteData(png_structp png_ptr,
@@ -490,6 +599,10 @@ bool ossimPngWriter::saveState(ossimKeywordlist& kwl,
             ADD_ALPHA_CHANNEL_KW,
             ossimString::toString( theAlphaChannelFlag ),
             true );
+   kwl.add( prefix,
+            COMPRESSION_THREADS_KW,
+            ossimString::toString( theCompressionThreads ),
+            true );
 
    return ossimImageFileWriter::saveState(kwl, prefix);
 }
@@ -505,6 +618,12 @@ bool ossimPngWriter::loadState(const ossimKeywordlist& kwl,
       setAlphaChannelFlag( ossimString(value).toBool() );
    }
 
+   value = kwl.find(prefix, COMPRESSION_THREADS_KW);
+   if(value)
+   {
+      theCompressionThreads = ossimString(value).toUInt32();
+   }
+
    theOutputImageType = "png";
 
    return ossimImageFileWriter::loadState(kwl, prefix);
@@ -596,6 +715,11 @@ void ossimPngWriter::setProperty(ossimRefPtr<ossimProperty> property)
       setAlphaChannelFlag( property->valueToString().toBool() );
    }
    else
+   if (property->getName() == COMPRESSION_THREADS_KW)
+   {
+      theCompressionThreads = property->valueToString().toUInt32();
+   }
+   else
    {
       ossimImageFileWriter::setProperty(property);
    }
@@ -620,6 +744,15 @@ ossimRefPtr<ossimProperty> ossimPngWriter::getProperty(const ossimString& name)c
       return new ossimBooleanProperty(ADD_ALPHA_CHANNEL_KW,
                                       theAlphaChannelFlag);
    }
+   else if (name == COMPRESSION_THREADS_KW)
+   {
+      ossimNumericProperty* numericProp =
+         new ossimNumericProperty(name,
+                                  ossimString::toString(theCompressionThreads),
+                                  0, 256);
+      numericProp->setNumericType(ossimNumericProperty::ossimNumericPropertyType_UINT);
+      return numericProp;
+   }
    return ossimImageFileWriter::getProperty(name);
 }
 
@@ -627,6 +760,7 @@ void ossimPngWriter::getPropertyNames(std::vector<ossimString>& propertyNames)co
 {
    propertyNames.push_back(ossimString(COMPRESSION_LEVEL_KW));
    propertyNames.push_back(ossimString(ADD_ALPHA_CHANNEL_KW));
+   propertyNames.push_back(ossimString(COMPRESSION_THREADS_KW));
    ossimImageFileWriter::getPropertyNames(propertyNames);
 }
 
@@ -343,6 +343,15 @@ private:
     */
    ossim_int32 theCompressionStratagy;
 
+   /**
+    * Number of threads used to deflate image data.  0 or 1 writes rows
+    * through libpng on the calling thread.  More than 1 uses
+    * ossimPngParallelDeflater.  Output is a standard png either way.
+    *
+    * Defaulted to 0.
+    */
+   ossim_uint32 theCompressionThreads;
+
    /**
     * PNG_NO_FILTERS     0x00
     * PNG_FILTER_NONE    0x08
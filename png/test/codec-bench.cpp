@@ -0,0 +1,107 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Tiles per second for ossimPngCodec::encode's ossimPngEncoder against a png_struct created per
+// tile, the way the codec used libpng before. 256x256 tiles of 8 bit RGB, 8 bit RGBA and 16 bit
+// gray at compression level 1.
+//
+// Usage: codec-bench [tiles]
+
+#include "../src/ossimPngEncoder.h"
+#include <png.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const int TILE_SIZE = 256;
+
+static void writeData(png_structp pp, png_bytep data, png_size_t length)
+{
+   vector<ossim_uint8>* out = (vector<ossim_uint8>*) png_get_io_ptr(pp);
+   out->insert(out->end(), data, data + length);
+}
+
+static void flushData(png_structp)
+{
+}
+
+static bool encodeLibpng(const vector<ossim_uint8>& img, int bitDepth, int colorType,
+                         int filters, int strategy, vector<png_bytep>& rows,
+                         vector<ossim_uint8>& out)
+{
+   out.clear();
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   bool ok = false;
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      png_set_IHDR(pp, info, TILE_SIZE, TILE_SIZE, bitDepth, colorType, PNG_INTERLACE_NONE,
+                   PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+      png_set_compression_level(pp, 1);
+      if (filters >= 0)
+         png_set_filter(pp, PNG_FILTER_TYPE_BASE, filters);
+      if (strategy >= 0)
+         png_set_compression_strategy(pp, strategy);
+      png_set_rows(pp, info, &rows.front());
+      png_set_write_fn(pp, &out, writeData, flushData);
+      png_write_png(pp, info, PNG_TRANSFORM_IDENTITY, 0);
+      ok = true;
+   }
+   png_destroy_write_struct(&pp, &info);
+   return ok;
+}
+
+static void run(const char* name, int channels, int bitDepth, int colorType, int filters,
+                int strategy, int tiles)
+{
+   const int ROW_BYTES = TILE_SIZE * channels * bitDepth / 8;
+   vector<ossim_uint8> img((size_t) ROW_BYTES * TILE_SIZE);
+   for (size_t i = 0; i < img.size(); ++i)
+      img[i] = (ossim_uint8) ((i / channels / 7) % 200 + ((i * 2654435761u >> 28) & 3));
+
+   vector<png_bytep> rows(TILE_SIZE);
+   for (int y = 0; y < TILE_SIZE; ++y)
+      rows[y] = &img[(size_t) y * ROW_BYTES];
+
+   vector<ossim_uint8> out;
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   for (int t = 0; t < tiles; ++t)
+      encodeLibpng(img, bitDepth, colorType, filters, strategy, rows, out);
+   double libpngSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+   size_t libpngBytes = out.size();
+
+   ossimPngEncoder encoder;
+   start = chrono::steady_clock::now();
+   for (int t = 0; t < tiles; ++t)
+      encoder.encode(&img.front(), TILE_SIZE, TILE_SIZE, bitDepth, colorType, 1, filters,
+                     strategy, out);
+   double encoderSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+   cout << name << ": libpng per tile " << (int) (tiles / libpngSeconds) << " tiles/s ("
+        << libpngBytes << " bytes), ossimPngEncoder " << (int) (tiles / encoderSeconds)
+        << " tiles/s (" << out.size() << " bytes)" << endl;
+}
+
+int main(int argc, char* argv[])
+{
+   int tiles = (argc > 1) ? atoi(argv[1]) : 1000;
+
+   cout << "Default filters and strategy:" << endl;
+   run("  RGB8  ", 3, 8, PNG_COLOR_TYPE_RGB, -1, -1, tiles);
+   run("  RGBA8 ", 4, 8, PNG_COLOR_TYPE_RGB_ALPHA, -1, -1, tiles);
+   run("  Gray16", 1, 16, PNG_COLOR_TYPE_GRAY, -1, -1, tiles);
+
+   cout << "filter=none strategy=z_rle:" << endl;
+   run("  RGB8  ", 3, 8, PNG_COLOR_TYPE_RGB, PNG_FILTER_NONE, Z_RLE, tiles);
+   run("  RGBA8 ", 4, 8, PNG_COLOR_TYPE_RGB_ALPHA, PNG_FILTER_NONE, Z_RLE, tiles);
+   run("  Gray16", 1, 16, PNG_COLOR_TYPE_GRAY, PNG_FILTER_NONE, Z_RLE, tiles);
+   return 0;
+}
@@ -0,0 +1,169 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Round trip test for ossimPngEncoder, the per thread encoder behind ossimPngCodec::encode.
+// Images of every handled color type and bit depth are encoded with each filter and strategy
+// choice, decoded with libpng and must match the input byte for byte. The same encoder is
+// reused throughout so state left over from one image would show up in the next.
+
+#include "../src/ossimPngEncoder.h"
+#include "../../test/ossimPluginTest.h"
+#include <png.h>
+#include <zlib.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+struct Reader
+{
+   const vector<ossim_uint8>* data;
+   size_t offset;
+};
+
+static void readData(png_structp pp, png_bytep dst, png_size_t length)
+{
+   Reader* r = (Reader*) png_get_io_ptr(pp);
+   if (r->offset + length > r->data->size())
+      png_error(pp, "read past end");
+   memcpy(dst, &(*r->data)[r->offset], length);
+   r->offset += length;
+}
+
+// Decodes with libpng, no transforms. Returns false on any libpng error.
+static bool decode(const vector<ossim_uint8>& png, int w, int h, int bitDepth, int colorType,
+                   vector<ossim_uint8>& pixels)
+{
+   png_structp pp = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   bool ok = false;
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      Reader r = { &png, 0 };
+      png_set_read_fn(pp, &r, readData);
+      png_read_info(pp, info);
+      if (((int) png_get_image_width(pp, info) == w) &&
+          ((int) png_get_image_height(pp, info) == h) &&
+          (png_get_bit_depth(pp, info) == bitDepth) &&
+          (png_get_color_type(pp, info) == colorType))
+      {
+         size_t rowBytes = png_get_rowbytes(pp, info);
+         pixels.assign(rowBytes * h, 0);
+         for (int y = 0; y < h; ++y)
+            png_read_row(pp, &pixels[y * rowBytes], 0);
+         png_read_end(pp, 0);
+         ok = true;
+      }
+   }
+   png_destroy_read_struct(&pp, &info, 0);
+   return ok;
+}
+
+// Smooth gradient with noise so every filter gets picked somewhere.
+static void makeImage(int w, int h, int bytesPerPixel, unsigned seed, vector<ossim_uint8>& img)
+{
+   srand(seed);
+   img.resize((size_t) w * h * bytesPerPixel);
+   for (int y = 0; y < h; ++y)
+   {
+      for (int x = 0; x < w * bytesPerPixel; ++x)
+      {
+         int v = (x * 3 + y * 5) / 4 + (rand() % 9);
+         if ((y / 16 + x / 48) % 5 == 0)
+            v = 200; // Flat patches.
+         img[(size_t) y * w * bytesPerPixel + x] = (ossim_uint8) v;
+      }
+   }
+}
+
+int main()
+{
+   ossimPngEncoder encoder;
+
+   const int colorTypes[] = { PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GRAY_ALPHA,
+                              PNG_COLOR_TYPE_RGB, PNG_COLOR_TYPE_RGB_ALPHA };
+   const int channels[] = { 1, 2, 3, 4 };
+   const char* colorNames[] = { "gray", "gray alpha", "rgb", "rgba" };
+
+   const int filters[] = { -1, PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG,
+                           PNG_FILTER_PAETH, PNG_FILTER_SUB | PNG_FILTER_PAETH };
+   const int strategies[] = { -1, Z_DEFAULT_STRATEGY, Z_FILTERED, Z_HUFFMAN_ONLY, Z_RLE,
+                              Z_FIXED };
+
+   cout << "Round trip, every filter and strategy:" << endl;
+   for (int c = 0; c < 4; ++c)
+   {
+      for (int bitDepth = 8; bitDepth <= 16; bitDepth += 8)
+      {
+         const int w = 133;
+         const int h = 71;
+         const int BPP = channels[c] * bitDepth / 8;
+         vector<ossim_uint8> img;
+         makeImage(w, h, BPP, c * 17 + bitDepth, img);
+
+         bool allMatch = true;
+         for (size_t f = 0; f < sizeof(filters) / sizeof(int); ++f)
+         {
+            for (size_t s = 0; s < sizeof(strategies) / sizeof(int); ++s)
+            {
+               for (int level = 0; level <= 9; level += 3)
+               {
+                  vector<ossim_uint8> png;
+                  vector<ossim_uint8> pixels;
+                  if (!encoder.encode(&img.front(), w, h, bitDepth, colorTypes[c], level,
+                                      filters[f], strategies[s], png) ||
+                      !decode(png, w, h, bitDepth, colorTypes[c], pixels) || (pixels != img))
+                  {
+                     cout << "    mismatch: filter " << filters[f] << " strategy "
+                          << strategies[s] << " level " << level << endl;
+                     allMatch = false;
+                  }
+               }
+            }
+         }
+         string what = string(colorNames[c]) + (bitDepth == 8 ? " 8 bit" : " 16 bit");
+         check(allMatch, what.c_str());
+      }
+   }
+
+   cout << "Edge cases:" << endl;
+   {
+      // One pixel, one row; SUB and PAETH have no left neighbor at all.
+      vector<ossim_uint8> img(3, 77), png, pixels;
+      check(encoder.encode(&img.front(), 1, 1, 8, PNG_COLOR_TYPE_RGB, 6, PNG_ALL_FILTERS, -1,
+                           png) &&
+            decode(png, 1, 1, 8, PNG_COLOR_TYPE_RGB, pixels) && (pixels == img),
+            "1x1 rgb");
+
+      // Random data that does not compress, so the output must grow past its first guess.
+      vector<ossim_uint8> noise(512 * 512 * 4);
+      for (size_t i = 0; i < noise.size(); ++i)
+         noise[i] = (ossim_uint8) (rand() >> 7);
+      check(encoder.encode(&noise.front(), 512, 512, 8, PNG_COLOR_TYPE_RGB_ALPHA, 1, -1, -1,
+                           png) &&
+            decode(png, 512, 512, 8, PNG_COLOR_TYPE_RGB_ALPHA, pixels) && (pixels == noise),
+            "incompressible 512x512 rgba");
+
+      vector<ossim_uint8> small(64 * 4, 9);
+      check(encoder.encode(&small.front(), 8, 8, 8, PNG_COLOR_TYPE_RGB_ALPHA, 1, -1, -1, png) &&
+            decode(png, 8, 8, 8, PNG_COLOR_TYPE_RGB_ALPHA, pixels) && (pixels == small),
+            "small image after a large one");
+
+      check(!encoder.encode(&small.front(), 8, 8, 4, PNG_COLOR_TYPE_GRAY, 1, -1, -1, png) &&
+            png.empty(), "4 bit rejected");
+      check(!encoder.encode(&small.front(), 8, 8, 8, PNG_COLOR_TYPE_PALETTE, 1, -1, -1, png),
+            "palette rejected");
+      check(!encoder.encode(&small.front(), 0, 8, 8, PNG_COLOR_TYPE_GRAY, 1, -1, -1, png),
+            "zero width rejected");
+   }
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,155 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Bit exactness test for ossimPngCopyKernels, the line copy code behind ossimPngReader. Every
+// copyLine and copyLineWithAlpha variant is run with the SSSE3 kernels on and off and the band
+// buffers must match byte for byte. Row lengths cover the vector block sizes and the scalar
+// tails; alpha rows mix transparent, opaque and partial pixels.
+
+#include "../src/ossimPngCopyKernels.h"
+#include "../../test/ossimPluginTest.h"
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const ossim_uint32 DST_OFFSET = 5;
+
+template <class T>
+static void makeRow(ossim_uint32 samples, ossim_uint32 bands, bool alpha, T maxValue,
+                    vector<T>& row)
+{
+   row.resize(samples * bands);
+   for (ossim_uint32 i = 0; i < row.size(); ++i)
+   {
+      row[i] = (T) (rand() % ((int) maxValue + 1));
+      if (alpha && ((i % bands) == bands - 1))
+      {
+         // A third each transparent, opaque and partial.
+         int kind = rand() % 3;
+         if (kind == 0)
+            row[i] = 0;
+         else if (kind == 1)
+            row[i] = maxValue;
+      }
+   }
+}
+
+// Runs fn with the vector kernels on or off, returning the band buffers.
+template <class T, class Fn>
+static vector< vector<T> > run(bool simd, ossim_uint32 samples, ossim_uint32 bands, Fn fn)
+{
+   ossimPngCopyKernels::setSimdEnabled(simd);
+   vector< vector<T> > buffers(bands, vector<T>(samples + DST_OFFSET + 3, (T) 0x5a));
+   vector<T*> dst(bands);
+   for (ossim_uint32 b = 0; b < bands; ++b)
+      dst[b] = &buffers[b].front();
+   fn(&dst.front());
+   return buffers;
+}
+
+template <class T>
+static void testType(const char* name, T maxValue)
+{
+   const ossim_uint32 SAMPLES[] = { 0, 1, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 255, 256,
+                                    1001 };
+   const size_t SAMPLE_COUNT = sizeof(SAMPLES) / sizeof(SAMPLES[0]);
+
+   ossimPngCopyKernels::AlphaParams params;
+   params.m_denominator = maxValue;
+   params.m_minPix = 1;
+   params.m_maxPix = maxValue;
+   params.m_nullPix = 0;
+
+   for (int swap = 0; swap < 2; ++swap)
+   {
+      for (ossim_uint32 bands = 1; bands <= 4; ++bands)
+      {
+         bool allMatch = true;
+         for (size_t s = 0; s < SAMPLE_COUNT; ++s)
+         {
+            ossim_uint32 samples = SAMPLES[s];
+            vector<T> row;
+            makeRow(samples, bands, false, maxValue, row);
+            const T* src = row.empty() ? 0 : &row.front();
+            struct Copy
+            {
+               const T* src;
+               ossim_uint32 samples;
+               ossim_uint32 bands;
+               bool swap;
+               void operator()(T* const* dst) const
+               {
+                  ossimPngCopyKernels::copyLine(src, samples, bands, swap, dst, DST_OFFSET);
+               }
+            } copy = { src, samples, bands, swap != 0 };
+            allMatch = allMatch && (run<T>(true, samples, bands, copy) ==
+                                    run<T>(false, samples, bands, copy));
+         }
+         ostringstream what;
+         what << name << " copyLine bands=" << bands << " swap=" << swap;
+         check(allMatch, what.str());
+      }
+
+      for (ossim_uint32 outputBands = 1; outputBands <= 3; ++outputBands)
+      {
+         bool allMatch = true;
+         for (size_t s = 0; s < SAMPLE_COUNT; ++s)
+         {
+            ossim_uint32 samples = SAMPLES[s];
+            vector<T> row;
+            makeRow(samples, outputBands + 1, true, maxValue, row);
+            if (swap && (sizeof(T) == 2))
+            {
+               // Alpha tests are on native values; feed it the file order.
+               for (size_t i = 0; i < row.size(); ++i)
+                  row[i] = (T) ((row[i] >> 8) | (row[i] << 8));
+            }
+            const T* src = row.empty() ? 0 : &row.front();
+            struct Copy
+            {
+               const T* src;
+               ossim_uint32 samples;
+               ossim_uint32 outputBands;
+               bool swap;
+               const ossimPngCopyKernels::AlphaParams* params;
+               void operator()(T* const* dst) const
+               {
+                  ossimPngCopyKernels::copyLineWithAlpha(src, samples, outputBands, swap,
+                                                         *params, dst, DST_OFFSET);
+               }
+            } copy = { src, samples, outputBands, swap != 0, &params };
+            allMatch = allMatch && (run<T>(true, samples, outputBands, copy) ==
+                                    run<T>(false, samples, outputBands, copy));
+         }
+         ostringstream what;
+         what << name << " copyLineWithAlpha outputBands=" << outputBands << " swap=" << swap;
+         check(allMatch, what.str());
+      }
+   }
+}
+
+int main()
+{
+   if (!ossimPngCopyKernels::simdSupported())
+      cout << "  NOTE: no SSSE3 on this cpu, scalar code compared with itself." << endl;
+
+   srand(1);
+   testType<ossim_uint8>("uint8 ", 255);
+   testType<ossim_uint16>("uint16", 65535);
+   testType<ossim_uint16>("uint12", 4095);
+
+   ossimPngCopyKernels::setSimdEnabled(true);
+   check(ossimPngCopyKernels::getSimdEnabled() == ossimPngCopyKernels::simdSupported(),
+         "enabled only when supported");
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,108 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Throughput of ossimPngWriter's two write paths: rows through libpng on one thread, and
+// ossimPngParallelDeflater with 2, 4 and 8 threads. 8 bit RGB, written 256 rows at a time like
+// tile rows, default writer settings (all filters, Z_FILTERED, best compression) and level 1.
+//
+// Usage: deflate-bench [width height]
+
+#include "../src/ossimPngParallelDeflater.h"
+#include <png.h>
+#include <zlib.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+static const int CHANNELS = 3;
+static const int TILE_HEIGHT = 256;
+
+static void writeData(png_structp pp, png_bytep data, png_size_t length)
+{
+   ostream* str = (ostream*) png_get_io_ptr(pp);
+   str->write((const char*) data, length);
+}
+
+static void flushData(png_structp)
+{
+}
+
+// threads 0 writes the rows with libpng.
+static size_t write(const vector<ossim_uint8>& img, int width, int height, int level,
+                    ossim_uint32 threads)
+{
+   const int ROW_BYTES = width * CHANNELS;
+   ostringstream str;
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      png_set_write_fn(pp, &str, writeData, flushData);
+      png_set_compression_level(pp, level);
+      png_set_filter(pp, PNG_FILTER_TYPE_BASE, PNG_ALL_FILTERS);
+      png_set_compression_strategy(pp, Z_FILTERED);
+      png_set_IHDR(pp, info, width, height, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE,
+                   PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+      png_write_info(pp, info);
+
+      if (threads)
+      {
+         ossimPngParallelDeflater deflater(&str, level, Z_FILTERED, PNG_ALL_FILTERS, CHANNELS,
+                                           ROW_BYTES, height, threads);
+         bool ok = true;
+         for (int y = 0; (y < height) && ok; y += TILE_HEIGHT)
+         {
+            int lines = (y + TILE_HEIGHT <= height) ? TILE_HEIGHT : (height - y);
+            ok = deflater.addRows(&img[(size_t) y * ROW_BYTES], lines);
+         }
+         if (ok && deflater.finish())
+            png_write_chunk(pp, (png_const_bytep) "IEND", NULL, 0);
+      }
+      else
+      {
+         for (int y = 0; y < height; ++y)
+            png_write_row(pp, (png_bytep) &img[(size_t) y * ROW_BYTES]);
+         png_write_end(pp, 0);
+      }
+   }
+   png_destroy_write_struct(&pp, &info);
+   return str.str().size();
+}
+
+int main(int argc, char* argv[])
+{
+   int width = (argc > 2) ? atoi(argv[1]) : 4096;
+   int height = (argc > 2) ? atoi(argv[2]) : 4096;
+
+   vector<ossim_uint8> img((size_t) width * height * CHANNELS);
+   for (size_t i = 0; i < img.size(); ++i)
+      img[i] = (ossim_uint8) ((i / CHANNELS / 7) % 200 + ((i * 2654435761u >> 28) & 3));
+   const double MB = img.size() / (1024.0 * 1024.0);
+
+   const int LEVELS[] = { Z_BEST_COMPRESSION, Z_BEST_SPEED };
+   const ossim_uint32 THREADS[] = { 0, 2, 4, 8 };
+   for (int l = 0; l < 2; ++l)
+   {
+      cout << "level " << LEVELS[l] << ", " << width << "x" << height << " rgb:" << endl;
+      for (int t = 0; t < 4; ++t)
+      {
+         chrono::steady_clock::time_point start = chrono::steady_clock::now();
+         size_t bytes = write(img, width, height, LEVELS[l], THREADS[t]);
+         double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+         if (THREADS[t])
+            cout << "  deflater " << THREADS[t] << " threads: ";
+         else
+            cout << "  libpng            : ";
+         cout << MB / seconds << " MB/s (" << bytes << " bytes)" << endl;
+      }
+   }
+   return 0;
+}
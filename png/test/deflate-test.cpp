@@ -0,0 +1,356 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Bit exactness test for ossimPngParallelDeflater, the multi-threaded IDAT writer behind
+// ossimPngWriter's compression_threads option. Files are written the way the writer does it:
+// libpng writes everything up to the first IDAT, the deflater writes the image data and libpng
+// adds IEND. Each one is checked against the same image written by libpng alone:
+//
+//   - decoded with libpng, the pixels must match the input byte for byte;
+//   - inflated, the IDAT data (filter bytes and filtered rows) must match libpng's exactly, so
+//     the filter and strategy settings are honoured the same way on both paths.
+//
+// Also checks that a stream error is reported and that dropping the deflater before finish()
+// with chunks in flight is safe.
+
+#include "../src/ossimPngParallelDeflater.h"
+#include "../../test/ossimPluginTest.h"
+#include <png.h>
+#include <zlib.h>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static void writeData(png_structp pp, png_bytep data, png_size_t length)
+{
+   ostream* str = (ostream*) png_get_io_ptr(pp);
+   str->write((const char*) data, length);
+}
+
+static void flushData(png_structp pp)
+{
+   ostream* str = (ostream*) png_get_io_ptr(pp);
+   str->flush();
+}
+
+struct Image
+{
+   int width;
+   int height;
+   int bitDepth;
+   int colorType;
+   int channels;
+   vector<ossim_uint8> pixels;
+
+   int rowBytes() const { return width * channels * bitDepth / 8; }
+};
+
+// Smooth gradient with noise so every filter gets picked somewhere.
+static void makeImage(int w, int h, int bitDepth, int colorType, int channels, unsigned seed,
+                      Image& img)
+{
+   img.width = w;
+   img.height = h;
+   img.bitDepth = bitDepth;
+   img.colorType = colorType;
+   img.channels = channels;
+   img.pixels.resize((size_t) img.rowBytes() * h);
+   srand(seed);
+   for (int y = 0; y < h; ++y)
+   {
+      for (int x = 0; x < img.rowBytes(); ++x)
+      {
+         int v = (x / channels + y) / 3 + (x % channels) * 40 + (rand() % 5);
+         img.pixels[(size_t) y * img.rowBytes() + x] = (ossim_uint8) v;
+      }
+   }
+}
+
+static void startPng(png_structp pp, png_infop info, ostream& str, const Image& img, int level,
+                     int strategy, int filters)
+{
+   png_set_write_fn(pp, &str, writeData, flushData);
+   png_set_compression_level(pp, level);
+   png_set_filter(pp, PNG_FILTER_TYPE_BASE, filters);
+   png_set_compression_strategy(pp, strategy);
+   png_set_IHDR(pp, info, img.width, img.height, img.bitDepth, img.colorType,
+                PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+   png_write_info(pp, info);
+}
+
+// libpng alone.
+static bool writeLibpng(const Image& img, int level, int strategy, int filters, string& out)
+{
+   ostringstream str;
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   bool ok = false;
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      startPng(pp, info, str, img, level, strategy, filters);
+      for (int y = 0; y < img.height; ++y)
+         png_write_row(pp, (png_bytep) &img.pixels[(size_t) y * img.rowBytes()]);
+      png_write_end(pp, 0);
+      ok = true;
+   }
+   png_destroy_write_struct(&pp, &info);
+   out = str.str();
+   return ok;
+}
+
+// libpng for the header and IEND, the deflater for the data, rows handed over in tile rows.
+static bool writeParallel(const Image& img, int level, int strategy, int filters,
+                          ossim_uint32 threads, int tileHeight, string& out)
+{
+   ostringstream str;
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   bool ok = false;
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      startPng(pp, info, str, img, level, strategy, filters);
+
+      ossimPngParallelDeflater deflater(&str, level, strategy, filters,
+                                        img.channels * img.bitDepth / 8, img.rowBytes(),
+                                        img.height, threads);
+      ok = true;
+      for (int y = 0; (y < img.height) && ok; y += tileHeight)
+      {
+         int lines = (y + tileHeight <= img.height) ? tileHeight : (img.height - y);
+         ok = deflater.addRows(&img.pixels[(size_t) y * img.rowBytes()], lines);
+      }
+      if (ok)
+         ok = deflater.finish();
+      if (ok)
+         png_write_chunk(pp, (png_const_bytep) "IEND", NULL, 0);
+   }
+   png_destroy_write_struct(&pp, &info);
+   out = str.str();
+   return ok;
+}
+
+static ossim_uint32 getUint32(const string& s, size_t offset)
+{
+   const unsigned char* p = (const unsigned char*) s.data() + offset;
+   return ((ossim_uint32) p[0] << 24) | ((ossim_uint32) p[1] << 16) |
+      ((ossim_uint32) p[2] << 8) | p[3];
+}
+
+// Walks the chunks, checking each CRC, and inflates the IDAT data. The chunks must end in IEND.
+static bool inflateIdat(const string& png, vector<ossim_uint8>& data)
+{
+   data.clear();
+   string zdata;
+   size_t offset = 8;
+   bool sawEnd = false;
+   while (!sawEnd && (offset + 12 <= png.size()))
+   {
+      ossim_uint32 length = getUint32(png, offset);
+      if (offset + 12 + length > png.size())
+         return false;
+      string type = png.substr(offset + 4, 4);
+      uLong crc = crc32(0L, (const Bytef*) png.data() + offset + 4, length + 4);
+      if (crc != getUint32(png, offset + 8 + length))
+         return false;
+      if (type == "IDAT")
+         zdata.append(png, offset + 8, length);
+      sawEnd = (type == "IEND");
+      offset += 12 + length;
+   }
+   if (!sawEnd || (offset != png.size()) || zdata.empty())
+      return false;
+
+   z_stream z;
+   memset(&z, 0, sizeof(z_stream));
+   if (inflateInit(&z) != Z_OK)
+      return false;
+   z.next_in = (Bytef*) zdata.data();
+   z.avail_in = (uInt) zdata.size();
+   int ret = Z_OK;
+   while (ret == Z_OK)
+   {
+      ossim_uint8 buf[65536];
+      z.next_out = buf;
+      z.avail_out = sizeof(buf);
+      ret = inflate(&z, Z_NO_FLUSH);
+      data.insert(data.end(), buf, buf + (sizeof(buf) - z.avail_out));
+   }
+   bool ok = (ret == Z_STREAM_END) && (z.avail_in == 0);
+   inflateEnd(&z);
+   return ok;
+}
+
+struct Reader
+{
+   const string* data;
+   size_t offset;
+};
+
+static void readData(png_structp pp, png_bytep dst, png_size_t length)
+{
+   Reader* r = (Reader*) png_get_io_ptr(pp);
+   if (r->offset + length > r->data->size())
+      png_error(pp, "read past end");
+   memcpy(dst, r->data->data() + r->offset, length);
+   r->offset += length;
+}
+
+static bool decodeMatches(const string& png, const Image& img)
+{
+   png_structp pp = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   bool ok = false;
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      Reader r = { &png, 0 };
+      png_set_read_fn(pp, &r, readData);
+      png_read_info(pp, info);
+      if (((int) png_get_image_width(pp, info) == img.width) &&
+          ((int) png_get_image_height(pp, info) == img.height) &&
+          ((int) png_get_rowbytes(pp, info) == img.rowBytes()))
+      {
+         vector<ossim_uint8> pixels(img.pixels.size());
+         for (int y = 0; y < img.height; ++y)
+            png_read_row(pp, &pixels[(size_t) y * img.rowBytes()], 0);
+         png_read_end(pp, 0);
+         ok = (pixels == img.pixels);
+      }
+   }
+   png_destroy_read_struct(&pp, &info, 0);
+   return ok;
+}
+
+static string describe(const char* name, int filters, int strategy, int level,
+                       ossim_uint32 threads)
+{
+   ostringstream s;
+   s << name << " filters=0x" << hex << filters << dec << " strategy=" << strategy
+     << " level=" << level << " threads=" << threads;
+   return s.str();
+}
+
+int main()
+{
+   struct Case
+   {
+      const char* name;
+      int width;
+      int height;
+      int bitDepth;
+      int colorType;
+      int channels;
+   };
+   // The first two span several deflate jobs (512k each), the rest one.
+   const Case CASES[] = {
+      { "gray8   ", 700, 800, 8, PNG_COLOR_TYPE_GRAY, 1 },
+      { "rgb8    ", 777, 250, 8, PNG_COLOR_TYPE_RGB, 3 },
+      { "rgba8   ", 160, 120, 8, PNG_COLOR_TYPE_RGB_ALPHA, 4 },
+      { "gray16  ", 200, 150, 16, PNG_COLOR_TYPE_GRAY, 1 },
+      { "rgb16   ", 129, 57, 16, PNG_COLOR_TYPE_RGB, 3 },
+      { "1x1     ", 1, 1, 8, PNG_COLOR_TYPE_GRAY, 1 },
+      { "column  ", 1, 300, 16, PNG_COLOR_TYPE_GRAY, 1 },
+      { "row     ", 300, 1, 8, PNG_COLOR_TYPE_RGB, 3 },
+   };
+   const int FILTERS[] = { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG,
+                           PNG_FILTER_PAETH, PNG_ALL_FILTERS };
+   const int STRATEGIES[] = { Z_FILTERED, Z_DEFAULT_STRATEGY, Z_RLE };
+   const int LEVELS[] = { Z_BEST_COMPRESSION, Z_BEST_SPEED, Z_DEFAULT_COMPRESSION };
+   const ossim_uint32 THREADS[] = { 1, 3, 8 };
+
+   for (size_t c = 0; c < sizeof(CASES) / sizeof(CASES[0]); ++c)
+   {
+      Image img;
+      makeImage(CASES[c].width, CASES[c].height, CASES[c].bitDepth, CASES[c].colorType,
+                CASES[c].channels, (unsigned) c + 1, img);
+
+      for (size_t f = 0; f < sizeof(FILTERS) / sizeof(FILTERS[0]); ++f)
+      {
+         for (size_t s = 0; s < sizeof(STRATEGIES) / sizeof(STRATEGIES[0]); ++s)
+         {
+            // Levels only change the deflate output, so one filter covers them.
+            size_t levels = (f + 1 == sizeof(FILTERS) / sizeof(FILTERS[0])) ?
+               sizeof(LEVELS) / sizeof(LEVELS[0]) : 1;
+            for (size_t l = 0; l < levels; ++l)
+            {
+               string reference;
+               vector<ossim_uint8> referenceData;
+               bool ok = writeLibpng(img, LEVELS[l], STRATEGIES[s], FILTERS[f], reference) &&
+                  inflateIdat(reference, referenceData);
+
+               for (size_t t = 0; t < sizeof(THREADS) / sizeof(THREADS[0]); ++t)
+               {
+                  string png;
+                  vector<ossim_uint8> data;
+                  bool passed = ok &&
+                     writeParallel(img, LEVELS[l], STRATEGIES[s], FILTERS[f], THREADS[t],
+                                   64, png) &&
+                     inflateIdat(png, data) && (data == referenceData) &&
+                     decodeMatches(png, img);
+                  check(passed, describe(CASES[c].name, FILTERS[f], STRATEGIES[s], LEVELS[l],
+                                         THREADS[t]));
+               }
+            }
+         }
+      }
+   }
+
+   // Rows handed over one at a time and all at once.
+   {
+      Image img;
+      makeImage(300, 1000, 8, PNG_COLOR_TYPE_RGB, 3, 42, img);
+      string reference;
+      vector<ossim_uint8> referenceData;
+      writeLibpng(img, Z_BEST_COMPRESSION, Z_FILTERED, PNG_ALL_FILTERS, reference);
+      inflateIdat(reference, referenceData);
+
+      const int TILE_HEIGHTS[] = { 1, 1000 };
+      for (size_t i = 0; i < 2; ++i)
+      {
+         string png;
+         vector<ossim_uint8> data;
+         bool passed = writeParallel(img, Z_BEST_COMPRESSION, Z_FILTERED, PNG_ALL_FILTERS, 4,
+                                     TILE_HEIGHTS[i], png) &&
+            inflateIdat(png, data) && (data == referenceData) && decodeMatches(png, img);
+         ostringstream what;
+         what << "rows in batches of " << TILE_HEIGHTS[i];
+         check(passed, what.str());
+      }
+   }
+
+   // A failed stream is reported, not ignored.
+   {
+      Image img;
+      makeImage(1000, 1500, 8, PNG_COLOR_TYPE_GRAY, 1, 7, img);
+      ostringstream str;
+      str.setstate(ios::badbit);
+      ossimPngParallelDeflater deflater(&str, 6, Z_FILTERED, PNG_ALL_FILTERS, 1, 1000, 1500, 2);
+      bool ok = deflater.addRows(&img.pixels.front(), img.height);
+      if (ok)
+         ok = deflater.finish();
+      check(!ok, "stream error reported");
+   }
+
+   // Abandoned with jobs in flight, as after an abort; must not crash or write.
+   {
+      Image img;
+      makeImage(1000, 1500, 8, PNG_COLOR_TYPE_GRAY, 1, 9, img);
+      ostringstream str;
+      {
+         ossimPngParallelDeflater deflater(&str, 9, Z_FILTERED, PNG_ALL_FILTERS, 1, 1000, 1500, 8);
+         deflater.addRows(&img.pixels.front(), img.height);
+      }
+      check(str.str().size() < img.pixels.size(), "abandoned before finish");
+   }
+
+   return ossimPluginTest::summary();
+}
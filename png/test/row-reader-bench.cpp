@@ -0,0 +1,164 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Time to read the rows of a large PNG in full width strips, bottom up, as a viewer panning up
+// or a resampler working against the file order asks for them: through ossimPngRowReader, which
+// resumes from its checkpoints, and through libpng, which has to start again from the top for
+// every strip as ossimPngReader did before. A plain libpng decode of the whole image and the
+// row reader's first pass, which lays down the checkpoints, are timed for reference. The image
+// is 8 bit gray, written to the work directory first.
+//
+// Usage: row-reader-bench [work directory] [size] [strip rows] [libpng strips]
+
+#include "../src/ossimPngRowReader.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimFilename.h>
+#include <png.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Gradient with noise, compressed fast so writing 400 MB of pixels does not take all day.
+static bool writePng(const ossimFilename& file, ossim_uint32 size)
+{
+   FILE* fp = fopen(file.c_str(), "wb");
+   if (!fp)
+      return false;
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   png_init_io(pp, fp);
+   png_set_IHDR(pp, info, size, size, 8, PNG_COLOR_TYPE_GRAY, PNG_INTERLACE_NONE,
+                PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+   png_set_compression_level(pp, 1);
+   png_write_info(pp, info);
+   vector<ossim_uint8> row(size);
+   unsigned state = 1;
+   for (ossim_uint32 y = 0; y < size; ++y)
+   {
+      for (ossim_uint32 x = 0; x < size; ++x)
+      {
+         state = state * 1664525u + 1013904223u;
+         row[x] = (ossim_uint8) (((x ^ y) >> 3) + (state >> 29));
+      }
+      png_write_row(pp, &row[0]);
+   }
+   png_write_end(pp, info);
+   png_destroy_write_struct(&pp, &info);
+   fclose(fp);
+   return true;
+}
+
+// Seconds for libpng to read from the top of the file down to the last row.
+static double libpngRead(const ossimFilename& file, ossim_uint32 last)
+{
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   FILE* fp = fopen(file.c_str(), "rb");
+   png_structp pp = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   png_init_io(pp, fp);
+   png_read_info(pp, info);
+   vector<ossim_uint8> row(png_get_rowbytes(pp, info));
+   for (ossim_uint32 y = 0; y <= last; ++y)
+      png_read_row(pp, &row[0], 0);
+   png_destroy_read_struct(&pp, &info, 0);
+   fclose(fp);
+   return seconds(start);
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename dir = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("row-reader-bench");
+   const ossim_uint32 size = (argc > 2) ? atoi(argv[2]) : 20000;
+   const ossim_uint32 stripRows = (argc > 3) ? atoi(argv[3]) : 256;
+   const ossim_uint32 libpngStrips = (argc > 4) ? atoi(argv[4]) : 4;
+   if (!dir.exists() && !dir.createDirectory(true))
+   {
+      cout << "Could not create " << dir << endl;
+      return 1;
+   }
+
+   const ossimFilename file = dir.dirCat("row-reader-bench.png");
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   if (!writePng(file, size))
+   {
+      cout << "Could not write " << file << endl;
+      return 1;
+   }
+   const ossim_uint32 strips = (size + stripRows - 1) / stripRows;
+   cout << size << " x " << size << " 8 bit gray, " << file.fileSize() / (1024 * 1024)
+        << " MB, written in " << fixed << setprecision(1) << seconds(start) << " s; "
+        << strips << " strips of " << stripRows << " rows" << endl;
+
+   cout << setprecision(3);
+   cout << "libpng, whole image top down:            " << setw(10)
+        << libpngRead(file, size - 1) << " s" << endl;
+
+   std::shared_ptr<ossim::istream> str(new ifstream(file.c_str(), ios::in | ios::binary));
+   ossimPngRowReader reader;
+   if (!reader.open(str, stripRows))
+   {
+      cout << "ossimPngRowReader could not open " << file << endl;
+      return 1;
+   }
+   vector<ossim_uint8> row(reader.getRowBytes());
+   start = chrono::steady_clock::now();
+   for (ossim_uint32 y = 0; y < size; ++y)
+      reader.readRow(&row[0]);
+   cout << "row reader, whole image top down:        " << setw(10) << seconds(start)
+        << " s (lays down " << strips - 1 << " checkpoints)" << endl;
+
+   start = chrono::steady_clock::now();
+   bool ok = true;
+   for (ossim_uint32 s = strips; s-- > 0 && ok; )
+   {
+      const ossim_uint32 first = s * stripRows;
+      const ossim_uint32 last = min(first + stripRows, size) - 1;
+      ok = reader.seek(first);
+      while (ok && (reader.getCurrentRow() <= last))
+         ok = reader.readRow(&row[0]);
+   }
+   const double rowReaderTime = seconds(start);
+   cout << "row reader, strips bottom up:            " << setw(10) << rowReaderTime << " s, "
+        << 1000.0 * rowReaderTime / strips << " ms per strip" << (ok ? "" : " (FAILED)")
+        << endl;
+
+   //---
+   // libpng restarts for each strip and reads every row above it, so the bottom strips are the
+   // dearest. Only the bottom few are timed; the whole image would take about half the strips
+   // times a full decode.
+   //---
+   double libpngTime = 0.0;
+   const ossim_uint32 timed = min(libpngStrips, strips);
+   for (ossim_uint32 n = 0; n < timed; ++n)
+   {
+      const ossim_uint32 first = (strips - 1 - n) * stripRows;
+      libpngTime += libpngRead(file, min(first + stripRows, size) - 1);
+   }
+   if (timed)
+   {
+      cout << "libpng restarting, bottom " << timed << " strips:     " << setw(10) << libpngTime
+           << " s, " << 1000.0 * libpngTime / timed << " ms per strip" << endl;
+   }
+
+   remove(file.c_str());
+   remove(dir.c_str());
+   return 0;
+}
@@ -0,0 +1,309 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Checks the random access rows of ossimPngRowReader, and the tiles of ossimPngReader which sits
+// on it, against libpng's decode of the whole image.
+//
+// The row reader is given non-interlaced images of every handled color type and bit depth, split
+// over many IDAT chunks, and read forward, backward one row at a time and in jumps, with
+// checkpoints every row, every few rows and never. Interlaced images must be turned down, so the
+// reader falls back to libpng. ossimPngReader is then given the same images, interlaced and not,
+// and its full width strips are read top down, bottom up and out of order.
+//
+// Usage: row-reader-test [work directory]
+
+#include "../src/ossimPngReader.h"
+#include "../src/ossimPngRowReader.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimBooleanProperty.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <png.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const int WIDTH = 157;
+static const int HEIGHT = 403;
+
+static void writeData(png_structp pp, png_bytep data, png_size_t length)
+{
+   ((string*) png_get_io_ptr(pp))->append((const char*) data, length);
+}
+
+static void flushData(png_structp)
+{
+}
+
+struct Reader
+{
+   const string* data;
+   size_t offset;
+};
+
+static void readData(png_structp pp, png_bytep dst, png_size_t length)
+{
+   Reader* r = (Reader*) png_get_io_ptr(pp);
+   if (r->offset + length > r->data->size())
+      png_error(pp, "read past end");
+   memcpy(dst, r->data->data() + r->offset, length);
+   r->offset += length;
+}
+
+// Gradient with noise and flat patches so every filter gets used, in small IDAT chunks.
+static string makePng(int w, int h, int bitDepth, int colorType, int channels, bool interlaced)
+{
+   const size_t rowBytes = (size_t) w * channels * bitDepth / 8;
+   vector<ossim_uint8> pixels(rowBytes * h);
+   srand(colorType * 100 + bitDepth + (interlaced ? 1 : 0));
+   for (int y = 0; y < h; ++y)
+   {
+      for (size_t x = 0; x < rowBytes; ++x)
+      {
+         int v = (int) (x * 7 + y * 3) / 5 + (rand() % 5);
+         if ((y / 32 + x / 40) % 4 == 0)
+            v = 90;
+         pixels[y * rowBytes + x] = (ossim_uint8) v;
+      }
+   }
+   vector<png_bytep> rows(h);
+   for (int y = 0; y < h; ++y)
+      rows[y] = &pixels[y * rowBytes];
+
+   string png;
+   png_structp pp = png_create_write_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   png_set_write_fn(pp, &png, writeData, flushData);
+   png_set_IHDR(pp, info, w, h, bitDepth, colorType,
+                interlaced ? PNG_INTERLACE_ADAM7 : PNG_INTERLACE_NONE,
+                PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+   png_set_filter(pp, 0, PNG_ALL_FILTERS);
+   png_set_compression_buffer_size(pp, 1000);
+   png_write_info(pp, info);
+   png_write_image(pp, &rows[0]);
+   png_write_end(pp, info);
+   png_destroy_write_struct(&pp, &info);
+   return png;
+}
+
+// Rows as libpng decodes the whole image, no transforms, interlaced or not.
+static vector< vector<ossim_uint8> > decode(const string& png)
+{
+   vector< vector<ossim_uint8> > rows;
+   png_structp pp = png_create_read_struct(PNG_LIBPNG_VER_STRING, 0, 0, 0);
+   png_infop info = png_create_info_struct(pp);
+   if (setjmp(png_jmpbuf(pp)) == 0)
+   {
+      Reader r = { &png, 0 };
+      png_set_read_fn(pp, &r, readData);
+      png_read_info(pp, info);
+      png_set_interlace_handling(pp);
+      png_read_update_info(pp, info);
+      const ossim_uint32 h = png_get_image_height(pp, info);
+      rows.assign(h, vector<ossim_uint8>(png_get_rowbytes(pp, info)));
+      vector<png_bytep> pointers(h);
+      for (ossim_uint32 y = 0; y < h; ++y)
+         pointers[y] = &rows[y][0];
+      png_read_image(pp, &pointers[0]);
+      png_read_end(pp, 0);
+   }
+   else
+   {
+      rows.clear();
+   }
+   png_destroy_read_struct(&pp, &info, 0);
+   return rows;
+}
+
+// Reads row through the row reader the way ossimPngReader does: seek, then forward.
+static bool readRow(ossimPngRowReader& reader, ossim_uint32 row, vector<ossim_uint8>& buf)
+{
+   if (!reader.seek(row) || (reader.getCurrentRow() > row))
+      return false;
+   while (reader.getCurrentRow() < row)
+   {
+      if (!reader.readRow(&buf[0]))
+         return false;
+   }
+   return reader.readRow(&buf[0]);
+}
+
+// Rows in the order read: every row forward, every row backward, then jumps both ways.
+static vector<ossim_uint32> rowOrder(ossim_uint32 h)
+{
+   vector<ossim_uint32> order;
+   for (ossim_uint32 y = 0; y < h; ++y)
+      order.push_back(y);
+   for (ossim_uint32 y = h; y-- > 0; )
+      order.push_back(y);
+   const ossim_uint32 JUMPS[] = { 0, 200, 5, h - 1, 63, 64, 65, 1, 300, 299, 128, 129, 0, h / 2 };
+   for (size_t i = 0; i < sizeof(JUMPS) / sizeof(JUMPS[0]); ++i)
+      order.push_back(JUMPS[i]);
+   return order;
+}
+
+static void testRowReader(const string& name, const string& png,
+                          const vector< vector<ossim_uint8> >& expected)
+{
+   const ossim_uint32 INTERVALS[] = { 1, 16, 1000 };
+   const vector<ossim_uint32> order = rowOrder((ossim_uint32) expected.size());
+   for (int i = 0; i < 3; ++i)
+   {
+      std::shared_ptr<ossim::istream> str(new istringstream(png));
+      ossimPngRowReader reader;
+      bool same = reader.open(str, INTERVALS[i]) &&
+         (reader.getRowBytes() == expected[0].size());
+      vector<ossim_uint8> buf(expected[0].size());
+      for (size_t n = 0; (n < order.size()) && same; ++n)
+      {
+         same = readRow(reader, order[n], buf) && (buf == expected[order[n]]);
+         if (!same)
+            cout << "    row " << order[n] << " (read " << n << ") differs" << endl;
+      }
+      ostringstream what;
+      what << name << ", checkpoint every " << INTERVALS[i] << " rows: " << order.size()
+           << " rows forward, backward and in jumps match libpng";
+      check(same, what.str());
+   }
+}
+
+// Full width strips of ossimPngReader, in the order given, against the libpng decode.
+static bool readStrips(const ossimFilename& file, int channels, int bitDepth,
+                       const vector< vector<ossim_uint8> >& expected,
+                       const vector<int>& strips, int stripHeight)
+{
+   // Alpha as a band of its own rather than burnt into the others.
+   ossimRefPtr<ossimPngReader> reader = new ossimPngReader();
+   reader->setProperty(new ossimBooleanProperty("use_alpha", true));
+   if (!reader->open(file) || (reader->getNumberOfOutputBands() != (ossim_uint32) channels))
+      return false;
+
+   const int bytes = bitDepth / 8;
+   for (size_t s = 0; s < strips.size(); ++s)
+   {
+      const int y0 = strips[s] * stripHeight;
+      const int y1 = min(y0 + stripHeight, (int) expected.size()) - 1;
+      ossimRefPtr<ossimImageData> tile = reader->getTile(ossimIrect(0, y0, WIDTH - 1, y1), 0);
+      if (!tile.valid() || !tile->getBuf())
+         return false;
+      for (int b = 0; b < channels; ++b)
+      {
+         for (int y = y0; y <= y1; ++y)
+         {
+            for (int x = 0; x < WIDTH; ++x)
+            {
+               const ossim_uint8* p = &expected[y][(x * channels + b) * bytes];
+               const size_t i = (size_t) (y - y0) * WIDTH + x;
+               const ossim_uint32 value = (bytes == 1) ? p[0] : ((p[0] << 8) | p[1]);
+               const ossim_uint32 actual = (bytes == 1) ? tile->getUcharBuf(b)[i] :
+                  tile->getUshortBuf(b)[i];
+               if (value != actual)
+               {
+                  cout << "    strip " << strips[s] << " band " << b << " pixel (" << x << ", "
+                       << y << "): " << actual << ", libpng " << value << endl;
+                  return false;
+               }
+            }
+         }
+      }
+   }
+   return true;
+}
+
+static void testPngReader(const string& name, const string& png, int channels, int bitDepth,
+                          const vector< vector<ossim_uint8> >& expected,
+                          const ossimFilename& dir)
+{
+   ossimFilename file = dir.dirCat("row-reader-test.png");
+   {
+      ofstream out(file.c_str(), ios::binary);
+      out.write(png.data(), png.size());
+   }
+
+   const int STRIP = 64;
+   const int strips = ((int) expected.size() + STRIP - 1) / STRIP;
+   vector<int> down;
+   vector<int> up;
+   for (int s = 0; s < strips; ++s)
+   {
+      down.push_back(s);
+      up.push_back(strips - 1 - s);
+   }
+   const int SCATTERED[] = { 3, 0, strips - 1, 1, 4, 2 };
+   const vector<int> scattered(SCATTERED, SCATTERED + 6);
+
+   // A new reader for each order, the strips it has read stay in the tile cache.
+   check(readStrips(file, channels, bitDepth, expected, down, STRIP),
+         name + ": ossimPngReader strips top down match libpng");
+   check(readStrips(file, channels, bitDepth, expected, up, STRIP),
+         name + ": ossimPngReader strips bottom up match libpng");
+   check(readStrips(file, channels, bitDepth, expected, scattered, STRIP),
+         name + ": ossimPngReader strips out of order match libpng");
+   remove(file.c_str());
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename dir = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("row-reader-test");
+   if (!dir.exists() && !dir.createDirectory(true))
+   {
+      cout << "Could not create " << dir << endl;
+      return 1;
+   }
+
+   const int colorTypes[] = { PNG_COLOR_TYPE_GRAY, PNG_COLOR_TYPE_GRAY_ALPHA,
+                              PNG_COLOR_TYPE_RGB, PNG_COLOR_TYPE_RGB_ALPHA };
+   const int channels[] = { 1, 2, 3, 4 };
+   const char* colorNames[] = { "gray", "gray alpha", "rgb", "rgba" };
+
+   for (int interlaced = 0; interlaced < 2; ++interlaced)
+   {
+      for (int c = 0; c < 4; ++c)
+      {
+         for (int bitDepth = 8; bitDepth <= 16; bitDepth += 8)
+         {
+            ostringstream name;
+            name << colorNames[c] << " " << bitDepth << " bit"
+                 << (interlaced ? ", interlaced" : "");
+            const string png = makePng(WIDTH, HEIGHT, bitDepth, colorTypes[c], channels[c],
+                                       interlaced != 0);
+            const vector< vector<ossim_uint8> > expected = decode(png);
+            if (expected.size() != (size_t) HEIGHT)
+            {
+               check(false, name.str() + ": libpng decode");
+               continue;
+            }
+
+            if (interlaced)
+            {
+               std::shared_ptr<ossim::istream> str(new istringstream(png));
+               ossimPngRowReader reader;
+               check(!reader.open(str, 16), name.str() + ": row reader turns it down");
+            }
+            else
+            {
+               testRowReader(name.str(), png, expected);
+            }
+            testPngReader(name.str(), png, channels[c], bitDepth, expected, dir);
+         }
+      }
+   }
+   remove(dir.c_str());
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,247 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#include <potrace/src/ossimPotraceBitmapKernels.h>
+#include <atomic>
+
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && (_M_IX86_FP >= 2) )
+#  define OSSIM_POTRACE_SSE2 1
+#  include <emmintrin.h>
+#endif
+
+static const ossim_uint32 WORD_BITS = 8 * sizeof(potrace_word);
+static const potrace_word HIGH_BIT = ((potrace_word)1) << (WORD_BITS - 1);
+
+// Read by every packing thread, may be set from another.
+static std::atomic<bool> simdEnabled( ossimPotraceBitmapKernels::simdSupported() );
+
+//---
+// Scalar code. This is the reference; the vector code hands it any pixels it does not handle
+// itself.
+//---
+template <class T>
+static void packScalar(const T* src, ossim_uint32 first, ossim_uint32 last, T nullPix,
+                       potrace_word* row, ossim_uint32 x)
+{
+   for (ossim_uint32 i = first; i < last; ++i)
+   {
+      const ossim_uint32 bit = x + i;
+      const potrace_word mask = HIGH_BIT >> (bit % WORD_BITS);
+      if (src[i] != nullPix)
+         row[bit / WORD_BITS] |= mask;
+      else
+         row[bit / WORD_BITS] &= ~mask;
+   }
+}
+
+#ifdef OSSIM_POTRACE_SSE2
+
+//---
+// SSE2 code. A block is 64 pixels: the compare masks are gathered into a 64 bit value with
+// pixel k at bit k, which is then bit reversed so pixel 0 lands on the most significant bit.
+//---
+
+static inline ossim_uint64 reverseBits(ossim_uint64 v)
+{
+   v = ((v >> 1)  & 0x5555555555555555ULL) | ((v & 0x5555555555555555ULL) << 1);
+   v = ((v >> 2)  & 0x3333333333333333ULL) | ((v & 0x3333333333333333ULL) << 2);
+   v = ((v >> 4)  & 0x0F0F0F0F0F0F0F0FULL) | ((v & 0x0F0F0F0F0F0F0F0FULL) << 4);
+   v = ((v >> 8)  & 0x00FF00FF00FF00FFULL) | ((v & 0x00FF00FF00FF00FFULL) << 8);
+   v = ((v >> 16) & 0x0000FFFF0000FFFFULL) | ((v & 0x0000FFFF0000FFFFULL) << 16);
+   return (v >> 32) | (v << 32);
+}
+
+// Returns 16 bits, bit k set if pixel k equals null.
+static inline ossim_uint64 nullMask16(const ossim_uint8* p, __m128i n)
+{
+   const __m128i v = _mm_loadu_si128((const __m128i*)p);
+   return (ossim_uint32)_mm_movemask_epi8(_mm_cmpeq_epi8(v, n));
+}
+
+static inline ossim_uint64 nullMask16(const ossim_uint16* p, __m128i n)
+{
+   const __m128i a = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)p), n);
+   const __m128i b = _mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)(p + 8)), n);
+   return (ossim_uint32)_mm_movemask_epi8(_mm_packs_epi16(a, b));
+}
+
+static inline ossim_uint64 nullMask16(const ossim_uint32* p, __m128i n)
+{
+   const __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)p), n);
+   const __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p + 4)), n);
+   const __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p + 8)), n);
+   const __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(p + 12)), n);
+   return (ossim_uint32)_mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(a, b),
+                                                          _mm_packs_epi32(c, d)));
+}
+
+static inline ossim_uint64 nullMask16(const ossim_float32* p, __m128 n)
+{
+   const __m128i a = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p), n));
+   const __m128i b = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p + 4), n));
+   const __m128i c = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p + 8), n));
+   const __m128i d = _mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p + 12), n));
+   return (ossim_uint32)_mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(a, b),
+                                                          _mm_packs_epi32(c, d)));
+}
+
+static inline void storeBlock(ossim_uint64 nullBits, potrace_word* words)
+{
+   const ossim_uint64 bits = reverseBits(~nullBits);
+   if (WORD_BITS == 64)
+   {
+      words[0] = (potrace_word)bits;
+   }
+   else
+   {
+      words[0] = (potrace_word)(bits >> 32);
+      words[1] = (potrace_word)(bits & 0xFFFFFFFFULL);
+   }
+}
+
+//---
+// Packs whole 64 pixel blocks from pixel first on, which must fall on a word boundary.
+// Returns the first pixel not packed.
+//---
+template <class T, class V>
+static ossim_uint32 packVector(const T* src, ossim_uint32 first, ossim_uint32 count, V n,
+                               potrace_word* row, ossim_uint32 x)
+{
+   ossim_uint32 i = first;
+   potrace_word* words = row + (x + i) / WORD_BITS;
+   for ( ; i + 64 <= count; i += 64)
+   {
+      const T* p = src + i;
+      const ossim_uint64 nullBits = nullMask16(p, n) | (nullMask16(p + 16, n) << 16) |
+                                    (nullMask16(p + 32, n) << 32) | (nullMask16(p + 48, n) << 48);
+      storeBlock(nullBits, words);
+      words += 64 / WORD_BITS;
+   }
+   return i;
+}
+
+static ossim_uint32 packVector(const ossim_uint8* src, ossim_uint32 first, ossim_uint32 count,
+                               ossim_uint8 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   return packVector(src, first, count, _mm_set1_epi8((char)nullPix), row, x);
+}
+
+static ossim_uint32 packVector(const ossim_uint16* src, ossim_uint32 first, ossim_uint32 count,
+                               ossim_uint16 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   return packVector(src, first, count, _mm_set1_epi16((short)nullPix), row, x);
+}
+
+static ossim_uint32 packVector(const ossim_uint32* src, ossim_uint32 first, ossim_uint32 count,
+                               ossim_uint32 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   return packVector(src, first, count, _mm_set1_epi32((int)nullPix), row, x);
+}
+
+static ossim_uint32 packVector(const ossim_float32* src, ossim_uint32 first, ossim_uint32 count,
+                               ossim_float32 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   return packVector(src, first, count, _mm_set1_ps(nullPix), row, x);
+}
+
+#else /* #ifdef OSSIM_POTRACE_SSE2 */
+
+template <class T>
+static ossim_uint32 packVector(const T*, ossim_uint32 first, ossim_uint32, T,
+                               potrace_word*, ossim_uint32)
+{
+   return first;
+}
+
+#endif /* #ifdef OSSIM_POTRACE_SSE2 */
+
+//---
+// Scalar up to the first word boundary, vector over whole blocks, scalar for the rest. Signed
+// types compare the same as unsigned ones of the same size.
+//---
+template <class T, class U>
+static void pack(const T* src, ossim_uint32 count, T nullPix, potrace_word* row, ossim_uint32 x)
+{
+   ossim_uint32 done = 0;
+   if (simdEnabled)
+   {
+      ossim_uint32 aligned = (WORD_BITS - x % WORD_BITS) % WORD_BITS;
+      if (aligned > count)
+         aligned = count;
+      packScalar(src, 0, aligned, nullPix, row, x);
+      done = packVector((const U*)src, aligned, count, (U)nullPix, row, x);
+   }
+   packScalar(src, done, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_uint8* src, ossim_uint32 count,
+                                        ossim_uint8 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_uint8, ossim_uint8>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_sint8* src, ossim_uint32 count,
+                                        ossim_sint8 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_sint8, ossim_uint8>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_uint16* src, ossim_uint32 count,
+                                        ossim_uint16 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_uint16, ossim_uint16>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_sint16* src, ossim_uint32 count,
+                                        ossim_sint16 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_sint16, ossim_uint16>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_uint32* src, ossim_uint32 count,
+                                        ossim_uint32 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_uint32, ossim_uint32>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_sint32* src, ossim_uint32 count,
+                                        ossim_sint32 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_sint32, ossim_uint32>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_float32* src, ossim_uint32 count,
+                                        ossim_float32 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   pack<ossim_float32, ossim_float32>(src, count, nullPix, row, x);
+}
+
+void ossimPotraceBitmapKernels::packRow(const ossim_float64* src, ossim_uint32 count,
+                                        ossim_float64 nullPix, potrace_word* row, ossim_uint32 x)
+{
+   // No vector version: doubles are rare for masks.
+   packScalar(src, 0, count, nullPix, row, x);
+}
+
+bool ossimPotraceBitmapKernels::simdSupported()
+{
+#ifdef OSSIM_POTRACE_SSE2
+   return true;
+#else
+   return false;
+#endif
+}
+
+void ossimPotraceBitmapKernels::setSimdEnabled(bool flag)
+{
+   simdEnabled = flag && simdSupported();
+}
+
+bool ossimPotraceBitmapKernels::getSimdEnabled()
+{
+   return simdEnabled;
+}
@@ -0,0 +1,60 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#ifndef ossimPotraceBitmapKernels_HEADER
+#define ossimPotraceBitmapKernels_HEADER 1
+
+#include <ossim/base/ossimConstants.h>
+
+extern "C" {
+#include "potracelib.h"
+}
+
+/**
+ * Packs raster rows into potrace bitmap rows: a bit is set where the pixel differs from the null
+ * value, most significant bit first within a word as potrace expects. On x86 whole words are
+ * packed with SSE2 (compare a block against null, movemask, bit reverse); the scalar code does
+ * the unaligned ends and is the reference for the results.
+ */
+class ossimPotraceBitmapKernels
+{
+public:
+   /**
+    * @brief Packs count pixels into row starting at bit x. Bits outside [x, x+count) are left
+    * unchanged, so neighboring tiles can fill the same row.
+    */
+   static void packRow(const ossim_uint8* src, ossim_uint32 count, ossim_uint8 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_sint8* src, ossim_uint32 count, ossim_sint8 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_uint16* src, ossim_uint32 count, ossim_uint16 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_sint16* src, ossim_uint32 count, ossim_sint16 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_uint32* src, ossim_uint32 count, ossim_uint32 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_sint32* src, ossim_uint32 count, ossim_sint32 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_float32* src, ossim_uint32 count, ossim_float32 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+   static void packRow(const ossim_float64* src, ossim_uint32 count, ossim_float64 nullPix,
+                       potrace_word* row, ossim_uint32 x);
+
+   /** @return true if the vector kernels are available. */
+   static bool simdSupported();
+
+   /**
+    * @brief Turns the vector kernels on or off. They are on by default when supported. Turning
+    * off forces the scalar code, e.g. to compare results.
+    */
+   static void setSimdEnabled(bool flag);
+
+   /** @return true if the vector kernels are in use. */
+   static bool getSimdEnabled();
+};
+
+#endif /* #ifndef ossimPotraceBitmapKernels_HEADER */
@@ -0,0 +1,634 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#include <potrace/src/ossimPotraceTileTracer.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+static const size_t NO_EDGE = (size_t) -1;
+
+namespace
+{
+   // What one tile leaves behind once its bitmap is gone.
+   struct TileResult
+   {
+      // Fitted paths not touching a seam, in bitmap coordinates.
+      vector<potrace_path_t*> paths;
+
+      // Index in paths of the enclosing path, or -1 if it is enclosed by no path of the tile or
+      // first by a seam outline.
+      vector<int> parents;
+
+      // Outlines reaching a seam as (x, y) pairs, in bitmap coordinates.
+      vector< vector<long> > outlines;
+   };
+
+   // Unit edge of an outline. The region is on its left.
+   struct Edge
+   {
+      ossim_int32 x;
+      ossim_int32 y;
+      signed char dx;
+      signed char dy;
+      bool removed;
+      bool visited;
+      size_t next; // Following edge of the same outline.
+   };
+
+   // Vertical edges of a joined outline per pixel row, for insideness tests.
+   struct RowIndex
+   {
+      long minX, minY, maxX, maxY;
+      vector< vector<long> > rows;
+   };
+
+   class Tiling
+   {
+   public:
+      Tiling(ossim_uint32 width, ossim_uint32 height, ossim_uint32 tileSize)
+      :  m_width(width),
+         m_height(height),
+         m_tileSize(tileSize),
+         m_tilesX((width + tileSize - 1) / tileSize),
+         m_tilesY((height + tileSize - 1) / tileSize)
+      {
+      }
+
+      ossim_uint32 getNumTiles() const { return m_tilesX * m_tilesY; }
+
+      ossimIrect getTileRect(ossim_uint32 index) const
+      {
+         ossim_int32 x = (index % m_tilesX) * m_tileSize;
+         ossim_int32 y = (index / m_tilesX) * m_tileSize;
+         ossim_int32 w = std::min(m_tileSize, m_width - x);
+         ossim_int32 h = std::min(m_tileSize, m_height - y);
+         return ossimIrect(x, y, x + w - 1, y + h - 1);
+      }
+
+      bool isSeamX(long x) const { return (x > 0) && (x < (long) m_width) && !(x % m_tileSize); }
+      bool isSeamY(long y) const { return (y > 0) && (y < (long) m_height) && !(y % m_tileSize); }
+
+      ossim_uint32 getCell(long x, long y) const
+      {
+         return (ossim_uint32) (y / m_tileSize) * m_tilesX + (ossim_uint32) (x / m_tileSize);
+      }
+
+      ossim_uint32 m_width;
+      ossim_uint32 m_height;
+      ossim_uint32 m_tileSize;
+      ossim_uint32 m_tilesX;
+      ossim_uint32 m_tilesY;
+   };
+
+   inline ossim_uint64 pointKey(long x, long y)
+   {
+      return ((ossim_uint64) x << 32) | (ossim_uint64) y;
+   }
+
+   // Unlinks and frees a single path.
+   void freePath(potrace_path_t* path)
+   {
+      path->next = 0;
+      potrace_pathlist_free(path);
+   }
+
+   //---
+   // Decomposes one tile. Paths clear of the seams are fitted here; outlines reaching a seam are
+   // kept as points for joining. Turds are removed after decomposing, not by potrace, because a
+   // small piece of a large region may end at a seam.
+   //---
+   bool traceTile(const ossimIrect& rect, const Tiling& tiling, const potrace_param_t* param,
+                  ossimPotraceTileTracer::BitmapSource* source, vector<potrace_word>& map,
+                  TileResult& result)
+   {
+      const int wordBits = 8 * sizeof(potrace_word);
+      potrace_bitmap_t bitmap;
+      bitmap.w = rect.width();
+      bitmap.h = rect.height();
+      bitmap.dy = (bitmap.w + wordBits - 1) / wordBits;
+      map.assign(bitmap.dy * (size_t) bitmap.h, 0);
+      bitmap.map = &map.front();
+      if (!source->fillTile(rect, &bitmap))
+         return false;
+
+      potrace_param_t tileParam = *param;
+      tileParam.turdsize = 0;
+      potrace_path_t* plist = 0;
+      if (potrace_decompose(&tileParam, &bitmap, &plist))
+         return false;
+
+      const long x0 = rect.ul().x;
+      const long y0 = rect.ul().y;
+      const bool seamLeft = tiling.isSeamX(x0);
+      const bool seamRight = tiling.isSeamX(x0 + bitmap.w);
+      const bool seamBottom = tiling.isSeamY(y0);
+      const bool seamTop = tiling.isSeamY(y0 + bitmap.h);
+
+      // Sort the paths into kept (index in result.paths), seam outlines and turds:
+      static const int SEAM = -1;
+      static const int TURD = -2;
+      unordered_map<potrace_path_t*, potrace_path_t*> parentOf;
+      unordered_map<potrace_path_t*, int> kind;
+      vector<potrace_path_t*> all;
+      for (potrace_path_t* p = plist; p; p = p->next)
+      {
+         all.push_back(p);
+         for (potrace_path_t* c = p->childlist; c; c = c->sibling)
+            parentOf[c] = p;
+      }
+
+      for (size_t i=0; i<all.size(); ++i)
+      {
+         int len = 0;
+         const long* xy = potrace_path_points(all[i], &len);
+         bool onSeam = false;
+         for (int v=0; (v<len) && !onSeam; ++v)
+         {
+            const long x = xy[2*v];
+            const long y = xy[2*v+1];
+            onSeam = (seamLeft && (x == 0)) || (seamRight && (x == bitmap.w)) ||
+                     (seamBottom && (y == 0)) || (seamTop && (y == bitmap.h));
+         }
+
+         if (onSeam)
+         {
+            kind[all[i]] = SEAM;
+            result.outlines.push_back(vector<long> (xy, xy + 2*len));
+            vector<long>& outline = result.outlines.back();
+            for (int v=0; v<len; ++v)
+            {
+               outline[2*v] += x0;
+               outline[2*v+1] += y0;
+            }
+         }
+         else if (all[i]->area > param->turdsize)
+         {
+            kind[all[i]] = (int) result.paths.size();
+            result.paths.push_back(all[i]);
+         }
+         else
+         {
+            kind[all[i]] = TURD;
+         }
+      }
+
+      // Nearest kept ancestor in the tile, unless a seam outline comes first:
+      for (size_t i=0; i<result.paths.size(); ++i)
+      {
+         int parent = -1;
+         unordered_map<potrace_path_t*, potrace_path_t*>::const_iterator up =
+               parentOf.find(result.paths[i]);
+         while (up != parentOf.end())
+         {
+            const int k = kind[up->second];
+            if (k != TURD)
+            {
+               parent = k;
+               break;
+            }
+            up = parentOf.find(up->second);
+         }
+         result.parents.push_back(parent);
+      }
+
+      // Free seam outlines and turds, fit the rest:
+      potrace_path_t* keptList = 0;
+      for (size_t i=all.size(); i>0; --i)
+      {
+         potrace_path_t* p = all[i-1];
+         if (kind[p] < 0)
+         {
+            freePath(p);
+            continue;
+         }
+         potrace_path_translate(p, x0, y0);
+         p->next = keptList;
+         keptList = p;
+      }
+      bool fitted = (potrace_fit_paths(param, keptList) == 0);
+      for (size_t i=0; i<result.paths.size(); ++i)
+      {
+         potrace_path_compact(result.paths[i]);
+         result.paths[i]->next = 0;
+         result.paths[i]->childlist = 0;
+         result.paths[i]->sibling = 0;
+      }
+
+      return fitted;
+   }
+
+   //---
+   // Makes a path of a joined outline, oriented and started the way findpath would have:
+   // counter-clockwise around its region from the upper left corner. Outlines running clockwise
+   // go around holes. Sets path to 0 for turds. Returns false if out of memory.
+   //---
+   bool makeJoinedPath(vector<long>& xy, int turdsize, potrace_path_t** path)
+   {
+      *path = 0;
+      const size_t n = xy.size() / 2;
+      long area = 0;
+      for (size_t i=0; i<n; ++i)
+      {
+         const size_t j = (i+1 == n) ? 0 : i+1;
+         area += xy[2*j] * (xy[2*j+1] - xy[2*i+1]);
+      }
+
+      int sign = '+';
+      if (area < 0)
+      {
+         std::reverse(xy.begin(), xy.end());
+         for (size_t i=0; i<n; ++i)
+            std::swap(xy[2*i], xy[2*i+1]);
+         area = -area;
+         sign = '-';
+      }
+      if (area <= turdsize)
+         return true;
+
+      size_t first = 0;
+      for (size_t i=1; i<n; ++i)
+      {
+         if ((xy[2*i+1] > xy[2*first+1]) ||
+             ((xy[2*i+1] == xy[2*first+1]) && (xy[2*i] < xy[2*first])))
+            first = i;
+      }
+      std::rotate(xy.begin(), xy.begin() + 2*first, xy.end());
+
+      *path = potrace_path_from_points(&xy.front(), (int) n, sign);
+      return *path != 0;
+   }
+
+   void buildRowIndex(const potrace_path_t* path, RowIndex& index)
+   {
+      int len = 0;
+      const long* xy = potrace_path_points(path, &len);
+      index.minX = index.maxX = xy[0];
+      index.minY = index.maxY = xy[1];
+      for (int i=1; i<len; ++i)
+      {
+         index.minX = std::min(index.minX, xy[2*i]);
+         index.maxX = std::max(index.maxX, xy[2*i]);
+         index.minY = std::min(index.minY, xy[2*i+1]);
+         index.maxY = std::max(index.maxY, xy[2*i+1]);
+      }
+      index.rows.resize(index.maxY - index.minY);
+      for (int i=0; i<len; ++i)
+      {
+         const int j = (i+1 == len) ? 0 : i+1;
+         if (xy[2*i] == xy[2*j])
+            index.rows[std::min(xy[2*i+1], xy[2*j+1]) - index.minY].push_back(xy[2*i]);
+      }
+      for (size_t r=0; r<index.rows.size(); ++r)
+         std::sort(index.rows[r].begin(), index.rows[r].end());
+   }
+
+   // True if pixel (x, y) is inside the outline: an odd number of its edges lie to the right.
+   bool contains(const RowIndex& index, long x, long y)
+   {
+      if ((x < index.minX) || (x >= index.maxX) || (y < index.minY) || (y >= index.maxY))
+         return false;
+      const vector<long>& row = index.rows[y - index.minY];
+      return ((row.end() - std::upper_bound(row.begin(), row.end(), x)) & 1) != 0;
+   }
+
+   // Runs worker on numThreads threads, the calling thread being one of them.
+   template <class Worker>
+   void runWorkers(Worker& worker, ossim_uint32 numThreads)
+   {
+      vector<thread> threads;
+      for (ossim_uint32 i=1; i<numThreads; ++i)
+         threads.push_back(thread(std::ref(worker)));
+      worker();
+      for (size_t i=0; i<threads.size(); ++i)
+         threads[i].join();
+   }
+}
+
+ossimPotraceTileTracer::ossimPotraceTileTracer()
+:  m_tileSize(2048),
+   m_numThreads(0)
+{
+}
+
+void ossimPotraceTileTracer::setTileSize(ossim_uint32 pixels)
+{
+   if (pixels > 0)
+      m_tileSize = pixels;
+}
+
+ossim_uint32 ossimPotraceTileTracer::getTileSize() const
+{
+   return m_tileSize;
+}
+
+void ossimPotraceTileTracer::setNumThreads(ossim_uint32 numThreads)
+{
+   m_numThreads = numThreads;
+}
+
+ossim_uint32 ossimPotraceTileTracer::getNumThreads() const
+{
+   return m_numThreads;
+}
+
+potrace_state_t* ossimPotraceTileTracer::trace(const potrace_param_t* param, ossim_uint32 width,
+                                               ossim_uint32 height, BitmapSource* source) const
+{
+   if (!param || !source)
+      return 0;
+
+   potrace_state_t* state = (potrace_state_t*) malloc(sizeof(potrace_state_t));
+   if (!state)
+      return 0;
+   state->status = POTRACE_STATUS_OK;
+   state->plist = 0;
+   state->priv = 0;
+   if (!width || !height)
+      return state;
+
+   const Tiling tiling (width, height, m_tileSize);
+   const ossim_uint32 numTiles = tiling.getNumTiles();
+   ossim_uint32 numThreads = m_numThreads ? m_numThreads : thread::hardware_concurrency();
+   if (numThreads == 0)
+      numThreads = 1;
+
+   // Decompose the tiles and fit the paths that stay inside one:
+   vector<TileResult> tiles (numTiles);
+   atomic<ossim_uint32> nextTile (0);
+   atomic<bool> ok (true);
+   auto tileWorker = [&]()
+   {
+      vector<potrace_word> map;
+      for (ossim_uint32 i = nextTile++; (i < numTiles) && ok; i = nextTile++)
+      {
+         if (!traceTile(tiling.getTileRect(i), tiling, param, source, map, tiles[i]))
+            ok = false;
+      }
+   };
+   runWorkers(tileWorker, std::min(numThreads, numTiles));
+
+   //---
+   // Join the outlines reaching a seam. A seam edge seen from both sides bounds the region on
+   // neither, so both copies go. The rest are chained into loops, following the original
+   // outline except at seam vertices, where the outline to follow may now come from the other
+   // tile. Where two outlines meet at a corner there, the right turn is taken.
+   //---
+   vector<Edge> edges;
+   for (ossim_uint32 t=0; (t<numTiles) && ok; ++t)
+   {
+      for (size_t o=0; o<tiles[t].outlines.size(); ++o)
+      {
+         const vector<long>& xy = tiles[t].outlines[o];
+         const size_t base = edges.size();
+         const size_t n = xy.size() / 2;
+         for (size_t v=0; v<n; ++v)
+         {
+            const size_t w = (v+1 == n) ? 0 : v+1;
+            Edge e;
+            e.x = (ossim_int32) xy[2*v];
+            e.y = (ossim_int32) xy[2*v+1];
+            e.dx = (signed char) (xy[2*w] - e.x);
+            e.dy = (signed char) (xy[2*w+1] - e.y);
+            e.removed = false;
+            e.visited = false;
+            e.next = base + w;
+            edges.push_back(e);
+         }
+      }
+      vector< vector<long> >().swap(tiles[t].outlines);
+   }
+
+   unordered_map<ossim_uint64, size_t> seamEdges;
+   for (size_t i=0; i<edges.size(); ++i)
+   {
+      const Edge& e = edges[i];
+      const bool vertical = (e.dx == 0);
+      if (vertical ? !tiling.isSeamX(e.x) : !tiling.isSeamY(e.y))
+         continue;
+      const ossim_uint64 key = 2*pointKey(e.x + std::min<int>(e.dx, 0),
+                                          e.y + std::min<int>(e.dy, 0)) + (vertical ? 1 : 0);
+      unordered_map<ossim_uint64, size_t>::iterator other = seamEdges.find(key);
+      if (other == seamEdges.end())
+      {
+         seamEdges[key] = i;
+      }
+      else
+      {
+         edges[i].removed = true;
+         edges[other->second].removed = true;
+         seamEdges.erase(other);
+      }
+   }
+   unordered_map<ossim_uint64, size_t>().swap(seamEdges);
+
+   unordered_map<ossim_uint64, pair<size_t, size_t> > outgoing;
+   for (size_t i=0; i<edges.size(); ++i)
+   {
+      const Edge& e = edges[i];
+      if (e.removed || !(tiling.isSeamX(e.x) || tiling.isSeamY(e.y)))
+         continue;
+      pair<size_t, size_t>& out = outgoing.insert(
+            make_pair(pointKey(e.x, e.y), make_pair(NO_EDGE, NO_EDGE))).first->second;
+      if (out.first == NO_EDGE)
+         out.first = i;
+      else
+         out.second = i;
+   }
+
+   vector<potrace_path_t*> joined;
+   vector<long> loop;
+   for (size_t start=0; (start<edges.size()) && ok; ++start)
+   {
+      if (edges[start].removed || edges[start].visited)
+         continue;
+
+      loop.clear();
+      size_t cur = start;
+      while ((cur != NO_EDGE) && !edges[cur].visited)
+      {
+         Edge& e = edges[cur];
+         e.visited = true;
+         loop.push_back(e.x);
+         loop.push_back(e.y);
+
+         const long x = e.x + e.dx;
+         const long y = e.y + e.dy;
+         if (!(tiling.isSeamX(x) || tiling.isSeamY(y)))
+         {
+            cur = e.next;
+            continue;
+         }
+         unordered_map<ossim_uint64, pair<size_t, size_t> >::const_iterator out =
+               outgoing.find(pointKey(x, y));
+         if (out == outgoing.end())
+            cur = NO_EDGE;
+         else if (out->second.second == NO_EDGE)
+            cur = out->second.first;
+         else
+         {
+            const Edge& first = edges[out->second.first];
+            const bool rightTurn = (first.dx == e.dy) && (first.dy == -e.dx);
+            cur = rightTurn ? out->second.first : out->second.second;
+         }
+      }
+
+      // Every vertex has as many edges in as out, so only a broken outline ends elsewhere:
+      if (cur != start)
+         continue;
+
+      potrace_path_t* path = 0;
+      if (!makeJoinedPath(loop, param->turdsize, &path))
+         ok = false;
+      else if (path)
+         joined.push_back(path);
+   }
+   vector<Edge>().swap(edges);
+   outgoing.clear();
+
+   // Index the joined outlines for the insideness tests below, before fitting drops the points:
+   vector<RowIndex> rowIndex (joined.size());
+   vector< vector<size_t> > cells (numTiles);
+   for (size_t j=0; j<joined.size(); ++j)
+   {
+      RowIndex& index = rowIndex[j];
+      buildRowIndex(joined[j], index);
+      for (long cy = index.minY / m_tileSize; cy <= (index.maxY - 1) / m_tileSize; ++cy)
+      {
+         for (long cx = index.minX / m_tileSize; cx <= (index.maxX - 1) / m_tileSize; ++cx)
+            cells[cy * tiling.m_tilesX + cx].push_back(j);
+      }
+   }
+
+   // Fit the joined outlines:
+   atomic<size_t> nextJoined (0);
+   atomic<bool> fitted (true);
+   auto fitWorker = [&]()
+   {
+      for (size_t i = nextJoined++; i < joined.size(); i = nextJoined++)
+      {
+         if (potrace_fit_paths(param, joined[i]))
+            fitted = false;
+         potrace_path_compact(joined[i]);
+      }
+   };
+   if (ok)
+      runWorkers(fitWorker, (ossim_uint32) std::min<size_t>(numThreads, joined.size()));
+
+   // Gather all paths. Those not placed by their tile are inside a joined outline or none:
+   vector<potrace_path_t*> paths;
+   vector<int> parents;
+   for (ossim_uint32 t=0; t<numTiles; ++t)
+   {
+      const int offset = (int) paths.size();
+      for (size_t i=0; i<tiles[t].paths.size(); ++i)
+      {
+         paths.push_back(tiles[t].paths[i]);
+         parents.push_back(tiles[t].parents[i] < 0 ? -1 : offset + tiles[t].parents[i]);
+      }
+      vector<potrace_path_t*>().swap(tiles[t].paths);
+   }
+   const size_t firstJoined = paths.size();
+   paths.insert(paths.end(), joined.begin(), joined.end());
+   parents.resize(paths.size(), -1);
+
+   if (!ok)
+   {
+      for (size_t i=0; i<paths.size(); ++i)
+         freePath(paths[i]);
+      free(state);
+      return 0;
+   }
+   if (!fitted)
+      state->status = POTRACE_STATUS_INCOMPLETE;
+
+   //---
+   // As in pathlist_to_tree, a path is tested by the pixel inside its upper left corner. The
+   // smallest outline containing it is its parent.
+   //---
+   for (size_t i=0; i<paths.size(); ++i)
+   {
+      if (parents[i] >= 0)
+         continue;
+      int len = 0;
+      const long* xy = potrace_path_points(paths[i], &len);
+      const long x = xy[0];
+      const long y = xy[1] - 1;
+      const vector<size_t>& candidates = cells[tiling.getCell(x, y)];
+      int bestArea = 0;
+      for (size_t c=0; c<candidates.size(); ++c)
+      {
+         const size_t j = candidates[c];
+         const int area = joined[j]->area;
+         if ((firstJoined + j == i) || (area <= paths[i]->area) ||
+             ((parents[i] >= 0) && (area >= bestArea)))
+            continue;
+         if (contains(rowIndex[j], x, y))
+         {
+            parents[i] = (int) (firstJoined + j);
+            bestArea = area;
+         }
+      }
+   }
+
+   //---
+   // Link the tree in potrace's scan order, top row first, then the path list the way
+   // pathlist_to_tree does: each path followed by its children, grandchildren later.
+   //---
+   vector< pair<pair<long, long>, size_t> > order (paths.size());
+   for (size_t i=0; i<paths.size(); ++i)
+   {
+      int len = 0;
+      const long* xy = potrace_path_points(paths[i], &len);
+      order[i] = make_pair(make_pair(-xy[1], xy[0]), i);
+      paths[i]->next = 0;
+      paths[i]->sibling = 0;
+      paths[i]->childlist = 0;
+   }
+   std::sort(order.begin(), order.end());
+
+   potrace_path_t* roots = 0;
+   potrace_path_t** rootHook = &roots;
+   vector<potrace_path_t**> childHook (paths.size(), 0);
+   for (size_t i=0; i<paths.size(); ++i)
+      childHook[i] = &paths[i]->childlist;
+   for (size_t k=0; k<order.size(); ++k)
+   {
+      const size_t i = order[k].second;
+      potrace_path_t*** hook = (parents[i] < 0) ? &rootHook : &childHook[parents[i]];
+      **hook = paths[i];
+      *hook = &paths[i]->sibling;
+   }
+
+   vector<potrace_path_t*> lists;
+   if (roots)
+      lists.push_back(roots);
+   potrace_path_t** hook = &state->plist;
+   for (size_t l=0; l<lists.size(); ++l)
+   {
+      for (potrace_path_t* p = lists[l]; p; p = p->sibling)
+      {
+         *hook = p;
+         hook = &p->next;
+         for (potrace_path_t* c = p->childlist; c; c = c->sibling)
+         {
+            *hook = c;
+            hook = &c->next;
+            if (c->childlist)
+               lists.push_back(c->childlist);
+         }
+      }
+   }
+   *hook = 0;
+
+   return state;
+}
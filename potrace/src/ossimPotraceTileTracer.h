@@ -0,0 +1,71 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#ifndef ossimPotraceTileTracer_HEADER
+#define ossimPotraceTileTracer_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimIrect.h>
+
+extern "C" {
+#include "potracelib.h"
+}
+
+/**
+ * Traces a large bitmap in square tiles on worker threads, so that only a few tiles of the bitmap
+ * are in memory at once. Each tile is decomposed into pixel outlines on its own. Outlines that
+ * reach a seam between tiles are joined to their neighbors' by dropping the seam edges the two
+ * sides share, and only then curve fitted, so no seam shows in the output. The paths come back
+ * nested in the same tree potrace_trace builds.
+ *
+ * The result matches potrace_trace on the whole bitmap except where pixels touch only at a corner
+ * within a few pixels of a seam: the turn policy may pair those outlines differently, which moves
+ * area between polygons but not in or out of the foreground.
+ */
+class OSSIM_DLL ossimPotraceTileTracer
+{
+public:
+   /** Supplies the bitmap one tile at a time. */
+   class BitmapSource
+   {
+   public:
+      virtual ~BitmapSource() {}
+
+      /**
+       * @brief Sets the bits of bitmap, which is zeroed and sized to rect, from the pixels of
+       * rect. rect is relative to the whole bitmap. Called from the worker threads, so must be
+       * thread safe.
+       * @return false on error, which stops the trace.
+       */
+      virtual bool fillTile(const ossimIrect& rect, potrace_bitmap_t* bitmap) = 0;
+   };
+
+   ossimPotraceTileTracer();
+
+   /** @brief Sets the tile edge length in pixels. Default is 2048. */
+   void setTileSize(ossim_uint32 pixels);
+   ossim_uint32 getTileSize() const;
+
+   /** @brief Sets the number of worker threads, 0 (default) for one per core. */
+   void setNumThreads(ossim_uint32 numThreads);
+   ossim_uint32 getNumThreads() const;
+
+   /**
+    * @brief Traces a width x height bitmap read from source.
+    * @return State as returned by potrace_trace, to be freed with potrace_state_free, or 0 if
+    * the source failed or memory ran out.
+    */
+   potrace_state_t* trace(const potrace_param_t* param, ossim_uint32 width, ossim_uint32 height,
+                          BitmapSource* source) const;
+
+private:
+   ossim_uint32 m_tileSize;
+   ossim_uint32 m_numThreads;
+};
+
+#endif /* #ifndef ossimPotraceTileTracer_HEADER */
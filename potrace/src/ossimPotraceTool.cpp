@@ -8,12 +8,20 @@
 #include <ossim/base/ossimArgumentParser.h>
 #include <ossim/base/ossimApplicationUsage.h>
 #include <ossim/imaging/ossimImageHandlerRegistry.h>
-#include <ossim/imaging/ossimImageSourceSequencer.h>
+#include <ossim/imaging/ossimImageData.h>
 #include <ossim/imaging/ossimCacheTileSource.h>
 #include <ossim/base/ossimKeywordNames.h>
 #include <ossim/base/ossimException.h>
+#include <ossim/base/ossimObjectFactoryRegistry.h>
 #include <potrace/src/ossimPotraceTool.h>
+#include <potrace/src/ossimPotraceBitmapKernels.h>
+#include <potrace/src/ossimPotraceTileTracer.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 
@@ -23,11 +31,245 @@ const char* ossimPotraceTool::DESCRIPTION =
 static const string MODE_KW = "mode";
 static const string ALPHAMAX_KW = "alphamax";
 static const string TURDSIZE_KW = "turdsize";
+static const string TILE_SIZE_KW = "tile_size";
+static const string FORMAT_KW = "format";
+static const string SIMPLIFY_KW = "simplify";
+static const string PRECISION_KW = "precision";
+
+//---
+// Packs one band of a tile into the bitmap rows it covers. buf holds the band of the tile; origin
+// is the tile origin relative to the bitmap. Pixels outside the bitmap are ignored.
+//---
+template <class T>
+static void packTile(const void* buf, const ossimIpt& origin, ossim_uint32 tileWidth,
+                     ossim_uint32 tileHeight, double nullPix, potrace_bitmap_t* bitmap)
+{
+   const T* src = static_cast<const T*>(buf);
+   const T null_pix = static_cast<T>(nullPix);
+   ossim_int32 x0 = origin.x < 0 ? -origin.x : 0;
+   ossim_int32 y0 = origin.y < 0 ? -origin.y : 0;
+   ossim_int32 x1 = std::min<ossim_int32>(tileWidth, bitmap->w - origin.x);
+   ossim_int32 y1 = std::min<ossim_int32>(tileHeight, bitmap->h - origin.y);
+   if ((x0 >= x1) || (y0 >= y1))
+      return;
+
+   for (ossim_int32 y=y0; y<y1; ++y)
+   {
+      potrace_word* row = bitmap->map + (origin.y + y)*(ossim_int64)bitmap->dy;
+      ossimPotraceBitmapKernels::packRow(src + y*tileWidth + x0, x1 - x0, null_pix,
+                                         row, origin.x + x0);
+   }
+}
+
+namespace
+{
+   //---
+   // Copies of an input chain for the worker threads, since a chain is not thread safe and reuses
+   // its tile on the next request. The copies are made from the chain's state before the workers
+   // start. If the chain cannot be copied, there are fewer chains than workers and a worker waits
+   // for a free one.
+   //---
+   class ossimPotraceChainPool
+   {
+   public:
+      ossimPotraceChainPool(ossimImageSource* raster, ossim_uint32 size)
+      {
+         m_idle.push_back(raster);
+         for (ossim_uint32 i=1; i<size; ++i)
+         {
+            ossimKeywordlist kwl;
+            if (!raster->saveState(kwl))
+               break;
+            ossimRefPtr<ossimObject> obj =
+                  ossimObjectFactoryRegistry::instance()->createObject(kwl);
+            ossimRefPtr<ossimImageSource> copy = dynamic_cast<ossimImageSource*>(obj.get());
+            if (!copy.valid())
+               break;
+            copy->initialize();
+            if (copy->getBoundingRect() != raster->getBoundingRect())
+               break;
+            m_copies.push_back(copy);
+            m_idle.push_back(copy.get());
+         }
+      }
+
+      ossimImageSource* acquire()
+      {
+         std::unique_lock<std::mutex> lock (m_mutex);
+         while (m_idle.empty())
+            m_released.wait(lock);
+         ossimImageSource* chain = m_idle.back();
+         m_idle.pop_back();
+         return chain;
+      }
+
+      void release(ossimImageSource* chain)
+      {
+         {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_idle.push_back(chain);
+         }
+         m_released.notify_one();
+      }
+
+   private:
+      std::vector<ossimRefPtr<ossimImageSource> > m_copies;
+      std::vector<ossimImageSource*> m_idle;
+      std::mutex m_mutex;
+      std::condition_variable m_released;
+   };
+
+   // A chain of the pool, for the life of this object.
+   class ossimPotraceChainLease
+   {
+   public:
+      explicit ossimPotraceChainLease(ossimPotraceChainPool& pool)
+      :  m_pool(pool),
+         m_chain(pool.acquire())
+      {
+      }
+
+      ~ossimPotraceChainLease()
+      {
+         m_pool.release(m_chain);
+      }
+
+      ossimImageSource* get() const { return m_chain; }
+
+   private:
+      ossimPotraceChainLease(const ossimPotraceChainLease&);
+      ossimPotraceChainLease& operator=(const ossimPotraceChainLease&);
+
+      ossimPotraceChainPool& m_pool;
+      ossimImageSource* m_chain;
+   };
+}
+
+//---
+// Packs band 0 of the tiles covering region (image space) into bitmap, whose first pixel is at
+// bitmapUl. raster must not be in use by another thread; the tiles are packed where they are.
+//---
+static void packRegion(ossimImageSource* raster, const ossimIrect& region,
+                       const ossimIpt& bitmapUl, potrace_bitmap_t* bitmap)
+{
+   const ossim_int32 tileWidth = raster->getTileWidth();
+   const ossim_int32 tileHeight = raster->getTileHeight();
+
+   for (ossim_int32 y = region.ul().y; y <= region.lr().y; y += tileHeight)
+   {
+      for (ossim_int32 x = region.ul().x; x <= region.lr().x; x += tileWidth)
+      {
+         ossimIrect tileRect (x, y, std::min(x + tileWidth - 1, region.lr().x),
+                              std::min(y + tileHeight - 1, region.lr().y));
+         ossimRefPtr<ossimImageData> tile = raster->getTile(tileRect);
+
+         // Empty and null tiles are all off, which the zeroed bitmap already is:
+         if (!tile.valid() || !tile->getBuf(0) ||
+             (tile->getDataObjectStatus() == OSSIM_NULL) ||
+             (tile->getDataObjectStatus() == OSSIM_EMPTY))
+            continue;
+
+         const void* buf = tile->getBuf(0);
+         const double nullPix = tile->getNullPix(0);
+         const ossim_uint32 w = tile->getWidth();
+         const ossim_uint32 h = tile->getHeight();
+         const ossimIpt origin = tile->getOrigin() - bitmapUl;
+
+         switch (tile->getScalarType())
+         {
+         case OSSIM_UINT8:
+            packTile<ossim_uint8>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_SINT8:
+            packTile<ossim_sint8>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_USHORT11:
+         case OSSIM_USHORT12:
+         case OSSIM_USHORT13:
+         case OSSIM_USHORT14:
+         case OSSIM_USHORT15:
+         case OSSIM_UINT16:
+            packTile<ossim_uint16>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_SINT16:
+            packTile<ossim_sint16>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_UINT32:
+            packTile<ossim_uint32>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_SINT32:
+            packTile<ossim_sint32>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_FLOAT32:
+         case OSSIM_NORMALIZED_FLOAT:
+            packTile<ossim_float32>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         case OSSIM_FLOAT64:
+         case OSSIM_NORMALIZED_DOUBLE:
+            packTile<ossim_float64>(buf, origin, w, h, nullPix, bitmap);
+            break;
+         default:
+            break;
+         }
+      }
+   }
+}
+
+//---
+// Worker for convertToBitmap. Takes rows of tiles off nextRow until none are left, reading them
+// through a chain of its own. A row of tiles covers whole bitmap rows, so no two workers write
+// the same word.
+//---
+static void packTileRows(ossimPotraceChainPool* chains, const ossimIrect& rect,
+                         potrace_bitmap_t* bitmap, std::atomic<ossim_uint32>* nextRow)
+{
+   ossimPotraceChainLease raster (*chains);
+   const ossim_int32 tileHeight = raster.get()->getTileHeight();
+   const ossim_uint32 numRows = (rect.height() + tileHeight - 1) / tileHeight;
+
+   for (ossim_uint32 tileRow = (*nextRow)++; tileRow < numRows; tileRow = (*nextRow)++)
+   {
+      ossim_int32 y = rect.ul().y + tileRow*tileHeight;
+      ossimIrect region (rect.ul().x, y, rect.lr().x, std::min(y + tileHeight - 1, rect.lr().y));
+      packRegion(raster.get(), region, rect.ul(), bitmap);
+   }
+}
+
+namespace
+{
+   // Feeds the tiled tracer from copies of the input chain, one per tracer thread.
+   class ossimPotraceChainSource : public ossimPotraceTileTracer::BitmapSource
+   {
+   public:
+      ossimPotraceChainSource(ossimImageSource* raster, const ossimIpt& origin,
+                              ossim_uint32 numThreads)
+      :  m_chains(raster, numThreads),
+         m_origin(origin)
+      {
+      }
+
+      virtual bool fillTile(const ossimIrect& rect, potrace_bitmap_t* bitmap)
+      {
+         ossimIrect region (rect.ul() + m_origin, rect.lr() + m_origin);
+         ossimPotraceChainLease raster (m_chains);
+         packRegion(raster.get(), region, region.ul(), bitmap);
+         return true;
+      }
+
+   private:
+      ossimPotraceChainPool m_chains;
+      ossimIpt m_origin;
+   };
+}
 
 ossimPotraceTool::ossimPotraceTool()
 :  m_mode (LINESTRING),
    m_alphamax (1.0),
    m_turdSize (4),
+   m_tileSize (0),
+   m_format (ossimPotraceVectorWriter::GEOJSON),
+   m_simplify (0.0),
+   m_precision (8),
    m_outputToConsole(false),
    m_maskBitmap (0),
    m_productBitmap (0)
@@ -58,6 +300,10 @@ void ossimPotraceTool::setUsage(ossimArgumentParser& ap)
          "more sharp corners will be produced. If this parameter is 0, then no smoothing will be "
          "performed and the output is a polygon. If this parameter is greater than 1.3, then all "
          "corners are suppressed and the output is completely smooth");
+   au->addCommandLineOption("--format geojson|geojsonseq|flatgeobuf",
+         "Output vector format. geojsonseq writes one GeoJSON feature per line. Defaults to the "
+         "format matching the output file extension (.fgb, .geojsonl, .geojsons or .ndjson), "
+         "else geojson.");
    au->addCommandLineOption("--mode polygon|linestring",
          "Specifies whether to represent foreground-background boundary as polygons or line-strings"
          ". Polygons are closed regions surrounding either null or non-null pixels. Most viewers "
@@ -67,6 +313,15 @@ void ossimPotraceTool::setUsage(ossimArgumentParser& ap)
          "Use the raster file provided as a mask to exclude any vertices found within 1 pixel of "
          "a null mask pixel. Implies linestring mode since polygons may not be closed. The mask "
          "should be a single-band image, but if multi-band, only band 0 will be referenced.");
+   au->addCommandLineOption("--precision <digits>",
+         "Number of decimal places written for each coordinate. Defaults to 8.");
+   au->addCommandLineOption("--simplify <pixels>",
+         "Drop vertices that are within this many pixels of the line through their neighbors "
+         "(Douglas-Peucker). Defaults to 0, writing all vertices.");
+   au->addCommandLineOption("--tile-size <pixels>",
+         "Trace in square tiles of this size on worker threads, joining the paths that cross "
+         "tile seams. Needs memory for a few tiles instead of the whole image. Defaults to 0, "
+         "tracing the whole image at once.");
    au->addCommandLineOption("--turdsize <int>", "suppress speckles of up to this many pixels.");
 }
 
@@ -81,6 +336,9 @@ bool ossimPotraceTool::initialize(ossimArgumentParser& ap)
    if ( ap.read("--alphamax", sp1))
       m_kwl.addPair(ALPHAMAX_KW, ts1);
 
+   if ( ap.read("--format", sp1))
+      m_kwl.addPair(FORMAT_KW, ts1);
+
    if ( ap.read("--mode", sp1))
       m_kwl.addPair(MODE_KW, ts1);
 
@@ -92,6 +350,15 @@ bool ossimPotraceTool::initialize(ossimArgumentParser& ap)
       m_kwl.addPair( key.str(), ts1 );
    }
 
+   if ( ap.read("--precision", sp1))
+      m_kwl.addPair(PRECISION_KW, ts1);
+
+   if ( ap.read("--simplify", sp1))
+      m_kwl.addPair(SIMPLIFY_KW, ts1);
+
+   if ( ap.read("--tile-size", sp1))
+      m_kwl.addPair(TILE_SIZE_KW, ts1);
+
    if ( ap.read("--turdsize", sp1))
       m_kwl.addPair(TURDSIZE_KW, ts1);
 
@@ -120,6 +387,10 @@ void ossimPotraceTool::initialize(const ossimKeywordlist& kwl)
    if (!value.empty())
       m_turdSize = value.toInt();
 
+   value = m_kwl.findKey(TILE_SIZE_KW);
+   if (!value.empty())
+      m_tileSize = value.toUInt32();
+
    value = m_kwl.findKey(MODE_KW);
    if (value.contains("polygon"))
       m_mode = POLYGON;
@@ -132,7 +403,26 @@ void ossimPotraceTool::initialize(const ossimKeywordlist& kwl)
       throw ossimException(xmsg.str());
    }
 
+   value = m_kwl.findKey(SIMPLIFY_KW);
+   if (!value.empty())
+      m_simplify = value.toDouble();
+
+   value = m_kwl.findKey(PRECISION_KW);
+   if (!value.empty())
+      m_precision = value.toInt();
+
    ossimChipProcTool::initialize(kwl);
+
+   // Output format follows the product file extension unless specified:
+   value = m_kwl.findKey(FORMAT_KW);
+   if (value.empty())
+      m_format = ossimPotraceVectorWriter::formatFromFilename(m_productFilename);
+   else if (!ossimPotraceVectorWriter::stringToFormat(value, m_format))
+   {
+      xmsg <<"ossimPotraceTool:"<<__LINE__<<" Unallowed format requested: <"<<value<<">."
+            <<endl;
+      throw ossimException(xmsg.str());
+   }
 }
 
 void ossimPotraceTool::initProcessingChain()
@@ -155,10 +445,7 @@ bool ossimPotraceTool::execute()
       throw ossimException(xmsg.str());
    }
 
-   // Generate bitmap for input image:
-   m_productBitmap = convertToBitmap(m_imgLayers[0].get());
-
-   // If there is a mask, generate a bitmap for it as well:
+   // If there is a mask, generate a bitmap for it:
    m_maskBitmap = 0;
    if (m_imgLayers.size() == 2)
    {
@@ -166,228 +453,43 @@ bool ossimPotraceTool::execute()
       m_mode = LINESTRING;
    }
 
-   // Perform vectorization:
+   // Perform vectorization, in tiles if requested so the input bitmap is never whole:
    potrace_param_t* potraceParam = potrace_param_default();
    potraceParam->turdsize = m_turdSize;
    potraceParam->alphamax = m_alphamax;
-   potrace_state_t* potraceOutput = potrace_trace(potraceParam, m_productBitmap);
-   if (!potraceOutput)
+   potrace_state_t* potraceOutput = 0;
+   if (m_tileSize)
    {
-      xmsg <<"ossimPotraceTool:"<<__LINE__<<" Null pointer returned from potrace_trace!";
-      throw ossimException(xmsg.str());
+      ossimIrect rect;
+      m_imgLayers[0]->getImageGeometry()->getBoundingRect(rect);
+      ossim_uint32 numThreads = std::thread::hardware_concurrency();
+      if (numThreads == 0)
+         numThreads = 1;
+      ossimPotraceChainSource source (m_imgLayers[0].get(), rect.ul(), numThreads);
+      ossimPotraceTileTracer tracer;
+      tracer.setTileSize(m_tileSize);
+      tracer.setNumThreads(numThreads);
+      potraceOutput = tracer.trace(potraceParam, rect.width(), rect.height(), &source);
    }
-
-   if (m_mode == LINESTRING)
-      transformLineStrings(potraceOutput);
    else
-      transformPolygons(potraceOutput);
-
-   // Write to output vector file:
-   if (!writeGeoJSON(potraceOutput->plist))
-      return false;
-
-   // Release memory:
-   //potrace_state_free(potraceOutput);
-   //free(potraceBitmap->map);
-   free(potraceParam);
-
-   return true;
-}
-
-void ossimPotraceTool::transformLineStrings(potrace_state_t* potraceOutput)
-{
-   // This is a fairly complex process because potrace assumes all paths are closed, i.e., the
-   // last vertex of a path is the same as the first. For linestring mode, this is not always
-   // true since the path may hit the border or masked region, in which case it needs to be
-   // split into two or more paths.
-
-   ossimIrect rect;
-   m_geom->getBoundingRect(rect);
-   rect.expand(ossimIpt(-1,-1));
-
-   // Vector coordinates are in image space. Need geom to convert to geographic lat/lon:
-   potrace_path_t* path = potraceOutput->plist;
-   potrace_path_t* pathToDelete;
-   ossimDpt imgPt;
-   vector<Path*> originalPaths;
-   vector<Path*> adjustedPaths;
-
-   // Populate the std::vector with original list of potrace paths:
-   while (path)
    {
-      //cout << "\nProcessing path "<<(long)path<<endl;
-      if (path->curve.n > 0)
-      {
-         // Start by converting all paths to C++ data structures:
-         Path* p = new Path;
-         for (int segment=0; segment<path->curve.n; ++segment)
-         {
-            //cout << "  Processing segment "<<segment;
-            p->addPotraceCurve(path->curve, segment);
-         }
-         originalPaths.push_back(p);
-      }
-      potrace_path_t* delete_this_path = path;
-      path = path->next;
-      free(delete_this_path); // Don't need old path anymore
+      m_productBitmap = convertToBitmap(m_imgLayers[0].get());
+      potraceOutput = potrace_trace(potraceParam, m_productBitmap);
    }
-
-   // All paths are now represented by line segments in convenient C++ vector structure. Now
-   // need to filter out masked points, splitting up paths as they encounter the masked regions:
-   for (size_t i=0; i<originalPaths.size(); ++i)
+   if (!potraceOutput)
    {
-      Path* original = originalPaths[i];
-      bool outside = false;
-
-      //cout << "\nProcessing originalPath["<<i<<"] with numVertices="<<original->vertices.size()<<endl;
-      Path* adjusted = 0;
-      for (size_t v=0; v<original->vertices.size(); ++v)
-      {
-         imgPt = original->vertices[v];
-         if ( rect.pointWithin(imgPt) && !pixelIsMasked(imgPt, m_maskBitmap))
-         {
-            if (!adjusted)
-            {
-               adjusted = new Path;
-               adjustedPaths.push_back(adjusted);
-               //cout << "  Creating adjusted="<<(long)adjusted<<endl;
-            }
-            adjusted->vertices.push_back(imgPt);
-            //cout << "  Adding to adjusted, imgPt:"<<imgPt<<endl;
-
-            if (outside)
-            {
-               // Coming in from the outside, so not closed:
-               adjusted->closed = false;
-               outside = false;
-            }
-         }
-         else if (!outside)
-         {
-            // Just went outside. Close this adjusted path and start a new one:
-            //cout << "  Hit outside, end of adjusted:"<<(long)adjusted<<endl;
-            if (adjusted)
-               adjusted->closed = false;
-            adjusted = 0;
-            outside = true;
-         }
-      }
+      xmsg <<"ossimPotraceTool:"<<__LINE__<<" Null pointer returned from potrace_trace!";
+      throw ossimException(xmsg.str());
    }
 
-   // The adjustedPaths list contains only vertices inside the ROI. Now need to move back into
-   // potrace space to prepare potrace data structures for geojson output:
-   ossimGpt gndPt;
-   potrace_path_t* previous_path = 0;
-   vector<Path*>::iterator path_iter = adjustedPaths.begin();
-   while (path_iter != adjustedPaths.end())
-   {
-      // Don't bother with single-vertex "paths":
-      Path* adjusted = *path_iter;
-      if (adjusted->vertices.size() < 3)
-      {
-         ++path_iter;
-         continue;
-      }
-
-      // Convert image point vertices to ground points and repopulate using potrace
-      // datastructures:
-      //cout << "\nProcessing adjustedPaths["<<i<<"] with numVertices="<<adjusted->vertices.size()<<endl;
-      path = new potrace_path_t;
-      //cout << "  Created potrace path:"<<(long)path<<endl;
-      if (previous_path)
-         previous_path->next = path;
-      else
-         potraceOutput->plist = path;
-
-      int num_segments = (adjusted->vertices.size()+1)/2;
-      path->curve.n = num_segments;
-      path->curve.c = new potrace_dpoint_t[num_segments][3];
-      path->curve.tag = new int[num_segments];
-      path->area = 1;
-      path->sign = 1;
-      path->sibling = 0;
-      path->childlist = 0;
-      path->priv = 0;
-      path->next = 0;
-
-      // Loop to transfer the vertices to the potrace structure, transforming to lat, lon:
-      int segment = 0;
-      int adj_v = 0;
-      while (adj_v < adjusted->vertices.size())
-      {
-         path->curve.tag[segment] = POTRACE_CORNER;
+   // Transform and write to output vector file in one pass:
+   bool status = writeVectors(potraceOutput->plist);
 
-         // Transform:
-         imgPt = adjusted->vertices[adj_v++];
-         m_geom->localToWorld(imgPt, gndPt);
-         path->curve.c[segment][1].x = gndPt.lon;
-         path->curve.c[segment][1].y = gndPt.lat;
-         //cout << "  Inserted ["<<adj_v-1<<"], imgPt:"<<imgPt<<" --> ("<<gndPt.lon<<", "<<gndPt.lat<<")"<<endl;
-
-         if (adj_v == adjusted->vertices.size())
-         {
-            //cout << "  Inserted above as last"<<endl;
-
-            path->curve.c[segment][2].x = gndPt.lon;
-            path->curve.c[segment][2].y = gndPt.lat;
-         }
-         else
-         {
-            imgPt = adjusted->vertices[adj_v++];
-            m_geom->localToWorld(imgPt, gndPt);
-            path->curve.c[segment][2].x = gndPt.lon;
-            path->curve.c[segment][2].y = gndPt.lat;
-            //cout << "  Inserted ["<<adj_v-1<<"], imgPt:"<<imgPt<<" --> ("<<gndPt.lon<<", "<<gndPt.lat<<")"<<endl;
-         }
-
-         // Mark the last point as a line segment endpoint to avoid closure:
-         if (adj_v == adjusted->vertices.size() && !adjusted->closed)
-            path->curve.tag[segment] = POTRACE_ENDPOINT;
-
-         //cout << "  Finished segment:"<<segment<<", tag="<<path->curve.tag[segment]<<endl;
-         ++segment;
-      }
-      previous_path = path;
-
-      // Don't need the adjusted path anymore:
-      delete adjusted;
-      adjusted = 0;
-      ++path_iter;
-   }
-}
+   // Release memory:
+   potrace_state_free(potraceOutput);
+   potrace_param_free(potraceParam);
 
-void ossimPotraceTool::transformPolygons(potrace_state_t* potraceOutput)
-{
-   // Vector coordinates are in image space. Need geom to convert to geographic lat/lon:
-   potrace_path_t* path = potraceOutput->plist;
-   ossimDpt imgPt;
-   ossimGpt gndPt;
-   while (path)
-   {
-      for (int segment=0; segment<path->curve.n;)
-      {
-         //cout << "\nWorking on path="<<(long)path<<" segment="<<segment<<", tag="<<path->curve.tag[segment]<<endl;
-         // Convert up to 3 possible vertices per segment
-         for (int v=0; v<3; ++v)
-         {
-            if ((v == 0) && (path->curve.tag[segment] == POTRACE_CORNER))
-            {
-               //cout << "Hit corner"<<endl;
-               continue;
-            }
-
-            imgPt.x = path->curve.c[segment][v].x;
-            imgPt.y = path->curve.c[segment][v].y;
-            //cout << "imgPt["<<v<<"] = "<<imgPt<<endl;
-
-            m_geom->localToWorld(imgPt, gndPt);
-            path->curve.c[segment][v].x = gndPt.lon;
-            path->curve.c[segment][v].y = gndPt.lat;
-         }
-         ++segment;
-      }
-      path = path->next;
-   }
+   return status;
 }
 
 void ossimPotraceTool::getKwlTemplate(ossimKeywordlist& kwl)
@@ -396,14 +498,29 @@ void ossimPotraceTool::getKwlTemplate(ossimKeywordlist& kwl)
    value << "polygon|linestring (optional, defaults to polygon)";
    kwl.addPair(MODE_KW, value.str());
 
-   value.clear();
+   value.str("");
    value<<"<float> (optional, defaults to "<<m_alphamax<<")";
    kwl.addPair(ALPHAMAX_KW, value.str());
 
-   value.clear();
+   value.str("");
    value<<"<int> (optional, defaults to "<<m_turdSize<<")";
    kwl.addPair(TURDSIZE_KW, value.str());
 
+   value.str("");
+   value<<"<pixels> (optional, defaults to "<<m_tileSize<<" for tracing the whole image at once)";
+   kwl.addPair(TILE_SIZE_KW, value.str());
+
+   kwl.addPair(FORMAT_KW, "geojson|geojsonseq|flatgeobuf (optional, defaults to matching the "
+         "output file extension)");
+
+   value.str("");
+   value<<"<pixels> (optional, defaults to "<<m_simplify<<" for no simplification)";
+   kwl.addPair(SIMPLIFY_KW, value.str());
+
+   value.str("");
+   value<<"<digits> (optional, defaults to "<<m_precision<<")";
+   kwl.addPair(PRECISION_KW, value.str());
+
    kwl.add("image_file0", "<input-raster-file>");
    kwl.add("image_file1", "<mask-file> (optional)");
    kwl.add(ossimKeywordNames::OUTPUT_FILE_KW, "<output-vector-file>");
@@ -418,53 +535,33 @@ potrace_bitmap_t* ossimPotraceTool::convertToBitmap(ossimImageSource* raster)
    raster->getImageGeometry()->getBoundingRect(rect);
    potraceBitmap->w = rect.width();
    potraceBitmap->h = rect.height();
-   int pixelsPerWord = 8 * sizeof(int*);
-   potraceBitmap->dy = (int) ceil((double)rect.width()/pixelsPerWord);
-
-   // Allocate the bitmap memory:
-   unsigned long bufLength = potraceBitmap->dy*potraceBitmap->h;
-   potraceBitmap->map = new potrace_word[bufLength];
-
-   // Prepare to sequence over all input image tiles and fill the bitmap image:
-   ossimRefPtr<ossimImageSourceSequencer> sequencer = new ossimImageSourceSequencer(raster);
-   ossimRefPtr<ossimImageData> tile = sequencer->getNextTile();
-   double null_pix = tile->getNullPix(0);
-   unsigned long offset=0;
-   ossimIpt pt_ul, pt, pt_lr;
-
-   // Loop to fill bitmap buffer:
-   while (tile.valid())
+   int pixelsPerWord = 8 * sizeof(potrace_word);
+   potraceBitmap->dy = (rect.width() + pixelsPerWord - 1)/pixelsPerWord;
+
+   // Allocate the bitmap memory. Zeroed, so pixels not covered by a valid tile are off:
+   unsigned long bufLength = potraceBitmap->dy*(unsigned long)potraceBitmap->h;
+   potraceBitmap->map = new potrace_word[bufLength]();
+
+   // Pack rows of tiles in parallel, each worker reading through its own copy of the chain:
+   ossim_uint32 tileHeight = raster->getTileHeight();
+   ossim_uint32 numTileRows = (rect.height() + tileHeight - 1) / tileHeight;
+   ossim_uint32 numThreads = std::thread::hardware_concurrency();
+   if (numThreads == 0)
+      numThreads = 1;
+   if (numThreads > numTileRows)
+      numThreads = numTileRows;
+
+   ossimPotraceChainPool chains (raster, numThreads);
+   std::atomic<ossim_uint32> nextRow (0);
+   std::vector<std::thread> workers;
+   for (ossim_uint32 i=1; i<numThreads; ++i)
    {
-      pt_ul = tile->getOrigin();
-      pt_lr.x = pt_ul.x + tile->getWidth();
-      pt_lr.y = pt_ul.y + tile->getHeight();
-      if (pt_lr.x > rect.lr().x)
-         pt_lr.x = rect.lr().x;
-      if (pt_lr.y > rect.lr().y)
-         pt_lr.y = rect.lr().y;
-
-      // Nested loops over all pixels in input tile:
-      for (pt.y=pt_ul.y; pt.y < pt_lr.y; ++pt.y)
-      {
-         offset = pt_ul.x/pixelsPerWord + pt.y*potraceBitmap->dy;
-         for (pt.x=pt_ul.x; pt.x<pt_lr.x; )
-         {
-            // Loop to pack a word buffer with pixel on (non-null) or off bit in proper positions:
-            unsigned long wordBuf = 0;
-            for (int bitpos=pixelsPerWord-1; bitpos>=0; --bitpos)
-            {
-               unsigned long pixel = (tile->getPix(pt) != null_pix) ? 1 : 0;
-               wordBuf |= pixel << bitpos;
-               ++pt.x;
-               if (pt.x >= pt_lr.x)
-                  break;
-            }
-            potraceBitmap->map[offset++] = wordBuf;
-         }
-      }
-
-      tile = sequencer->getNextTile();
+      workers.push_back(std::thread(packTileRows, &chains, std::cref(rect), potraceBitmap,
+                                    &nextRow));
    }
+   packTileRows(&chains, rect, potraceBitmap, &nextRow);
+   for (ossim_uint32 i=0; i<workers.size(); ++i)
+      workers[i].join();
 
 #if 0
    FILE* pbm = fopen("TEMP.pbm", "w");
@@ -479,7 +576,7 @@ bool ossimPotraceTool::pixelIsMasked(const ossimIpt& image_pt, potrace_bitmap_t*
    if (bitmap == 0)
       return false;
 
-   int pixelsPerWord = 8 * sizeof(int*);
+   int pixelsPerWord = 8 * sizeof(potrace_word);
    unsigned long offset = image_pt.x/pixelsPerWord + image_pt.y*bitmap->dy;
    int shift = pixelsPerWord - (image_pt.x % pixelsPerWord) - 1;
    unsigned long wordBuf = bitmap->map[offset];
@@ -490,93 +587,104 @@ bool ossimPotraceTool::pixelIsMasked(const ossimIpt& image_pt, potrace_bitmap_t*
    return false;
 }
 
-bool ossimPotraceTool::writeGeoJSON(potrace_path_t* vectorList)
+bool ossimPotraceTool::writeVectors(potrace_path_t* vectorList)
 {
    ostringstream xmsg;
 
-   FILE* outFile = fopen(m_productFilename.chars(), "w");
-   if (!outFile)
+   ossimPotraceVectorWriter writer;
+   writer.setFormat(m_format);
+   writer.setGeometryType(m_mode == POLYGON ? ossimPotraceVectorWriter::POLYGON
+                                            : ossimPotraceVectorWriter::LINESTRING);
+   writer.setImageGeometry(m_geom.get());
+   writer.setSimplifyTolerance(m_simplify);
+   writer.setPrecision(m_precision);
+
+   // Console output gets a copy as it is written rather than reading back the file:
+   ostream* echo = (m_outputToConsole && m_consoleStream) ? m_consoleStream : 0;
+   if ((m_productFilename.empty() && !echo) || !writer.open(m_productFilename, echo))
    {
       xmsg <<"ossimPotraceTool:"<<__LINE__<<" Could not open output file <"<<m_productFilename
             <<"> for writing.";
       throw ossimException(xmsg.str());
    }
 
-   potrace_geojson(outFile, vectorList, (int) (m_mode == POLYGON));
-   fclose(outFile);
+   if (m_mode == POLYGON)
+      writePolygons(vectorList, writer);
+   else
+      writeLineStrings(vectorList, writer);
 
-   if (m_outputToConsole && m_consoleStream)
+   if (!writer.close())
    {
-      ifstream vectorFile (m_productFilename.chars());
-      if (vectorFile.fail())
-      {
-         xmsg <<"ossimPotraceTool:"<<__LINE__<<" Error encountered opening temporary vector file at: "
-               "<"<<m_productFilename<<">.";
-         throw ossimException(xmsg.str());
-      }
-
-      *m_consoleStream << vectorFile.rdbuf();
-      vectorFile.close();
+      xmsg <<"ossimPotraceTool:"<<__LINE__<<" Error encountered writing output file <"
+            <<m_productFilename<<">.";
+      throw ossimException(xmsg.str());
    }
 
    return true;
 }
 
-ossimPotraceTool::Path::~Path()
+void ossimPotraceTool::writePolygons(potrace_path_t* tree, ossimPotraceVectorWriter& writer)
 {
-   vertices.clear();
+   // Each top-level path is written with its children as holes. Islands in the holes are
+   // features of their own:
+   vector<ossimDpt> ring;
+   for (potrace_path_t* p = tree; p; p = p->sibling)
+   {
+      if (p->curve.n != 0)
+      {
+         writer.beginFeature();
+         ring.clear();
+         ossimPotraceVectorWriter::flattenCurve(p->curve, ring);
+         writer.addRing(ring, true);
+         for (potrace_path_t* q = p->childlist; q; q = q->sibling)
+         {
+            ring.clear();
+            ossimPotraceVectorWriter::flattenCurve(q->curve, ring);
+            writer.addRing(ring, true);
+         }
+         writer.endFeature();
+      }
+      for (potrace_path_t* q = p->childlist; q; q = q->sibling)
+         writePolygons(q->childlist, writer);
+   }
 }
 
-
-void ossimPotraceTool::Path::addPotraceCurve(potrace_curve_t& curve, int segment)
+void ossimPotraceTool::writeLineStrings(potrace_path_t* vectorList,
+                                        ossimPotraceVectorWriter& writer)
 {
-   potrace_dpoint_t *c = curve.c[segment];
-   if (curve.tag[segment] == POTRACE_CORNER)
-   {
-      // Just add next connected line segment
-      ossimDpt v1 (c[1].x, c[1].y);
-      ossimDpt v2 (c[2].x, c[2].y);
-      vertices.push_back(v1);
-      vertices.push_back(v2);
-      //cout <<"    Added corners    v1:"<<v1<<endl;
-      //cout <<"                     v2:"<<v2<<endl;
-   }
-   else
+   // Potrace paths are all closed, but a path that hits the border or a masked region is split
+   // into open pieces there.
+   ossimIrect rect;
+   m_geom->getBoundingRect(rect);
+   rect.expand(ossimIpt(-1,-1));
+
+   vector<ossimDpt> vertices;
+   vector<ossimDpt> piece;
+   for (potrace_path_t* path = vectorList; path; path = path->next)
    {
-      // Need to convert bezier curve representation to line segments:
-      ossimDpt v0;
-      ossimDpt v1 (c[0].x, c[0].y);
-      ossimDpt v2 (c[1].x, c[1].y);
-      ossimDpt v3 (c[2].x, c[2].y);
-
-      // Need the first vertex from the previous segment if available:
-      if (segment == 0)
-         v0 = v1;
-      else
-      {
-         c = curve.c[segment-1];
-         v0.x = c[2].x;
-         v0.y = c[2].y;
-      }
-      //cout <<"    Processing curve v0:"<<v0<<endl;
-      //cout <<"                     v1:"<<v1<<endl;
-      //cout <<"                     v2:"<<v2<<endl;
-      //cout <<"                     v3:"<<v3<<endl;
-
-      // Now loop to extract line segments from bezier curve:
-      double step, t, s;
-      ossimDpt vertex;
-      step = 1.0 / 8.0;
-      t = step;
-      for (int i=0; i<8; i++)
+      vertices.clear();
+      ossimPotraceVectorWriter::flattenCurve(path->curve, vertices);
+
+      bool split = false;
+      piece.clear();
+      for (size_t v=0; v<=vertices.size(); ++v)
       {
-         s = 1.0 - t;
-         vertex.x = s*s*s*v0.x + 3*(s*s*t)*v1.x + 3*(t*t*s)*v2.x + t*t*t*v3.x;
-         vertex.y = s*s*s*v0.y + 3*(s*s*t)*v1.y + 3*(t*t*s)*v2.y + t*t*t*v3.y;
-         vertices.push_back(vertex);
-         t += step;
-         //cout <<"    added vertex:"<<vertex<<endl;
+         if ((v < vertices.size()) && rect.pointWithin(vertices[v]) &&
+             !pixelIsMasked(vertices[v], m_maskBitmap))
+         {
+            piece.push_back(vertices[v]);
+            continue;
+         }
+
+         // End of a piece. Don't bother with pieces of fewer than three vertices:
+         if (piece.size() >= 3)
+         {
+            writer.beginFeature();
+            writer.addRing(piece, !split && (v == vertices.size()));
+            writer.endFeature();
+         }
+         piece.clear();
+         split = true;
       }
    }
 }
-
@@ -11,6 +11,7 @@
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/util/ossimChipProcTool.h>
+#include <potrace/src/ossimPotraceVectorWriter.h>
 
 extern "C" {
 #include "potracelib.h"
@@ -39,27 +40,21 @@ public:
    virtual void getKwlTemplate(ossimKeywordlist& kwl);
 
 private:
-   class Path
-   {
-   public:
-      Path() : closed(true) {}
-      ~Path();
-      void addPotraceCurve(potrace_curve_t& curve, int segment);
-      std::vector<ossimDpt> vertices;
-      bool closed;
-   };
-
    virtual void initProcessingChain();
    virtual void finalizeChain();
    potrace_bitmap_t* convertToBitmap(ossimImageSource* handler);
-   bool writeGeoJSON(potrace_path_t* vectorList);
+   bool writeVectors(potrace_path_t* vectorList);
+   void writePolygons(potrace_path_t* tree, ossimPotraceVectorWriter& writer);
+   void writeLineStrings(potrace_path_t* vectorList, ossimPotraceVectorWriter& writer);
    bool pixelIsMasked(const ossimIpt& image_pt, potrace_bitmap_t* bitmap) const;
-   void transformLineStrings(potrace_state_t* pathTree);
-   void transformPolygons(potrace_state_t* pathTree);
 
    OutputMode m_mode;
    double m_alphamax;
    int m_turdSize;
+   ossim_uint32 m_tileSize;
+   ossimPotraceVectorWriter::Format m_format;
+   double m_simplify;
+   int m_precision;
    bool m_outputToConsole;
    potrace_bitmap_t* m_maskBitmap;
    potrace_bitmap_t* m_productBitmap;
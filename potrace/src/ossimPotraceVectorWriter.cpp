@@ -0,0 +1,661 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#include <potrace/src/ossimPotraceVectorWriter.h>
+#include <ossim/base/ossimGpt.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+// Output is handed to the streams in chunks of about this many bytes:
+static const size_t BUFFER_SIZE = 1 << 20;
+
+// FlatGeobuf 3.0.1 magic bytes and geometry type codes:
+static const char FGB_MAGIC[8] = { 'f', 'g', 'b', 3, 'f', 'g', 'b', 1 };
+static const ossim_uint8 FGB_LINESTRING = 2;
+static const ossim_uint8 FGB_POLYGON = 3;
+
+namespace
+{
+   //---
+   // Lays out a size prefixed flatbuffer front to back at the end of a byte buffer. Positions are
+   // relative to the size prefix, which is how the flatbuffers library aligns them. Offsets
+   // always point forward, so children are put after their parents and linked afterwards.
+   // Assumes a little endian host, as the rest of OSSIM does.
+   //---
+   class FlatBufferLayout
+   {
+   public:
+      FlatBufferLayout(vector<char>& buf) : m_buf(buf), m_base(buf.size()) {}
+
+      size_t base() const { return m_base; }
+      size_t pos() const { return m_buf.size() - m_base; }
+
+      template <class T> size_t put(T value)
+      {
+         const size_t at = pos();
+         const char* bytes = reinterpret_cast<const char*>(&value);
+         m_buf.insert(m_buf.end(), bytes, bytes + sizeof(T));
+         return at;
+      }
+
+      /** Pads with zeros to remainder modulo align. */
+      void pad(size_t align, size_t remainder=0)
+      {
+         while (pos() % align != remainder)
+            m_buf.push_back(0);
+      }
+
+      /** Sets the offset field at "at" to point to the object at target. */
+      void link(size_t at, size_t target)
+      {
+         const ossim_uint32 offset = (ossim_uint32) (target - at);
+         memcpy(&m_buf[m_base + at], &offset, sizeof(offset));
+      }
+
+      /** Sets the size prefix, padding the buffer to the largest alignment used. */
+      void finish()
+      {
+         pad(8);
+         const ossim_uint32 size = (ossim_uint32) (pos() - sizeof(ossim_uint32));
+         memcpy(&m_buf[m_base], &size, sizeof(size));
+      }
+
+   private:
+      vector<char>& m_buf;
+      size_t m_base;
+   };
+
+   // Squared distance from p to the segment a-b.
+   double segmentDistance2(const ossimDpt& p, const ossimDpt& a, const ossimDpt& b)
+   {
+      const double dx = b.x - a.x;
+      const double dy = b.y - a.y;
+      const double len2 = dx*dx + dy*dy;
+      double t = 0.0;
+      if (len2 > 0.0)
+         t = std::min(1.0, std::max(0.0, ((p.x - a.x)*dx + (p.y - a.y)*dy) / len2));
+      const double ex = a.x + t*dx - p.x;
+      const double ey = a.y + t*dy - p.y;
+      return ex*ex + ey*ey;
+   }
+}
+
+ossimPotraceVectorWriter::ossimPotraceVectorWriter()
+:  m_format (GEOJSON),
+   m_geometryType (POLYGON),
+   m_geom (0),
+   m_tolerance (0.0),
+   m_precision (8),
+   m_scale (100000000),
+   m_echo (0),
+   m_ok (false),
+   m_flushed (0),
+   m_countPos (0),
+   m_envelopePos (0),
+   m_numFeatures (0),
+   m_skipFeature (false)
+{
+}
+
+ossimPotraceVectorWriter::~ossimPotraceVectorWriter()
+{
+   if (m_file.is_open())
+      m_file.close();
+}
+
+bool ossimPotraceVectorWriter::stringToFormat(const ossimString& s, Format& format)
+{
+   ossimString str = s.trim();
+   str.downcase();
+   if (str == "geojson")
+      format = GEOJSON;
+   else if ((str == "geojsonseq") || (str == "ndjson"))
+      format = GEOJSON_SEQ;
+   else if ((str == "flatgeobuf") || (str == "fgb"))
+      format = FLATGEOBUF;
+   else
+      return false;
+   return true;
+}
+
+ossimPotraceVectorWriter::Format ossimPotraceVectorWriter::formatFromFilename(
+   const ossimFilename& file)
+{
+   ossimString ext = file.ext();
+   ext.downcase();
+   if (ext == "fgb")
+      return FLATGEOBUF;
+   if ((ext == "geojsonl") || (ext == "geojsons") || (ext == "ndjson"))
+      return GEOJSON_SEQ;
+   return GEOJSON;
+}
+
+void ossimPotraceVectorWriter::flattenCurve(const potrace_curve_t& curve,
+                                            vector<ossimDpt>& vertices)
+{
+   if (curve.n == 0)
+      return;
+
+   // Each segment starts where the previous one ended, the first where the last one ends:
+   potrace_dpoint_t cur = curve.c[curve.n-1][2];
+   for (int segment=0; segment<curve.n; ++segment)
+   {
+      const potrace_dpoint_t* c = curve.c[segment];
+      if (curve.tag[segment] == POTRACE_CURVETO)
+      {
+         for (int i=1; i<=8; ++i)
+         {
+            const double t = i / 8.0;
+            const double s = 1.0 - t;
+            vertices.push_back(ossimDpt(
+               s*s*s*cur.x + 3*(s*s*t)*c[0].x + 3*(t*t*s)*c[1].x + t*t*t*c[2].x,
+               s*s*s*cur.y + 3*(s*s*t)*c[0].y + 3*(t*t*s)*c[1].y + t*t*t*c[2].y));
+         }
+      }
+      else
+      {
+         vertices.push_back(ossimDpt(c[1].x, c[1].y));
+         vertices.push_back(ossimDpt(c[2].x, c[2].y));
+      }
+      cur = c[2];
+   }
+}
+
+void ossimPotraceVectorWriter::setFormat(Format format)
+{
+   m_format = format;
+}
+
+ossimPotraceVectorWriter::Format ossimPotraceVectorWriter::getFormat() const
+{
+   return m_format;
+}
+
+void ossimPotraceVectorWriter::setGeometryType(GeometryType type)
+{
+   m_geometryType = type;
+}
+
+ossimPotraceVectorWriter::GeometryType ossimPotraceVectorWriter::getGeometryType() const
+{
+   return m_geometryType;
+}
+
+void ossimPotraceVectorWriter::setImageGeometry(const ossimImageGeometry* geom)
+{
+   m_geom = geom;
+}
+
+void ossimPotraceVectorWriter::setSimplifyTolerance(double pixels)
+{
+   m_tolerance = pixels > 0.0 ? pixels : 0.0;
+}
+
+double ossimPotraceVectorWriter::getSimplifyTolerance() const
+{
+   return m_tolerance;
+}
+
+void ossimPotraceVectorWriter::setPrecision(int decimals)
+{
+   // Beyond 12 places, rounded coordinates could overflow 64 bits:
+   m_precision = std::min(12, std::max(0, decimals));
+   m_scale = 1;
+   for (int i=0; i<m_precision; ++i)
+      m_scale *= 10;
+}
+
+int ossimPotraceVectorWriter::getPrecision() const
+{
+   return m_precision;
+}
+
+bool ossimPotraceVectorWriter::open(const ossimFilename& file, ostream* echo)
+{
+   m_echo = echo;
+   m_ok = true;
+   m_buffer.clear();
+   m_buffer.reserve(BUFFER_SIZE + BUFFER_SIZE/4);
+   m_flushed = 0;
+   m_countPos = 0;
+   m_envelopePos = 0;
+   m_envelope[0] = m_envelope[1] = numeric_limits<double>::max();
+   m_envelope[2] = m_envelope[3] = -numeric_limits<double>::max();
+   m_numFeatures = 0;
+
+   if (!file.empty())
+   {
+      m_file.open(file.chars(), ios::out | ios::binary | ios::trunc);
+      if (!m_file.is_open())
+      {
+         m_ok = false;
+         return false;
+      }
+   }
+
+   writeHeader();
+   return true;
+}
+
+void ossimPotraceVectorWriter::beginFeature()
+{
+   m_coords.clear();
+   m_ends.clear();
+   m_skipFeature = false;
+}
+
+void ossimPotraceVectorWriter::addRing(const vector<ossimDpt>& vertices, bool closed)
+{
+   if (m_skipFeature || ((m_geometryType == LINESTRING) && !m_ends.empty()))
+      return;
+
+   const vector<ossimDpt>* ring = &vertices;
+   if (m_tolerance > 0.0)
+   {
+      simplify(vertices, closed);
+      ring = &m_ring;
+   }
+
+   // Transform and round, dropping vertices that land on the previous one:
+   const size_t start = m_coords.size();
+   const double scale = (double) m_scale;
+   ossimGpt gpt;
+   for (size_t i=0; i<ring->size(); ++i)
+   {
+      double x = (*ring)[i].x;
+      double y = (*ring)[i].y;
+      if (m_geom)
+      {
+         m_geom->localToWorld((*ring)[i], gpt);
+         if (gpt.hasNans())
+            continue;
+         x = gpt.lon;
+         y = gpt.lat;
+      }
+      const ossim_int64 qx = llround(x * scale);
+      const ossim_int64 qy = llround(y * scale);
+      const size_t n = m_coords.size();
+      if ((n > start) && (m_coords[n-2] == qx) && (m_coords[n-1] == qy))
+         continue;
+      m_coords.push_back(qx);
+      m_coords.push_back(qy);
+   }
+
+   size_t numPoints = (m_coords.size() - start) / 2;
+   if (closed && (numPoints > 1) && (m_coords[start] == m_coords[start + 2*numPoints - 2]) &&
+       (m_coords[start + 1] == m_coords[start + 2*numPoints - 1]))
+   {
+      m_coords.resize(m_coords.size() - 2);
+      --numPoints;
+   }
+   if (numPoints < (closed ? 3u : 2u))
+   {
+      m_coords.resize(start);
+      if (m_ends.empty())
+         m_skipFeature = true;
+      return;
+   }
+   if (closed)
+   {
+      m_coords.push_back(m_coords[start]);
+      m_coords.push_back(m_coords[start + 1]);
+   }
+   m_ends.push_back((ossim_uint32) (m_coords.size() / 2));
+}
+
+void ossimPotraceVectorWriter::endFeature()
+{
+   if (m_skipFeature || m_ends.empty() || !m_ok)
+      return;
+
+   if (m_format == FLATGEOBUF)
+      writeFlatGeobufFeature();
+   else
+      writeJsonFeature();
+   ++m_numFeatures;
+
+   if (m_buffer.size() >= BUFFER_SIZE)
+      flush();
+}
+
+bool ossimPotraceVectorWriter::close()
+{
+   if (m_format == GEOJSON)
+      append("\n]}\n");
+   flush();
+
+   // Fill in the FlatGeobuf header fields that were not known at the start:
+   if (m_file.is_open())
+   {
+      if (m_countPos)
+      {
+         m_file.seekp(m_countPos);
+         m_file.write(reinterpret_cast<const char*>(&m_numFeatures), sizeof(m_numFeatures));
+      }
+      if (m_envelopePos && m_numFeatures)
+      {
+         m_file.seekp(m_envelopePos);
+         m_file.write(reinterpret_cast<const char*>(m_envelope), sizeof(m_envelope));
+      }
+      if (!m_file.good())
+         m_ok = false;
+      m_file.close();
+   }
+   if (m_echo)
+      m_echo->flush();
+
+   return m_ok;
+}
+
+ossim_uint64 ossimPotraceVectorWriter::getNumFeatures() const
+{
+   return m_numFeatures;
+}
+
+void ossimPotraceVectorWriter::simplify(const vector<ossimDpt>& vertices, bool closed)
+{
+   m_ring.clear();
+   const size_t n = vertices.size();
+   if (n < 3)
+   {
+      m_ring = vertices;
+      return;
+   }
+
+   //---
+   // Douglas-Peucker over indices 0..last. A closed ring runs on to index n, which is vertex 0
+   // again, and is split first at the vertex farthest from vertex 0, as both ends of a chord
+   // are always kept.
+   //---
+   const size_t last = closed ? n : n - 1;
+   const double tolerance2 = m_tolerance * m_tolerance;
+   m_keep.assign(last + 1, 0);
+   m_keep[0] = m_keep[last] = 1;
+   m_stack.clear();
+   if (closed)
+   {
+      size_t far = 0;
+      double farDistance2 = -1.0;
+      for (size_t i=1; i<n; ++i)
+      {
+         const double d2 = segmentDistance2(vertices[i], vertices[0], vertices[0]);
+         if (d2 > farDistance2)
+         {
+            far = i;
+            farDistance2 = d2;
+         }
+      }
+      m_keep[far] = 1;
+      m_stack.push_back(make_pair((size_t) 0, far));
+      m_stack.push_back(make_pair(far, last));
+   }
+   else
+      m_stack.push_back(make_pair((size_t) 0, last));
+
+   while (!m_stack.empty())
+   {
+      const size_t a = m_stack.back().first;
+      const size_t b = m_stack.back().second;
+      m_stack.pop_back();
+      if (b - a < 2)
+         continue;
+
+      const ossimDpt& pa = vertices[a];
+      const ossimDpt& pb = vertices[b % n];
+      size_t worst = a;
+      double worstDistance2 = tolerance2;
+      for (size_t i=a+1; i<b; ++i)
+      {
+         const double d2 = segmentDistance2(vertices[i], pa, pb);
+         if (d2 > worstDistance2)
+         {
+            worst = i;
+            worstDistance2 = d2;
+         }
+      }
+      if (worst != a)
+      {
+         m_keep[worst] = 1;
+         m_stack.push_back(make_pair(a, worst));
+         m_stack.push_back(make_pair(worst, b));
+      }
+   }
+
+   for (size_t i=0; i<n; ++i)
+   {
+      if (m_keep[i])
+         m_ring.push_back(vertices[i]);
+   }
+
+   // A ring simplified down to a sliver is written as it was:
+   if (closed && (m_ring.size() < 3))
+      m_ring = vertices;
+}
+
+void ossimPotraceVectorWriter::writeHeader()
+{
+   if (m_format == GEOJSON)
+   {
+      append("{\"type\":\"FeatureCollection\",\"features\":[\n");
+      return;
+   }
+   if (m_format != FLATGEOBUF)
+      return;
+
+   // The count and extent are patched in on close, which a copy sent to the echo stream misses:
+   const bool patch = m_file.is_open();
+   const bool withEnvelope = patch && !m_echo;
+
+   m_buffer.insert(m_buffer.end(), FGB_MAGIC, FGB_MAGIC + sizeof(FGB_MAGIC));
+   FlatBufferLayout fb (m_buffer);
+   fb.put<ossim_uint32>(0);
+   const size_t root = fb.put<ossim_uint32>(0);
+
+   // Header vtable, for fields name, envelope, geometry_type, has_z/m/t/tm, columns,
+   // features_count, index_node_size, crs:
+   const size_t vtable = fb.put<ossim_uint16>(26);
+   fb.put<ossim_uint16>(24);
+   fb.put<ossim_uint16>(0);
+   fb.put<ossim_uint16>(withEnvelope ? 16 : 0);
+   fb.put<ossim_uint16>(22);
+   for (int i=0; i<5; ++i)
+      fb.put<ossim_uint16>(0);
+   fb.put<ossim_uint16>(8);
+   fb.put<ossim_uint16>(20);
+   fb.put<ossim_uint16>(m_geom ? 4 : 0);
+
+   // Header table:
+   fb.pad(8);
+   const size_t table = fb.pos();
+   fb.put<ossim_int32>((ossim_int32) (table - vtable));
+   const size_t crsField = fb.put<ossim_uint32>(0);
+   const size_t countField = fb.put<ossim_uint64>(0);
+   const size_t envelopeField = fb.put<ossim_uint32>(0);
+   fb.put<ossim_uint16>(0); // No spatial index, so features can be written as they come.
+   fb.put<ossim_uint8>(m_geometryType == POLYGON ? FGB_POLYGON : FGB_LINESTRING);
+   fb.pad(4);
+   fb.link(root, table);
+
+   // Ground coordinates are WGS 84, code 4326 of the default EPSG authority:
+   if (m_geom)
+   {
+      const size_t crsVtable = fb.put<ossim_uint16>(8);
+      fb.put<ossim_uint16>(8);
+      fb.put<ossim_uint16>(0);
+      fb.put<ossim_uint16>(4);
+      const size_t crsTable = fb.put<ossim_int32>((ossim_int32) (fb.pos() - crsVtable));
+      fb.put<ossim_int32>(4326);
+      fb.link(crsField, crsTable);
+   }
+
+   if (withEnvelope)
+   {
+      fb.pad(8, 4);
+      const size_t envelope = fb.put<ossim_uint32>(4);
+      m_envelopePos = m_flushed + fb.base() + fb.pos();
+      for (int i=0; i<4; ++i)
+         fb.put<double>(0.0);
+      fb.link(envelopeField, envelope);
+   }
+   if (patch)
+      m_countPos = m_flushed + fb.base() + countField;
+
+   fb.finish();
+}
+
+void ossimPotraceVectorWriter::writeJsonFeature()
+{
+   if ((m_format == GEOJSON) && m_numFeatures)
+      append(",\n");
+
+   const bool polygon = (m_geometryType == POLYGON);
+   append("{\"type\":\"Feature\",\"properties\":{},\"geometry\":{\"type\":");
+   append(polygon ? "\"Polygon\",\"coordinates\":[" : "\"LineString\",\"coordinates\":");
+
+   size_t point = 0;
+   for (size_t ring=0; ring<m_ends.size(); ++ring)
+   {
+      if (ring)
+         m_buffer.push_back(',');
+      m_buffer.push_back('[');
+      for (const size_t first = point; point<m_ends[ring]; ++point)
+      {
+         append(point == first ? "[" : ",[");
+         appendCoordinate(m_coords[2*point]);
+         m_buffer.push_back(',');
+         appendCoordinate(m_coords[2*point + 1]);
+         m_buffer.push_back(']');
+      }
+      m_buffer.push_back(']');
+   }
+
+   append(polygon ? "]}}" : "}}");
+   if (m_format == GEOJSON_SEQ)
+      m_buffer.push_back('\n');
+}
+
+void ossimPotraceVectorWriter::writeFlatGeobufFeature()
+{
+   const bool polygon = (m_geometryType == POLYGON);
+   const double scale = (double) m_scale;
+
+   FlatBufferLayout fb (m_buffer);
+   fb.put<ossim_uint32>(0);
+   const size_t root = fb.put<ossim_uint32>(0);
+
+   // Feature vtable and table, with just the geometry field:
+   const size_t featureVtable = fb.put<ossim_uint16>(6);
+   fb.put<ossim_uint16>(8);
+   fb.put<ossim_uint16>(4);
+   fb.pad(4);
+   const size_t feature = fb.put<ossim_int32>((ossim_int32) (fb.pos() - featureVtable));
+   const size_t geometryField = fb.put<ossim_uint32>(0);
+
+   // Geometry vtable and table, with the ends (polygons only) and xy fields. The type is the
+   // header's:
+   const size_t geometryVtable = fb.put<ossim_uint16>(8);
+   fb.put<ossim_uint16>(12);
+   fb.put<ossim_uint16>(polygon ? 4 : 0);
+   fb.put<ossim_uint16>(8);
+   const size_t geometry = fb.put<ossim_int32>((ossim_int32) (fb.pos() - geometryVtable));
+   const size_t endsField = fb.put<ossim_uint32>(0);
+   const size_t xyField = fb.put<ossim_uint32>(0);
+
+   if (polygon)
+   {
+      const size_t ends = fb.put<ossim_uint32>((ossim_uint32) m_ends.size());
+      for (size_t i=0; i<m_ends.size(); ++i)
+         fb.put<ossim_uint32>(m_ends[i]);
+      fb.link(endsField, ends);
+   }
+
+   fb.pad(8, 4);
+   const size_t xy = fb.put<ossim_uint32>((ossim_uint32) m_coords.size());
+   for (size_t i=0; i<m_coords.size(); i+=2)
+   {
+      const double x = m_coords[i] / scale;
+      const double y = m_coords[i + 1] / scale;
+      fb.put<double>(x);
+      fb.put<double>(y);
+      m_envelope[0] = std::min(m_envelope[0], x);
+      m_envelope[1] = std::min(m_envelope[1], y);
+      m_envelope[2] = std::max(m_envelope[2], x);
+      m_envelope[3] = std::max(m_envelope[3], y);
+   }
+
+   fb.link(root, feature);
+   fb.link(geometryField, geometry);
+   fb.link(xyField, xy);
+   fb.finish();
+}
+
+void ossimPotraceVectorWriter::appendCoordinate(ossim_int64 q)
+{
+   // Fixed point to decimal without printf, trailing zeros dropped:
+   char digits[24];
+   ossim_uint64 u = (ossim_uint64) q;
+   if (q < 0)
+   {
+      m_buffer.push_back('-');
+      u = 0 - u;
+   }
+   ossim_uint64 whole = u / (ossim_uint64) m_scale;
+   ossim_uint64 fraction = u % (ossim_uint64) m_scale;
+
+   int n = 0;
+   do
+   {
+      digits[n++] = (char) ('0' + whole % 10);
+      whole /= 10;
+   } while (whole);
+   while (n)
+      m_buffer.push_back(digits[--n]);
+
+   if (fraction)
+   {
+      int places = m_precision;
+      while (fraction % 10 == 0)
+      {
+         fraction /= 10;
+         --places;
+      }
+      for (int i=places-1; i>=0; --i)
+      {
+         digits[i] = (char) ('0' + fraction % 10);
+         fraction /= 10;
+      }
+      m_buffer.push_back('.');
+      m_buffer.insert(m_buffer.end(), digits, digits + places);
+   }
+}
+
+void ossimPotraceVectorWriter::append(const char* s)
+{
+   m_buffer.insert(m_buffer.end(), s, s + strlen(s));
+}
+
+void ossimPotraceVectorWriter::flush()
+{
+   if (m_buffer.empty())
+      return;
+
+   if (m_file.is_open())
+   {
+      m_file.write(&m_buffer.front(), m_buffer.size());
+      if (!m_file.good())
+         m_ok = false;
+   }
+   if (m_echo)
+      m_echo->write(&m_buffer.front(), m_buffer.size());
+   m_flushed += m_buffer.size();
+   m_buffer.clear();
+}
@@ -0,0 +1,140 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#ifndef ossimPotraceVectorWriter_HEADER
+#define ossimPotraceVectorWriter_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimConstants.h>
+#include <ossim/base/ossimDpt.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimString.h>
+#include <fstream>
+#include <vector>
+
+extern "C" {
+#include "potracelib.h"
+}
+
+class ossimImageGeometry;
+
+/**
+ * Writes traced paths as vector features in one pass. Vertices are given in image space and are
+ * simplified there, transformed to ground, rounded to the output precision and written to a
+ * memory buffer that goes to the file (and/or an echo stream) a megabyte at a time. Nothing is
+ * held back but the feature being written, except that GeoJSON still needs its closing brackets
+ * and FlatGeobuf gets its feature count and extent patched into the header when writing a file.
+ *
+ * All features of one output have the same geometry type. A polygon feature is its outer ring
+ * followed by its holes; a linestring feature is a single ring, open or closed.
+ */
+class OSSIM_DLL ossimPotraceVectorWriter
+{
+public:
+   enum Format { GEOJSON, GEOJSON_SEQ, FLATGEOBUF };
+   enum GeometryType { POLYGON, LINESTRING };
+
+   ossimPotraceVectorWriter();
+   ~ossimPotraceVectorWriter();
+
+   /**
+    * @brief Parses "geojson", "geojsonseq" (or "ndjson") and "flatgeobuf" (or "fgb").
+    * @return false if s is none of these.
+    */
+   static bool stringToFormat(const ossimString& s, Format& format);
+
+   /** @brief Format for a file extension: .fgb, .geojsonl/.geojsons/.ndjson, else GeoJSON. */
+   static Format formatFromFilename(const ossimFilename& file);
+
+   /** @brief Appends the vertices of a potrace curve, Bezier segments split in eight. */
+   static void flattenCurve(const potrace_curve_t& curve, std::vector<ossimDpt>& vertices);
+
+   void setFormat(Format format);
+   Format getFormat() const;
+
+   void setGeometryType(GeometryType type);
+   GeometryType getGeometryType() const;
+
+   /**
+    * @brief Sets the geometry taking image points to ground. The default 0 writes image
+    * coordinates.
+    */
+   void setImageGeometry(const ossimImageGeometry* geom);
+
+   /** @brief Douglas-Peucker tolerance in pixels, 0 (default) to write every vertex. */
+   void setSimplifyTolerance(double pixels);
+   double getSimplifyTolerance() const;
+
+   /**
+    * @brief Decimal places kept of each coordinate, 0 to 12. Default is 8, a millimeter in
+    * degrees. Vertices that round to the same point as the previous are dropped.
+    */
+   void setPrecision(int decimals);
+   int getPrecision() const;
+
+   /**
+    * @brief Starts the output. Set everything else first.
+    * @param file Output file, may be empty when only echoing.
+    * @param echo Optional stream that gets a copy of the output, e.g. the console.
+    * @return false if the file could not be created.
+    */
+   bool open(const ossimFilename& file, std::ostream* echo=0);
+
+   void beginFeature();
+
+   /**
+    * @brief Adds a ring to the current feature. Closed rings are written with the first vertex
+    * repeated at the end, so vertices should not repeat it. A ring with too few vertices left
+    * after simplifying and rounding is dropped, and if it is the first ring, so is the feature.
+    */
+   void addRing(const std::vector<ossimDpt>& vertices, bool closed);
+
+   void endFeature();
+
+   /** @brief Finishes the output and closes the file. @return false on a write error. */
+   bool close();
+
+   ossim_uint64 getNumFeatures() const;
+
+private:
+   void simplify(const std::vector<ossimDpt>& vertices, bool closed);
+   void writeHeader();
+   void writeJsonFeature();
+   void writeFlatGeobufFeature();
+   void appendCoordinate(ossim_int64 q);
+   void append(const char* s);
+   void flush();
+
+   Format m_format;
+   GeometryType m_geometryType;
+   const ossimImageGeometry* m_geom;
+   double m_tolerance;
+   int m_precision;
+   ossim_int64 m_scale;
+
+   std::ofstream m_file;
+   std::ostream* m_echo;
+   bool m_ok;
+   std::vector<char> m_buffer;
+   ossim_uint64 m_flushed;        // Bytes written out before m_buffer.
+   ossim_uint64 m_countPos;       // File offsets of the FlatGeobuf header fields to patch,
+   ossim_uint64 m_envelopePos;    // 0 if not patched.
+   double m_envelope[4];
+   ossim_uint64 m_numFeatures;
+
+   // Feature being written: rounded coordinates and the end of each ring, in points.
+   std::vector<ossim_int64> m_coords;
+   std::vector<ossim_uint32> m_ends;
+   bool m_skipFeature;
+
+   // Scratch space for simplifying.
+   std::vector<ossimDpt> m_ring;
+   std::vector<char> m_keep;
+   std::vector<std::pair<size_t, size_t> > m_stack;
+};
+
+#endif /* #ifndef ossimPotraceVectorWriter_HEADER */
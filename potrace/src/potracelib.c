@@ -128,3 +128,111 @@ void potrace_writepbm(FILE *pbm, potrace_bitmap_t *potraceBitmap)
    bm_writepbm(pbm, potraceBitmap);
 }
 
+int potrace_decompose(const potrace_param_t *param,
+                      const potrace_bitmap_t *bm, potrace_path_t **plistp)
+{
+  progress_t prog;
+  prog.callback = NULL;
+  return bm_to_pathlist(bm, plistp, param, &prog);
+}
+
+int potrace_fit_paths(const potrace_param_t *param, potrace_path_t *plist)
+{
+  progress_t prog;
+  prog.callback = NULL;
+  return process_path(plist, param, &prog);
+}
+
+const long *potrace_path_points(const potrace_path_t *p, int *len)
+{
+  *len = p->priv->len;
+  return (const long *) p->priv->pt;
+}
+
+void potrace_path_translate(potrace_path_t *p, long dx, long dy)
+{
+  int i;
+  for (i=0; i<p->priv->len; i++) {
+    p->priv->pt[i].x += dx;
+    p->priv->pt[i].y += dy;
+  }
+}
+
+potrace_path_t *potrace_path_from_points(const long *xy, int len, int sign)
+{
+  path_t *p;
+  int i, j;
+  long area = 0;
+
+  p = path_new();
+  if (!p) {
+    return NULL;
+  }
+  p->priv->pt = (point_t *) malloc(len * sizeof(point_t));
+  if (!p->priv->pt) {
+    path_free(p);
+    return NULL;
+  }
+  for (i=0; i<len; i++) {
+    p->priv->pt[i].x = xy[2*i];
+    p->priv->pt[i].y = xy[2*i+1];
+  }
+  /* same sum as findpath */
+  for (i=0; i<len; i++) {
+    j = (i+1 == len) ? 0 : i+1;
+    area += xy[2*j] * (xy[2*j+1] - xy[2*i+1]);
+  }
+  p->priv->len = len;
+  p->area = (int) area;
+  p->sign = sign;
+  return p;
+}
+
+/* free the members of a private curve, setting them to NULL */
+static void compact_free(privcurve_t *curve, int all) {
+  if (all) {
+    free(curve->tag);
+    free(curve->c);
+    curve->tag = NULL;
+    curve->c = NULL;
+  }
+  free(curve->vertex);
+  free(curve->alpha);
+  free(curve->alpha0);
+  free(curve->beta);
+  curve->vertex = NULL;
+  curve->alpha = NULL;
+  curve->alpha0 = NULL;
+  curve->beta = NULL;
+  curve->alphacurve = 0;
+}
+
+void potrace_path_compact(potrace_path_t *p)
+{
+  privpath_t *pp = p->priv;
+  point_t *pt;
+
+  if (pp->len > 1) {
+    pt = (point_t *) realloc(pp->pt, sizeof(point_t));
+    if (pt) {
+      pp->pt = pt;
+      pp->len = 1;
+    }
+  }
+
+  free(pp->lon);
+  free(pp->sums);
+  free(pp->po);
+  pp->lon = NULL;
+  pp->sums = NULL;
+  pp->po = NULL;
+  if (pp->fcurve) {
+    compact_free(pp->fcurve == &pp->curve ? &pp->ocurve : &pp->curve, 1);
+    compact_free(pp->fcurve, 0);
+  }
+}
+
+void potrace_pathlist_free(potrace_path_t *plist)
+{
+  pathlist_free(plist);
+}
@@ -138,4 +138,31 @@ int potrace_geojson(FILE *fout, potrace_path_t *plist, int as_polygons);
 /* Stub for debug utility for outputting intermediate bitmap file */
 void potrace_writepbm(FILE *fout, potrace_bitmap_t *bm);
 
+/* The two stages of potrace_trace, for tracing a bitmap in pieces. */
+
+/* decompose a bitmap into pixel outlines. Only the points, area, sign
+   and tree of each path are set. Returns 0 on success. */
+int potrace_decompose(const potrace_param_t *param,
+                      const potrace_bitmap_t *bm, potrace_path_t **plistp);
+
+/* fit curves to the outlines of a path list. Returns 0 on success. */
+int potrace_fit_paths(const potrace_param_t *param, potrace_path_t *plist);
+
+/* outline points of a path, as len (x, y) pairs */
+const long *potrace_path_points(const potrace_path_t *p, int *len);
+
+/* add (dx, dy) to the outline points of a path */
+void potrace_path_translate(potrace_path_t *p, long dx, long dy);
+
+/* new path from len (x, y) outline points, counter-clockwise around
+   the region of the given sign. Returns NULL on error. */
+potrace_path_t *potrace_path_from_points(const long *xy, int len, int sign);
+
+/* free what only curve fitting needs, keeping the final curve and the
+   first outline point */
+void potrace_path_compact(potrace_path_t *p);
+
+/* free a path and its outline, curve and list successors */
+void potrace_pathlist_free(potrace_path_t *plist);
+
 #endif /* POTRACELIB_H */
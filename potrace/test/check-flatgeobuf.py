@@ -0,0 +1,113 @@
+#!/usr/bin/env python3
+#**************************************************************************************************
+#
+#     OSSIM Open Source Geospatial Data Processing Library
+#     See top level LICENSE.txt file for license information
+#
+#**************************************************************************************************
+#
+# Reads FlatGeobuf files written by ossimPotraceVectorWriter with GDAL's FlatGeobuf driver, an
+# implementation independent of the writer, and checks that the header agrees with the features.
+#
+# Usage: check-flatgeobuf.py [--env DIR] file.fgb ...
+#
+# The files come from "vector-writer-test file.fgb" or "ossim-potrace --format flatgeobuf ...".
+# GDAL (through pyogrio) and shapely are installed with pip into a virtual environment, created
+# in DIR on first use (default: ossim-potrace-fgb-check in the system temp dir) and reused
+# afterwards. Nothing is installed into the calling Python.
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+import venv
+
+REQUIREMENTS = ["pyogrio>=0.7", "shapely>=2.0", "numpy"]
+
+failures = 0
+
+
+def check(passed, what):
+    global failures
+    print(("  PASSED: " if passed else "  FAILED: ") + what)
+    if not passed:
+        failures += 1
+
+
+def env_python(env_dir):
+    bin_dir = "Scripts" if os.name == "nt" else "bin"
+    return os.path.join(env_dir, bin_dir, "python")
+
+
+def ensure_env(env_dir):
+    """Creates the virtual environment with the readers if it isn't there yet."""
+    python = env_python(env_dir)
+    if not os.path.exists(python):
+        print("Creating " + env_dir)
+        venv.EnvBuilder(with_pip=True).create(env_dir)
+        subprocess.check_call([python, "-m", "pip", "install", "--quiet"] + REQUIREMENTS)
+    return python
+
+
+def check_file(path):
+    import numpy
+    import pyogrio
+    import shapely
+
+    print(path)
+    info = pyogrio.read_info(path, force_feature_count=False, force_total_bounds=False)
+    check(info["driver"] == "FlatGeobuf", "read by the FlatGeobuf driver")
+
+    _, _, wkb, _ = pyogrio.raw.read(path)
+    geometries = shapely.from_wkb(wkb)
+    check(info["features"] == len(geometries),
+          "header feature count %d matches the %d features" % (info["features"], len(geometries)))
+    check(len(geometries) > 0, "has features")
+
+    types = set(shapely.get_type_id(geometries).tolist())
+    header_type = info["geometry_type"]
+    if header_type == "Polygon":
+        check(types == {3}, "every feature is a polygon")
+        check(bool(numpy.all(shapely.is_valid(geometries))), "polygons are valid")
+        rings_closed = all(
+            ring.is_closed
+            for polygon in geometries
+            for ring in [polygon.exterior] + list(polygon.interiors))
+        check(rings_closed, "rings are closed")
+    elif header_type == "LineString":
+        check(types == {1}, "every feature is a line string")
+        check(bool(numpy.all(shapely.get_num_points(geometries) >= 2)), "at least two points each")
+    else:
+        check(False, "polygon or line string geometry type in header, got %s" % header_type)
+
+    # The header extent is patched in after the features are written:
+    bounds = shapely.total_bounds(geometries)
+    header_bounds = info["total_bounds"]
+    check(header_bounds is not None and numpy.allclose(header_bounds, bounds, rtol=0, atol=0),
+          "header extent %s matches the features %s" % (header_bounds, bounds.tolist()))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Checks FlatGeobuf files with GDAL's FlatGeobuf driver.")
+    parser.add_argument("--env", default=os.path.join(tempfile.gettempdir(),
+                                                      "ossim-potrace-fgb-check"),
+                        help="virtual environment holding GDAL and shapely")
+    parser.add_argument("files", nargs="+", help="FlatGeobuf files to check")
+    args = parser.parse_args()
+
+    # Rerun inside the environment unless already there:
+    python = ensure_env(os.path.abspath(args.env))
+    if os.path.realpath(sys.prefix) != os.path.realpath(os.path.abspath(args.env)):
+        return subprocess.call([python, os.path.abspath(__file__), "--env", args.env] + args.files)
+
+    for path in args.files:
+        check_file(path)
+
+    print("FAILED" if failures else "PASSED")
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
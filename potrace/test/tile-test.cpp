@@ -0,0 +1,306 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Regression test for tiled tracing. Synthetic masks are traced whole with potrace_trace and in
+// small tiles with ossimPotraceTileTracer, and the polygon areas must agree.
+
+#include "../src/ossimPotraceTileTracer.h"
+#include "../../test/ossimPluginTest.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const int WORD_BITS = 8 * sizeof(potrace_word);
+
+static potrace_word bit(int x)
+{
+   return ((potrace_word) 1) << (WORD_BITS - 1 - x % WORD_BITS);
+}
+
+class Mask : public ossimPotraceTileTracer::BitmapSource
+{
+public:
+   Mask(int w, int h)
+   {
+      m_bitmap.w = w;
+      m_bitmap.h = h;
+      m_bitmap.dy = (w + WORD_BITS - 1) / WORD_BITS;
+      m_words.assign(m_bitmap.dy * (size_t) h, 0);
+      m_bitmap.map = &m_words.front();
+   }
+
+   void set(int x, int y, bool on)
+   {
+      if ((x < 0) || (y < 0) || (x >= m_bitmap.w) || (y >= m_bitmap.h))
+         return;
+      potrace_word& word = m_bitmap.map[y * m_bitmap.dy + x / WORD_BITS];
+      word = on ? (word | bit(x)) : (word & ~bit(x));
+   }
+
+   bool get(int x, int y) const
+   {
+      return (m_bitmap.map[y * m_bitmap.dy + x / WORD_BITS] & bit(x)) != 0;
+   }
+
+   void disc(double cx, double cy, double r, bool on)
+   {
+      for (int y = (int) (cy - r) - 1; y <= (int) (cy + r) + 1; ++y)
+         for (int x = (int) (cx - r) - 1; x <= (int) (cx + r) + 1; ++x)
+            if ((x + 0.5 - cx)*(x + 0.5 - cx) + (y + 0.5 - cy)*(y + 0.5 - cy) < r*r)
+               set(x, y, on);
+   }
+
+   virtual bool fillTile(const ossimIrect& rect, potrace_bitmap_t* bitmap)
+   {
+      for (ossim_uint32 y=0; y<rect.height(); ++y)
+      {
+         for (ossim_uint32 x=0; x<rect.width(); ++x)
+         {
+            if (get(rect.ul().x + x, rect.ul().y + y))
+               bitmap->map[y * bitmap->dy + x / WORD_BITS] |= bit(x);
+         }
+      }
+      return true;
+   }
+
+   potrace_bitmap_t* getBitmap() { return &m_bitmap; }
+
+   size_t count() const
+   {
+      size_t n = 0;
+      for (int y=0; y<m_bitmap.h; ++y)
+         for (int x=0; x<m_bitmap.w; ++x)
+            n += get(x, y) ? 1 : 0;
+      return n;
+   }
+
+private:
+   potrace_bitmap_t m_bitmap;
+   vector<potrace_word> m_words;
+};
+
+// Area enclosed by the fitted curve, Bezier segments sampled as the GeoJSON writer does.
+static double curveArea(const potrace_curve_t& curve)
+{
+   double area = 0;
+   potrace_dpoint_t cur = curve.c[curve.n-1][2];
+   for (int i=0; i<curve.n; ++i)
+   {
+      vector<potrace_dpoint_t> pts;
+      if (curve.tag[i] == POTRACE_CORNER)
+      {
+         pts.push_back(curve.c[i][1]);
+         pts.push_back(curve.c[i][2]);
+      }
+      else
+      {
+         for (int k=1; k<=8; ++k)
+         {
+            double t = k / 8.0, s = 1 - t;
+            potrace_dpoint_t p;
+            const potrace_dpoint_t* c = curve.c[i];
+            p.x = s*s*s*cur.x + 3*s*s*t*c[0].x + 3*s*t*t*c[1].x + t*t*t*c[2].x;
+            p.y = s*s*s*cur.y + 3*s*s*t*c[0].y + 3*s*t*t*c[1].y + t*t*t*c[2].y;
+            pts.push_back(p);
+         }
+      }
+      for (size_t k=0; k<pts.size(); ++k)
+      {
+         area += cur.x * pts[k].y - pts[k].x * cur.y;
+         cur = pts[k];
+      }
+   }
+   return fabs(area) / 2;
+}
+
+struct Summary
+{
+   long signedArea;          // Pixels in outer outlines less pixels in holes.
+   double curveArea;         // Same, for the fitted curves.
+   vector<long> outer;       // Pixel areas of the outer outlines, sorted.
+   vector<long> holes;       // Pixel areas of the holes, sorted.
+   vector<double> curves;    // Curve areas, sorted.
+   vector< pair<long, long> > nesting; // (area, parent area) for paths below the top level.
+};
+
+static void summarizeTree(potrace_path_t* list, long parentArea, Summary& s)
+{
+   for (potrace_path_t* p = list; p; p = p->sibling)
+   {
+      if (parentArea)
+         s.nesting.push_back(make_pair((long) p->area, parentArea));
+      summarizeTree(p->childlist, p->area, s);
+   }
+}
+
+static Summary summarize(potrace_state_t* state)
+{
+   Summary s;
+   s.signedArea = 0;
+   s.curveArea = 0;
+   for (potrace_path_t* p = state->plist; p; p = p->next)
+   {
+      const double a = curveArea(p->curve);
+      if (p->sign == '+')
+      {
+         s.signedArea += p->area;
+         s.curveArea += a;
+         s.outer.push_back(p->area);
+      }
+      else
+      {
+         s.signedArea -= p->area;
+         s.curveArea -= a;
+         s.holes.push_back(p->area);
+      }
+      s.curves.push_back(a);
+   }
+   summarizeTree(state->plist, 0, s);
+   sort(s.outer.begin(), s.outer.end());
+   sort(s.holes.begin(), s.holes.end());
+   sort(s.curves.begin(), s.curves.end());
+   sort(s.nesting.begin(), s.nesting.end());
+   return s;
+}
+
+static bool curvesClose(const Summary& a, const Summary& b, double tolerance)
+{
+   if (a.curves.size() != b.curves.size())
+      return false;
+   for (size_t i=0; i<a.curves.size(); ++i)
+   {
+      if (fabs(a.curves[i] - b.curves[i]) > tolerance * max(a.curves[i], 8.0))
+         return false;
+   }
+   return true;
+}
+
+static void compare(Mask& mask, int turdsize, int turnpolicy, ossim_uint32 tileSize,
+                    bool exactPartition)
+{
+   potrace_param_t* param = potrace_param_default();
+   param->turdsize = turdsize;
+   param->turnpolicy = turnpolicy;
+
+   potrace_state_t* whole = potrace_trace(param, mask.getBitmap());
+   ossimPotraceTileTracer tracer;
+   tracer.setTileSize(tileSize);
+   tracer.setNumThreads(4);
+   potrace_state_t* tiled = tracer.trace(param, mask.getBitmap()->w, mask.getBitmap()->h, &mask);
+   tracer.setNumThreads(1);
+   potrace_state_t* serial = tracer.trace(param, mask.getBitmap()->w, mask.getBitmap()->h, &mask);
+   check(whole && tiled && serial, "traced");
+   if (!whole || !tiled || !serial)
+      return;
+
+   Summary w = summarize(whole);
+   Summary t = summarize(tiled);
+   Summary s = summarize(serial);
+   cout << "  whole: " << w.outer.size() << " outer, " << w.holes.size() << " holes, area "
+        << w.signedArea << ", curve area " << w.curveArea << endl;
+   cout << "  tiled: " << t.outer.size() << " outer, " << t.holes.size() << " holes, area "
+        << t.signedArea << ", curve area " << t.curveArea << endl;
+
+   if (turdsize == 0)
+      check(t.signedArea == (long) mask.count(), "pixel area equals foreground count");
+   check(t.signedArea == w.signedArea, "pixel area matches whole image trace");
+   check(fabs(t.curveArea - w.curveArea) <= 0.002 * w.curveArea, "curve area within 0.2%");
+   if (exactPartition)
+   {
+      check(t.outer == w.outer, "outer polygon areas match");
+      check(t.holes == w.holes, "hole areas match");
+      check(t.nesting == w.nesting, "nesting matches");
+      check(curvesClose(t, w, 0.01), "each curve area within 1%");
+   }
+   check((t.outer == s.outer) && (t.holes == s.holes) && (t.nesting == s.nesting),
+         "same result on 1 and 4 threads");
+
+   potrace_state_free(whole);
+   potrace_state_free(tiled);
+   potrace_state_free(serial);
+   potrace_param_free(param);
+}
+
+void testShapes()
+{
+   cout << "Discs and rings across seams" << endl;
+   Mask mask (700, 500);
+
+   // Large ring with an island, crossing several seams both ways:
+   mask.disc(300, 250, 200, true);
+   mask.disc(300, 250, 120, false);
+   mask.disc(300, 250, 60, true);
+   mask.disc(300, 250, 25, false);
+
+   // Small discs and rings, some on seams and tile corners:
+   for (int i=0; i<12; ++i)
+   {
+      mask.disc(560 + (i % 3) * 45, 40 + (i / 3) * 120, 18, true);
+      if (i % 2)
+         mask.disc(560 + (i % 3) * 45, 40 + (i / 3) * 120, 8, false);
+   }
+   mask.disc(128, 64, 10, true);
+   mask.disc(64, 448, 30, true);
+
+   // Full width bar, so an outline runs through every tile of a row:
+   for (int x=0; x<700; ++x)
+      for (int y=470; y<490; ++y)
+         mask.set(x, y, true);
+
+   compare(mask, 0, POTRACE_TURNPOLICY_MINORITY, 64, true);
+   compare(mask, 2, POTRACE_TURNPOLICY_MINORITY, 64, true);
+   compare(mask, 0, POTRACE_TURNPOLICY_MINORITY, 100, true);
+}
+
+void testNoise()
+{
+   cout << "Speckle noise" << endl;
+   Mask mask (520, 390);
+   ossim_uint32 state = 7;
+   for (int i=0; i<1500; ++i)
+   {
+      state = state*1103515245u + 12345u;
+      const double x = ((state >> 8) & 0xFFFF) / 65536.0 * 520;
+      state = state*1103515245u + 12345u;
+      const double y = ((state >> 8) & 0xFFFF) / 65536.0 * 390;
+      state = state*1103515245u + 12345u;
+      const double r = 1 + ((state >> 8) & 0xFF) / 256.0 * 9;
+      mask.disc(x, y, r, (i % 5) != 0);
+   }
+
+   // Pixels touch at corners here, and outlines meeting at a corner on a seam may be paired
+   // differently than potrace would, so only the totals must match:
+   compare(mask, 0, POTRACE_TURNPOLICY_MINORITY, 32, false);
+   compare(mask, 0, POTRACE_TURNPOLICY_RIGHT, 47, false);
+}
+
+void testEmpty()
+{
+   cout << "Empty mask" << endl;
+   Mask mask (300, 200);
+   potrace_param_t* param = potrace_param_default();
+   ossimPotraceTileTracer tracer;
+   tracer.setTileSize(64);
+   potrace_state_t* tiled = tracer.trace(param, 300, 200, &mask);
+   check(tiled && !tiled->plist, "no paths");
+   if (tiled)
+      potrace_state_free(tiled);
+   potrace_param_free(param);
+}
+
+int main(int argc, char *argv[])
+{
+   testShapes();
+   testNoise();
+   testEmpty();
+
+   return ossimPluginTest::summary();
+}
@@ -0,0 +1,251 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Test for the streaming vector writer. A traced mask is written in each format, in image
+// coordinates, and the output is read back.
+//
+// Usage: vector-writer-test [file.fgb]
+//
+// With a file name the FlatGeobuf output is kept there, for check-flatgeobuf.py to read it with
+// an independent implementation.
+
+#include "../src/ossimPotraceVectorWriter.h"
+#include "../../test/ossimPluginTest.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const int WORD_BITS = 8 * sizeof(potrace_word);
+
+static potrace_word bit(int x)
+{
+   return ((potrace_word) 1) << (WORD_BITS - 1 - x % WORD_BITS);
+}
+
+// Traces a 64 x 64 mask holding a ring (one polygon with a hole) and a square.
+static potrace_state_t* traceShapes()
+{
+   static vector<potrace_word> words;
+   potrace_bitmap_t bitmap;
+   bitmap.w = 64;
+   bitmap.h = 64;
+   bitmap.dy = (64 + WORD_BITS - 1) / WORD_BITS;
+   words.assign(bitmap.dy * 64, 0);
+   bitmap.map = &words.front();
+   for (int y=0; y<64; ++y)
+   {
+      for (int x=0; x<64; ++x)
+      {
+         const double r2 = (x + 0.5 - 20)*(x + 0.5 - 20) + (y + 0.5 - 24)*(y + 0.5 - 24);
+         const bool ring = (r2 < 15*15) && (r2 > 7*7);
+         const bool square = (x >= 44) && (x < 56) && (y >= 40) && (y < 52);
+         if (ring || square)
+            bitmap.map[y*bitmap.dy + x/WORD_BITS] |= bit(x);
+      }
+   }
+   potrace_param_t* param = potrace_param_default();
+   potrace_state_t* state = potrace_trace(param, &bitmap);
+   potrace_param_free(param);
+   return state;
+}
+
+static void writePolygons(potrace_path_t* tree, ossimPotraceVectorWriter& writer)
+{
+   vector<ossimDpt> ring;
+   for (potrace_path_t* p = tree; p; p = p->sibling)
+   {
+      writer.beginFeature();
+      ring.clear();
+      ossimPotraceVectorWriter::flattenCurve(p->curve, ring);
+      writer.addRing(ring, true);
+      for (potrace_path_t* q = p->childlist; q; q = q->sibling)
+      {
+         ring.clear();
+         ossimPotraceVectorWriter::flattenCurve(q->curve, ring);
+         writer.addRing(ring, true);
+      }
+      writer.endFeature();
+   }
+}
+
+static string write(potrace_state_t* state, ossimPotraceVectorWriter::Format format,
+                    double tolerance, int precision)
+{
+   ostringstream out;
+   ossimPotraceVectorWriter writer;
+   writer.setFormat(format);
+   writer.setSimplifyTolerance(tolerance);
+   writer.setPrecision(precision);
+   writer.open(ossimFilename(), &out);
+   writePolygons(state->plist, writer);
+   check(writer.close(), "writer closed");
+   check(writer.getNumFeatures() == 2, "two features written");
+   return out.str();
+}
+
+static size_t countOf(const string& s, const string& what)
+{
+   size_t n = 0;
+   for (size_t at = s.find(what); at != string::npos; at = s.find(what, at + 1))
+      ++n;
+   return n;
+}
+
+static ossim_uint32 u32(const string& s, size_t at)
+{
+   ossim_uint32 v;
+   memcpy(&v, s.data() + at, sizeof(v));
+   return v;
+}
+
+// Position of a flatbuffer table field, 0 if absent.
+static size_t field(const string& s, size_t table, int index)
+{
+   ossim_int32 soffset;
+   memcpy(&soffset, s.data() + table, sizeof(soffset));
+   const size_t vtable = table - soffset;
+   ossim_uint16 vtableSize, offset;
+   memcpy(&vtableSize, s.data() + vtable, sizeof(vtableSize));
+   if (4 + 2*index >= vtableSize)
+      return 0;
+   memcpy(&offset, s.data() + vtable + 4 + 2*index, sizeof(offset));
+   return offset ? table + offset : 0;
+}
+
+static size_t deref(const string& s, size_t at)
+{
+   return at + u32(s, at);
+}
+
+void testGeoJson(potrace_state_t* state)
+{
+   cout << "GeoJSON" << endl;
+   const string json = write(state, ossimPotraceVectorWriter::GEOJSON, 0.0, 8);
+   check(json.find("{\"type\":\"FeatureCollection\",\"features\":[\n") == 0, "collection header");
+   check(json.substr(json.size() - 4) == "\n]}\n", "collection footer");
+   check(countOf(json, "\"Polygon\"") == 2, "two polygons");
+   check(countOf(json, "[[[") == 2 && countOf(json, "]],[[") == 1, "one hole");
+
+   // The square's corners are exact:
+   check(json.find("[56,52]") != string::npos && json.find("[44,40]") != string::npos,
+         "integer coordinates written without decimals");
+
+   const string seq = write(state, ossimPotraceVectorWriter::GEOJSON_SEQ, 0.0, 8);
+   check(countOf(seq, "\n") == 2 && seq.find("{\"type\":\"Feature\"") == 0,
+         "one feature per line");
+}
+
+void testSimplifyAndPrecision(potrace_state_t* state)
+{
+   cout << "Simplifying and rounding" << endl;
+   const string full = write(state, ossimPotraceVectorWriter::GEOJSON_SEQ, 0.0, 8);
+   const string simple = write(state, ossimPotraceVectorWriter::GEOJSON_SEQ, 0.5, 8);
+   const size_t fullVertices = countOf(full, "],[");
+   const size_t simpleVertices = countOf(simple, "],[");
+   cout << "  vertices: " << fullVertices << " -> " << simpleVertices << endl;
+   check(simpleVertices < fullVertices, "simplified to fewer vertices");
+   check(simple.find("[[[44,40],[56,40],[56,52],[44,52],[44,40]]]") != string::npos,
+         "square simplified to its corners");
+   check(countOf(simple, "\"Polygon\"") == 2 && countOf(simple, "]],[[") == 1,
+         "simplified rings kept");
+
+   const string rounded = write(state, ossimPotraceVectorWriter::GEOJSON_SEQ, 0.0, 1);
+   bool maxOneDecimal = true;
+   for (size_t at = rounded.find('.'); at != string::npos; at = rounded.find('.', at + 1))
+   {
+      if (isdigit(rounded[at + 2]))
+         maxOneDecimal = false;
+   }
+   check(maxOneDecimal, "one decimal place");
+   check(countOf(rounded, "],[") <= fullVertices, "rounded duplicates dropped");
+}
+
+void testFlatGeobuf(potrace_state_t* state, const char* keepAs)
+{
+   cout << "FlatGeobuf" << endl;
+
+   // To a file, so the header gets the count and extent:
+   const char* filename = keepAs ? keepAs : "vector-writer-test.fgb";
+   ossimPotraceVectorWriter writer;
+   check(ossimPotraceVectorWriter::formatFromFilename(filename) ==
+         ossimPotraceVectorWriter::FLATGEOBUF, "format from extension");
+   writer.setFormat(ossimPotraceVectorWriter::FLATGEOBUF);
+   check(writer.open(filename), "file opened");
+   writePolygons(state->plist, writer);
+   check(writer.close(), "file closed");
+
+   ifstream in (filename, ios::binary);
+   const string fgb ((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+   in.close();
+   if (!keepAs)
+      remove(filename);
+
+   check(fgb.compare(0, 8, string("fgb\3fgb\1", 8)) == 0, "magic bytes");
+   const size_t header = 12;
+   const size_t headerTable = header + u32(fgb, header);
+   ossim_uint64 count;
+   memcpy(&count, fgb.data() + field(fgb, headerTable, 8), sizeof(count));
+   check(count == 2, "feature count in header");
+   check(fgb[field(fgb, headerTable, 2)] == 3, "polygon geometry type");
+   const size_t indexField = field(fgb, headerTable, 9);
+   check(indexField && (fgb[indexField] == 0) && (fgb[indexField + 1] == 0), "no index");
+   const size_t envelope = deref(fgb, field(fgb, headerTable, 1));
+   double env[4];
+   memcpy(env, fgb.data() + envelope + 4, sizeof(env));
+   check((env[0] >= 4) && (env[0] < 6) && (env[2] == 56) && (env[3] == 52), "envelope");
+
+   // Walk the features. The square is written as corners and edge midpoints:
+   size_t at = 8 + 4 + u32(fgb, 8);
+   size_t numFeatures = 0;
+   bool squareFound = false;
+   while (at + 4 <= fgb.size())
+   {
+      const size_t size = u32(fgb, at);
+      const size_t feature = at + 4 + u32(fgb, at + 4);
+      const size_t geometry = deref(fgb, field(fgb, feature, 0));
+      const size_t xy = deref(fgb, field(fgb, geometry, 1));
+      const size_t ends = deref(fgb, field(fgb, geometry, 0));
+      const ossim_uint32 numCoords = u32(fgb, xy);
+      const ossim_uint32 numRings = u32(fgb, ends);
+      check((xy + 4) % 8 == at % 8, "coordinates aligned");
+      check(u32(fgb, ends + 4*numRings) == numCoords/2, "last ring ends with the coordinates");
+      if (numCoords == 18)
+      {
+         double c[18];
+         memcpy(c, fgb.data() + xy + 4, sizeof(c));
+         squareFound = (c[0] == 44) && (c[1] == 40) && (c[4] == 56) && (c[16] == 44) &&
+            (c[17] == 40) && (numRings == 1);
+      }
+      at += 4 + size;
+      ++numFeatures;
+   }
+   check(at == fgb.size() && numFeatures == 2, "two features fill the file");
+   check(squareFound, "square is a closed ring");
+}
+
+int main(int argc, char *argv[])
+{
+   potrace_state_t* state = traceShapes();
+   check(state && state->plist, "traced");
+   if (!state || !state->plist)
+      return 1;
+
+   testGeoJson(state);
+   testSimplifyAndPrecision(state);
+   testFlatGeobuf(state, (argc > 1) ? argv[1] : 0);
+   potrace_state_free(state);
+
+   return ossimPluginTest::summary();
+}
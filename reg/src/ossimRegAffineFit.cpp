@@ -0,0 +1,198 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#include "ossimRegAffineFit.h"
+#include <cmath>
+
+using namespace std;
+
+// Stop sampling once a model is this likely to have been found:
+static const double CONFIDENCE = 0.999;
+
+ossimRegAffineFit::ossimRegAffineFit()
+:  m_model(AFFINE),
+   m_threshold(2.0),
+   m_maxIterations(1000),
+   m_seed(12345),
+   m_numInliers(0),
+   m_rms(0.0)
+{
+   m_a[0] = 0.0; m_a[1] = 1.0; m_a[2] = 0.0;
+   m_b[0] = 0.0; m_b[1] = 0.0; m_b[2] = 1.0;
+}
+
+bool ossimRegAffineFit::fit(const vector<ossimDpt>& from, const vector<ossimDpt>& to)
+{
+   m_a[0] = 0.0; m_a[1] = 1.0; m_a[2] = 0.0;
+   m_b[0] = 0.0; m_b[1] = 0.0; m_b[2] = 1.0;
+   m_inliers.clear();
+   m_numInliers = 0;
+   m_rms = 0.0;
+
+   const ossim_uint32 n = (ossim_uint32) from.size();
+   const ossim_uint32 k = getMinPoints();
+   if ((to.size() != n) || (n < k))
+      return false;
+
+   // Small LCG so that results do not depend on the platform's rand():
+   ossim_uint32 state = m_seed;
+   vector<ossim_uint32> sample (k);
+   double a[3], b[3];
+   ossim_uint32 bestCount = 0;
+   ossim_uint32 iterations = m_maxIterations;
+   for (ossim_uint32 i=0; i<iterations; ++i)
+   {
+      // Draw k distinct indices:
+      for (ossim_uint32 j=0; j<k; ++j)
+      {
+         bool repeated = true;
+         while (repeated)
+         {
+            state = state*1664525u + 1013904223u;
+            sample[j] = (state >> 8) % n;
+            repeated = false;
+            for (ossim_uint32 m=0; m<j; ++m)
+               if (sample[m] == sample[j]) repeated = true;
+         }
+      }
+
+      if (!solve(from, to, sample, a, b))
+         continue;
+
+      ossim_uint32 count = countInliers(from, to, a, b, 0);
+      if (count > bestCount)
+      {
+         bestCount = count;
+         for (int c=0; c<3; ++c)
+         {
+            m_a[c] = a[c];
+            m_b[c] = b[c];
+         }
+
+         // Adaptive number of iterations for the current inlier ratio:
+         double w = pow((double) count / n, (double) k);
+         if (w >= 1.0)
+            break;
+         double needed = log(1.0 - CONFIDENCE) / log(1.0 - w);
+         if (needed < iterations)
+            iterations = (ossim_uint32) ceil(needed);
+      }
+   }
+
+   if (bestCount < k)
+      return false;
+
+   // Refine over the inliers, then take the inliers of the refined model. Twice is enough for
+   // the set to settle in practice:
+   for (int pass=0; pass<2; ++pass)
+   {
+      countInliers(from, to, m_a, m_b, &m_inliers);
+      vector<ossim_uint32> indices;
+      for (ossim_uint32 i=0; i<n; ++i)
+         if (m_inliers[i]) indices.push_back(i);
+      if ((indices.size() < k) || !solve(from, to, indices, a, b))
+         break;
+      for (int c=0; c<3; ++c)
+      {
+         m_a[c] = a[c];
+         m_b[c] = b[c];
+      }
+   }
+
+   m_numInliers = countInliers(from, to, m_a, m_b, &m_inliers);
+   double sum = 0.0;
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      if (m_inliers[i])
+      {
+         ossimDpt d = forward(from[i]) - to[i];
+         sum += d.x*d.x + d.y*d.y;
+      }
+   }
+   if (m_numInliers)
+      m_rms = sqrt(sum / m_numInliers);
+
+   return m_numInliers >= k;
+}
+
+ossimDpt ossimRegAffineFit::forward(const ossimDpt& p) const
+{
+   return ossimDpt(m_a[0] + m_a[1]*p.x + m_a[2]*p.y, m_b[0] + m_b[1]*p.x + m_b[2]*p.y);
+}
+
+bool ossimRegAffineFit::solve(const vector<ossimDpt>& from, const vector<ossimDpt>& to,
+                              const vector<ossim_uint32>& indices, double* a, double* b) const
+{
+   const ossim_uint32 n = (ossim_uint32) indices.size();
+   if (n == 0)
+      return false;
+
+   // Centroids. Working relative to them keeps the normal equations well conditioned for large
+   // image coordinates:
+   ossimDpt cf (0.0, 0.0), ct (0.0, 0.0);
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      cf += from[indices[i]];
+      ct += to[indices[i]];
+   }
+   cf = cf / n;
+   ct = ct / n;
+
+   if (m_model == TRANSLATION)
+   {
+      a[1] = 1.0; a[2] = 0.0; a[0] = ct.x - cf.x;
+      b[1] = 0.0; b[2] = 1.0; b[0] = ct.y - cf.y;
+      return true;
+   }
+
+   double sxx = 0, sxy = 0, syy = 0, sxu = 0, syu = 0, sxv = 0, syv = 0;
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      const double x = from[indices[i]].x - cf.x;
+      const double y = from[indices[i]].y - cf.y;
+      const double u = to[indices[i]].x - ct.x;
+      const double v = to[indices[i]].y - ct.y;
+      sxx += x*x; sxy += x*y; syy += y*y;
+      sxu += x*u; syu += y*u; sxv += x*v; syv += y*v;
+   }
+
+   // Reject (near) collinear samples:
+   const double det = sxx*syy - sxy*sxy;
+   if (fabs(det) <= 1.0e-9*(sxx*syy + 1.0))
+      return false;
+
+   a[1] = ( syy*sxu - sxy*syu) / det;
+   a[2] = (-sxy*sxu + sxx*syu) / det;
+   b[1] = ( syy*sxv - sxy*syv) / det;
+   b[2] = (-sxy*sxv + sxx*syv) / det;
+   a[0] = ct.x - a[1]*cf.x - a[2]*cf.y;
+   b[0] = ct.y - b[1]*cf.x - b[2]*cf.y;
+   return true;
+}
+
+ossim_uint32 ossimRegAffineFit::countInliers(const vector<ossimDpt>& from,
+                                             const vector<ossimDpt>& to,
+                                             const double* a, const double* b,
+                                             vector<bool>* inliers) const
+{
+   const double t2 = m_threshold*m_threshold;
+   ossim_uint32 count = 0;
+   if (inliers)
+      inliers->assign(from.size(), false);
+   for (ossim_uint32 i=0; i<from.size(); ++i)
+   {
+      const double dx = a[0] + a[1]*from[i].x + a[2]*from[i].y - to[i].x;
+      const double dy = b[0] + b[1]*from[i].x + b[2]*from[i].y - to[i].y;
+      if (dx*dx + dy*dy <= t2)
+      {
+         ++count;
+         if (inliers)
+            (*inliers)[i] = true;
+      }
+   }
+   return count;
+}
@@ -0,0 +1,75 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+#ifndef ossimRegAffineFit_HEADER
+#define ossimRegAffineFit_HEADER 1
+
+#include <ossim/plugin/ossimPluginConstants.h>
+#include <ossim/base/ossimDpt.h>
+#include <vector>
+
+/**
+ * Robust fit of a 2D translation or affine transform to point pairs. Candidate models are drawn
+ * from minimal random samples (RANSAC) and the one with the most points within the threshold is
+ * refined by least squares over its inliers. The sampling is seeded, so a given set of points
+ * always gives the same result.
+ *
+ *    x' = a[0] + a[1]*x + a[2]*y
+ *    y' = b[0] + b[1]*x + b[2]*y
+ */
+class OSSIM_DLL ossimRegAffineFit
+{
+public:
+   enum Model { TRANSLATION, AFFINE };
+
+   ossimRegAffineFit();
+
+   void setModel(Model model) { m_model = model; }
+   Model getModel() const { return m_model; }
+
+   /** Max distance in pixels between a transformed point and its pair to count as an inlier. */
+   void setThreshold(double pixels) { m_threshold = pixels; }
+   double getThreshold() const { return m_threshold; }
+
+   void setMaxIterations(ossim_uint32 n) { m_maxIterations = n; }
+   void setSeed(ossim_uint32 seed) { m_seed = seed; }
+
+   /** Fits to = T(from). Returns false if there are too few points or no consistent model. */
+   bool fit(const std::vector<ossimDpt>& from, const std::vector<ossimDpt>& to);
+
+   ossimDpt forward(const ossimDpt& p) const;
+
+   const std::vector<bool>& getInliers() const { return m_inliers; }
+   ossim_uint32 getNumInliers() const { return m_numInliers; }
+
+   /** RMS residual of the inliers in pixels. */
+   double getRms() const { return m_rms; }
+
+   const double* getXCoefficients() const { return m_a; }
+   const double* getYCoefficients() const { return m_b; }
+
+   /** Minimum number of pairs for the model. */
+   ossim_uint32 getMinPoints() const { return (m_model == AFFINE) ? 3 : 1; }
+
+private:
+   bool solve(const std::vector<ossimDpt>& from, const std::vector<ossimDpt>& to,
+              const std::vector<ossim_uint32>& indices, double* a, double* b) const;
+   ossim_uint32 countInliers(const std::vector<ossimDpt>& from, const std::vector<ossimDpt>& to,
+                             const double* a, const double* b, std::vector<bool>* inliers) const;
+
+   Model m_model;
+   double m_threshold;
+   ossim_uint32 m_maxIterations;
+   ossim_uint32 m_seed;
+   double m_a[3];
+   double m_b[3];
+   std::vector<bool> m_inliers;
+   ossim_uint32 m_numInliers;
+   double m_rms;
+};
+
+#endif /* #ifndef ossimRegAffineFit_HEADER */
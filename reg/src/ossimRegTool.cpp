@@ -8,15 +8,74 @@
 #include <ossim/base/ossimArgumentParser.h>
 #include <ossim/base/ossimApplicationUsage.h>
 #include <ossim/base/ossimException.h>
+#include <ossim/base/ossimKeywordNames.h>
+#include <ossim/base/ossimObjectFactoryRegistry.h>
+#include <ossim/base/ossimTieMeasurementGeneratorInterface.h>
+#include <ossim/base/ossim2dBilinearTransform.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimImageSourceFilter.h>
+#include <ossim/imaging/ossimSingleImageChain.h>
 #include "ossimRegTool.h"
+#include <fstream>
+#include <iomanip>
 #include <sstream>
+#include <thread>
 
 using namespace std;
 
 const char* ossimRegTool::DESCRIPTION =
       "Performs registration given list of images.";
 
+static const string PATCH_SIZE_KW = "patch_size";
+static const string PATCH_COUNT_KW = "patch_count";
+static const string GRID_SIZE_KW = "grid_size";
+static const string GUIDED_KW = "guided_matching";
+static const string MAX_MATCHES_KW = "max_matches";
+static const string THREADS_KW = "threads";
+static const string MODEL_KW = "model";
+static const string THRESHOLD_KW = "ransac_threshold";
+static const string OUTPUT_DIR_KW = "output_dir";
+static const string REPORT_FILE_KW = "report_file";
+
+// Overlaps narrower than this (pixels) are not worth matching:
+static const ossim_uint32 MIN_OVERLAP = 64;
+
+namespace
+{
+   // Serializes the tile requests on one input chain and hands out copies, since a chain is not
+   // safe to call from several threads and reuses its tile buffer.
+   class ossimRegTileSource : public ossimImageSourceFilter
+   {
+   public:
+      ossimRegTileSource(ossimImageSource* input) : ossimImageSourceFilter(input) {}
+
+      virtual ossimRefPtr<ossimImageData> getTile(const ossimIrect& rect, ossim_uint32 resLevel=0)
+      {
+         std::lock_guard<std::mutex> lock (m_tileMutex);
+         ossimRefPtr<ossimImageData> tile = ossimImageSourceFilter::getTile(rect, resLevel);
+         if (tile.valid())
+            tile = (ossimImageData*) tile->dup();
+         return tile;
+      }
+
+      // Held while the chain is used other than through getTile.
+      std::mutex& getTileMutex() { return m_tileMutex; }
+
+   private:
+      std::mutex m_tileMutex;
+   };
+}
+
 ossimRegTool::ossimRegTool()
+:  m_patchSize (512),
+   m_patchCount (3),
+   m_gridSize (2),
+   m_guided (false),
+   m_maxMatches (5),
+   m_numThreads (0),
+   m_model (ossimRegAffineFit::AFFINE),
+   m_threshold (2.0)
 {
 }
 
@@ -36,7 +95,27 @@ void ossimRegTool::setUsage(ossimArgumentParser& ap)
    au->setCommandLineUsage(usageString);
 
    // Set the command line options:
-   au->addCommandLineOption("--myoption <float>", "Blah blah");
+   au->addCommandLineOption("--grid-size <int>",
+         "Each patch is split into this many cells per side for matching, each cell keeping at most"
+         " --max-matches ties. Defaults to 2.");
+   au->addCommandLineOption("--guided",
+         "Match each feature only against features near where the image geometries predict it, "
+         "then reject outliers with RANSAC per patch. Faster and more robust than brute force "
+         "when the geometries are within a few tens of pixels.");
+   au->addCommandLineOption("--max-matches <int>", "Ties kept per grid cell. Defaults to 5.");
+   au->addCommandLineOption("--model affine|translation",
+         "Image space correction fitted to the ties of each image. Defaults to affine.");
+   au->addCommandLineOption("--output-dir <dir>",
+         "Directory for the adjusted <image>_reg.geom files. Defaults to the image's directory.");
+   au->addCommandLineOption("--patch-count <int>",
+         "The overlap of each pair is sampled with this many patches per side. Defaults to 3.");
+   au->addCommandLineOption("--patch-size <int>", "Side of a patch in pixels. Defaults to 512.");
+   au->addCommandLineOption("--report <filename>",
+         "Writes the registration report to the file instead of the console.");
+   au->addCommandLineOption("--threads <int>",
+         "Number of threads. Defaults to one per hardware thread.");
+   au->addCommandLineOption("--threshold <float>",
+         "Max residual in pixels for a tie to be an inlier of the fit. Defaults to 2.");
 }
 
 bool ossimRegTool::initialize(ossimArgumentParser& ap)
@@ -47,8 +126,35 @@ bool ossimRegTool::initialize(ossimArgumentParser& ap)
    if (!ossimTool::initialize(ap))
       return false;
 
-   if ( ap.read("--myoption", sp1))
-      m_kwl.addPair("myoption", ts1);
+   if ( ap.read("--grid-size", sp1))
+      m_kwl.addPair(GRID_SIZE_KW, ts1);
+
+   if ( ap.read("--guided"))
+      m_kwl.addPair(GUIDED_KW, "true");
+
+   if ( ap.read("--max-matches", sp1))
+      m_kwl.addPair(MAX_MATCHES_KW, ts1);
+
+   if ( ap.read("--model", sp1))
+      m_kwl.addPair(MODEL_KW, ts1);
+
+   if ( ap.read("--output-dir", sp1))
+      m_kwl.addPair(OUTPUT_DIR_KW, ts1);
+
+   if ( ap.read("--patch-count", sp1))
+      m_kwl.addPair(PATCH_COUNT_KW, ts1);
+
+   if ( ap.read("--patch-size", sp1))
+      m_kwl.addPair(PATCH_SIZE_KW, ts1);
+
+   if ( ap.read("--report", sp1))
+      m_kwl.addPair(REPORT_FILE_KW, ts1);
+
+   if ( ap.read("--threads", sp1))
+      m_kwl.addPair(THREADS_KW, ts1);
+
+   if ( ap.read("--threshold", sp1))
+      m_kwl.addPair(THRESHOLD_KW, ts1);
 
    processRemainingArgs(ap);
    return true;
@@ -67,35 +173,476 @@ void ossimRegTool::initialize(const ossimKeywordlist& kwl)
       m_kwl.addList( kwl, true );
    }
 
-   value = m_kwl.findKey("myoption");
+   value = m_kwl.findKey(PATCH_SIZE_KW);
+   if (!value.empty())
+      m_patchSize = value.toUInt32();
+
+   value = m_kwl.findKey(PATCH_COUNT_KW);
+   if (!value.empty())
+      m_patchCount = value.toUInt32();
+
+   value = m_kwl.findKey(GRID_SIZE_KW);
+   if (!value.empty())
+      m_gridSize = value.toUInt32();
+
+   value = m_kwl.findKey(GUIDED_KW);
    if (!value.empty())
-      double myoption = value.toDouble();
+      m_guided = value.toBool();
+
+   value = m_kwl.findKey(MAX_MATCHES_KW);
+   if (!value.empty())
+      m_maxMatches = value.toUInt32();
+
+   value = m_kwl.findKey(THREADS_KW);
+   if (!value.empty())
+      m_numThreads = value.toUInt32();
+
+   value = m_kwl.findKey(THRESHOLD_KW);
+   if (!value.empty())
+      m_threshold = value.toDouble();
+
+   value = m_kwl.findKey(MODEL_KW);
+   if (value.contains("affine"))
+      m_model = ossimRegAffineFit::AFFINE;
+   else if (value.contains("translation"))
+      m_model = ossimRegAffineFit::TRANSLATION;
+   else if (!value.empty())
+   {
+      xmsg <<"ossimRegTool:"<<__LINE__<<" Unallowed model requested: <"<<value<<">."<<endl;
+      throw ossimException(xmsg.str());
+   }
+
+   m_outputDir = m_kwl.findKey(OUTPUT_DIR_KW);
+   m_reportFile = m_kwl.findKey(REPORT_FILE_KW);
+
+   if ((m_patchSize < MIN_OVERLAP) || (m_patchCount == 0) || (m_gridSize == 0) ||
+         (m_maxMatches == 0) || (m_threshold <= 0.0))
+   {
+      xmsg <<"ossimRegTool:"<<__LINE__<<" Invalid patch, grid, match or threshold setting."<<endl;
+      throw ossimException(xmsg.str());
+   }
 
    ossimChipProcTool::initialize(kwl);
 }
 
+void ossimRegTool::initProcessingChain()
+{
+   // Nothing to do.
+}
+
+void ossimRegTool::finalizeChain()
+{
+   // Do nothing and avoid ossimChipProcUtil from doing its standard stuff.
+}
+
 bool ossimRegTool::execute()
 {
    ostringstream xmsg;
 
+   if ((m_imgLayers.size() < 2) || !m_geom.valid())
+   {
+      xmsg<<"ossimRegTool:"<<__LINE__<<" At least two input images are needed! ";
+      throw ossimException(xmsg.str());
+   }
+
+   // The tie measurement generator lives in the opencv plugin:
+   {
+      ossimRefPtr<ossimObject> obj = ossimObjectFactoryRegistry::instance()->
+            createObject(ossimString("ossimTieMeasurementGenerator"));
+      if (!dynamic_cast<ossimTieMeasurementGeneratorInterface*>(obj.get()))
+      {
+         xmsg<<"ossimRegTool:"<<__LINE__<<" No tie measurement generator available. Is the "
+               "opencv plugin loaded?";
+         throw ossimException(xmsg.str());
+      }
+   }
+
+   // Thread-safe access to the input chains:
+   m_tileSources.clear();
+   for (ossim_uint32 i=0; i<m_imgLayers.size(); ++i)
+      m_tileSources.push_back(new ossimRegTileSource(m_imgLayers[i].get()));
+
    // Establish intersections
+   vector<Job> jobs;
+   bool overlaps = findOverlaps(jobs);
+
+   // Find tiepoints. Patches of all pairs go to one pool; whatever threads are left over go to
+   // the grid cells inside a patch:
+   if (overlaps)
+   {
+      ossim_uint32 numThreads = m_numThreads ? m_numThreads : thread::hardware_concurrency();
+      if (numThreads == 0)
+         numThreads = 1;
+      ossim_uint32 numWorkers = numThreads;
+      if (numWorkers > jobs.size())
+         numWorkers = (ossim_uint32) jobs.size();
+      ossim_uint32 generatorThreads = numThreads / numWorkers;
 
-   // Find tiepoints
+      atomic<ossim_uint32> nextJob (0);
+      vector<thread> workers;
+      for (ossim_uint32 t=1; t<numWorkers; ++t)
+      {
+         workers.push_back(thread(&ossimRegTool::collectTies, this, ref(jobs), ref(nextJob),
+                                  generatorThreads));
+      }
+      collectTies(jobs, nextJob, generatorThreads);
+      for (ossim_uint32 t=0; t<workers.size(); ++t)
+         workers[t].join();
 
-   // Register images
+      mergeTies(jobs);
+
+      // Register images
+      registerPairs();
+   }
+
+   bool writeOK = writeGeometries();
 
    // Report results
+   if (m_reportFile.empty())
+   {
+      writeReport(cout, jobs);
+   }
+   else
+   {
+      ofstream reportStream (m_reportFile.chars());
+      if (reportStream.fail())
+      {
+         xmsg<<"ossimRegTool:"<<__LINE__<<" Could not open report file <"<<m_reportFile<<">.";
+         throw ossimException(xmsg.str());
+      }
+      writeReport(reportStream, jobs);
+   }
 
-   return true;
+   m_tileSources.clear();
+
+   if (!overlaps)
+      return false;
+   for (ossim_uint32 i=0; i<m_pairs.size(); ++i)
+      if (!m_pairs[i].solved) return false;
+   return writeOK;
 }
 
+bool ossimRegTool::findOverlaps(vector<Job>& jobs)
+{
+   m_pairs.clear();
+   jobs.clear();
+
+   // All layers are rendered in the common view space of m_geom:
+   ossimIrect refRect = m_imgLayers[0]->getBoundingRect();
+   for (ossim_uint32 k=1; k<m_imgLayers.size(); ++k)
+   {
+      Pair pair;
+      pair.secondary = k;
+      pair.fit.setModel(m_model);
+      pair.fit.setThreshold(m_threshold);
+
+      ossimIrect rect = m_imgLayers[k]->getBoundingRect();
+      if (refRect.hasNans() || rect.hasNans() || !refRect.intersects(rect))
+      {
+         m_pairs.push_back(pair);
+         continue;
+      }
+      pair.overlap = refRect.clipToRect(rect);
+      if ((pair.overlap.width() < MIN_OVERLAP) || (pair.overlap.height() < MIN_OVERLAP))
+      {
+         m_pairs.push_back(pair);
+         continue;
+      }
+
+      // Patches evenly spread over the overlap, fewer if the overlap is small:
+      ossim_uint32 w = min(m_patchSize, pair.overlap.width());
+      ossim_uint32 h = min(m_patchSize, pair.overlap.height());
+      ossim_uint32 nx = min(m_patchCount, pair.overlap.width() / w);
+      ossim_uint32 ny = min(m_patchCount, pair.overlap.height() / h);
+      if (nx == 0) nx = 1;
+      if (ny == 0) ny = 1;
+      for (ossim_uint32 r=0; r<ny; ++r)
+      {
+         for (ossim_uint32 c=0; c<nx; ++c)
+         {
+            ossim_int32 cx = pair.overlap.ul().x + (ossim_int32)((2*c+1)*pair.overlap.width()/(2*nx));
+            ossim_int32 cy = pair.overlap.ul().y + (ossim_int32)((2*r+1)*pair.overlap.height()/(2*ny));
+            ossim_int32 ulx = cx - (ossim_int32)w/2;
+            ossim_int32 uly = cy - (ossim_int32)h/2;
+            ulx = max(pair.overlap.ul().x, min(ulx, pair.overlap.lr().x - (ossim_int32)w + 1));
+            uly = max(pair.overlap.ul().y, min(uly, pair.overlap.lr().y - (ossim_int32)h + 1));
+
+            Job job;
+            job.pair = (ossim_uint32) m_pairs.size();
+            job.viewRect = ossimIrect(ulx, uly, ulx + w - 1, uly + h - 1);
+            jobs.push_back(job);
+            ++pair.numPatches;
+         }
+      }
+      m_pairs.push_back(pair);
+   }
+
+   return !jobs.empty();
+}
+
+void ossimRegTool::collectTies(vector<Job>& jobs, atomic<ossim_uint32>& nextJob,
+                               ossim_uint32 generatorThreads)
+{
+   ossim_uint32 j;
+   while ((j = nextJob++) < jobs.size())
+   {
+      try
+      {
+         runJob(jobs[j], generatorThreads);
+      }
+      catch (const std::exception& e)
+      {
+         jobs[j].ok = false;
+         jobs[j].report += e.what();
+      }
+      catch (...)
+      {
+         jobs[j].ok = false;
+      }
+   }
+}
+
+void ossimRegTool::runJob(Job& job, ossim_uint32 generatorThreads)
+{
+   const Pair& pair = m_pairs[job.pair];
+   ostringstream report;
+
+   ossimRefPtr<ossimObject> obj;
+   ossimTieMeasurementGeneratorInterface* generator = 0;
+   {
+      // Factories and the chain visitors used by setROIs are not meant for concurrent use:
+      std::lock_guard<std::mutex> lock (m_mutex);
+      obj = ossimObjectFactoryRegistry::instance()->
+            createObject(ossimString("ossimTieMeasurementGenerator"));
+      generator = dynamic_cast<ossimTieMeasurementGeneratorInterface*>(obj.get());
+      if (!generator || !generator->init(report))
+      {
+         job.report = report.str();
+         return;
+      }
+
+      ossimKeywordlist kwl;
+      kwl.add("use_grid", (m_gridSize > 1) ? "true" : "false");
+      ostringstream grid;
+      grid << m_gridSize << " " << m_gridSize;
+      kwl.add("grid_size", grid.str().c_str());
+      kwl.add("max_matches", m_maxMatches);
+      kwl.add("threads", generatorThreads);
+      kwl.add("guided", m_guided ? "true" : "false");
+      obj->loadState(kwl);
+
+      vector<ossimImageSource*> src;
+      src.push_back(m_tileSources[0].get());
+      src.push_back(m_tileSources[pair.secondary].get());
+      generator->setImageList(src);
+
+      //---
+      // setROIs gives the generator its own copies of the chain geometries, so the projections
+      // of concurrent jobs do not share state. No tile of either chain may be rendered while
+      // they are copied:
+      //---
+      ossimRegTileSource* refSource = static_cast<ossimRegTileSource*>(m_tileSources[0].get());
+      ossimRegTileSource* imgSource =
+            static_cast<ossimRegTileSource*>(m_tileSources[pair.secondary].get());
+      std::lock(refSource->getTileMutex(), imgSource->getTileMutex());
+      std::lock_guard<std::mutex> refLock (refSource->getTileMutex(), std::adopt_lock);
+      std::lock_guard<std::mutex> imgLock (imgSource->getTileMutex(), std::adopt_lock);
+
+      vector<ossimIrect> roi (2, job.viewRect);
+      if (!generator->setROIs(roi))
+      {
+         job.report = report.str();
+         return;
+      }
+   }
+
+   report << "\n Pair " << job.pair+1 << ", patch " << job.viewRect << endl;
+   job.ok = generator->run();
+   for (int i=0; i<generator->numMeasurements(); ++i)
+   {
+      job.refPts.push_back(generator->pointIndexedAt(0, i));
+      job.imgPts.push_back(generator->pointIndexedAt(1, i));
+   }
+   job.report = report.str();
+}
+
+void ossimRegTool::mergeTies(const vector<Job>& jobs)
+{
+   for (ossim_uint32 j=0; j<jobs.size(); ++j)
+   {
+      Pair& pair = m_pairs[jobs[j].pair];
+      if (!jobs[j].ok)
+         ++pair.numFailed;
+      pair.refPts.insert(pair.refPts.end(), jobs[j].refPts.begin(), jobs[j].refPts.end());
+      pair.imgPts.insert(pair.imgPts.end(), jobs[j].imgPts.begin(), jobs[j].imgPts.end());
+   }
+}
+
+void ossimRegTool::registerPairs()
+{
+   ossimRefPtr<ossimImageGeometry> refGeom =
+         m_imgLayers[0]->getImageHandler()->getImageGeometry();
+
+   for (ossim_uint32 p=0; p<m_pairs.size(); ++p)
+   {
+      Pair& pair = m_pairs[p];
+      ossimRefPtr<ossimImageGeometry> geom =
+            m_imgLayers[pair.secondary]->getImageHandler()->getImageGeometry();
+      if (!refGeom.valid() || !geom.valid())
+         continue;
+
+      //---
+      // Where the secondary's current model puts the ground seen at each reference tie. The
+      // correction maps the measured image point there, so the adjusted model sends the measured
+      // point to that ground position:
+      //---
+      vector<ossimDpt> measured;
+      vector<ossimDpt> predicted;
+      for (ossim_uint32 i=0; i<pair.refPts.size(); ++i)
+      {
+         ossimGpt gpt;
+         ossimDpt ipt;
+         refGeom->localToWorld(pair.refPts[i], gpt);
+         if (gpt.hasNans())
+            continue;
+         geom->worldToLocal(gpt, ipt);
+         if (ipt.hasNans() || pair.imgPts[i].hasNans())
+            continue;
+         measured.push_back(pair.imgPts[i]);
+         predicted.push_back(ipt);
+      }
+
+      pair.solved = pair.fit.fit(measured, predicted);
+   }
+}
+
+bool ossimRegTool::writeGeometries()
+{
+   bool writeOK = true;
+   for (ossim_uint32 p=0; p<m_pairs.size(); ++p)
+   {
+      Pair& pair = m_pairs[p];
+      if (!pair.solved)
+         continue;
+
+      ossimRefPtr<ossimImageHandler> handler = m_imgLayers[pair.secondary]->getImageHandler();
+      ossimRefPtr<ossimImageGeometry> geom =
+            (ossimImageGeometry*) handler->getImageGeometry()->dup();
+
+      //---
+      // Fold the correction into the geometry's 2D transform. A bilinear transform through the
+      // corners represents the affine correction exactly, and an existing shift or affine
+      // transform composed with it:
+      //---
+      ossimIrect bounds = handler->getImageRectangle(0);
+      ossimDpt local[4] = { bounds.ul(), bounds.ur(), bounds.lr(), bounds.ll() };
+      ossimDpt full[4];
+      ossimRefPtr<ossim2dTo2dTransform> oldXform = geom->getTransform();
+      for (int i=0; i<4; ++i)
+      {
+         full[i] = pair.fit.forward(local[i]);
+         if (oldXform.valid())
+            oldXform->forward(ossimDpt(full[i]), full[i]);
+      }
+      geom->setTransform(new ossim2dBilinearTransform(local, full, 4));
+
+      ossimFilename imageFile = handler->getFilename();
+      ossimFilename dir = m_outputDir.empty() ? imageFile.path() : m_outputDir;
+      pair.geomFile = dir.dirCat(imageFile.fileNoExtension() + "_reg.geom");
+
+      ossimKeywordlist kwl;
+      geom->saveState(kwl);
+      if (!kwl.write(pair.geomFile.chars()))
+      {
+         pair.geomFile.clear();
+         writeOK = false;
+      }
+   }
+   return writeOK;
+}
+
+void ossimRegTool::writeReport(ostream& out, const vector<Job>& jobs) const
+{
+   out << "\nossimRegTool Report"
+       << "\n~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~"
+       << "\n Reference:  " << m_imgLayers[0]->getImageHandler()->getFilename()
+       << "\n Model:      " << ((m_model == ossimRegAffineFit::AFFINE) ? "affine" : "translation")
+       << "\n Patches:    " << m_patchCount << "x" << m_patchCount << " of " << m_patchSize
+       << " pixels, " << m_gridSize << "x" << m_gridSize << " cells, "
+       << m_maxMatches << " ties per cell"
+       << (m_guided ? ", guided matching" : "")
+       << "\n Threshold:  " << m_threshold << " pixels" << endl;
+
+   for (ossim_uint32 p=0; p<m_pairs.size(); ++p)
+   {
+      const Pair& pair = m_pairs[p];
+      out << "\n Pair " << p+1 << ": "
+          << m_imgLayers[pair.secondary]->getImageHandler()->getFilename() << endl;
+      if (pair.numPatches == 0)
+      {
+         out << "   No usable overlap with the reference." << endl;
+         continue;
+      }
+      out << "   Overlap:  " << pair.overlap << endl;
+      out << "   Patches:  " << pair.numPatches;
+      if (pair.numFailed)
+         out << " (" << pair.numFailed << " failed)";
+      out << "\n   Ties:     " << pair.refPts.size() << endl;
+      if (!pair.solved)
+      {
+         out << "   Not registered: too few consistent ties." << endl;
+         continue;
+      }
+
+      const double* a = pair.fit.getXCoefficients();
+      const double* b = pair.fit.getYCoefficients();
+      out << "   Inliers:  " << pair.fit.getNumInliers()
+          << "\n   RMS:      " << setprecision(3) << fixed << pair.fit.getRms() << " pixels"
+          << setprecision(8)
+          << "\n   x' = " << a[0] << " + " << a[1] << "*x + " << a[2] << "*y"
+          << "\n   y' = " << b[0] << " + " << b[1] << "*x + " << b[2] << "*y" << endl;
+      out.unsetf(ios_base::floatfield);
+      if (pair.geomFile.empty())
+         out << "   Adjusted geometry could not be written." << endl;
+      else
+         out << "   Geometry: " << pair.geomFile << endl;
+   }
+
+   // Tie collection detail, in patch order:
+   for (ossim_uint32 j=0; j<jobs.size(); ++j)
+      out << jobs[j].report;
+   out << endl;
+}
 
 void ossimRegTool::getKwlTemplate(ossimKeywordlist& kwl)
 {
    ostringstream value;
-   value<<"<float> (optional, defaults to <ADD DEFAULT>)";
-   kwl.addPair("myoption", value.str());
+   value<<"<int> (optional, defaults to "<<m_gridSize<<")";
+   kwl.addPair(GRID_SIZE_KW, value.str());
 
-}
+   value.str("");
+   value<<"<int> (optional, defaults to "<<m_maxMatches<<")";
+   kwl.addPair(MAX_MATCHES_KW, value.str());
+
+   kwl.addPair(GUIDED_KW, "true|false (optional, defaults to false)");
+   kwl.addPair(MODEL_KW, "affine|translation (optional, defaults to affine)");
+   kwl.addPair(OUTPUT_DIR_KW, "<dir> (optional, defaults to the image directory)");
+
+   value.str("");
+   value<<"<int> (optional, defaults to "<<m_patchCount<<")";
+   kwl.addPair(PATCH_COUNT_KW, value.str());
 
+   value.str("");
+   value<<"<int> (optional, defaults to "<<m_patchSize<<")";
+   kwl.addPair(PATCH_SIZE_KW, value.str());
 
+   value.str("");
+   value<<"<float> (optional, defaults to "<<m_threshold<<")";
+   kwl.addPair(THRESHOLD_KW, value.str());
+
+   kwl.addPair(REPORT_FILE_KW, "<filename> (optional, defaults to console)");
+   kwl.addPair(THREADS_KW, "<int> (optional, defaults to one per hardware thread)");
+
+   kwl.add("image_file0", "<reference-raster-file>");
+   kwl.add("image_file1", "<input-raster-file>");
+}
@@ -11,7 +11,21 @@
 #include <ossim/plugin/ossimPluginConstants.h>
 #include <ossim/imaging/ossimImageHandler.h>
 #include <ossim/util/ossimChipProcTool.h>
+#include "ossimRegAffineFit.h"
+#include <atomic>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
 
+/**
+ * Registers each input image to the first one. For every pair the overlap is computed in the
+ * common view space and sampled with a grid of patches. Each patch is matched by the opencv
+ * plugin's tie measurement generator, with the patches of all pairs spread over a pool of
+ * threads. Only the tiles of patches in flight are held in memory. A translation or affine image
+ * space correction is then fitted to the ties with RANSAC and the adjusted geometry of the image
+ * is written next to it (or to the output directory) as <image>_reg.geom, together with a report.
+ */
 class OSSIM_DLL ossimRegTool : public ossimChipProcTool
 {
 public:
@@ -34,8 +48,71 @@ public:
    virtual void getKwlTemplate(ossimKeywordlist& kwl);
 
 private:
+   /** One patch of one image pair and the ties found in it. */
+   struct Job
+   {
+      Job() : pair(0), ok(false) {}
+      ossim_uint32 pair;
+      ossimIrect viewRect;
+      std::vector<ossimDpt> refPts;   // Image coordinates on the reference
+      std::vector<ossimDpt> imgPts;   // Image coordinates on the secondary
+      bool ok;
+      std::string report;
+   };
+
+   /** Image pair to register: m_imgLayers[0] and m_imgLayers[secondary]. */
+   struct Pair
+   {
+      Pair() : secondary(0), numPatches(0), numFailed(0), solved(false) {}
+      ossim_uint32 secondary;
+      ossimIrect overlap;
+      std::vector<ossimDpt> refPts;
+      std::vector<ossimDpt> imgPts;
+      ossim_uint32 numPatches;
+      ossim_uint32 numFailed;
+      ossimRegAffineFit fit;
+      bool solved;
+      ossimFilename geomFile;
+   };
+
    virtual void initProcessingChain();
    virtual void finalizeChain();
+
+   /** Sets up the pairs and the patch jobs. Returns false if no pair overlaps. */
+   bool findOverlaps(std::vector<Job>& jobs);
+
+   /** Worker loop taking jobs until none are left. */
+   void collectTies(std::vector<Job>& jobs, std::atomic<ossim_uint32>& nextJob,
+                    ossim_uint32 generatorThreads);
+
+   /** Matches one patch, storing the ties in the job. */
+   void runJob(Job& job, ossim_uint32 generatorThreads);
+
+   /** Appends the job ties to their pairs, in job order so results do not depend on timing. */
+   void mergeTies(const std::vector<Job>& jobs);
+
+   /** Fits the correction of each pair from its ties. */
+   void registerPairs();
+
+   /** Writes <image>_reg.geom for each solved pair. */
+   bool writeGeometries();
+
+   void writeReport(std::ostream& out, const std::vector<Job>& jobs) const;
+
+   ossim_uint32 m_patchSize;
+   ossim_uint32 m_patchCount;
+   ossim_uint32 m_gridSize;
+   bool m_guided;
+   ossim_uint32 m_maxMatches;
+   ossim_uint32 m_numThreads;
+   ossimRegAffineFit::Model m_model;
+   double m_threshold;
+   ossimFilename m_outputDir;
+   ossimFilename m_reportFile;
+
+   std::vector<Pair> m_pairs;
+   std::vector<ossimRefPtr<ossimImageSource> > m_tileSources;
+   std::mutex m_mutex; // Guards generator creation and setup
 };
 
 #endif /* #ifndef ossimRegTool_HEADER */
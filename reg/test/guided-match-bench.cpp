@@ -0,0 +1,339 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Cost and quality of the two matching schemes of ossimTieMeasurementGenerator, followed by the
+// robust fit the registration tool runs on the ties. Keypoints of patch B are those of patch A
+// moved by a known affine transform with 0.5 px of noise, 256 bit binary descriptors (ORB's)
+// with a fifth of their bits flipped. 30% of A has no partner in B, B has 50% more keypoints
+// that match nothing, and half of A are near copies of other A descriptors, as on repeated
+// texture.
+//
+//  - Brute force compares every A descriptor with every B one and keeps matches under three
+//    times the smallest distance, as the generator does by default.
+//  - Guided compares each A descriptor with the B keypoints within the search radius of where
+//    the predicted transform puts it, and keeps it if it beats the runner-up by the ratio, as
+//    the generator does with setGuidedMatching(true). The prediction is off by about 0.3 px, as the
+//    view -> ground -> view one is.
+//  - The ties of each scheme then go through ossimRegAffineFit with a 3 px threshold, the
+//    default of the generator's own RANSAC step.
+//
+// Usage: guided-match-bench [keypoints in A ...]
+
+#include "../src/ossimRegAffineFit.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+static const double PATCH_SIZE = 2048.0;
+static const double SEARCH_RADIUS = 20.0;
+static const double MATCH_RATIO = 0.8;
+static const double RANSAC_THRESHOLD = 3.0;
+
+// A to B: small rotation and scale, then a shift.
+static const double A_X[3] = { 3.2, 1.0012, 0.0087 };
+static const double A_Y[3] = { -1.7, -0.0087, 1.0012 };
+
+struct Descriptor
+{
+   ossim_uint64 bits[4];
+};
+
+struct Keypoints
+{
+   vector<ossimDpt> points;
+   vector<Descriptor> descriptors;
+};
+
+static double seconds(const chrono::steady_clock::time_point& start)
+{
+   return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Repeatable across platforms:
+static ossim_uint64 random64(ossim_uint64& state)
+{
+   state = state*6364136223846793005ull + 1442695040888963407ull;
+   return state;
+}
+
+static double uniform(ossim_uint64& state, double lo, double hi)
+{
+   return lo + (hi - lo)*(random64(state) >> 11)*(1.0/9007199254740992.0);
+}
+
+static double gaussian(ossim_uint64& state, double sigma)
+{
+   const double u = uniform(state, 1.0e-12, 1.0);
+   return sigma*sqrt(-2.0*log(u))*cos(2.0*M_PI*uniform(state, 0.0, 1.0));
+}
+
+static Descriptor randomDescriptor(ossim_uint64& state)
+{
+   Descriptor d;
+   for (int i=0; i<4; ++i)
+      d.bits[i] = random64(state);
+   return d;
+}
+
+static Descriptor flip(Descriptor d, double p, ossim_uint64& state)
+{
+   for (int i=0; i<256; ++i)
+      if (uniform(state, 0.0, 1.0) < p)
+         d.bits[i/64] ^= 1ull << (i%64);
+   return d;
+}
+
+// OpenCV's Hamming norm uses the hardware count where there is one.
+static int popcount(ossim_uint64 x)
+{
+#if defined(__GNUC__)
+   return __builtin_popcountll(x);
+#else
+   x = x - ((x >> 1) & 0x5555555555555555ull);
+   x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+   x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+   return (int)((x*0x0101010101010101ull) >> 56);
+#endif
+}
+
+static int hamming(const Descriptor& a, const Descriptor& b)
+{
+   return popcount(a.bits[0]^b.bits[0]) + popcount(a.bits[1]^b.bits[1]) +
+      popcount(a.bits[2]^b.bits[2]) + popcount(a.bits[3]^b.bits[3]);
+}
+
+static ossimDpt transform(const double* a, const double* b, const ossimDpt& p)
+{
+   return ossimDpt(a[0] + a[1]*p.x + a[2]*p.y, b[0] + b[1]*p.x + b[2]*p.y);
+}
+
+// Fills A and B, and truth[i] with the B index of A keypoint i, -1 if it has none.
+static void synthesize(ossim_uint32 n, Keypoints& a, Keypoints& b, vector<int>& truth)
+{
+   ossim_uint64 state = 1;
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      a.points.push_back(ossimDpt(uniform(state, 0, PATCH_SIZE), uniform(state, 0, PATCH_SIZE)));
+      a.descriptors.push_back(randomDescriptor(state));
+   }
+   for (ossim_uint32 i=0; i<n; i+=2)
+      a.descriptors[i] = flip(a.descriptors[(i + 7)%n], 0.15, state);
+   truth.assign(n, -1);
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      if (i%10 < 7)
+      {
+         ossimDpt p = transform(A_X, A_Y, a.points[i]);
+         truth[i] = (int)b.points.size();
+         b.points.push_back(ossimDpt(p.x + gaussian(state, 0.5), p.y + gaussian(state, 0.5)));
+         b.descriptors.push_back(flip(a.descriptors[i], 0.2, state));
+      }
+   }
+   for (ossim_uint32 i=0; i<n/2; ++i)
+   {
+      b.points.push_back(ossimDpt(uniform(state, 0, PATCH_SIZE), uniform(state, 0, PATCH_SIZE)));
+      b.descriptors.push_back(randomDescriptor(state));
+   }
+}
+
+struct Result
+{
+   vector<int> matches;  // B index of each A keypoint, -1 if not kept
+   double seconds;
+   double comparisons;   // per A keypoint
+};
+
+static Result bruteForce(const Keypoints& a, const Keypoints& b)
+{
+   Result r;
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   vector<int> distances(a.points.size());
+   r.matches.assign(a.points.size(), -1);
+   int minDistance = 256;
+   for (size_t i=0; i<a.points.size(); ++i)
+   {
+      int best = 257;
+      for (size_t j=0; j<b.points.size(); ++j)
+      {
+         const int d = hamming(a.descriptors[i], b.descriptors[j]);
+         if (d < best)
+         {
+            best = d;
+            r.matches[i] = (int)j;
+         }
+      }
+      distances[i] = best;
+      minDistance = min(minDistance, best);
+   }
+   for (size_t i=0; i<a.points.size(); ++i)
+      if (distances[i] >= 3*max(minDistance, 1))
+         r.matches[i] = -1;
+   r.seconds = seconds(start);
+   r.comparisons = (double)b.points.size();
+   return r;
+}
+
+static Result guided(const Keypoints& a, const Keypoints& b)
+{
+   // Prediction off by about 0.3 px.
+   const double PX[3] = { A_X[0] - 0.2, A_X[1], A_X[2] };
+   const double PY[3] = { A_Y[0] - 0.2, A_Y[1], A_Y[2] };
+
+   Result r;
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   const double binSize = SEARCH_RADIUS;
+   const int bins = (int)((PATCH_SIZE + 2*SEARCH_RADIUS)/binSize) + 1;
+   vector< vector<int> > grid(bins*bins);
+   for (size_t j=0; j<b.points.size(); ++j)
+   {
+      const int bx = min(bins - 1, max(0, (int)floor(b.points[j].x/binSize)));
+      const int by = min(bins - 1, max(0, (int)floor(b.points[j].y/binSize)));
+      grid[by*bins + bx].push_back((int)j);
+   }
+
+   r.matches.assign(a.points.size(), -1);
+   double comparisons = 0.0;
+   const double r2 = SEARCH_RADIUS*SEARCH_RADIUS;
+   for (size_t i=0; i<a.points.size(); ++i)
+   {
+      const ossimDpt p = transform(PX, PY, a.points[i]);
+      const int x0 = max(0, (int)floor((p.x - SEARCH_RADIUS)/binSize));
+      const int x1 = min(bins - 1, (int)floor((p.x + SEARCH_RADIUS)/binSize));
+      const int y0 = max(0, (int)floor((p.y - SEARCH_RADIUS)/binSize));
+      const int y1 = min(bins - 1, (int)floor((p.y + SEARCH_RADIUS)/binSize));
+      int best = 257;
+      int second = 257;
+      int bestIndex = -1;
+      for (int y=y0; y<=y1; ++y)
+      {
+         for (int x=x0; x<=x1; ++x)
+         {
+            const vector<int>& bin = grid[y*bins + x];
+            for (size_t k=0; k<bin.size(); ++k)
+            {
+               const ossimDpt d = b.points[bin[k]] - p;
+               if (d.x*d.x + d.y*d.y > r2)
+                  continue;
+               ++comparisons;
+               const int distance = hamming(a.descriptors[i], b.descriptors[bin[k]]);
+               if (distance < best)
+               {
+                  second = best;
+                  best = distance;
+                  bestIndex = bin[k];
+               }
+               else if (distance < second)
+               {
+                  second = distance;
+               }
+            }
+         }
+      }
+      if ((bestIndex >= 0) && ((second == 257) || (best < MATCH_RATIO*second)))
+         r.matches[i] = bestIndex;
+   }
+   r.seconds = seconds(start);
+   r.comparisons = comparisons/a.points.size();
+   return r;
+}
+
+static void report(const char* name, const Result& r, const Keypoints& a, const Keypoints& b,
+                   const vector<int>& truth)
+{
+   vector<ossimDpt> from;
+   vector<ossimDpt> to;
+   vector<bool> correct;
+   for (size_t i=0; i<r.matches.size(); ++i)
+   {
+      if (r.matches[i] < 0)
+         continue;
+      from.push_back(a.points[i]);
+      to.push_back(b.points[r.matches[i]]);
+      correct.push_back(r.matches[i] == truth[i]);
+   }
+   const size_t kept = from.size();
+   const size_t good = count(correct.begin(), correct.end(), true);
+
+   ossimRegAffineFit fit;
+   fit.setThreshold(RANSAC_THRESHOLD);
+   const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   const bool fitted = fit.fit(from, to);
+   const double fitTime = seconds(start);
+   size_t goodInliers = 0;
+   double maxError = 0.0;
+   if (fitted)
+   {
+      for (size_t i=0; i<kept; ++i)
+         if (fit.getInliers()[i] && correct[i])
+            ++goodInliers;
+      for (int y=0; y<=2048; y+=256)
+      {
+         for (int x=0; x<=2048; x+=256)
+         {
+            const ossimDpt e = fit.forward(ossimDpt(x, y)) - transform(A_X, A_Y, ossimDpt(x, y));
+            maxError = max(maxError, sqrt(e.x*e.x + e.y*e.y));
+         }
+      }
+   }
+
+   cout << "  " << setw(12) << left << name << right << fixed << setprecision(2)
+        << setw(10) << 1000.0*r.seconds << setw(9) << setprecision(1) << r.comparisons
+        << setw(7) << kept << setw(7) << setprecision(0) << (kept ? 100.0*good/kept : 0.0)
+        << "%";
+   if (fitted)
+   {
+      cout << setw(10) << setprecision(2) << 1000.0*fitTime << setw(7)
+           << fit.getNumInliers() << setw(7) << setprecision(0)
+           << 100.0*fit.getNumInliers()/kept << "%" << setw(7)
+           << (fit.getNumInliers() ? 100.0*goodInliers/fit.getNumInliers() : 0.0) << "%"
+           << setw(9) << setprecision(3) << maxError;
+   }
+   else
+   {
+      cout << "    no fit";
+   }
+   cout << endl;
+}
+
+int main(int argc, char* argv[])
+{
+   vector<ossim_uint32> sizes;
+   for (int i=1; i<argc; ++i)
+      sizes.push_back(atoi(argv[i]));
+   if (sizes.empty())
+   {
+      sizes.push_back(500);
+      sizes.push_back(2000);
+      sizes.push_back(8000);
+   }
+
+   cout << "                  match   compared  ties   good  fit (ms) inliers ratio   "
+        << "good  max err" << endl
+        << "                   (ms)    per pt                                         "
+        << "        (px)" << endl;
+   for (size_t s=0; s<sizes.size(); ++s)
+   {
+      Keypoints a;
+      Keypoints b;
+      vector<int> truth;
+      synthesize(sizes[s], a, b, truth);
+      cout << a.points.size() << " / " << b.points.size() << " keypoints" << endl;
+      const Result brute = bruteForce(a, b);
+      const Result guide = guided(a, b);
+      report("brute force", brute, a, b, truth);
+      report("guided", guide, a, b, truth);
+      cout << "  guided speed-up " << setprecision(1) << brute.seconds/guide.seconds << "x"
+           << endl;
+   }
+   return 0;
+}
@@ -0,0 +1,135 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// Regression test for the robust transform fit used by the registration tool. Tie points are
+// synthesized from a known transform with noise and a share of gross outliers, the way a matcher
+// returns them, and the fit must recover the transform.
+
+#include "../src/ossimRegAffineFit.h"
+#include "../../test/ossimPluginTest.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+// Uniform in [lo, hi), repeatable across platforms:
+static double uniform(ossim_uint32& state, double lo, double hi)
+{
+   state = state*1103515245u + 12345u;
+   return lo + (hi - lo)*((state >> 8) & 0xFFFF)/65536.0;
+}
+
+static void synthesize(const double* a, const double* b, ossim_uint32 n, double outlierRatio,
+                       vector<ossimDpt>& from, vector<ossimDpt>& to, vector<bool>& isOutlier)
+{
+   ossim_uint32 state = 42;
+   from.clear(); to.clear(); isOutlier.clear();
+   for (ossim_uint32 i=0; i<n; ++i)
+   {
+      ossimDpt p (uniform(state, 0, 8000), uniform(state, 0, 8000));
+      ossimDpt q (a[0] + a[1]*p.x + a[2]*p.y + uniform(state, -0.3, 0.3),
+                  b[0] + b[1]*p.x + b[2]*p.y + uniform(state, -0.3, 0.3));
+      bool outlier = uniform(state, 0, 1) < outlierRatio;
+      if (outlier)
+         q = ossimDpt(q.x + uniform(state, -300, 300), q.y + uniform(state, -300, 300));
+      from.push_back(p);
+      to.push_back(q);
+      isOutlier.push_back(outlier);
+   }
+}
+
+void testAffine(double outlierRatio)
+{
+   cout << "Affine, " << (int)(outlierRatio*100) << "% outliers" << endl;
+   const double a[3] = { 12.5, 1.0004, 0.0021 };
+   const double b[3] = { -7.25, -0.0019, 0.9993 };
+   vector<ossimDpt> from, to;
+   vector<bool> isOutlier;
+   synthesize(a, b, 200, outlierRatio, from, to, isOutlier);
+
+   ossimRegAffineFit fit;
+   fit.setThreshold(1.5);
+   check(fit.fit(from, to), "fit");
+
+   const double* fa = fit.getXCoefficients();
+   const double* fb = fit.getYCoefficients();
+   check(fabs(fa[1]-a[1]) < 1e-4 && fabs(fa[2]-a[2]) < 1e-4 &&
+         fabs(fb[1]-b[1]) < 1e-4 && fabs(fb[2]-b[2]) < 1e-4, "linear terms");
+
+   // Compare over the image rather than the offsets alone, which trade off against the slopes:
+   double maxErr = 0.0;
+   for (int y=0; y<=8000; y+=1000)
+   {
+      for (int x=0; x<=8000; x+=1000)
+      {
+         ossimDpt e = fit.forward(ossimDpt(x, y)) -
+               ossimDpt(a[0] + a[1]*x + a[2]*y, b[0] + b[1]*x + b[2]*y);
+         double err = sqrt(e.x*e.x + e.y*e.y);
+         if (err > maxErr) maxErr = err;
+      }
+   }
+   cout << "  max error " << maxErr << " px, rms " << fit.getRms() << " px, "
+        << fit.getNumInliers() << " inliers" << endl;
+   check(maxErr < 0.25, "transform within 0.25 px");
+
+   ossim_uint32 wrong = 0;
+   for (ossim_uint32 i=0; i<from.size(); ++i)
+      if (fit.getInliers()[i] == isOutlier[i]) ++wrong;
+   check(wrong <= 2, "outliers identified");
+
+   // Deterministic:
+   ossimRegAffineFit again;
+   again.setThreshold(1.5);
+   again.fit(from, to);
+   check(again.getXCoefficients()[0] == fa[0] && again.getYCoefficients()[0] == fb[0] &&
+         again.getNumInliers() == fit.getNumInliers(), "repeatable");
+}
+
+void testTranslation()
+{
+   cout << "Translation, 30% outliers" << endl;
+   const double a[3] = { -3.5, 1.0, 0.0 };
+   const double b[3] = { 4.75, 0.0, 1.0 };
+   vector<ossimDpt> from, to;
+   vector<bool> isOutlier;
+   synthesize(a, b, 50, 0.3, from, to, isOutlier);
+
+   ossimRegAffineFit fit;
+   fit.setModel(ossimRegAffineFit::TRANSLATION);
+   check(fit.fit(from, to), "fit");
+   check(fabs(fit.getXCoefficients()[0]-a[0]) < 0.1 && fabs(fit.getYCoefficients()[0]-b[0]) < 0.1,
+         "offset within 0.1 px");
+}
+
+void testDegenerate()
+{
+   cout << "Degenerate input" << endl;
+   vector<ossimDpt> from, to;
+   ossimRegAffineFit fit;
+   check(!fit.fit(from, to), "no points rejected");
+
+   // Collinear points do not determine an affine transform:
+   for (int i=0; i<10; ++i)
+   {
+      from.push_back(ossimDpt(i, 2*i));
+      to.push_back(ossimDpt(i+1, 2*i+1));
+   }
+   check(!fit.fit(from, to), "collinear points rejected");
+}
+
+int main()
+{
+   testAffine(0.0);
+   testAffine(0.4);
+   testTranslation();
+   testDegenerate();
+
+   return ossimPluginTest::summary();
+}
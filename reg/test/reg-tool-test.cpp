@@ -0,0 +1,291 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+
+// End to end test of ossimRegTool::execute() on a small synthetic image pair. Image B shows the
+// scene of image A moved by a known offset, and its geometry is a few pixels off the truth, as
+// an image to register is. The tool is run with brute force and guided matching, translation
+// and affine corrections, on one thread and on several, and the adjusted geometry it writes must
+// put B's pixels on the ground A sees them at. Ties are merged in patch order, so the geometries
+// from one thread and from several must be the same. An image that does not overlap the
+// reference must be left alone.
+//
+// The tie measurement generator comes from the opencv plugin, registered here as the plugin
+// loader would.
+//
+// Usage: reg-tool-test [work directory]
+
+#include "../src/ossimRegTool.h"
+#include "../../opencv/src/ossimOpenCvObjectFactory.h"
+#include "../../test/ossimPluginTest.h"
+#include <ossim/init/ossimInit.h>
+#include <ossim/base/ossimException.h>
+#include <ossim/base/ossimFilename.h>
+#include <ossim/base/ossimKeywordlist.h>
+#include <ossim/base/ossimObjectFactoryRegistry.h>
+#include <ossim/imaging/ossimImageData.h>
+#include <ossim/imaging/ossimImageGeometry.h>
+#include <ossim/imaging/ossimMemoryImageSource.h>
+#include <ossim/imaging/ossimTiffWriter.h>
+#include <ossim/projection/ossimEquDistCylProjection.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using ossimPluginTest::check;
+
+static const int IMAGE_SIZE = 768;
+static const double DEGREES_PER_PIXEL = 1.0e-4;
+static const double LAT = 45.0;
+static const double LON = 5.0;
+
+// B pixel (x, y) shows what A pixel (x + OFFSET_X, y + OFFSET_Y) does.
+static const int OFFSET_X = 11;
+static const int OFFSET_Y = 7;
+
+// B's geometry puts its pixels this far (in pixels) from where they belong.
+static const double ERROR_X = -4.0;
+static const double ERROR_Y = 3.0;
+
+// Max distance in pixels between where the adjusted geometry puts a B pixel and the truth.
+static const double TOLERANCE = 0.5;
+
+// Random rectangles and disks, box filtered: corners and blobs everywhere.
+static vector<ossim_uint8> makeScene(int size)
+{
+   vector<int> scene(size*size, 128);
+   ossim_uint32 state = 41;
+   for (int i=0; i<size*size/400; ++i)
+   {
+      state = state*1103515245u + 12345u;
+      const int cx = (state >> 8) % size;
+      state = state*1103515245u + 12345u;
+      const int cy = (state >> 8) % size;
+      state = state*1103515245u + 12345u;
+      const int r = 2 + (state >> 8) % 9;
+      state = state*1103515245u + 12345u;
+      const int gray = (state >> 8) % 256;
+      for (int y=max(0, cy - r); y<min(size, cy + r + 1); ++y)
+         for (int x=max(0, cx - r); x<min(size, cx + r + 1); ++x)
+            if ((i % 2) || ((x - cx)*(x - cx) + (y - cy)*(y - cy) <= r*r))
+               scene[y*size + x] = gray;
+   }
+   vector<ossim_uint8> blurred(size*size);
+   for (int y=0; y<size; ++y)
+   {
+      for (int x=0; x<size; ++x)
+      {
+         int sum = 0;
+         int n = 0;
+         for (int v=max(0, y - 1); v<=min(size - 1, y + 1); ++v)
+            for (int u=max(0, x - 1); u<=min(size - 1, x + 1); ++u, ++n)
+               sum += scene[v*size + u];
+         blurred[y*size + x] = (ossim_uint8) (sum/n);
+      }
+   }
+   return blurred;
+}
+
+// Geographic geometry with the upper left pixel at lat, lon.
+static ossimRefPtr<ossimImageGeometry> makeGeometry(double lat, double lon)
+{
+   ossimRefPtr<ossimEquDistCylProjection> proj = new ossimEquDistCylProjection;
+   proj->setOrigin(ossimGpt(0.0, 0.0, 0.0));
+   proj->setUlGpt(ossimGpt(lat, lon));
+   proj->setDecimalDegreesPerPixel(ossimDpt(DEGREES_PER_PIXEL, DEGREES_PER_PIXEL));
+   return new ossimImageGeometry(0, proj.get());
+}
+
+// Writes the IMAGE_SIZE square of the scene from (x0, y0) as a GeoTIFF with the geometry given.
+static bool writeImage(const ossimFilename& file, const vector<ossim_uint8>& scene, int sceneSize,
+                       int x0, int y0, ossimImageGeometry* geom)
+{
+   ossimRefPtr<ossimImageData> tile =
+      new ossimImageData(0, OSSIM_UINT8, 1, IMAGE_SIZE, IMAGE_SIZE);
+   tile->initialize();
+   ossim_uint8* buf = tile->getUcharBuf(0);
+   for (int y=0; y<IMAGE_SIZE; ++y)
+      for (int x=0; x<IMAGE_SIZE; ++x)
+         buf[y*IMAGE_SIZE + x] = scene[(y0 + y)*sceneSize + x0 + x];
+   tile->validate();
+
+   ossimRefPtr<ossimMemoryImageSource> source = new ossimMemoryImageSource;
+   source->setImage(tile);
+   source->setImageGeometry(geom);
+
+   ossimRefPtr<ossimTiffWriter> writer = new ossimTiffWriter;
+   writer->setGeotiffFlag(true);
+   writer->setFilename(file);
+   writer->connectMyInputTo(0, source.get());
+   const bool ok = writer->execute();
+   writer->disconnect();
+   return ok;
+}
+
+// Runs the tool on the images, returns what execute() returned.
+static bool runTool(const ossimFilename& reference, const ossimFilename& image,
+                    const ossimFilename& outputDir, const string& model, bool guided,
+                    int threads)
+{
+   ossimKeywordlist kwl;
+   kwl.add("image_file0", reference.c_str());
+   kwl.add("image_file1", image.c_str());
+   kwl.add("patch_size", 256);
+   kwl.add("patch_count", 2);
+   kwl.add("grid_size", 2);
+   kwl.add("max_matches", 10);
+   kwl.add("model", model.c_str());
+   kwl.add("guided_matching", guided ? "true" : "false");
+   kwl.add("threads", threads);
+   kwl.add("output_dir", outputDir.c_str());
+   kwl.add("report_file", outputDir.dirCat("report.txt").c_str());
+   try
+   {
+      ossimRefPtr<ossimRegTool> tool = new ossimRegTool;
+      tool->initialize(kwl);
+      return tool->execute();
+   }
+   catch (const ossimException& e)
+   {
+      cout << "    " << e.what() << endl;
+      return false;
+   }
+}
+
+static string readFile(const ossimFilename& file)
+{
+   ifstream in(file.c_str());
+   ostringstream text;
+   text << in.rdbuf();
+   return text.str();
+}
+
+// Largest distance, in pixels, between where geom puts B pixels and where they belong: on the
+// ground A pixel (x + OFFSET_X, y + OFFSET_Y) covers. -1 if a pixel has no ground point.
+static double geometryError(ossimImageGeometry* geom, ossimImageGeometry* refGeom)
+{
+   double worst = 0.0;
+   for (int y=0; y<IMAGE_SIZE; y+=IMAGE_SIZE/8)
+   {
+      for (int x=0; x<IMAGE_SIZE; x+=IMAGE_SIZE/8)
+      {
+         ossimGpt ground;
+         ossimDpt refPt;
+         geom->localToWorld(ossimDpt(x, y), ground);
+         refGeom->worldToLocal(ground, refPt);
+         if (refPt.hasNans())
+            return -1.0;
+         worst = max(worst, (refPt - ossimDpt(x + OFFSET_X, y + OFFSET_Y)).length());
+      }
+   }
+   return worst;
+}
+
+// geometryError of the geometry file the tool wrote, -1 if it cannot be loaded.
+static double adjustedError(const ossimFilename& geomFile, ossimImageGeometry* refGeom)
+{
+   ossimKeywordlist kwl;
+   ossimRefPtr<ossimImageGeometry> geom = new ossimImageGeometry;
+   if (!geomFile.exists() || !kwl.addFile(geomFile) || !geom->loadState(kwl))
+      return -1.0;
+   return geometryError(geom.get(), refGeom);
+}
+
+int main(int argc, char* argv[])
+{
+   ossimInit::instance()->initialize(argc, argv);
+
+   ossimFilename dir = ossimFilename((argc > 1) ? argv[1] : ".").dirCat("reg-tool-test");
+   if (!dir.exists() && !dir.createDirectory(true))
+   {
+      cout << "Could not create " << dir << endl;
+      return 1;
+   }
+
+   // As the opencv plugin does when it is loaded:
+   ossimObjectFactoryRegistry* registry = ossimObjectFactoryRegistry::instance();
+   ossimRefPtr<ossimObject> generator =
+      registry->createObject(ossimString("ossimTieMeasurementGenerator"));
+   if (!generator.valid())
+      registry->registerFactory(ossimOpenCvObjectFactory::instance());
+
+   const int sceneSize = IMAGE_SIZE + max(OFFSET_X, OFFSET_Y);
+   const vector<ossim_uint8> scene = makeScene(sceneSize);
+
+   ossimRefPtr<ossimImageGeometry> refGeom = makeGeometry(LAT, LON);
+   const ossimFilename reference = dir.dirCat("reference.tif");
+   const ossimFilename image = dir.dirCat("image.tif");
+   const ossimFilename faraway = dir.dirCat("faraway.tif");
+   ossimRefPtr<ossimImageGeometry> wrongGeom =
+      makeGeometry(LAT - (OFFSET_Y + ERROR_Y)*DEGREES_PER_PIXEL,
+                   LON + (OFFSET_X + ERROR_X)*DEGREES_PER_PIXEL);
+   check(writeImage(reference, scene, sceneSize, 0, 0, refGeom.get()) &&
+         writeImage(image, scene, sceneSize, OFFSET_X, OFFSET_Y, wrongGeom.get()) &&
+         writeImage(faraway, scene, sceneSize, 0, 0, makeGeometry(LAT - 1.0, LON).get()),
+         "synthetic images written");
+
+   // The image as written is off by the error:
+   const double before = geometryError(wrongGeom.get(), refGeom.get());
+   ostringstream what;
+   what << "geometry of the image before registration is " << before << " px off";
+   check(fabs(before - sqrt(ERROR_X*ERROR_X + ERROR_Y*ERROR_Y)) < 0.01, what.str());
+
+   struct Run
+   {
+      const char* model;
+      bool guided;
+      int threads;
+   };
+   const Run RUNS[] = { { "translation", false, 1 }, { "translation", false, 4 },
+                        { "affine", false, 1 }, { "affine", false, 4 },
+                        { "affine", true, 4 } };
+   const ossimFilename registered = dir.dirCat("image_reg.geom");
+   string oneThread;
+   for (size_t r=0; r<sizeof(RUNS)/sizeof(RUNS[0]); ++r)
+   {
+      const Run& run = RUNS[r];
+      ostringstream name;
+      name << run.model << (run.guided ? ", guided" : ", brute force") << ", " << run.threads
+           << " thread" << ((run.threads > 1) ? "s" : "");
+      remove(registered.c_str());
+
+      check(runTool(reference, image, dir, run.model, run.guided, run.threads),
+            name.str() + ": execute() succeeds");
+      const double error = adjustedError(registered, refGeom.get());
+      what.str("");
+      what << name.str() << ": adjusted geometry within " << TOLERANCE << " px (" << error
+           << " px)";
+      check((error >= 0.0) && (error < TOLERANCE), what.str());
+
+      // The same matching on one thread and on several gives the same geometry:
+      if (!run.guided && (run.threads == 1))
+         oneThread = readFile(registered);
+      else if (!run.guided)
+         check(!oneThread.empty() && (readFile(registered) == oneThread),
+               name.str() + ": same geometry as on one thread");
+   }
+   remove(registered.c_str());
+
+   const ossimFilename farawayGeom = dir.dirCat("faraway_reg.geom");
+   check(!runTool(reference, faraway, dir, "affine", false, 4) && !farawayGeom.exists(),
+         "image off the reference: execute() fails and writes no geometry");
+   check(readFile(dir.dirCat("report.txt")).find("No usable overlap") != string::npos,
+         "image off the reference: reported");
+
+   remove(reference.c_str());
+   remove(image.c_str());
+   remove(faraway.c_str());
+   remove(dir.dirCat("report.txt").c_str());
+   remove(dir.c_str());
+
+   return ossimPluginTest::summary();
+}
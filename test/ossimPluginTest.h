@@ -0,0 +1,43 @@
+//**************************************************************************************************
+//
+//     OSSIM Open Source Geospatial Data Processing Library
+//     See top level LICENSE.txt file for license information
+//
+//**************************************************************************************************
+//
+// Pass/fail bookkeeping shared by the plugin unit tests. Each check prints one line; the test's
+// main() ends with "return ossimPluginTest::summary();", which prints the overall result and
+// gives the exit code ctest goes by.
+
+#ifndef ossimPluginTest_HEADER
+#define ossimPluginTest_HEADER 1
+
+#include <iostream>
+#include <string>
+
+namespace ossimPluginTest
+{
+   /** Number of failed checks so far. */
+   inline int& failures()
+   {
+      static int count = 0;
+      return count;
+   }
+
+   /** Reports one check. Call from the main thread. */
+   inline void check(bool passed, const std::string& what)
+   {
+      std::cout << (passed ? "  PASSED: " : "  FAILED: ") << what << std::endl;
+      if (!passed)
+         ++failures();
+   }
+
+   /** Prints the overall result and returns the exit code: 0 if every check passed, else 1. */
+   inline int summary()
+   {
+      std::cout << (failures() ? "FAILED" : "PASSED") << std::endl;
+      return failures() ? 1 : 0;
+   }
+}
+
+#endif /* #ifndef ossimPluginTest_HEADER */